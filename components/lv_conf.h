@@ -51,7 +51,12 @@
 #define LV_MEM_CUSTOM 0
 #if LV_MEM_CUSTOM == 0
     /*Size of the memory available for `lv_mem_alloc()` in bytes (>= 2kB)*/
-    #define LV_MEM_SIZE (48U * 1024U)          /*[bytes]*/
+    #define LV_MEM_SIZE (64U * 1024U)          /*[bytes]*/
+
+    /*Size of an area in the pool for small objects (<= 128 bytes) which are allocated from size classes.
+     *It keeps the small and frequent allocations (objects, style lists, list nodes) from fragmenting the pool.
+     *0: disable*/
+    #define LV_MEM_SLAB_SIZE (8U * 1024U)    /*[bytes]*/
 
     /*Set an address for the memory pool instead of allocating it as a normal array. Can be in external SRAM too.*/
     #define LV_MEM_ADR 0     /*0: unused*/
@@ -72,6 +77,14 @@
  *You will see an error log message if there wasn't enough buffers. */
 #define LV_MEM_BUF_MAX_NUM 16
 
+/*Allocate the caches (shadow corners, decompressed glyphs, resolved style properties and the LRU bookkeeping)
+ *with these functions instead of `lv_mem_alloc()`. E.g. to keep them out of the LVGL heap.
+ *Leave them undefined to allocate the caches from the LVGL heap.
+ *They are read on every draw so internal RAM is preferred, PSRAM is the fallback.*/
+#define LV_CACHE_MEM_INCLUDE <esp_heap_caps.h>
+#define LV_CACHE_MEM_ALLOC(size) heap_caps_malloc_prefer(size, 2, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT, MALLOC_CAP_SPIRAM)
+#define LV_CACHE_MEM_FREE heap_caps_free
+
 /*Use the standard `memcpy` and `memset` instead of LVGL's own functions. (Might or might not be faster).*/
 #define LV_MEMCPY_MEMSET_STD 0
 
@@ -85,6 +98,10 @@
 /*Input device read period in milliseconds*/
 #define LV_INDEV_DEF_READ_PERIOD 30     /*[ms]*/
 
+/*Cell size [px] of the grid used to find the clicked object on screens with
+ *`lv_indev_hit_index_enable(scr, true)`. 0: disable the hit index*/
+#define LV_INDEV_HIT_INDEX_CELL_SIZE 0
+
 /*Use a custom tick source that tells the elapsed time in milliseconds.
  *It removes the need to manually update the tick with `lv_tick_inc()`)*/
 #define LV_TICK_CUSTOM 0
@@ -115,14 +132,23 @@
 
     /*Allow buffering some shadow calculation.
     *LV_SHADOW_CACHE_SIZE is the max. shadow size to buffer, where shadow size is `shadow_width + radius`
-    *Caching has LV_SHADOW_CACHE_SIZE^2 RAM cost*/
-    #define LV_SHADOW_CACHE_SIZE 0
+    *A buffered shadow has shadow size^2 RAM cost*/
+    #define LV_SHADOW_CACHE_SIZE 64
+    #if LV_SHADOW_CACHE_SIZE
+        /*Bytes of buffered shadows to keep. The least recently used ones are freed to stay in the limit*/
+        #define LV_SHADOW_CACHE_MEM_SIZE (8 * 1024)
+    #endif
 
     /* Set number of maximally cached circle data.
     * The circumference of 1/4 circle are saved for anti-aliasing
-    * radius * 4 bytes are used per circle (the most often used radiuses are saved)
+    * radius * 6 bytes are used per circle (the most often used radiuses are saved)
+    * The entries are looked up by a hash of the radius so a larger cache is not slower
     * 0: to disable caching */
-    #define LV_CIRCLE_CACHE_SIZE 4
+    #define LV_CIRCLE_CACHE_SIZE 16
+
+    /*Use the circle data of src/draw/lv_draw_mask_circle_tables.c from the flash for its radii (1..16 by default).
+     *Generate it with scripts/circle_tables_gen.py for other radii*/
+    #define LV_USE_CIRCLE_CONST_TABLES 1
 #endif /*LV_DRAW_COMPLEX*/
 
 /**
@@ -146,7 +172,26 @@
  *With complex image decoders (e.g. PNG or JPG) caching can save the continuous open/decode of images.
  *However the opened images might consume additional RAM.
  *0: to disable caching*/
-#define LV_IMG_CACHE_DEF_SIZE 0
+#define LV_IMG_CACHE_DEF_SIZE 16
+#if LV_IMG_CACHE_DEF_SIZE
+    /*Default number of bytes the cached images can use. Mainly the decoded pixels are counted.
+     *The least recently used images are closed to stay in the limit*/
+    #define LV_IMG_CACHE_DEF_MEM_SIZE (512U * 1024U)
+
+    /*Copy the decoded images to memory allocated by these functions and close their decoder.
+     *Icons stay in internal RAM, larger images go to PSRAM. Both fall back to the other heap.*/
+    #define LV_IMG_CACHE_MEM_INCLUDE <esp_heap_caps.h>
+    #define LV_IMG_CACHE_INTERNAL_MAX (8U * 1024U)
+    #define LV_IMG_CACHE_MEM_ALLOC(size) heap_caps_malloc_prefer(size, 2,                                            \
+                                         (size) <= LV_IMG_CACHE_INTERNAL_MAX ? MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT : MALLOC_CAP_SPIRAM, \
+                                         (size) <= LV_IMG_CACHE_INTERNAL_MAX ? MALLOC_CAP_SPIRAM : MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT)
+    #define LV_IMG_CACHE_MEM_FREE heap_caps_free
+#endif
+
+/*Default number of resolved style properties to cache. Reading a style property of a widget
+ *walks all of its styles, the cache keeps the result per widget, part, state and property.
+ *About 16 bytes per entry. 0: to disable caching*/
+#define LV_OBJ_STYLE_CACHE_DEF_SIZE 256
 
 /*Number of stops allowed per gradient. Increase this to allow more stops.
  *This adds (sizeof(lv_color_t) + 1) bytes per additional stop*/
@@ -174,6 +219,27 @@
  *Only used if software rotation is enabled in the display driver.*/
 #define LV_DISP_ROT_MAX_BUF (10*1024)
 
+/*Let a custom header (e.g. with SIMD or assembly kernels) handle the RGB565 fill and image blending.
+ *The header can define `LV_DRAW_SW_RGB565_FILL(dsc)` and `LV_DRAW_SW_RGB565_MAP(dsc)`.
+ *Only used with LV_COLOR_DEPTH 16 and LV_COLOR_16_SWAP 0*/
+#define LV_DRAW_SW_ASM_CUSTOM 1
+#if LV_DRAW_SW_ASM_CUSTOM
+    #define LV_DRAW_SW_ASM_CUSTOM_INCLUDE "lv_draw_sw_blend_esp.h"
+#endif
+
+/*Render on two threads: the invalidated areas are split at a horizontal line and the part above it
+ *is rendered by a worker (e.g. a task on the other core) into the same buffer. See `lv_parallel_set_cb()`.
+ *Only for the software renderer.
+ *The `LV_EVENT_DRAW_MAIN/POST/PART_...` event callbacks run on both threads at the same time (for different
+ *parts of the screen), so they must not modify any state shared with other objects or the LVGL task.*/
+#define LV_USE_PARALLEL_RENDER 0
+#if LV_USE_PARALLEL_RENDER
+    /*Storage class of the render state each thread has its own copy of (a few hundred bytes per thread)*/
+    #define LV_PARALLEL_RENDER_TLS __thread
+    /*[px] Smaller areas are rendered on one thread because starting the worker would take longer*/
+    #define LV_PARALLEL_RENDER_MIN_AREA 4096
+#endif
+
 /*-------------
  * GPU
  *-----------*/
@@ -293,6 +359,23 @@
     #define LV_USE_MEM_MONITOR_POS LV_ALIGN_BOTTOM_LEFT
 #endif
 
+/*1: Measure the stages of the refresh (layout, style refresh, rendering, flush, etc.) with histograms of the durations.
+ *See `lv_trace_dump()` and `lv_trace_export_chrome()`. Off in production, enable it with menuconfig
+ *(Component config > LVGL configuration > Others) to serve the "trace" commands of the diag topic.*/
+#ifdef CONFIG_LV_USE_TRACE
+    #define LV_USE_TRACE 1
+#else
+    #define LV_USE_TRACE 0
+#endif
+#if LV_USE_TRACE
+    /*Number of the last measurements to keep for `lv_trace_export_chrome()`. 0: keep only the histograms*/
+    #define LV_TRACE_EVENT_CNT 256
+
+    /*Time in microseconds as uint32_t. The default has the resolution of the tick.*/
+    #define LV_TRACE_TIME_INCLUDE <esp_timer.h>
+    #define LV_TRACE_TIME_EXPR ((uint32_t)esp_timer_get_time())
+#endif
+
 /*1: Draw random colored rectangles over the redrawn areas*/
 #define LV_USE_REFR_DEBUG 1
 
@@ -411,7 +494,11 @@
 #define LV_FONT_FMT_TXT_LARGE 0
 
 /*Enables/disables support for compressed fonts.*/
-#define LV_USE_FONT_COMPRESSED 0
+#define LV_USE_FONT_COMPRESSED 1
+#if LV_USE_FONT_COMPRESSED
+    /*Bytes of decompressed glyphs to keep so that they are not decompressed on every draw. 0: no caching*/
+    #define LV_FONT_COMPRESSED_CACHE_SIZE (6 * 1024)
+#endif
 
 /*Enable subpixel rendering*/
 #define LV_USE_FONT_SUBPX 0
@@ -495,6 +582,7 @@
 #if LV_USE_LABEL
     #define LV_LABEL_TEXT_SELECTION 1 /*Enable selecting text of the label*/
     #define LV_LABEL_LONG_TXT_HINT 1  /*Store some extra info in labels to speed up drawing of very long texts*/
+    #define LV_LABEL_LINE_CACHE 1     /*Store the line breaks of labels to not measure the text on every draw and refresh*/
 #endif
 
 #define LV_USE_LINE       1
@@ -602,6 +690,10 @@
 
 /*A layout similar to Flexbox in CSS.*/
 #define LV_USE_FLEX 1
+#if LV_USE_FLEX
+    /*Remember the size and position of the items to re-layout only the changed tracks*/
+    #define LV_FLEX_CACHE 1
+#endif
 
 /*A layout similar to Grid in CSS.*/
 #define LV_USE_GRID 1
@@ -612,6 +704,15 @@
 
 /*File system interfaces for common APIs */
 
+/*Cache the files of the drivers with `cache_size > 0` in blocks shared by all of them, instead of a `cache_size`
+ *window per open file. Sequential reads are read ahead, the least recently used blocks are dropped.
+ *Byte budget of the cache, 0: disabled*/
+#define LV_FS_BLOCK_CACHE_SIZE 0
+#if LV_FS_BLOCK_CACHE_SIZE
+    #define LV_FS_BLOCK_CACHE_BLOCK_SIZE 512    /*Bytes per block. A multiple of the medium's sector size is the best*/
+    #define LV_FS_BLOCK_CACHE_READ_AHEAD 8      /*Max. number of blocks read with one driver call*/
+#endif
+
 /*API for fopen, fread, etc*/
 #define LV_USE_FS_STDIO 0
 #if LV_USE_FS_STDIO
@@ -652,6 +753,11 @@
 
 /*PNG decoder library*/
 #define LV_USE_PNG 1
+#if LV_USE_PNG
+    /*Decode the PNGs whose decoded size is at least this many bytes row by row while drawing, instead of into a
+     *full image buffer. It needs about 32 kB plus two rows, but drawing the image again decodes it again. 0: never*/
+    #define LV_PNG_STREAM_MIN_SIZE 65536
+#endif
 
 /*BMP decoder library*/
 #define LV_USE_BMP 0
@@ -52,3 +52,21 @@ if(CONFIG_LV_ATTRIBUTE_FAST_MEM_USE_IRAM)
   target_compile_definitions(${COMPONENT_LIB}
                              PUBLIC "-DLV_ATTRIBUTE_FAST_MEM=IRAM_ATTR")
 endif()
+
+# The RGB565 assembly kernels of esp_lvgl_port can be used via
+# `LV_DRAW_SW_ASM_CUSTOM_INCLUDE "lv_draw_sw_blend_esp.h"` in lv_conf.h
+target_include_directories(${COMPONENT_LIB} PRIVATE ${LVGL_ROOT_DIR}/env_support/esp)
+
+idf_build_get_property(build_components BUILD_COMPONENTS)
+if((CONFIG_IDF_TARGET_ESP32 OR CONFIG_IDF_TARGET_ESP32S3)
+   AND ("espressif__esp_lvgl_port" IN_LIST build_components))
+  idf_component_get_property(LV_PORT_DIR espressif__esp_lvgl_port COMPONENT_DIR)
+  if(CONFIG_IDF_TARGET_ESP32S3)
+    set(LV_ASM_SUFFIX "esp32s3")
+  else()
+    set(LV_ASM_SUFFIX "esp32")
+  endif()
+  target_sources(${COMPONENT_LIB} PRIVATE
+    ${LV_PORT_DIR}/src/lvgl9/simd/lv_color_blend_to_rgb565_${LV_ASM_SUFFIX}.S
+    ${LV_PORT_DIR}/src/lvgl9/simd/lv_rgb565_blend_normal_to_rgb565_${LV_ASM_SUFFIX}.S)
+endif()
@@ -0,0 +1,112 @@
+/**
+ * @file lv_draw_sw_blend_esp.h
+ * Route the opaque RGB565 fills and image copies to the ESP32/ESP32-S3 assembly kernels of esp_lvgl_port.
+ * Use it with `#define LV_DRAW_SW_ASM_CUSTOM_INCLUDE "lv_draw_sw_blend_esp.h"`
+ *
+ * Only the opaque cases are routed: esp_lvgl_port ships only these two RGB565 kernels
+ * (`lv_color_blend_to_rgb565` and `lv_rgb565_blend_normal_to_rgb565`), both without opacity and mask support.
+ * The alpha and masked cases return `LV_RES_INV` and use the C kernels of lv_draw_sw_blend_rgb565.c.
+ * They must be bit-exact with LVGL's `lv_color_mix` rounding (the 5 bit mix ratio and `LV_UDIV255`),
+ * which the 8 bit lanes of the PIE instructions don't reproduce, so they stay in C.
+ * The C kernels load and store 2 pixels in a 32 bit word and mix the 3 channels of a pixel at once.
+ */
+
+#ifndef LV_DRAW_SW_BLEND_ESP_H
+#define LV_DRAW_SW_BLEND_ESP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "sdkconfig.h"
+
+/*Only these targets have the assembly kernels, the others use the C implementation*/
+#if CONFIG_IDF_TARGET_ESP32 || CONFIG_IDF_TARGET_ESP32S3
+
+/*********************
+ *      DEFINES
+ *********************/
+
+#define LV_DRAW_SW_RGB565_FILL(dsc) lv_draw_sw_blend_esp_rgb565_fill(dsc)
+#define LV_DRAW_SW_RGB565_MAP(dsc)  lv_draw_sw_blend_esp_rgb565_map(dsc)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/*The layout expected by the assembly functions*/
+typedef struct {
+    uint32_t opa;
+    void * dst_buf;
+    uint32_t dst_w;
+    uint32_t dst_h;
+    uint32_t dst_stride;            /*In bytes*/
+    const void * src_buf;
+    uint32_t src_stride;            /*In bytes*/
+    const lv_opa_t * mask_buf;
+    uint32_t mask_stride;
+} lv_draw_sw_blend_esp_asm_dsc_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+int lv_color_blend_to_rgb565_esp(lv_draw_sw_blend_esp_asm_dsc_t * asm_dsc);
+int lv_rgb565_blend_normal_to_rgb565_esp(lv_draw_sw_blend_esp_asm_dsc_t * asm_dsc);
+
+/**********************
+ *  STATIC FUNCTIONS
+ **********************/
+
+static inline lv_res_t lv_draw_sw_blend_esp_rgb565_fill(const lv_draw_sw_rgb565_blend_dsc_t * dsc)
+{
+    /*The assembly can only fill with an opaque color*/
+    if(dsc->mask_buf || dsc->opa < LV_OPA_MAX) return LV_RES_INV;
+
+    /*It reads the color with one 32 bit load as 8 bit blue, green and red channels (little endian),
+     *so it has to be a word aligned variable, not a byte array*/
+    uint32_t blue = (uint32_t)(dsc->color & 0x1F) << 3;
+    uint32_t green = (uint32_t)((dsc->color >> 5) & 0x3F) << 2;
+    uint32_t red = (uint32_t)(dsc->color >> 11) << 3;
+    uint32_t color = blue | (green << 8) | (red << 16) | 0xFF000000U;
+
+    lv_draw_sw_blend_esp_asm_dsc_t asm_dsc = {
+        .dst_buf = dsc->dest_buf,
+        .dst_w = dsc->dest_w,
+        .dst_h = dsc->dest_h,
+        .dst_stride = dsc->dest_stride * sizeof(uint16_t),
+        .src_buf = &color,
+    };
+
+    lv_color_blend_to_rgb565_esp(&asm_dsc);
+    return LV_RES_OK;
+}
+
+static inline lv_res_t lv_draw_sw_blend_esp_rgb565_map(const lv_draw_sw_rgb565_blend_dsc_t * dsc)
+{
+    /*The assembly can only copy opaque images*/
+    if(dsc->mask_buf || dsc->opa < LV_OPA_MAX) return LV_RES_INV;
+
+    lv_draw_sw_blend_esp_asm_dsc_t asm_dsc = {
+        .dst_buf = dsc->dest_buf,
+        .dst_w = dsc->dest_w,
+        .dst_h = dsc->dest_h,
+        .dst_stride = dsc->dest_stride * sizeof(uint16_t),
+        .src_buf = dsc->src_buf,
+        .src_stride = dsc->src_stride * sizeof(uint16_t),
+    };
+
+    lv_rgb565_blend_normal_to_rgb565_esp(&asm_dsc);
+    return LV_RES_OK;
+}
+
+#endif /*CONFIG_IDF_TARGET_ESP32 || CONFIG_IDF_TARGET_ESP32S3*/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_DRAW_SW_BLEND_ESP_H*/
@@ -27,6 +27,8 @@ extern "C" {
 #include "src/misc/lv_math.h"
 #include "src/misc/lv_mem.h"
 #include "src/misc/lv_async.h"
+#include "src/misc/lv_parallel.h"
+#include "src/misc/lv_trace.h"
 #include "src/misc/lv_anim_timeline.h"
 #include "src/misc/lv_printf.h"
 
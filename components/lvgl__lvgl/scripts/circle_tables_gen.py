@@ -0,0 +1,185 @@
+#!/usr/bin/env python3
+
+'''
+Generates src/draw/lv_draw_mask_circle_tables.c with the anti-aliased circle coverage
+of a fixed set of radii. It mirrors circ_calc_aa4() of lv_draw_mask.c, so the tables
+are the same as the ones calculated at run time.
+
+Usage: circle_tables_gen.py [radii]
+radii is a comma separated list of radii and ranges, e.g. "1-16,20,24". Default: 1-16
+'''
+
+import os
+import sys
+
+SCRIPT_DIR = os.path.dirname(__file__)
+OUT_FILE = os.path.join(SCRIPT_DIR, "..", "src", "draw", "lv_draw_mask_circle_tables.c")
+
+
+def parse_radii(s):
+    radii = set()
+    for part in s.split(","):
+        if "-" in part:
+            first, last = part.split("-")
+            radii.update(range(int(first), int(last) + 1))
+        elif part:
+            radii.add(int(part))
+    if not radii or min(radii) < 1:
+        raise ValueError("the radii have to be positive")
+    return sorted(radii)
+
+
+def calc_aa4(radius):
+    '''Return (cir_opa, opa_start_on_y, x_start_on_y) like circ_calc_aa4()'''
+    cir_opa = [0] * (2 * radius + 2)
+    opa_start_on_y = [0] * (radius + 1)
+    x_start_on_y = [0] * (radius + 1)
+
+    if radius == 1:
+        cir_opa[0] = 180
+        opa_start_on_y[0] = 0
+        opa_start_on_y[1] = 1
+        x_start_on_y[0] = 0
+        return cir_opa, opa_start_on_y, x_start_on_y
+
+    cir_x = []
+    cir_y = []
+
+    def add(x, y, opa):
+        cir_x.append(x)
+        cir_y.append(y)
+        cir_opa[len(cir_x) - 1] = (opa * 16) & 0xff
+
+    # Bresenham circle upscaled by 4
+    cp_x = radius * 4
+    cp_y = 0
+    tmp = 1 - cp_x
+
+    y_8th_cnt = 0
+    x_int = [cp_x >> 2, 0, 0, 0]
+    x_fract = [0, 0, 0, 0]
+
+    while cp_y <= cp_x:
+        i = 0
+        while i < 4:
+            if tmp <= 0:
+                tmp += 2 * cp_y + 3
+            else:
+                tmp += 2 * (cp_y - cp_x) + 5
+                cp_x -= 1
+            cp_y += 1
+            if cp_y > cp_x:
+                break
+            x_int[i] = cp_x >> 2
+            x_fract[i] = cp_x & 0x3
+            i += 1
+        if i != 4:
+            break
+
+        if x_int[0] == x_int[3]:
+            add(x_int[0], y_8th_cnt, x_fract[0] + x_fract[1] + x_fract[2] + x_fract[3])
+        elif x_int[0] != x_int[1]:
+            add(x_int[0], y_8th_cnt, x_fract[0])
+            add(x_int[0] - 1, y_8th_cnt, 1 * 4 + x_fract[1] + x_fract[2] + x_fract[3])
+        elif x_int[0] != x_int[2]:
+            add(x_int[0], y_8th_cnt, x_fract[0] + x_fract[1])
+            add(x_int[0] - 1, y_8th_cnt, 2 * 4 + x_fract[2] + x_fract[3])
+        else:
+            add(x_int[0], y_8th_cnt, x_fract[0] + x_fract[1] + x_fract[2])
+            add(x_int[0] - 1, y_8th_cnt, 3 * 4 + x_fract[3])
+
+        y_8th_cnt += 1
+
+    # The point on the 1/8 circle
+    mid = radius * 723
+    mid_int = mid >> 10
+    if cir_x[-1] != mid_int or cir_y[-1] != mid_int:
+        tmp_val = mid - (mid_int << 10)
+        if tmp_val <= 512:
+            tmp_val = (tmp_val * tmp_val * 2) >> (10 + 6)
+        else:
+            tmp_val = 1024 - tmp_val
+            tmp_val = (tmp_val * tmp_val * 2) >> (10 + 6)
+            tmp_val = 15 - tmp_val
+        add(mid_int, mid_int, tmp_val)
+
+    # Mirror the first octet
+    for i in range(len(cir_x) - 2, -1, -1):
+        cir_opa[len(cir_x)] = cir_opa[i]
+        cir_x.append(cir_y[i])
+        cir_y.append(cir_x[i])
+
+    cir_size = len(cir_x)
+    y = 0
+    i = 0
+    while i < cir_size:
+        opa_start_on_y[y] = i
+        x_start_on_y[y] = cir_x[i]
+        while i < cir_size and cir_y[i] == y:
+            x_start_on_y[y] = min(x_start_on_y[y], cir_x[i])
+            i += 1
+        y += 1
+
+    return cir_opa, opa_start_on_y, x_start_on_y
+
+
+def c_array(values, per_line=16):
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append("    " + ", ".join(str(v) for v in values[i:i + per_line]) + ",")
+    return "\n".join(lines)
+
+
+def generate(radii):
+    out = []
+    out.append('''/**
+ * GENERATED FILE, DO NOT EDIT IT!
+ * @file lv_draw_mask_circle_tables.c
+ * Anti-aliased circle coverage of fixed radii, generated by scripts/circle_tables_gen.py
+ * Radii: %s
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_draw.h"
+#if LV_DRAW_COMPLEX && LV_USE_CIRCLE_CONST_TABLES
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+''' % ", ".join(str(r) for r in radii))
+
+    for r in radii:
+        cir_opa, opa_start_on_y, x_start_on_y = calc_aa4(r)
+        out.append("static LV_ATTRIBUTE_LARGE_CONST const lv_opa_t cir_opa_%d[] = {\n%s\n};\n" % (r, c_array(cir_opa)))
+        out.append("static LV_ATTRIBUTE_LARGE_CONST const uint16_t opa_start_on_y_%d[] = {\n%s\n};\n" %
+                   (r, c_array(opa_start_on_y)))
+        out.append("static LV_ATTRIBUTE_LARGE_CONST const uint16_t x_start_on_y_%d[] = {\n%s\n};\n" %
+                   (r, c_array(x_start_on_y)))
+
+    out.append("static const _lv_draw_mask_radius_circle_dsc_t circles[] = {")
+    for r in radii:
+        out.append("    {\n        .cir_opa = (lv_opa_t *)cir_opa_%d, .opa_start_on_y = (uint16_t *)opa_start_on_y_%d,\n"
+                   "        .x_start_on_y = (uint16_t *)x_start_on_y_%d, .radius = %d\n    }," % (r, r, r, r))
+    out.append("};\n")
+
+    out.append('''/**********************
+ *  GLOBAL VARIABLES
+ **********************/
+''')
+    out.append("const _lv_draw_mask_radius_circle_dsc_t * const _lv_draw_mask_circle_const_tables[] = {")
+    index = {r: i for i, r in enumerate(radii)}
+    for r in range(0, radii[-1] + 1):
+        out.append("    &circles[%d]," % index[r] if r in index else "    NULL,")
+    out.append("};\n")
+    out.append("const lv_coord_t _lv_draw_mask_circle_const_max = %d;\n" % radii[-1])
+    out.append("#endif /*LV_DRAW_COMPLEX && LV_USE_CIRCLE_CONST_TABLES*/\n")
+
+    return "\n".join(out)
+
+
+if __name__ == "__main__":
+    radii = parse_radii(sys.argv[1] if len(sys.argv) > 1 else "1-16")
+    with open(OUT_FILE, "w") as f:
+        f.write(generate(radii))
@@ -8,6 +8,7 @@
  *********************/
 #include "lv_obj.h"
 #include "lv_indev.h"
+#include "../misc/lv_parallel.h"
 
 /*********************
  *      DEFINES
@@ -33,7 +34,7 @@ static bool event_is_bubbled(lv_event_t * e);
 /**********************
  *  STATIC VARIABLES
  **********************/
-static lv_event_t * event_head;
+static LV_RENDER_TLS lv_event_t * event_head;
 
 /**********************
  *      MACROS
@@ -10,6 +10,7 @@
 #include "lv_disp.h"
 #include "lv_obj.h"
 #include "lv_indev_scroll.h"
+#include "lv_indev_hit_index.h"
 #include "lv_group.h"
 #include "lv_refr.h"
 
@@ -300,6 +301,10 @@ lv_obj_t * lv_indev_search_obj(lv_obj_t * obj, lv_point_t * point)
 {
     lv_obj_t * found_p = NULL;
 
+#if LV_INDEV_HIT_INDEX_CELL_SIZE
+    if(obj->parent == NULL && _lv_indev_hit_index_search(obj, point, &found_p)) return found_p;
+#endif
+
     /*If this obj is hidden the children are hidden too so return immediately*/
     if(lv_obj_has_flag(obj, LV_OBJ_FLAG_HIDDEN)) return NULL;
 
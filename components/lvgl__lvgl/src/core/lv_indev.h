@@ -165,6 +165,17 @@ lv_timer_t * lv_indev_get_read_timer(lv_disp_t * indev);
  */
 lv_obj_t * lv_indev_search_obj(lv_obj_t * obj, lv_point_t * point);
 
+#if LV_INDEV_HIT_INDEX_CELL_SIZE
+/**
+ * Enable or disable the hit index of a screen. With hit index `lv_indev_search_obj` on the screen
+ * looks up the clickable objects under the point in a grid instead of walking all the children.
+ * The index is updated as the objects move, resize or change their flags.
+ * @param scr   pointer to a screen (or the top or system layer)
+ * @param en    true: create the index; false: delete it
+ */
+void lv_indev_hit_index_enable(lv_obj_t * scr, bool en);
+#endif
+
 /**********************
  *      MACROS
  **********************/
@@ -0,0 +1,527 @@
+/**
+ * @file lv_indev_hit_index.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_indev.h"
+#include "lv_indev_hit_index.h"
+#include "../misc/lv_gc.h"
+
+#if LV_INDEV_HIT_INDEX_CELL_SIZE
+
+/*********************
+ *      DEFINES
+ *********************/
+#define CELL_SIZE       LV_INDEV_HIT_INDEX_CELL_SIZE
+
+/*Candidates under a point. With more the recursive search is used.*/
+#define CANDIDATE_MAX   16
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/*The clickable objects whose click area overlaps a cell*/
+typedef struct {
+    lv_obj_t ** objs;
+    uint16_t cnt;
+    uint16_t cap;
+} hit_cell_t;
+
+/*An object in the index: its cells and whether it's transformed*/
+typedef struct {
+    lv_obj_t * obj;         /*NULL: free slot*/
+    uint16_t x1;
+    uint16_t y1;
+    uint16_t x2;            /*x1 > x2: not in any cell*/
+    uint16_t y2;
+    uint8_t transformed;
+} hit_entry_t;
+
+typedef struct _lv_hit_index_t {
+    struct _lv_hit_index_t * next;
+    lv_obj_t * scr;
+    lv_area_t area;         /*The area of the screen covered by the cells*/
+    uint16_t col_cnt;
+    uint16_t row_cnt;
+    hit_cell_t * cells;
+    hit_entry_t * entries;  /*Hash table with linear probing*/
+    uint32_t entry_cap;     /*A power of 2*/
+    uint32_t entry_cnt;
+    uint32_t transform_cnt; /*The point has to be transformed on the way down, the cells don't tell the candidates*/
+    bool oom;               /*Some objects are missing, use the recursive search until rebuilt*/
+} lv_hit_index_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static lv_hit_index_t * get_index(const lv_obj_t * obj);
+static void index_build(lv_hit_index_t * index);
+static void index_clear(lv_hit_index_t * index);
+static void index_update(lv_hit_index_t * index, lv_obj_t * obj);
+static void index_update_tree(lv_hit_index_t * index, lv_obj_t * obj);
+static void index_remove(lv_hit_index_t * index, lv_obj_t * obj);
+static void index_remove_tree(lv_hit_index_t * index, lv_obj_t * obj);
+static bool cell_add(hit_cell_t * cell, lv_obj_t * obj);
+static void cell_remove(hit_cell_t * cell, lv_obj_t * obj);
+static hit_entry_t * entry_find(lv_hit_index_t * index, const lv_obj_t * obj);
+static hit_entry_t * entry_insert(lv_hit_index_t * index, lv_obj_t * obj);
+static void entry_delete(lv_hit_index_t * index, hit_entry_t * e);
+static uint32_t entry_hash(const lv_hit_index_t * index, const lv_obj_t * obj);
+static bool is_reachable(const lv_obj_t * obj, const lv_point_t * point);
+static bool is_above(const lv_obj_t * a, const lv_obj_t * b);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+#define index_list  (*((lv_hit_index_t **)&LV_GC_ROOT(_lv_indev_hit_index_list)))
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void lv_indev_hit_index_enable(lv_obj_t * scr, bool en)
+{
+    LV_ASSERT_OBJ(scr, &lv_obj_class);
+
+    if(lv_obj_get_parent(scr) != NULL) {
+        LV_LOG_WARN("only screens can have hit index");
+        return;
+    }
+
+    lv_hit_index_t ** link = &index_list;
+    while(*link && (*link)->scr != scr) link = &(*link)->next;
+
+    if(en && *link == NULL) {
+        lv_hit_index_t * index = lv_mem_alloc(sizeof(lv_hit_index_t));
+        LV_ASSERT_MALLOC(index);
+        if(index == NULL) return;
+        lv_memset_00(index, sizeof(lv_hit_index_t));
+        index->scr = scr;
+        index->next = index_list;
+        index_list = index;
+        index_build(index);
+    }
+    else if(!en && *link) {
+        lv_hit_index_t * index = *link;
+        *link = index->next;
+        index_clear(index);
+        lv_mem_free(index);
+    }
+}
+
+void _lv_indev_hit_index_update(lv_obj_t * obj)
+{
+    lv_hit_index_t * index = get_index(obj);
+    if(index == NULL) return;
+
+    /*The cells follow the screen, e.g. if the display is rotated*/
+    if(obj == index->scr && !_lv_area_is_equal(&obj->coords, &index->area)) {
+        index_clear(index);
+        index_build(index);
+        return;
+    }
+
+    index_update(index, obj);
+}
+
+void _lv_indev_hit_index_update_tree(lv_obj_t * obj)
+{
+    lv_hit_index_t * index = get_index(obj);
+    if(index) index_update_tree(index, obj);
+}
+
+void _lv_indev_hit_index_remove(lv_obj_t * obj)
+{
+    if(lv_obj_get_parent(obj) == NULL) {
+        lv_indev_hit_index_enable(obj, false);
+        return;
+    }
+
+    if(!obj->hit_indexed) return;
+
+    lv_hit_index_t * index = get_index(obj);
+    if(index) index_remove(index, obj);
+}
+
+void _lv_indev_hit_index_remove_tree(lv_obj_t * obj)
+{
+    lv_hit_index_t * index = get_index(obj);
+    if(index) index_remove_tree(index, obj);
+}
+
+bool _lv_indev_hit_index_search(lv_obj_t * scr, const lv_point_t * point, lv_obj_t ** found)
+{
+    lv_hit_index_t * index = index_list;
+    while(index && index->scr != scr) index = index->next;
+
+    if(index == NULL || index->oom || index->transform_cnt) return false;
+    if(!_lv_area_is_point_on(&index->area, point, 0)) return false;
+
+    uint32_t col = (point->x - index->area.x1) / CELL_SIZE;
+    uint32_t row = (point->y - index->area.y1) / CELL_SIZE;
+    const hit_cell_t * cell = &index->cells[row * index->col_cnt + col];
+
+    /*Collect the objects which would be hit tested by the recursive search, in the order it'd test them*/
+    lv_obj_t * cand[CANDIDATE_MAX];
+    uint32_t cand_cnt = 0;
+    uint32_t i;
+    for(i = 0; i < cell->cnt; i++) {
+        lv_obj_t * obj = cell->objs[i];
+        if(lv_obj_has_state(obj, LV_STATE_DISABLED)) continue;
+
+        lv_area_t a;
+        lv_obj_get_click_area(obj, &a);
+        if(!_lv_area_is_point_on(&a, point, 0)) continue;
+        if(!is_reachable(obj, point)) continue;
+
+        if(cand_cnt == CANDIDATE_MAX) return false;
+
+        uint32_t j = cand_cnt;
+        while(j > 0 && is_above(obj, cand[j - 1])) {
+            cand[j] = cand[j - 1];
+            j--;
+        }
+        cand[j] = obj;
+        cand_cnt++;
+    }
+
+    /*The first one passing the hit test, the advanced hit test of the others is not called*/
+    *found = NULL;
+    for(i = 0; i < cand_cnt; i++) {
+        if(lv_obj_hit_test(cand[i], point)) {
+            *found = cand[i];
+            break;
+        }
+    }
+
+    return true;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static lv_hit_index_t * get_index(const lv_obj_t * obj)
+{
+    lv_hit_index_t * index = index_list;
+    if(index == NULL) return NULL;
+
+    const lv_obj_t * scr = lv_obj_get_screen(obj);
+    while(index && index->scr != scr) index = index->next;
+
+    return index;
+}
+
+static void index_build(lv_hit_index_t * index)
+{
+    lv_obj_t * scr = index->scr;
+    index->area = scr->coords;
+    index->col_cnt = (lv_area_get_width(&scr->coords) + CELL_SIZE - 1) / CELL_SIZE;
+    index->row_cnt = (lv_area_get_height(&scr->coords) + CELL_SIZE - 1) / CELL_SIZE;
+
+    uint32_t cell_cnt = (uint32_t)index->col_cnt * index->row_cnt;
+    if(cell_cnt) {
+        index->cells = lv_mem_alloc(cell_cnt * sizeof(hit_cell_t));
+        LV_ASSERT_MALLOC(index->cells);
+        if(index->cells == NULL) {
+            index->oom = true;
+            return;
+        }
+        lv_memset_00(index->cells, cell_cnt * sizeof(hit_cell_t));
+    }
+
+    index_update_tree(index, scr);
+}
+
+static void index_clear(lv_hit_index_t * index)
+{
+    uint32_t i;
+    for(i = 0; i < index->entry_cap; i++) {
+        if(index->entries[i].obj) index->entries[i].obj->hit_indexed = 0;
+    }
+
+    uint32_t cell_cnt = (uint32_t)index->col_cnt * index->row_cnt;
+    if(index->cells) {
+        for(i = 0; i < cell_cnt; i++) {
+            if(index->cells[i].objs) lv_mem_free(index->cells[i].objs);
+        }
+    }
+
+    if(index->cells) lv_mem_free(index->cells);
+    if(index->entries) lv_mem_free(index->entries);
+    index->cells = NULL;
+    index->entries = NULL;
+    index->entry_cap = 0;
+    index->entry_cnt = 0;
+    index->transform_cnt = 0;
+    index->oom = false;
+}
+
+static void index_update(lv_hit_index_t * index, lv_obj_t * obj)
+{
+    if(index->oom) return;
+
+    /*The cells of the click area on the screen*/
+    bool in_cells = false;
+    uint16_t x1 = 1, y1 = 0, x2 = 0, y2 = 0;
+    lv_area_t a;
+    if(lv_obj_has_flag(obj, LV_OBJ_FLAG_CLICKABLE)) {
+        lv_obj_get_click_area(obj, &a);
+        in_cells = _lv_area_intersect(&a, &a, &index->area);
+    }
+    if(in_cells) {
+        x1 = (a.x1 - index->area.x1) / CELL_SIZE;
+        y1 = (a.y1 - index->area.y1) / CELL_SIZE;
+        x2 = (a.x2 - index->area.x1) / CELL_SIZE;
+        y2 = (a.y2 - index->area.y1) / CELL_SIZE;
+    }
+    bool transformed = _lv_obj_get_layer_type(obj) == LV_LAYER_TYPE_TRANSFORM;
+
+    hit_entry_t * e = obj->hit_indexed ? entry_find(index, obj) : NULL;
+    if(e == NULL) {
+        if(!in_cells && !transformed) return;
+        e = entry_insert(index, obj);
+        if(e == NULL) return;
+    }
+
+    if(e->x1 != x1 || e->y1 != y1 || e->x2 != x2 || e->y2 != y2) {
+        uint32_t x;
+        uint32_t y;
+        for(y = e->y1; e->x1 <= e->x2 && y <= e->y2; y++) {
+            for(x = e->x1; x <= e->x2; x++) cell_remove(&index->cells[y * index->col_cnt + x], obj);
+        }
+        for(y = y1; in_cells && y <= y2; y++) {
+            for(x = x1; x <= x2; x++) {
+                if(!cell_add(&index->cells[y * index->col_cnt + x], obj)) index->oom = true;
+            }
+        }
+        e->x1 = x1;
+        e->y1 = y1;
+        e->x2 = x2;
+        e->y2 = y2;
+    }
+
+    if(e->transformed != transformed) {
+        if(transformed) index->transform_cnt++;
+        else index->transform_cnt--;
+        e->transformed = transformed;
+    }
+
+    if(!in_cells && !transformed) {
+        entry_delete(index, e);
+        obj->hit_indexed = 0;
+    }
+}
+
+static void index_update_tree(lv_hit_index_t * index, lv_obj_t * obj)
+{
+    index_update(index, obj);
+
+    uint32_t child_cnt = lv_obj_get_child_cnt(obj);
+    uint32_t i;
+    for(i = 0; i < child_cnt; i++) {
+        index_update_tree(index, obj->spec_attr->children[i]);
+    }
+}
+
+static void index_remove(lv_hit_index_t * index, lv_obj_t * obj)
+{
+    if(!obj->hit_indexed) return;
+    obj->hit_indexed = 0;
+
+    hit_entry_t * e = entry_find(index, obj);
+    if(e == NULL) return;
+
+    uint32_t x;
+    uint32_t y;
+    for(y = e->y1; e->x1 <= e->x2 && y <= e->y2; y++) {
+        for(x = e->x1; x <= e->x2; x++) cell_remove(&index->cells[y * index->col_cnt + x], obj);
+    }
+
+    if(e->transformed) index->transform_cnt--;
+    entry_delete(index, e);
+}
+
+static void index_remove_tree(lv_hit_index_t * index, lv_obj_t * obj)
+{
+    index_remove(index, obj);
+
+    uint32_t child_cnt = lv_obj_get_child_cnt(obj);
+    uint32_t i;
+    for(i = 0; i < child_cnt; i++) {
+        index_remove_tree(index, obj->spec_attr->children[i]);
+    }
+}
+
+static bool cell_add(hit_cell_t * cell, lv_obj_t * obj)
+{
+    if(cell->cnt == cell->cap) {
+        uint16_t cap = cell->cap ? cell->cap * 2 : 4;
+        lv_obj_t ** objs = lv_mem_realloc(cell->objs, cap * sizeof(lv_obj_t *));
+        LV_ASSERT_MALLOC(objs);
+        if(objs == NULL) return false;
+        cell->objs = objs;
+        cell->cap = cap;
+    }
+
+    cell->objs[cell->cnt] = obj;
+    cell->cnt++;
+    return true;
+}
+
+static void cell_remove(hit_cell_t * cell, lv_obj_t * obj)
+{
+    uint32_t i;
+    for(i = 0; i < cell->cnt; i++) {
+        if(cell->objs[i] == obj) {
+            cell->cnt--;
+            cell->objs[i] = cell->objs[cell->cnt];
+            return;
+        }
+    }
+}
+
+static hit_entry_t * entry_find(lv_hit_index_t * index, const lv_obj_t * obj)
+{
+    if(index->entry_cap == 0) return NULL;
+
+    uint32_t mask = index->entry_cap - 1;
+    uint32_t i;
+    for(i = entry_hash(index, obj); index->entries[i].obj; i = (i + 1) & mask) {
+        if(index->entries[i].obj == obj) return &index->entries[i];
+    }
+
+    return NULL;
+}
+
+static hit_entry_t * entry_insert(lv_hit_index_t * index, lv_obj_t * obj)
+{
+    /*Keep the table at most half full*/
+    if((index->entry_cnt + 1) * 2 > index->entry_cap) {
+        uint32_t cap = index->entry_cap ? index->entry_cap * 2 : 64;
+        hit_entry_t * entries = lv_mem_alloc(cap * sizeof(hit_entry_t));
+        LV_ASSERT_MALLOC(entries);
+        if(entries == NULL) {
+            index->oom = true;
+            return NULL;
+        }
+        lv_memset_00(entries, cap * sizeof(hit_entry_t));
+
+        hit_entry_t * old = index->entries;
+        uint32_t old_cap = index->entry_cap;
+        index->entries = entries;
+        index->entry_cap = cap;
+
+        uint32_t i;
+        for(i = 0; i < old_cap; i++) {
+            if(old[i].obj == NULL) continue;
+            uint32_t j = entry_hash(index, old[i].obj);
+            while(entries[j].obj) j = (j + 1) & (cap - 1);
+            entries[j] = old[i];
+        }
+        if(old) lv_mem_free(old);
+    }
+
+    uint32_t i = entry_hash(index, obj);
+    while(index->entries[i].obj) i = (i + 1) & (index->entry_cap - 1);
+
+    hit_entry_t * e = &index->entries[i];
+    e->obj = obj;
+    e->x1 = 1;
+    e->y1 = 0;
+    e->x2 = 0;
+    e->y2 = 0;
+    e->transformed = 0;
+    index->entry_cnt++;
+    obj->hit_indexed = 1;
+
+    return e;
+}
+
+static void entry_delete(lv_hit_index_t * index, hit_entry_t * e)
+{
+    uint32_t mask = index->entry_cap - 1;
+    uint32_t i = e - index->entries;
+    index->entries[i].obj = NULL;
+    index->entry_cnt--;
+
+    /*Move back the following entries of the run which are not at their home slot any more*/
+    uint32_t j = (i + 1) & mask;
+    while(index->entries[j].obj) {
+        uint32_t home = entry_hash(index, index->entries[j].obj);
+        if(((j - home) & mask) >= ((j - i) & mask)) {
+            index->entries[i] = index->entries[j];
+            index->entries[j].obj = NULL;
+            i = j;
+        }
+        j = (j + 1) & mask;
+    }
+}
+
+static uint32_t entry_hash(const lv_hit_index_t * index, const lv_obj_t * obj)
+{
+    uint32_t key = (uint32_t)((lv_uintptr_t)obj >> 3) * 2654435761U;
+    return (key ^ (key >> 16)) & (index->entry_cap - 1);
+}
+
+/**
+ * Tell if the recursive search gets to an object: it and its parents are not hidden,
+ * and the point is on the parents, or their overflow is visible.
+ */
+static bool is_reachable(const lv_obj_t * obj, const lv_point_t * point)
+{
+    if(lv_obj_has_flag(obj, LV_OBJ_FLAG_HIDDEN)) return false;
+
+    const lv_obj_t * parent;
+    for(parent = obj->parent; parent; parent = parent->parent) {
+        if(lv_obj_has_flag(parent, LV_OBJ_FLAG_HIDDEN)) return false;
+        if(!_lv_area_is_point_on(&parent->coords, point, 0) &&
+           !lv_obj_has_flag(parent, LV_OBJ_FLAG_OVERFLOW_VISIBLE)) return false;
+    }
+
+    return true;
+}
+
+/**
+ * Tell if the recursive search tests `a` before `b`, i.e. `a` is a child of `b`
+ * or `a` is in a later child of their common parent
+ */
+static bool is_above(const lv_obj_t * a, const lv_obj_t * b)
+{
+    uint32_t a_depth = 0;
+    uint32_t b_depth = 0;
+    const lv_obj_t * p;
+    for(p = a->parent; p; p = p->parent) a_depth++;
+    for(p = b->parent; p; p = p->parent) b_depth++;
+
+    const lv_obj_t * a_anc = a;
+    const lv_obj_t * b_anc = b;
+    while(a_depth > b_depth) {
+        a_anc = a_anc->parent;
+        a_depth--;
+    }
+    while(b_depth > a_depth) {
+        b_anc = b_anc->parent;
+        b_depth--;
+    }
+
+    /*One is the parent of the other*/
+    if(a_anc == b_anc) return a_anc != a;
+
+    while(a_anc->parent != b_anc->parent) {
+        a_anc = a_anc->parent;
+        b_anc = b_anc->parent;
+    }
+
+    return lv_obj_get_index(a_anc) > lv_obj_get_index(b_anc);
+}
+
+#endif /*LV_INDEV_HIT_INDEX_CELL_SIZE*/
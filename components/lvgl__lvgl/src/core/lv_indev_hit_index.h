@@ -0,0 +1,77 @@
+/**
+ * @file lv_indev_hit_index.h
+ *
+ */
+
+#ifndef LV_INDEV_HIT_INDEX_H
+#define LV_INDEV_HIT_INDEX_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_obj.h"
+
+#if LV_INDEV_HIT_INDEX_CELL_SIZE
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Update the hit index of the screen of an object after the object's coordinates, click area,
+ * clickable flag or transformation has changed. Only the object itself is updated.
+ * @param obj       pointer to an object
+ */
+void _lv_indev_hit_index_update(lv_obj_t * obj);
+
+/**
+ * Update an object and all its children in the hit index, e.g. after it was moved to another screen
+ * @param obj       pointer to an object
+ */
+void _lv_indev_hit_index_update_tree(lv_obj_t * obj);
+
+/**
+ * Remove an object from the hit index of its screen before it's deleted.
+ * If `obj` is a screen with hit index, the index is deleted.
+ * @param obj       pointer to an object
+ */
+void _lv_indev_hit_index_remove(lv_obj_t * obj);
+
+/**
+ * Remove an object and all its children from the hit index of their screen, e.g. before it's moved to another screen
+ * @param obj       pointer to an object
+ */
+void _lv_indev_hit_index_remove_tree(lv_obj_t * obj);
+
+/**
+ * Search the object under a point with the hit index of a screen, like `lv_indev_search_obj` does it recursively.
+ * @param scr       pointer to a screen
+ * @param point     the point to search
+ * @param found     store the found object or NULL here
+ * @return          true: `found` is the result; false: the screen has no usable index, use the recursive search
+ */
+bool _lv_indev_hit_index_search(lv_obj_t * scr, const lv_point_t * point, lv_obj_t ** found);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif /*LV_INDEV_HIT_INDEX_CELL_SIZE*/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_INDEV_HIT_INDEX_H*/
@@ -8,12 +8,14 @@
  *********************/
 #include "lv_obj.h"
 #include "lv_indev.h"
+#include "lv_indev_hit_index.h"
 #include "lv_refr.h"
 #include "lv_group.h"
 #include "lv_disp.h"
 #include "lv_theme.h"
 #include "../misc/lv_assert.h"
 #include "../draw/lv_draw.h"
+#include "../draw/sw/lv_draw_sw.h"
 #include "../misc/lv_anim.h"
 #include "../misc/lv_timer.h"
 #include "../misc/lv_async.h"
@@ -196,6 +198,18 @@ void lv_init(void)
 
 void lv_deinit(void)
 {
+#ifdef LV_CACHE_MEM_ALLOC
+    /*The caches are not in the LVGL heap so freeing the heap doesn't free them*/
+    lv_draw_sw_shadow_cache_clear();
+    lv_font_fmt_txt_bitmap_cache_clear();
+#if LV_OBJ_STYLE_CACHE_DEF_SIZE
+    lv_obj_style_cache_set_size(0);
+#endif
+#if LV_IMG_CACHE_DEF_SIZE
+    lv_img_cache_set_size(0);
+#endif
+#endif
+
     _lv_gc_clear_roots();
 
     lv_disp_set_default(NULL);
@@ -237,6 +251,10 @@ void lv_obj_add_flag(lv_obj_t * obj, lv_obj_flag_t f)
 
     obj->flags |= f;
 
+#if LV_INDEV_HIT_INDEX_CELL_SIZE
+    if(f & LV_OBJ_FLAG_CLICKABLE) _lv_indev_hit_index_update(obj);
+#endif
+
     if(f & LV_OBJ_FLAG_HIDDEN) {
         if(lv_obj_has_state(obj, LV_STATE_FOCUSED)) {
             lv_group_t * group = lv_obj_get_group(obj);
@@ -277,6 +295,10 @@ void lv_obj_clear_flag(lv_obj_t * obj, lv_obj_flag_t f)
 
     obj->flags &= (~f);
 
+#if LV_INDEV_HIT_INDEX_CELL_SIZE
+    if(f & LV_OBJ_FLAG_CLICKABLE) _lv_indev_hit_index_update(obj);
+#endif
+
     if(f & LV_OBJ_FLAG_HIDDEN) {
         lv_obj_invalidate(obj);
         if(lv_obj_is_layout_positioned(obj)) {
@@ -474,6 +496,12 @@ static void lv_obj_destructor(const lv_obj_class_t * class_p, lv_obj_t * obj)
             lv_mem_free(obj->spec_attr->event_dsc);
             obj->spec_attr->event_dsc = NULL;
         }
+#if LV_USE_FLEX && LV_FLEX_CACHE
+        if(obj->spec_attr->flex_cache) {
+            lv_mem_free(obj->spec_attr->flex_cache);
+            obj->spec_attr->flex_cache = NULL;
+        }
+#endif
 
         lv_mem_free(obj->spec_attr);
         obj->spec_attr = NULL;
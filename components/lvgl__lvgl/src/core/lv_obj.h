@@ -162,6 +162,10 @@ typedef struct {
     lv_coord_t ext_click_pad;           /**< Extra click padding in all direction*/
     lv_coord_t ext_draw_size;           /**< EXTend the size in every direction for drawing.*/
 
+#if LV_USE_FLEX && LV_FLEX_CACHE
+    void * flex_cache;                  /**< The items of a flex container after the last layout*/
+#endif
+
     lv_scrollbar_mode_t scrollbar_mode : 2; /**< How to display scrollbars*/
     lv_scroll_snap_t scroll_snap_x : 2;     /**< Where to align the snappable children horizontally*/
     lv_scroll_snap_t scroll_snap_y : 2;     /**< Where to align the snappable children vertically*/
@@ -182,6 +186,8 @@ typedef struct _lv_obj_t {
     lv_obj_flag_t flags;
     lv_state_t state;
     uint16_t layout_inv : 1;
+    uint16_t child_layout_inv : 1;  /*Some descendants need layout update or scroll readjustment*/
+    uint16_t parent_layout_inv : 1; /*A style affecting its place in the parent's layout has changed*/
     uint16_t readjust_scroll_after_layout : 1;
     uint16_t scr_layout_inv : 1;
     uint16_t skip_trans : 1;
@@ -189,6 +195,7 @@ typedef struct _lv_obj_t {
     uint16_t h_layout   : 1;
     uint16_t w_layout   : 1;
     uint16_t being_deleted   : 1;
+    uint16_t hit_indexed     : 1;   /*In the hit index of its screen*/
 } lv_obj_t;
 
 /**********************
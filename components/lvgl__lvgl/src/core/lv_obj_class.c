@@ -8,6 +8,7 @@
  *********************/
 #include "lv_obj.h"
 #include "lv_theme.h"
+#include "lv_indev_hit_index.h"
 
 /*********************
  *      DEFINES
@@ -114,6 +115,10 @@ void lv_obj_class_init_obj(lv_obj_t * obj)
 
     lv_obj_refresh_self_size(obj);
 
+#if LV_INDEV_HIT_INDEX_CELL_SIZE
+    _lv_indev_hit_index_update(obj);
+#endif
+
     lv_group_t * def_group = lv_group_get_default();
     if(def_group && lv_obj_is_group_def(obj)) {
         lv_group_add_obj(def_group, obj);
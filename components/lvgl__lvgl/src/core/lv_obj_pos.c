@@ -9,6 +9,7 @@
 #include "lv_obj.h"
 #include "lv_disp.h"
 #include "lv_refr.h"
+#include "lv_indev_hit_index.h"
 #include "../misc/lv_gc.h"
 
 /*********************
@@ -26,6 +27,7 @@
 static lv_coord_t calc_content_width(lv_obj_t * obj);
 static lv_coord_t calc_content_height(lv_obj_t * obj);
 static void layout_update_core(lv_obj_t * obj);
+static void mark_parents_layout(lv_obj_t * obj);
 static void transform_point(const lv_obj_t * obj, lv_point_t * p, bool inv);
 
 /**********************
@@ -191,6 +193,10 @@ bool lv_obj_refr_size(lv_obj_t * obj)
         obj->coords.x2 = obj->coords.x1 + w - 1;
     }
 
+#if LV_INDEV_HIT_INDEX_CELL_SIZE
+    _lv_indev_hit_index_update(obj);
+#endif
+
     /*Call the ancestor's event handler to the object with its new coordinates*/
     lv_event_send(obj, LV_EVENT_SIZE_CHANGED, &ori);
 
@@ -201,6 +207,7 @@ bool lv_obj_refr_size(lv_obj_t * obj)
     lv_obj_invalidate(obj);
 
     obj->readjust_scroll_after_layout = 1;
+    mark_parents_layout(obj);
 
     /*If the object was out of the parent invalidate the new scrollbar area too.
      *If it wasn't out of the parent but out now, also invalidate the scrollbars*/
@@ -288,6 +295,7 @@ bool lv_obj_is_layout_positioned(const lv_obj_t * obj)
 void lv_obj_mark_layout_as_dirty(lv_obj_t * obj)
 {
     obj->layout_inv = 1;
+    mark_parents_layout(obj);
 
     /*Mark the screen as dirty too to mark that there is something to do on this screen*/
     lv_obj_t * scr = lv_obj_get_screen(obj);
@@ -763,6 +771,10 @@ void lv_obj_move_to(lv_obj_t * obj, lv_coord_t x, lv_coord_t y)
 
     lv_obj_move_children_by(obj, diff.x, diff.y, false);
 
+#if LV_INDEV_HIT_INDEX_CELL_SIZE
+    _lv_indev_hit_index_update(obj);
+#endif
+
     /*Call the ancestor's event handler to the parent too*/
     if(parent) lv_event_send(parent, LV_EVENT_CHILD_CHANGED, obj);
 
@@ -790,6 +802,10 @@ void lv_obj_move_children_by(lv_obj_t * obj, lv_coord_t x_diff, lv_coord_t y_dif
         child->coords.y2 += y_diff;
 
         lv_obj_move_children_by(child, x_diff, y_diff, false);
+
+#if LV_INDEV_HIT_INDEX_CELL_SIZE
+        _lv_indev_hit_index_update(child);
+#endif
     }
 }
 
@@ -933,6 +949,10 @@ void lv_obj_set_ext_click_area(lv_obj_t * obj, lv_coord_t size)
 
     lv_obj_allocate_spec_attr(obj);
     obj->spec_attr->ext_click_pad = size;
+
+#if LV_INDEV_HIT_INDEX_CELL_SIZE
+    _lv_indev_hit_index_update(obj);
+#endif
 }
 
 void lv_obj_get_click_area(const lv_obj_t * obj, lv_area_t * area)
@@ -1125,9 +1145,14 @@ static void layout_update_core(lv_obj_t * obj)
 {
     uint32_t i;
     uint32_t child_cnt = lv_obj_get_child_cnt(obj);
-    for(i = 0; i < child_cnt; i++) {
-        lv_obj_t * child = obj->spec_attr->children[i];
-        layout_update_core(child);
+
+    /*Skip the subtrees where nothing has changed*/
+    if(obj->child_layout_inv) {
+        obj->child_layout_inv = 0;
+        for(i = 0; i < child_cnt; i++) {
+            lv_obj_t * child = obj->spec_attr->children[i];
+            layout_update_core(child);
+        }
     }
 
     if(obj->layout_inv) {
@@ -1150,6 +1175,19 @@ static void layout_update_core(lv_obj_t * obj)
     }
 }
 
+/**
+ * Mark the parents of an object to have a child to update in `layout_update_core`.
+ * The parents of a marked object are marked too, so it can stop at the first marked one.
+ */
+static void mark_parents_layout(lv_obj_t * obj)
+{
+    lv_obj_t * parent = obj->parent;
+    while(parent && !parent->child_layout_inv) {
+        parent->child_layout_inv = 1;
+        parent = parent->parent;
+    }
+}
+
 static void transform_point(const lv_obj_t * obj, lv_point_t * p, bool inv)
 {
     int16_t angle = lv_obj_get_style_transform_angle(obj, 0);
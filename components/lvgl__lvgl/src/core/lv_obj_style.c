@@ -8,13 +8,18 @@
  *********************/
 #include "lv_obj.h"
 #include "lv_disp.h"
+#include "lv_indev_hit_index.h"
 #include "../misc/lv_gc.h"
+#include "../misc/lv_trace.h"
 
 /*********************
  *      DEFINES
  *********************/
 #define MY_CLASS &lv_obj_class
 
+/*The entries of an object are in a group of this many slots, so it's cheap to drop them*/
+#define STYLE_CACHE_OBJ_SLOTS   32
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -35,6 +40,18 @@ typedef enum {
     CACHE_NEED_CHECK = 4,
 } cache_t;
 
+#if LV_OBJ_STYLE_CACHE_DEF_SIZE
+/*The result of `get_prop_core` for a property of an object's part in a state*/
+typedef struct {
+    const lv_obj_t * obj;       /*NULL: free slot*/
+    lv_style_value_t value;
+    uint16_t prop;
+    lv_state_t state;
+    uint8_t part;               /*The part shifted down to 8 bit*/
+    uint8_t res;                /*An `lv_style_res_t`*/
+} style_cache_entry_t;
+#endif
+
 /**********************
  *  GLOBAL PROTOTYPES
  **********************/
@@ -45,6 +62,8 @@ typedef enum {
 static lv_style_t * get_local_style(lv_obj_t * obj, lv_style_selector_t selector);
 static _lv_obj_style_t * get_trans_style(lv_obj_t * obj, uint32_t part);
 static lv_style_res_t get_prop_core(const lv_obj_t * obj, lv_part_t part, lv_style_prop_t prop, lv_style_value_t * v);
+static lv_style_res_t get_prop_cached(const lv_obj_t * obj, lv_part_t part, lv_style_prop_t prop, lv_style_value_t * v);
+static void style_cache_invalidate(const lv_obj_t * obj);
 static void report_style_change_core(void * style, lv_obj_t * obj);
 static void refresh_children_style(lv_obj_t * obj);
 static bool trans_del(lv_obj_t * obj, lv_part_t part, lv_style_prop_t prop, trans_t * tr_limit);
@@ -59,6 +78,10 @@ static void fade_in_anim_ready(lv_anim_t * a);
  *  STATIC VARIABLES
  **********************/
 static bool style_refr = true;
+#if LV_OBJ_STYLE_CACHE_DEF_SIZE
+    static uint32_t style_cache_size = LV_OBJ_STYLE_CACHE_DEF_SIZE;
+    static lv_obj_style_cache_stats_t style_cache_stats;
+#endif
 
 /**********************
  *      MACROS
@@ -71,6 +94,10 @@ static bool style_refr = true;
 void _lv_obj_style_init(void)
 {
     _lv_ll_init(&LV_GC_ROOT(_lv_obj_style_trans_ll), sizeof(trans_t));
+#if LV_OBJ_STYLE_CACHE_DEF_SIZE
+    LV_GC_ROOT(_lv_obj_style_cache) = NULL;
+    lv_obj_style_cache_set_size(LV_OBJ_STYLE_CACHE_DEF_SIZE);
+#endif
 }
 
 void lv_obj_add_style(lv_obj_t * obj, lv_style_t * style, lv_style_selector_t selector)
@@ -152,7 +179,13 @@ void lv_obj_remove_style(lv_obj_t * obj, lv_style_t * style, lv_style_selector_t
 
 void lv_obj_report_style_change(lv_style_t * style)
 {
-    if(!style_refr) return;
+    if(!style_refr) {
+        /*The objects using the style are not visited so drop all the cached values*/
+        style_cache_invalidate(NULL);
+        return;
+    }
+
+    LV_TRACE_BEGIN(LV_TRACE_STAGE_STYLE);
     lv_disp_t * d = lv_disp_get_next(NULL);
 
     while(d) {
@@ -162,14 +195,19 @@ void lv_obj_report_style_change(lv_style_t * style)
         }
         d = lv_disp_get_next(d);
     }
+    LV_TRACE_END(LV_TRACE_STAGE_STYLE);
 }
 
 void lv_obj_refresh_style(lv_obj_t * obj, lv_style_selector_t selector, lv_style_prop_t prop)
 {
     LV_ASSERT_OBJ(obj, MY_CLASS);
 
+    /*Drop the cached values even if the refresh is disabled because the styles have changed*/
+    style_cache_invalidate(obj);
+
     if(!style_refr) return;
 
+    LV_TRACE_BEGIN(LV_TRACE_STAGE_STYLE);
     lv_obj_invalidate(obj);
 
     lv_part_t part = lv_obj_style_get_selector_part(selector);
@@ -190,7 +228,10 @@ void lv_obj_refresh_style(lv_obj_t * obj, lv_style_selector_t selector, lv_style
     }
     if((part == LV_PART_ANY || part == LV_PART_MAIN) && (prop == LV_STYLE_PROP_ANY || is_layout_refr)) {
         lv_obj_t * parent = lv_obj_get_parent(obj);
-        if(parent) lv_obj_mark_layout_as_dirty(parent);
+        if(parent) {
+            obj->parent_layout_inv = 1;
+            lv_obj_mark_layout_as_dirty(parent);
+        }
     }
 
     /*Cache the layer type*/
@@ -201,6 +242,9 @@ void lv_obj_refresh_style(lv_obj_t * obj, lv_style_selector_t selector, lv_style
             lv_obj_allocate_spec_attr(obj);
             obj->spec_attr->layer_type = layer_type;
         }
+#if LV_INDEV_HIT_INDEX_CELL_SIZE
+        _lv_indev_hit_index_update(obj);
+#endif
     }
 
     if(prop == LV_STYLE_PROP_ANY || is_ext_draw) {
@@ -213,6 +257,7 @@ void lv_obj_refresh_style(lv_obj_t * obj, lv_style_selector_t selector, lv_style
             refresh_children_style(obj);
         }
     }
+    LV_TRACE_END(LV_TRACE_STAGE_STYLE);
 }
 
 void lv_obj_enable_style_refresh(bool en)
@@ -220,13 +265,55 @@ void lv_obj_enable_style_refresh(bool en)
     style_refr = en;
 }
 
+void lv_obj_style_cache_set_size(uint32_t entry_cnt)
+{
+#if LV_OBJ_STYLE_CACHE_DEF_SIZE == 0
+    LV_UNUSED(entry_cnt);
+    LV_LOG_WARN("Can't change cache size because it's disabled by LV_OBJ_STYLE_CACHE_DEF_SIZE = 0");
+#else
+    LV_ASSERT_MSG(!_lv_parallel_is_active(), "Can't resize the style cache while rendering");
+
+    if(LV_GC_ROOT(_lv_obj_style_cache)) {
+        lv_mem_cache_free(LV_GC_ROOT(_lv_obj_style_cache));
+        LV_GC_ROOT(_lv_obj_style_cache) = NULL;
+    }
+
+    /*Use whole groups only*/
+    style_cache_size = entry_cnt - entry_cnt % STYLE_CACHE_OBJ_SLOTS;
+    if(style_cache_size == 0) return;
+
+    uint32_t mem_size = style_cache_size * sizeof(style_cache_entry_t);
+    LV_GC_ROOT(_lv_obj_style_cache) = lv_mem_cache_alloc(mem_size);
+    LV_ASSERT_MALLOC(LV_GC_ROOT(_lv_obj_style_cache));
+    if(LV_GC_ROOT(_lv_obj_style_cache) == NULL) {
+        LV_LOG_WARN("Couldn't allocate the style cache");
+        style_cache_size = 0;
+        return;
+    }
+    lv_memset_00(LV_GC_ROOT(_lv_obj_style_cache), mem_size);
+#endif
+}
+
+void lv_obj_style_cache_get_stats(lv_obj_style_cache_stats_t * stats)
+{
+#if LV_OBJ_STYLE_CACHE_DEF_SIZE
+    *stats = style_cache_stats;
+    stats->entry_max = style_cache_size;
+#else
+    lv_memset_00(stats, sizeof(lv_obj_style_cache_stats_t));
+#endif
+}
+
 lv_style_value_t lv_obj_get_style_prop(const lv_obj_t * obj, lv_part_t part, lv_style_prop_t prop)
 {
     lv_style_value_t value_act;
     bool inheritable = lv_style_prop_has_flag(prop, LV_STYLE_PROP_INHERIT);
     lv_style_res_t found = LV_STYLE_RES_NOT_FOUND;
+#if LV_OBJ_STYLE_CACHE_DEF_SIZE
+    if(!_lv_parallel_is_active()) style_cache_stats.lookup_cnt++;
+#endif
     while(obj) {
-        found = get_prop_core(obj, part, prop, &value_act);
+        found = get_prop_cached(obj, part, prop, &value_act);
         if(found == LV_STYLE_RES_FOUND) break;
         if(!inheritable) break;
 
@@ -341,6 +428,7 @@ void _lv_obj_style_create_transition(lv_obj_t * obj, lv_part_t part, lv_state_t
 
     _lv_obj_style_t * style_trans = get_trans_style(obj, part);
     lv_style_set_prop(style_trans->style, tr_dsc->prop, v1);   /*Be sure `trans_style` has a valid value*/
+    style_cache_invalidate(obj);
 
     if(tr_dsc->prop == LV_STYLE_RADIUS) {
         if(v1.num == LV_RADIUS_CIRCLE || v2.num == LV_RADIUS_CIRCLE) {
@@ -665,6 +753,98 @@ static lv_style_res_t get_prop_core(const lv_obj_t * obj, lv_part_t part, lv_sty
     else return LV_STYLE_RES_NOT_FOUND;
 }
 
+#if LV_OBJ_STYLE_CACHE_DEF_SIZE
+/**
+ * Get the slots of the style cache where the properties of an object can be stored
+ * @param cache     the style cache
+ * @param obj       pointer to an object
+ * @return          pointer to the first of `STYLE_CACHE_OBJ_SLOTS` entries
+ */
+static inline style_cache_entry_t * get_style_cache_group(style_cache_entry_t * cache, const lv_obj_t * obj)
+{
+    uint32_t h = (uint32_t)((lv_uintptr_t)obj >> 3) * 2654435761U;
+    return &cache[((h >> 8) % (style_cache_size / STYLE_CACHE_OBJ_SLOTS)) * STYLE_CACHE_OBJ_SLOTS];
+}
+#endif
+
+/**
+ * Get a property from the style cache or search it with `get_prop_core` and add it to the cache.
+ * The result depends only on the object's styles so the cached value is valid until
+ * `style_cache_invalidate` is called for the object.
+ * @param obj       pointer to an object
+ * @param part      the part whose property should be get
+ * @param prop      the property to get
+ * @param v         store the value here
+ * @return          the result of `get_prop_core`
+ */
+static lv_style_res_t get_prop_cached(const lv_obj_t * obj, lv_part_t part, lv_style_prop_t prop, lv_style_value_t * v)
+{
+#if LV_OBJ_STYLE_CACHE_DEF_SIZE
+    /*The worker thread doesn't touch the cache, it only reads the styles*/
+    if(_lv_parallel_is_active()) return get_prop_core(obj, part, prop, v);
+
+    style_cache_entry_t * cache = LV_GC_ROOT(_lv_obj_style_cache);
+
+    /*Skipping the transitions is temporary, don't cache the values seen this way*/
+    if(cache == NULL || obj->skip_trans) {
+        style_cache_stats.walk_cnt++;
+        return get_prop_core(obj, part, prop, v);
+    }
+
+    uint8_t part_id = (uint8_t)(part >> 16);
+    uint32_t h = (prop + ((uint32_t)part_id << 9) + ((uint32_t)obj->state << 13)) * 2654435761U;
+    /*2 ways: the newest entry is in the first slot of the pair*/
+    style_cache_entry_t * e = &get_style_cache_group(cache, obj)[((h >> 16) % (STYLE_CACHE_OBJ_SLOTS / 2)) * 2];
+    uint32_t i;
+    for(i = 0; i < 2; i++) {
+        if(e[i].obj == obj && e[i].prop == prop && e[i].part == part_id && e[i].state == obj->state) {
+            style_cache_stats.hit_cnt++;
+            *v = e[i].value;
+            return e[i].res;
+        }
+    }
+
+    style_cache_stats.walk_cnt++;
+    lv_style_res_t res = get_prop_core(obj, part, prop, v);
+    e[1] = e[0];
+    e->obj = obj;
+    e->prop = prop;
+    e->part = part_id;
+    e->state = obj->state;
+    e->res = res;
+    if(res == LV_STYLE_RES_FOUND) e->value = *v;
+    return res;
+#else
+    return get_prop_core(obj, part, prop, v);
+#endif
+}
+
+/**
+ * Drop the cached style properties of an object
+ * @param obj       pointer to an object or NULL to drop all the cached properties
+ */
+static void style_cache_invalidate(const lv_obj_t * obj)
+{
+#if LV_OBJ_STYLE_CACHE_DEF_SIZE
+    style_cache_entry_t * cache = LV_GC_ROOT(_lv_obj_style_cache);
+    if(cache == NULL) return;
+
+    if(obj == NULL) {
+        lv_memset_00(cache, style_cache_size * sizeof(style_cache_entry_t));
+        return;
+    }
+
+    /*Only this group can have the entries of the object*/
+    style_cache_entry_t * e = get_style_cache_group(cache, obj);
+    uint32_t i;
+    for(i = 0; i < STYLE_CACHE_OBJ_SLOTS; i++) {
+        if(e[i].obj == obj) e[i].obj = NULL;
+    }
+#else
+    LV_UNUSED(obj);
+#endif
+}
+
 /**
  * Refresh the style of all children of an object. (Called recursively)
  * @param style refresh objects only with this
@@ -745,6 +925,7 @@ static bool trans_del(lv_obj_t * obj, lv_part_t part, lv_style_prop_t prop, tran
         }
         tr = tr_prev;
     }
+    if(removed) style_cache_invalidate(obj);
     return removed;
 }
 
@@ -830,6 +1011,7 @@ static void trans_anim_start_cb(lv_anim_t * a)
 
     _lv_obj_style_t * style_trans = get_trans_style(tr->obj, tr->selector);
     lv_style_set_prop(style_trans->style, tr->prop, tr->start_value);   /*Be sure `trans_style` has a valid value*/
+    style_cache_invalidate(tr->obj);
 
 }
 
@@ -860,6 +1042,7 @@ static void trans_anim_ready_cb(lv_anim_t * a)
 
                 _lv_obj_style_t * obj_style = &obj->styles[i];
                 lv_style_remove_prop(obj_style->style, prop);
+                style_cache_invalidate(obj);
 
                 if(lv_style_is_empty(obj->styles[i].style)) {
                     lv_obj_remove_style(obj, obj_style->style, obj_style->selector);
@@ -43,6 +43,13 @@ typedef struct {
     uint32_t is_trans : 1;
 } _lv_obj_style_t;
 
+typedef struct {
+    uint32_t lookup_cnt;    /**< Number of style properties read*/
+    uint32_t walk_cnt;      /**< Number of times the styles of an object were searched for a property*/
+    uint32_t hit_cnt;       /**< Number of times a cached value was used instead of searching the styles*/
+    uint32_t entry_max;     /**< Number of properties the cache can store*/
+} lv_obj_style_cache_stats_t;
+
 typedef struct {
     uint16_t time;
     uint16_t delay;
@@ -118,6 +125,19 @@ void lv_obj_refresh_style(struct _lv_obj_t * obj, lv_part_t part, lv_style_prop_
  */
 void lv_obj_enable_style_refresh(bool en);
 
+/**
+ * Set the number of style properties to cache. The cached values are dropped.
+ * The properties of an object share a group of slots so the size is rounded down to whole groups.
+ * @param entry_cnt number of properties to cache. 0: to disable caching
+ */
+void lv_obj_style_cache_set_size(uint32_t entry_cnt);
+
+/**
+ * Get the lookup and hit counters of the style cache.
+ * @param stats     store the statistics here
+ */
+void lv_obj_style_cache_get_stats(lv_obj_style_cache_stats_t * stats);
+
 /**
  * Get the value of a style property. The current state of the object will be considered.
  * Inherited properties will be inherited.
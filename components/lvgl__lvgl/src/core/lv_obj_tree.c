@@ -10,6 +10,7 @@
 
 #include "lv_obj.h"
 #include "lv_indev.h"
+#include "lv_indev_hit_index.h"
 #include "../misc/lv_anim.h"
 #include "../misc/lv_gc.h"
 #include "../misc/lv_async.h"
@@ -143,6 +144,10 @@ void lv_obj_set_parent(lv_obj_t * obj, lv_obj_t * parent)
 
     lv_obj_allocate_spec_attr(parent);
 
+#if LV_INDEV_HIT_INDEX_CELL_SIZE
+    _lv_indev_hit_index_remove_tree(obj);
+#endif
+
     lv_obj_t * old_parent = obj->parent;
     /*Remove the object from the old parent's child list*/
     int32_t i;
@@ -167,6 +172,10 @@ void lv_obj_set_parent(lv_obj_t * obj, lv_obj_t * parent)
 
     obj->parent = parent;
 
+#if LV_INDEV_HIT_INDEX_CELL_SIZE
+    _lv_indev_hit_index_update_tree(obj);
+#endif
+
     /*Notify the original parent because one of its children is lost*/
     lv_obj_scrollbar_invalidate(old_parent);
     lv_event_send(old_parent, LV_EVENT_CHILD_CHANGED, obj);
@@ -356,6 +365,10 @@ static void obj_del_core(lv_obj_t * obj)
 
     obj->being_deleted = 1;
 
+#if LV_INDEV_HIT_INDEX_CELL_SIZE
+    _lv_indev_hit_index_remove(obj);
+#endif
+
     /*Recursively delete the children*/
     lv_obj_t * child = lv_obj_get_child(obj, 0);
     while(child) {
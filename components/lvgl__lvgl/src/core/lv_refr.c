@@ -16,6 +16,9 @@
 #include "../misc/lv_math.h"
 #include "../misc/lv_gc.h"
 #include "../draw/lv_draw.h"
+#include "../draw/sw/lv_draw_sw.h"
+#include "../misc/lv_parallel.h"
+#include "../misc/lv_trace.h"
 #include "../font/lv_font_fmt_txt.h"
 #include "../extra/others/snapshot/lv_snapshot.h"
 
@@ -48,14 +51,37 @@ typedef struct {
 #endif
 } mem_monitor_t;
 
+#if LV_USE_PARALLEL_RENDER
+/*The rows of the areas rendered by one thread*/
+typedef struct {
+    lv_draw_ctx_t * draw_ctx;
+    const lv_area_t * areas;
+    uint32_t area_cnt;
+    lv_area_t band;
+} refr_band_t;
+#endif
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
 static void lv_refr_join_area(void);
+static void inv_area_remove_covered(lv_disp_t * disp, const lv_area_t * area, uint16_t skip);
+static void inv_area_merge_cheapest(lv_disp_t * disp, const lv_area_t * area);
+static uint32_t inv_area_join_cost(const lv_area_t * a1, const lv_area_t * a2);
 static void refr_invalid_areas(void);
 static void refr_sync_areas(void);
+static void sync_area_remove(const lv_area_t * area, uint16_t start);
 static void refr_area(const lv_area_t * area_p);
 static void refr_area_part(lv_draw_ctx_t * draw_ctx);
+static bool refr_wait_for_flushing(void);
+static void refr_area_content(lv_draw_ctx_t * draw_ctx);
+#if LV_USE_PARALLEL_RENDER
+    static bool refr_parallel_is_worth(uint32_t px);
+    static void refr_parallel(lv_draw_ctx_t * draw_ctx, const lv_area_t * areas, uint32_t area_cnt);
+    static bool refr_direct_parallel(int32_t last_i);
+    static void refr_band(refr_band_t * band);
+    static void refr_band_job_cb(void * param);
+#endif
 static lv_obj_t * lv_refr_get_top_obj(const lv_area_t * area_p, lv_obj_t * obj);
 static void refr_obj_and_children(lv_draw_ctx_t * draw_ctx, lv_obj_t * top_obj);
 static void refr_obj(lv_draw_ctx_t * draw_ctx, lv_obj_t * obj);
@@ -247,15 +273,19 @@ void _lv_inv_area(lv_disp_t * disp, const lv_area_t * area_p)
         if(_lv_area_is_in(&com_area, &disp->inv_areas[i], 0) != false) return;
     }
 
+    /*Remove the saved areas covered by the new one*/
+    inv_area_remove_covered(disp, &com_area, LV_INV_BUF_SIZE);
+
     /*Save the area*/
     if(disp->inv_p < LV_INV_BUF_SIZE) {
         lv_area_copy(&disp->inv_areas[disp->inv_p], &com_area);
+        disp->inv_p++;
     }
-    else {   /*If no place for the area add the screen*/
-        disp->inv_p = 0;
-        lv_area_copy(&disp->inv_areas[disp->inv_p], &scr_area);
+    else {
+        /*If no place for the area merge the two areas which add the fewest pixels when joined.
+         *Unlike redrawing the whole screen, it keeps the redrawn size close to the really invalid size.*/
+        inv_area_merge_cheapest(disp, &com_area);
     }
-    disp->inv_p++;
     if(disp->refr_timer) lv_timer_resume(disp->refr_timer);
 }
 
@@ -304,17 +334,22 @@ void _lv_disp_refr_timer(lv_timer_t * tmr)
         disp_refr = lv_disp_get_default();
     }
 
+    LV_TRACE_BEGIN(LV_TRACE_STAGE_FRAME);
+
     /*Refresh the screen's layout if required*/
+    LV_TRACE_BEGIN(LV_TRACE_STAGE_LAYOUT);
     lv_obj_update_layout(disp_refr->act_scr);
     if(disp_refr->prev_scr) lv_obj_update_layout(disp_refr->prev_scr);
 
     lv_obj_update_layout(disp_refr->top_layer);
     lv_obj_update_layout(disp_refr->sys_layer);
+    LV_TRACE_END(LV_TRACE_STAGE_LAYOUT);
 
     /*Do nothing if there is no active screen*/
     if(disp_refr->act_scr == NULL) {
         disp_refr->inv_p = 0;
         LV_LOG_WARN("there is no active screen");
+        LV_TRACE_CANCEL(LV_TRACE_STAGE_FRAME);
         REFR_TRACE("finished");
         return;
     }
@@ -334,8 +369,7 @@ void _lv_disp_refr_timer(lv_timer_t * tmr)
                 if(disp_refr->inv_area_joined[i])
                     continue;
 
-                lv_area_t * sync_area = _lv_ll_ins_tail(&disp_refr->sync_areas);
-                *sync_area = disp_refr->inv_areas[i];
+                disp_refr->sync_areas[disp_refr->sync_p++] = disp_refr->inv_areas[i];
             }
         }
 
@@ -345,12 +379,17 @@ void _lv_disp_refr_timer(lv_timer_t * tmr)
         disp_refr->inv_p = 0;
 
         elaps = lv_tick_elaps(start);
+        LV_TRACE_END(LV_TRACE_STAGE_FRAME);
 
         /*Call monitor cb if present*/
         if(disp_refr->driver->monitor_cb) {
             disp_refr->driver->monitor_cb(disp_refr->driver, elaps, px_num);
         }
     }
+    else {
+        /*Nothing was drawn, it's not a frame*/
+        LV_TRACE_CANCEL(LV_TRACE_STAGE_FRAME);
+    }
 
     lv_mem_buf_free_all();
     _lv_font_clean_up_fmt_txt();
@@ -470,6 +509,82 @@ uint32_t lv_refr_get_fps_avg(void)
  *   STATIC FUNCTIONS
  **********************/
 
+/**
+ * Remove the invalid areas which are inside an area
+ * @param disp      pointer to a display
+ * @param area      the covering area
+ * @param skip      index of `area` in `inv_areas` to keep it, or `LV_INV_BUF_SIZE` if it's not saved
+ */
+static void inv_area_remove_covered(lv_disp_t * disp, const lv_area_t * area, uint16_t skip)
+{
+    uint16_t i;
+    uint16_t j = 0;
+    for(i = 0; i < disp->inv_p; i++) {
+        if(i != skip && _lv_area_is_in(&disp->inv_areas[i], area, 0)) continue;
+        if(i != j) lv_area_copy(&disp->inv_areas[j], &disp->inv_areas[i]);
+        j++;
+    }
+    disp->inv_p = j;
+}
+
+/**
+ * Get how many more pixels the bounding box of two areas has than the two areas together
+ * @param a1        pointer to an area
+ * @param a2        pointer to an other area
+ * @return          the number of the not invalid pixels which would be redrawn after joining
+ */
+static uint32_t inv_area_join_cost(const lv_area_t * a1, const lv_area_t * a2)
+{
+    lv_area_t joined;
+    lv_area_t common;
+    _lv_area_join(&joined, a1, a2);
+    uint32_t common_size = _lv_area_intersect(&common, a1, a2) ? lv_area_get_size(&common) : 0;
+
+    return lv_area_get_size(&joined) + common_size - lv_area_get_size(a1) - lv_area_get_size(a2);
+}
+
+/**
+ * Make room for a new area in the full invalid area buffer by joining the cheapest pair
+ * of the saved areas and the new area
+ * @param disp      pointer to a display with `LV_INV_BUF_SIZE` invalid areas
+ * @param area      the new area
+ */
+static void inv_area_merge_cheapest(lv_disp_t * disp, const lv_area_t * area)
+{
+    uint16_t n = disp->inv_p;
+    uint16_t best_i = 0;
+    uint16_t best_j = n;
+    uint32_t best_cost = UINT32_MAX;
+    uint16_t i;
+    uint16_t j;
+
+    /*Index `n` is the new area*/
+    for(i = 0; i < n && best_cost > 0; i++) {
+        for(j = i + 1; j <= n; j++) {
+            const lv_area_t * a2 = j < n ? &disp->inv_areas[j] : area;
+            uint32_t cost = inv_area_join_cost(&disp->inv_areas[i], a2);
+            if(cost < best_cost) {
+                best_cost = cost;
+                best_i = i;
+                best_j = j;
+                if(cost == 0) break;
+            }
+        }
+    }
+
+    if(best_j == n) {
+        _lv_area_join(&disp->inv_areas[best_i], &disp->inv_areas[best_i], area);
+    }
+    else {
+        _lv_area_join(&disp->inv_areas[best_i], &disp->inv_areas[best_i], &disp->inv_areas[best_j]);
+        lv_area_copy(&disp->inv_areas[best_j], area);
+    }
+
+    /*The joined area can cover others*/
+    lv_area_t joined = disp->inv_areas[best_i];
+    inv_area_remove_covered(disp, &joined, best_i);
+}
+
 /**
  * Join the areas which has got common parts
  */
@@ -519,7 +634,12 @@ static void refr_sync_areas(void)
     if(disp_refr->driver->draw_buf->buf2 == NULL) return;
 
     /*Do not sync if no sync areas*/
-    if(_lv_ll_is_empty(&disp_refr->sync_areas)) return;
+    if(disp_refr->sync_p == 0) return;
+
+    /*Nothing will be rendered, keep the areas until the next frame*/
+    if(disp_refr->inv_p == 0) return;
+
+    LV_TRACE_BEGIN(LV_TRACE_STAGE_SYNC);
 
     /*The buffers are already swapped.
      *So the active buffer is the off screen buffer where LVGL will render*/
@@ -528,55 +648,76 @@ static void refr_sync_areas(void)
                            ? disp_refr->driver->draw_buf->buf2
                            : disp_refr->driver->draw_buf->buf1;
 
-    /*Get stride for buffer copy*/
-    lv_coord_t stride = lv_disp_get_hor_res(disp_refr);
-
-    /*Iterate through invalidated areas to see if sync area should be copied*/
-    lv_area_t res[4] = {0};
-    int8_t res_c, j;
+    /*The parts which will be redrawn don't need to be copied*/
     uint32_t i;
-    lv_area_t * sync_area, * new_area, * next_area;
     for(i = 0; i < disp_refr->inv_p; i++) {
-        /*Skip joined areas*/
         if(disp_refr->inv_area_joined[i]) continue;
+        sync_area_remove(&disp_refr->inv_areas[i], 0);
+    }
 
-        /*Iterate over sync areas*/
-        sync_area = _lv_ll_get_head(&disp_refr->sync_areas);
-        while(sync_area != NULL) {
-            /*Get next sync area*/
-            next_area = _lv_ll_get_next(&disp_refr->sync_areas, sync_area);
-
-            /*Remove intersect of redraw area from sync area and get remaining areas*/
-            res_c = _lv_area_diff(res, sync_area, &disp_refr->inv_areas[i]);
-
-            /*New sub areas created after removing intersect*/
-            if(res_c != -1) {
-                /*Replace old sync area with new areas*/
-                for(j = 0; j < res_c; j++) {
-                    new_area = _lv_ll_ins_prev(&disp_refr->sync_areas, sync_area);
-                    *new_area = res[j];
-                }
-                _lv_ll_remove(&disp_refr->sync_areas, sync_area);
-                lv_mem_free(sync_area);
-            }
+    /*The areas of the last frame might overlap too, copy those parts only once*/
+    for(i = 0; i < disp_refr->sync_p; i++) {
+        lv_area_t a = disp_refr->sync_areas[i];
+        sync_area_remove(&a, i + 1);
+    }
 
-            /*Move on to next sync area*/
-            sync_area = next_area;
-        }
+    disp_refr->sync_px = 0;
+    for(i = 0; i < disp_refr->sync_p; i++) {
+        disp_refr->sync_px += lv_area_get_size(&disp_refr->sync_areas[i]);
     }
 
-    /*Copy sync areas (if any remaining)*/
-    for(sync_area = _lv_ll_get_head(&disp_refr->sync_areas); sync_area != NULL;
-        sync_area = _lv_ll_get_next(&disp_refr->sync_areas, sync_area)) {
-        disp_refr->driver->draw_ctx->buffer_copy(
-            disp_refr->driver->draw_ctx,
-            buf_off_screen, stride, sync_area,
-            buf_on_screen, stride, sync_area
-        );
+    if(disp_refr->driver->sync_cb) {
+        disp_refr->driver->sync_cb(disp_refr->driver, buf_off_screen, buf_on_screen,
+                                   disp_refr->sync_areas, disp_refr->sync_p);
+    }
+    else {
+        /*Get stride for buffer copy*/
+        lv_coord_t stride = lv_disp_get_hor_res(disp_refr);
+        for(i = 0; i < disp_refr->sync_p; i++) {
+            disp_refr->driver->draw_ctx->buffer_copy(
+                disp_refr->driver->draw_ctx,
+                buf_off_screen, stride, &disp_refr->sync_areas[i],
+                buf_on_screen, stride, &disp_refr->sync_areas[i]
+            );
+        }
     }
 
-    /*Clear sync areas*/
-    _lv_ll_clear(&disp_refr->sync_areas);
+    disp_refr->sync_p = 0;
+    LV_TRACE_END(LV_TRACE_STAGE_SYNC);
+}
+
+/**
+ * Remove an area from the sync areas starting from an index.
+ * When the buffer is full the remaining areas are kept, they are copied needlessly but correctly.
+ * @param area      the area to remove
+ * @param start     index of the first sync area to check
+ */
+static void sync_area_remove(const lv_area_t * area, uint16_t start)
+{
+    lv_area_t res[4];
+    uint16_t i = start;
+    /*New parts are added to the end but they don't overlap `area` so they are checked quickly*/
+    while(i < disp_refr->sync_p) {
+        int8_t res_c = _lv_area_diff(res, &disp_refr->sync_areas[i], area);
+        if(res_c < 0) {
+            i++;
+        }
+        else if(res_c == 0) {
+            disp_refr->sync_p--;
+            disp_refr->sync_areas[i] = disp_refr->sync_areas[disp_refr->sync_p];
+        }
+        else if(disp_refr->sync_p + res_c - 1 <= LV_SYNC_BUF_SIZE) {
+            disp_refr->sync_areas[i] = res[0];
+            int8_t j;
+            for(j = 1; j < res_c; j++) {
+                disp_refr->sync_areas[disp_refr->sync_p++] = res[j];
+            }
+            i++;
+        }
+        else {
+            i++;
+        }
+    }
 }
 
 /**
@@ -598,6 +739,8 @@ static void refr_invalid_areas(void)
         }
     }
 
+    LV_TRACE_BEGIN(LV_TRACE_STAGE_RENDER);
+
     /*Notify the display driven rendering has started*/
     if(disp_refr->driver->render_start_cb) {
         disp_refr->driver->render_start_cb(disp_refr->driver);
@@ -607,6 +750,15 @@ static void refr_invalid_areas(void)
     disp_refr->driver->draw_buf->last_part = 0;
     disp_refr->rendering_in_progress = true;
 
+#if LV_USE_PARALLEL_RENDER
+    /*In direct mode all areas can be rendered at once and split between the threads*/
+    if(refr_direct_parallel(last_i)) {
+        disp_refr->rendering_in_progress = false;
+        LV_TRACE_END(LV_TRACE_STAGE_RENDER);
+        return;
+    }
+#endif
+
     for(i = 0; i < disp_refr->inv_p; i++) {
         /*Refresh the unjoined areas*/
         if(disp_refr->inv_area_joined[i] == 0) {
@@ -620,6 +772,7 @@ static void refr_invalid_areas(void)
     }
 
     disp_refr->rendering_in_progress = false;
+    LV_TRACE_END(LV_TRACE_STAGE_RENDER);
 }
 
 /**
@@ -695,21 +848,10 @@ static void refr_area(const lv_area_t * area_p)
 
 static void refr_area_part(lv_draw_ctx_t * draw_ctx)
 {
-    lv_disp_draw_buf_t * draw_buf = lv_disp_get_draw_buf(disp_refr);
-
     if(draw_ctx->init_buf)
         draw_ctx->init_buf(draw_ctx);
 
-    /* Below the `area_p` area will be redrawn into the draw buffer.
-     * In single buffered mode wait here until the buffer is freed.
-     * In full double buffered mode wait here while the buffers are swapped and a buffer becomes available*/
-    bool full_sized = draw_buf->size == (uint32_t)disp_refr->driver->hor_res * disp_refr->driver->ver_res;
-    if((draw_buf->buf1 && !draw_buf->buf2) ||
-       (draw_buf->buf1 && draw_buf->buf2 && full_sized)) {
-        while(draw_buf->flushing) {
-            if(disp_refr->driver->wait_cb) disp_refr->driver->wait_cb(disp_refr->driver);
-        }
-
+    if(refr_wait_for_flushing()) {
         /*If the screen is transparent initialize it when the flushing is ready*/
 #if LV_COLOR_SCREEN_TRANSP
         if(disp_refr->driver->screen_transp) {
@@ -723,6 +865,52 @@ static void refr_area_part(lv_draw_ctx_t * draw_ctx)
 #endif
     }
 
+#if LV_USE_PARALLEL_RENDER
+    if(refr_parallel_is_worth(lv_area_get_size(draw_ctx->clip_area))) {
+        refr_parallel(draw_ctx, draw_ctx->clip_area, 1);
+    }
+    else {
+        refr_area_content(draw_ctx);
+    }
+#else
+    refr_area_content(draw_ctx);
+#endif
+
+    draw_buf_flush(disp_refr);
+}
+
+/**
+ * Wait until the active buffer can be drawn.
+ * In single buffered mode wait here until the buffer is freed.
+ * In full double buffered mode wait here while the buffers are swapped and a buffer becomes available
+ * @return true: the buffer is shared with flushing (single or full sized buffers)
+ */
+static bool refr_wait_for_flushing(void)
+{
+    lv_disp_draw_buf_t * draw_buf = lv_disp_get_draw_buf(disp_refr);
+
+    bool full_sized = draw_buf->size == (uint32_t)disp_refr->driver->hor_res * disp_refr->driver->ver_res;
+    if((draw_buf->buf1 && !draw_buf->buf2) ||
+       (draw_buf->buf1 && draw_buf->buf2 && full_sized)) {
+        if(draw_buf->flushing) {
+            LV_TRACE_BEGIN(LV_TRACE_STAGE_FLUSH_WAIT);
+            while(draw_buf->flushing) {
+                if(disp_refr->driver->wait_cb) disp_refr->driver->wait_cb(disp_refr->driver);
+            }
+            LV_TRACE_END(LV_TRACE_STAGE_FLUSH_WAIT);
+        }
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * Draw the screens and layers on the clip area of a draw context
+ * @param draw_ctx  pointer to a draw context
+ */
+static void refr_area_content(lv_draw_ctx_t * draw_ctx)
+{
     lv_obj_t * top_act_scr = NULL;
     lv_obj_t * top_prev_scr = NULL;
 
@@ -792,10 +980,178 @@ static void refr_area_part(lv_draw_ctx_t * draw_ctx)
     /*Also refresh top and sys layer unconditionally*/
     refr_obj_and_children(draw_ctx, lv_disp_get_layer_top(disp_refr));
     refr_obj_and_children(draw_ctx, lv_disp_get_layer_sys(disp_refr));
+}
 
-    draw_buf_flush(disp_refr);
+#if LV_USE_PARALLEL_RENDER
+
+/**
+ * Tell whether it's worth to split an area between the render threads
+ * @param px    number of pixels to render
+ * @return      true: there is a worker and the area is large enough
+ */
+static bool refr_parallel_is_worth(uint32_t px)
+{
+    /*Only the software renderer keeps its state per thread*/
+    if(disp_refr->driver->draw_ctx_init != lv_draw_sw_init_ctx) return false;
+    if(px < LV_PARALLEL_RENDER_MIN_AREA) return false;
+
+    return _lv_parallel_has_worker();
 }
 
+/**
+ * Render areas on two threads. The areas are split at a row so that both threads get about the same
+ * number of pixels. The worker renders the rows above it with its own draw context into the same buffer.
+ * @param draw_ctx  the draw context of the display, its buffer is used by both threads
+ * @param areas     the areas to render (absolute coordinates)
+ * @param area_cnt  number of areas
+ */
+static void refr_parallel(lv_draw_ctx_t * draw_ctx, const lv_area_t * areas, uint32_t area_cnt)
+{
+    lv_disp_drv_t * drv = disp_refr->driver;
+
+    if(disp_refr->worker_draw_ctx == NULL) {
+        lv_draw_ctx_t * worker_ctx = lv_mem_alloc(drv->draw_ctx_size);
+        LV_ASSERT_MALLOC(worker_ctx);
+        if(worker_ctx == NULL) {
+            refr_band_t band = {draw_ctx, areas, area_cnt, {LV_COORD_MIN, LV_COORD_MIN, LV_COORD_MAX, LV_COORD_MAX}};
+            refr_band(&band);
+            return;
+        }
+        lv_memset_00(worker_ctx, drv->draw_ctx_size);
+        drv->draw_ctx_init(drv, worker_ctx);
+        disp_refr->worker_draw_ctx = worker_ctx;
+    }
+
+    lv_draw_ctx_t * worker_ctx = disp_refr->worker_draw_ctx;
+    worker_ctx->buf = draw_ctx->buf;
+    worker_ctx->buf_area = draw_ctx->buf_area;
+    worker_ctx->clip_area = draw_ctx->clip_area;
+
+    /*Find the first row where at least half of the pixels are above or on it*/
+    uint32_t px_total = 0;
+    lv_coord_t y_min = LV_COORD_MAX;
+    lv_coord_t y_max = LV_COORD_MIN;
+    uint32_t i;
+    for(i = 0; i < area_cnt; i++) {
+        px_total += lv_area_get_size(&areas[i]);
+        y_min = LV_MIN(y_min, areas[i].y1);
+        y_max = LV_MAX(y_max, areas[i].y2);
+    }
+
+    while(y_min < y_max) {
+        lv_coord_t y = y_min + (y_max - y_min) / 2;
+        uint32_t px_above = 0;
+        for(i = 0; i < area_cnt; i++) {
+            if(areas[i].y1 > y) continue;
+            lv_coord_t y2 = LV_MIN(y, areas[i].y2);
+            px_above += (uint32_t)lv_area_get_width(&areas[i]) * (y2 - areas[i].y1 + 1);
+        }
+        if(px_above * 2 >= px_total) y_max = y;
+        else y_min = y + 1;
+    }
+
+    refr_band_t worker_band = {worker_ctx, areas, area_cnt, {LV_COORD_MIN, LV_COORD_MIN, LV_COORD_MAX, y_min}};
+    refr_band_t main_band = {draw_ctx, areas, area_cnt, {LV_COORD_MIN, y_min + 1, LV_COORD_MAX, LV_COORD_MAX}};
+
+    if(!_lv_parallel_start(refr_band_job_cb, &worker_band)) {
+        refr_band(&worker_band);
+        refr_band(&main_band);
+        return;
+    }
+
+    refr_band(&main_band);
+    _lv_parallel_wait();
+}
+
+/**
+ * Render all invalidated areas at once in direct mode, split between the threads, then flush them one by one
+ * @param last_i    index of the last not joined area
+ * @return          false if it's not worth, nothing was rendered then
+ */
+static bool refr_direct_parallel(int32_t last_i)
+{
+    lv_disp_drv_t * drv = disp_refr->driver;
+    if(!drv->direct_mode || drv->full_refresh) return false;
+#if LV_COLOR_SCREEN_TRANSP
+    /*The buffer is cleared before each area*/
+    if(drv->screen_transp) return false;
+#endif
+
+    lv_area_t areas[LV_INV_BUF_SIZE];
+    uint32_t area_cnt = 0;
+    uint32_t px = 0;
+    int32_t i;
+    for(i = 0; i <= last_i; i++) {
+        if(disp_refr->inv_area_joined[i]) continue;
+        areas[area_cnt] = disp_refr->inv_areas[i];
+        px += lv_area_get_size(&areas[area_cnt]);
+        area_cnt++;
+    }
+
+    if(!refr_parallel_is_worth(px)) return false;
+
+    lv_draw_ctx_t * draw_ctx = drv->draw_ctx;
+    lv_area_t disp_area;
+    lv_area_set(&disp_area, 0, 0, lv_disp_get_hor_res(disp_refr) - 1, lv_disp_get_ver_res(disp_refr) - 1);
+    draw_ctx->buf = drv->draw_buf->buf_act;
+    draw_ctx->buf_area = &disp_area;
+    draw_ctx->clip_area = &disp_area;
+
+    if(draw_ctx->init_buf) draw_ctx->init_buf(draw_ctx);
+    refr_wait_for_flushing();
+
+    refr_parallel(draw_ctx, areas, area_cnt);
+
+    /*Flush the areas in the same order as the serial rendering*/
+    uint32_t a;
+    for(a = 0; a < area_cnt; a++) {
+        drv->draw_buf->last_area = a == area_cnt - 1 ? 1 : 0;
+        drv->draw_buf->last_part = drv->draw_buf->last_area;
+        draw_ctx->clip_area = &areas[a];
+        if(a > 0) refr_wait_for_flushing();
+        draw_buf_flush(disp_refr);
+        px_num += lv_area_get_size(&areas[a]);
+    }
+
+    return true;
+}
+
+/**
+ * Render the parts of the areas in the rows of a band
+ * @param band  the band, its areas and the draw context to use
+ */
+static void refr_band(refr_band_t * band)
+{
+    lv_draw_ctx_t * draw_ctx = band->draw_ctx;
+    const lv_area_t * clip_area_ori = draw_ctx->clip_area;
+
+    uint32_t i;
+    for(i = 0; i < band->area_cnt; i++) {
+        lv_area_t clip_area;
+        if(!_lv_area_intersect(&clip_area, &band->areas[i], &band->band)) continue;
+        draw_ctx->clip_area = &clip_area;
+        refr_area_content(draw_ctx);
+    }
+
+    draw_ctx->clip_area = clip_area_ori;
+}
+
+static void refr_band_job_cb(void * param)
+{
+    refr_band_t * band = param;
+    refr_band(band);
+    if(band->draw_ctx->wait_for_finish) band->draw_ctx->wait_for_finish(band->draw_ctx);
+
+    /*Free the render state of the worker thread*/
+    lv_mem_buf_free_all();
+    _lv_font_clean_up_fmt_txt();
+#if LV_DRAW_COMPLEX
+    _lv_draw_mask_cleanup();
+#endif
+}
+
+#endif /*LV_USE_PARALLEL_RENDER*/
+
 /**
  * Search the most top object which fully covers an area
  * @param area_p pointer to an area
@@ -1250,8 +1606,12 @@ static void draw_buf_rotate(lv_area_t * area, lv_color_t * color_p)
             /*Flush the completed area to the display*/
             call_flush_cb(drv, area, rot_buf == NULL ? color_p : rot_buf);
             /*FIXME: Rotation forces legacy behavior where rendering and flushing are done serially*/
-            while(draw_buf->flushing) {
-                if(drv->wait_cb) drv->wait_cb(drv);
+            if(draw_buf->flushing) {
+                LV_TRACE_BEGIN(LV_TRACE_STAGE_FLUSH_WAIT);
+                while(draw_buf->flushing) {
+                    if(drv->wait_cb) drv->wait_cb(drv);
+                }
+                LV_TRACE_END(LV_TRACE_STAGE_FLUSH_WAIT);
             }
             color_p += area_w * height;
             row += height;
@@ -1275,10 +1635,12 @@ static void draw_buf_flush(lv_disp_t * disp)
     /* In partial double buffered mode wait until the other buffer is freed
      * and driver is ready to receive the new buffer */
     bool full_sized = draw_buf->size == (uint32_t)disp_refr->driver->hor_res * disp_refr->driver->ver_res;
-    if(draw_buf->buf1 && draw_buf->buf2 && !full_sized) {
+    if(draw_buf->buf1 && draw_buf->buf2 && !full_sized && draw_buf->flushing) {
+        LV_TRACE_BEGIN(LV_TRACE_STAGE_FLUSH_WAIT);
         while(draw_buf->flushing) {
             if(disp_refr->driver->wait_cb) disp_refr->driver->wait_cb(disp_refr->driver);
         }
+        LV_TRACE_END(LV_TRACE_STAGE_FLUSH_WAIT);
     }
 
     draw_buf->flushing = 1;
@@ -1319,7 +1681,9 @@ static void call_flush_cb(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_
         .y2 = area->y2 + drv->offset_y
     };
 
+    LV_TRACE_BEGIN(LV_TRACE_STAGE_FLUSH);
     drv->flush_cb(drv, &offset_area, color_p);
+    LV_TRACE_END(LV_TRACE_STAGE_FLUSH);
 }
 
 #if LV_USE_PERF_MONITOR
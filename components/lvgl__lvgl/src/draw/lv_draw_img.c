@@ -13,6 +13,7 @@
 #include "../core/lv_refr.h"
 #include "../misc/lv_mem.h"
 #include "../misc/lv_math.h"
+#include "../misc/lv_parallel.h"
 
 /*********************
  *      DEFINES
@@ -254,11 +255,13 @@ static lv_res_t LV_ATTRIBUTE_FAST_MEM decode_and_draw(lv_draw_ctx_t * draw_ctx,
     else if(lv_img_cf_has_alpha(cdsc->dec_dsc.header.cf)) cf = LV_IMG_CF_TRUE_COLOR_ALPHA;
     else cf = LV_IMG_CF_TRUE_COLOR;
 
+    /*The entry might be shared with the other render thread so don't modify it*/
+    const uint8_t * img_data = cdsc->dec_dsc.img_data;
     if(cf == LV_IMG_CF_ALPHA_8BIT) {
         if(draw_dsc->angle || draw_dsc->zoom != LV_IMG_ZOOM_NONE) {
             /* resume normal method */
             cf = LV_IMG_CF_TRUE_COLOR_ALPHA;
-            cdsc->dec_dsc.img_data = NULL;
+            img_data = NULL;
         }
     }
 
@@ -269,7 +272,7 @@ static lv_res_t LV_ATTRIBUTE_FAST_MEM decode_and_draw(lv_draw_ctx_t * draw_ctx,
     }
     /*The decoder could open the image and gave the entire uncompressed image.
      *Just draw it!*/
-    else if(cdsc->dec_dsc.img_data) {
+    else if(img_data) {
         lv_area_t map_area_rot;
         lv_area_copy(&map_area_rot, coords);
         if(draw_dsc->angle || draw_dsc->zoom != LV_IMG_ZOOM_NONE) {
@@ -295,7 +298,7 @@ static lv_res_t LV_ATTRIBUTE_FAST_MEM decode_and_draw(lv_draw_ctx_t * draw_ctx,
 
         const lv_area_t * clip_area_ori = draw_ctx->clip_area;
         draw_ctx->clip_area = &clip_com;
-        lv_draw_img_decoded(draw_ctx, draw_dsc, coords, cdsc->dec_dsc.img_data, cf);
+        lv_draw_img_decoded(draw_ctx, draw_dsc, coords, img_data, cf);
         draw_ctx->clip_area = clip_area_ori;
     }
     /*The whole uncompressed image is not available. Try to read it line-by-line*/
@@ -314,6 +317,9 @@ static lv_res_t LV_ATTRIBUTE_FAST_MEM decode_and_draw(lv_draw_ctx_t * draw_ctx,
         uint8_t  * buf = lv_mem_buf_get(lv_area_get_width(&mask_com) *
                                         LV_IMG_PX_SIZE_ALPHA_BYTE);  /*+1 because of the possible alpha byte*/
 
+        /*The decoder's state is shared when the entry is cached*/
+        _lv_parallel_lock();
+
         const lv_area_t * clip_area_ori = draw_ctx->clip_area;
         lv_area_t line;
         lv_area_copy(&line, &mask_com);
@@ -329,9 +335,11 @@ static lv_res_t LV_ATTRIBUTE_FAST_MEM decode_and_draw(lv_draw_ctx_t * draw_ctx,
 
             read_res = lv_img_decoder_read_line(&cdsc->dec_dsc, x, y, width, buf);
             if(read_res != LV_RES_OK) {
-                lv_img_decoder_close(&cdsc->dec_dsc);
                 LV_LOG_WARN("Image draw can't read the line");
                 lv_mem_buf_release(buf);
+                /*Don't keep the broken image in the cache*/
+                lv_img_cache_invalidate_src(src);
+                _lv_parallel_unlock();
                 draw_cleanup(cdsc);
                 draw_ctx->clip_area = clip_area_ori;
                 return LV_RES_INV;
@@ -345,6 +353,7 @@ static lv_res_t LV_ATTRIBUTE_FAST_MEM decode_and_draw(lv_draw_ctx_t * draw_ctx,
         }
         draw_ctx->clip_area = clip_area_ori;
         lv_mem_buf_release(buf);
+        _lv_parallel_unlock();
     }
 
     draw_cleanup(cdsc);
@@ -365,10 +374,6 @@ static void show_error(lv_draw_ctx_t * draw_ctx, const lv_area_t * coords, const
 
 static void draw_cleanup(_lv_img_cache_entry_t * cache)
 {
-    /*Automatically close images with no caching*/
-#if LV_IMG_CACHE_DEF_SIZE == 0
-    lv_img_decoder_close(&cache->dec_dsc);
-#else
-    LV_UNUSED(cache);
-#endif
+    /*Closes the image if it's not cached*/
+    _lv_img_cache_release(cache);
 }
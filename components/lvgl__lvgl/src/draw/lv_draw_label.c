@@ -106,7 +106,14 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_label(lv_draw_ctx_t * draw_ctx, const lv_draw
 
     lv_bidi_calculate_align(&align, &base_dir, txt);
 
-    if((dsc->flag & LV_TEXT_FLAG_EXPAND) == 0) {
+    /*Use the known line breaks instead of breaking the text again. With EXPAND the width doesn't matter.*/
+    const lv_txt_layout_t * layout = dsc->layout;
+    if(layout && !_lv_txt_layout_is_valid(layout, txt, font, dsc->letter_space, lv_area_get_width(coords), dsc->flag)) {
+        layout = NULL;
+    }
+    if(layout) hint = NULL;
+
+    if((dsc->flag & LV_TEXT_FLAG_EXPAND) == 0 || layout) {
         /*Normally use the label's width as width*/
         w = lv_area_get_width(coords);
     }
@@ -135,6 +142,7 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_label(lv_draw_ctx_t * draw_ctx, const lv_draw
 
     uint32_t line_start     = 0;
     int32_t last_line_start = -1;
+    uint32_t line_id = 0;
 
     /*Check the hint to use the cached info*/
     if(hint && y_ofs == 0 && coords->y1 < 0) {
@@ -151,13 +159,17 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_label(lv_draw_ctx_t * draw_ctx, const lv_draw
         pos.y += hint->y;
     }
 
-    uint32_t line_end = line_start + _lv_txt_get_next_line(&txt[line_start], font, dsc->letter_space, w, NULL, dsc->flag);
+    uint32_t line_end;
+    if(layout) line_end = _lv_txt_layout_get_line_start(layout, 1);
+    else line_end = line_start + _lv_txt_get_next_line(&txt[line_start], font, dsc->letter_space, w, NULL, dsc->flag);
 
     /*Go the first visible line*/
     while(pos.y + line_height_font < draw_ctx->clip_area->y1) {
         /*Go to next line*/
         line_start = line_end;
-        line_end += _lv_txt_get_next_line(&txt[line_start], font, dsc->letter_space, w, NULL, dsc->flag);
+        line_id++;
+        if(layout) line_end = _lv_txt_layout_get_line_start(layout, line_id + 1);
+        else line_end += _lv_txt_get_next_line(&txt[line_start], font, dsc->letter_space, w, NULL, dsc->flag);
         pos.y += line_height;
 
         /*Save at the threshold coordinate*/
@@ -170,16 +182,17 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_label(lv_draw_ctx_t * draw_ctx, const lv_draw
         if(txt[line_start] == '\0') return;
     }
 
+    if(align == LV_TEXT_ALIGN_CENTER || align == LV_TEXT_ALIGN_RIGHT) {
+        if(layout) line_width = _lv_txt_layout_get_line_width(layout, line_id);
+        else line_width = lv_txt_get_width(&txt[line_start], line_end - line_start, font, dsc->letter_space, dsc->flag);
+    }
+
     /*Align to middle*/
     if(align == LV_TEXT_ALIGN_CENTER) {
-        line_width = lv_txt_get_width(&txt[line_start], line_end - line_start, font, dsc->letter_space, dsc->flag);
-
         pos.x += (lv_area_get_width(coords) - line_width) / 2;
-
     }
     /*Align to the right*/
     else if(align == LV_TEXT_ALIGN_RIGHT) {
-        line_width = lv_txt_get_width(&txt[line_start], line_end - line_start, font, dsc->letter_space, dsc->flag);
         pos.x += lv_area_get_width(coords) - line_width;
     }
     uint32_t sel_start = dsc->sel_start;
@@ -334,21 +347,22 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_label(lv_draw_ctx_t * draw_ctx, const lv_draw
 #endif
         /*Go to next line*/
         line_start = line_end;
-        line_end += _lv_txt_get_next_line(&txt[line_start], font, dsc->letter_space, w, NULL, dsc->flag);
+        line_id++;
+        if(layout) line_end = _lv_txt_layout_get_line_start(layout, line_id + 1);
+        else line_end += _lv_txt_get_next_line(&txt[line_start], font, dsc->letter_space, w, NULL, dsc->flag);
 
         pos.x = coords->x1;
+        if(align == LV_TEXT_ALIGN_CENTER || align == LV_TEXT_ALIGN_RIGHT) {
+            if(layout) line_width = _lv_txt_layout_get_line_width(layout, line_id);
+            else line_width = lv_txt_get_width(&txt[line_start], line_end - line_start, font, dsc->letter_space, dsc->flag);
+        }
+
         /*Align to middle*/
         if(align == LV_TEXT_ALIGN_CENTER) {
-            line_width =
-                lv_txt_get_width(&txt[line_start], line_end - line_start, font, dsc->letter_space, dsc->flag);
-
             pos.x += (lv_area_get_width(coords) - line_width) / 2;
-
         }
         /*Align to the right*/
         else if(align == LV_TEXT_ALIGN_RIGHT) {
-            line_width =
-                lv_txt_get_width(&txt[line_start], line_end - line_start, font, dsc->letter_space, dsc->flag);
             pos.x += lv_area_get_width(coords) - line_width;
         }
 
@@ -44,6 +44,7 @@ typedef struct {
     lv_text_flag_t flag;
     lv_text_decor_t decor : 3;
     lv_blend_mode_t blend_mode: 3;
+    const lv_txt_layout_t * layout; /*Line breaks of the text if they are known. Used only if valid for the text.*/
 } lv_draw_label_dsc_t;
 
 /** Store some info to speed up drawing of very large texts
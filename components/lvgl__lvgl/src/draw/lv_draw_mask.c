@@ -19,6 +19,9 @@
 #define CIRCLE_CACHE_LIFE_MAX   1000
 #define CIRCLE_CACHE_AGING(life, r)   life = LV_MIN(life + (r < 16 ? 1 : (r >> 4)), 1000)
 
+/*A radius is searched in this many entries starting from its hash*/
+#define CIRCLE_CACHE_PROBE_MAX  LV_MIN(LV_CIRCLE_CACHE_SIZE, 4)
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -59,6 +62,11 @@ static void circ_calc_aa4(_lv_draw_mask_radius_circle_dsc_t * c, lv_coord_t radi
 static lv_opa_t * get_next_line(_lv_draw_mask_radius_circle_dsc_t * c, lv_coord_t y, lv_coord_t * len,
                                 lv_coord_t * x_start);
 static inline lv_opa_t /* LV_ATTRIBUTE_FAST_MEM */ mask_mix(lv_opa_t mask_act, lv_opa_t mask_new);
+static void /* LV_ATTRIBUTE_FAST_MEM */ mask_mix_row(lv_opa_t * mask_buf, const lv_opa_t * opa, int32_t step,
+                                                     lv_opa_t opa_xor, int32_t len);
+static void /* LV_ATTRIBUTE_FAST_MEM */ mask_mix_aa_line(lv_opa_t * mask_buf, lv_coord_t len, int32_t x,
+                                                         const lv_opa_t * aa_opa, int32_t aa_len, int32_t step,
+                                                         lv_opa_t opa_xor);
 
 /**********************
  *  STATIC VARIABLES
@@ -213,7 +221,8 @@ void lv_draw_mask_free_param(void * p)
     _lv_draw_mask_common_dsc_t * pdsc = p;
     if(pdsc->type == LV_DRAW_MASK_TYPE_RADIUS) {
         lv_draw_mask_radius_param_t * radius_p = (lv_draw_mask_radius_param_t *) p;
-        if(radius_p->circle) {
+        /*The constant circle tables have no `buf` and they are never released*/
+        if(radius_p->circle && radius_p->circle->buf) {
             if(radius_p->circle->life < 0) {
                 lv_mem_free(radius_p->circle->cir_opa);
                 lv_mem_free(radius_p->circle);
@@ -491,26 +500,36 @@ void lv_draw_mask_radius_init(lv_draw_mask_radius_param_t * param, const lv_area
         return;
     }
 
-    uint32_t i;
+#if LV_USE_CIRCLE_CONST_TABLES
+    /*Use the table of the flash if there is one for this radius*/
+    if(radius <= _lv_draw_mask_circle_const_max && _lv_draw_mask_circle_const_tables[radius]) {
+        param->circle = (_lv_draw_mask_radius_circle_dsc_t *)_lv_draw_mask_circle_const_tables[radius];
+        return;
+    }
+#endif
 
-    /*Try to reuse a circle cache entry*/
-    for(i = 0; i < LV_CIRCLE_CACHE_SIZE; i++) {
-        if(LV_GC_ROOT(_lv_circle_cache[i]).radius == radius) {
-            LV_GC_ROOT(_lv_circle_cache[i]).used_cnt++;
-            CIRCLE_CACHE_AGING(LV_GC_ROOT(_lv_circle_cache[i]).life, radius);
-            param->circle = &LV_GC_ROOT(_lv_circle_cache[i]);
+    _lv_draw_mask_radius_circle_dsc_t * entry = NULL;
+
+#if LV_CIRCLE_CACHE_SIZE
+    /*Try to reuse a circle cache entry. The radius can be only in the first few entries from its hash.
+     *If not found remember the free entry with lowest life among them*/
+    uint32_t hash = (uint32_t)radius % LV_CIRCLE_CACHE_SIZE;
+    uint32_t i;
+    for(i = 0; i < CIRCLE_CACHE_PROBE_MAX; i++) {
+        _lv_draw_mask_radius_circle_dsc_t * c = &LV_GC_ROOT(_lv_circle_cache[(hash + i) % LV_CIRCLE_CACHE_SIZE]);
+        if(c->radius == radius) {
+            c->used_cnt++;
+            CIRCLE_CACHE_AGING(c->life, radius);
+            param->circle = c;
             return;
         }
-    }
 
-    /*If not found find a free entry with lowest life*/
-    _lv_draw_mask_radius_circle_dsc_t * entry = NULL;
-    for(i = 0; i < LV_CIRCLE_CACHE_SIZE; i++) {
-        if(LV_GC_ROOT(_lv_circle_cache[i]).used_cnt == 0) {
-            if(!entry) entry = &LV_GC_ROOT(_lv_circle_cache[i]);
-            else if(LV_GC_ROOT(_lv_circle_cache[i]).life < entry->life) entry = &LV_GC_ROOT(_lv_circle_cache[i]);
+        if(c->used_cnt == 0) {
+            if(!entry) entry = c;
+            else if(c->life < entry->life) entry = c;
         }
     }
+#endif
 
     if(!entry) {
         entry = lv_mem_alloc(sizeof(_lv_draw_mask_radius_circle_dsc_t));
@@ -1125,21 +1144,16 @@ static lv_draw_mask_res_t LV_ATTRIBUTE_FAST_MEM lv_draw_mask_radius(lv_opa_t * m
     lv_opa_t * aa_opa = get_next_line(p->circle, cir_y, &aa_len, &x_start);
     lv_coord_t cir_x_right = k + w - radius + x_start;
     lv_coord_t cir_x_left = k + radius - x_start - 1;
-    lv_coord_t i;
 
-    if(outer == false) {
-        for(i = 0; i < aa_len; i++) {
-            lv_opa_t opa = aa_opa[aa_len - i - 1];
-            if(cir_x_right + i >= 0 && cir_x_right + i < len) {
-                mask_buf[cir_x_right + i] = mask_mix(opa, mask_buf[cir_x_right + i]);
-            }
-            if(cir_x_left - i >= 0 && cir_x_left - i < len) {
-                mask_buf[cir_x_left - i] = mask_mix(opa, mask_buf[cir_x_left - i]);
-            }
-        }
+    /*The right side goes backward on `aa_opa`, the left side is mirrored so it goes forward.
+     *The opacities are inverted for outer masks.*/
+    lv_opa_t opa_xor = outer ? 0xFF : 0x00;
+    mask_mix_aa_line(mask_buf, len, cir_x_right, &aa_opa[aa_len - 1], aa_len, -1, opa_xor);
+    mask_mix_aa_line(mask_buf, len, cir_x_left - aa_len + 1, aa_opa, aa_len, 1, opa_xor);
 
+    if(outer == false) {
         /*Clean the right side*/
-        cir_x_right = LV_CLAMP(0, cir_x_right + i, len);
+        cir_x_right = LV_CLAMP(0, cir_x_right + aa_len, len);
         lv_memset_00(&mask_buf[cir_x_right], len - cir_x_right);
 
         /*Clean the left side*/
@@ -1147,16 +1161,6 @@ static lv_draw_mask_res_t LV_ATTRIBUTE_FAST_MEM lv_draw_mask_radius(lv_opa_t * m
         lv_memset_00(&mask_buf[0], cir_x_left);
     }
     else {
-        for(i = 0; i < aa_len; i++) {
-            lv_opa_t opa = 255 - (aa_opa[aa_len - 1 - i]);
-            if(cir_x_right + i >= 0 && cir_x_right + i < len) {
-                mask_buf[cir_x_right + i] = mask_mix(opa, mask_buf[cir_x_right + i]);
-            }
-            if(cir_x_left - i >= 0 && cir_x_left - i < len) {
-                mask_buf[cir_x_left - i] = mask_mix(opa, mask_buf[cir_x_left - i]);
-            }
-        }
-
         lv_coord_t clr_start = LV_CLAMP(0, cir_x_left + 1, len);
         lv_coord_t clr_len = LV_CLAMP(0, cir_x_right - clr_start, len - clr_start);
         lv_memset_00(&mask_buf[clr_start], clr_len);
@@ -1523,4 +1527,47 @@ static inline lv_opa_t LV_ATTRIBUTE_FAST_MEM mask_mix(lv_opa_t mask_act, lv_opa_
     return LV_UDIV255(mask_act * mask_new);// >> 8);
 }
 
+/**
+ * Mix opacities into a mask row like `mask_mix` but without branches so that the compiler can vectorize it.
+ * @param mask_buf the first pixel of the mask to mix
+ * @param opa the opacity of the first pixel, the next ones are at `opa + step`
+ * @param step 1 or -1 to read `opa` forward or backward
+ * @param opa_xor 0xFF to invert the opacities, 0 to use them as they are
+ * @param len number of pixels
+ */
+static void LV_ATTRIBUTE_FAST_MEM mask_mix_row(lv_opa_t * mask_buf, const lv_opa_t * opa, int32_t step,
+                                               lv_opa_t opa_xor, int32_t len)
+{
+    int32_t i;
+    for(i = 0; i < len; i++) {
+        uint32_t act = opa[i * step] ^ opa_xor;
+        uint32_t m = mask_buf[i];
+        uint32_t res = LV_UDIV255(act * m);
+        res = m >= LV_OPA_MAX ? act : res;
+        res = m <= LV_OPA_MIN ? 0 : res;
+        mask_buf[i] = (lv_opa_t)res;
+    }
+}
+
+/**
+ * Mix an anti-aliased line of a circle into the part of the mask it covers.
+ * @param mask_buf the mask
+ * @param len length of the mask
+ * @param x the mask coordinate of the first pixel of the line (can be out of the mask)
+ * @param aa_opa opacity of the first pixel of the line
+ * @param aa_len length of the line
+ * @param step 1 or -1 to read `aa_opa` forward or backward
+ * @param opa_xor 0xFF to invert the opacities, 0 to use them as they are
+ */
+static void LV_ATTRIBUTE_FAST_MEM mask_mix_aa_line(lv_opa_t * mask_buf, lv_coord_t len, int32_t x,
+                                                   const lv_opa_t * aa_opa, int32_t aa_len, int32_t step,
+                                                   lv_opa_t opa_xor)
+{
+    int32_t first = x < 0 ? -x : 0;
+    int32_t last = LV_MIN(aa_len, len - x);
+    if(first >= last) return;
+
+    mask_mix_row(&mask_buf[x + first], &aa_opa[first * step], step, opa_xor, last - first);
+}
+
 #endif /*LV_DRAW_COMPLEX*/
@@ -210,6 +210,13 @@ typedef struct {
     } cfg;
 } lv_draw_mask_polygon_param_t;
 
+#if LV_USE_CIRCLE_CONST_TABLES
+/*Circle tables of fixed radii in the flash, indexed by the radius. NULL if there is no table for a radius.
+ *Generated by scripts/circle_tables_gen.py*/
+extern const _lv_draw_mask_radius_circle_dsc_t * const _lv_draw_mask_circle_const_tables[];
+extern const lv_coord_t _lv_draw_mask_circle_const_max;
+#endif
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -0,0 +1,315 @@
+/**
+ * GENERATED FILE, DO NOT EDIT IT!
+ * @file lv_draw_mask_circle_tables.c
+ * Anti-aliased circle coverage of fixed radii, generated by scripts/circle_tables_gen.py
+ * Radii: 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_draw.h"
+#if LV_DRAW_COMPLEX && LV_USE_CIRCLE_CONST_TABLES
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+static LV_ATTRIBUTE_LARGE_CONST const lv_opa_t cir_opa_1[] = {
+    180, 0, 0, 0,
+};
+
+static LV_ATTRIBUTE_LARGE_CONST const uint16_t opa_start_on_y_1[] = {
+    0, 1,
+};
+
+static LV_ATTRIBUTE_LARGE_CONST const uint16_t x_start_on_y_1[] = {
+    0, 0,
+};
+
+static LV_ATTRIBUTE_LARGE_CONST const lv_opa_t cir_opa_2[] = {
+    0, 224, 80, 224, 0, 0,
+};
+
+static LV_ATTRIBUTE_LARGE_CONST const uint16_t opa_start_on_y_2[] = {
+    0, 2, 4,
+};
+
+static LV_ATTRIBUTE_LARGE_CONST const uint16_t x_start_on_y_2[] = {
+    1, 0, 0,
+};
+
+static LV_ATTRIBUTE_LARGE_CONST const lv_opa_t cir_opa_3[] = {
+    0, 240, 128, 0, 128, 240, 0, 0,
+};
+
+static LV_ATTRIBUTE_LARGE_CONST const uint16_t opa_start_on_y_3[] = {
+    0, 2, 3, 6,
+};
+
+static LV_ATTRIBUTE_LARGE_CONST const uint16_t x_start_on_y_3[] = {
+    2, 2, 0, 0,
+};
+
+static LV_ATTRIBUTE_LARGE_CONST const lv_opa_t cir_opa_4[] = {
+    0, 160, 240, 160, 0, 0, 0, 0, 0, 0,
+};
+
+static LV_ATTRIBUTE_LARGE_CONST const uint16_t opa_start_on_y_4[] = {
+    0, 1, 2, 3, 4,
+};
+
+static LV_ATTRIBUTE_LARGE_CONST const uint16_t x_start_on_y_4[] = {
+    4, 3, 2, 1, 0,
+};
+
+static LV_ATTRIBUTE_LARGE_CONST const lv_opa_t cir_opa_5[] = {
+    0, 176, 64, 128, 64, 176, 0, 0, 0, 0, 0, 0,
+};
+
+static LV_ATTRIBUTE_LARGE_CONST const uint16_t opa_start_on_y_5[] = {
+    0, 1, 2, 3, 4, 6,
+};
+
+static LV_ATTRIBUTE_LARGE_CONST const uint16_t x_start_on_y_5[] = {
+    5, 4, 4, 3, 1, 0,
+};
+
+static LV_ATTRIBUTE_LARGE_CONST const lv_opa_t cir_opa_6[] = {
+    0, 192, 96, 0, 208, 16, 208, 0, 96, 192, 0, 0, 0, 0,
+};
+
+static LV_ATTRIBUTE_LARGE_CONST const uint16_t opa_start_on_y_6[] = {
+    0, 1, 2, 3, 5, 7, 10,
+};
+
+static LV_ATTRIBUTE_LARGE_CONST const uint16_t x_start_on_y_6[] = {
+    6, 5, 5, 4, 3, 1, 0,
+};
+
+static LV_ATTRIBUTE_LARGE_CONST const lv_opa_t cir_opa_7[] = {
+    0, 0, 208, 128, 16, 240, 64, 240, 64, 240, 16, 128, 208, 0, 0, 0,
+};
+
+static LV_ATTRIBUTE_LARGE_CONST const uint16_t opa_start_on_y_7[] = {
+    0, 1, 3, 4, 6, 8, 10, 13,
+};
+
+static LV_ATTRIBUTE_LARGE_CONST const uint16_t x_start_on_y_7[] = {
+    7, 6, 6, 5, 4, 3, 1, 0,
+};
+
+static LV_ATTRIBUTE_LARGE_CONST const lv_opa_t cir_opa_8[] = {
+    0, 0, 208, 144, 32, 128, 192, 128, 32, 144, 208, 0, 0, 0, 0, 0,
+    0, 0,
+};
+
+static LV_ATTRIBUTE_LARGE_CONST const uint16_t opa_start_on_y_8[] = {
+    0, 1, 3, 4, 5, 6, 7, 8, 11,
+};
+
+static LV_ATTRIBUTE_LARGE_CONST const uint16_t x_start_on_y_8[] = {
+    8, 7, 7, 7, 6, 5, 4, 1, 0,
+};
+
+static LV_ATTRIBUTE_LARGE_CONST const lv_opa_t cir_opa_9[] = {
+    0, 0, 224, 160, 64, 0, 192, 32, 240, 64, 240, 32, 192, 0, 64, 160,
+    224, 0, 0, 0,
+};
+
+static LV_ATTRIBUTE_LARGE_CONST const uint16_t opa_start_on_y_9[] = {
+    0, 1, 3, 4, 5, 7, 9, 11, 13, 17,
+};
+
+static LV_ATTRIBUTE_LARGE_CONST const uint16_t x_start_on_y_9[] = {
+    9, 8, 8, 8, 7, 6, 5, 4, 1, 0,
+};
+
+static LV_ATTRIBUTE_LARGE_CONST const lv_opa_t cir_opa_10[] = {
+    0, 0, 224, 160, 80, 0, 224, 64, 128, 0, 128, 64, 224, 0, 80, 160,
+    224, 0, 0, 0, 0, 0,
+};
+
+static LV_ATTRIBUTE_LARGE_CONST const uint16_t opa_start_on_y_10[] = {
+    0, 1, 3, 4, 5, 7, 8, 9, 11, 13, 17,
+};
+
+static LV_ATTRIBUTE_LARGE_CONST const uint16_t x_start_on_y_10[] = {
+    10, 9, 9, 9, 8, 8, 7, 6, 4, 1, 0,
+};
+
+static LV_ATTRIBUTE_LARGE_CONST const lv_opa_t cir_opa_11[] = {
+    0, 0, 224, 176, 96, 16, 240, 128, 0, 208, 224, 208, 0, 128, 240, 16,
+    96, 176, 224, 0, 0, 0, 0, 0,
+};
+
+static LV_ATTRIBUTE_LARGE_CONST const uint16_t opa_start_on_y_11[] = {
+    0, 1, 3, 4, 5, 7, 8, 10, 11, 12, 15, 19,
+};
+
+static LV_ATTRIBUTE_LARGE_CONST const uint16_t x_start_on_y_11[] = {
+    11, 10, 10, 10, 9, 9, 8, 7, 6, 4, 1, 0,
+};
+
+static LV_ATTRIBUTE_LARGE_CONST const lv_opa_t cir_opa_12[] = {
+    0, 0, 224, 176, 112, 32, 160, 16, 240, 64, 112, 64, 240, 16, 160, 32,
+    112, 176, 224, 0, 0, 0, 0, 0, 0, 0,
+};
+
+static LV_ATTRIBUTE_LARGE_CONST const uint16_t opa_start_on_y_12[] = {
+    0, 1, 3, 4, 5, 6, 7, 9, 10, 11, 13, 15, 19,
+};
+
+static LV_ATTRIBUTE_LARGE_CONST const uint16_t x_start_on_y_12[] = {
+    12, 11, 11, 11, 11, 10, 9, 9, 8, 6, 5, 1, 0,
+};
+
+static LV_ATTRIBUTE_LARGE_CONST const lv_opa_t cir_opa_13[] = {
+    0, 0, 240, 192, 112, 32, 0, 192, 48, 128, 0, 176, 16, 176, 0, 128,
+    48, 192, 0, 32, 112, 192, 240, 0, 0, 0, 0, 0,
+};
+
+static LV_ATTRIBUTE_LARGE_CONST const uint16_t opa_start_on_y_13[] = {
+    0, 1, 3, 4, 5, 6, 8, 9, 10, 12, 14, 16, 18, 23,
+};
+
+static LV_ATTRIBUTE_LARGE_CONST const uint16_t x_start_on_y_13[] = {
+    13, 12, 12, 12, 12, 11, 11, 10, 9, 8, 7, 5, 1, 0,
+};
+
+static LV_ATTRIBUTE_LARGE_CONST const lv_opa_t cir_opa_14[] = {
+    0, 0, 240, 192, 128, 48, 0, 224, 96, 0, 192, 32, 240, 240, 240, 32,
+    192, 0, 96, 224, 0, 48, 128, 192, 240, 0, 0, 0, 0, 0,
+};
+
+static LV_ATTRIBUTE_LARGE_CONST const uint16_t opa_start_on_y_14[] = {
+    0, 1, 3, 4, 5, 6, 8, 9, 11, 13, 14, 15, 17, 20, 25,
+};
+
+static LV_ATTRIBUTE_LARGE_CONST const uint16_t x_start_on_y_14[] = {
+    14, 13, 13, 13, 13, 12, 12, 11, 10, 9, 8, 7, 5, 1, 0,
+};
+
+static LV_ATTRIBUTE_LARGE_CONST const lv_opa_t cir_opa_15[] = {
+    0, 0, 240, 192, 144, 80, 0, 224, 128, 16, 224, 64, 128, 160, 128, 64,
+    224, 16, 128, 224, 0, 80, 144, 192, 240, 0, 0, 0, 0, 0, 0, 0,
+};
+
+static LV_ATTRIBUTE_LARGE_CONST const uint16_t opa_start_on_y_15[] = {
+    0, 1, 3, 4, 5, 6, 8, 9, 11, 12, 13, 14, 15, 17, 20, 25,
+};
+
+static LV_ATTRIBUTE_LARGE_CONST const uint16_t x_start_on_y_15[] = {
+    15, 14, 14, 14, 14, 13, 13, 12, 12, 11, 10, 9, 7, 5, 1, 0,
+};
+
+static LV_ATTRIBUTE_LARGE_CONST const lv_opa_t cir_opa_16[] = {
+    0, 0, 192, 144, 80, 0, 240, 144, 32, 240, 128, 0, 208, 16, 208, 32,
+    208, 16, 208, 0, 128, 240, 32, 144, 240, 0, 80, 144, 192, 0, 0, 0,
+    0, 0,
+};
+
+static LV_ATTRIBUTE_LARGE_CONST const uint16_t opa_start_on_y_16[] = {
+    0, 1, 2, 3, 4, 5, 7, 8, 10, 11, 13, 15, 17, 19, 22, 25,
+    29,
+};
+
+static LV_ATTRIBUTE_LARGE_CONST const uint16_t x_start_on_y_16[] = {
+    16, 16, 15, 15, 15, 14, 14, 13, 13, 12, 11, 10, 9, 7, 5, 2,
+    0,
+};
+
+static const _lv_draw_mask_radius_circle_dsc_t circles[] = {
+    {
+        .cir_opa = (lv_opa_t *)cir_opa_1, .opa_start_on_y = (uint16_t *)opa_start_on_y_1,
+        .x_start_on_y = (uint16_t *)x_start_on_y_1, .radius = 1
+    },
+    {
+        .cir_opa = (lv_opa_t *)cir_opa_2, .opa_start_on_y = (uint16_t *)opa_start_on_y_2,
+        .x_start_on_y = (uint16_t *)x_start_on_y_2, .radius = 2
+    },
+    {
+        .cir_opa = (lv_opa_t *)cir_opa_3, .opa_start_on_y = (uint16_t *)opa_start_on_y_3,
+        .x_start_on_y = (uint16_t *)x_start_on_y_3, .radius = 3
+    },
+    {
+        .cir_opa = (lv_opa_t *)cir_opa_4, .opa_start_on_y = (uint16_t *)opa_start_on_y_4,
+        .x_start_on_y = (uint16_t *)x_start_on_y_4, .radius = 4
+    },
+    {
+        .cir_opa = (lv_opa_t *)cir_opa_5, .opa_start_on_y = (uint16_t *)opa_start_on_y_5,
+        .x_start_on_y = (uint16_t *)x_start_on_y_5, .radius = 5
+    },
+    {
+        .cir_opa = (lv_opa_t *)cir_opa_6, .opa_start_on_y = (uint16_t *)opa_start_on_y_6,
+        .x_start_on_y = (uint16_t *)x_start_on_y_6, .radius = 6
+    },
+    {
+        .cir_opa = (lv_opa_t *)cir_opa_7, .opa_start_on_y = (uint16_t *)opa_start_on_y_7,
+        .x_start_on_y = (uint16_t *)x_start_on_y_7, .radius = 7
+    },
+    {
+        .cir_opa = (lv_opa_t *)cir_opa_8, .opa_start_on_y = (uint16_t *)opa_start_on_y_8,
+        .x_start_on_y = (uint16_t *)x_start_on_y_8, .radius = 8
+    },
+    {
+        .cir_opa = (lv_opa_t *)cir_opa_9, .opa_start_on_y = (uint16_t *)opa_start_on_y_9,
+        .x_start_on_y = (uint16_t *)x_start_on_y_9, .radius = 9
+    },
+    {
+        .cir_opa = (lv_opa_t *)cir_opa_10, .opa_start_on_y = (uint16_t *)opa_start_on_y_10,
+        .x_start_on_y = (uint16_t *)x_start_on_y_10, .radius = 10
+    },
+    {
+        .cir_opa = (lv_opa_t *)cir_opa_11, .opa_start_on_y = (uint16_t *)opa_start_on_y_11,
+        .x_start_on_y = (uint16_t *)x_start_on_y_11, .radius = 11
+    },
+    {
+        .cir_opa = (lv_opa_t *)cir_opa_12, .opa_start_on_y = (uint16_t *)opa_start_on_y_12,
+        .x_start_on_y = (uint16_t *)x_start_on_y_12, .radius = 12
+    },
+    {
+        .cir_opa = (lv_opa_t *)cir_opa_13, .opa_start_on_y = (uint16_t *)opa_start_on_y_13,
+        .x_start_on_y = (uint16_t *)x_start_on_y_13, .radius = 13
+    },
+    {
+        .cir_opa = (lv_opa_t *)cir_opa_14, .opa_start_on_y = (uint16_t *)opa_start_on_y_14,
+        .x_start_on_y = (uint16_t *)x_start_on_y_14, .radius = 14
+    },
+    {
+        .cir_opa = (lv_opa_t *)cir_opa_15, .opa_start_on_y = (uint16_t *)opa_start_on_y_15,
+        .x_start_on_y = (uint16_t *)x_start_on_y_15, .radius = 15
+    },
+    {
+        .cir_opa = (lv_opa_t *)cir_opa_16, .opa_start_on_y = (uint16_t *)opa_start_on_y_16,
+        .x_start_on_y = (uint16_t *)x_start_on_y_16, .radius = 16
+    },
+};
+
+/**********************
+ *  GLOBAL VARIABLES
+ **********************/
+
+const _lv_draw_mask_radius_circle_dsc_t * const _lv_draw_mask_circle_const_tables[] = {
+    NULL,
+    &circles[0],
+    &circles[1],
+    &circles[2],
+    &circles[3],
+    &circles[4],
+    &circles[5],
+    &circles[6],
+    &circles[7],
+    &circles[8],
+    &circles[9],
+    &circles[10],
+    &circles[11],
+    &circles[12],
+    &circles[13],
+    &circles[14],
+    &circles[15],
+};
+
+const lv_coord_t _lv_draw_mask_circle_const_max = 16;
+
+#endif /*LV_DRAW_COMPLEX && LV_USE_CIRCLE_CONST_TABLES*/
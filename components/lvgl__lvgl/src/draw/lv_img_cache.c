@@ -12,19 +12,18 @@
 #include "lv_draw_img.h"
 #include "../hal/lv_hal_tick.h"
 #include "../misc/lv_gc.h"
+#include "../misc/lv_lru.h"
+#include "../misc/lv_parallel.h"
+
+#if LV_IMG_CACHE_DEF_SIZE && defined(LV_IMG_CACHE_MEM_INCLUDE)
+    #include LV_IMG_CACHE_MEM_INCLUDE
+#endif
 
 /*********************
  *      DEFINES
  *********************/
-/*Decrement life with this value on every open*/
-#define LV_IMG_CACHE_AGING 1
-
-/*Boost life by this factor (multiply time_to_open with this value)*/
-#define LV_IMG_CACHE_LIFE_GAIN 1
-
-/*Don't let life to be greater than this limit because it would require a lot of time to
- * "die" from very high values*/
-#define LV_IMG_CACHE_LIFE_LIMIT 1000
+/*Keys up to this size are built on the stack*/
+#define KEY_BUF_SIZE    64
 
 /**********************
  *      TYPEDEFS
@@ -35,13 +34,22 @@
  **********************/
 #if LV_IMG_CACHE_DEF_SIZE
     static bool lv_img_cache_match(const void * src1, const void * src2);
+    static uint32_t key_get_size(const void * src);
+    static void key_fill(uint8_t * key, const void * src, lv_color_t color, int32_t frame_id);
+    static size_t take_img_data(_lv_img_cache_entry_t * entry);
+    static void cache_create(void);
+    static void entry_evicted_cb(void * entry_p);
+    static void entry_free(_lv_img_cache_entry_t * entry);
 #endif
 
 /**********************
  *  STATIC VARIABLES
  **********************/
 #if LV_IMG_CACHE_DEF_SIZE
-    static uint16_t entry_cnt;
+    static uint16_t entry_max;
+    static size_t mem_max = LV_IMG_CACHE_DEF_MEM_SIZE;
+    static _lv_img_cache_entry_t * entry_head;
+    static lv_img_cache_stats_t stats;
 #endif
 
 /**********************
@@ -55,66 +63,61 @@
 /**
  * Open an image using the image decoder interface and cache it.
  * The image will be left open meaning if the image decoder open callback allocated memory then it will remain.
- * The image is closed if a new image is opened and the new image takes its place in the cache.
+ * The least recently used images are closed when the entry or byte limit of the cache is reached.
  * @param src source of the image. Path to file or pointer to an `lv_img_dsc_t` variable
  * @param color color The color of the image with `LV_IMG_CF_ALPHA_...`
  * @return pointer to the cache entry or NULL if can open the image
  */
 _lv_img_cache_entry_t * _lv_img_cache_open(const void * src, lv_color_t color, int32_t frame_id)
 {
-    /*Is the image cached?*/
     _lv_img_cache_entry_t * cached_src = NULL;
 
 #if LV_IMG_CACHE_DEF_SIZE
-    if(entry_cnt == 0) {
+    lv_lru_t * lru = LV_GC_ROOT(_lv_img_cache_lru);
+    if(lru == NULL) {
         LV_LOG_WARN("lv_img_cache_open: the cache size is 0");
         return NULL;
     }
 
-    _lv_img_cache_entry_t * cache = LV_GC_ROOT(_lv_img_cache_array);
+    uint32_t key_size = key_get_size(src);
+    if(key_size == 0) return NULL;
 
-    /*Decrement all lifes. Make the entries older*/
-    uint16_t i;
-    for(i = 0; i < entry_cnt; i++) {
-        if(cache[i].life > INT32_MIN + LV_IMG_CACHE_AGING) {
-            cache[i].life -= LV_IMG_CACHE_AGING;
-        }
-    }
+    uint8_t key_buf[KEY_BUF_SIZE];
+    uint8_t * key = key_size <= KEY_BUF_SIZE ? key_buf : lv_mem_alloc(key_size);
+    LV_ASSERT_MALLOC(key);
+    if(key == NULL) return NULL;
+    key_fill(key, src, color, frame_id);
 
-    for(i = 0; i < entry_cnt; i++) {
-        if(color.full == cache[i].dec_dsc.color.full &&
-           frame_id == cache[i].dec_dsc.frame_id &&
-           lv_img_cache_match(src, cache[i].dec_dsc.src)) {
-            /*If opened increment its life.
-             *Image difficult to open should live longer to keep avoid frequent their recaching.
-             *Therefore increase `life` with `time_to_open`*/
-            cached_src = &cache[i];
-            cached_src->life += cached_src->dec_dsc.time_to_open * LV_IMG_CACHE_LIFE_GAIN;
-            if(cached_src->life > LV_IMG_CACHE_LIFE_LIMIT) cached_src->life = LV_IMG_CACHE_LIFE_LIMIT;
-            LV_LOG_TRACE("image source found in the cache");
-            break;
-        }
-    }
-
-    /*The image is not cached then cache it now*/
-    if(cached_src) return cached_src;
+    /*The cache is shared by the render threads*/
+    _lv_parallel_lock();
 
-    /*Find an entry to reuse. Select the entry with the least life*/
-    cached_src = &cache[0];
-    for(i = 1; i < entry_cnt; i++) {
-        if(cache[i].life < cached_src->life) {
-            cached_src = &cache[i];
-        }
+    lv_lru_get(lru, key, key_size, (void **)&cached_src);
+    if(cached_src) {
+        LV_LOG_TRACE("image source found in the cache");
+        stats.hit_cnt++;
+        cached_src->ref_cnt++;
+        _lv_parallel_unlock();
+        if(key != key_buf) lv_mem_free(key);
+        return cached_src;
     }
 
-    /*Close the decoder to reuse if it was opened (has a valid source)*/
-    if(cached_src->dec_dsc.src) {
-        lv_img_decoder_close(&cached_src->dec_dsc);
-        LV_LOG_INFO("image draw: cache miss, close and reuse an entry");
+    stats.miss_cnt++;
+    cached_src = lv_mem_alloc(sizeof(_lv_img_cache_entry_t));
+    LV_ASSERT_MALLOC(cached_src);
+    if(cached_src) {
+        lv_memset_00(cached_src, sizeof(_lv_img_cache_entry_t));
+        cached_src->key = lv_mem_alloc(key_size);
+        LV_ASSERT_MALLOC(cached_src->key);
     }
-    else {
-        LV_LOG_INFO("image draw: cache miss, cached to an empty entry");
+    if(cached_src == NULL || cached_src->key == NULL) {
+        if(cached_src) lv_mem_free(cached_src);
+        _lv_parallel_unlock();
+        if(key != key_buf) lv_mem_free(key);
+        return NULL;
     }
+    lv_memcpy(cached_src->key, key, key_size);
+    cached_src->key_size = key_size;
+    if(key != key_buf) lv_mem_free(key);
 #else
     cached_src = &LV_GC_ROOT(_lv_img_cache_single);
 #endif
@@ -123,13 +126,16 @@ _lv_img_cache_entry_t * _lv_img_cache_open(const void * src, lv_color_t color, i
     lv_res_t open_res = lv_img_decoder_open(&cached_src->dec_dsc, src, color, frame_id);
     if(open_res == LV_RES_INV) {
         LV_LOG_WARN("Image draw cannot open the image resource");
+#if LV_IMG_CACHE_DEF_SIZE
+        lv_mem_free(cached_src->key);
+        lv_mem_free(cached_src);
+        _lv_parallel_unlock();
+#else
         lv_memset_00(cached_src, sizeof(_lv_img_cache_entry_t));
-        cached_src->life = INT32_MIN; /*Make the empty entry very "weak" to force its us*/
+#endif
         return NULL;
     }
 
-    cached_src->life = 0;
-
     /*If `time_to_open` was not set in the open function set it here*/
     if(cached_src->dec_dsc.time_to_open == 0) {
         cached_src->dec_dsc.time_to_open = lv_tick_elaps(t_start);
@@ -137,9 +143,59 @@ _lv_img_cache_entry_t * _lv_img_cache_open(const void * src, lv_color_t color, i
 
     if(cached_src->dec_dsc.time_to_open == 0) cached_src->dec_dsc.time_to_open = 1;
 
+    cached_src->ref_cnt = 1;
+
+#if LV_IMG_CACHE_DEF_SIZE
+    cached_src->mem_size = sizeof(_lv_img_cache_entry_t) + cached_src->key_size + take_img_data(cached_src);
+    /*The decoder's state is kept only while it's open*/
+    if(!cached_src->own_data) cached_src->mem_size += cached_src->dec_dsc.state_size;
+
+    /*Too large images are used only by this draw and closed on release*/
+    if(cached_src->mem_size > mem_max) {
+        LV_LOG_INFO("image draw: cache miss, the image is larger than the cache");
+        _lv_parallel_unlock();
+        return cached_src;
+    }
+
+    /*The least recently used entries are evicted by the LRU to stay in the byte budget*/
+    while(stats.entry_cnt >= entry_max) lv_lru_remove_lru_item(lru);
+
+    cached_src->cached = 1;
+    cached_src->next = entry_head;
+    if(entry_head) entry_head->prev = cached_src;
+    entry_head = cached_src;
+    stats.entry_cnt++;
+
+    lv_lru_set(lru, cached_src->key, cached_src->key_size, cached_src, cached_src->mem_size);
+    stats.mem_size = lru->total_memory - lru->free_memory;
+    LV_LOG_INFO("image draw: cache miss, %d bytes cached", (int)cached_src->mem_size);
+
+    _lv_parallel_unlock();
+#endif
+
     return cached_src;
 }
 
+/**
+ * Release an entry returned by `_lv_img_cache_open` when it's not used anymore.
+ * Without caching the image is closed here.
+ * @param entry pointer to a cache entry
+ */
+void _lv_img_cache_release(_lv_img_cache_entry_t * entry)
+{
+#if LV_IMG_CACHE_DEF_SIZE
+    _lv_parallel_lock();
+    LV_ASSERT(entry->ref_cnt > 0);
+    entry->ref_cnt--;
+    if(entry->ref_cnt == 0 && !entry->cached) entry_free(entry);
+    _lv_parallel_unlock();
+#else
+    /*Automatically close images with no caching*/
+    entry->ref_cnt = 0;
+    lv_img_decoder_close(&entry->dec_dsc);
+#endif
+}
+
 /**
  * Set the number of images to be cached.
  * More cached images mean more opened image at same time which might mean more memory usage.
@@ -152,23 +208,26 @@ void lv_img_cache_set_size(uint16_t new_entry_cnt)
     LV_UNUSED(new_entry_cnt);
     LV_LOG_WARN("Can't change cache size because it's disabled by LV_IMG_CACHE_DEF_SIZE = 0");
 #else
-    if(LV_GC_ROOT(_lv_img_cache_array) != NULL) {
-        /*Clean the cache before free it*/
-        lv_img_cache_invalidate_src(NULL);
-        lv_mem_free(LV_GC_ROOT(_lv_img_cache_array));
-    }
-
-    /*Reallocate the cache*/
-    LV_GC_ROOT(_lv_img_cache_array) = lv_mem_alloc(sizeof(_lv_img_cache_entry_t) * new_entry_cnt);
-    LV_ASSERT_MALLOC(LV_GC_ROOT(_lv_img_cache_array));
-    if(LV_GC_ROOT(_lv_img_cache_array) == NULL) {
-        entry_cnt = 0;
-        return;
-    }
-    entry_cnt = new_entry_cnt;
+    entry_max = new_entry_cnt;
+    cache_create();
+#endif
+}
 
-    /*Clean the cache*/
-    lv_memset_00(LV_GC_ROOT(_lv_img_cache_array), entry_cnt * sizeof(_lv_img_cache_entry_t));
+/**
+ * Set the number of bytes the cached images can use.
+ * The size of an entry is the size of its decoded pixels (if the decoder gave the whole image) and some overhead.
+ * The least recently used images are closed to stay in the limit.
+ * Images larger than the limit are not cached at all.
+ * @param new_mem_size the byte budget of the cache
+ */
+void lv_img_cache_set_mem_size(size_t new_mem_size)
+{
+#if LV_IMG_CACHE_DEF_SIZE == 0
+    LV_UNUSED(new_mem_size);
+    LV_LOG_WARN("Can't change cache size because it's disabled by LV_IMG_CACHE_DEF_SIZE = 0");
+#else
+    mem_max = new_mem_size;
+    cache_create();
 #endif
 }
 
@@ -181,18 +240,38 @@ void lv_img_cache_invalidate_src(const void * src)
 {
     LV_UNUSED(src);
 #if LV_IMG_CACHE_DEF_SIZE
-    _lv_img_cache_entry_t * cache = LV_GC_ROOT(_lv_img_cache_array);
-
-    uint16_t i;
-    for(i = 0; i < entry_cnt; i++) {
-        if(src == NULL || lv_img_cache_match(src, cache[i].dec_dsc.src)) {
-            if(cache[i].dec_dsc.src != NULL) {
-                lv_img_decoder_close(&cache[i].dec_dsc);
-            }
+    lv_lru_t * lru = LV_GC_ROOT(_lv_img_cache_lru);
+    if(lru == NULL) return;
 
-            lv_memset_00(&cache[i], sizeof(_lv_img_cache_entry_t));
+    _lv_parallel_lock();
+    /*All colors and frames of the source are dropped*/
+    _lv_img_cache_entry_t * entry = entry_head;
+    while(entry) {
+        _lv_img_cache_entry_t * next = entry->next;
+        if(src == NULL || lv_img_cache_match(src, entry->dec_dsc.src)) {
+            lv_lru_remove(lru, entry->key, entry->key_size);
         }
+        entry = next;
     }
+    stats.mem_size = lru->total_memory - lru->free_memory;
+    _lv_parallel_unlock();
+#endif
+}
+
+/**
+ * Get the hit/miss counters and the memory usage of the image cache.
+ * @param stats_out store the statistics here
+ */
+void lv_img_cache_get_stats(lv_img_cache_stats_t * stats_out)
+{
+#if LV_IMG_CACHE_DEF_SIZE
+    _lv_parallel_lock();
+    *stats_out = stats;
+    stats_out->entry_max = entry_max;
+    stats_out->mem_max = mem_max;
+    _lv_parallel_unlock();
+#else
+    lv_memset_00(stats_out, sizeof(lv_img_cache_stats_t));
 #endif
 }
 
@@ -212,4 +291,125 @@ static bool lv_img_cache_match(const void * src1, const void * src2)
         return false;
     return strcmp(src1, src2) == 0;
 }
+
+/**
+ * The key is the color, the frame ID and the variable's address or the file's path with its '\0'.
+ * Built as bytes so no padding goes into the hash.
+ */
+static uint32_t key_get_size(const void * src)
+{
+    uint32_t size = sizeof(lv_color_t) + sizeof(int32_t);
+    lv_img_src_t src_type = lv_img_src_get_type(src);
+    if(src_type == LV_IMG_SRC_VARIABLE) return size + sizeof(void *);
+    if(src_type == LV_IMG_SRC_FILE) return size + strlen(src) + 1;
+    return 0;
+}
+
+static void key_fill(uint8_t * key, const void * src, lv_color_t color, int32_t frame_id)
+{
+    lv_memcpy(key, &color, sizeof(lv_color_t));
+    key += sizeof(lv_color_t);
+    lv_memcpy(key, &frame_id, sizeof(int32_t));
+    key += sizeof(int32_t);
+
+    if(lv_img_src_get_type(src) == LV_IMG_SRC_VARIABLE) lv_memcpy(key, &src, sizeof(void *));
+    else strcpy((char *)key, src);
+}
+
+/**
+ * Get the size of the pixels decoded for the entry.
+ * With `LV_IMG_CACHE_MEM_ALLOC` they are also moved to the cache's memory and the decoder is closed.
+ * @return the size of the decoded pixels or 0 if the decoder didn't allocate them
+ */
+static size_t take_img_data(_lv_img_cache_entry_t * entry)
+{
+    lv_img_decoder_dsc_t * dsc = &entry->dec_dsc;
+    if(dsc->img_data == NULL || dsc->error_msg != NULL) return 0;
+
+    /*The built-in decoder only points into the source*/
+    if(dsc->decoder->open_cb == lv_img_decoder_built_in_open) return 0;
+    /*A decoder without close callback doesn't own the pixels either, e.g. they are in memory mapped flash*/
+    if(dsc->decoder->close_cb == NULL) return 0;
+    if(dsc->src_type == LV_IMG_SRC_VARIABLE) {
+        const lv_img_dsc_t * img_dsc = dsc->src;
+        if(dsc->img_data >= img_dsc->data && dsc->img_data < img_dsc->data + img_dsc->data_size) return 0;
+    }
+
+    size_t size = lv_img_buf_get_img_size(dsc->header.w, dsc->header.h, dsc->header.cf);
+
+#ifdef LV_IMG_CACHE_MEM_ALLOC
+    /*Only plain pixel data can be used without the decoder, e.g. its `user_data` might be needed*/
+    if(dsc->user_data != NULL || size == 0) return size;
+    if(dsc->header.cf != LV_IMG_CF_TRUE_COLOR && dsc->header.cf != LV_IMG_CF_TRUE_COLOR_ALPHA &&
+       dsc->header.cf != LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED) return size;
+
+    uint8_t * data = LV_IMG_CACHE_MEM_ALLOC(size);
+    if(data == NULL) {
+        LV_LOG_WARN("image cache: couldn't copy the decoded image, keep the decoder's buffer");
+        return size;
+    }
+    lv_memcpy(data, dsc->img_data, size);
+
+    /*Closing frees the decoder's buffer and the copy of a file's path.
+     *The path is also in the key so point to that one.*/
+    lv_img_decoder_close(dsc);
+    dsc->img_data = data;
+    if(dsc->src_type == LV_IMG_SRC_FILE) dsc->src = (uint8_t *)entry->key + sizeof(lv_color_t) + sizeof(int32_t);
+    entry->own_data = 1;
+#endif
+
+    return size;
+}
+
+static void cache_create(void)
+{
+    _lv_parallel_lock();
+    if(LV_GC_ROOT(_lv_img_cache_lru) != NULL) {
+        /*Entries in use are freed on their last release*/
+        lv_lru_del(LV_GC_ROOT(_lv_img_cache_lru));
+        LV_GC_ROOT(_lv_img_cache_lru) = NULL;
+    }
+
+    if(entry_max > 0 && mem_max > 0) {
+        /*The hash table has about one slot per entry*/
+        LV_GC_ROOT(_lv_img_cache_lru) = lv_lru_create(mem_max, LV_MAX(mem_max / entry_max, 1), entry_evicted_cb, NULL);
+        LV_ASSERT_MALLOC(LV_GC_ROOT(_lv_img_cache_lru));
+    }
+
+    stats.mem_size = 0;
+    _lv_parallel_unlock();
+}
+
+/*Called by the LRU when an entry is removed from the cache*/
+static void entry_evicted_cb(void * entry_p)
+{
+    _lv_img_cache_entry_t * entry = entry_p;
+
+    if(entry->prev) entry->prev->next = entry->next;
+    else entry_head = entry->next;
+    if(entry->next) entry->next->prev = entry->prev;
+    entry->prev = NULL;
+    entry->next = NULL;
+
+    entry->cached = 0;
+    stats.entry_cnt--;
+    stats.evict_cnt++;
+
+    if(entry->ref_cnt == 0) entry_free(entry);
+}
+
+static void entry_free(_lv_img_cache_entry_t * entry)
+{
+    if(entry->own_data) {
+#ifdef LV_IMG_CACHE_MEM_FREE
+        LV_IMG_CACHE_MEM_FREE((void *)entry->dec_dsc.img_data);
+#endif
+    }
+    else {
+        lv_img_decoder_close(&entry->dec_dsc);
+    }
+
+    lv_mem_free(entry->key);
+    lv_mem_free(entry);
+}
 #endif
@@ -28,15 +28,33 @@ extern "C" {
  *
  * To avoid repeating this heavy load images can be cached.
  */
-typedef struct {
+typedef struct _lv_img_cache_entry_t {
     lv_img_decoder_dsc_t dec_dsc; /**< Image information*/
 
-    /** Count the cache entries's life. Add `time_to_open` to `life` when the entry is used.
-     * Decrement all lifes by one every in every ::lv_img_cache_open.
-     * If life == 0 the entry can be reused*/
-    int32_t life;
+    /** Number of draws using the entry now. An evicted entry is freed only when it drops to 0*/
+    uint32_t ref_cnt;
+
+#if LV_IMG_CACHE_DEF_SIZE
+    void * key;             /**< Source, color and frame ID as bytes*/
+    uint32_t key_size;
+    size_t mem_size;        /**< Bytes accounted to the entry*/
+    struct _lv_img_cache_entry_t * prev;    /**< Previous cached entry, for invalidation*/
+    struct _lv_img_cache_entry_t * next;    /**< Next cached entry, for invalidation*/
+    uint8_t cached : 1;     /**< 1: in the cache; 0: evicted or not cacheable, free it on the last release*/
+    uint8_t own_data : 1;   /**< 1: `dec_dsc.img_data` is copied by the cache and the decoder is already closed*/
+#endif
 } _lv_img_cache_entry_t;
 
+typedef struct {
+    uint32_t hit_cnt;       /**< Opens served from the cache*/
+    uint32_t miss_cnt;      /**< Opens which had to decode the image*/
+    uint32_t evict_cnt;     /**< Entries dropped to make room for new ones*/
+    uint16_t entry_cnt;     /**< Number of cached images*/
+    uint16_t entry_max;     /**< Maximal number of cached images*/
+    size_t mem_size;        /**< Bytes used by the cached images, mainly their decoded pixels*/
+    size_t mem_max;         /**< Byte budget of the cache*/
+} lv_img_cache_stats_t;
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -52,6 +70,13 @@ typedef struct {
  */
 _lv_img_cache_entry_t * _lv_img_cache_open(const void * src, lv_color_t color, int32_t frame_id);
 
+/**
+ * Release an entry returned by `_lv_img_cache_open` when it's not used anymore.
+ * Without caching the image is closed here.
+ * @param entry pointer to a cache entry
+ */
+void _lv_img_cache_release(_lv_img_cache_entry_t * entry);
+
 /**
  * Set the number of images to be cached.
  * More cached images mean more opened image at same time which might mean more memory usage.
@@ -60,6 +85,21 @@ _lv_img_cache_entry_t * _lv_img_cache_open(const void * src, lv_color_t color, i
  */
 void lv_img_cache_set_size(uint16_t new_slot_num);
 
+/**
+ * Set the number of bytes the cached images can use.
+ * The size of an entry is the size of its decoded pixels (if the decoder gave the whole image) and some overhead.
+ * The least recently used images are closed to stay in the limit.
+ * Images larger than the limit are not cached at all.
+ * @param new_mem_size the byte budget of the cache
+ */
+void lv_img_cache_set_mem_size(size_t new_mem_size);
+
+/**
+ * Get the hit/miss counters and the memory usage of the image cache.
+ * @param stats store the statistics here
+ */
+void lv_img_cache_get_stats(lv_img_cache_stats_t * stats);
+
 /**
  * Invalidate an image source in the cache.
  * Useful if the image source is updated therefore it needs to be cached again.
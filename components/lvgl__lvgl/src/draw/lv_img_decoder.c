@@ -155,6 +155,7 @@ lv_res_t lv_img_decoder_open(lv_img_decoder_dsc_t * dsc, const void * src, lv_co
         dsc->error_msg = NULL;
         dsc->img_data  = NULL;
         dsc->user_data = NULL;
+        dsc->state_size = 0;
         dsc->time_to_open = 0;
     }
 
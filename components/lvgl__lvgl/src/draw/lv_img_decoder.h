@@ -127,6 +127,10 @@ typedef struct _lv_img_decoder_dsc_t {
 
     /**Store any custom data here is required*/
     void * user_data;
+
+    /**Bytes held by the decoder for the open image besides `img_data`, e.g. to decode it line by line.
+     * Can be set in `open` function, it's counted in the budget of the image cache.*/
+    size_t state_size;
 } lv_img_decoder_dsc_t;
 
 /**********************
@@ -14,6 +14,7 @@ extern "C" {
  *      INCLUDES
  *********************/
 #include "lv_draw_sw_blend.h"
+#include "lv_draw_sw_blend_rgb565.h"
 #include "../lv_draw.h"
 #include "../../misc/lv_area.h"
 #include "../../misc/lv_color.h"
@@ -43,6 +44,15 @@ typedef struct {
     uint32_t has_alpha : 1;
 } lv_draw_sw_layer_ctx_t;
 
+typedef struct {
+    uint32_t hit_cnt;       /**< Shadows whose blurred corner was found in the cache*/
+    uint32_t miss_cnt;      /**< Shadows whose blurred corner had to be calculated*/
+    uint32_t evict_cnt;     /**< Corners dropped to make room for new ones*/
+    uint16_t entry_cnt;     /**< Number of cached corners*/
+    size_t mem_size;        /**< Bytes used by the cached corners*/
+    size_t mem_max;         /**< Byte budget of the cache*/
+} lv_draw_sw_shadow_cache_stats_t;
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -91,6 +101,26 @@ void lv_draw_sw_layer_blend(struct _lv_draw_ctx_t * draw_ctx, struct _lv_draw_la
 
 void lv_draw_sw_layer_destroy(lv_draw_ctx_t * draw_ctx, lv_draw_layer_ctx_t * layer_ctx);
 
+/**
+ * Set the number of bytes the blurred shadow corners can use.
+ * The corners are cached by shadow width, radius and the size of the blurred area,
+ * the least recently used ones are freed to stay in the limit. The cache is emptied too.
+ * Only corners up to `LV_SHADOW_CACHE_SIZE` are cached.
+ * @param size      the byte budget of the cache. 0: disable caching and blur the corners on every draw
+ */
+void lv_draw_sw_shadow_cache_set_mem_size(uint32_t size);
+
+/**
+ * Free the cached shadow corners.
+ */
+void lv_draw_sw_shadow_cache_clear(void);
+
+/**
+ * Get the hit, miss and memory counters of the shadow cache.
+ * @param stats     store the statistics here
+ */
+void lv_draw_sw_shadow_cache_get_stats(lv_draw_sw_shadow_cache_stats_t * stats);
+
 /***********************
  * GLOBAL VARIABLES
  ***********************/
@@ -7,14 +7,23 @@
  *      INCLUDES
  *********************/
 #include "lv_draw_sw.h"
+#include "lv_draw_sw_blend_rgb565.h"
 #include "../../misc/lv_math.h"
 #include "../../hal/lv_hal_disp.h"
 #include "../../core/lv_refr.h"
+#include "../../misc/lv_parallel.h"
 
 /*********************
  *      DEFINES
  *********************/
 
+/*The tests compare the RGB565 kernels with the generic loops, so keep them there*/
+#if LV_DRAW_SW_BLEND_RGB565 == 0 || defined(LV_BUILD_TEST)
+    #define BLEND_NORMAL_GENERIC 1
+#else
+    #define BLEND_NORMAL_GENERIC 0
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -26,9 +35,11 @@
 static void fill_set_px(lv_color_t * dest_buf, const lv_area_t * blend_area, lv_coord_t dest_stride,
                         lv_color_t color, lv_opa_t opa, const lv_opa_t * mask, lv_coord_t mask_stide);
 
+#if BLEND_NORMAL_GENERIC
 static void /* LV_ATTRIBUTE_FAST_MEM */ fill_normal(lv_color_t * dest_buf, const lv_area_t * dest_area,
                                                     lv_coord_t dest_stride, lv_color_t color, lv_opa_t opa,
                                                     const lv_opa_t * mask, lv_coord_t mask_stride);
+#endif
 
 #if LV_COLOR_SCREEN_TRANSP
 static void /* LV_ATTRIBUTE_FAST_MEM */ fill_argb(lv_color_t * dest_buf, const lv_area_t * dest_area,
@@ -45,10 +56,12 @@ static void map_set_px(lv_color_t * dest_buf, const lv_area_t * dest_area, lv_co
                        const lv_color_t * src_buf, lv_coord_t src_stride, lv_opa_t opa,
                        const lv_opa_t * mask, lv_coord_t mask_stride);
 
+#if BLEND_NORMAL_GENERIC
 static void /* LV_ATTRIBUTE_FAST_MEM */ map_normal(lv_color_t * dest_buf, const lv_area_t * dest_area,
                                                    lv_coord_t dest_stride, const lv_color_t * src_buf,
                                                    lv_coord_t src_stride, lv_opa_t opa, const lv_opa_t * mask,
                                                    lv_coord_t mask_stride);
+#endif
 
 #if LV_COLOR_SCREEN_TRANSP
 static void /* LV_ATTRIBUTE_FAST_MEM */ map_argb(lv_color_t * dest_buf, const lv_area_t * dest_area,
@@ -184,12 +197,28 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_sw_blend_basic(lv_draw_ctx_t * draw_ctx,
     }
 #endif
     else if(dsc->blend_mode == LV_BLEND_MODE_NORMAL) {
+#if LV_DRAW_SW_BLEND_RGB565
+        lv_draw_sw_rgb565_blend_dsc_t rgb565_dsc;
+        rgb565_dsc.dest_buf = (uint16_t *)dest_buf;
+        rgb565_dsc.dest_w = lv_area_get_width(&blend_area);
+        rgb565_dsc.dest_h = lv_area_get_height(&blend_area);
+        rgb565_dsc.dest_stride = dest_stride;
+        rgb565_dsc.color = dsc->color.full;
+        rgb565_dsc.src_buf = (const uint16_t *)src_buf;
+        rgb565_dsc.src_stride = src_stride;
+        rgb565_dsc.opa = dsc->opa;
+        rgb565_dsc.mask_buf = mask;
+        rgb565_dsc.mask_stride = mask_stride;
+        if(dsc->src_buf == NULL) lv_draw_sw_blend_rgb565_fill(&rgb565_dsc);
+        else lv_draw_sw_blend_rgb565_map(&rgb565_dsc);
+#else
         if(dsc->src_buf == NULL) {
             fill_normal(dest_buf, &blend_area, dest_stride, dsc->color, dsc->opa, mask, mask_stride);
         }
         else {
             map_normal(dest_buf, &blend_area, dest_stride, src_buf, src_stride, dsc->opa, mask, mask_stride);
         }
+#endif
     }
     else {
 #if LV_DRAW_COMPLEX
@@ -203,6 +232,24 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_sw_blend_basic(lv_draw_ctx_t * draw_ctx,
     }
 }
 
+#if LV_DRAW_SW_BLEND_RGB565 && defined(LV_BUILD_TEST)
+void _lv_draw_sw_blend_rgb565_generic(const lv_draw_sw_rgb565_blend_dsc_t * dsc)
+{
+    lv_area_t area;
+    lv_area_set(&area, 0, 0, dsc->dest_w - 1, dsc->dest_h - 1);
+    lv_color_t * dest_buf = (lv_color_t *)dsc->dest_buf;
+    if(dsc->src_buf == NULL) {
+        lv_color_t color;
+        color.full = dsc->color;
+        fill_normal(dest_buf, &area, dsc->dest_stride, color, dsc->opa, dsc->mask_buf, dsc->mask_stride);
+    }
+    else {
+        map_normal(dest_buf, &area, dsc->dest_stride, (const lv_color_t *)dsc->src_buf, dsc->src_stride, dsc->opa,
+                   dsc->mask_buf, dsc->mask_stride);
+    }
+}
+#endif
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
@@ -239,6 +286,7 @@ static void fill_set_px(lv_color_t * dest_buf, const lv_area_t * blend_area, lv_
     }
 }
 
+#if BLEND_NORMAL_GENERIC
 static LV_ATTRIBUTE_FAST_MEM void fill_normal(lv_color_t * dest_buf, const lv_area_t * dest_area,
                                               lv_coord_t dest_stride, lv_color_t color, lv_opa_t opa,
                                               const lv_opa_t * mask, lv_coord_t mask_stride)
@@ -374,6 +422,8 @@ static LV_ATTRIBUTE_FAST_MEM void fill_normal(lv_color_t * dest_buf, const lv_ar
     }
 }
 
+#endif /*BLEND_NORMAL_GENERIC*/
+
 #if LV_COLOR_SCREEN_TRANSP
 static inline void set_px_argb(uint8_t * buf, lv_color_t color, lv_opa_t opa)
 {
@@ -404,10 +454,10 @@ static inline void set_px_argb(uint8_t * buf, lv_color_t color, lv_opa_t opa)
 static inline void set_px_argb_blend(uint8_t * buf, lv_color_t color, lv_opa_t opa, lv_color_t (*blend_fp)(lv_color_t,
                                                                                                            lv_color_t, lv_opa_t))
 {
-    static lv_color_t last_dest_color;
-    static lv_color_t last_src_color;
-    static lv_color_t last_res_color;
-    static uint32_t last_opa = 0xffff; /*Set to an invalid value for first*/
+    static LV_RENDER_TLS lv_color_t last_dest_color;
+    static LV_RENDER_TLS lv_color_t last_src_color;
+    static LV_RENDER_TLS lv_color_t last_res_color;
+    static LV_RENDER_TLS uint32_t last_opa = 0xffff; /*Set to an invalid value for first*/
 
     lv_color_t bg_color;
 
@@ -638,6 +688,7 @@ static void map_set_px(lv_color_t * dest_buf, const lv_area_t * dest_area, lv_co
     }
 }
 
+#if BLEND_NORMAL_GENERIC
 static void LV_ATTRIBUTE_FAST_MEM map_normal(lv_color_t * dest_buf, const lv_area_t * dest_area,
                                              lv_coord_t dest_stride, const lv_color_t * src_buf,
                                              lv_coord_t src_stride, lv_opa_t opa, const lv_opa_t * mask,
@@ -733,6 +784,8 @@ static void LV_ATTRIBUTE_FAST_MEM map_normal(lv_color_t * dest_buf, const lv_are
     }
 }
 
+#endif /*BLEND_NORMAL_GENERIC*/
+
 #if LV_COLOR_SCREEN_TRANSP
 static void LV_ATTRIBUTE_FAST_MEM map_argb(lv_color_t * dest_buf, const lv_area_t * dest_area,
                                            lv_coord_t dest_stride, const lv_color_t * src_buf,
@@ -0,0 +1,461 @@
+/**
+ * @file lv_draw_sw_blend_rgb565.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_draw_sw_blend_rgb565.h"
+#include "../../misc/lv_math.h"
+#include "../../misc/lv_mem.h"
+
+#if LV_DRAW_SW_BLEND_RGB565
+
+#if LV_DRAW_SW_ASM_CUSTOM
+    #include LV_DRAW_SW_ASM_CUSTOM_INCLUDE
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/*The custom include can define these to handle a blend with e.g. SIMD instructions.
+ *They should return `LV_RES_OK` if the blend was done, or `LV_RES_INV` to use the C implementation*/
+#ifndef LV_DRAW_SW_RGB565_FILL
+    #define LV_DRAW_SW_RGB565_FILL(dsc) LV_RES_INV
+#endif
+
+#ifndef LV_DRAW_SW_RGB565_MAP
+    #define LV_DRAW_SW_RGB565_MAP(dsc) LV_RES_INV
+#endif
+
+#define RGB565_R(c) ((uint32_t)(c) >> 11)
+#define RGB565_G(c) (((uint32_t)(c) >> 5) & 0x3F)
+#define RGB565_B(c) ((uint32_t)(c) & 0x1F)
+
+#if LV_COLOR_MIX_ROUND_OFS == 0
+/*Spread the channels of a color in a 32 bit word to mix them at once. See `lv_color_mix`*/
+#define RGB565_FG(c) ((((uint32_t)(c)) | ((uint32_t)(c) << 16)) & 0x7E0F81F)
+/*The mix ratio is used on 5 bits*/
+#define RGB565_MIX(mix) (((uint32_t)(mix) + 4) >> 3)
+#else
+#define RGB565_FG(c) ((uint32_t)(c))
+#define RGB565_MIX(mix) ((uint32_t)(mix))
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+
+static inline uint16_t rgb565_mix(uint16_t fg, uint16_t bg, uint8_t mix);
+static inline uint16_t rgb565_mix_fg(uint32_t fg, uint16_t bg, uint32_t mix);
+static void fill_rgb565_row(uint16_t * dest_buf, uint16_t color, int32_t w);
+static void fill_rgb565_opa(const lv_draw_sw_rgb565_blend_dsc_t * dsc);
+static void fill_rgb565_mask(const lv_draw_sw_rgb565_blend_dsc_t * dsc);
+static void fill_rgb565_mask_opa(const lv_draw_sw_rgb565_blend_dsc_t * dsc);
+static void map_rgb565_opa(const lv_draw_sw_rgb565_blend_dsc_t * dsc);
+static void map_rgb565_mask(const lv_draw_sw_rgb565_blend_dsc_t * dsc);
+static void map_rgb565_mask_opa(const lv_draw_sw_rgb565_blend_dsc_t * dsc);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/*Blend a pixel in `fill_rgb565_opa`. The last result is reused if the destination color is the same*/
+#define FILL_OPA_PX(i)                                                                              \
+    do {                                                                                            \
+        uint16_t d = dest_buf[i];                                                                   \
+        if(last_dest_color != d) {                                                                  \
+            last_dest_color = d;                                                                    \
+            uint32_t r = LV_UDIV255(r_premult + RGB565_R(d) * opa_inv + LV_COLOR_MIX_ROUND_OFS);    \
+            uint32_t g = LV_UDIV255(g_premult + RGB565_G(d) * opa_inv + LV_COLOR_MIX_ROUND_OFS);    \
+            uint32_t b = LV_UDIV255(b_premult + RGB565_B(d) * opa_inv + LV_COLOR_MIX_ROUND_OFS);    \
+            last_res_color = (uint16_t)((r << 11) | (g << 5) | b);                                  \
+        }                                                                                           \
+        dest_buf[i] = last_res_color;                                                               \
+    } while(0)
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void LV_ATTRIBUTE_FAST_MEM lv_draw_sw_blend_rgb565_fill(const lv_draw_sw_rgb565_blend_dsc_t * dsc)
+{
+    if(LV_DRAW_SW_RGB565_FILL(dsc) == LV_RES_OK) return;
+
+    if(dsc->mask_buf == NULL) {
+        if(dsc->opa >= LV_OPA_MAX) {
+            uint16_t * dest_buf = dsc->dest_buf;
+            int32_t y;
+            for(y = 0; y < dsc->dest_h; y++) {
+                fill_rgb565_row(dest_buf, dsc->color, dsc->dest_w);
+                dest_buf += dsc->dest_stride;
+            }
+        }
+        else {
+            fill_rgb565_opa(dsc);
+        }
+    }
+    else if(dsc->opa >= LV_OPA_MAX) {
+        fill_rgb565_mask(dsc);
+    }
+    else {
+        fill_rgb565_mask_opa(dsc);
+    }
+}
+
+void LV_ATTRIBUTE_FAST_MEM lv_draw_sw_blend_rgb565_map(const lv_draw_sw_rgb565_blend_dsc_t * dsc)
+{
+    if(LV_DRAW_SW_RGB565_MAP(dsc) == LV_RES_OK) return;
+
+    if(dsc->mask_buf == NULL) {
+        if(dsc->opa >= LV_OPA_MAX) {
+            uint16_t * dest_buf = dsc->dest_buf;
+            const uint16_t * src_buf = dsc->src_buf;
+            int32_t y;
+            for(y = 0; y < dsc->dest_h; y++) {
+                lv_memcpy(dest_buf, src_buf, dsc->dest_w * sizeof(uint16_t));
+                dest_buf += dsc->dest_stride;
+                src_buf += dsc->src_stride;
+            }
+        }
+        else {
+            map_rgb565_opa(dsc);
+        }
+    }
+    /*Same as in the generic `map_normal`: only opa == 255 ignores the opacity*/
+    else if(dsc->opa > LV_OPA_MAX) {
+        map_rgb565_mask(dsc);
+    }
+    else {
+        map_rgb565_mask_opa(dsc);
+    }
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Mix two RGB565 colors exactly as `lv_color_mix` does with 16 bit color depth.
+ */
+static inline uint16_t LV_ATTRIBUTE_FAST_MEM rgb565_mix(uint16_t fg, uint16_t bg, uint8_t mix)
+{
+    return rgb565_mix_fg(RGB565_FG(fg), bg, RGB565_MIX(mix));
+}
+
+/**
+ * Same as `rgb565_mix` but the foreground color and the ratio are already prepared with
+ * `RGB565_FG` and `RGB565_MIX`, so that a loop can do it only once.
+ */
+static inline uint16_t LV_ATTRIBUTE_FAST_MEM rgb565_mix_fg(uint32_t fg, uint16_t bg, uint32_t mix)
+{
+#if LV_COLOR_MIX_ROUND_OFS == 0
+    /*Mix the 3 channels at once in a 32 bit word*/
+    uint32_t bg32 = RGB565_FG(bg);
+    uint32_t res = ((((fg - bg32) * mix) >> 5) + bg32) & 0x7E0F81F;
+    return (uint16_t)((res >> 16) | res);
+#else
+    uint32_t mix_inv = 255 - mix;
+    uint32_t r = LV_UDIV255(RGB565_R(fg) * mix + RGB565_R(bg) * mix_inv + LV_COLOR_MIX_ROUND_OFS);
+    uint32_t g = LV_UDIV255(RGB565_G(fg) * mix + RGB565_G(bg) * mix_inv + LV_COLOR_MIX_ROUND_OFS);
+    uint32_t b = LV_UDIV255(RGB565_B(fg) * mix + RGB565_B(bg) * mix_inv + LV_COLOR_MIX_ROUND_OFS);
+    return (uint16_t)((r << 11) | (g << 5) | b);
+#endif
+}
+
+static void LV_ATTRIBUTE_FAST_MEM fill_rgb565_row(uint16_t * dest_buf, uint16_t color, int32_t w)
+{
+    if(w <= 0) return;
+
+    if((lv_uintptr_t)dest_buf & 0x3) {
+        *dest_buf = color;
+        dest_buf++;
+        w--;
+    }
+
+    uint32_t c32 = (uint32_t)color + ((uint32_t)color << 16);
+    uint32_t * buf32 = (uint32_t *)dest_buf;
+    while(w >= 8) {
+        buf32[0] = c32;
+        buf32[1] = c32;
+        buf32[2] = c32;
+        buf32[3] = c32;
+        buf32 += 4;
+        w -= 8;
+    }
+
+    while(w >= 2) {
+        *buf32 = c32;
+        buf32++;
+        w -= 2;
+    }
+
+    if(w) *((uint16_t *)buf32) = color;
+}
+
+static void LV_ATTRIBUTE_FAST_MEM fill_rgb565_opa(const lv_draw_sw_rgb565_blend_dsc_t * dsc)
+{
+    uint16_t * dest_buf = dsc->dest_buf;
+    uint16_t color = dsc->color;
+    lv_opa_t opa = dsc->opa;
+
+    /*Buffer the result color to avoid recalculating the same color.
+     *The cache is primed with black exactly like the generic fill does.*/
+    uint16_t last_dest_color = 0;
+    uint16_t last_res_color = rgb565_mix(color, 0, opa);
+
+#if LV_COLOR_MIX_ROUND_OFS == 0
+    /*Introduce the same rounding error as `lv_color_mix` has with 16 bit color depth*/
+    opa = (uint32_t)((uint32_t)opa + 4) >> 3;
+    opa = opa << 3;
+#endif
+
+    uint32_t r_premult = RGB565_R(color) * opa;
+    uint32_t g_premult = RGB565_G(color) * opa;
+    uint32_t b_premult = RGB565_B(color) * opa;
+    uint32_t opa_inv = 255 - opa;
+    int32_t w = dsc->dest_w;
+
+    int32_t x;
+    int32_t y;
+    for(y = 0; y < dsc->dest_h; y++) {
+        x = 0;
+        if(((lv_uintptr_t)dest_buf & 0x3) && w > 0) {
+            FILL_OPA_PX(0);
+            x = 1;
+        }
+
+        /*Two pixels with the color of the last one (e.g. a plain background) need only one 32 bit load and store*/
+        for(; x + 2 <= w; x += 2) {
+            uint32_t d32 = *((uint32_t *)&dest_buf[x]);
+            if(d32 == (uint32_t)last_dest_color * 0x10001) {
+                *((uint32_t *)&dest_buf[x]) = (uint32_t)last_res_color * 0x10001;
+            }
+            else {
+                FILL_OPA_PX(x);
+                FILL_OPA_PX(x + 1);
+            }
+        }
+
+        if(x < w) FILL_OPA_PX(x);
+
+        dest_buf += dsc->dest_stride;
+    }
+}
+
+static void LV_ATTRIBUTE_FAST_MEM fill_rgb565_mask(const lv_draw_sw_rgb565_blend_dsc_t * dsc)
+{
+    uint16_t * dest_buf = dsc->dest_buf;
+    const lv_opa_t * mask = dsc->mask_buf;
+    uint16_t color = dsc->color;
+    uint32_t c32 = (uint32_t)color + ((uint32_t)color << 16);
+    uint32_t fg = RGB565_FG(color);
+    int32_t w = dsc->dest_w;
+    int32_t x_end4 = w - 4;
+
+    int32_t x;
+    int32_t y;
+    for(y = 0; y < dsc->dest_h; y++) {
+        /*Align the mask to read 4 values at once*/
+        for(x = 0; x < w && ((lv_uintptr_t)&mask[x] & 0x3); x++) {
+            if(mask[x] == LV_OPA_COVER) dest_buf[x] = color;
+            else if(mask[x]) dest_buf[x] = rgb565_mix_fg(fg, dest_buf[x], RGB565_MIX(mask[x]));
+        }
+
+        for(; x <= x_end4; x += 4) {
+            uint32_t mask32 = *((const uint32_t *)&mask[x]);
+            if(mask32 == 0xFFFFFFFF) {
+                /*Fully covered: write 2 pixels with one 32 bit store if possible*/
+                if((lv_uintptr_t)&dest_buf[x] & 0x3) {
+                    dest_buf[x] = color;
+                    *((uint32_t *)&dest_buf[x + 1]) = c32;
+                    dest_buf[x + 3] = color;
+                }
+                else {
+                    *((uint32_t *)&dest_buf[x]) = c32;
+                    *((uint32_t *)&dest_buf[x + 2]) = c32;
+                }
+            }
+            else if(mask32) {
+                int32_t i;
+                for(i = x; i < x + 4; i++) {
+                    if(mask[i] == LV_OPA_COVER) dest_buf[i] = color;
+                    else if(mask[i]) dest_buf[i] = rgb565_mix_fg(fg, dest_buf[i], RGB565_MIX(mask[i]));
+                }
+            }
+        }
+
+        for(; x < w; x++) {
+            if(mask[x] == LV_OPA_COVER) dest_buf[x] = color;
+            else if(mask[x]) dest_buf[x] = rgb565_mix_fg(fg, dest_buf[x], RGB565_MIX(mask[x]));
+        }
+
+        dest_buf += dsc->dest_stride;
+        mask += dsc->mask_stride;
+    }
+}
+
+static void LV_ATTRIBUTE_FAST_MEM fill_rgb565_mask_opa(const lv_draw_sw_rgb565_blend_dsc_t * dsc)
+{
+    uint16_t * dest_buf = dsc->dest_buf;
+    const lv_opa_t * mask = dsc->mask_buf;
+    uint16_t color = dsc->color;
+    uint32_t fg = RGB565_FG(color);
+    lv_opa_t opa = dsc->opa;
+
+    /*Buffer the result color to avoid recalculating the same color*/
+    uint16_t last_dest_color = dest_buf[0];
+    uint16_t last_res_color = dest_buf[0];
+    lv_opa_t last_mask = LV_OPA_TRANSP;
+    lv_opa_t opa_tmp = LV_OPA_TRANSP;
+
+    int32_t x;
+    int32_t y;
+    for(y = 0; y < dsc->dest_h; y++) {
+        for(x = 0; x < dsc->dest_w; x++) {
+            /*Skip 4 transparent mask values at once*/
+            if(((lv_uintptr_t)&mask[x] & 0x3) == 0 && x + 4 <= dsc->dest_w && *((const uint32_t *)&mask[x]) == 0) {
+                x += 3;
+                continue;
+            }
+            lv_opa_t m = mask[x];
+            if(m == LV_OPA_TRANSP) continue;
+            if(m != last_mask) opa_tmp = m == LV_OPA_COVER ? opa : (uint32_t)((uint32_t)m * opa) >> 8;
+            if(m != last_mask || last_dest_color != dest_buf[x]) {
+                if(opa_tmp == LV_OPA_COVER) last_res_color = color;
+                else last_res_color = rgb565_mix_fg(fg, dest_buf[x], RGB565_MIX(opa_tmp));
+                last_mask = m;
+                last_dest_color = dest_buf[x];
+            }
+            dest_buf[x] = last_res_color;
+        }
+        dest_buf += dsc->dest_stride;
+        mask += dsc->mask_stride;
+    }
+}
+
+static void LV_ATTRIBUTE_FAST_MEM map_rgb565_opa(const lv_draw_sw_rgb565_blend_dsc_t * dsc)
+{
+    uint16_t * dest_buf = dsc->dest_buf;
+    const uint16_t * src_buf = dsc->src_buf;
+    uint32_t mix = RGB565_MIX(dsc->opa);
+    int32_t w = dsc->dest_w;
+
+    int32_t x;
+    int32_t y;
+    for(y = 0; y < dsc->dest_h; y++) {
+        x = 0;
+        /*Blend 2 pixels with one 32 bit load and store if the buffers are aligned the same way*/
+        if((((lv_uintptr_t)dest_buf ^ (lv_uintptr_t)src_buf) & 0x3) == 0) {
+            if(((lv_uintptr_t)dest_buf & 0x3) && w > 0) {
+                dest_buf[0] = rgb565_mix_fg(RGB565_FG(src_buf[0]), dest_buf[0], mix);
+                x = 1;
+            }
+
+            for(; x + 2 <= w; x += 2) {
+                uint32_t s32 = *((const uint32_t *)&src_buf[x]);
+                uint32_t d32 = *((uint32_t *)&dest_buf[x]);
+                uint32_t lo = rgb565_mix_fg(RGB565_FG(s32 & 0xFFFF), (uint16_t)d32, mix);
+                uint32_t hi = rgb565_mix_fg(RGB565_FG(s32 >> 16), (uint16_t)(d32 >> 16), mix);
+                *((uint32_t *)&dest_buf[x]) = lo | (hi << 16);
+            }
+        }
+
+        for(; x < w; x++) {
+            dest_buf[x] = rgb565_mix_fg(RGB565_FG(src_buf[x]), dest_buf[x], mix);
+        }
+
+        dest_buf += dsc->dest_stride;
+        src_buf += dsc->src_stride;
+    }
+}
+
+static void LV_ATTRIBUTE_FAST_MEM map_rgb565_mask(const lv_draw_sw_rgb565_blend_dsc_t * dsc)
+{
+    uint16_t * dest_buf = dsc->dest_buf;
+    const uint16_t * src_buf = dsc->src_buf;
+    const lv_opa_t * mask = dsc->mask_buf;
+    int32_t w = dsc->dest_w;
+    int32_t x_end4 = w - 4;
+
+    int32_t x;
+    int32_t y;
+    for(y = 0; y < dsc->dest_h; y++) {
+        for(x = 0; x < w && ((lv_uintptr_t)&mask[x] & 0x3); x++) {
+            if(mask[x] == LV_OPA_COVER) dest_buf[x] = src_buf[x];
+            else if(mask[x]) dest_buf[x] = rgb565_mix(src_buf[x], dest_buf[x], mask[x]);
+        }
+
+        for(; x <= x_end4; x += 4) {
+            uint32_t mask32 = *((const uint32_t *)&mask[x]);
+            if(mask32 == 0xFFFFFFFF) {
+                /*Copy 2 pixels at once if the source and destination are aligned the same way*/
+                if((((lv_uintptr_t)&dest_buf[x] | (lv_uintptr_t)&src_buf[x]) & 0x3) == 0) {
+                    *((uint32_t *)&dest_buf[x]) = *((const uint32_t *)&src_buf[x]);
+                    *((uint32_t *)&dest_buf[x + 2]) = *((const uint32_t *)&src_buf[x + 2]);
+                }
+                else {
+                    dest_buf[x] = src_buf[x];
+                    dest_buf[x + 1] = src_buf[x + 1];
+                    dest_buf[x + 2] = src_buf[x + 2];
+                    dest_buf[x + 3] = src_buf[x + 3];
+                }
+            }
+            else if(mask32) {
+                int32_t i;
+                for(i = x; i < x + 4; i++) {
+                    if(mask[i] == LV_OPA_COVER) dest_buf[i] = src_buf[i];
+                    else if(mask[i]) dest_buf[i] = rgb565_mix(src_buf[i], dest_buf[i], mask[i]);
+                }
+            }
+        }
+
+        for(; x < w; x++) {
+            if(mask[x] == LV_OPA_COVER) dest_buf[x] = src_buf[x];
+            else if(mask[x]) dest_buf[x] = rgb565_mix(src_buf[x], dest_buf[x], mask[x]);
+        }
+
+        dest_buf += dsc->dest_stride;
+        src_buf += dsc->src_stride;
+        mask += dsc->mask_stride;
+    }
+}
+
+static void LV_ATTRIBUTE_FAST_MEM map_rgb565_mask_opa(const lv_draw_sw_rgb565_blend_dsc_t * dsc)
+{
+    uint16_t * dest_buf = dsc->dest_buf;
+    const uint16_t * src_buf = dsc->src_buf;
+    const lv_opa_t * mask = dsc->mask_buf;
+    lv_opa_t opa = dsc->opa;
+
+    int32_t x;
+    int32_t y;
+    for(y = 0; y < dsc->dest_h; y++) {
+        for(x = 0; x < dsc->dest_w; x++) {
+            /*Skip 4 transparent mask values at once*/
+            if(((lv_uintptr_t)&mask[x] & 0x3) == 0 && x + 4 <= dsc->dest_w && *((const uint32_t *)&mask[x]) == 0) {
+                x += 3;
+                continue;
+            }
+            if(mask[x]) {
+                lv_opa_t opa_tmp = mask[x] >= LV_OPA_MAX ? opa : ((opa * mask[x]) >> 8);
+                dest_buf[x] = rgb565_mix(src_buf[x], dest_buf[x], opa_tmp);
+            }
+        }
+        dest_buf += dsc->dest_stride;
+        src_buf += dsc->src_stride;
+        mask += dsc->mask_stride;
+    }
+}
+
+#endif /*LV_DRAW_SW_BLEND_RGB565*/
@@ -0,0 +1,82 @@
+/**
+ * @file lv_draw_sw_blend_rgb565.h
+ *
+ */
+
+#ifndef LV_DRAW_SW_BLEND_RGB565_H
+#define LV_DRAW_SW_BLEND_RGB565_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../../misc/lv_color.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/*Use the RGB565 kernels instead of the generic `lv_color_t` loops for normal blending*/
+#if LV_COLOR_DEPTH == 16 && LV_COLOR_16_SWAP == 0
+#define LV_DRAW_SW_BLEND_RGB565 1
+#else
+#define LV_DRAW_SW_BLEND_RGB565 0
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef struct {
+    uint16_t * dest_buf;            /**< First pixel of the area to blend on*/
+    int32_t dest_w;                 /**< Width of the area in pixels*/
+    int32_t dest_h;                 /**< Height of the area in pixels*/
+    int32_t dest_stride;            /**< Distance between two rows of `dest_buf` in pixels*/
+    uint16_t color;                 /**< Fill color. Ignored if `src_buf` is set*/
+    const uint16_t * src_buf;       /**< First pixel of the image to blend or NULL to fill with `color`*/
+    int32_t src_stride;             /**< Distance between two rows of `src_buf` in pixels*/
+    lv_opa_t opa;                   /**< The overall opacity*/
+    const lv_opa_t * mask_buf;      /**< First mask value for the area or NULL if there is no mask*/
+    int32_t mask_stride;            /**< Distance between two rows of `mask_buf` in bytes*/
+} lv_draw_sw_rgb565_blend_dsc_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Fill an area of an RGB565 buffer with a color using normal blending.
+ * The result is the same as LVGL's generic 16 bit fill, but the spans are processed
+ * a word at a time where possible and `LV_DRAW_SW_RGB565_FILL` can take over the common cases.
+ * @param dsc       pointer to an initialized blend descriptor. `src_buf` is ignored.
+ */
+void /* LV_ATTRIBUTE_FAST_MEM */ lv_draw_sw_blend_rgb565_fill(const lv_draw_sw_rgb565_blend_dsc_t * dsc);
+
+/**
+ * Blend an RGB565 image onto an RGB565 buffer using normal blending.
+ * `LV_DRAW_SW_RGB565_MAP` can take over the common cases.
+ * @param dsc       pointer to an initialized blend descriptor with `src_buf` set
+ */
+void /* LV_ATTRIBUTE_FAST_MEM */ lv_draw_sw_blend_rgb565_map(const lv_draw_sw_rgb565_blend_dsc_t * dsc);
+
+#if LV_DRAW_SW_BLEND_RGB565 && defined(LV_BUILD_TEST)
+/**
+ * Blend with LVGL's generic `lv_color_t` loops instead of the RGB565 kernels.
+ * Only for the tests to compare the results.
+ * @param dsc       pointer to an initialized blend descriptor
+ */
+void _lv_draw_sw_blend_rgb565_generic(const lv_draw_sw_rgb565_blend_dsc_t * dsc);
+#endif
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_DRAW_SW_BLEND_RGB565_H*/
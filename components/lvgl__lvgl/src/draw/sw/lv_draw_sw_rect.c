@@ -12,6 +12,9 @@
 #include "../../core/lv_refr.h"
 #include "../../misc/lv_assert.h"
 #include "lv_draw_sw_dither.h"
+#include "../../misc/lv_parallel.h"
+#include "../../misc/lv_gc.h"
+#include "../../misc/lv_lru.h"
 
 /*********************
  *      DEFINES
@@ -20,9 +23,24 @@
 #define SHADOW_ENHANCE          1
 #define SPLIT_LIMIT             50
 
+/*Bytes counted for a cached corner besides its mask: the LRU item, the key and the allocation headers, roughly*/
+#define SHADOW_CACHE_ITEM_OVERHEAD  48
+
+/*Expected size of a cached corner to size the hash table*/
+#define SHADOW_CACHE_AVG_ITEM_SIZE  (24 * 24 + SHADOW_CACHE_ITEM_OVERHEAD)
+
 /**********************
  *      TYPEDEFS
  **********************/
+#if LV_DRAW_COMPLEX && LV_SHADOW_CACHE_SIZE
+/*The blurred corner depends only on these. The spread is part of the blurred area's size.*/
+typedef struct {
+    lv_coord_t sw;
+    lv_coord_t r;
+    lv_coord_t w;   /*Size of the blurred area, clamped where it doesn't change the corner anymore*/
+    lv_coord_t h;
+} shadow_cache_key_t;
+#endif
 
 /**********************
  *  STATIC PROTOTYPES
@@ -39,6 +57,11 @@ static void /* LV_ATTRIBUTE_FAST_MEM */ draw_shadow(lv_draw_ctx_t * draw_ctx, co
 static void /* LV_ATTRIBUTE_FAST_MEM */ shadow_draw_corner_buf(const lv_area_t * coords, uint16_t * sh_buf,
                                                                lv_coord_t s, lv_coord_t r);
 static void /* LV_ATTRIBUTE_FAST_MEM */ shadow_blur_corner(lv_coord_t size, lv_coord_t sw, uint16_t * sh_ups_buf);
+#if LV_SHADOW_CACHE_SIZE
+    static bool shadow_cache_get(const shadow_cache_key_t * key, lv_opa_t * sh_buf, uint32_t size);
+    static void shadow_cache_add(const shadow_cache_key_t * key, const lv_opa_t * sh_buf, uint32_t size);
+    static void shadow_cache_free_cb(void * p);
+#endif
 #endif
 
 void draw_border_generic(lv_draw_ctx_t * draw_ctx, const lv_area_t * outer_area, const lv_area_t * inner_area,
@@ -50,10 +73,12 @@ static void draw_border_simple(lv_draw_ctx_t * draw_ctx, const lv_area_t * outer
 /**********************
  *  STATIC VARIABLES
  **********************/
-#if defined(LV_SHADOW_CACHE_SIZE) && LV_SHADOW_CACHE_SIZE > 0
-    static uint8_t sh_cache[LV_SHADOW_CACHE_SIZE * LV_SHADOW_CACHE_SIZE];
-    static int32_t sh_cache_size = -1;
-    static int32_t sh_cache_r = -1;
+#if LV_DRAW_COMPLEX && LV_SHADOW_CACHE_SIZE
+    static uint32_t sh_cache_mem_size = LV_SHADOW_CACHE_MEM_SIZE;
+    static uint32_t sh_cache_hit_cnt;
+    static uint32_t sh_cache_miss_cnt;
+    static uint32_t sh_cache_evict_cnt;
+    static uint16_t sh_cache_entry_cnt;
 #endif
 
 /**********************
@@ -90,6 +115,47 @@ void lv_draw_sw_bg(lv_draw_ctx_t * draw_ctx, const lv_draw_rect_dsc_t * dsc, con
     draw_bg_img(draw_ctx, dsc, coords);
 }
 
+void lv_draw_sw_shadow_cache_set_mem_size(uint32_t size)
+{
+#if LV_DRAW_COMPLEX && LV_SHADOW_CACHE_SIZE
+    lv_draw_sw_shadow_cache_clear();
+    sh_cache_mem_size = size;
+#else
+    LV_UNUSED(size);
+#endif
+}
+
+void lv_draw_sw_shadow_cache_clear(void)
+{
+#if LV_DRAW_COMPLEX && LV_SHADOW_CACHE_SIZE
+    LV_ASSERT_MSG(!_lv_parallel_is_active(), "Can't clear the shadow cache while rendering");
+
+    if(LV_GC_ROOT(_lv_draw_sw_shadow_cache)) {
+        /*Freeing the corners here is not an eviction*/
+        uint32_t evict_cnt = sh_cache_evict_cnt;
+        lv_lru_del(LV_GC_ROOT(_lv_draw_sw_shadow_cache));
+        LV_GC_ROOT(_lv_draw_sw_shadow_cache) = NULL;
+        sh_cache_evict_cnt = evict_cnt;
+    }
+#endif
+}
+
+void lv_draw_sw_shadow_cache_get_stats(lv_draw_sw_shadow_cache_stats_t * stats)
+{
+    lv_memset_00(stats, sizeof(lv_draw_sw_shadow_cache_stats_t));
+#if LV_DRAW_COMPLEX && LV_SHADOW_CACHE_SIZE
+    _lv_parallel_lock();
+    stats->hit_cnt = sh_cache_hit_cnt;
+    stats->miss_cnt = sh_cache_miss_cnt;
+    stats->evict_cnt = sh_cache_evict_cnt;
+    stats->entry_cnt = sh_cache_entry_cnt;
+    stats->mem_max = sh_cache_mem_size;
+    lv_lru_t * cache = LV_GC_ROOT(_lv_draw_sw_shadow_cache);
+    if(cache) stats->mem_size = cache->total_memory - cache->free_memory;
+    _lv_parallel_unlock();
+#endif
+}
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
@@ -476,28 +542,25 @@ static void LV_ATTRIBUTE_FAST_MEM draw_shadow(lv_draw_ctx_t * draw_ctx, const lv
     /*Get how many pixels are affected by the blur on the corners*/
     int32_t corner_size = dsc->shadow_width  + r_sh;
 
-    lv_opa_t * sh_buf;
+    /*A larger buffer is required for calculation*/
+    lv_opa_t * sh_buf = lv_mem_buf_get(corner_size * corner_size * sizeof(uint16_t));
 
 #if LV_SHADOW_CACHE_SIZE
-    if(sh_cache_size == corner_size && sh_cache_r == r_sh) {
-        /*Use the cache if available*/
-        sh_buf = lv_mem_buf_get(corner_size * corner_size);
-        lv_memcpy(sh_buf, sh_cache, corner_size * corner_size);
-    }
-    else {
-        /*A larger buffer is required for calculation*/
-        sh_buf = lv_mem_buf_get(corner_size * corner_size * sizeof(uint16_t));
+    /*The corner is affected by the far edges of the blurred area only if the area is small.
+     *Above twice the corner size they are out of the corner so the larger areas can share the corner.*/
+    shadow_cache_key_t key;
+    lv_memset_00(&key, sizeof(key));    /*No garbage in the padding as it's hashed too*/
+    key.sw = dsc->shadow_width;
+    key.r = r_sh;
+    key.w = LV_MIN(lv_area_get_width(&core_area), 2 * corner_size);
+    key.h = LV_MIN(lv_area_get_height(&core_area), 2 * corner_size);
+
+    bool cacheable = corner_size <= LV_SHADOW_CACHE_SIZE && sh_cache_mem_size > 0;
+    if(!cacheable || !shadow_cache_get(&key, sh_buf, corner_size * corner_size)) {
         shadow_draw_corner_buf(&core_area, (uint16_t *)sh_buf, dsc->shadow_width, r_sh);
-
-        /*Cache the corner if it fits into the cache size*/
-        if((uint32_t)corner_size * corner_size < sizeof(sh_cache)) {
-            lv_memcpy(sh_cache, sh_buf, corner_size * corner_size);
-            sh_cache_size = corner_size;
-            sh_cache_r = r_sh;
-        }
+        if(cacheable) shadow_cache_add(&key, sh_buf, corner_size * corner_size);
     }
 #else
-    sh_buf = lv_mem_buf_get(corner_size * corner_size * sizeof(uint16_t));
     shadow_draw_corner_buf(&core_area, (uint16_t *)sh_buf, dsc->shadow_width, r_sh);
 #endif
 
@@ -1101,6 +1164,79 @@ static void LV_ATTRIBUTE_FAST_MEM shadow_blur_corner(lv_coord_t size, lv_coord_t
 
     lv_mem_buf_release(sh_ups_blur_buf);
 }
+
+#if LV_SHADOW_CACHE_SIZE
+/**
+ * Copy a cached corner. It's copied while locked as the other render thread might evict it.
+ * @param key       describes the corner
+ * @param sh_buf    copy the corner here
+ * @param size      size of the corner in bytes
+ * @return          true: the corner was in the cache; false: it has to be calculated
+ */
+static bool shadow_cache_get(const shadow_cache_key_t * key, lv_opa_t * sh_buf, uint32_t size)
+{
+    lv_opa_t * cached = NULL;
+    _lv_parallel_lock();
+    lv_lru_t * cache = LV_GC_ROOT(_lv_draw_sw_shadow_cache);
+    if(cache) lv_lru_get(cache, key, sizeof(shadow_cache_key_t), (void **)&cached);
+
+    if(cached) {
+        lv_memcpy(sh_buf, cached, size);
+        sh_cache_hit_cnt++;
+    }
+    else {
+        sh_cache_miss_cnt++;
+    }
+    _lv_parallel_unlock();
+
+    return cached != NULL;
+}
+
+/**
+ * Add a copy of a calculated corner to the cache
+ * @param key       describes the corner
+ * @param sh_buf    the calculated corner
+ * @param size      size of the corner in bytes
+ */
+static void shadow_cache_add(const shadow_cache_key_t * key, const lv_opa_t * sh_buf, uint32_t size)
+{
+    uint32_t item_size = size + SHADOW_CACHE_ITEM_OVERHEAD;
+    if(item_size > sh_cache_mem_size) return;
+
+    _lv_parallel_lock();
+    lv_lru_t * cache = LV_GC_ROOT(_lv_draw_sw_shadow_cache);
+    if(cache == NULL) {
+        cache = lv_lru_create(sh_cache_mem_size, SHADOW_CACHE_AVG_ITEM_SIZE, shadow_cache_free_cb, NULL);
+        LV_GC_ROOT(_lv_draw_sw_shadow_cache) = cache;
+    }
+
+    if(cache) {
+        /*The other render thread might have added it since the lookup*/
+        lv_opa_t * cached;
+        lv_lru_get(cache, key, sizeof(shadow_cache_key_t), (void **)&cached);
+        if(cached == NULL) {
+            cached = lv_mem_cache_alloc(size);
+            if(cached) {
+                lv_memcpy(cached, sh_buf, size);
+                sh_cache_entry_cnt++;
+                lv_lru_set(cache, key, sizeof(shadow_cache_key_t), cached, item_size);
+            }
+        }
+    }
+    _lv_parallel_unlock();
+}
+
+/**
+ * Free a corner evicted by the LRU
+ * @param p         the corner
+ */
+static void shadow_cache_free_cb(void * p)
+{
+    lv_mem_cache_free(p);
+    sh_cache_entry_cnt--;
+    sh_cache_evict_cnt++;
+}
+#endif /*LV_SHADOW_CACHE_SIZE*/
 #endif
 
 static void draw_outline(lv_draw_ctx_t * draw_ctx, const lv_draw_rect_dsc_t * dsc, const lv_area_t * coords)
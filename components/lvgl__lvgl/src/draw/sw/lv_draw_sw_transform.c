@@ -47,23 +47,65 @@ typedef struct {
 static void transform_point_upscaled(point_transform_dsc_t * t, int32_t xin, int32_t yin, int32_t * xout,
                                      int32_t * yout);
 
+static void transform_px(const uint8_t * src, lv_coord_t src_w, lv_coord_t src_h, lv_coord_t src_stride,
+                         int32_t xs_ups, int32_t ys_ups, int32_t xs_step, int32_t ys_step,
+                         int32_t x_start, int32_t x_end, lv_color_t * cbuf, uint8_t * abuf, lv_img_cf_t cf, bool aa);
+
 static void argb_no_aa(const uint8_t * src, lv_coord_t src_w, lv_coord_t src_h, lv_coord_t src_stride,
                        int32_t xs_ups, int32_t ys_ups, int32_t xs_step, int32_t ys_step,
-                       int32_t x_end, lv_color_t * cbuf, uint8_t * abuf);
+                       int32_t x_start, int32_t x_end, lv_color_t * cbuf, uint8_t * abuf);
 
 static void rgb_no_aa(const uint8_t * src, lv_coord_t src_w, lv_coord_t src_h, lv_coord_t src_stride,
                       int32_t xs_ups, int32_t ys_ups, int32_t xs_step, int32_t ys_step,
-                      int32_t x_end, lv_color_t * cbuf, uint8_t * abuf, lv_img_cf_t cf);
+                      int32_t x_start, int32_t x_end, lv_color_t * cbuf, uint8_t * abuf, lv_img_cf_t cf);
 
 #if LV_COLOR_DEPTH == 16
 static void rgb565a8_no_aa(const uint8_t * src, lv_coord_t src_w, lv_coord_t src_h, lv_coord_t src_stride,
                            int32_t xs_ups, int32_t ys_ups, int32_t xs_step, int32_t ys_step,
-                           int32_t x_end, lv_color_t * cbuf, uint8_t * abuf);
+                           int32_t x_start, int32_t x_end, lv_color_t * cbuf, uint8_t * abuf);
 #endif
 
 static void argb_and_rgb_aa(const uint8_t * src, lv_coord_t src_w, lv_coord_t src_h, lv_coord_t src_stride,
                             int32_t xs_ups, int32_t ys_ups, int32_t xs_step, int32_t ys_step,
-                            int32_t x_end, lv_color_t * cbuf, uint8_t * abuf, lv_img_cf_t cf);
+                            int32_t x_start, int32_t x_end, lv_color_t * cbuf, uint8_t * abuf, lv_img_cf_t cf);
+
+static bool aa_get_format(lv_img_cf_t cf, int32_t * px_size, bool * has_alpha, lv_color_t * ck);
+
+static inline void aa_mix_px(const uint8_t * src, lv_coord_t src_h, lv_coord_t src_stride, int32_t px_size,
+                             lv_img_cf_t cf, bool has_alpha, lv_color_t ck, int32_t xs_int, int32_t ys_int,
+                             int32_t x_next, int32_t y_next, int32_t xs_fract, int32_t ys_fract,
+                             lv_color_t * cbuf, uint8_t * abuf);
+
+static void inner_range(int32_t v_ups, int32_t step, int32_t v_min, int32_t v_max, int32_t * x_start,
+                        int32_t * x_end);
+
+static int32_t inner_first_x(int32_t v_ups, int32_t step, int32_t limit, int32_t x_min, int32_t x_max);
+
+static void transform_inner(const uint8_t * src, lv_coord_t src_h, lv_coord_t src_stride,
+                            int32_t xs_ups, int32_t ys_ups, int32_t xs_step, int32_t ys_step,
+                            int32_t x_start, int32_t x_end, lv_color_t * cbuf, uint8_t * abuf, lv_img_cf_t cf, bool aa);
+
+static void copy_inner(const uint8_t * src, lv_coord_t src_h, lv_coord_t src_stride,
+                       int32_t xs_ups, int32_t ys_ups, int32_t xs_step, int32_t ys_step,
+                       int32_t x_start, int32_t x_end, lv_color_t * cbuf, uint8_t * abuf, lv_img_cf_t cf);
+
+static void scale_inner(const uint8_t * src, lv_coord_t src_h, lv_coord_t src_stride,
+                        int32_t xs_ups, int32_t ys_ups, int32_t xs_step,
+                        int32_t x_start, int32_t x_end, lv_color_t * cbuf, uint8_t * abuf, lv_img_cf_t cf);
+static void repeat_inner(const uint8_t * src, lv_coord_t src_h, lv_coord_t src_stride,
+                         int32_t xs_ups, int32_t ys_ups, int32_t xs_step,
+                         int32_t x_start, int32_t x_end, lv_color_t * cbuf, uint8_t * abuf, lv_img_cf_t cf);
+
+static void nearest_inner(const uint8_t * src, lv_coord_t src_h, lv_coord_t src_stride,
+                          int32_t xs_ups, int32_t ys_ups, int32_t xs_step, int32_t ys_step,
+                          int32_t x_start, int32_t x_end, lv_color_t * cbuf, uint8_t * abuf, lv_img_cf_t cf);
+
+static void aa_inner(const uint8_t * src, lv_coord_t src_h, lv_coord_t src_stride,
+                     int32_t xs_ups, int32_t ys_ups, int32_t xs_step, int32_t ys_step,
+                     int32_t x_start, int32_t x_end, lv_color_t * cbuf, uint8_t * abuf, lv_img_cf_t cf);
+
+static inline void read_px(const uint8_t * src, lv_coord_t src_h, lv_coord_t src_stride, int32_t idx,
+                           lv_img_cf_t cf, lv_color_t ck, lv_color_t * c, lv_opa_t * a);
 
 /**********************
  *  STATIC VARIABLES
@@ -107,6 +149,13 @@ void lv_draw_sw_transform(lv_draw_ctx_t * draw_ctx, const lv_area_t * dest_area,
 
     lv_coord_t dest_w = lv_area_get_width(dest_area);
     lv_coord_t dest_h = lv_area_get_height(dest_area);
+
+    bool inner_supported = cf == LV_IMG_CF_TRUE_COLOR || cf == LV_IMG_CF_TRUE_COLOR_ALPHA ||
+                           cf == LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED;
+#if LV_COLOR_DEPTH == 16
+    if(cf == LV_IMG_CF_RGB565A8) inner_supported = true;
+#endif
+
     lv_coord_t y;
     for(y = 0; y < dest_h; y++) {
         int32_t xs1_ups, ys1_ups, xs2_ups, ys2_ups;
@@ -125,29 +174,24 @@ void lv_draw_sw_transform(lv_draw_ctx_t * draw_ctx, const lv_area_t * dest_area,
         int32_t xs_ups = xs1_ups + 0x80;
         int32_t ys_ups = ys1_ups + 0x80;
 
-        if(draw_dsc->antialias == 0) {
-            switch(cf) {
-                case LV_IMG_CF_TRUE_COLOR_ALPHA:
-                    argb_no_aa(src_buf, src_w, src_h, src_stride, xs_ups, ys_ups, xs_step_256, ys_step_256, dest_w, cbuf, abuf);
-                    break;
-                case LV_IMG_CF_TRUE_COLOR:
-                case LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED:
-                    rgb_no_aa(src_buf, src_w, src_h, src_stride, xs_ups, ys_ups, xs_step_256, ys_step_256, dest_w, cbuf, abuf, cf);
-                    break;
-
-#if LV_COLOR_DEPTH == 16
-                case LV_IMG_CF_RGB565A8:
-                    rgb565a8_no_aa(src_buf, src_w, src_h, src_stride, xs_ups, ys_ups, xs_step_256, ys_step_256, dest_w, cbuf, abuf);
-                    break;
-#endif
-                default:
-                    break;
-            }
-        }
-        else {
-            argb_and_rgb_aa(src_buf, src_w, src_h, src_stride, xs_ups, ys_ups, xs_step_256, ys_step_256, dest_w, cbuf, abuf, cf);
+        /*The pixels whose source pixel (and its neighbors for anti-aliasing) is surely on the image
+         *are transformed by the fast kernels. Only the pixels around the edges of the image need the checks.*/
+        int32_t inner_start = 0;
+        int32_t inner_end = 0;
+        if(inner_supported) {
+            int32_t margin = draw_dsc->antialias ? 1 : 0;
+            inner_end = dest_w;
+            inner_range(xs_ups, xs_step_256, margin, src_w - 1 - margin, &inner_start, &inner_end);
+            inner_range(ys_ups, ys_step_256, margin, src_h - 1 - margin, &inner_start, &inner_end);
         }
 
+        transform_px(src_buf, src_w, src_h, src_stride, xs_ups, ys_ups, xs_step_256, ys_step_256,
+                     0, inner_start, cbuf, abuf, cf, draw_dsc->antialias);
+        transform_inner(src_buf, src_h, src_stride, xs_ups, ys_ups, xs_step_256, ys_step_256,
+                        inner_start, inner_end, cbuf, abuf, cf, draw_dsc->antialias);
+        transform_px(src_buf, src_w, src_h, src_stride, xs_ups, ys_ups, xs_step_256, ys_step_256,
+                     inner_end, dest_w, cbuf, abuf, cf, draw_dsc->antialias);
+
         cbuf += dest_w;
         abuf += dest_w;
     }
@@ -157,19 +201,52 @@ void lv_draw_sw_transform(lv_draw_ctx_t * draw_ctx, const lv_area_t * dest_area,
  *   STATIC FUNCTIONS
  **********************/
 
+/**
+ * Transform the pixels of a line one by one, checking whether their source is on the image
+ */
+static void transform_px(const uint8_t * src, lv_coord_t src_w, lv_coord_t src_h, lv_coord_t src_stride,
+                         int32_t xs_ups, int32_t ys_ups, int32_t xs_step, int32_t ys_step,
+                         int32_t x_start, int32_t x_end, lv_color_t * cbuf, uint8_t * abuf, lv_img_cf_t cf, bool aa)
+{
+    if(x_start >= x_end) return;
+
+    if(aa == false) {
+        switch(cf) {
+            case LV_IMG_CF_TRUE_COLOR_ALPHA:
+                argb_no_aa(src, src_w, src_h, src_stride, xs_ups, ys_ups, xs_step, ys_step, x_start, x_end, cbuf, abuf);
+                break;
+            case LV_IMG_CF_TRUE_COLOR:
+            case LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED:
+                rgb_no_aa(src, src_w, src_h, src_stride, xs_ups, ys_ups, xs_step, ys_step, x_start, x_end, cbuf, abuf, cf);
+                break;
+
+#if LV_COLOR_DEPTH == 16
+            case LV_IMG_CF_RGB565A8:
+                rgb565a8_no_aa(src, src_w, src_h, src_stride, xs_ups, ys_ups, xs_step, ys_step, x_start, x_end, cbuf, abuf);
+                break;
+#endif
+            default:
+                break;
+        }
+    }
+    else {
+        argb_and_rgb_aa(src, src_w, src_h, src_stride, xs_ups, ys_ups, xs_step, ys_step, x_start, x_end, cbuf, abuf, cf);
+    }
+}
+
 static void rgb_no_aa(const uint8_t * src, lv_coord_t src_w, lv_coord_t src_h, lv_coord_t src_stride,
                       int32_t xs_ups, int32_t ys_ups, int32_t xs_step, int32_t ys_step,
-                      int32_t x_end, lv_color_t * cbuf, uint8_t * abuf, lv_img_cf_t cf)
+                      int32_t x_start, int32_t x_end, lv_color_t * cbuf, uint8_t * abuf, lv_img_cf_t cf)
 {
     int32_t xs_ups_start = xs_ups;
     int32_t ys_ups_start = ys_ups;
     lv_disp_t * d = _lv_refr_get_disp_refreshing();
     lv_color_t ck = d->driver->color_chroma_key;
 
-    lv_memset_ff(abuf, x_end);
+    lv_memset_ff(&abuf[x_start], x_end - x_start);
 
     lv_coord_t x;
-    for(x = 0; x < x_end; x++) {
+    for(x = x_start; x < x_end; x++) {
         xs_ups = xs_ups_start + ((xs_step * x) >> 8);
         ys_ups = ys_ups_start + ((ys_step * x) >> 8);
 
@@ -202,13 +279,13 @@ static void rgb_no_aa(const uint8_t * src, lv_coord_t src_w, lv_coord_t src_h, l
 
 static void argb_no_aa(const uint8_t * src, lv_coord_t src_w, lv_coord_t src_h, lv_coord_t src_stride,
                        int32_t xs_ups, int32_t ys_ups, int32_t xs_step, int32_t ys_step,
-                       int32_t x_end, lv_color_t * cbuf, uint8_t * abuf)
+                       int32_t x_start, int32_t x_end, lv_color_t * cbuf, uint8_t * abuf)
 {
     int32_t xs_ups_start = xs_ups;
     int32_t ys_ups_start = ys_ups;
 
     lv_coord_t x;
-    for(x = 0; x < x_end; x++) {
+    for(x = x_start; x < x_end; x++) {
         xs_ups = xs_ups_start + ((xs_step * x) >> 8);
         ys_ups = ys_ups_start + ((ys_step * x) >> 8);
 
@@ -236,13 +313,13 @@ static void argb_no_aa(const uint8_t * src, lv_coord_t src_w, lv_coord_t src_h,
 #if LV_COLOR_DEPTH == 16
 static void rgb565a8_no_aa(const uint8_t * src, lv_coord_t src_w, lv_coord_t src_h, lv_coord_t src_stride,
                            int32_t xs_ups, int32_t ys_ups, int32_t xs_step, int32_t ys_step,
-                           int32_t x_end, lv_color_t * cbuf, uint8_t * abuf)
+                           int32_t x_start, int32_t x_end, lv_color_t * cbuf, uint8_t * abuf)
 {
     int32_t xs_ups_start = xs_ups;
     int32_t ys_ups_start = ys_ups;
 
     lv_coord_t x;
-    for(x = 0; x < x_end; x++) {
+    for(x = x_start; x < x_end; x++) {
         xs_ups = xs_ups_start + ((xs_step * x) >> 8);
         ys_ups = ys_ups_start + ((ys_step * x) >> 8);
 
@@ -266,41 +343,17 @@ static void rgb565a8_no_aa(const uint8_t * src, lv_coord_t src_w, lv_coord_t src
 
 static void argb_and_rgb_aa(const uint8_t * src, lv_coord_t src_w, lv_coord_t src_h, lv_coord_t src_stride,
                             int32_t xs_ups, int32_t ys_ups, int32_t xs_step, int32_t ys_step,
-                            int32_t x_end, lv_color_t * cbuf, uint8_t * abuf, lv_img_cf_t cf)
+                            int32_t x_start, int32_t x_end, lv_color_t * cbuf, uint8_t * abuf, lv_img_cf_t cf)
 {
     int32_t xs_ups_start = xs_ups;
     int32_t ys_ups_start = ys_ups;
     bool has_alpha;
     int32_t px_size;
     lv_color_t ck = _LV_COLOR_ZERO_INITIALIZER;
-    switch(cf) {
-        case LV_IMG_CF_TRUE_COLOR:
-            has_alpha = false;
-            px_size = sizeof(lv_color_t);
-            break;
-        case LV_IMG_CF_TRUE_COLOR_ALPHA:
-            has_alpha = true;
-            px_size = LV_IMG_PX_SIZE_ALPHA_BYTE;
-            break;
-        case LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED: {
-                has_alpha = true;
-                px_size = sizeof(lv_color_t);
-                lv_disp_t * d = _lv_refr_get_disp_refreshing();
-                ck = d->driver->color_chroma_key;
-                break;
-            }
-#if LV_COLOR_DEPTH == 16
-        case LV_IMG_CF_RGB565A8:
-            has_alpha = true;
-            px_size = sizeof(lv_color_t);
-            break;
-#endif
-        default:
-            return;
-    }
+    if(!aa_get_format(cf, &px_size, &has_alpha, &ck)) return;
 
     lv_coord_t x;
-    for(x = 0; x < x_end; x++) {
+    for(x = x_start; x < x_end; x++) {
         xs_ups = xs_ups_start + ((xs_step * x) >> 8);
         ys_ups = ys_ups_start + ((ys_step * x) >> 8);
 
@@ -337,96 +390,17 @@ static void argb_and_rgb_aa(const uint8_t * src, lv_coord_t src_w, lv_coord_t sr
             ys_fract = (ys_fract - 0x80) * 2;
         }
 
-        const uint8_t * src_tmp = src;
-        src_tmp += (ys_int * src_stride * px_size) + xs_int * px_size;
-
         if(xs_int + x_next >= 0 &&
            xs_int + x_next <= src_w - 1 &&
            ys_int + y_next >= 0 &&
            ys_int + y_next <= src_h - 1) {
-
-            const uint8_t * px_base = src_tmp;
-            const uint8_t * px_hor = src_tmp + x_next * px_size;
-            const uint8_t * px_ver = src_tmp + y_next * src_stride * px_size;
-            lv_color_t c_base;
-            lv_color_t c_ver;
-            lv_color_t c_hor;
-
-            if(has_alpha) {
-                lv_opa_t a_base;
-                lv_opa_t a_ver;
-                lv_opa_t a_hor;
-                if(cf == LV_IMG_CF_TRUE_COLOR_ALPHA) {
-                    a_base = px_base[LV_IMG_PX_SIZE_ALPHA_BYTE - 1];
-                    a_ver = px_ver[LV_IMG_PX_SIZE_ALPHA_BYTE - 1];
-                    a_hor = px_hor[LV_IMG_PX_SIZE_ALPHA_BYTE - 1];
-                }
-#if LV_COLOR_DEPTH == 16
-                else if(cf == LV_IMG_CF_RGB565A8) {
-                    const lv_opa_t * a_tmp = src + src_stride * src_h * sizeof(lv_color_t);
-                    a_base = *(a_tmp + (ys_int * src_stride) + xs_int);
-                    a_hor = *(a_tmp + (ys_int * src_stride) + xs_int + x_next);
-                    a_ver = *(a_tmp + ((ys_int + y_next) * src_stride) + xs_int);
-                }
-#endif
-                else if(cf == LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED) {
-                    if(((lv_color_t *)px_base)->full == ck.full ||
-                       ((lv_color_t *)px_ver)->full == ck.full ||
-                       ((lv_color_t *)px_hor)->full == ck.full) {
-                        abuf[x] = 0x00;
-                        continue;
-                    }
-                    else {
-                        a_base = 0xff;
-                        a_ver = 0xff;
-                        a_hor = 0xff;
-                    }
-                }
-                else {
-                    a_base = 0xff;
-                    a_ver = 0xff;
-                    a_hor = 0xff;
-                }
-
-                if(a_ver != a_base) a_ver = ((a_ver * ys_fract) + (a_base * (0x100 - ys_fract))) >> 8;
-                if(a_hor != a_base) a_hor = ((a_hor * xs_fract) + (a_base * (0x100 - xs_fract))) >> 8;
-                abuf[x] = (a_ver + a_hor) >> 1;
-
-                if(abuf[x] == 0x00) continue;
-
-#if LV_COLOR_DEPTH == 1 || LV_COLOR_DEPTH == 8
-                c_base.full = px_base[0];
-                c_ver.full = px_ver[0];
-                c_hor.full = px_hor[0];
-#elif LV_COLOR_DEPTH == 16
-                c_base.full = px_base[0] + (px_base[1] << 8);
-                c_ver.full = px_ver[0] + (px_ver[1] << 8);
-                c_hor.full = px_hor[0] + (px_hor[1] << 8);
-#elif LV_COLOR_DEPTH == 32
-                c_base.full = *((uint32_t *)px_base);
-                c_ver.full = *((uint32_t *)px_ver);
-                c_hor.full = *((uint32_t *)px_hor);
-#endif
-            }
-            /*No alpha channel -> RGB*/
-            else {
-                c_base = *((const lv_color_t *) px_base);
-                c_hor = *((const lv_color_t *) px_hor);
-                c_ver = *((const lv_color_t *) px_ver);
-                abuf[x] = 0xff;
-            }
-
-            if(c_base.full == c_ver.full && c_base.full == c_hor.full) {
-                cbuf[x] = c_base;
-            }
-            else {
-                c_ver = lv_color_mix(c_ver, c_base, ys_fract);
-                c_hor = lv_color_mix(c_hor, c_base, xs_fract);
-                cbuf[x] = lv_color_mix(c_hor, c_ver, LV_OPA_50);
-            }
+            aa_mix_px(src, src_h, src_stride, px_size, cf, has_alpha, ck, xs_int, ys_int, x_next, y_next,
+                      xs_fract, ys_fract, &cbuf[x], &abuf[x]);
         }
         /*Partially out of the image*/
         else {
+            const uint8_t * src_tmp = src;
+            src_tmp += (ys_int * src_stride * px_size) + xs_int * px_size;
 #if LV_COLOR_DEPTH == 1 || LV_COLOR_DEPTH == 8
             cbuf[x].full = src_tmp[0];
 #elif LV_COLOR_DEPTH == 16
@@ -464,6 +438,424 @@ static void argb_and_rgb_aa(const uint8_t * src, lv_coord_t src_w, lv_coord_t sr
     }
 }
 
+/**
+ * Get how the pixels of a color format are mixed with anti-aliasing
+ * @param cf        color format of the image
+ * @param px_size   store the size of a pixel in bytes here (without the alpha map of `LV_IMG_CF_RGB565A8`)
+ * @param has_alpha store whether the pixels can be transparent here
+ * @param ck        store the chroma key color here if `cf` is `LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED`
+ * @return          false if the color format is not supported
+ */
+static bool aa_get_format(lv_img_cf_t cf, int32_t * px_size, bool * has_alpha, lv_color_t * ck)
+{
+    switch(cf) {
+        case LV_IMG_CF_TRUE_COLOR:
+            *has_alpha = false;
+            *px_size = sizeof(lv_color_t);
+            return true;
+        case LV_IMG_CF_TRUE_COLOR_ALPHA:
+            *has_alpha = true;
+            *px_size = LV_IMG_PX_SIZE_ALPHA_BYTE;
+            return true;
+        case LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED: {
+                *has_alpha = true;
+                *px_size = sizeof(lv_color_t);
+                lv_disp_t * d = _lv_refr_get_disp_refreshing();
+                *ck = d->driver->color_chroma_key;
+                return true;
+            }
+#if LV_COLOR_DEPTH == 16
+        case LV_IMG_CF_RGB565A8:
+            *has_alpha = true;
+            *px_size = sizeof(lv_color_t);
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+/**
+ * Mix a pixel of the image with its horizontal and vertical neighbor. All of them have to be on the image.
+ */
+static inline void aa_mix_px(const uint8_t * src, lv_coord_t src_h, lv_coord_t src_stride, int32_t px_size,
+                             lv_img_cf_t cf, bool has_alpha, lv_color_t ck, int32_t xs_int, int32_t ys_int,
+                             int32_t x_next, int32_t y_next, int32_t xs_fract, int32_t ys_fract,
+                             lv_color_t * cbuf, uint8_t * abuf)
+{
+#if LV_COLOR_DEPTH != 16
+    LV_UNUSED(src_h);
+#endif
+
+    const uint8_t * px_base = src + (ys_int * src_stride * px_size) + xs_int * px_size;
+    const uint8_t * px_hor = px_base + x_next * px_size;
+    const uint8_t * px_ver = px_base + y_next * src_stride * px_size;
+    lv_color_t c_base;
+    lv_color_t c_ver;
+    lv_color_t c_hor;
+
+    if(has_alpha) {
+        lv_opa_t a_base;
+        lv_opa_t a_ver;
+        lv_opa_t a_hor;
+        if(cf == LV_IMG_CF_TRUE_COLOR_ALPHA) {
+            a_base = px_base[LV_IMG_PX_SIZE_ALPHA_BYTE - 1];
+            a_ver = px_ver[LV_IMG_PX_SIZE_ALPHA_BYTE - 1];
+            a_hor = px_hor[LV_IMG_PX_SIZE_ALPHA_BYTE - 1];
+        }
+#if LV_COLOR_DEPTH == 16
+        else if(cf == LV_IMG_CF_RGB565A8) {
+            const lv_opa_t * a_tmp = src + src_stride * src_h * sizeof(lv_color_t);
+            a_base = *(a_tmp + (ys_int * src_stride) + xs_int);
+            a_hor = *(a_tmp + (ys_int * src_stride) + xs_int + x_next);
+            a_ver = *(a_tmp + ((ys_int + y_next) * src_stride) + xs_int);
+        }
+#endif
+        else if(cf == LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED) {
+            if(((lv_color_t *)px_base)->full == ck.full ||
+               ((lv_color_t *)px_ver)->full == ck.full ||
+               ((lv_color_t *)px_hor)->full == ck.full) {
+                *abuf = 0x00;
+                return;
+            }
+            else {
+                a_base = 0xff;
+                a_ver = 0xff;
+                a_hor = 0xff;
+            }
+        }
+        else {
+            a_base = 0xff;
+            a_ver = 0xff;
+            a_hor = 0xff;
+        }
+
+        if(a_ver != a_base) a_ver = ((a_ver * ys_fract) + (a_base * (0x100 - ys_fract))) >> 8;
+        if(a_hor != a_base) a_hor = ((a_hor * xs_fract) + (a_base * (0x100 - xs_fract))) >> 8;
+        *abuf = (a_ver + a_hor) >> 1;
+
+        if(*abuf == 0x00) return;
+
+#if LV_COLOR_DEPTH == 1 || LV_COLOR_DEPTH == 8
+        c_base.full = px_base[0];
+        c_ver.full = px_ver[0];
+        c_hor.full = px_hor[0];
+#elif LV_COLOR_DEPTH == 16
+        c_base.full = px_base[0] + (px_base[1] << 8);
+        c_ver.full = px_ver[0] + (px_ver[1] << 8);
+        c_hor.full = px_hor[0] + (px_hor[1] << 8);
+#elif LV_COLOR_DEPTH == 32
+        c_base.full = *((uint32_t *)px_base);
+        c_ver.full = *((uint32_t *)px_ver);
+        c_hor.full = *((uint32_t *)px_hor);
+#endif
+    }
+    /*No alpha channel -> RGB*/
+    else {
+        c_base = *((const lv_color_t *) px_base);
+        c_hor = *((const lv_color_t *) px_hor);
+        c_ver = *((const lv_color_t *) px_ver);
+        *abuf = 0xff;
+    }
+
+    if(c_base.full == c_ver.full && c_base.full == c_hor.full) {
+        *cbuf = c_base;
+    }
+    else {
+        c_ver = lv_color_mix(c_ver, c_base, ys_fract);
+        c_hor = lv_color_mix(c_hor, c_base, xs_fract);
+        *cbuf = lv_color_mix(c_hor, c_ver, LV_OPA_50);
+    }
+}
+
+/**
+ * Limit a range of pixels of a line to the ones whose source coordinate is in a range.
+ * The source coordinate of pixel `x` is `v_ups + ((step * x) >> 8)`, i.e. it changes monotonically.
+ * @param v_ups     upscaled source coordinate of the first pixel of the line
+ * @param step      change of the source coordinate per pixel, upscaled by 256 * 256
+ * @param v_min     the smallest allowed source coordinate
+ * @param v_max     the largest allowed source coordinate
+ * @param x_start   the first pixel of the range, it's updated
+ * @param x_end     the pixel after the range, it's updated. Not less than `x_start` on return.
+ */
+static void inner_range(int32_t v_ups, int32_t step, int32_t v_min, int32_t v_max, int32_t * x_start,
+                        int32_t * x_end)
+{
+    if(*x_start >= *x_end) return;
+
+    int32_t lo = v_min * 256;
+    int32_t hi = (v_max + 1) * 256;
+    if(v_min > v_max || (step == 0 && (v_ups < lo || v_ups >= hi))) {
+        *x_end = *x_start;
+        return;
+    }
+    if(step == 0) return;
+
+    int32_t x1;
+    int32_t x2;
+    if(step > 0) {
+        x1 = inner_first_x(v_ups, step, lo, *x_start, *x_end);
+        x2 = inner_first_x(v_ups, step, hi, x1, *x_end);
+    }
+    else {
+        x1 = inner_first_x(v_ups, step, hi, *x_start, *x_end);
+        x2 = inner_first_x(v_ups, step, lo, x1, *x_end);
+    }
+
+    *x_start = x1;
+    *x_end = x2;
+}
+
+/**
+ * Binary search the first pixel where the source coordinate reaches a limit
+ * (`>= limit` if it increases, `< limit` if it decreases)
+ * @return the first such pixel in `x_min..x_max`, or `x_max` if there is no such pixel
+ */
+static int32_t inner_first_x(int32_t v_ups, int32_t step, int32_t limit, int32_t x_min, int32_t x_max)
+{
+    while(x_min < x_max) {
+        int32_t x = (x_min + x_max) >> 1;
+        int32_t v = v_ups + ((step * x) >> 8);
+        bool reached = step > 0 ? v >= limit : v < limit;
+        if(reached) x_max = x;
+        else x_min = x + 1;
+    }
+
+    return x_min;
+}
+
+/**
+ * Transform the pixels of a line whose source pixels (and their neighbors for anti-aliasing) are all on the image.
+ * The result is the same as with `transform_px` but the kernels are specialized
+ * and the source coordinates are stepped incrementally.
+ */
+static void transform_inner(const uint8_t * src, lv_coord_t src_h, lv_coord_t src_stride,
+                            int32_t xs_ups, int32_t ys_ups, int32_t xs_step, int32_t ys_step,
+                            int32_t x_start, int32_t x_end, lv_color_t * cbuf, uint8_t * abuf, lv_img_cf_t cf, bool aa)
+{
+    if(x_start >= x_end) return;
+
+    /*On translation, on rotation by 90 or 180 degrees and on zooming out by an integer factor (e.g. 0.5x)
+     *the source moves a whole number of pixels per pixel.
+     *Anti-aliasing doesn't change the pixels if the source coordinates are in the middle of the pixels,
+     *except for chroma keying which needs the neighbors too.*/
+    bool int_step = (xs_step == 0 && ys_step != 0 && (ys_step & 0xFFFF) == 0) ||
+                    (ys_step == 0 && xs_step != 0 && (xs_step & 0xFFFF) == 0);
+    bool centered = (xs_ups & 0xFF) == 0x80 && (ys_ups & 0xFF) == 0x80;
+    if(int_step && (!aa || (centered && cf != LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED))) {
+        copy_inner(src, src_h, src_stride, xs_ups, ys_ups, xs_step, ys_step, x_start, x_end, cbuf, abuf, cf);
+    }
+    else if(aa) {
+        aa_inner(src, src_h, src_stride, xs_ups, ys_ups, xs_step, ys_step, x_start, x_end, cbuf, abuf, cf);
+    }
+    /*Zooming in by a power of two (2x, 4x, ...): every source pixel is repeated the same number of times*/
+    else if(ys_step == 0 && xs_step > 0 && xs_step < 0x10000 && (0x10000 % xs_step) == 0 && (xs_step & 0xFF) == 0) {
+        repeat_inner(src, src_h, src_stride, xs_ups, ys_ups, xs_step, x_start, x_end, cbuf, abuf, cf);
+    }
+    /*Zoom without rotation: the whole line is from the same row of the image*/
+    else if(ys_step == 0) {
+        scale_inner(src, src_h, src_stride, xs_ups, ys_ups, xs_step, x_start, x_end, cbuf, abuf, cf);
+    }
+    else {
+        nearest_inner(src, src_h, src_stride, xs_ups, ys_ups, xs_step, ys_step, x_start, x_end, cbuf, abuf, cf);
+    }
+}
+
+static void copy_inner(const uint8_t * src, lv_coord_t src_h, lv_coord_t src_stride,
+                       int32_t xs_ups, int32_t ys_ups, int32_t xs_step, int32_t ys_step,
+                       int32_t x_start, int32_t x_end, lv_color_t * cbuf, uint8_t * abuf, lv_img_cf_t cf)
+{
+    int32_t xs_int = (xs_ups + ((xs_step * x_start) >> 8)) >> 8;
+    int32_t ys_int = (ys_ups + ((ys_step * x_start) >> 8)) >> 8;
+    int32_t idx = ys_int * src_stride + xs_int;
+    int32_t idx_step = (xs_step >> 16) + (ys_step >> 16) * src_stride;
+
+    /*Translation: copy the line of the image*/
+    if(cf == LV_IMG_CF_TRUE_COLOR && idx_step == 1) {
+        lv_memcpy(&cbuf[x_start], (const lv_color_t *)src + idx, (x_end - x_start) * sizeof(lv_color_t));
+        lv_memset_ff(&abuf[x_start], x_end - x_start);
+        return;
+    }
+
+    lv_color_t ck = _LV_COLOR_ZERO_INITIALIZER;
+    if(cf == LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED) ck = _lv_refr_get_disp_refreshing()->driver->color_chroma_key;
+
+    lv_coord_t x;
+    for(x = x_start; x < x_end; x++) {
+        read_px(src, src_h, src_stride, idx, cf, ck, &cbuf[x], &abuf[x]);
+        idx += idx_step;
+    }
+}
+
+static void scale_inner(const uint8_t * src, lv_coord_t src_h, lv_coord_t src_stride,
+                        int32_t xs_ups, int32_t ys_ups, int32_t xs_step,
+                        int32_t x_start, int32_t x_end, lv_color_t * cbuf, uint8_t * abuf, lv_img_cf_t cf)
+{
+    lv_color_t ck = _LV_COLOR_ZERO_INITIALIZER;
+    if(cf == LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED) ck = _lv_refr_get_disp_refreshing()->driver->color_chroma_key;
+
+    int32_t row_idx = (ys_ups >> 8) * src_stride;
+    int32_t xs_acc = xs_step * x_start;
+    int32_t xs_int_prev = -1;
+    lv_color_t c = _LV_COLOR_ZERO_INITIALIZER;
+    lv_opa_t a = 0;
+
+    lv_coord_t x;
+    for(x = x_start; x < x_end; x++) {
+        int32_t xs_int = (xs_ups + (xs_acc >> 8)) >> 8;
+        xs_acc += xs_step;
+
+        /*When zooming in, a source pixel is repeated on the next pixels so read it only once*/
+        if(xs_int != xs_int_prev) {
+            read_px(src, src_h, src_stride, row_idx + xs_int, cf, ck, &c, &a);
+            xs_int_prev = xs_int;
+        }
+
+        cbuf[x] = c;
+        abuf[x] = a;
+    }
+}
+
+/**
+ * Zoom in without rotation when a source pixel covers the same whole number of pixels,
+ * i.e. `xs_step` is 1/2, 1/4, ... pixel. Read every source pixel once and fill its run.
+ */
+static void repeat_inner(const uint8_t * src, lv_coord_t src_h, lv_coord_t src_stride,
+                         int32_t xs_ups, int32_t ys_ups, int32_t xs_step,
+                         int32_t x_start, int32_t x_end, lv_color_t * cbuf, uint8_t * abuf, lv_img_cf_t cf)
+{
+    lv_color_t ck = _LV_COLOR_ZERO_INITIALIZER;
+    if(cf == LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED) ck = _lv_refr_get_disp_refreshing()->driver->color_chroma_key;
+
+    /*The step is a divisor of 256 in 1/256 pixels, so the runs are exact*/
+    int32_t step = xs_step >> 8;
+    int32_t xs_px = xs_ups + ((xs_step * x_start) >> 8);
+    int32_t idx = (ys_ups >> 8) * src_stride + (xs_px >> 8);
+    int32_t run = (256 - (xs_px & 0xFF) + step - 1) / step;
+    int32_t run_full = 256 / step;
+
+    lv_coord_t x = x_start;
+    while(x < x_end) {
+        lv_color_t c;
+        lv_opa_t a;
+        read_px(src, src_h, src_stride, idx, cf, ck, &c, &a);
+
+        /*The runs are short (2x, 4x, ...), a loop is faster than calling the fill functions*/
+        lv_coord_t run_end = LV_MIN(x + run, x_end);
+        for(; x < run_end; x++) {
+            cbuf[x] = c;
+            abuf[x] = a;
+        }
+        idx++;
+        run = run_full;
+    }
+}
+
+static void nearest_inner(const uint8_t * src, lv_coord_t src_h, lv_coord_t src_stride,
+                          int32_t xs_ups, int32_t ys_ups, int32_t xs_step, int32_t ys_step,
+                          int32_t x_start, int32_t x_end, lv_color_t * cbuf, uint8_t * abuf, lv_img_cf_t cf)
+{
+    lv_color_t ck = _LV_COLOR_ZERO_INITIALIZER;
+    if(cf == LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED) ck = _lv_refr_get_disp_refreshing()->driver->color_chroma_key;
+
+    /*Step the source coordinates incrementally instead of multiplying in every pixel*/
+    int32_t xs_acc = xs_step * x_start;
+    int32_t ys_acc = ys_step * x_start;
+
+    lv_coord_t x;
+    for(x = x_start; x < x_end; x++) {
+        int32_t xs_int = (xs_ups + (xs_acc >> 8)) >> 8;
+        int32_t ys_int = (ys_ups + (ys_acc >> 8)) >> 8;
+        xs_acc += xs_step;
+        ys_acc += ys_step;
+
+        read_px(src, src_h, src_stride, ys_int * src_stride + xs_int, cf, ck, &cbuf[x], &abuf[x]);
+    }
+}
+
+static void aa_inner(const uint8_t * src, lv_coord_t src_h, lv_coord_t src_stride,
+                     int32_t xs_ups, int32_t ys_ups, int32_t xs_step, int32_t ys_step,
+                     int32_t x_start, int32_t x_end, lv_color_t * cbuf, uint8_t * abuf, lv_img_cf_t cf)
+{
+    bool has_alpha;
+    int32_t px_size;
+    lv_color_t ck = _LV_COLOR_ZERO_INITIALIZER;
+    if(!aa_get_format(cf, &px_size, &has_alpha, &ck)) return;
+
+    /*Step the source coordinates incrementally instead of multiplying in every pixel*/
+    int32_t xs_acc = xs_step * x_start;
+    int32_t ys_acc = ys_step * x_start;
+
+    lv_coord_t x;
+    for(x = x_start; x < x_end; x++) {
+        int32_t xs_px = xs_ups + (xs_acc >> 8);
+        int32_t ys_px = ys_ups + (ys_acc >> 8);
+        xs_acc += xs_step;
+        ys_acc += ys_step;
+
+        int32_t xs_fract = xs_px & 0xFF;
+        int32_t ys_fract = ys_px & 0xFF;
+        int32_t x_next;
+        int32_t y_next;
+        if(xs_fract < 0x80) {
+            x_next = -1;
+            xs_fract = (0x7F - xs_fract) * 2;
+        }
+        else {
+            x_next = 1;
+            xs_fract = (xs_fract - 0x80) * 2;
+        }
+        if(ys_fract < 0x80) {
+            y_next = -1;
+            ys_fract = (0x7F - ys_fract) * 2;
+        }
+        else {
+            y_next = 1;
+            ys_fract = (ys_fract - 0x80) * 2;
+        }
+
+        aa_mix_px(src, src_h, src_stride, px_size, cf, has_alpha, ck, xs_px >> 8, ys_px >> 8, x_next, y_next,
+                  xs_fract, ys_fract, &cbuf[x], &abuf[x]);
+    }
+}
+
+/**
+ * Read a pixel of the image like the not anti-aliased kernels
+ * @param idx   index of the pixel on the image (y * stride + x)
+ * @param ck    the chroma key color if `cf` is `LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED`
+ * @param c     store the color here
+ * @param a     store the opacity here
+ */
+static inline void read_px(const uint8_t * src, lv_coord_t src_h, lv_coord_t src_stride, int32_t idx,
+                           lv_img_cf_t cf, lv_color_t ck, lv_color_t * c, lv_opa_t * a)
+{
+    if(cf == LV_IMG_CF_TRUE_COLOR_ALPHA) {
+        const uint8_t * src_tmp = src + idx * LV_IMG_PX_SIZE_ALPHA_BYTE;
+#if LV_COLOR_DEPTH == 1 || LV_COLOR_DEPTH == 8
+        c->full = src_tmp[0];
+#elif LV_COLOR_DEPTH == 16
+        c->full = src_tmp[0] + (src_tmp[1] << 8);
+#elif LV_COLOR_DEPTH == 32
+        c->full = *((uint32_t *)src_tmp);
+#endif
+        *a = src_tmp[LV_IMG_PX_SIZE_ALPHA_BYTE - 1];
+        return;
+    }
+
+    *c = ((const lv_color_t *)src)[idx];
+#if LV_COLOR_DEPTH == 16
+    if(cf == LV_IMG_CF_RGB565A8) {
+        *a = (src + src_stride * src_h * sizeof(lv_color_t))[idx];
+        return;
+    }
+#else
+    LV_UNUSED(src_h);
+    LV_UNUSED(src_stride);
+#endif
+
+    *a = cf == LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED && c->full == ck.full ? 0x00 : 0xff;
+}
+
 static void transform_point_upscaled(point_transform_dsc_t * t, int32_t xin, int32_t yin, int32_t * xout,
                                      int32_t * yout)
 {
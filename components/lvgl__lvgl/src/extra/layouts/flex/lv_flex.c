@@ -7,16 +7,64 @@
  *      INCLUDES
  *********************/
 #include "../lv_layouts.h"
+#include "../../../core/lv_indev_hit_index.h"
 
 #if LV_USE_FLEX
 
 /*********************
  *      DEFINES
  *********************/
+#if LV_FLEX_CACHE
+#define ITEM_IGNORED    0x01
+#define ITEM_NEW_TRACK  0x02
+#define CACHE_MIN_ITEMS 16         /*Fewer items are laid out faster than compared with the cache*/
+#endif
 
 /**********************
  *      TYPEDEFS
  **********************/
+#if LV_FLEX_CACHE
+/*Everything of the container which affects the position of the items, besides the items*/
+typedef struct {
+    lv_coord_t max_main_size;
+    lv_coord_t item_gap;
+    lv_coord_t track_gap;
+    uint8_t row;
+    uint8_t wrap;
+    uint8_t rev;
+    uint8_t rtl;
+    uint8_t main_place;
+    uint8_t cross_place;
+} flex_cache_params_t;
+
+/*An item after the last layout*/
+typedef struct {
+    lv_obj_t * obj;
+    lv_coord_t x;               /*Relative to the start of the content area*/
+    lv_coord_t y;
+    lv_coord_t w;
+    lv_coord_t h;
+    lv_coord_t main_pos;        /*Position in the track before placing this item*/
+    uint8_t flags;
+} flex_cache_item_t;
+
+typedef struct {
+    int32_t first_item;
+    lv_coord_t cross_pos;       /*Relative to the start of the content area*/
+    lv_coord_t cross_size;
+} flex_cache_track_t;
+
+/*Stored in one block in `spec_attr->flex_cache`: the header, `item_cnt` items and tracks*/
+typedef struct {
+    flex_cache_params_t params;
+    flex_cache_item_t * items;  /*Index by child index*/
+    flex_cache_track_t * tracks;
+    uint32_t item_cnt;
+    uint32_t track_cnt;
+    bool valid;
+} flex_cache_t;
+#endif
+
 typedef struct {
     lv_flex_align_t main_place;
     lv_flex_align_t cross_place;
@@ -24,6 +72,14 @@ typedef struct {
     uint8_t row : 1;
     uint8_t wrap : 1;
     uint8_t rev : 1;
+#if LV_FLEX_CACHE
+    uint8_t same_track : 1;     /*The current track is the same as before, unchanged items can be skipped*/
+    flex_cache_t * cache;       /*NULL: don't use and update the cache*/
+    lv_coord_t base_x;          /*Start of the content area*/
+    lv_coord_t base_y;
+    int32_t first_changed;      /*The changed items' first and last position in the order of placing*/
+    int32_t last_changed;
+#endif
 } flex_t;
 
 typedef struct {
@@ -60,6 +116,13 @@ static void children_repos(lv_obj_t * cont, flex_t * f, int32_t item_first_id, i
 static void place_content(lv_flex_align_t place, lv_coord_t max_size, lv_coord_t content_size, lv_coord_t item_cnt,
                           lv_coord_t * start_pos, lv_coord_t * gap);
 static lv_obj_t * get_next_item(lv_obj_t * cont, bool rev, int32_t * item_id);
+#if LV_FLEX_CACHE
+static bool cache_usable(lv_obj_t * cont, const flex_t * f, lv_flex_align_t track_cross_place, bool rtl);
+static flex_cache_t * cache_get(lv_obj_t * cont, const flex_cache_params_t * params);
+static bool cache_find_changes(lv_obj_t * cont, flex_t * f);
+static uint8_t get_item_flags(const lv_obj_t * item);
+static void cache_save_item(flex_t * f, int32_t item_id, lv_obj_t * item, lv_coord_t main_pos);
+#endif
 
 /**********************
  *  GLOBAL VARIABLES
@@ -78,6 +141,8 @@ lv_style_prop_t LV_STYLE_FLEX_GROW;
 /**********************
  *      MACROS
  **********************/
+/*Position of an item in the order of placing*/
+#define ITEM_POS(cont, f, id) ((f)->rev ? (int32_t)(cont)->spec_attr->child_cnt - 1 - (id) : (id))
 
 /**********************
  *   GLOBAL FUNCTIONS
@@ -277,6 +342,55 @@ static void flex_update(lv_obj_t * cont, void * user_data)
         *cross_pos += total_track_cross_size;
     }
 
+#if LV_FLEX_CACHE
+    /*With START track placement the tracks before a change stay in place, and the items before and after it too.
+     *Find the first changed item and re-layout from its track until the positions match the previous layout again.
+     *See `cache_usable()` for the containers laid out from scratch every time.*/
+    uint32_t track_id = 0;
+    uint32_t old_track_cnt = 0;
+    f.same_track = 0;
+    f.cache = NULL;
+    f.base_x = abs_x;
+    f.base_y = abs_y;
+    f.first_changed = 0;
+    f.last_changed = INT32_MAX;
+    if(cache_usable(cont, &f, track_cross_place, rtl)) {
+        flex_cache_params_t params;
+        params.max_main_size = max_main_size;
+        params.item_gap = item_gap;
+        params.track_gap = track_gap;
+        params.row = f.row;
+        params.wrap = f.wrap;
+        params.rev = f.rev;
+        params.rtl = rtl;
+        params.main_place = f.main_place;
+        params.cross_place = f.cross_place;
+        f.cache = cache_get(cont, &params);
+    }
+    else if(cont->spec_attr->flex_cache) {
+        ((flex_cache_t *)cont->spec_attr->flex_cache)->valid = false;
+    }
+
+    if(f.cache && f.cache->valid) {
+        old_track_cnt = f.cache->track_cnt;
+        if(!cache_find_changes(cont, &f)) {
+            track_first_item = -1;  /*Nothing to do*/
+            track_id = old_track_cnt;
+        }
+        else {
+            while(track_id + 1 < old_track_cnt &&
+                  ITEM_POS(cont, &f, f.cache->tracks[track_id + 1].first_item) <= f.first_changed) {
+                track_id++;
+            }
+            /*The changed items might fit into the end of the previous track*/
+            if(track_id > 0) track_id--;
+            track_first_item = f.cache->tracks[track_id].first_item;
+            *cross_pos += f.cache->tracks[track_id].cross_pos;
+        }
+    }
+    if(f.cache) f.cache->valid = false;
+#endif
+
     while(track_first_item < (int32_t)cont->spec_attr->child_cnt && track_first_item >= 0) {
         track_t t;
         t.grow_dsc_calc = 1;
@@ -286,6 +400,24 @@ static void flex_update(lv_obj_t * cont, void * user_data)
         if(rtl && !f.row) {
             *cross_pos -= t.track_cross_size;
         }
+
+#if LV_FLEX_CACHE
+        if(f.cache) {
+            lv_coord_t track_cross_pos = *cross_pos - (f.row ? f.base_y : f.base_x);
+            flex_cache_track_t * old_track = track_id < old_track_cnt ? &f.cache->tracks[track_id] : NULL;
+            int32_t old_track_end = track_id + 1 < old_track_cnt ? f.cache->tracks[track_id + 1].first_item :
+                                    (f.rev ? -1 : (int32_t)cont->spec_attr->child_cnt);
+            f.same_track = old_track && old_track->first_item == track_first_item &&
+                           old_track_end == next_track_first_item && old_track->cross_pos == track_cross_pos &&
+                           (f.cross_place == LV_FLEX_ALIGN_START || old_track->cross_size == t.track_cross_size) &&
+                           f.main_place == LV_FLEX_ALIGN_START && t.grow_item_cnt == 0;
+
+            f.cache->tracks[track_id].first_item = track_first_item;
+            f.cache->tracks[track_id].cross_pos = track_cross_pos;
+            f.cache->tracks[track_id].cross_size = t.track_cross_size;
+        }
+#endif
+
         children_repos(cont, &f, track_first_item, next_track_first_item, abs_x, abs_y, max_main_size, item_gap, &t);
         track_first_item = next_track_first_item;
         lv_mem_buf_release(t.grow_dsc);
@@ -296,7 +428,25 @@ static void flex_update(lv_obj_t * cont, void * user_data)
         else {
             *cross_pos += t.track_cross_size + gap + track_gap;
         }
+
+#if LV_FLEX_CACHE
+        track_id++;
+        /*The next tracks are the same if they start at the same item and position and have no changes*/
+        if(f.cache && track_id < old_track_cnt && f.cache->tracks[track_id].first_item == track_first_item &&
+           f.cache->tracks[track_id].cross_pos == *cross_pos - (f.row ? f.base_y : f.base_x) &&
+           ITEM_POS(cont, &f, track_first_item) > f.last_changed) {
+            track_id = old_track_cnt;
+            break;
+        }
+#endif
     }
+
+#if LV_FLEX_CACHE
+    if(f.cache) {
+        f.cache->track_cnt = track_id;
+        f.cache->valid = true;
+    }
+#endif
     LV_ASSERT_MEM_INTEGRITY();
 
     if(w_set == LV_SIZE_CONTENT || h_set == LV_SIZE_CONTENT) {
@@ -448,13 +598,26 @@ static void children_repos(lv_obj_t * cont, flex_t * f, int32_t item_first_id, i
     place_content(f->main_place, max_main_size, t->track_main_size, t->item_cnt, &main_pos, &place_gap);
     if(f->row && rtl) main_pos += lv_obj_get_content_width(cont);
 
+#if LV_FLEX_CACHE
+    /*The items before the first change are at the same place, continue from the first changed item*/
+    if(f->cache && f->same_track && ITEM_POS(cont, f, item_first_id) < f->first_changed &&
+       f->first_changed < ITEM_POS(cont, f, item_last_id)) {
+        item_first_id = f->rev ? (int32_t)cont->spec_attr->child_cnt - 1 - f->first_changed : f->first_changed;
+        main_pos = f->cache->items[item_first_id].main_pos;
+    }
+#endif
+
     lv_obj_t * item = lv_obj_get_child(cont, item_first_id);
     /*Reposition the children*/
     while(item && item_first_id != item_last_id) {
         if(lv_obj_has_flag_any(item, LV_OBJ_FLAG_IGNORE_LAYOUT | LV_OBJ_FLAG_HIDDEN | LV_OBJ_FLAG_FLOATING)) {
+#if LV_FLEX_CACHE
+            if(f->cache) cache_save_item(f, item_first_id, item, main_pos);
+#endif
             item = get_next_item(cont, f->rev, &item_first_id);
             continue;
         }
+        lv_coord_t item_main_pos = main_pos;
         lv_coord_t grow_size = lv_obj_get_style_flex_grow(item, LV_PART_MAIN);
         if(grow_size) {
             lv_coord_t s = 0;
@@ -529,10 +692,28 @@ static void children_repos(lv_obj_t * cont, flex_t * f, int32_t item_first_id, i
             lv_obj_move_children_by(item, diff_x, diff_y, false);
         }
 
+#if LV_INDEV_HIT_INDEX_CELL_SIZE
+        _lv_indev_hit_index_update(item);
+#endif
+
         if(!(f->row && rtl)) main_pos += area_get_main_size(&item->coords) + item_gap + place_gap;
         else main_pos -= item_gap + place_gap;
 
+#if LV_FLEX_CACHE
+        if(f->cache) cache_save_item(f, item_first_id, item, item_main_pos);
+#else
+        LV_UNUSED(item_main_pos);
+#endif
+
         item = get_next_item(cont, f->rev, &item_first_id);
+
+#if LV_FLEX_CACHE
+        /*The rest of the track is the same if the next item is at the same place and there are no changes after it*/
+        if(f->cache && f->same_track && item && item_first_id != item_last_id &&
+           ITEM_POS(cont, f, item_first_id) > f->last_changed && f->cache->items[item_first_id].main_pos == main_pos) {
+            break;
+        }
+#endif
     }
 }
 
@@ -593,4 +774,136 @@ static lv_obj_t * get_next_item(lv_obj_t * cont, bool rev, int32_t * item_id)
     }
 }
 
+#if LV_FLEX_CACHE
+
+/**
+ * Check if the layout of a container can start from the cache. It can't if
+ * - the tracks aren't placed to the start: a change moves the tracks before it too,
+ * - the container is content sized: its size depends on all items,
+ * - a wrapping container has grow items: where the tracks wrap depends on the earlier layouts too,
+ * - there are only a few items.
+ */
+static bool cache_usable(lv_obj_t * cont, const flex_t * f, lv_flex_align_t track_cross_place, bool rtl)
+{
+    if(track_cross_place != LV_FLEX_ALIGN_START || (rtl && !f->row)) return false;
+    if(cont->spec_attr->child_cnt < CACHE_MIN_ITEMS) return false;
+    if(lv_obj_get_style_width(cont, LV_PART_MAIN) == LV_SIZE_CONTENT ||
+       lv_obj_get_style_height(cont, LV_PART_MAIN) == LV_SIZE_CONTENT) return false;
+
+    if(f->wrap) {
+        uint32_t i;
+        for(i = 0; i < cont->spec_attr->child_cnt; i++) {
+            lv_obj_t * item = cont->spec_attr->children[i];
+            if(!lv_obj_has_flag_any(item, LV_OBJ_FLAG_IGNORE_LAYOUT | LV_OBJ_FLAG_HIDDEN | LV_OBJ_FLAG_FLOATING) &&
+               lv_obj_get_style_flex_grow(item, LV_PART_MAIN)) return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Get the cache of a container. If the parameters or the number of children has changed it's invalidated.
+ * @return the cache or NULL if it couldn't be allocated
+ */
+static flex_cache_t * cache_get(lv_obj_t * cont, const flex_cache_params_t * params)
+{
+    uint32_t child_cnt = cont->spec_attr->child_cnt;
+    flex_cache_t * cache = cont->spec_attr->flex_cache;
+
+    if(cache == NULL || cache->item_cnt != child_cnt) {
+        uint32_t size = sizeof(flex_cache_t) + child_cnt * (sizeof(flex_cache_item_t) + sizeof(flex_cache_track_t));
+        cache = lv_mem_realloc(cache, size);
+        LV_ASSERT_MALLOC(cache);
+        cont->spec_attr->flex_cache = cache;
+        if(cache == NULL) return NULL;
+
+        cache->params = *params;
+        cache->item_cnt = child_cnt;
+        cache->track_cnt = 0;
+        cache->valid = false;
+    }
+
+    cache->items = (flex_cache_item_t *)(cache + 1);
+    cache->tracks = (flex_cache_track_t *)(cache->items + child_cnt);
+
+    const flex_cache_params_t * p = &cache->params;
+    if(p->max_main_size != params->max_main_size || p->item_gap != params->item_gap ||
+       p->track_gap != params->track_gap || p->row != params->row || p->wrap != params->wrap ||
+       p->rev != params->rev || p->rtl != params->rtl || p->main_place != params->main_place ||
+       p->cross_place != params->cross_place) {
+        cache->params = *params;
+        cache->valid = false;
+    }
+
+    return cache;
+}
+
+/**
+ * Compare the items with the cache and store the position of the first and last changed one
+ * @return false: nothing has changed
+ */
+static bool cache_find_changes(lv_obj_t * cont, flex_t * f)
+{
+    flex_cache_t * cache = f->cache;
+    int32_t first = INT32_MAX;
+    int32_t last = -1;
+
+    int32_t i;
+    for(i = 0; i < (int32_t)cache->item_cnt; i++) {
+        lv_obj_t * item = cont->spec_attr->children[i];
+        const flex_cache_item_t * c = &cache->items[i];
+        uint8_t flags = get_item_flags(item);
+
+        /*Only fields are read here, looking up the styles of every item would take as long as the layout.
+         *The style changes are marked in `parent_layout_inv` instead.*/
+        bool same = c->obj == item && c->flags == flags;
+        if(same && !(flags & ITEM_IGNORED)) {
+            same = !item->parent_layout_inv &&
+                   item->coords.x1 - f->base_x == c->x && item->coords.y1 - f->base_y == c->y &&
+                   lv_area_get_width(&item->coords) == c->w && lv_area_get_height(&item->coords) == c->h;
+        }
+
+        if(!same) {
+            int32_t pos = ITEM_POS(cont, f, i);
+            first = LV_MIN(first, pos);
+            last = LV_MAX(last, pos);
+        }
+    }
+
+    f->first_changed = first;
+    f->last_changed = last;
+
+    return last >= 0;
+}
+
+static uint8_t get_item_flags(const lv_obj_t * item)
+{
+    uint8_t flags = 0;
+    if(lv_obj_has_flag_any(item, LV_OBJ_FLAG_IGNORE_LAYOUT | LV_OBJ_FLAG_HIDDEN | LV_OBJ_FLAG_FLOATING)) {
+        flags |= ITEM_IGNORED;
+    }
+    if(lv_obj_has_flag(item, LV_OBJ_FLAG_FLEX_IN_NEW_TRACK)) flags |= ITEM_NEW_TRACK;
+
+    return flags;
+}
+
+/**
+ * Save an item after placing it
+ */
+static void cache_save_item(flex_t * f, int32_t item_id, lv_obj_t * item, lv_coord_t main_pos)
+{
+    flex_cache_item_t * c = &f->cache->items[item_id];
+    c->obj = item;
+    c->flags = get_item_flags(item);
+    c->main_pos = main_pos;
+    c->x = item->coords.x1 - f->base_x;
+    c->y = item->coords.y1 - f->base_y;
+    c->w = lv_area_get_width(&item->coords);
+    c->h = lv_area_get_height(&item->coords);
+    item->parent_layout_inv = 0;
+}
+
+#endif /*LV_FLEX_CACHE*/
+
 #endif /*LV_USE_FLEX*/
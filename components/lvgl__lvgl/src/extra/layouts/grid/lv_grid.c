@@ -7,6 +7,7 @@
  *      INCLUDES
  *********************/
 #include "../lv_layouts.h"
+#include "../../../core/lv_indev_hit_index.h"
 
 #if LV_USE_GRID
 
@@ -679,6 +680,10 @@ static void item_repos(lv_obj_t * item, _lv_grid_calc_t * c, item_repos_hint_t *
         lv_obj_invalidate(item);
         lv_obj_move_children_by(item, diff_x, diff_y, false);
     }
+
+#if LV_INDEV_HIT_INDEX_CELL_SIZE
+    _lv_indev_hit_index_update(item);
+#endif
 }
 
 /**
@@ -12,26 +12,131 @@
 #include "lv_png.h"
 #include "lodepng.h"
 #include <stdlib.h>
+#if defined(LV_IMG_CACHE_MEM_ALLOC) && defined(LV_IMG_CACHE_MEM_INCLUDE)
+    #include LV_IMG_CACHE_MEM_INCLUDE
+#endif
 
 /*********************
  *      DEFINES
  *********************/
+#define PNG_SIG_SIZE        8
+#define WINDOW_MAX          32768   /*The farthest back reference of deflate*/
+#define FAST_BITS           9       /*Huffman codes up to this length are decoded with one lookup*/
+#define IN_BUF_SIZE         256     /*Read buffer of the file sources*/
+
+/*A streamed image keeps its state while it's cached, so it goes to the image cache's memory if it has one*/
+#if defined(LV_IMG_CACHE_MEM_ALLOC) && defined(LV_IMG_CACHE_MEM_FREE)
+    #define STREAM_ALLOC(size)  LV_IMG_CACHE_MEM_ALLOC(size)
+    #define STREAM_FREE(p)      LV_IMG_CACHE_MEM_FREE(p)
+#else
+    #define STREAM_ALLOC(size)  lv_mem_alloc(size)
+    #define STREAM_FREE(p)      lv_mem_free(p)
+#endif
 
 /**********************
  *      TYPEDEFS
  **********************/
+typedef struct {
+    uint16_t fast[1 << FAST_BITS];  /*Code length << 12 | symbol of the codes up to FAST_BITS long, 0: longer code*/
+    uint16_t count[16];             /*Number of the codes of each length*/
+    uint16_t symbol[288];           /*Symbols in the order of their codes*/
+} huffman_t;
+
+typedef enum {
+    INFLATE_HEADER,                 /*A block header comes next*/
+    INFLATE_STORED,
+    INFLATE_HUFFMAN,
+    INFLATE_END,
+} inflate_mode_t;
+
+/**
+ * Decoder of a non-interlaced PNG which inflates and unfilters one row at a time.
+ * Only the last 32 KB of the inflated data (the deflate window) and two rows are kept,
+ * not the whole image.
+ */
+typedef struct {
+    /*Source*/
+    const uint8_t * mem;            /*The data of a C array, NULL for files*/
+    uint32_t mem_size;
+    lv_fs_file_t file;
+    const uint8_t * in_ptr;         /*Next byte to read*/
+    const uint8_t * in_end;
+    uint32_t in_pos;                /*Offset of `in_end` in the source*/
+    uint32_t idat_start;            /*Offset of the data of the first IDAT chunk*/
+    uint32_t idat_start_len;
+    uint32_t idat_left;             /*Bytes left in the current IDAT chunk*/
+    uint8_t idat_end : 1;           /*A chunk other than IDAT was found*/
+
+    /*Header*/
+    uint32_t w;
+    uint32_t h;
+    uint8_t depth;
+    uint8_t color_type;
+    uint8_t filter_bpp;             /*Bytes per complete pixel, at least 1*/
+    uint8_t has_key : 1;            /*tRNS of a gray or RGB image*/
+    uint16_t key[3];                /*Transparent gray or RGB*/
+    uint32_t row_bytes;             /*Without the filter type byte*/
+
+    /*Inflate*/
+    uint32_t bitbuf;
+    uint8_t bitcnt;
+    uint8_t pad;                    /*Zero bytes added to `bitbuf` after the end of the data*/
+    uint8_t final_block : 1;
+    inflate_mode_t mode;
+    uint32_t stored_left;
+    uint16_t copy_len;              /*Rest of a back reference*/
+    uint16_t copy_dist;
+    huffman_t lit;
+    huffman_t dist;
+    uint8_t * window;
+    uint32_t window_size;
+    uint32_t window_pos;
+    uint32_t total;                 /*Number of the inflated bytes*/
+
+    /*Rows*/
+    uint8_t * row;                  /*The filter type and the unfiltered bytes of the last row*/
+    uint8_t * prev_row;
+    uint8_t * out;                  /*Where the inflated bytes go*/
+    uint32_t y;                     /*Number of the decoded rows*/
+    uint32_t restart_cnt;
+    uint8_t palette[256 * LV_IMG_PX_SIZE_ALPHA_BYTE];   /*Converted to the output format*/
+} png_stream_t;
 
 /**********************
  *  STATIC PROTOTYPES
  **********************/
 static lv_res_t decoder_info(struct _lv_img_decoder_t * decoder, const void * src, lv_img_header_t * header);
 static lv_res_t decoder_open(lv_img_decoder_t * dec, lv_img_decoder_dsc_t * dsc);
+static lv_res_t decoder_read_line(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y,
+                                  lv_coord_t len, uint8_t * buf);
 static void decoder_close(lv_img_decoder_t * dec, lv_img_decoder_dsc_t * dsc);
+static lv_res_t decode_lodepng(lv_img_decoder_dsc_t * dsc);
 static void convert_color_depth(uint8_t * img, uint32_t px_cnt);
 
+static png_stream_t * stream_open(lv_img_decoder_dsc_t * dsc, bool * interlaced);
+static void stream_close(png_stream_t * s);
+static bool stream_rewind(png_stream_t * s);
+static bool stream_next_row(png_stream_t * s);
+static void stream_convert_row(png_stream_t * s, uint32_t x, uint32_t len, uint8_t * out);
+
 /**********************
  *  STATIC VARIABLES
  **********************/
+static uint32_t stream_min_size = LV_PNG_STREAM_MIN_SIZE;
+
+static const uint16_t len_base[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+static const uint8_t len_extra[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+static const uint16_t dist_base[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097,
+    6145, 8193, 12289, 16385, 24577
+};
+static const uint8_t dist_extra[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
 
 /**********************
  *      MACROS
@@ -49,9 +154,15 @@ void lv_png_init(void)
     lv_img_decoder_t * dec = lv_img_decoder_create();
     lv_img_decoder_set_info_cb(dec, decoder_info);
     lv_img_decoder_set_open_cb(dec, decoder_open);
+    lv_img_decoder_set_read_line_cb(dec, decoder_read_line);
     lv_img_decoder_set_close_cb(dec, decoder_close);
 }
 
+void lv_png_set_stream_min_size(uint32_t size)
+{
+    stream_min_size = size;
+}
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
@@ -137,79 +248,86 @@ static lv_res_t decoder_info(struct _lv_img_decoder_t * decoder, const void * sr
 }
 
 /**
- * Open a PNG image and return the decided image
- * @param src can be file name or pointer to a C array
- * @param style style of the image object (unused now but certain formats might use it)
- * @return pointer to the decoded image or `LV_IMG_DECODER_OPEN_FAIL` if failed
+ * Open a PNG image. Images not smaller than `stream_min_size` are decoded line by line in `decoder_read_line`,
+ * the others are decoded here into the color format of the display in one pass.
+ * Interlaced images are decoded by lodepng.
+ * @param decoder pointer to the decoder
+ * @param dsc pointer to the decoder descriptor
+ * @return LV_RES_OK: no error; LV_RES_INV: can't open the image
  */
 static lv_res_t decoder_open(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc)
 {
-
     (void) decoder; /*Unused*/
-    uint32_t error;                 /*For the return values of PNG decoder functions*/
 
-    uint8_t * img_data = NULL;
+    bool interlaced = false;
+    png_stream_t * s = stream_open(dsc, &interlaced);
+    if(s == NULL) {
+        return interlaced ? decode_lodepng(dsc) : LV_RES_INV;
+    }
 
-    /*If it's a PNG file...*/
-    if(dsc->src_type == LV_IMG_SRC_FILE) {
-        const char * fn = dsc->src;
-        if(strcmp(lv_fs_get_ext(fn), "png") == 0) {              /*Check the extension*/
+    uint32_t px_size = LV_IMG_PX_SIZE_ALPHA_BYTE;
+    uint32_t img_size = s->w * s->h * px_size;
+    if(stream_min_size && img_size >= stream_min_size) {
+        dsc->user_data = s;
+        dsc->state_size = sizeof(png_stream_t) + (s->mem == NULL ? IN_BUF_SIZE : 0) + s->window_size +
+                          2 * (s->row_bytes + 1);
+        return LV_RES_OK;
+    }
 
-            /*Load the PNG file into buffer. It's still compressed (not decoded)*/
-            unsigned char * png_data;      /*Pointer to the loaded data. Same as the original file just loaded into the RAM*/
-            size_t png_data_size;          /*Size of `png_data` in bytes*/
+    uint8_t * img_data = lv_mem_alloc(img_size);
+    if(img_data == NULL) {
+        LV_LOG_WARN("out of memory");
+        stream_close(s);
+        return LV_RES_INV;
+    }
 
-            error = lodepng_load_file(&png_data, &png_data_size, fn);   /*Load the file*/
-            if(error) {
-                LV_LOG_WARN("error %" LV_PRIu32 ": %s\n", error, lodepng_error_text(error));
-                return LV_RES_INV;
-            }
+    uint32_t y;
+    for(y = 0; y < s->h; y++) {
+        if(!stream_next_row(s)) {
+            LV_LOG_WARN("corrupted PNG data");
+            lv_mem_free(img_data);
+            stream_close(s);
+            return LV_RES_INV;
+        }
+        stream_convert_row(s, 0, s->w, img_data + y * s->w * px_size);
+    }
+    stream_close(s);
 
-            /*Decode the PNG image*/
-            unsigned png_width;             /*Will be the width of the decoded image*/
-            unsigned png_height;            /*Will be the width of the decoded image*/
+    dsc->img_data = img_data;
+    return LV_RES_OK;     /*The image is fully decoded. Return with its pointer*/
+}
 
-            /*Decode the loaded image in ARGB8888 */
-            error = lodepng_decode32(&img_data, &png_width, &png_height, png_data, png_data_size);
-            lv_mem_free(png_data); /*Free the loaded file*/
-            if(error) {
-                if(img_data != NULL) {
-                    lv_mem_free(img_data);
-                }
-                LV_LOG_WARN("error %" LV_PRIu32 ": %s\n", error, lodepng_error_text(error));
-                return LV_RES_INV;
-            }
+/**
+ * Decode a line of a streamed image. Reading an earlier line than the last one restarts the decoding.
+ * @param decoder pointer to the decoder
+ * @param dsc pointer to the decoder descriptor
+ * @param x start x coordinate
+ * @param y start y coordinate
+ * @param len number of pixels to decode
+ * @param buf a buffer to store the decoded pixels
+ * @return LV_RES_OK: ok; LV_RES_INV: failed
+ */
+static lv_res_t decoder_read_line(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y,
+                                  lv_coord_t len, uint8_t * buf)
+{
+    LV_UNUSED(decoder);
+    png_stream_t * s = dsc->user_data;
+    if(s == NULL || x < 0 || y < 0 || len <= 0 || (uint32_t)(x + len) > s->w || (uint32_t)y >= s->h) return LV_RES_INV;
 
-            /*Convert the image to the system's color depth*/
-            convert_color_depth(img_data,  png_width * png_height);
-            dsc->img_data = img_data;
-            return LV_RES_OK;     /*The image is fully decoded. Return with its pointer*/
-        }
+    if((uint32_t)y + 1 < s->y) {
+        if(!stream_rewind(s)) return LV_RES_INV;
+        s->restart_cnt++;
     }
-    /*If it's a PNG file in a  C array...*/
-    else if(dsc->src_type == LV_IMG_SRC_VARIABLE) {
-        const lv_img_dsc_t * img_dsc = dsc->src;
-        unsigned png_width;             /*No used, just required by he decoder*/
-        unsigned png_height;            /*No used, just required by he decoder*/
 
-        /*Decode the image in ARGB8888 */
-        error = lodepng_decode32(&img_data, &png_width, &png_height, img_dsc->data, img_dsc->data_size);
-
-        if(error) {
-            if(img_data != NULL) {
-                lv_mem_free(img_data);
-            }
+    while(s->y <= (uint32_t)y) {
+        if(!stream_next_row(s)) {
+            LV_LOG_WARN("corrupted PNG data");
             return LV_RES_INV;
         }
-
-        /*Convert the image to the system's color depth*/
-        convert_color_depth(img_data,  png_width * png_height);
-
-        dsc->img_data = img_data;
-        return LV_RES_OK;     /*Return with its pointer*/
     }
 
-    return LV_RES_INV;    /*If not returned earlier then it failed*/
+    stream_convert_row(s, x, len, buf);
+    return LV_RES_OK;
 }
 
 /**
@@ -218,12 +336,68 @@ static lv_res_t decoder_open(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t *
 static void decoder_close(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc)
 {
     LV_UNUSED(decoder); /*Unused*/
+    if(dsc->user_data) {
+        png_stream_t * s = dsc->user_data;
+        LV_LOG_TRACE("%d restarts", (int)s->restart_cnt);
+        stream_close(s);
+        dsc->user_data = NULL;
+    }
     if(dsc->img_data) {
         lv_mem_free((uint8_t *)dsc->img_data);
         dsc->img_data = NULL;
     }
 }
 
+/**
+ * Decode the whole image with lodepng into ARGB8888 and convert it to the color format of the display
+ * @param dsc pointer to the decoder descriptor
+ * @return LV_RES_OK: no error; LV_RES_INV: can't decode the image
+ */
+static lv_res_t decode_lodepng(lv_img_decoder_dsc_t * dsc)
+{
+    uint32_t error;                 /*For the return values of PNG decoder functions*/
+    uint8_t * img_data = NULL;
+    unsigned png_width;             /*Will be the width of the decoded image*/
+    unsigned png_height;            /*Will be the width of the decoded image*/
+
+    /*If it's a PNG file...*/
+    if(dsc->src_type == LV_IMG_SRC_FILE) {
+        /*Load the PNG file into buffer. It's still compressed (not decoded)*/
+        unsigned char * png_data;      /*Pointer to the loaded data. Same as the original file just loaded into the RAM*/
+        size_t png_data_size;          /*Size of `png_data` in bytes*/
+
+        error = lodepng_load_file(&png_data, &png_data_size, dsc->src);   /*Load the file*/
+        if(error) {
+            LV_LOG_WARN("error %" LV_PRIu32 ": %s\n", error, lodepng_error_text(error));
+            return LV_RES_INV;
+        }
+
+        /*Decode the loaded image in ARGB8888 */
+        error = lodepng_decode32(&img_data, &png_width, &png_height, png_data, png_data_size);
+        lv_mem_free(png_data); /*Free the loaded file*/
+    }
+    /*If it's a PNG file in a  C array...*/
+    else {
+        const lv_img_dsc_t * img_dsc = dsc->src;
+
+        /*Decode the image in ARGB8888 */
+        error = lodepng_decode32(&img_data, &png_width, &png_height, img_dsc->data, img_dsc->data_size);
+    }
+
+    if(error) {
+        if(img_data != NULL) {
+            lv_mem_free(img_data);
+        }
+        LV_LOG_WARN("error %" LV_PRIu32 ": %s\n", error, lodepng_error_text(error));
+        return LV_RES_INV;
+    }
+
+    /*Convert the image to the system's color depth*/
+    convert_color_depth(img_data,  png_width * png_height);
+    dsc->img_data = img_data;
+    return LV_RES_OK;     /*The image is fully decoded. Return with its pointer*/
+}
+
 /**
  * If the display is not in 32 bit format (ARGB888) then covert the image to the current color depth
  * @param img the ARGB888 image
@@ -272,4 +446,710 @@ static void convert_color_depth(uint8_t * img, uint32_t px_cnt)
 #endif
 }
 
+/*-----------------
+ * Source reading
+ *----------------*/
+
+static inline uint32_t read_be32(const uint8_t * p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static bool src_fill(png_stream_t * s)
+{
+    if(s->mem) return false;     /*All of it is in the buffer*/
+
+    uint32_t rn = 0;
+    uint8_t * buf = (uint8_t *)(s + 1);
+    if(lv_fs_read(&s->file, buf, IN_BUF_SIZE, &rn) != LV_FS_RES_OK || rn == 0) return false;
+    s->in_ptr = buf;
+    s->in_end = buf + rn;
+    s->in_pos += rn;
+    return true;
+}
+
+static inline int src_getc(png_stream_t * s)
+{
+    if(s->in_ptr == s->in_end && !src_fill(s)) return -1;
+    return *s->in_ptr++;
+}
+
+static uint32_t src_read(png_stream_t * s, uint8_t * buf, uint32_t len)
+{
+    uint32_t i;
+    for(i = 0; i < len; i++) {
+        int c = src_getc(s);
+        if(c < 0) break;
+        buf[i] = (uint8_t)c;
+    }
+    return i;
+}
+
+static bool src_seek(png_stream_t * s, uint32_t pos)
+{
+    if(s->mem) {
+        if(pos > s->mem_size) return false;
+        s->in_ptr = s->mem + pos;
+        return true;
+    }
+
+    if(lv_fs_seek(&s->file, pos, LV_FS_SEEK_SET) != LV_FS_RES_OK) return false;
+    s->in_ptr = s->in_end;
+    s->in_pos = pos;
+    return true;
+}
+
+static bool src_skip(png_stream_t * s, uint32_t len)
+{
+    if(len <= (uint32_t)(s->in_end - s->in_ptr)) {
+        s->in_ptr += len;
+        return true;
+    }
+    return src_seek(s, s->in_pos - (uint32_t)(s->in_end - s->in_ptr) + len);
+}
+
+/**
+ * Read the next byte of the zlib stream, which continues in the following IDAT chunks
+ */
+static inline int idat_getc(png_stream_t * s)
+{
+    while(s->idat_left == 0) {
+        if(s->idat_end) return -1;
+
+        /*The CRC of the previous chunk and the header of the next one*/
+        uint8_t buf[12];
+        if(src_read(s, buf, 12) != 12 || memcmp(buf + 8, "IDAT", 4) != 0) {
+            s->idat_end = 1;
+            return -1;
+        }
+        s->idat_left = read_be32(buf + 4);
+    }
+
+    s->idat_left--;
+    return src_getc(s);
+}
+
+/*-----------------
+ * Inflate
+ *----------------*/
+
+/**
+ * Make sure that at least 25 bits are in the bit buffer. After the end of the data zeros are added,
+ * reading them is detected by `inflate_overrun()`.
+ */
+static inline void bits_refill(png_stream_t * s)
+{
+    while(s->bitcnt <= 24) {
+        int c = idat_getc(s);
+        if(c < 0) {
+            c = 0;
+            if(s->pad < 8) s->pad++;
+        }
+        s->bitbuf |= (uint32_t)c << s->bitcnt;
+        s->bitcnt += 8;
+    }
+}
+
+static inline uint32_t bits_get(png_stream_t * s, uint8_t n)
+{
+    if(n == 0) return 0;
+    if(s->bitcnt < n) bits_refill(s);
+    uint32_t v = s->bitbuf & ((1UL << n) - 1);
+    s->bitbuf >>= n;
+    s->bitcnt -= n;
+    return v;
+}
+
+static bool inflate_overrun(png_stream_t * s)
+{
+    return s->pad * 8 > s->bitcnt;
+}
+
+/**
+ * Build the decoding tables of a canonical Huffman code
+ * @param h     store the tables here
+ * @param lens  code length of each symbol, 0: unused
+ * @param n     number of symbols
+ * @return      false if the code is over-subscribed
+ */
+static bool huffman_build(huffman_t * h, const uint8_t * lens, uint32_t n)
+{
+    uint16_t offs[16];
+    uint32_t next_code[16];
+    uint32_t i;
+
+    lv_memset_00(h->count, sizeof(h->count));
+    for(i = 0; i < n; i++) h->count[lens[i]]++;
+    h->count[0] = 0;
+
+    int32_t left = 1;
+    for(i = 1; i < 16; i++) {
+        left <<= 1;
+        left -= h->count[i];
+        if(left < 0) return false;
+    }
+
+    offs[1] = 0;
+    for(i = 1; i < 15; i++) offs[i + 1] = offs[i] + h->count[i];
+
+    uint32_t code = 0;
+    for(i = 1; i < 16; i++) {
+        code = (code + h->count[i - 1]) << 1;
+        next_code[i] = code;
+    }
+
+    lv_memset_00(h->fast, sizeof(h->fast));
+    for(i = 0; i < n; i++) {
+        uint8_t len = lens[i];
+        if(len == 0) continue;
+
+        h->symbol[offs[len]++] = (uint16_t)i;
+        uint32_t c = next_code[len]++;
+        if(len > FAST_BITS) continue;
+
+        /*The codes are stored from the most significant bit but read from the least significant one*/
+        uint32_t rev = 0;
+        uint32_t b;
+        for(b = 0; b < len; b++) rev |= ((c >> b) & 1) << (len - 1 - b);
+        for(; rev < (1 << FAST_BITS); rev += 1 << len) h->fast[rev] = (uint16_t)((len << 12) | i);
+    }
+
+    return true;
+}
+
+/**
+ * Decode a symbol
+ * @return the symbol or -1 for an invalid code
+ */
+static inline int huffman_decode(png_stream_t * s, const huffman_t * h)
+{
+    if(s->bitcnt < 16) bits_refill(s);
+
+    uint16_t e = h->fast[s->bitbuf & ((1 << FAST_BITS) - 1)];
+    if(e) {
+        s->bitbuf >>= e >> 12;
+        s->bitcnt -= e >> 12;
+        return e & 0x1FF;
+    }
+
+    /*Longer code, decode it bit by bit*/
+    int32_t code = 0;
+    int32_t first = 0;
+    int32_t index = 0;
+    uint32_t len;
+    for(len = 1; len < 16; len++) {
+        code |= bits_get(s, 1);
+        int32_t count = h->count[len];
+        if(code - count < first) return h->symbol[index + (code - first)];
+        index += count;
+        first += count;
+        first <<= 1;
+        code <<= 1;
+    }
+
+    return -1;
+}
+
+static bool inflate_block_header(png_stream_t * s)
+{
+    s->final_block = bits_get(s, 1);
+    uint32_t type = bits_get(s, 2);
+
+    if(type == 0) {
+        /*Stored block: skip to the byte boundary, the length and its complement follow*/
+        bits_get(s, s->bitcnt & 7);
+        uint32_t len = bits_get(s, 16);
+        uint32_t nlen = bits_get(s, 16);
+        if((len ^ 0xFFFF) != nlen) return false;
+        s->stored_left = len;
+        s->mode = INFLATE_STORED;
+        return !inflate_overrun(s);
+    }
+
+    uint8_t lens[288 + 32];
+    if(type == 1) {
+        /*Fixed Huffman codes*/
+        uint32_t i;
+        for(i = 0; i < 144; i++) lens[i] = 8;
+        for(; i < 256; i++) lens[i] = 9;
+        for(; i < 280; i++) lens[i] = 7;
+        for(; i < 288; i++) lens[i] = 8;
+        for(i = 0; i < 32; i++) lens[288 + i] = 5;
+        huffman_build(&s->lit, lens, 288);
+        huffman_build(&s->dist, lens + 288, 32);
+        s->mode = INFLATE_HUFFMAN;
+        return true;
+    }
+
+    if(type != 2) return false;
+
+    /*Dynamic Huffman codes. First the code of the code lengths, built temporarily into the distance code.*/
+    static const uint8_t cl_order[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+    uint32_t hlit = bits_get(s, 5) + 257;
+    uint32_t hdist = bits_get(s, 5) + 1;
+    uint32_t hclen = bits_get(s, 4) + 4;
+    if(hlit > 286 || hdist > 30) return false;
+
+    uint8_t cl_lens[19];
+    lv_memset_00(cl_lens, sizeof(cl_lens));
+    uint32_t i;
+    for(i = 0; i < hclen; i++) cl_lens[cl_order[i]] = (uint8_t)bits_get(s, 3);
+    if(!huffman_build(&s->dist, cl_lens, 19)) return false;
+
+    i = 0;
+    while(i < hlit + hdist) {
+        int sym = huffman_decode(s, &s->dist);
+        if(sym < 0) return false;
+        if(sym < 16) {
+            lens[i++] = (uint8_t)sym;
+            continue;
+        }
+
+        uint8_t val = 0;
+        uint32_t rep;
+        if(sym == 16) {
+            if(i == 0) return false;
+            val = lens[i - 1];
+            rep = 3 + bits_get(s, 2);
+        }
+        else if(sym == 17) {
+            rep = 3 + bits_get(s, 3);
+        }
+        else {
+            rep = 11 + bits_get(s, 7);
+        }
+        if(i + rep > hlit + hdist) return false;
+        while(rep--) lens[i++] = val;
+    }
+
+    if(lens[256] == 0) return false;     /*No end of block code*/
+    if(!huffman_build(&s->lit, lens, hlit)) return false;
+    if(!huffman_build(&s->dist, lens + hlit, hdist)) return false;
+    s->mode = INFLATE_HUFFMAN;
+    return !inflate_overrun(s);
+}
+
+static inline void window_put(png_stream_t * s, uint8_t v)
+{
+    s->window[s->window_pos] = v;
+    if(++s->window_pos == s->window_size) s->window_pos = 0;
+    *s->out++ = v;
+}
+
+/**
+ * Inflate the next bytes into `s->out` and the window
+ * @param s     the stream
+ * @param n     number of bytes to inflate
+ * @return      false if the data is corrupted or ended too early
+ */
+static bool inflate_next(png_stream_t * s, uint32_t n)
+{
+    s->total += n;
+
+    while(n) {
+        /*Continue a back reference*/
+        if(s->copy_len) {
+            uint32_t src = s->window_pos >= s->copy_dist ? s->window_pos - s->copy_dist :
+                           s->window_pos + s->window_size - s->copy_dist;
+            uint32_t cnt = LV_MIN(s->copy_len, n);
+            s->copy_len -= cnt;
+            n -= cnt;
+            while(cnt--) {
+                uint8_t v = s->window[src];
+                if(++src == s->window_size) src = 0;
+                window_put(s, v);
+            }
+            continue;
+        }
+
+        switch(s->mode) {
+            case INFLATE_HEADER:
+                if(!inflate_block_header(s)) return false;
+                break;
+            case INFLATE_STORED:
+                if(s->stored_left == 0) {
+                    s->mode = s->final_block ? INFLATE_END : INFLATE_HEADER;
+                    break;
+                }
+                window_put(s, (uint8_t)bits_get(s, 8));
+                s->stored_left--;
+                n--;
+                break;
+            case INFLATE_HUFFMAN: {
+                    int sym = huffman_decode(s, &s->lit);
+                    if(sym < 256) {
+                        if(sym < 0) return false;
+                        window_put(s, (uint8_t)sym);
+                        n--;
+                        break;
+                    }
+                    if(sym == 256) {
+                        s->mode = s->final_block ? INFLATE_END : INFLATE_HEADER;
+                        break;
+                    }
+
+                    sym -= 257;
+                    if(sym >= 29) return false;
+                    uint32_t len = len_base[sym] + bits_get(s, len_extra[sym]);
+                    int dsym = huffman_decode(s, &s->dist);
+                    if(dsym < 0 || dsym >= 30) return false;
+                    uint32_t dist = dist_base[dsym] + bits_get(s, dist_extra[dsym]);
+
+                    /*`total` already counts the rest of this call*/
+                    if(dist > s->total - n || dist > s->window_size) return false;
+                    s->copy_len = (uint16_t)len;
+                    s->copy_dist = (uint16_t)dist;
+                    break;
+                }
+            case INFLATE_END:
+            default:
+                return false;
+        }
+    }
+
+    return !inflate_overrun(s);
+}
+
+/*-----------------
+ * Rows
+ *----------------*/
+
+static inline uint8_t paeth(uint8_t a, uint8_t b, uint8_t c)
+{
+    int16_t p = (int16_t)a + b - c;
+    int16_t pa = LV_ABS(p - a);
+    int16_t pb = LV_ABS(p - b);
+    int16_t pc = LV_ABS(p - c);
+    if(pa <= pb && pa <= pc) return a;
+    if(pb <= pc) return b;
+    return c;
+}
+
+static bool unfilter(uint8_t * row, const uint8_t * prev, uint32_t len, uint32_t bpp, uint8_t type)
+{
+    uint32_t i;
+    switch(type) {
+        case 0:
+            break;
+        case 1:
+            for(i = bpp; i < len; i++) row[i] += row[i - bpp];
+            break;
+        case 2:
+            for(i = 0; i < len; i++) row[i] += prev[i];
+            break;
+        case 3:
+            for(i = 0; i < bpp; i++) row[i] += prev[i] >> 1;
+            for(; i < len; i++) row[i] += (uint8_t)(((uint32_t)row[i - bpp] + prev[i]) >> 1);
+            break;
+        case 4:
+            for(i = 0; i < bpp; i++) row[i] += prev[i];
+            for(; i < len; i++) row[i] += paeth(row[i - bpp], prev[i], prev[i - bpp]);
+            break;
+        default:
+            return false;
+    }
+    return true;
+}
+
+static bool stream_next_row(png_stream_t * s)
+{
+    if(s->y >= s->h) return false;
+
+    uint8_t * tmp = s->prev_row;
+    s->prev_row = s->row;
+    s->row = tmp;
+
+    s->out = s->row;
+    if(!inflate_next(s, s->row_bytes + 1)) return false;
+    if(!unfilter(s->row + 1, s->prev_row + 1, s->row_bytes, s->filter_bpp, s->row[0])) return false;
+
+    s->y++;
+    return true;
+}
+
+static bool stream_rewind(png_stream_t * s)
+{
+    if(!src_seek(s, s->idat_start)) return false;
+    s->idat_left = s->idat_start_len;
+    s->idat_end = 0;
+
+    s->bitbuf = 0;
+    s->bitcnt = 0;
+    s->pad = 0;
+    s->final_block = 0;
+    s->mode = INFLATE_HEADER;
+    s->copy_len = 0;
+    s->window_pos = 0;
+    s->total = 0;
+    s->y = 0;
+    lv_memset_00(s->row, s->row_bytes + 1);     /*The row above the first one is zero for the filters*/
+
+    /*zlib header, no preset dictionary*/
+    uint32_t cmf = bits_get(s, 8);
+    uint32_t flg = bits_get(s, 8);
+    return (cmf & 0x0F) == 8 && ((cmf << 8) | flg) % 31 == 0 && (flg & 0x20) == 0 && !inflate_overrun(s);
+}
+
+static inline uint8_t * put_px(uint8_t * out, uint8_t r, uint8_t g, uint8_t b, uint8_t a)
+{
+#if LV_COLOR_DEPTH == 32
+    out[0] = b;
+    out[1] = g;
+    out[2] = r;
+    out[3] = a;
+    return out + 4;
+#elif LV_COLOR_DEPTH == 16
+    lv_color_t c = lv_color_make(r, g, b);
+    out[0] = c.full & 0xFF;
+    out[1] = c.full >> 8;
+    out[2] = a;
+    return out + 3;
+#elif LV_COLOR_DEPTH == 8
+    lv_color_t c = lv_color_make(r, g, b);
+    out[0] = c.full;
+    out[1] = a;
+    return out + 2;
+#elif LV_COLOR_DEPTH == 1
+    out[0] = (r | g | b) > 128 ? 1 : 0;
+    out[1] = a;
+    return out + 2;
+#endif
+}
+
+static inline uint32_t get_sample(const uint8_t * row, uint32_t i, uint8_t depth)
+{
+    switch(depth) {
+        case 16:
+            return ((uint32_t)row[i * 2] << 8) | row[i * 2 + 1];
+        case 8:
+            return row[i];
+        default: {
+                uint32_t bit = i * depth;
+                return (row[bit >> 3] >> (8 - depth - (bit & 7))) & ((1 << depth) - 1);
+            }
+    }
+}
+
+/**
+ * Convert a part of the last decoded row to the color format of the display
+ */
+static void stream_convert_row(png_stream_t * s, uint32_t x, uint32_t len, uint8_t * out)
+{
+    const uint8_t * row = s->row + 1;
+    uint32_t i;
+    uint32_t end = x + len;
+
+    switch(s->color_type) {
+        case 6:     /*RGBA*/
+            if(s->depth == 8) {
+                const uint8_t * p = row + x * 4;
+                for(i = x; i < end; i++) {
+                    out = put_px(out, p[0], p[1], p[2], p[3]);
+                    p += 4;
+                }
+            }
+            else {
+                const uint8_t * p = row + x * 8;
+                for(i = x; i < end; i++) {
+                    out = put_px(out, p[0], p[2], p[4], p[6]);
+                    p += 8;
+                }
+            }
+            break;
+        case 2:     /*RGB*/
+            if(s->depth == 8 && !s->has_key) {
+                const uint8_t * p = row + x * 3;
+                for(i = x; i < end; i++) {
+                    out = put_px(out, p[0], p[1], p[2], 0xFF);
+                    p += 3;
+                }
+            }
+            else {
+                for(i = x; i < end; i++) {
+                    uint32_t r = get_sample(row, i * 3, s->depth);
+                    uint32_t g = get_sample(row, i * 3 + 1, s->depth);
+                    uint32_t b = get_sample(row, i * 3 + 2, s->depth);
+                    uint8_t a = (s->has_key && r == s->key[0] && g == s->key[1] && b == s->key[2]) ? 0 : 0xFF;
+                    if(s->depth == 16) out = put_px(out, r >> 8, g >> 8, b >> 8, a);
+                    else out = put_px(out, r, g, b, a);
+                }
+            }
+            break;
+        case 4:     /*Gray and alpha*/
+            for(i = x; i < end; i++) {
+                uint8_t v = s->depth == 8 ? row[i * 2] : row[i * 4];
+                uint8_t a = s->depth == 8 ? row[i * 2 + 1] : row[i * 4 + 2];
+                out = put_px(out, v, v, v, a);
+            }
+            break;
+        case 0: {   /*Gray*/
+                static const uint8_t scale[9] = {0, 255, 85, 0, 17, 0, 0, 0, 1};
+                for(i = x; i < end; i++) {
+                    uint32_t v = get_sample(row, i, s->depth);
+                    uint8_t a = (s->has_key && v == s->key[0]) ? 0 : 0xFF;
+                    uint8_t v8 = s->depth == 16 ? (uint8_t)(v >> 8) : (uint8_t)(v * scale[s->depth]);
+                    out = put_px(out, v8, v8, v8, a);
+                }
+                break;
+            }
+        case 3:     /*Indexed*/
+            for(i = x; i < end; i++) {
+                uint32_t idx = get_sample(row, i, s->depth);
+                lv_memcpy_small(out, &s->palette[idx * LV_IMG_PX_SIZE_ALPHA_BYTE], LV_IMG_PX_SIZE_ALPHA_BYTE);
+                out += LV_IMG_PX_SIZE_ALPHA_BYTE;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * Read the chunks up to the image data and prepare the decoding
+ * @param dsc           the decoder descriptor
+ * @param interlaced    set to true if it's a valid interlaced PNG which is not supported
+ * @return              the stream or NULL on error
+ */
+static png_stream_t * stream_open(lv_img_decoder_dsc_t * dsc, bool * interlaced)
+{
+    /*The read buffer of the files is after the struct*/
+    uint32_t alloc_size = sizeof(png_stream_t) + (dsc->src_type == LV_IMG_SRC_FILE ? IN_BUF_SIZE : 0);
+    png_stream_t * s = STREAM_ALLOC(alloc_size);
+    if(s == NULL) return NULL;
+    lv_memset_00(s, sizeof(png_stream_t));
+
+    if(dsc->src_type == LV_IMG_SRC_FILE) {
+        const char * fn = dsc->src;
+        if(strcmp(lv_fs_get_ext(fn), "png") != 0 || lv_fs_open(&s->file, fn, LV_FS_MODE_RD) != LV_FS_RES_OK) {
+            STREAM_FREE(s);
+            return NULL;
+        }
+        s->in_ptr = s->in_end = (uint8_t *)(s + 1);
+    }
+    else if(dsc->src_type == LV_IMG_SRC_VARIABLE) {
+        const lv_img_dsc_t * img_dsc = dsc->src;
+        s->mem = img_dsc->data;
+        s->mem_size = img_dsc->data_size;
+        s->in_ptr = s->mem;
+        s->in_end = s->mem + s->mem_size;
+        s->in_pos = s->mem_size;
+    }
+    else {
+        STREAM_FREE(s);
+        return NULL;
+    }
+
+    static const uint8_t magic[PNG_SIG_SIZE] = {0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a};
+    uint8_t buf[13];
+    if(src_read(s, buf, PNG_SIG_SIZE) != PNG_SIG_SIZE || memcmp(buf, magic, PNG_SIG_SIZE) != 0) goto fail;
+
+    /*Opaque black palette by default*/
+    uint32_t i;
+    for(i = 0; i < 256; i++) put_px(&s->palette[i * LV_IMG_PX_SIZE_ALPHA_BYTE], 0, 0, 0, 0xFF);
+    uint8_t pal_rgb[256 * 3];
+    uint32_t pal_cnt = 0;
+    bool has_ihdr = false;
+
+    while(1) {
+        uint8_t hdr[8];
+        if(src_read(s, hdr, 8) != 8) goto fail;
+        uint32_t len = read_be32(hdr);
+
+        if(memcmp(hdr + 4, "IHDR", 4) == 0) {
+            if(len != 13 || src_read(s, buf, 13) != 13) goto fail;
+            s->w = read_be32(buf);
+            s->h = read_be32(buf + 4);
+            s->depth = buf[8];
+            s->color_type = buf[9];
+            if(buf[10] != 0 || buf[11] != 0 || buf[12] > 1) goto fail;     /*Compression and filter method*/
+            if(s->w == 0 || s->h == 0 || s->w > LV_COORD_MAX || s->h > LV_COORD_MAX) goto fail;
+
+            static const uint8_t channels[7] = {1, 0, 3, 1, 2, 0, 4};
+            if(s->color_type > 6 || channels[s->color_type] == 0) goto fail;
+            if(s->depth != 1 && s->depth != 2 && s->depth != 4 && s->depth != 8 && s->depth != 16) goto fail;
+            if(s->color_type != 0 && s->color_type != 3 && s->depth < 8) goto fail;
+            if(s->color_type == 3 && s->depth == 16) goto fail;
+
+            if(buf[12]) {
+                *interlaced = true;
+                goto fail;
+            }
+
+            uint32_t bits = channels[s->color_type] * s->depth;
+            s->filter_bpp = (uint8_t)LV_MAX(bits / 8, 1);
+            s->row_bytes = (s->w * bits + 7) / 8;
+            has_ihdr = true;
+        }
+        else if(!has_ihdr) {
+            goto fail;
+        }
+        else if(memcmp(hdr + 4, "PLTE", 4) == 0) {
+            if(len % 3 || len > sizeof(pal_rgb) || src_read(s, pal_rgb, len) != len) goto fail;
+            pal_cnt = len / 3;
+            for(i = 0; i < pal_cnt; i++) {
+                put_px(&s->palette[i * LV_IMG_PX_SIZE_ALPHA_BYTE], pal_rgb[i * 3], pal_rgb[i * 3 + 1], pal_rgb[i * 3 + 2],
+                       0xFF);
+            }
+        }
+        else if(memcmp(hdr + 4, "tRNS", 4) == 0) {
+            if(s->color_type == 3) {
+                if(len > pal_cnt) goto fail;
+                for(i = 0; i < len; i++) {
+                    int a = src_getc(s);
+                    if(a < 0) goto fail;
+                    put_px(&s->palette[i * LV_IMG_PX_SIZE_ALPHA_BYTE], pal_rgb[i * 3], pal_rgb[i * 3 + 1],
+                           pal_rgb[i * 3 + 2], (uint8_t)a);
+                }
+            }
+            else if(s->color_type == 0 || s->color_type == 2) {
+                uint32_t n = s->color_type == 0 ? 1 : 3;
+                if(len != n * 2 || src_read(s, buf, len) != len) goto fail;
+                for(i = 0; i < n; i++) s->key[i] = (uint16_t)((buf[i * 2] << 8) | buf[i * 2 + 1]);
+                s->has_key = 1;
+            }
+            else if(!src_skip(s, len)) {
+                goto fail;
+            }
+        }
+        else if(memcmp(hdr + 4, "IDAT", 4) == 0) {
+            s->idat_start = s->in_pos - (uint32_t)(s->in_end - s->in_ptr);
+            s->idat_start_len = len;
+            break;
+        }
+        else if(memcmp(hdr + 4, "IEND", 4) == 0) {
+            goto fail;
+        }
+        else if(!src_skip(s, len)) {
+            goto fail;
+        }
+
+        if(!src_skip(s, 4)) goto fail;    /*CRC*/
+    }
+
+    /*The raw image is the filter type byte and the data of each row.
+     *The deflate window doesn't need to be larger than that.*/
+    uint64_t raw_size = (uint64_t)s->h * (s->row_bytes + 1);
+    s->window_size = (uint32_t)LV_MIN(raw_size, WINDOW_MAX);
+    s->window = STREAM_ALLOC(s->window_size);
+    s->row = STREAM_ALLOC(s->row_bytes + 1);
+    s->prev_row = STREAM_ALLOC(s->row_bytes + 1);
+    if(s->window == NULL || s->row == NULL || s->prev_row == NULL) goto fail;
+
+    if(!stream_rewind(s)) goto fail;
+    return s;
+
+fail:
+    stream_close(s);
+    return NULL;
+}
+
+static void stream_close(png_stream_t * s)
+{
+    if(s->mem == NULL) lv_fs_close(&s->file);
+    STREAM_FREE(s->window);
+    STREAM_FREE(s->row);
+    STREAM_FREE(s->prev_row);
+    STREAM_FREE(s);
+}
+
 #endif /*LV_USE_PNG*/
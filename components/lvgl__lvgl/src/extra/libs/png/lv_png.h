@@ -33,6 +33,13 @@ extern "C" {
  */
 void lv_png_init(void);
 
+/**
+ * Set the decoded size from which the PNGs are decoded row by row while drawing
+ * instead of into a full image buffer. The initial value is `LV_PNG_STREAM_MIN_SIZE`.
+ * @param size  size in bytes, 0: decode all images fully
+ */
+void lv_png_set_stream_min_size(uint32_t size);
+
 /**********************
  *      MACROS
  **********************/
@@ -211,7 +211,7 @@ static lv_font_t * lv_tiny_ttf_create(const char * path, const void * data, size
     }
 #endif
 
-    dsc->bitmap_cache = lv_lru_create(cache_size, font_size * font_size, lv_mem_free, lv_mem_free);
+    dsc->bitmap_cache = lv_lru_create(cache_size, font_size * font_size, lv_mem_free, NULL);
     if(dsc->bitmap_cache == NULL) {
         LV_LOG_ERROR("failed to create lru cache");
         goto err_after_dsc;
@@ -11,6 +11,7 @@
 #if LV_USE_COLORWHEEL
 
 #include "../../../misc/lv_assert.h"
+#include "../../../misc/lv_parallel.h"
 
 /*********************
  *      DEFINES
@@ -646,9 +647,9 @@ static lv_color_t angle_to_mode_color_fast(lv_obj_t * obj, uint16_t angle)
 {
     lv_colorwheel_t * ext = (lv_colorwheel_t *)obj;
     uint8_t r = 0, g = 0, b = 0;
-    static uint16_t h = 0;
-    static uint8_t s = 0, v = 0, m = 255;
-    static uint16_t angle_saved = 0xffff;
+    static LV_RENDER_TLS uint16_t h = 0;
+    static LV_RENDER_TLS uint8_t s = 0, v = 0, m = 255;
+    static LV_RENDER_TLS uint16_t angle_saved = 0xffff;
 
     /*If the angle is different recalculate scaling*/
     if(angle_saved != angle) m = 255;
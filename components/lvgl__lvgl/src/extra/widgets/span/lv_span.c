@@ -11,6 +11,7 @@
 #if LV_USE_SPAN != 0
 
 #include "../../../misc/lv_assert.h"
+#include "../../../misc/lv_parallel.h"
 
 /*********************
  *      DEFINES
@@ -590,7 +591,10 @@ static void draw_main(lv_event_t * e)
     lv_obj_t * obj = lv_event_get_target(e);
     lv_draw_ctx_t * draw_ctx = lv_event_get_draw_ctx(e);
 
+    /*The snippet stack is shared by the render threads*/
+    _lv_parallel_lock();
     lv_draw_span(obj, draw_ctx);
+    _lv_parallel_unlock();
 }
 
 /**
@@ -14,10 +14,17 @@
 #include "../misc/lv_log.h"
 #include "../misc/lv_utils.h"
 #include "../misc/lv_mem.h"
+#include "../misc/lv_parallel.h"
+#include "../misc/lv_lru.h"
 
 /*********************
  *      DEFINES
  *********************/
+/*Bytes counted for a cached glyph besides its bitmap: the LRU item, the key and the allocation headers, roughly*/
+#define BITMAP_CACHE_ITEM_OVERHEAD  48
+
+/*Expected size of a cached glyph to size the hash table*/
+#define BITMAP_CACHE_AVG_ITEM_SIZE  (64 + BITMAP_CACHE_ITEM_OVERHEAD)
 
 /**********************
  *      TYPEDEFS
@@ -28,6 +35,21 @@ typedef enum {
     RLE_STATE_COUNTER,
 } rle_state_t;
 
+/*State of decompressing a glyph, every caller has its own so it's reentrant*/
+typedef struct {
+    const uint8_t * in;
+    uint32_t rdp;
+    uint8_t bpp;
+    uint8_t prev_v;
+    uint8_t cnt;
+    rle_state_t state;
+} rle_t;
+
+typedef struct {
+    const lv_font_t * font;
+    uint32_t letter;
+} bitmap_cache_key_t;
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
@@ -38,24 +60,22 @@ static int32_t kern_pair_8_compare(const void * ref, const void * element);
 static int32_t kern_pair_16_compare(const void * ref, const void * element);
 
 #if LV_USE_FONT_COMPRESSED
+    static const uint8_t * bitmap_cache_get(const lv_font_t * font, uint32_t letter);
+    static const uint8_t * bitmap_cache_add(const lv_font_t * font, uint32_t letter, const uint8_t * in,
+                                            const lv_font_fmt_txt_glyph_dsc_t * gdsc, uint32_t buf_size);
     static void decompress(const uint8_t * in, uint8_t * out, lv_coord_t w, lv_coord_t h, uint8_t bpp, bool prefilter);
-    static inline void decompress_line(uint8_t * out, lv_coord_t w);
+    static inline void decompress_line(rle_t * rle, uint8_t * out, lv_coord_t w);
     static inline uint8_t get_bits(const uint8_t * in, uint32_t bit_pos, uint8_t len);
     static inline void bits_write(uint8_t * out, uint32_t bit_pos, uint8_t val, uint8_t len);
-    static inline void rle_init(const uint8_t * in,  uint8_t bpp);
-    static inline uint8_t rle_next(void);
+    static inline void rle_init(rle_t * rle, const uint8_t * in,  uint8_t bpp);
+    static inline uint8_t rle_next(rle_t * rle);
 #endif /*LV_USE_FONT_COMPRESSED*/
 
 /**********************
  *  STATIC VARIABLES
  **********************/
 #if LV_USE_FONT_COMPRESSED
-    static uint32_t rle_rdp;
-    static const uint8_t * rle_in;
-    static uint8_t rle_bpp;
-    static uint8_t rle_prev_v;
-    static uint8_t rle_cnt;
-    static rle_state_t rle_state;
+    static uint32_t bitmap_cache_size = LV_FONT_COMPRESSED_CACHE_SIZE;
 #endif /*LV_USE_FONT_COMPRESSED*/
 
 /**********************
@@ -92,7 +112,11 @@ const uint8_t * lv_font_get_bitmap_fmt_txt(const lv_font_t * font, uint32_t unic
     /*Handle compressed bitmap*/
     else {
 #if LV_USE_FONT_COMPRESSED
-        static size_t last_buf_size = 0;
+        /*Most glyphs are drawn again and again so they are decompressed only once*/
+        const uint8_t * cached = bitmap_cache_get(font, unicode_letter);
+        if(cached) return cached;
+
+        static LV_RENDER_TLS size_t last_buf_size = 0;
         if(LV_GC_ROOT(_lv_font_decompr_buf) == NULL) last_buf_size = 0;
 
         uint32_t gsize = gdsc->box_w * gdsc->box_h;
@@ -115,6 +139,10 @@ const uint8_t * lv_font_get_bitmap_fmt_txt(const lv_font_t * font, uint32_t unic
                 break;
         }
 
+        cached = bitmap_cache_add(font, unicode_letter, &fdsc->glyph_bitmap[gdsc->bitmap_index], gdsc, buf_size);
+        if(cached) return cached;
+
+        /*Not cached, decompress to the temporary buffer*/
         if(last_buf_size < buf_size) {
             uint8_t * tmp = lv_mem_realloc(LV_GC_ROOT(_lv_font_decompr_buf), buf_size);
             LV_ASSERT_MALLOC(tmp);
@@ -189,6 +217,38 @@ bool lv_font_get_glyph_dsc_fmt_txt(const lv_font_t * font, lv_font_glyph_dsc_t *
     return true;
 }
 
+/**
+ * Set the number of bytes the decompressed glyphs of compressed fonts can use.
+ * The glyphs are cached by font and letter, the least recently used ones are freed to stay in the limit.
+ * The cache is emptied too.
+ * @param size the byte budget of the cache. 0: disable caching and decompress the glyphs on every draw
+ */
+void lv_font_fmt_txt_set_bitmap_cache_size(uint32_t size)
+{
+#if LV_USE_FONT_COMPRESSED
+    bitmap_cache_size = size;
+    lv_font_fmt_txt_bitmap_cache_clear();
+#else
+    LV_UNUSED(size);
+#endif
+}
+
+/**
+ * Free the decompressed glyphs of compressed fonts.
+ * Required before freeing a compressed font as the glyphs are identified by the font's address.
+ */
+void lv_font_fmt_txt_bitmap_cache_clear(void)
+{
+#if LV_USE_FONT_COMPRESSED
+    LV_ASSERT_MSG(!_lv_parallel_is_active(), "Can't clear the glyph cache while rendering");
+
+    if(LV_GC_ROOT(_lv_font_bitmap_cache)) {
+        lv_lru_del(LV_GC_ROOT(_lv_font_bitmap_cache));
+        LV_GC_ROOT(_lv_font_bitmap_cache) = NULL;
+    }
+#endif
+}
+
 /**
  * Free the allocated memories.
  */
@@ -212,15 +272,18 @@ static uint32_t get_glyph_dsc_id(const lv_font_t * font, uint32_t letter)
 
     lv_font_fmt_txt_dsc_t * fdsc = (lv_font_fmt_txt_dsc_t *)font->dsc;
 
+    /*The cache is shared by the render threads*/
+    lv_font_fmt_txt_glyph_cache_t * cache = _lv_parallel_is_active() ? NULL : fdsc->cache;
+
     /*Check the cache first*/
-    if(fdsc->cache && letter == fdsc->cache->last_letter) return fdsc->cache->last_glyph_id;
+    if(cache && letter == cache->last_letter) return cache->last_glyph_id;
 
     uint16_t i;
     for(i = 0; i < fdsc->cmap_num; i++) {
 
         /*Relative code point*/
         uint32_t rcp = letter - fdsc->cmaps[i].range_start;
-        if(rcp > fdsc->cmaps[i].range_length) continue;
+        if(rcp >= fdsc->cmaps[i].range_length) continue;
         uint32_t glyph_id = 0;
         if(fdsc->cmaps[i].type == LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY) {
             glyph_id = fdsc->cmaps[i].glyph_id_start + rcp;
@@ -252,16 +315,16 @@ static uint32_t get_glyph_dsc_id(const lv_font_t * font, uint32_t letter)
         }
 
         /*Update the cache*/
-        if(fdsc->cache) {
-            fdsc->cache->last_letter = letter;
-            fdsc->cache->last_glyph_id = glyph_id;
+        if(cache) {
+            cache->last_letter = letter;
+            cache->last_glyph_id = glyph_id;
         }
         return glyph_id;
     }
 
-    if(fdsc->cache) {
-        fdsc->cache->last_letter = letter;
-        fdsc->cache->last_glyph_id = 0;
+    if(cache) {
+        cache->last_letter = letter;
+        cache->last_glyph_id = 0;
     }
     return 0;
 
@@ -345,6 +408,81 @@ static int32_t kern_pair_16_compare(const void * ref, const void * element)
 }
 
 #if LV_USE_FONT_COMPRESSED
+static const uint8_t * bitmap_cache_get(const lv_font_t * font, uint32_t letter)
+{
+    lv_lru_t * cache = LV_GC_ROOT(_lv_font_bitmap_cache);
+    if(cache == NULL) return NULL;
+
+    bitmap_cache_key_t key;
+    lv_memset_00(&key, sizeof(key));    /*No garbage in the padding as it's hashed too*/
+    key.font = font;
+    key.letter = letter;
+
+    uint8_t * bitmap;
+    _lv_parallel_lock();
+    lv_lru_get(cache, &key, sizeof(key), (void **)&bitmap);
+    _lv_parallel_unlock();
+    return bitmap;
+}
+
+/**
+ * Decompress a glyph into the cache.
+ * While rendering on more threads the other thread might still use a glyph the LRU would free,
+ * so then the glyph is added only if it fits without evicting anything.
+ * @return the cached bitmap or NULL if it's not cached
+ */
+static const uint8_t * bitmap_cache_add(const lv_font_t * font, uint32_t letter, const uint8_t * in,
+                                        const lv_font_fmt_txt_glyph_dsc_t * gdsc, uint32_t buf_size)
+{
+    if(bitmap_cache_size == 0) return NULL;
+
+    uint32_t item_size = buf_size + BITMAP_CACHE_ITEM_OVERHEAD;
+    if(item_size > bitmap_cache_size) return NULL;
+
+    _lv_parallel_lock();
+    lv_lru_t * cache = LV_GC_ROOT(_lv_font_bitmap_cache);
+    if(cache == NULL) {
+        cache = lv_lru_create(bitmap_cache_size, BITMAP_CACHE_AVG_ITEM_SIZE, NULL, NULL);
+        LV_GC_ROOT(_lv_font_bitmap_cache) = cache;
+    }
+    bool fits = cache && (!_lv_parallel_is_active() || cache->free_memory >= item_size);
+    _lv_parallel_unlock();
+    if(!fits) return NULL;
+
+    uint8_t * bitmap = lv_mem_cache_alloc(buf_size);
+    if(bitmap == NULL) return NULL;
+
+    lv_font_fmt_txt_dsc_t * fdsc = (lv_font_fmt_txt_dsc_t *)font->dsc;
+    bool prefilter = fdsc->bitmap_format == LV_FONT_FMT_TXT_COMPRESSED ? true : false;
+    decompress(in, bitmap, gdsc->box_w, gdsc->box_h, (uint8_t)fdsc->bpp, prefilter);
+
+    bitmap_cache_key_t key;
+    lv_memset_00(&key, sizeof(key));
+    key.font = font;
+    key.letter = letter;
+
+    _lv_parallel_lock();
+    /*Check again, the other thread might have added a glyph since then*/
+    if(_lv_parallel_is_active() && cache->free_memory < item_size) {
+        _lv_parallel_unlock();
+        lv_mem_cache_free(bitmap);
+        return NULL;
+    }
+
+    /*Don't replace a glyph the other thread has just added, it might be drawing it*/
+    uint8_t * added;
+    lv_lru_get(cache, &key, sizeof(key), (void **)&added);
+    if(added) {
+        _lv_parallel_unlock();
+        lv_mem_cache_free(bitmap);
+        return added;
+    }
+
+    lv_lru_set(cache, &key, sizeof(key), bitmap, item_size);
+    _lv_parallel_unlock();
+    return bitmap;
+}
+
 /**
  * The compress a glyph's bitmap
  * @param in the compressed bitmap
@@ -359,7 +497,8 @@ static void decompress(const uint8_t * in, uint8_t * out, lv_coord_t w, lv_coord
     uint8_t wr_size = bpp;
     if(bpp == 3) wr_size = 4;
 
-    rle_init(in, bpp);
+    rle_t rle;
+    rle_init(&rle, in, bpp);
 
     uint8_t * line_buf1 = lv_mem_buf_get(w);
 
@@ -369,7 +508,7 @@ static void decompress(const uint8_t * in, uint8_t * out, lv_coord_t w, lv_coord
         line_buf2 = lv_mem_buf_get(w);
     }
 
-    decompress_line(line_buf1, w);
+    decompress_line(&rle, line_buf1, w);
 
     lv_coord_t y;
     lv_coord_t x;
@@ -381,7 +520,7 @@ static void decompress(const uint8_t * in, uint8_t * out, lv_coord_t w, lv_coord
 
     for(y = 1; y < h; y++) {
         if(prefilter) {
-            decompress_line(line_buf2, w);
+            decompress_line(&rle, line_buf2, w);
 
             for(x = 0; x < w; x++) {
                 line_buf1[x] = line_buf2[x] ^ line_buf1[x];
@@ -390,7 +529,7 @@ static void decompress(const uint8_t * in, uint8_t * out, lv_coord_t w, lv_coord
             }
         }
         else {
-            decompress_line(line_buf1, w);
+            decompress_line(&rle, line_buf1, w);
 
             for(x = 0; x < w; x++) {
                 bits_write(out, wrp, line_buf1[x], bpp);
@@ -405,14 +544,15 @@ static void decompress(const uint8_t * in, uint8_t * out, lv_coord_t w, lv_coord
 
 /**
  * Decompress one line. Store one pixel per byte
+ * @param rle the state of the decompression
  * @param out output buffer
  * @param w width of the line in pixel count
  */
-static inline void decompress_line(uint8_t * out, lv_coord_t w)
+static inline void decompress_line(rle_t * rle, uint8_t * out, lv_coord_t w)
 {
     lv_coord_t i;
     for(i = 0; i < w; i++) {
-        out[i] = rle_next();
+        out[i] = rle_next(rle);
     }
 }
 
@@ -507,67 +647,67 @@ static inline void bits_write(uint8_t * out, uint32_t bit_pos, uint8_t val, uint
     out[byte_pos] |= (val << bit_pos);
 }
 
-static inline void rle_init(const uint8_t * in,  uint8_t bpp)
+static inline void rle_init(rle_t * rle, const uint8_t * in,  uint8_t bpp)
 {
-    rle_in = in;
-    rle_bpp = bpp;
-    rle_state = RLE_STATE_SINGLE;
-    rle_rdp = 0;
-    rle_prev_v = 0;
-    rle_cnt = 0;
+    rle->in = in;
+    rle->bpp = bpp;
+    rle->state = RLE_STATE_SINGLE;
+    rle->rdp = 0;
+    rle->prev_v = 0;
+    rle->cnt = 0;
 }
 
-static inline uint8_t rle_next(void)
+static inline uint8_t rle_next(rle_t * rle)
 {
     uint8_t v = 0;
     uint8_t ret = 0;
 
-    if(rle_state == RLE_STATE_SINGLE) {
-        ret = get_bits(rle_in, rle_rdp, rle_bpp);
-        if(rle_rdp != 0 && rle_prev_v == ret) {
-            rle_cnt = 0;
-            rle_state = RLE_STATE_REPEATE;
+    if(rle->state == RLE_STATE_SINGLE) {
+        ret = get_bits(rle->in, rle->rdp, rle->bpp);
+        if(rle->rdp != 0 && rle->prev_v == ret) {
+            rle->cnt = 0;
+            rle->state = RLE_STATE_REPEATE;
         }
 
-        rle_prev_v = ret;
-        rle_rdp += rle_bpp;
+        rle->prev_v = ret;
+        rle->rdp += rle->bpp;
     }
-    else if(rle_state == RLE_STATE_REPEATE) {
-        v = get_bits(rle_in, rle_rdp, 1);
-        rle_cnt++;
-        rle_rdp += 1;
+    else if(rle->state == RLE_STATE_REPEATE) {
+        v = get_bits(rle->in, rle->rdp, 1);
+        rle->cnt++;
+        rle->rdp += 1;
         if(v == 1) {
-            ret = rle_prev_v;
-            if(rle_cnt == 11) {
-                rle_cnt = get_bits(rle_in, rle_rdp, 6);
-                rle_rdp += 6;
-                if(rle_cnt != 0) {
-                    rle_state = RLE_STATE_COUNTER;
+            ret = rle->prev_v;
+            if(rle->cnt == 11) {
+                rle->cnt = get_bits(rle->in, rle->rdp, 6);
+                rle->rdp += 6;
+                if(rle->cnt != 0) {
+                    rle->state = RLE_STATE_COUNTER;
                 }
                 else {
-                    ret = get_bits(rle_in, rle_rdp, rle_bpp);
-                    rle_prev_v = ret;
-                    rle_rdp += rle_bpp;
-                    rle_state = RLE_STATE_SINGLE;
+                    ret = get_bits(rle->in, rle->rdp, rle->bpp);
+                    rle->prev_v = ret;
+                    rle->rdp += rle->bpp;
+                    rle->state = RLE_STATE_SINGLE;
                 }
             }
         }
         else {
-            ret = get_bits(rle_in, rle_rdp, rle_bpp);
-            rle_prev_v = ret;
-            rle_rdp += rle_bpp;
-            rle_state = RLE_STATE_SINGLE;
+            ret = get_bits(rle->in, rle->rdp, rle->bpp);
+            rle->prev_v = ret;
+            rle->rdp += rle->bpp;
+            rle->state = RLE_STATE_SINGLE;
         }
 
     }
-    else if(rle_state == RLE_STATE_COUNTER) {
-        ret = rle_prev_v;
-        rle_cnt--;
-        if(rle_cnt == 0) {
-            ret = get_bits(rle_in, rle_rdp, rle_bpp);
-            rle_prev_v = ret;
-            rle_rdp += rle_bpp;
-            rle_state = RLE_STATE_SINGLE;
+    else if(rle->state == RLE_STATE_COUNTER) {
+        ret = rle->prev_v;
+        rle->cnt--;
+        if(rle->cnt == 0) {
+            ret = get_bits(rle->in, rle->rdp, rle->bpp);
+            rle->prev_v = ret;
+            rle->rdp += rle->bpp;
+            rle->state = RLE_STATE_SINGLE;
         }
     }
 
@@ -220,6 +220,20 @@ const uint8_t * lv_font_get_bitmap_fmt_txt(const lv_font_t * font, uint32_t lett
 bool lv_font_get_glyph_dsc_fmt_txt(const lv_font_t * font, lv_font_glyph_dsc_t * dsc_out, uint32_t unicode_letter,
                                    uint32_t unicode_letter_next);
 
+/**
+ * Set the number of bytes the decompressed glyphs of compressed fonts can use.
+ * The glyphs are cached by font and letter, the least recently used ones are freed to stay in the limit.
+ * The cache is emptied too.
+ * @param size the byte budget of the cache. 0: disable caching and decompress the glyphs on every draw
+ */
+void lv_font_fmt_txt_set_bitmap_cache_size(uint32_t size);
+
+/**
+ * Free the decompressed glyphs of compressed fonts.
+ * Required before freeing a compressed font as the glyphs are identified by the font's address.
+ */
+void lv_font_fmt_txt_bitmap_cache_clear(void);
+
 /**
  * Free the allocated memories.
  */
@@ -166,6 +166,9 @@ void lv_font_free(lv_font_t * font)
                 lv_mem_free(cmaps);
             }
 
+            /*The cached glyphs are identified by the font's address*/
+            if(dsc->bitmap_format != LV_FONT_FMT_TXT_PLAIN) lv_font_fmt_txt_bitmap_cache_clear();
+
             if(NULL != dsc->glyph_bitmap) {
                 lv_mem_free((void *)dsc->glyph_bitmap);
             }
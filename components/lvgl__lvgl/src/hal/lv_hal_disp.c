@@ -186,7 +186,6 @@ lv_disp_t * lv_disp_drv_register(lv_disp_drv_t * driver)
 
     disp->inv_en_cnt = 1;
 
-    _lv_ll_init(&disp->sync_areas, sizeof(lv_area_t));
 
     lv_disp_t * disp_def_tmp = disp_def;
     disp_def                 = disp; /*Temporarily change the default screen to create the default screens on the
@@ -318,8 +317,13 @@ void lv_disp_remove(lv_disp_t * disp)
     }
 
     _lv_ll_remove(&LV_GC_ROOT(_lv_disp_ll), disp);
-    _lv_ll_clear(&disp->sync_areas);
     if(disp->refr_timer) lv_timer_del(disp->refr_timer);
+#if LV_USE_PARALLEL_RENDER
+    if(disp->worker_draw_ctx) {
+        disp->driver->draw_ctx_deinit(disp->driver, disp->worker_draw_ctx);
+        lv_mem_free(disp->worker_draw_ctx);
+    }
+#endif
     lv_mem_free(disp);
 
     if(was_default) lv_disp_set_default(_lv_ll_get_head(&LV_GC_ROOT(_lv_disp_ll)));
@@ -512,6 +516,13 @@ lv_coord_t lv_disp_get_dpi(const lv_disp_t * disp)
     return disp->driver->dpi;
 }
 
+uint32_t lv_disp_get_sync_size(const lv_disp_t * disp)
+{
+    if(disp == NULL) disp = lv_disp_get_default();
+    if(disp == NULL) return 0;
+    return disp->sync_px * sizeof(lv_color_t);
+}
+
 /**
  * Call in the display driver's `flush_cb` function when the flushing is finished
  * @param disp_drv pointer to display driver in `flush_cb` where this function is called
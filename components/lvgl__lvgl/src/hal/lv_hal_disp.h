@@ -32,6 +32,14 @@ extern "C" {
 #define LV_INV_BUF_SIZE 32 /*Buffer size for invalid areas*/
 #endif
 
+#ifndef LV_SYNC_BUF_SIZE
+#define LV_SYNC_BUF_SIZE (LV_INV_BUF_SIZE * 2) /*Buffer size for the areas to sync in direct mode. If full, the areas are not split further*/
+#endif
+
+#if LV_SYNC_BUF_SIZE < LV_INV_BUF_SIZE
+#error "LV_SYNC_BUF_SIZE can't be smaller than LV_INV_BUF_SIZE"
+#endif
+
 #ifndef LV_ATTRIBUTE_FLUSH_READY
 #define LV_ATTRIBUTE_FLUSH_READY
 #endif
@@ -136,6 +144,11 @@ typedef struct _lv_disp_drv_t {
     /** OPTIONAL: called when start rendering */
     void (*render_start_cb)(struct _lv_disp_drv_t * disp_drv);
 
+    /** OPTIONAL: Copy areas from the buffer on the screen to the other buffer in direct mode with two buffers.
+     * The areas don't overlap. Return when all are copied. E.g. to copy with DMA instead of `lv_draw_ctx_t::buffer_copy`*/
+    void (*sync_cb)(struct _lv_disp_drv_t * disp_drv, lv_color_t * dest_buf, const lv_color_t * src_buf,
+                    const lv_area_t * areas, uint16_t area_cnt);
+
     /** On CHROMA_KEYED images this color will be transparent.
      * `LV_COLOR_CHROMA_KEY` by default. (lv_conf.h)*/
     lv_color_t color_chroma_key;
@@ -187,8 +200,15 @@ typedef struct _lv_disp_t {
     uint16_t inv_p;
     int32_t inv_en_cnt;
 
-    /** Double buffer sync areas */
-    lv_ll_t sync_areas;
+    /** Areas rendered in the last frame. In direct mode with two buffers they are stale in the other buffer*/
+    lv_area_t sync_areas[LV_SYNC_BUF_SIZE];
+    uint16_t sync_p;
+    uint32_t sync_px;               /**< Pixels copied by the last sync*/
+
+#if LV_USE_PARALLEL_RENDER
+    /** Draw context of the worker thread, created at the first parallel rendering*/
+    lv_draw_ctx_t * worker_draw_ctx;
+#endif
 
     /*Miscellaneous data*/
     uint32_t last_activity_time;        /**< Last time when there was activity on this display*/
@@ -312,6 +332,14 @@ bool lv_disp_get_antialiasing(lv_disp_t * disp);
  */
 lv_coord_t lv_disp_get_dpi(const lv_disp_t * disp);
 
+/**
+ * Get how many bytes were copied between the buffers before rendering the last frame
+ * (only in direct mode with two buffers)
+ * @param disp pointer to a display (NULL to use the default display)
+ * @return the copied bytes
+ */
+uint32_t lv_disp_get_sync_size(const lv_disp_t * disp);
+
 /**
  * Set the rotation of this display.
  * @param disp pointer to a display (NULL to use the default display)
@@ -131,6 +131,17 @@
         #endif
     #endif
 
+    /*Size of an area in the pool for small objects (<= 128 bytes) which are allocated from size classes.
+     *It keeps the small and frequent allocations (objects, style lists, list nodes) from fragmenting the pool.
+     *0: disable*/
+    #ifndef LV_MEM_SLAB_SIZE
+        #ifdef CONFIG_LV_MEM_SLAB_SIZE
+            #define LV_MEM_SLAB_SIZE CONFIG_LV_MEM_SLAB_SIZE
+        #else
+            #define LV_MEM_SLAB_SIZE 0               /*[bytes]*/
+        #endif
+    #endif
+
     /*Set an address for the memory pool instead of allocating it as a normal array. Can be in external SRAM too.*/
     #ifndef LV_MEM_ADR
         #ifdef CONFIG_LV_MEM_ADR
@@ -198,6 +209,31 @@
     #endif
 #endif
 
+/*Allocate the caches (shadow corners, decompressed glyphs, resolved style properties and the LRU bookkeeping)
+ *with these functions instead of `lv_mem_alloc()`. E.g. to keep them out of the LVGL heap.
+ *Leave them undefined to allocate the caches from the LVGL heap*/
+#ifndef LV_CACHE_MEM_INCLUDE
+    #ifdef CONFIG_LV_CACHE_MEM_INCLUDE
+        #define LV_CACHE_MEM_INCLUDE CONFIG_LV_CACHE_MEM_INCLUDE
+    #else
+        #undef LV_CACHE_MEM_INCLUDE
+    #endif
+#endif
+#ifndef LV_CACHE_MEM_ALLOC
+    #ifdef CONFIG_LV_CACHE_MEM_ALLOC
+        #define LV_CACHE_MEM_ALLOC CONFIG_LV_CACHE_MEM_ALLOC
+    #else
+        #undef LV_CACHE_MEM_ALLOC
+    #endif
+#endif
+#ifndef LV_CACHE_MEM_FREE
+    #ifdef CONFIG_LV_CACHE_MEM_FREE
+        #define LV_CACHE_MEM_FREE CONFIG_LV_CACHE_MEM_FREE
+    #else
+        #undef LV_CACHE_MEM_FREE
+    #endif
+#endif
+
 /*Use the standard `memcpy` and `memset` instead of LVGL's own functions. (Might or might not be faster).*/
 #ifndef LV_MEMCPY_MEMSET_STD
     #ifdef CONFIG_LV_MEMCPY_MEMSET_STD
@@ -229,6 +265,16 @@
     #endif
 #endif
 
+/*Cell size [px] of the grid used to find the clicked object on screens with
+ *`lv_indev_hit_index_enable(scr, true)`. 0: disable the hit index*/
+#ifndef LV_INDEV_HIT_INDEX_CELL_SIZE
+    #ifdef CONFIG_LV_INDEV_HIT_INDEX_CELL_SIZE
+        #define LV_INDEV_HIT_INDEX_CELL_SIZE CONFIG_LV_INDEV_HIT_INDEX_CELL_SIZE
+    #else
+        #define LV_INDEV_HIT_INDEX_CELL_SIZE 0
+    #endif
+#endif
+
 /*Use a custom tick source that tells the elapsed time in milliseconds.
  *It removes the need to manually update the tick with `lv_tick_inc()`)*/
 #ifndef LV_TICK_CUSTOM
@@ -293,7 +339,7 @@
 
     /*Allow buffering some shadow calculation.
     *LV_SHADOW_CACHE_SIZE is the max. shadow size to buffer, where shadow size is `shadow_width + radius`
-    *Caching has LV_SHADOW_CACHE_SIZE^2 RAM cost*/
+    *A buffered shadow has shadow size^2 RAM cost*/
     #ifndef LV_SHADOW_CACHE_SIZE
         #ifdef CONFIG_LV_SHADOW_CACHE_SIZE
             #define LV_SHADOW_CACHE_SIZE CONFIG_LV_SHADOW_CACHE_SIZE
@@ -301,10 +347,21 @@
             #define LV_SHADOW_CACHE_SIZE 0
         #endif
     #endif
+    #if LV_SHADOW_CACHE_SIZE
+        /*Bytes of buffered shadows to keep. The least recently used ones are freed to stay in the limit*/
+        #ifndef LV_SHADOW_CACHE_MEM_SIZE
+            #ifdef CONFIG_LV_SHADOW_CACHE_MEM_SIZE
+                #define LV_SHADOW_CACHE_MEM_SIZE CONFIG_LV_SHADOW_CACHE_MEM_SIZE
+            #else
+                #define LV_SHADOW_CACHE_MEM_SIZE (8 * 1024)
+            #endif
+        #endif
+    #endif
 
     /* Set number of maximally cached circle data.
     * The circumference of 1/4 circle are saved for anti-aliasing
-    * radius * 4 bytes are used per circle (the most often used radiuses are saved)
+    * radius * 6 bytes are used per circle (the most often used radiuses are saved)
+    * The entries are looked up by a hash of the radius so a larger cache is not slower
     * 0: to disable caching */
     #ifndef LV_CIRCLE_CACHE_SIZE
         #ifdef CONFIG_LV_CIRCLE_CACHE_SIZE
@@ -313,6 +370,16 @@
             #define LV_CIRCLE_CACHE_SIZE 4
         #endif
     #endif
+
+    /*Use the circle data of src/draw/lv_draw_mask_circle_tables.c from the flash for its radii (1..16 by default).
+     *Generate it with scripts/circle_tables_gen.py for other radii*/
+    #ifndef LV_USE_CIRCLE_CONST_TABLES
+        #ifdef CONFIG_LV_USE_CIRCLE_CONST_TABLES
+            #define LV_USE_CIRCLE_CONST_TABLES CONFIG_LV_USE_CIRCLE_CONST_TABLES
+        #else
+            #define LV_USE_CIRCLE_CONST_TABLES 0
+        #endif
+    #endif
 #endif /*LV_DRAW_COMPLEX*/
 
 /**
@@ -355,6 +422,52 @@
         #define LV_IMG_CACHE_DEF_SIZE 0
     #endif
 #endif
+#if LV_IMG_CACHE_DEF_SIZE
+    /*Default number of bytes the cached images can use. Mainly the decoded pixels are counted.
+     *The least recently used images are closed to stay in the limit*/
+    #ifndef LV_IMG_CACHE_DEF_MEM_SIZE
+        #ifdef CONFIG_LV_IMG_CACHE_DEF_MEM_SIZE
+            #define LV_IMG_CACHE_DEF_MEM_SIZE CONFIG_LV_IMG_CACHE_DEF_MEM_SIZE
+        #else
+            #define LV_IMG_CACHE_DEF_MEM_SIZE (256U * 1024U)
+        #endif
+    #endif
+
+    /*Copy the decoded images to memory allocated by these functions and close their decoder.
+     *E.g. to place large images to external RAM. Leave them undefined to keep the decoder's buffer*/
+    #ifndef LV_IMG_CACHE_MEM_INCLUDE
+        #ifdef CONFIG_LV_IMG_CACHE_MEM_INCLUDE
+            #define LV_IMG_CACHE_MEM_INCLUDE CONFIG_LV_IMG_CACHE_MEM_INCLUDE
+        #else
+            #undef LV_IMG_CACHE_MEM_INCLUDE
+        #endif
+    #endif
+    #ifndef LV_IMG_CACHE_MEM_ALLOC
+        #ifdef CONFIG_LV_IMG_CACHE_MEM_ALLOC
+            #define LV_IMG_CACHE_MEM_ALLOC CONFIG_LV_IMG_CACHE_MEM_ALLOC
+        #else
+            #undef LV_IMG_CACHE_MEM_ALLOC
+        #endif
+    #endif
+    #ifndef LV_IMG_CACHE_MEM_FREE
+        #ifdef CONFIG_LV_IMG_CACHE_MEM_FREE
+            #define LV_IMG_CACHE_MEM_FREE CONFIG_LV_IMG_CACHE_MEM_FREE
+        #else
+            #undef LV_IMG_CACHE_MEM_FREE
+        #endif
+    #endif
+#endif
+
+/*Default number of resolved style properties to cache. Reading a style property of a widget
+ *walks all of its styles, the cache keeps the result per widget, part, state and property.
+ *About 16 bytes per entry. 0: to disable caching*/
+#ifndef LV_OBJ_STYLE_CACHE_DEF_SIZE
+    #ifdef CONFIG_LV_OBJ_STYLE_CACHE_DEF_SIZE
+        #define LV_OBJ_STYLE_CACHE_DEF_SIZE CONFIG_LV_OBJ_STYLE_CACHE_DEF_SIZE
+    #else
+        #define LV_OBJ_STYLE_CACHE_DEF_SIZE 0
+    #endif
+#endif
 
 /*Number of stops allowed per gradient. Increase this to allow more stops.
  *This adds (sizeof(lv_color_t) + 1) bytes per additional stop*/
@@ -412,6 +525,51 @@
     #endif
 #endif
 
+/*Let a custom header (e.g. with SIMD or assembly kernels) handle the RGB565 fill and image blending.
+ *The header can define `LV_DRAW_SW_RGB565_FILL(dsc)` and `LV_DRAW_SW_RGB565_MAP(dsc)`.
+ *Only used with LV_COLOR_DEPTH 16 and LV_COLOR_16_SWAP 0*/
+#ifndef LV_DRAW_SW_ASM_CUSTOM
+    #ifdef CONFIG_LV_DRAW_SW_ASM_CUSTOM
+        #define LV_DRAW_SW_ASM_CUSTOM CONFIG_LV_DRAW_SW_ASM_CUSTOM
+    #else
+        #define LV_DRAW_SW_ASM_CUSTOM 0
+    #endif
+#endif
+#if LV_DRAW_SW_ASM_CUSTOM
+    #ifndef LV_DRAW_SW_ASM_CUSTOM_INCLUDE
+        #ifdef CONFIG_LV_DRAW_SW_ASM_CUSTOM_INCLUDE
+            #define LV_DRAW_SW_ASM_CUSTOM_INCLUDE CONFIG_LV_DRAW_SW_ASM_CUSTOM_INCLUDE
+        #else
+            #define LV_DRAW_SW_ASM_CUSTOM_INCLUDE "my_blend_kernels.h"
+        #endif
+    #endif
+#endif
+
+/*Render on two threads: the invalidated areas are split at a horizontal line and the part above it
+ *is rendered by a worker (e.g. a task on the other core) into the same buffer. See `lv_parallel_set_cb()`.
+ *Only for the software renderer.*/
+#ifndef LV_USE_PARALLEL_RENDER
+    #ifdef CONFIG_LV_USE_PARALLEL_RENDER
+        #define LV_USE_PARALLEL_RENDER CONFIG_LV_USE_PARALLEL_RENDER
+    #else
+        #define LV_USE_PARALLEL_RENDER 0
+    #endif
+#endif
+#if LV_USE_PARALLEL_RENDER
+    /*Storage class of the render state each thread has its own copy of (a few hundred bytes per thread)*/
+    #ifndef LV_PARALLEL_RENDER_TLS
+        #define LV_PARALLEL_RENDER_TLS __thread
+    #endif
+    /*[px] Smaller areas are rendered on one thread because starting the worker would take longer*/
+    #ifndef LV_PARALLEL_RENDER_MIN_AREA
+        #ifdef CONFIG_LV_PARALLEL_RENDER_MIN_AREA
+            #define LV_PARALLEL_RENDER_MIN_AREA CONFIG_LV_PARALLEL_RENDER_MIN_AREA
+        #else
+            #define LV_PARALLEL_RENDER_MIN_AREA 4096
+        #endif
+    #endif
+#endif
+
 /*-------------
  * GPU
  *-----------*/
@@ -787,6 +945,42 @@
     #endif
 #endif
 
+/*1: Measure the stages of the refresh (layout, style refresh, rendering, flush, etc.) with histograms of the durations.
+ *See `lv_trace_dump()` and `lv_trace_export_chrome()`*/
+#ifndef LV_USE_TRACE
+    #ifdef CONFIG_LV_USE_TRACE
+        #define LV_USE_TRACE CONFIG_LV_USE_TRACE
+    #else
+        #define LV_USE_TRACE 0
+    #endif
+#endif
+#if LV_USE_TRACE
+    /*Number of the last measurements to keep for `lv_trace_export_chrome()`. 0: keep only the histograms*/
+    #ifndef LV_TRACE_EVENT_CNT
+        #ifdef CONFIG_LV_TRACE_EVENT_CNT
+            #define LV_TRACE_EVENT_CNT CONFIG_LV_TRACE_EVENT_CNT
+        #else
+            #define LV_TRACE_EVENT_CNT 256
+        #endif
+    #endif
+
+    /*Time in microseconds as uint32_t. The default has the resolution of the tick.*/
+    #ifndef LV_TRACE_TIME_INCLUDE
+        #ifdef CONFIG_LV_TRACE_TIME_INCLUDE
+            #define LV_TRACE_TIME_INCLUDE CONFIG_LV_TRACE_TIME_INCLUDE
+        #else
+            #define LV_TRACE_TIME_INCLUDE <stdint.h>
+        #endif
+    #endif
+    #ifndef LV_TRACE_TIME_EXPR
+        #ifdef CONFIG_LV_TRACE_TIME_EXPR
+            #define LV_TRACE_TIME_EXPR CONFIG_LV_TRACE_TIME_EXPR
+        #else
+            #define LV_TRACE_TIME_EXPR (lv_tick_get() * 1000)
+        #endif
+    #endif
+#endif
+
 /*1: Draw random colored rectangles over the redrawn areas*/
 #ifndef LV_USE_REFR_DEBUG
     #ifdef CONFIG_LV_USE_REFR_DEBUG
@@ -1228,6 +1422,16 @@
         #define LV_USE_FONT_COMPRESSED 0
     #endif
 #endif
+#if LV_USE_FONT_COMPRESSED
+    /*Bytes of decompressed glyphs to keep so that they are not decompressed on every draw. 0: no caching*/
+    #ifndef LV_FONT_COMPRESSED_CACHE_SIZE
+        #ifdef CONFIG_LV_FONT_COMPRESSED_CACHE_SIZE
+            #define LV_FONT_COMPRESSED_CACHE_SIZE CONFIG_LV_FONT_COMPRESSED_CACHE_SIZE
+        #else
+            #define LV_FONT_COMPRESSED_CACHE_SIZE (4 * 1024)
+        #endif
+    #endif
+#endif
 
 /*Enable subpixel rendering*/
 #ifndef LV_USE_FONT_SUBPX
@@ -1497,6 +1701,17 @@
             #define LV_LABEL_LONG_TXT_HINT 1  /*Store some extra info in labels to speed up drawing of very long texts*/
         #endif
     #endif
+    #ifndef LV_LABEL_LINE_CACHE
+        #ifdef _LV_KCONFIG_PRESENT
+            #ifdef CONFIG_LV_LABEL_LINE_CACHE
+                #define LV_LABEL_LINE_CACHE CONFIG_LV_LABEL_LINE_CACHE
+            #else
+                #define LV_LABEL_LINE_CACHE 0
+            #endif
+        #else
+            #define LV_LABEL_LINE_CACHE 1     /*Store the line breaks of labels to not measure the text on every draw and refresh*/
+        #endif
+    #endif
 #endif
 
 #ifndef LV_USE_LINE
@@ -1958,6 +2173,16 @@
         #define LV_USE_FLEX 1
     #endif
 #endif
+#if LV_USE_FLEX
+    /*Remember the size and position of the items to re-layout only the changed tracks*/
+    #ifndef LV_FLEX_CACHE
+        #ifdef CONFIG_LV_FLEX_CACHE
+            #define LV_FLEX_CACHE CONFIG_LV_FLEX_CACHE
+        #else
+            #define LV_FLEX_CACHE 0
+        #endif
+    #endif
+#endif
 
 /*A layout similar to Grid in CSS.*/
 #ifndef LV_USE_GRID
@@ -1978,6 +2203,33 @@
 
 /*File system interfaces for common APIs */
 
+/*Cache the files of the drivers with `cache_size > 0` in blocks shared by all of them, instead of a `cache_size`
+ *window per open file. Sequential reads are read ahead, the least recently used blocks are dropped.
+ *Byte budget of the cache, 0: disabled*/
+#ifndef LV_FS_BLOCK_CACHE_SIZE
+    #ifdef CONFIG_LV_FS_BLOCK_CACHE_SIZE
+        #define LV_FS_BLOCK_CACHE_SIZE CONFIG_LV_FS_BLOCK_CACHE_SIZE
+    #else
+        #define LV_FS_BLOCK_CACHE_SIZE 0
+    #endif
+#endif
+#if LV_FS_BLOCK_CACHE_SIZE
+    #ifndef LV_FS_BLOCK_CACHE_BLOCK_SIZE
+        #ifdef CONFIG_LV_FS_BLOCK_CACHE_BLOCK_SIZE
+            #define LV_FS_BLOCK_CACHE_BLOCK_SIZE CONFIG_LV_FS_BLOCK_CACHE_BLOCK_SIZE
+        #else
+            #define LV_FS_BLOCK_CACHE_BLOCK_SIZE 512    /*Bytes per block. A multiple of the medium's sector size is the best*/
+        #endif
+    #endif
+    #ifndef LV_FS_BLOCK_CACHE_READ_AHEAD
+        #ifdef CONFIG_LV_FS_BLOCK_CACHE_READ_AHEAD
+            #define LV_FS_BLOCK_CACHE_READ_AHEAD CONFIG_LV_FS_BLOCK_CACHE_READ_AHEAD
+        #else
+            #define LV_FS_BLOCK_CACHE_READ_AHEAD 8      /*Max. number of blocks read with one driver call*/
+        #endif
+    #endif
+#endif
+
 /*API for fopen, fread, etc*/
 #ifndef LV_USE_FS_STDIO
     #ifdef CONFIG_LV_USE_FS_STDIO
@@ -2132,6 +2384,17 @@
         #define LV_USE_PNG 0
     #endif
 #endif
+#if LV_USE_PNG
+    /*Decode the PNGs whose decoded size is at least this many bytes row by row while drawing, instead of into a
+     *full image buffer. It needs about 32 kB plus two rows, but drawing the image again decodes it again. 0: never*/
+    #ifndef LV_PNG_STREAM_MIN_SIZE
+        #ifdef CONFIG_LV_PNG_STREAM_MIN_SIZE
+            #define LV_PNG_STREAM_MIN_SIZE CONFIG_LV_PNG_STREAM_MIN_SIZE
+        #else
+            #define LV_PNG_STREAM_MIN_SIZE 0
+        #endif
+    #endif
+#endif
 
 /*BMP decoder library*/
 #ifndef LV_USE_BMP
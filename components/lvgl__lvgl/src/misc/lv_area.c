@@ -10,6 +10,7 @@
 
 #include "lv_area.h"
 #include "lv_math.h"
+#include "lv_parallel.h"
 
 /*********************
  *      DEFINES
@@ -161,53 +162,46 @@ int8_t _lv_area_diff(lv_area_t * res_p, const lv_area_t * a1_p, const lv_area_t
     /*Result counter*/
     int8_t res_c = 0;
 
-    /*Get required information*/
+    /*The results don't overlap each other and `a2_p`*/
     lv_area_t n;
-    lv_coord_t a1_w = lv_area_get_width(a1_p) - 1;
-    lv_coord_t a1_h = lv_area_get_height(a1_p) - 1;
 
     /*Compute top rectangle*/
-    lv_coord_t th = a2_p->y1 - a1_p->y1;
-    if(th > 0) {
+    if(a2_p->y1 > a1_p->y1) {
         n.x1 = a1_p->x1;
         n.y1 = a1_p->y1;
         n.x2 = a1_p->x2;
-        n.y2 = a1_p->y1 + th;
+        n.y2 = a2_p->y1 - 1;
         res_p[res_c++] = n;
     }
 
     /*Compute the bottom rectangle*/
-    lv_coord_t bh = a1_h - (a2_p->y2 - a1_p->y1);
-    if(bh > 0 && a2_p->y2 < a1_p->y2) {
+    if(a2_p->y2 < a1_p->y2) {
         n.x1 = a1_p->x1;
-        n.y1 = a2_p->y2;
+        n.y1 = a2_p->y2 + 1;
         n.x2 = a1_p->x2;
-        n.y2 = a2_p->y2 + bh;
+        n.y2 = a1_p->y2;
         res_p[res_c++] = n;
     }
 
     /*Compute side height*/
     lv_coord_t y1 = a2_p->y1 > a1_p->y1 ? a2_p->y1 : a1_p->y1;
     lv_coord_t y2 = a2_p->y2 < a1_p->y2 ? a2_p->y2 : a1_p->y2;
-    lv_coord_t sh = y2 - y1;
 
     /*Compute the left rectangle*/
-    lv_coord_t lw = a2_p->x1 - a1_p->x1;
-    if(lw > 0 && sh > 0) {
+    if(a2_p->x1 > a1_p->x1) {
         n.x1 = a1_p->x1;
         n.y1 = y1;
-        n.x2 = a1_p->x1 + lw;
-        n.y2 = y1 + sh;
+        n.x2 = a2_p->x1 - 1;
+        n.y2 = y2;
         res_p[res_c++] = n;
     }
 
     /*Compute the right rectangle*/
-    lv_coord_t rw = a1_w - (a2_p->x2 - a1_p->x1);
-    if(rw > 0) {
-        n.x1 = a2_p->x2;
+    if(a2_p->x2 < a1_p->x2) {
+        n.x1 = a2_p->x2 + 1;
         n.y1 = y1;
-        n.x2 = a2_p->x2 + rw;
-        n.y2 = y1 + sh;
+        n.x2 = a1_p->x2;
+        n.y2 = y2;
         res_p[res_c++] = n;
     }
 
@@ -544,9 +538,9 @@ void lv_point_transform(lv_point_t * p, int32_t angle, int32_t zoom, const lv_po
         return;
     }
 
-    static int32_t angle_prev = INT32_MIN;
-    static int32_t sinma;
-    static int32_t cosma;
+    static LV_RENDER_TLS int32_t angle_prev = INT32_MIN;
+    static LV_RENDER_TLS int32_t sinma;
+    static LV_RENDER_TLS int32_t cosma;
     if(angle_prev != angle) {
         int32_t angle_limited = angle;
         if(angle_limited > 3600) angle_limited -= 3600;
@@ -16,19 +16,76 @@
 /*********************
  *      DEFINES
  *********************/
+#if LV_FS_BLOCK_CACHE_SIZE
+#if LV_FS_BLOCK_CACHE_SIZE < LV_FS_BLOCK_CACHE_BLOCK_SIZE || LV_FS_BLOCK_CACHE_READ_AHEAD < 1
+    #error "LV_FS_BLOCK_CACHE_SIZE has to fit a block and LV_FS_BLOCK_CACHE_READ_AHEAD has to be at least 1"
+#endif
+
+#define BLOCK_SIZE      LV_FS_BLOCK_CACHE_BLOCK_SIZE
+#define BLOCK_MAX       (LV_FS_BLOCK_CACHE_SIZE / LV_FS_BLOCK_CACHE_BLOCK_SIZE)
+
+/*Extents don't cross the groups of this many blocks, so the group of a block gives its hash bucket*/
+#define GROUP_BLOCKS    LV_MIN(LV_FS_BLOCK_CACHE_READ_AHEAD, BLOCK_MAX)
+#define BUCKET_CNT      BLOCK_MAX
+#endif
 
 /**********************
  *      TYPEDEFS
  **********************/
+#if LV_FS_BLOCK_CACHE_SIZE
+/*A file with cached blocks or opened with cache. Files are identified by driver and path, so the blocks outlive
+ *the file handles and serve the next opening too*/
+typedef struct _lv_fs_cached_file_t {
+    struct _lv_fs_cached_file_t * next;
+    lv_fs_drv_t * drv;
+    uint32_t size;          /*Measured on the first opening*/
+    uint32_t ref_cnt;       /*Open handles*/
+    uint32_t ext_cnt;       /*Cached extents*/
+    bool listed;            /*false: invalidated, only the open handles use it*/
+    char path[];
+} lv_fs_cached_file_t;
+
+/*Consecutive blocks of a file read with one driver call*/
+typedef struct _lv_fs_cache_ext_t {
+    struct _lv_fs_cache_ext_t * bucket_next;
+    struct _lv_fs_cache_ext_t * lru_prev;   /*Towards the most recently used*/
+    struct _lv_fs_cache_ext_t * lru_next;
+    lv_fs_cached_file_t * file;
+    uint32_t block;         /*The first block*/
+    uint32_t size;          /*Bytes in `data`. Only the last extent of a file has partial blocks*/
+    uint16_t block_cnt;
+    uint8_t data[];
+} lv_fs_cache_ext_t;
+#endif
 
 /**********************
  *  STATIC PROTOTYPES
  **********************/
 static const char * lv_fs_get_real_path(const char * path);
+#if LV_FS_BLOCK_CACHE_SIZE
+    static lv_fs_cached_file_t * cached_file_open(lv_fs_drv_t * drv, const char * real_path, void * file_d);
+    static void cached_file_release(lv_fs_cached_file_t * file);
+    static lv_fs_cached_file_t * cached_file_find(lv_fs_drv_t * drv, const char * real_path);
+    static void cached_file_drop(lv_fs_cached_file_t * file);
+    static lv_fs_res_t lv_fs_read_block_cached(lv_fs_file_t * file_p, uint8_t * buf, uint32_t btr, uint32_t * br);
+    static lv_fs_cache_ext_t * cache_find(lv_fs_cached_file_t * file, uint32_t block);
+    static lv_fs_cache_ext_t * cache_load(lv_fs_file_t * file_p, uint32_t block, lv_fs_res_t * res);
+    static void cache_drop(lv_fs_cache_ext_t * ext);
+    static lv_fs_res_t cache_drv_read(lv_fs_file_t * file_p, uint32_t pos, void * buf, uint32_t btr, uint32_t * br);
+    static uint32_t cache_hash(const lv_fs_cached_file_t * file, uint32_t block);
+#endif
 
 /**********************
  *  STATIC VARIABLES
  **********************/
+#if LV_FS_BLOCK_CACHE_SIZE
+    static lv_fs_cache_ext_t * cache_buckets[BUCKET_CNT];
+    static lv_fs_cache_ext_t * cache_lru_head;
+    static lv_fs_cache_ext_t * cache_lru_tail;
+    static lv_fs_cached_file_t * cached_files;
+    static lv_fs_cache_stats_t cache_stats;
+    static uint32_t cache_generation;   /*Changes when an extent is freed, to validate `last_ext` of the handles*/
+#endif
 
 /**********************
  *      MACROS
@@ -41,6 +98,16 @@ static const char * lv_fs_get_real_path(const char * path);
 void _lv_fs_init(void)
 {
     _lv_ll_init(&LV_GC_ROOT(_lv_fsdrv_ll), sizeof(lv_fs_drv_t *));
+
+#if LV_FS_BLOCK_CACHE_SIZE
+    /*After `lv_deinit` the cached blocks are gone with the heap*/
+    lv_memset_00(cache_buckets, sizeof(cache_buckets));
+    cache_lru_head = NULL;
+    cache_lru_tail = NULL;
+    cached_files = NULL;
+    lv_memset_00(&cache_stats, sizeof(cache_stats));
+    cache_generation++;
+#endif
 }
 
 bool lv_fs_is_ready(char letter)
@@ -82,6 +149,15 @@ lv_fs_res_t lv_fs_open(lv_fs_file_t * file_p, const char * path, lv_fs_mode_t mo
     }
 
     const char * real_path = lv_fs_get_real_path(path);
+
+#if LV_FS_BLOCK_CACHE_SIZE
+    /*The cached blocks would hide the changes*/
+    if(drv->cache_size && (mode & LV_FS_MODE_WR)) {
+        lv_fs_cached_file_t * cached = cached_file_find(drv, real_path);
+        if(cached) cached_file_drop(cached);
+    }
+#endif
+
     void * file_d = drv->open_cb(drv, real_path, mode);
 
     if(file_d == NULL || file_d == (void *)(-1)) {
@@ -97,6 +173,14 @@ lv_fs_res_t lv_fs_open(lv_fs_file_t * file_p, const char * path, lv_fs_mode_t mo
         lv_memset_00(file_p->cache, sizeof(lv_fs_file_cache_t));
         file_p->cache->start = UINT32_MAX;  /*Set an invalid range by default*/
         file_p->cache->end = UINT32_MAX - 1;
+
+#if LV_FS_BLOCK_CACHE_SIZE
+        /*Read only files go to the shared block cache, the others keep the window of `cache_size` bytes*/
+        if(mode == LV_FS_MODE_RD && drv->seek_cb && drv->tell_cb) {
+            file_p->cache->cached = cached_file_open(drv, real_path, file_d);
+            file_p->cache->read_ahead = 1;
+        }
+#endif
     }
 
     return LV_FS_RES_OK;
@@ -115,6 +199,9 @@ lv_fs_res_t lv_fs_close(lv_fs_file_t * file_p)
     lv_fs_res_t res = file_p->drv->close_cb(file_p->drv, file_p->file_d);
 
     if(file_p->drv->cache_size && file_p->cache) {
+#if LV_FS_BLOCK_CACHE_SIZE
+        if(file_p->cache->cached) cached_file_release(file_p->cache->cached);
+#endif
         if(file_p->cache->buffer) {
             lv_mem_free(file_p->cache->buffer);
         }
@@ -131,6 +218,10 @@ lv_fs_res_t lv_fs_close(lv_fs_file_t * file_p)
 
 static lv_fs_res_t lv_fs_read_cached(lv_fs_file_t * file_p, char * buf, uint32_t btr, uint32_t * br)
 {
+#if LV_FS_BLOCK_CACHE_SIZE
+    if(file_p->cache->cached) return lv_fs_read_block_cached(file_p, (uint8_t *)buf, btr, br);
+#endif
+
     lv_fs_res_t res = LV_FS_RES_OK;
     uint32_t file_position = file_p->cache->file_position;
     uint32_t start = file_p->cache->start;
@@ -252,6 +343,17 @@ lv_fs_res_t lv_fs_seek(lv_fs_file_t * file_p, uint32_t pos, lv_fs_whence_t whenc
         return LV_FS_RES_NOT_IMP;
     }
 
+#if LV_FS_BLOCK_CACHE_SIZE
+    /*Only the position is moved, the driver seeks when it's read*/
+    if(file_p->drv->cache_size && file_p->cache->cached) {
+        lv_fs_file_cache_t * cache = file_p->cache;
+        if(whence == LV_FS_SEEK_SET) cache->file_position = pos;
+        else if(whence == LV_FS_SEEK_CUR) cache->file_position += pos;
+        else cache->file_position = cache->cached->size + pos;
+        return LV_FS_RES_OK;
+    }
+#endif
+
     lv_fs_res_t res = LV_FS_RES_OK;
     if(file_p->drv->cache_size) {
         switch(whence) {
@@ -321,6 +423,34 @@ lv_fs_res_t lv_fs_tell(lv_fs_file_t * file_p, uint32_t * pos)
     return res;
 }
 
+#if LV_FS_BLOCK_CACHE_SIZE
+void lv_fs_cache_get_stats(lv_fs_cache_stats_t * stats)
+{
+    *stats = cache_stats;
+}
+
+void lv_fs_cache_reset_stats(void)
+{
+    uint32_t size = cache_stats.size;
+    lv_memset_00(&cache_stats, sizeof(cache_stats));
+    cache_stats.size = size;
+}
+
+void lv_fs_cache_invalidate(const char * path)
+{
+    if(path == NULL) {
+        while(cache_lru_head) cache_drop(cache_lru_head);
+        return;
+    }
+
+    lv_fs_drv_t * drv = lv_fs_get_drv(path[0]);
+    if(drv == NULL) return;
+
+    lv_fs_cached_file_t * file = cached_file_find(drv, lv_fs_get_real_path(path));
+    if(file) cached_file_drop(file);
+}
+#endif
+
 lv_fs_res_t lv_fs_dir_open(lv_fs_dir_t * rddir_p, const char * path)
 {
     if(path == NULL) return LV_FS_RES_INV_PARAM;
@@ -516,3 +646,314 @@ static const char * lv_fs_get_real_path(const char * path)
 
     return path;
 }
+
+#if LV_FS_BLOCK_CACHE_SIZE
+
+/**
+ * Find or add the cache entry of a file just opened. A new entry needs the size of the file.
+ * @param drv       the file's driver
+ * @param real_path the file's path without the driver letter
+ * @param file_d    the driver's handle of the file, at position 0
+ * @return          the entry or NULL if the size is unknown or out of memory
+ */
+static lv_fs_cached_file_t * cached_file_open(lv_fs_drv_t * drv, const char * real_path, void * file_d)
+{
+    lv_fs_cached_file_t * file = cached_file_find(drv, real_path);
+    if(file == NULL) {
+        uint32_t size;
+        if(drv->seek_cb(drv, file_d, 0, LV_FS_SEEK_END) != LV_FS_RES_OK) return NULL;
+        lv_fs_res_t res = drv->tell_cb(drv, file_d, &size);
+        if(drv->seek_cb(drv, file_d, 0, LV_FS_SEEK_SET) != LV_FS_RES_OK || res != LV_FS_RES_OK) return NULL;
+
+        size_t path_len = strlen(real_path) + 1;
+        file = lv_mem_alloc(sizeof(lv_fs_cached_file_t) + path_len);
+        LV_ASSERT_MALLOC(file);
+        if(file == NULL) return NULL;
+
+        file->drv = drv;
+        file->size = size;
+        file->ref_cnt = 0;
+        file->ext_cnt = 0;
+        file->listed = true;
+        lv_memcpy(file->path, real_path, path_len);
+        file->next = cached_files;
+        cached_files = file;
+    }
+
+    file->ref_cnt++;
+    return file;
+}
+
+/**
+ * Close a handle of a file and forget the file if it's neither open nor has cached blocks
+ * @param file      the file's entry
+ */
+static void cached_file_release(lv_fs_cached_file_t * file)
+{
+    if(file->ref_cnt) file->ref_cnt--;
+    if(file->ref_cnt || file->ext_cnt) return;
+
+    if(file->listed) {
+        lv_fs_cached_file_t ** link = &cached_files;
+        while(*link != file) link = &(*link)->next;
+        *link = file->next;
+    }
+    lv_mem_free(file);
+}
+
+static lv_fs_cached_file_t * cached_file_find(lv_fs_drv_t * drv, const char * real_path)
+{
+    lv_fs_cached_file_t * file;
+    for(file = cached_files; file; file = file->next) {
+        if(file->drv == drv && strcmp(file->path, real_path) == 0) return file;
+    }
+
+    return NULL;
+}
+
+/**
+ * Drop the blocks of a file and let the next opening measure it again.
+ * The handles still open keep using the entry.
+ * @param file      the file's entry
+ */
+static void cached_file_drop(lv_fs_cached_file_t * file)
+{
+    /*Keep it while its blocks are freed*/
+    file->ref_cnt++;
+
+    lv_fs_cache_ext_t * ext = cache_lru_head;
+    while(ext && file->ext_cnt) {
+        lv_fs_cache_ext_t * next = ext->lru_next;
+        if(ext->file == file) cache_drop(ext);
+        ext = next;
+    }
+
+    lv_fs_cached_file_t ** link = &cached_files;
+    while(*link != file) link = &(*link)->next;
+    *link = file->next;
+    file->listed = false;
+
+    cached_file_release(file);
+}
+
+static lv_fs_res_t lv_fs_read_block_cached(lv_fs_file_t * file_p, uint8_t * buf, uint32_t btr, uint32_t * br)
+{
+    lv_fs_file_cache_t * cache = file_p->cache;
+    lv_fs_cached_file_t * file = cache->cached;
+    uint32_t pos = cache->file_position;
+    lv_fs_res_t res = LV_FS_RES_OK;
+
+    *br = 0;
+    if(pos >= file->size) return LV_FS_RES_OK;
+    btr = LV_MIN(btr, file->size - pos);
+
+    while(btr) {
+        uint32_t block = pos / BLOCK_SIZE;
+        uint32_t rn = 0;
+        lv_fs_cache_ext_t * ext;
+
+        /*Byte wise readers stay in the same extent, skip the lookup then*/
+        if(cache->last_ext && cache->last_evict_cnt == cache_generation && cache->last_ext->file == file &&
+           block >= cache->last_ext->block && block < cache->last_ext->block + cache->last_ext->block_cnt) {
+            ext = cache->last_ext;
+        }
+        else {
+            ext = cache_find(file, block);
+        }
+
+        if(ext) {
+            cache_stats.hit_cnt++;
+        }
+        else if(pos % BLOCK_SIZE == 0 && btr >= BLOCK_SIZE) {
+            /*Whole blocks which are not cached are read into `buf` directly, they would only evict the others*/
+            uint32_t block_cnt = 1;
+            while((block_cnt + 1) * BLOCK_SIZE <= btr && cache_find(file, block + block_cnt) == NULL) block_cnt++;
+
+            cache_stats.miss_cnt += block_cnt;
+            res = cache_drv_read(file_p, pos, buf, block_cnt * BLOCK_SIZE, &rn);
+            if(res != LV_FS_RES_OK) break;
+
+            cache->next_block = block + block_cnt;
+            buf += rn;
+            pos += rn;
+            btr -= rn;
+            *br += rn;
+            if(rn < block_cnt * BLOCK_SIZE) break;  /*The file got shorter*/
+            continue;
+        }
+        else {
+            cache_stats.miss_cnt++;
+            ext = cache_load(file_p, block, &res);
+            if(res != LV_FS_RES_OK) break;
+            if(ext == NULL) {
+                /*Out of memory, read the rest of the block without caching it*/
+                uint32_t part = LV_MIN(btr, BLOCK_SIZE - pos % BLOCK_SIZE);
+                res = cache_drv_read(file_p, pos, buf, part, &rn);
+                if(res != LV_FS_RES_OK || rn == 0) break;
+                buf += rn;
+                pos += rn;
+                btr -= rn;
+                *br += rn;
+                continue;
+            }
+        }
+
+        /*Make it the most recently used*/
+        if(ext != cache_lru_head) {
+            ext->lru_prev->lru_next = ext->lru_next;
+            if(ext->lru_next) ext->lru_next->lru_prev = ext->lru_prev;
+            else cache_lru_tail = ext->lru_prev;
+            ext->lru_prev = NULL;
+            ext->lru_next = cache_lru_head;
+            cache_lru_head->lru_prev = ext;
+            cache_lru_head = ext;
+        }
+        cache->last_ext = ext;
+        cache->last_evict_cnt = cache_generation;
+
+        uint32_t ofs = pos - ext->block * BLOCK_SIZE;
+        if(ofs >= ext->size) break;     /*The file got shorter*/
+
+        rn = LV_MIN(btr, ext->size - ofs);
+        lv_memcpy(buf, ext->data + ofs, rn);
+        cache->next_block = ext->block + ext->block_cnt;
+        buf += rn;
+        pos += rn;
+        btr -= rn;
+        *br += rn;
+    }
+
+    cache->file_position = pos;
+    return res;
+}
+
+static lv_fs_cache_ext_t * cache_find(lv_fs_cached_file_t * file, uint32_t block)
+{
+    lv_fs_cache_ext_t * ext;
+    for(ext = cache_buckets[cache_hash(file, block)]; ext; ext = ext->bucket_next) {
+        if(ext->file == file && block >= ext->block && block < ext->block + ext->block_cnt) return ext;
+    }
+
+    return NULL;
+}
+
+/**
+ * Read a block and the next ones if the file is read sequentially into a new extent
+ * @param file_p    the file to read
+ * @param block     the block which is needed
+ * @param res       store the driver's result here
+ * @return          the new extent, NULL on error or if out of memory
+ */
+static lv_fs_cache_ext_t * cache_load(lv_fs_file_t * file_p, uint32_t block, lv_fs_res_t * res)
+{
+    lv_fs_file_cache_t * cache = file_p->cache;
+    lv_fs_cached_file_t * file = cache->cached;
+
+    /*Double the read ahead on each miss of a sequential reader, restart from one block on a jump*/
+    if(block == cache->next_block) cache->read_ahead = LV_MIN(cache->read_ahead * 2, GROUP_BLOCKS);
+    else cache->read_ahead = 1;
+
+    /*Stay in the group, in the file and before the next cached block*/
+    uint32_t group_end = (block / GROUP_BLOCKS + 1) * GROUP_BLOCKS;
+    uint32_t file_end = (file->size + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    uint32_t end = LV_MIN3(block + cache->read_ahead, group_end, file_end);
+    uint32_t block_cnt = 1;
+    while(block + block_cnt < end && cache_find(file, block + block_cnt) == NULL) block_cnt++;
+
+    uint32_t size = LV_MIN((block + block_cnt) * BLOCK_SIZE, file->size) - block * BLOCK_SIZE;
+
+    /*Stay in the budget, then make room in the heap if needed*/
+    while(cache_lru_tail && cache_stats.size + size > LV_FS_BLOCK_CACHE_SIZE) {
+        cache_stats.evict_cnt += cache_lru_tail->block_cnt;
+        cache_drop(cache_lru_tail);
+    }
+
+    lv_fs_cache_ext_t * ext = lv_mem_alloc(sizeof(lv_fs_cache_ext_t) + size);
+    while(ext == NULL && cache_lru_tail) {
+        cache_stats.evict_cnt += cache_lru_tail->block_cnt;
+        cache_drop(cache_lru_tail);
+        ext = lv_mem_alloc(sizeof(lv_fs_cache_ext_t) + size);
+    }
+    if(ext == NULL) return NULL;
+
+    uint32_t rn;
+    *res = cache_drv_read(file_p, block * BLOCK_SIZE, ext->data, size, &rn);
+    if(*res != LV_FS_RES_OK || rn == 0) {
+        lv_mem_free(ext);
+        return NULL;
+    }
+
+    ext->file = file;
+    ext->block = block;
+    ext->block_cnt = block_cnt;
+    ext->size = rn;
+
+    uint32_t hash = cache_hash(file, block);
+    ext->bucket_next = cache_buckets[hash];
+    cache_buckets[hash] = ext;
+
+    ext->lru_prev = NULL;
+    ext->lru_next = cache_lru_head;
+    if(cache_lru_head) cache_lru_head->lru_prev = ext;
+    else cache_lru_tail = ext;
+    cache_lru_head = ext;
+
+    file->ext_cnt++;
+    cache_stats.size += rn;
+
+    return ext;
+}
+
+static void cache_drop(lv_fs_cache_ext_t * ext)
+{
+    lv_fs_cache_ext_t ** link = &cache_buckets[cache_hash(ext->file, ext->block)];
+    while(*link != ext) link = &(*link)->bucket_next;
+    *link = ext->bucket_next;
+
+    if(ext->lru_prev) ext->lru_prev->lru_next = ext->lru_next;
+    else cache_lru_head = ext->lru_next;
+    if(ext->lru_next) ext->lru_next->lru_prev = ext->lru_prev;
+    else cache_lru_tail = ext->lru_prev;
+
+    cache_stats.size -= ext->size;
+    cache_generation++;
+
+    lv_fs_cached_file_t * file = ext->file;
+    file->ext_cnt--;
+    lv_mem_free(ext);
+
+    /*A closed file without blocks is forgotten*/
+    if(file->ext_cnt == 0 && file->ref_cnt == 0) cached_file_release(file);
+}
+
+/**
+ * Read from the driver at a position. The driver seeks only if it's not there already.
+ */
+static lv_fs_res_t cache_drv_read(lv_fs_file_t * file_p, uint32_t pos, void * buf, uint32_t btr, uint32_t * br)
+{
+    lv_fs_file_cache_t * cache = file_p->cache;
+    lv_fs_drv_t * drv = file_p->drv;
+
+    *br = 0;
+    if(cache->drv_position != pos) {
+        cache->drv_position = UINT32_MAX;   /*Unknown if the seek fails*/
+        lv_fs_res_t res = drv->seek_cb(drv, file_p->file_d, pos, LV_FS_SEEK_SET);
+        if(res != LV_FS_RES_OK) return res;
+        cache->drv_position = pos;
+    }
+
+    lv_fs_res_t res = drv->read_cb(drv, file_p->file_d, buf, btr, br);
+    cache_stats.read_cnt++;
+    cache_stats.read_bytes += *br;
+    cache->drv_position = res == LV_FS_RES_OK ? pos + *br : UINT32_MAX;
+
+    return res;
+}
+
+static uint32_t cache_hash(const lv_fs_cached_file_t * file, uint32_t block)
+{
+    uint32_t key = (uint32_t)((uintptr_t)file >> 3) ^ ((block / GROUP_BLOCKS) * 2654435761U);
+    return (key ^ (key >> 16)) % BUCKET_CNT;
+}
+
+#endif /*LV_FS_BLOCK_CACHE_SIZE*/
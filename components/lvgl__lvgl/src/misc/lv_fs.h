@@ -92,6 +92,14 @@ typedef struct {
     uint32_t end;
     uint32_t file_position;
     void * buffer;
+#if LV_FS_BLOCK_CACHE_SIZE
+    struct _lv_fs_cached_file_t * cached;   /**< The file in the shared block cache, NULL: `buffer` caches the file*/
+    struct _lv_fs_cache_ext_t * last_ext;   /**< Where the last read was served from, valid while nothing is evicted*/
+    uint32_t last_evict_cnt;                /**< The eviction counter of the cache when `last_ext` was set*/
+    uint32_t drv_position;                  /**< The position of the driver's file, to skip needless seeks*/
+    uint32_t next_block;                    /**< The block after the last read one, a miss on it is sequential*/
+    uint16_t read_ahead;                    /**< Number of blocks to read on a sequential miss*/
+#endif
 } lv_fs_file_cache_t;
 
 typedef struct {
@@ -105,6 +113,17 @@ typedef struct {
     lv_fs_drv_t * drv;
 } lv_fs_dir_t;
 
+#if LV_FS_BLOCK_CACHE_SIZE
+typedef struct {
+    uint32_t hit_cnt;       /**< Blocks read from the cache*/
+    uint32_t miss_cnt;      /**< Blocks which had to be read from a driver*/
+    uint32_t read_cnt;      /**< `read_cb` calls for the cached files, including the reads bypassing the cache*/
+    uint32_t read_bytes;    /**< Bytes read by these calls*/
+    uint32_t evict_cnt;     /**< Blocks dropped to stay in the budget*/
+    uint32_t size;          /**< Bytes in the cache*/
+} lv_fs_cache_stats_t;
+#endif
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -198,6 +217,26 @@ lv_fs_res_t lv_fs_seek(lv_fs_file_t * file_p, uint32_t pos, lv_fs_whence_t whenc
  */
 lv_fs_res_t lv_fs_tell(lv_fs_file_t * file_p, uint32_t * pos);
 
+#if LV_FS_BLOCK_CACHE_SIZE
+/**
+ * Get the statistics of the block cache shared by the drivers with `cache_size > 0`
+ * @param stats     store the statistics here
+ */
+void lv_fs_cache_get_stats(lv_fs_cache_stats_t * stats);
+
+/**
+ * Zero the counters of the block cache. `size` is kept.
+ */
+void lv_fs_cache_reset_stats(void);
+
+/**
+ * Drop the cached blocks of a file, e.g. after it was changed not via `lv_fs`.
+ * Opening a file for writing does it automatically.
+ * @param path      path to the file beginning with the driver letter, NULL to drop all files
+ */
+void lv_fs_cache_invalidate(const char * path);
+#endif
+
 /**
  * Initialize a 'fs_dir_t' variable for directory reading
  * @param rddir_p   pointer to a 'lv_fs_dir_t' variable
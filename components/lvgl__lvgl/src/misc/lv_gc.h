@@ -19,6 +19,8 @@ extern "C" {
 #include "lv_ll.h"
 #include "lv_timer.h"
 #include "lv_types.h"
+#include "lv_parallel.h"
+#include "lv_lru.h"
 #include "../draw/lv_img_cache.h"
 #include "../draw/lv_draw_mask.h"
 #include "../core/lv_obj_pos.h"
@@ -32,6 +34,24 @@ extern "C" {
 #    define LV_IMG_CACHE_DEF            0
 #endif
 
+#if LV_DRAW_COMPLEX && LV_SHADOW_CACHE_SIZE
+#    define LV_SHADOW_CACHE_DEF         1
+#else
+#    define LV_SHADOW_CACHE_DEF         0
+#endif
+
+#if LV_OBJ_STYLE_CACHE_DEF_SIZE
+#    define LV_OBJ_STYLE_CACHE_DEF      1
+#else
+#    define LV_OBJ_STYLE_CACHE_DEF      0
+#endif
+
+#if LV_INDEV_HIT_INDEX_CELL_SIZE
+#    define LV_INDEV_HIT_INDEX_DEF      1
+#else
+#    define LV_INDEV_HIT_INDEX_DEF      0
+#endif
+
 #define LV_DISPATCH(f, t, n)            f(t, n)
 #define LV_DISPATCH_COND(f, t, n, m, v) LV_CONCAT3(LV_DISPATCH, m, v)(f, t, n)
 
@@ -49,16 +69,21 @@ extern "C" {
     LV_DISPATCH(f, lv_ll_t, _lv_group_ll)                                                              \
     LV_DISPATCH(f, lv_ll_t, _lv_img_decoder_ll)                                                        \
     LV_DISPATCH(f, lv_ll_t, _lv_obj_style_trans_ll)                                                    \
+    LV_DISPATCH_COND(f, void *, _lv_obj_style_cache, LV_OBJ_STYLE_CACHE_DEF, 1)                        \
+    LV_DISPATCH_COND(f, void *, _lv_indev_hit_index_list, LV_INDEV_HIT_INDEX_DEF, 1)                   \
     LV_DISPATCH(f, lv_layout_dsc_t *, _lv_layout_list)                                                 \
-    LV_DISPATCH_COND(f, _lv_img_cache_entry_t*, _lv_img_cache_array, LV_IMG_CACHE_DEF, 1)              \
-    LV_DISPATCH_COND(f, _lv_img_cache_entry_t, _lv_img_cache_single, LV_IMG_CACHE_DEF, 0)              \
+    LV_DISPATCH_COND(f, lv_lru_t*, _lv_img_cache_lru, LV_IMG_CACHE_DEF, 1)                             \
+    LV_DISPATCH_COND(f, LV_RENDER_TLS _lv_img_cache_entry_t, _lv_img_cache_single, LV_IMG_CACHE_DEF, 0) \
     LV_DISPATCH(f, lv_timer_t*, _lv_timer_act)                                                         \
-    LV_DISPATCH(f, lv_mem_buf_arr_t , lv_mem_buf)                                                      \
-    LV_DISPATCH_COND(f, _lv_draw_mask_radius_circle_dsc_arr_t , _lv_circle_cache, LV_DRAW_COMPLEX, 1)  \
-    LV_DISPATCH_COND(f, _lv_draw_mask_saved_arr_t , _lv_draw_mask_list, LV_DRAW_COMPLEX, 1)            \
+    LV_DISPATCH(f, lv_timer_t**, _lv_timer_heap) /*The timers ordered by their next run*/              \
+    LV_DISPATCH(f, LV_RENDER_TLS lv_mem_buf_arr_t , lv_mem_buf)                                        \
+    LV_DISPATCH_COND(f, LV_RENDER_TLS _lv_draw_mask_radius_circle_dsc_arr_t , _lv_circle_cache, LV_DRAW_COMPLEX, 1)  \
+    LV_DISPATCH_COND(f, LV_RENDER_TLS _lv_draw_mask_saved_arr_t , _lv_draw_mask_list, LV_DRAW_COMPLEX, 1)  \
     LV_DISPATCH(f, void * , _lv_theme_default_styles)                                                  \
     LV_DISPATCH(f, void * , _lv_theme_basic_styles)                                                  \
-    LV_DISPATCH_COND(f, uint8_t *, _lv_font_decompr_buf, LV_USE_FONT_COMPRESSED, 1)                    \
+    LV_DISPATCH_COND(f, LV_RENDER_TLS uint8_t *, _lv_font_decompr_buf, LV_USE_FONT_COMPRESSED, 1)      \
+    LV_DISPATCH_COND(f, lv_lru_t *, _lv_font_bitmap_cache, LV_USE_FONT_COMPRESSED, 1)                  \
+    LV_DISPATCH_COND(f, lv_lru_t *, _lv_draw_sw_shadow_cache, LV_SHADOW_CACHE_DEF, 1)                  \
     LV_DISPATCH(f, uint8_t * , _lv_grad_cache_mem)                                                     \
     LV_DISPATCH(f, uint8_t * , _lv_style_custom_prop_flag_lookup_table)
 
@@ -69,6 +94,9 @@ extern "C" {
 #if LV_MEM_CUSTOM != 1
 #error "GC requires CUSTOM_MEM"
 #endif /*LV_MEM_CUSTOM*/
+#if LV_USE_PARALLEL_RENDER
+#error "GC can't scan the thread local roots of LV_USE_PARALLEL_RENDER"
+#endif /*LV_USE_PARALLEL_RENDER*/
 #include LV_GC_INCLUDE
 #else  /*LV_ENABLE_GC*/
 #define LV_GC_ROOT(x) x
@@ -27,8 +27,9 @@ struct _lv_lru_item_t {
     void * key;
     size_t value_length;
     size_t key_length;
-    uint64_t access_count;
     struct _lv_lru_item_t * next;
+    struct _lv_lru_item_t * lru_prev;   /*Toward the most recently used*/
+    struct _lv_lru_item_t * lru_next;   /*Toward the least recently used*/
 };
 
 /**********************
@@ -51,6 +52,12 @@ static void lv_lru_remove_item(lv_lru_t * cache, lv_lru_item_t * prev, lv_lru_it
 /** pop an existing item off the free queue, or create a new one */
 static lv_lru_item_t * lv_lru_pop_or_create_item(lv_lru_t * cache);
 
+/** remove an item from the recency list */
+static void lv_lru_unlink(lv_lru_t * cache, lv_lru_item_t * item);
+
+/** make an item the most recently used one */
+static void lv_lru_touch(lv_lru_t * cache, lv_lru_item_t * item);
+
 /**********************
  *  STATIC VARIABLES
  **********************/
@@ -74,28 +81,28 @@ lv_lru_t * lv_lru_create(size_t cache_size, size_t average_length, lv_lru_free_t
                          lv_lru_free_t * key_free)
 {
     // create the cache
-    lv_lru_t * cache = (lv_lru_t *) lv_mem_alloc(sizeof(lv_lru_t));
-    lv_memset_00(cache, sizeof(lv_lru_t));
+    lv_lru_t * cache = (lv_lru_t *) lv_mem_cache_alloc(sizeof(lv_lru_t));
     if(!cache) {
         LV_LOG_WARN("LRU Cache unable to create cache object");
         return NULL;
     }
-    cache->hash_table_size = cache_size / average_length;
+    lv_memset_00(cache, sizeof(lv_lru_t));
+    cache->hash_table_size = LV_MAX(cache_size / average_length, 1);
     cache->average_item_length = average_length;
     cache->free_memory = cache_size;
     cache->total_memory = cache_size;
     cache->seed = lv_rand(1, UINT32_MAX);
-    cache->value_free = value_free ? value_free : lv_mem_free;
-    cache->key_free = key_free ? key_free : lv_mem_free;
+    cache->value_free = value_free ? value_free : lv_mem_cache_free;
+    cache->key_free = key_free ? key_free : lv_mem_cache_free;
 
     // size the hash table to a guestimate of the number of slots required (assuming a perfect hash)
-    cache->items = (lv_lru_item_t **) lv_mem_alloc(sizeof(lv_lru_item_t *) * cache->hash_table_size);
-    lv_memset_00(cache->items, sizeof(lv_lru_item_t *) * cache->hash_table_size);
+    cache->items = (lv_lru_item_t **) lv_mem_cache_alloc(sizeof(lv_lru_item_t *) * cache->hash_table_size);
     if(!cache->items) {
         LV_LOG_WARN("LRU Cache unable to create cache hash table");
-        lv_mem_free(cache);
+        lv_mem_cache_free(cache);
         return NULL;
     }
+    lv_memset_00(cache->items, sizeof(lv_lru_item_t *) * cache->hash_table_size);
     return cache;
 }
 
@@ -114,24 +121,24 @@ void lv_lru_del(lv_lru_t * cache)
                 cache->value_free(item->value);
                 cache->key_free(item->key);
                 cache->free_memory += item->value_length;
-                lv_mem_free(item);
+                lv_mem_cache_free(item);
                 item = next;
             }
         }
-        lv_mem_free(cache->items);
+        lv_mem_cache_free(cache->items);
     }
 
     if(cache->free_items) {
         item = cache->free_items;
         while(item) {
             next = (lv_lru_item_t *) item->next;
-            lv_mem_free(item);
+            lv_mem_cache_free(item);
             item = next;
         }
     }
 
     // free the cache
-    lv_mem_free(cache);
+    lv_mem_cache_free(cache);
 }
 
 lv_lru_res_t lv_lru_set(lv_lru_t * cache, const void * key, size_t key_length, void * value, size_t value_length)
@@ -164,7 +171,7 @@ lv_lru_res_t lv_lru_set(lv_lru_t * cache, const void * key, size_t key_length, v
         // insert a new item
         item = lv_lru_pop_or_create_item(cache);
         item->value = value;
-        item->key = lv_mem_alloc(key_length);
+        item->key = lv_mem_cache_alloc(key_length);
         memcpy(item->key, key, key_length);
         item->value_length = value_length;
         item->key_length = key_length;
@@ -175,11 +182,11 @@ lv_lru_res_t lv_lru_set(lv_lru_t * cache, const void * key, size_t key_length, v
         else
             cache->items[hash_index] = item;
     }
-    item->access_count = ++cache->access_count;
+    lv_lru_touch(cache, item);
 
-    // remove as many items as necessary to free enough space
+    // remove as many items as necessary to free enough space, the new item is the most recent so it stays
     if(required > 0 && (size_t) required > cache->free_memory) {
-        while(cache->free_memory < (size_t) required)
+        while(cache->free_memory < (size_t) required && cache->lru_oldest != item)
             lv_lru_remove_lru_item(cache);
     }
     cache->free_memory -= required;
@@ -200,7 +207,7 @@ lv_lru_res_t lv_lru_get(lv_lru_t * cache, const void * key, size_t key_size, voi
 
     if(item) {
         *value = item->value;
-        item->access_count = ++cache->access_count;
+        lv_lru_touch(cache, item);
     }
     else {
         *value = NULL;
@@ -233,30 +240,19 @@ lv_lru_res_t lv_lru_remove(lv_lru_t * cache, const void * key, size_t key_size)
 
 void lv_lru_remove_lru_item(lv_lru_t * cache)
 {
-    lv_lru_item_t * min_item = NULL, * min_prev = NULL;
-    lv_lru_item_t * item = NULL, * prev = NULL;
-    uint32_t i = 0, min_index = -1;
-    uint64_t min_access_count = -1;
-
-    for(; i < cache->hash_table_size; i++) {
-        item = cache->items[i];
-        prev = NULL;
-
-        while(item) {
-            if(item->access_count < min_access_count || (int64_t) min_access_count == -1) {
-                min_access_count = item->access_count;
-                min_item = item;
-                min_prev = prev;
-                min_index = i;
-            }
-            prev = item;
-            item = item->next;
-        }
+    lv_lru_item_t * item = cache->lru_oldest;
+    if(!item) return;
+
+    // the chain of the hash slot is walked only to find the previous item
+    uint32_t hash_index = lv_lru_hash(cache, item->key, item->key_length);
+    lv_lru_item_t * prev = NULL;
+    lv_lru_item_t * i = cache->items[hash_index];
+    while(i != item) {
+        prev = i;
+        i = i->next;
     }
 
-    if(min_item) {
-        lv_lru_remove_item(cache, min_prev, min_item, min_index);
-    }
+    lv_lru_remove_item(cache, prev, item, hash_index);
 }
 
 /**********************
@@ -316,6 +312,7 @@ static void lv_lru_remove_item(lv_lru_t * cache, lv_lru_item_t * prev, lv_lru_it
     else {
         cache->items[hash_index] = (lv_lru_item_t *) item->next;
     }
+    lv_lru_unlink(cache, item);
 
     // free memory and update the free memory counter
     cache->free_memory += item->value_length;
@@ -338,9 +335,32 @@ static lv_lru_item_t * lv_lru_pop_or_create_item(lv_lru_t * cache)
         lv_memset_00(item, sizeof(lv_lru_item_t));
     }
     else {
-        item = (lv_lru_item_t *) lv_mem_alloc(sizeof(lv_lru_item_t));
+        item = (lv_lru_item_t *) lv_mem_cache_alloc(sizeof(lv_lru_item_t));
         lv_memset_00(item, sizeof(lv_lru_item_t));
     }
 
     return item;
 }
+
+static void lv_lru_unlink(lv_lru_t * cache, lv_lru_item_t * item)
+{
+    if(item->lru_prev) item->lru_prev->lru_next = item->lru_next;
+    else if(cache->lru_newest == item) cache->lru_newest = item->lru_next;
+
+    if(item->lru_next) item->lru_next->lru_prev = item->lru_prev;
+    else if(cache->lru_oldest == item) cache->lru_oldest = item->lru_prev;
+
+    item->lru_prev = NULL;
+    item->lru_next = NULL;
+}
+
+static void lv_lru_touch(lv_lru_t * cache, lv_lru_item_t * item)
+{
+    if(cache->lru_newest == item) return;
+
+    lv_lru_unlink(cache, item);
+    item->lru_next = cache->lru_newest;
+    if(cache->lru_newest) cache->lru_newest->lru_prev = item;
+    cache->lru_newest = item;
+    if(cache->lru_oldest == NULL) cache->lru_oldest = item;
+}
@@ -43,7 +43,8 @@ typedef struct _lv_lru_item_t lv_lru_item_t;
 
 typedef struct lv_lru_t {
     lv_lru_item_t ** items;
-    uint64_t access_count;
+    lv_lru_item_t * lru_newest;     /*Head of the recency list*/
+    lv_lru_item_t * lru_oldest;     /*Tail of the recency list, evicted first*/
     size_t free_memory;
     size_t total_memory;
     size_t average_item_length;
@@ -72,7 +73,7 @@ lv_lru_res_t lv_lru_remove(lv_lru_t * cache, const void * key, size_t key_size);
 /**
  * remove the least recently used item
  *
- * @todo we can optimise this by finding the n lru items, where n = required_space / average_length
+ * The items are kept on a recency list so it's the tail of the list, no scan is required.
  */
 void lv_lru_remove_lru_item(lv_lru_t * cache);
 /**********************
@@ -10,6 +10,7 @@
 #include "lv_mem.h"
 #include "lv_tlsf.h"
 #include "lv_gc.h"
+#include "lv_parallel.h"
 #include "lv_assert.h"
 #include "lv_log.h"
 
@@ -21,6 +22,10 @@
     #include LV_MEM_POOL_INCLUDE
 #endif
 
+#ifdef LV_CACHE_MEM_INCLUDE
+    #include LV_CACHE_MEM_INCLUDE
+#endif
+
 /*********************
  *      DEFINES
  *********************/
@@ -39,9 +44,33 @@
 
 #define ZERO_MEM_SENTINEL  0xa1b2c3d4
 
+#if LV_MEM_CUSTOM == 0 && LV_MEM_SLAB_SIZE
+    #define USE_SLAB         1
+    #define SLAB_PAGE_SIZE   256
+    #define SLAB_PAGE_CNT    (LV_MEM_SLAB_SIZE / SLAB_PAGE_SIZE)
+    #define SLAB_MAX_SIZE    128
+    #define SLAB_CLASS_CNT   10
+    #define SLAB_NONE        0xFFFF
+    #if SLAB_PAGE_CNT == 0 || SLAB_PAGE_CNT >= SLAB_NONE
+        #error "LV_MEM_SLAB_SIZE should be at least 256 bytes and less than 16 MB"
+    #endif
+#else
+    #define USE_SLAB         0
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
+#if USE_SLAB
+/*A page of the slab holds the slots of one size class*/
+typedef struct {
+    void * free_head;   /*Free slots linked by their first bytes*/
+    uint16_t prev;      /*Neighbors in the list of partially used pages of the class or in the list of empty pages*/
+    uint16_t next;
+    uint8_t class_id;
+    uint8_t used_cnt;   /*Number of used slots, the page is empty if 0*/
+} slab_page_t;
+#endif
 
 /**********************
  *  STATIC PROTOTYPES
@@ -49,6 +78,16 @@
 #if LV_MEM_CUSTOM == 0
     static void lv_mem_walker(void * ptr, size_t size, int used, void * user);
 #endif
+#if USE_SLAB
+    static void slab_init(void);
+    static void * slab_alloc(size_t size);
+    static size_t slab_free(void * p);
+    static bool slab_is_own(const void * p);
+    static size_t slab_slot_size(const void * p);
+    static bool slab_check(void);
+    static void slab_list_push(uint16_t * head, uint16_t id);
+    static void slab_list_remove(uint16_t * head, uint16_t id);
+#endif
 
 /**********************
  *  STATIC VARIABLES
@@ -59,6 +98,19 @@
     static uint32_t max_used;
 #endif
 
+#if USE_SLAB
+    static uint8_t * slab_mem;
+    static slab_page_t slab_pages[SLAB_PAGE_CNT];
+    static uint16_t slab_partial[SLAB_CLASS_CNT];   /*Pages with free slots per class*/
+    static uint16_t slab_empty;                     /*Pages not used by any class*/
+    static uint32_t slab_fallback_cnt;
+
+    static const uint8_t slab_class_size[SLAB_CLASS_CNT] = {8, 16, 24, 32, 40, 48, 64, 80, 96, 128};
+
+    /*The smallest class for the sizes rounded up to 8 bytes*/
+    static const uint8_t slab_class_of[SLAB_MAX_SIZE / 8] = {0, 1, 2, 3, 4, 5, 6, 6, 7, 7, 8, 8, 9, 9, 9, 9};
+#endif
+
 static uint32_t zero_mem = ZERO_MEM_SENTINEL; /*Give the address of this variable if 0 byte should be allocated*/
 
 /**********************
@@ -100,6 +152,10 @@ void lv_mem_init(void)
 #endif
 #endif
 
+#if USE_SLAB
+    slab_init();
+#endif
+
 #if LV_MEM_ADD_JUNK
     LV_LOG_WARN("LV_MEM_ADD_JUNK is enabled which makes LVGL much slower");
 #endif
@@ -130,8 +186,14 @@ void * lv_mem_alloc(size_t size)
         return &zero_mem;
     }
 
+    _lv_parallel_lock();
 #if LV_MEM_CUSTOM == 0
+#if USE_SLAB
+    void * alloc = slab_alloc(size);
+    if(alloc == NULL) alloc = lv_tlsf_malloc(tlsf, size);
+#else
     void * alloc = lv_tlsf_malloc(tlsf, size);
+#endif
 #else
     void * alloc = LV_MEM_CUSTOM_ALLOC(size);
 #endif
@@ -159,6 +221,7 @@ void * lv_mem_alloc(size_t size)
 #endif
         MEM_TRACE("allocated at %p", alloc);
     }
+    _lv_parallel_unlock();
     return alloc;
 }
 
@@ -172,7 +235,20 @@ void lv_mem_free(void * data)
     if(data == &zero_mem) return;
     if(data == NULL) return;
 
+    _lv_parallel_lock();
 #if LV_MEM_CUSTOM == 0
+#if USE_SLAB
+    if(slab_is_own(data)) {
+#  if LV_MEM_ADD_JUNK
+        lv_memset(data, 0xbb, slab_slot_size(data));
+#  endif
+        size_t size = slab_free(data);
+        if(cur_used > size) cur_used -= size;
+        else cur_used = 0;
+        _lv_parallel_unlock();
+        return;
+    }
+#endif
 #  if LV_MEM_ADD_JUNK
     lv_memset(data, 0xbb, lv_tlsf_block_size(data));
 #  endif
@@ -182,6 +258,7 @@ void lv_mem_free(void * data)
 #else
     LV_MEM_CUSTOM_FREE(data);
 #endif
+    _lv_parallel_unlock();
 }
 
 /**
@@ -200,13 +277,33 @@ void * lv_mem_realloc(void * data_p, size_t new_size)
         return &zero_mem;
     }
 
-    if(data_p == &zero_mem) return lv_mem_alloc(new_size);
+    if(data_p == &zero_mem || data_p == NULL) return lv_mem_alloc(new_size);
+
+#if USE_SLAB
+    /*Slots can't grow, move the data to a larger class or to the pool*/
+    if(slab_is_own(data_p)) {
+        size_t slot_size = slab_slot_size(data_p);
+        if(new_size <= slot_size) return data_p;
+
+        void * new_p = lv_mem_alloc(new_size);
+        if(new_p == NULL) {
+            LV_LOG_ERROR("couldn't allocate memory");
+            return NULL;
+        }
+        lv_memcpy(new_p, data_p, slot_size);
+        lv_mem_free(data_p);
+        MEM_TRACE("allocated at %p", new_p);
+        return new_p;
+    }
+#endif
 
+    _lv_parallel_lock();
 #if LV_MEM_CUSTOM == 0
     void * new_p = lv_tlsf_realloc(tlsf, data_p, new_size);
 #else
     void * new_p = LV_MEM_CUSTOM_REALLOC(data_p, new_size);
 #endif
+    _lv_parallel_unlock();
     if(new_p == NULL) {
         LV_LOG_ERROR("couldn't allocate memory");
         return NULL;
@@ -216,6 +313,39 @@ void * lv_mem_realloc(void * data_p, size_t new_size)
     return new_p;
 }
 
+/**
+ * Allocate memory for a cache (shadows, glyphs, styles, LRU bookkeeping).
+ * It's allocated by `LV_CACHE_MEM_ALLOC` if it's defined, else by `lv_mem_alloc()`.
+ * @param size size of the memory to allocate in bytes
+ * @return pointer to the allocated memory, NULL on failure
+ */
+void * lv_mem_cache_alloc(size_t size)
+{
+#ifdef LV_CACHE_MEM_ALLOC
+    if(size == 0) return &zero_mem;
+
+    void * alloc = LV_CACHE_MEM_ALLOC(size);
+    if(alloc == NULL) LV_LOG_INFO("couldn't allocate cache memory (%lu bytes)", (unsigned long)size);
+    return alloc;
+#else
+    return lv_mem_alloc(size);
+#endif
+}
+
+/**
+ * Free a memory allocated by `lv_mem_cache_alloc()`
+ * @param data pointer to the memory
+ */
+void lv_mem_cache_free(void * data)
+{
+#ifdef LV_CACHE_MEM_ALLOC
+    if(data == &zero_mem || data == NULL) return;
+    LV_CACHE_MEM_FREE(data);
+#else
+    lv_mem_free(data);
+#endif
+}
+
 lv_res_t lv_mem_test(void)
 {
     if(zero_mem != ZERO_MEM_SENTINEL) {
@@ -234,6 +364,13 @@ lv_res_t lv_mem_test(void)
         return LV_RES_INV;
     }
 #endif
+
+#if USE_SLAB
+    if(!slab_check()) {
+        LV_LOG_WARN("slab failed");
+        return LV_RES_INV;
+    }
+#endif
     MEM_TRACE("passed");
     return LV_RES_OK;
 }
@@ -252,6 +389,36 @@ void lv_mem_monitor(lv_mem_monitor_t * mon_p)
 
     lv_tlsf_walk_pool(lv_tlsf_get_pool(tlsf), lv_mem_walker, mon_p);
 
+#if USE_SLAB
+    /*Count the objects of the slab instead of the slab itself*/
+    if(slab_mem) {
+        uint32_t used_page_size = 0;
+        uint32_t i;
+        for(i = 0; i < SLAB_PAGE_CNT; i++) {
+            slab_page_t * page = &slab_pages[i];
+            if(page->used_cnt == 0) {
+                mon_p->slab_free_size += SLAB_PAGE_SIZE;
+                continue;
+            }
+
+            uint32_t slot_size = slab_class_size[page->class_id];
+            uint32_t slot_cnt = SLAB_PAGE_SIZE / slot_size;
+            mon_p->slab_free_size += (slot_cnt - page->used_cnt) * slot_size;
+            mon_p->slab_used_cnt += page->used_cnt;
+            used_page_size += SLAB_PAGE_SIZE;
+        }
+
+        mon_p->slab_size = SLAB_PAGE_CNT * SLAB_PAGE_SIZE;
+        if(used_page_size) {
+            uint32_t free_in_used = mon_p->slab_free_size - (mon_p->slab_size - used_page_size);
+            mon_p->slab_frag_pct = (free_in_used * 100U) / used_page_size;
+        }
+        mon_p->used_cnt += mon_p->slab_used_cnt - 1;
+        mon_p->free_size += mon_p->slab_free_size;
+    }
+    mon_p->slab_fallback_cnt = slab_fallback_cnt;
+#endif
+
     mon_p->total_size = LV_MEM_SIZE;
     mon_p->used_pct = 100 - (100U * mon_p->free_size) / mon_p->total_size;
     if(mon_p->free_size > 0) {
@@ -563,3 +730,164 @@ static void lv_mem_walker(void * ptr, size_t size, int used, void * user)
     }
 }
 #endif
+
+#if USE_SLAB
+static void slab_init(void)
+{
+    slab_mem = lv_tlsf_malloc(tlsf, SLAB_PAGE_CNT * SLAB_PAGE_SIZE);
+    if(slab_mem == NULL) {
+        LV_LOG_WARN("couldn't allocate the slab, small objects will be allocated from the pool");
+    }
+
+    slab_empty = SLAB_NONE;
+    slab_fallback_cnt = 0;
+    uint32_t i;
+    for(i = 0; i < SLAB_CLASS_CNT; i++) {
+        slab_partial[i] = SLAB_NONE;
+    }
+
+    for(i = SLAB_PAGE_CNT; i > 0; i--) {
+        slab_pages[i - 1].used_cnt = 0;
+        slab_pages[i - 1].free_head = NULL;
+        slab_list_push(&slab_empty, i - 1);
+    }
+}
+
+/**
+ * Allocate a slot from the smallest class which fits `size`
+ * @param size      size in bytes
+ * @return          pointer to the slot or NULL if `size` is too large or the slab is full
+ */
+static void * slab_alloc(size_t size)
+{
+    if(slab_mem == NULL || size > SLAB_MAX_SIZE) return NULL;
+
+    uint8_t class_id = slab_class_of[(size - 1) >> 3];
+    if(slab_partial[class_id] == SLAB_NONE) {
+        if(slab_empty == SLAB_NONE) {
+            slab_fallback_cnt++;
+            return NULL;
+        }
+
+        /*Cut an empty page into slots*/
+        uint16_t id = slab_empty;
+        slab_list_remove(&slab_empty, id);
+
+        slab_page_t * page = &slab_pages[id];
+        uint32_t slot_size = slab_class_size[class_id];
+        uint8_t * slot = slab_mem + (uint32_t)id * SLAB_PAGE_SIZE;
+        uint32_t slot_cnt = SLAB_PAGE_SIZE / slot_size;
+        uint32_t i;
+        for(i = 0; i < slot_cnt - 1; i++) {
+            *(void **)slot = slot + slot_size;
+            slot += slot_size;
+        }
+        *(void **)slot = NULL;
+
+        page->free_head = slab_mem + (uint32_t)id * SLAB_PAGE_SIZE;
+        page->class_id = class_id;
+        page->used_cnt = 0;
+        slab_list_push(&slab_partial[class_id], id);
+    }
+
+    uint16_t id = slab_partial[class_id];
+    slab_page_t * page = &slab_pages[id];
+    void * p = page->free_head;
+    page->free_head = *(void **)p;
+    page->used_cnt++;
+
+    /*A full page is not searched for free slots*/
+    if(page->free_head == NULL) slab_list_remove(&slab_partial[class_id], id);
+
+    return p;
+}
+
+/**
+ * Give back a slot to its page
+ * @param p     pointer to the slot
+ * @return      size of the slot
+ */
+static size_t slab_free(void * p)
+{
+    uint16_t id = (uint16_t)(((uint8_t *)p - slab_mem) / SLAB_PAGE_SIZE);
+    slab_page_t * page = &slab_pages[id];
+    uint8_t class_id = page->class_id;
+
+    LV_ASSERT_MSG(page->used_cnt > 0, "Free of an unused slot");
+    LV_ASSERT_MSG((((uint8_t *)p - slab_mem) % SLAB_PAGE_SIZE) % slab_class_size[class_id] == 0,
+                  "Free of an invalid pointer");
+
+    if(page->free_head == NULL) slab_list_push(&slab_partial[class_id], id);
+
+    *(void **)p = page->free_head;
+    page->free_head = p;
+    page->used_cnt--;
+
+    /*Empty pages can be used by any class*/
+    if(page->used_cnt == 0) {
+        slab_list_remove(&slab_partial[class_id], id);
+        page->free_head = NULL;
+        slab_list_push(&slab_empty, id);
+    }
+
+    return slab_class_size[class_id];
+}
+
+static bool slab_is_own(const void * p)
+{
+    return slab_mem && (const uint8_t *)p >= slab_mem && (const uint8_t *)p < slab_mem + SLAB_PAGE_CNT * SLAB_PAGE_SIZE;
+}
+
+static size_t slab_slot_size(const void * p)
+{
+    uint16_t id = (uint16_t)(((const uint8_t *)p - slab_mem) / SLAB_PAGE_SIZE);
+    return slab_class_size[slab_pages[id].class_id];
+}
+
+/**
+ * Check that the free slots of every used page are in the page and add up with the used ones
+ * @return true: the slab is consistent
+ */
+static bool slab_check(void)
+{
+    if(slab_mem == NULL) return true;
+
+    uint32_t i;
+    for(i = 0; i < SLAB_PAGE_CNT; i++) {
+        slab_page_t * page = &slab_pages[i];
+        if(page->used_cnt == 0) continue;
+
+        uint32_t slot_size = slab_class_size[page->class_id];
+        uint32_t slot_cnt = SLAB_PAGE_SIZE / slot_size;
+        uint8_t * page_start = slab_mem + i * SLAB_PAGE_SIZE;
+        uint32_t free_cnt = 0;
+        uint8_t * slot;
+        for(slot = page->free_head; slot; slot = *(void **)slot) {
+            if(slot < page_start || slot >= page_start + slot_cnt * slot_size) return false;
+            if((slot - page_start) % slot_size) return false;
+            free_cnt++;
+            if(free_cnt > slot_cnt) return false;
+        }
+
+        if(free_cnt + page->used_cnt != slot_cnt) return false;
+    }
+
+    return true;
+}
+
+static void slab_list_push(uint16_t * head, uint16_t id)
+{
+    slab_pages[id].prev = SLAB_NONE;
+    slab_pages[id].next = *head;
+    if(*head != SLAB_NONE) slab_pages[*head].prev = id;
+    *head = id;
+}
+
+static void slab_list_remove(uint16_t * head, uint16_t id)
+{
+    slab_page_t * page = &slab_pages[id];
+    if(page->prev != SLAB_NONE) slab_pages[page->prev].next = page->next;
+    else *head = page->next;
+    if(page->next != SLAB_NONE) slab_pages[page->next].prev = page->prev;
+}
+#endif
@@ -35,12 +35,17 @@ extern "C" {
 typedef struct {
     uint32_t total_size; /**< Total heap size*/
     uint32_t free_cnt;
-    uint32_t free_size; /**< Size of available memory*/
+    uint32_t free_size; /**< Size of available memory (with the free slots of the slab)*/
     uint32_t free_biggest_size;
     uint32_t used_cnt;
     uint32_t max_used; /**< Max size of Heap memory used*/
+    uint32_t slab_size; /**< Size of the area for small objects, 0 if disabled*/
+    uint32_t slab_free_size; /**< Free slots and unused pages of the slab*/
+    uint32_t slab_used_cnt; /**< Number of objects in the slab*/
+    uint32_t slab_fallback_cnt; /**< Number of small objects allocated from the pool as the slab was full*/
     uint8_t used_pct; /**< Percentage used*/
     uint8_t frag_pct; /**< Amount of fragmentation*/
+    uint8_t slab_frag_pct; /**< Free slots of the used slab pages compared to the size of the pages*/
 } lv_mem_monitor_t;
 
 typedef struct {
@@ -88,6 +93,20 @@ void lv_mem_free(void * data);
  */
 void * lv_mem_realloc(void * data_p, size_t new_size);
 
+/**
+ * Allocate memory for a cache (shadows, glyphs, styles, LRU bookkeeping).
+ * It's allocated by `LV_CACHE_MEM_ALLOC` if it's defined, else by `lv_mem_alloc()`.
+ * @param size size of the memory to allocate in bytes
+ * @return pointer to the allocated memory, NULL on failure
+ */
+void * lv_mem_cache_alloc(size_t size);
+
+/**
+ * Free a memory allocated by `lv_mem_cache_alloc()`
+ * @param data pointer to the memory
+ */
+void lv_mem_cache_free(void * data);
+
 /**
  *
  * @return
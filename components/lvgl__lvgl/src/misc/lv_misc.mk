@@ -11,11 +11,13 @@ CSRCS += lv_log.c
 CSRCS += lv_lru.c
 CSRCS += lv_math.c
 CSRCS += lv_mem.c
+CSRCS += lv_parallel.c
 CSRCS += lv_printf.c
 CSRCS += lv_style.c
 CSRCS += lv_style_gen.c
 CSRCS += lv_timer.c
 CSRCS += lv_tlsf.c
+CSRCS += lv_trace.c
 CSRCS += lv_txt.c
 CSRCS += lv_txt_ap.c
 CSRCS += lv_utils.c
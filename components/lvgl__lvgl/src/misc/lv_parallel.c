@@ -0,0 +1,89 @@
+/**
+ * @file lv_parallel.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_parallel.h"
+#if LV_USE_PARALLEL_RENDER
+
+#include "lv_assert.h"
+#include "lv_mem.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_parallel_cb_t parallel_cb;
+static bool active;
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void lv_parallel_set_cb(const lv_parallel_cb_t * cb)
+{
+    LV_ASSERT_MSG(!active, "Can't change the worker while it's rendering");
+
+    if(cb) parallel_cb = *cb;
+    else lv_memset_00(&parallel_cb, sizeof(parallel_cb));
+}
+
+bool _lv_parallel_has_worker(void)
+{
+    return parallel_cb.start_cb && parallel_cb.wait_cb && parallel_cb.lock_cb && parallel_cb.unlock_cb;
+}
+
+bool _lv_parallel_start(lv_parallel_job_cb_t job_cb, void * param)
+{
+    if(!_lv_parallel_has_worker()) return false;
+
+    /*Set before starting the worker so both threads see it*/
+    active = true;
+    parallel_cb.start_cb(job_cb, param);
+    return true;
+}
+
+void _lv_parallel_wait(void)
+{
+    parallel_cb.wait_cb();
+    active = false;
+}
+
+bool _lv_parallel_is_active(void)
+{
+    return active;
+}
+
+void _lv_parallel_lock(void)
+{
+    if(active) parallel_cb.lock_cb();
+}
+
+void _lv_parallel_unlock(void)
+{
+    if(active) parallel_cb.unlock_cb();
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+#endif /*LV_USE_PARALLEL_RENDER*/
@@ -0,0 +1,119 @@
+/**
+ * @file lv_parallel.h
+ *
+ */
+
+#ifndef LV_PARALLEL_H
+#define LV_PARALLEL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../lv_conf_internal.h"
+
+#include <stdbool.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/*Storage class of the render state (draw masks, `lv_mem_buf_get()` buffers, blend caches, etc.)
+ *which both render threads need their own copy of*/
+#if LV_USE_PARALLEL_RENDER
+    #define LV_RENDER_TLS LV_PARALLEL_RENDER_TLS
+#else
+    #define LV_RENDER_TLS
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef void (*lv_parallel_job_cb_t)(void * param);
+
+/**
+ * Callbacks to render a part of the invalidated areas on a second thread.
+ * While both threads render, the heap and the shared caches are guarded by `lock_cb`/`unlock_cb`.
+ */
+typedef struct {
+    /**Start `job_cb(param)` on the worker thread (e.g. a task on the other core) and return without waiting*/
+    void (*start_cb)(lv_parallel_job_cb_t job_cb, void * param);
+
+    /**Wait until the job given to `start_cb` has returned*/
+    void (*wait_cb)(void);
+
+    /**Lock a recursive mutex*/
+    void (*lock_cb)(void);
+
+    /**Unlock the mutex of `lock_cb`*/
+    void (*unlock_cb)(void);
+} lv_parallel_cb_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+#if LV_USE_PARALLEL_RENDER
+
+/**
+ * Set the callbacks of the worker thread. Call it from the thread running `lv_timer_handler()`.
+ * @param cb    pointer to the callbacks (will be copied) or NULL to render on one thread
+ */
+void lv_parallel_set_cb(const lv_parallel_cb_t * cb);
+
+/**
+ * Tell whether a worker thread is set
+ * @return true: `_lv_parallel_start()` can be used
+ */
+bool _lv_parallel_has_worker(void);
+
+/**
+ * Start a job on the worker thread. Until `_lv_parallel_wait()` the locks are active.
+ * @param job_cb    the job to run
+ * @param param     parameter of `job_cb`
+ * @return          false if there is no worker thread
+ */
+bool _lv_parallel_start(lv_parallel_job_cb_t job_cb, void * param);
+
+/**
+ * Wait until the job started by `_lv_parallel_start()` has returned
+ */
+void _lv_parallel_wait(void);
+
+/**
+ * Tell whether the worker thread is rendering
+ * @return true: shared state must not be used without `_lv_parallel_lock()`
+ */
+bool _lv_parallel_is_active(void);
+
+/**
+ * Lock the shared state if the worker thread is rendering. Can be nested.
+ */
+void _lv_parallel_lock(void);
+
+/**
+ * Unlock the shared state locked by `_lv_parallel_lock()`
+ */
+void _lv_parallel_unlock(void);
+
+#else
+
+#define _lv_parallel_is_active() false
+#define _lv_parallel_lock()
+#define _lv_parallel_unlock()
+
+#endif /*LV_USE_PARALLEL_RENDER*/
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_PARALLEL_H*/
@@ -18,6 +18,9 @@
 #define IDLE_MEAS_PERIOD 500 /*[ms]*/
 #define DEF_PERIOD 500
 
+/*`heap_idx` of the paused timers which are not in the heap*/
+#define HEAP_IDX_NONE 0xFFFFFFFF
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -25,16 +28,29 @@
 /**********************
  *  STATIC PROTOTYPES
  **********************/
-static bool lv_timer_exec(lv_timer_t * timer);
-static uint32_t lv_timer_time_remaining(lv_timer_t * timer);
+static void lv_timer_exec(lv_timer_t * timer);
+static inline uint32_t heap_key(const lv_timer_t * timer, uint32_t now);
+static bool heap_less(const lv_timer_t * t1, const lv_timer_t * t2, uint32_t now);
+static void heap_set(uint32_t idx, lv_timer_t * timer);
+static void heap_sift_up(uint32_t idx, uint32_t now);
+static void heap_sift_down(uint32_t idx, uint32_t now);
+static bool heap_insert(lv_timer_t * timer);
+static void heap_remove(lv_timer_t * timer);
+static void heap_update(lv_timer_t * timer);
 
 /**********************
  *  STATIC VARIABLES
  **********************/
 static bool lv_timer_run = false;
 static uint8_t idle_last = 0;
-static bool timer_deleted;
-static bool timer_created;
+static uint32_t timer_id;
+
+/*`_lv_timer_heap` is a min-heap of the timers by their remaining time in the first `heap_cnt` elements.
+ *While `lv_timer_handler` runs, the timers which already ran in this call follow the heap
+ *up to `slot_cnt` so that they are not run again. Paused timers are not stored here.*/
+static uint32_t heap_cnt;
+static uint32_t slot_cnt;
+static uint32_t slot_max;
 
 /**********************
  *      MACROS
@@ -55,6 +71,10 @@ static bool timer_created;
 void _lv_timer_core_init(void)
 {
     _lv_ll_init(&LV_GC_ROOT(_lv_timer_ll), sizeof(lv_timer_t));
+    LV_GC_ROOT(_lv_timer_heap) = NULL;
+    heap_cnt = 0;
+    slot_cnt = 0;
+    slot_max = 0;
 
     /*Initially enable the lv_timer handling*/
     lv_timer_enable(true);
@@ -95,39 +115,32 @@ uint32_t LV_ATTRIBUTE_TIMER_HANDLER lv_timer_handler(void)
         }
     }
 
-    /*Run all timer from the list*/
-    lv_timer_t * next;
-    do {
-        timer_deleted             = false;
-        timer_created             = false;
-        LV_GC_ROOT(_lv_timer_act) = _lv_ll_get_head(&LV_GC_ROOT(_lv_timer_ll));
-        while(LV_GC_ROOT(_lv_timer_act)) {
-            /*The timer might be deleted if it runs only once ('repeat_count = 1')
-             *So get next element until the current is surely valid*/
-            next = _lv_ll_get_next(&LV_GC_ROOT(_lv_timer_ll), LV_GC_ROOT(_lv_timer_act));
-
-            if(lv_timer_exec(LV_GC_ROOT(_lv_timer_act))) {
-                /*If a timer was created or deleted then this or the next item might be corrupted*/
-                if(timer_created || timer_deleted) {
-                    TIMER_TRACE("Start from the first timer again because a timer was created or deleted");
-                    break;
-                }
-            }
-
-            LV_GC_ROOT(_lv_timer_act) = next; /*Load the next timer*/
-        }
-    } while(LV_GC_ROOT(_lv_timer_act));
+    /*Run the ready timers in the order of their remaining time. The timers which ran are moved
+     *behind the heap so they run only once even if they are ready again (e.g. with 0 period)*/
+    while(heap_cnt > 0) {
+        lv_timer_t * timer = LV_GC_ROOT(_lv_timer_heap)[0];
+        if(heap_key(timer, lv_tick_get()) > 0) break;
 
-    uint32_t time_till_next = LV_NO_TIMER_READY;
-    next = _lv_ll_get_head(&LV_GC_ROOT(_lv_timer_ll));
-    while(next) {
-        if(!next->paused) {
-            uint32_t delay = lv_timer_time_remaining(next);
-            if(delay < time_till_next)
-                time_till_next = delay;
-        }
+        heap_cnt--;
+        heap_set(0, LV_GC_ROOT(_lv_timer_heap)[heap_cnt]);
+        heap_set(heap_cnt, timer);
+        heap_sift_down(0, lv_tick_get());
+
+        /*The timer might be deleted by its callback. Then `_lv_timer_act` is cleared*/
+        LV_GC_ROOT(_lv_timer_act) = timer;
+        lv_timer_exec(timer);
+    }
+    LV_GC_ROOT(_lv_timer_act) = NULL;
+
+    /*Put the timers which ran back to the heap*/
+    while(heap_cnt < slot_cnt) {
+        heap_cnt++;
+        heap_sift_up(heap_cnt - 1, lv_tick_get());
+    }
 
-        next = _lv_ll_get_next(&LV_GC_ROOT(_lv_timer_ll), next); /*Find the next timer*/
+    uint32_t time_till_next = LV_NO_TIMER_READY;
+    if(heap_cnt > 0) {
+        time_till_next = heap_key(LV_GC_ROOT(_lv_timer_heap)[0], lv_tick_get());
     }
 
     busy_time += lv_tick_elaps(handler_start);
@@ -178,8 +191,13 @@ lv_timer_t * lv_timer_create(lv_timer_cb_t timer_xcb, uint32_t period, void * us
     new_timer->paused = 0;
     new_timer->last_run = lv_tick_get();
     new_timer->user_data = user_data;
+    new_timer->id = timer_id++;
 
-    timer_created = true;
+    if(!heap_insert(new_timer)) {
+        _lv_ll_remove(&LV_GC_ROOT(_lv_timer_ll), new_timer);
+        lv_mem_free(new_timer);
+        return NULL;
+    }
 
     return new_timer;
 }
@@ -200,8 +218,9 @@ void lv_timer_set_cb(lv_timer_t * timer, lv_timer_cb_t timer_cb)
  */
 void lv_timer_del(lv_timer_t * timer)
 {
+    heap_remove(timer);
     _lv_ll_remove(&LV_GC_ROOT(_lv_timer_ll), timer);
-    timer_deleted = true;
+    if(LV_GC_ROOT(_lv_timer_act) == timer) LV_GC_ROOT(_lv_timer_act) = NULL;
 
     lv_mem_free(timer);
 }
@@ -212,11 +231,15 @@ void lv_timer_del(lv_timer_t * timer)
  */
 void lv_timer_pause(lv_timer_t * timer)
 {
+    if(timer->paused) return;
+    heap_remove(timer);
     timer->paused = true;
 }
 
 void lv_timer_resume(lv_timer_t * timer)
 {
+    if(!timer->paused) return;
+    if(!heap_insert(timer)) return;
     timer->paused = false;
 }
 
@@ -228,6 +251,7 @@ void lv_timer_resume(lv_timer_t * timer)
 void lv_timer_set_period(lv_timer_t * timer, uint32_t period)
 {
     timer->period = period;
+    heap_update(timer);
 }
 
 /**
@@ -237,6 +261,7 @@ void lv_timer_set_period(lv_timer_t * timer, uint32_t period)
 void lv_timer_ready(lv_timer_t * timer)
 {
     timer->last_run = lv_tick_get() - timer->period - 1;
+    heap_update(timer);
 }
 
 /**
@@ -247,6 +272,7 @@ void lv_timer_ready(lv_timer_t * timer)
 void lv_timer_set_repeat_count(lv_timer_t * timer, int32_t repeat_count)
 {
     timer->repeat_count = repeat_count;
+    heap_update(timer);
 }
 
 /**
@@ -257,6 +283,7 @@ void lv_timer_set_repeat_count(lv_timer_t * timer, int32_t repeat_count)
 void lv_timer_reset(lv_timer_t * timer)
 {
     timer->last_run = lv_tick_get();
+    heap_update(timer);
 }
 
 /**
@@ -293,49 +320,180 @@ lv_timer_t * lv_timer_get_next(lv_timer_t * timer)
  **********************/
 
 /**
- * Execute timer if its remaining time is zero
+ * Execute a ready timer and delete it if its repeat count is over
  * @param timer pointer to lv_timer
- * @return true: execute, false: not executed
  */
-static bool lv_timer_exec(lv_timer_t * timer)
+static void lv_timer_exec(lv_timer_t * timer)
 {
-    if(timer->paused) return false;
-
-    bool exec = false;
-    if(lv_timer_time_remaining(timer) == 0) {
-        /* Decrement the repeat count before executing the timer_cb.
-         * If any timer is deleted `if(timer->repeat_count == 0)` is not executed below
-         * but at least the repeat count is zero and the timer can be deleted in the next round*/
-        int32_t original_repeat_count = timer->repeat_count;
-        if(timer->repeat_count > 0) timer->repeat_count--;
-        timer->last_run = lv_tick_get();
-        TIMER_TRACE("calling timer callback: %p", *((void **)&timer->timer_cb));
-        if(timer->timer_cb && original_repeat_count != 0) timer->timer_cb(timer);
-        TIMER_TRACE("timer callback %p finished", *((void **)&timer->timer_cb));
-        LV_ASSERT_MEM_INTEGRITY();
-        exec = true;
+    /* Decrement the repeat count before executing the timer_cb.
+     * A timer with zero repeat count is only deleted.*/
+    int32_t original_repeat_count = timer->repeat_count;
+    if(timer->repeat_count > 0) timer->repeat_count--;
+    timer->last_run = lv_tick_get();
+    TIMER_TRACE("calling timer callback: %p", *((void **)&timer->timer_cb));
+    if(timer->timer_cb && original_repeat_count != 0) timer->timer_cb(timer);
+    TIMER_TRACE("timer callback %p finished", *((void **)&timer->timer_cb));
+    LV_ASSERT_MEM_INTEGRITY();
+
+    /*The timer might be deleted by itself as well*/
+    if(LV_GC_ROOT(_lv_timer_act) == timer && timer->repeat_count == 0) {
+        TIMER_TRACE("deleting timer with %p callback because the repeat count is over", *((void **)&timer->timer_cb));
+        lv_timer_del(timer);
     }
+}
 
-    if(timer_deleted == false) { /*The timer might be deleted by itself as well*/
-        if(timer->repeat_count == 0) { /*The repeat count is over, delete the timer*/
-            TIMER_TRACE("deleting timer with %p callback because the repeat count is over", *((void **)&timer->timer_cb));
-            lv_timer_del(timer);
-        }
+/**
+ * Get the remaining time of a timer as the heap sees it
+ * @param timer pointer to a timer
+ * @param now the current tick
+ * @return the time remaining, 0 if it needs to be run or its repeat count is over
+ */
+static inline uint32_t heap_key(const lv_timer_t * timer, uint32_t now)
+{
+    /*The timers whose repeat count is over are ready to be deleted*/
+    if(timer->repeat_count == 0) return 0;
+
+    uint32_t elp = now - timer->last_run;
+    if(elp >= timer->period) return 0;
+    return timer->period - elp;
+}
+
+/**
+ * Tell whether a timer has to run before an other one
+ * @param t1 pointer to a timer
+ * @param t2 pointer to an other timer
+ * @param now the current tick
+ * @return true: `t1` has less time remaining. On a tie, the newer timer runs first
+ */
+static bool heap_less(const lv_timer_t * t1, const lv_timer_t * t2, uint32_t now)
+{
+    uint32_t r1 = heap_key(t1, now);
+    uint32_t r2 = heap_key(t2, now);
+    if(r1 != r2) return r1 < r2;
+    return (int32_t)(t1->id - t2->id) > 0;
+}
+
+/**
+ * Store a timer in a slot of the heap
+ * @param idx index of the slot
+ * @param timer pointer to a timer
+ */
+static void heap_set(uint32_t idx, lv_timer_t * timer)
+{
+    LV_GC_ROOT(_lv_timer_heap)[idx] = timer;
+    timer->heap_idx = idx;
+}
+
+/**
+ * Move a timer towards the root of the heap while it has to run before its parent
+ * @param idx index of the timer
+ * @param now the current tick
+ */
+static void heap_sift_up(uint32_t idx, uint32_t now)
+{
+    lv_timer_t ** heap = LV_GC_ROOT(_lv_timer_heap);
+    lv_timer_t * timer = heap[idx];
+    while(idx > 0) {
+        uint32_t parent = (idx - 1) / 2;
+        if(!heap_less(timer, heap[parent], now)) break;
+        heap_set(idx, heap[parent]);
+        idx = parent;
     }
+    heap_set(idx, timer);
+}
 
-    return exec;
+/**
+ * Move a timer towards the leaves of the heap while a child has to run before it
+ * @param idx index of the timer
+ * @param now the current tick
+ */
+static void heap_sift_down(uint32_t idx, uint32_t now)
+{
+    lv_timer_t ** heap = LV_GC_ROOT(_lv_timer_heap);
+    if(idx >= heap_cnt) return;
+
+    lv_timer_t * timer = heap[idx];
+    while(1) {
+        uint32_t child = idx * 2 + 1;
+        if(child >= heap_cnt) break;
+        if(child + 1 < heap_cnt && heap_less(heap[child + 1], heap[child], now)) child++;
+        if(!heap_less(heap[child], timer, now)) break;
+        heap_set(idx, heap[child]);
+        idx = child;
+    }
+    heap_set(idx, timer);
 }
 
 /**
- * Find out how much time remains before a timer must be run.
- * @param timer pointer to lv_timer
- * @return the time remaining, or 0 if it needs to be run again
+ * Add a timer to the heap
+ * @param timer pointer to a timer which is not in the heap
+ * @return false if there was not enough memory
  */
-static uint32_t lv_timer_time_remaining(lv_timer_t * timer)
+static bool heap_insert(lv_timer_t * timer)
 {
-    /*Check if at least 'period' time elapsed*/
-    uint32_t elp = lv_tick_elaps(timer->last_run);
-    if(elp >= timer->period)
-        return 0;
-    return timer->period - elp;
+    if(slot_cnt == slot_max) {
+        uint32_t new_max = slot_max ? slot_max * 2 : 8;
+        lv_timer_t ** new_heap = lv_mem_realloc(LV_GC_ROOT(_lv_timer_heap), new_max * sizeof(lv_timer_t *));
+        LV_ASSERT_MALLOC(new_heap);
+        if(new_heap == NULL) return false;
+        LV_GC_ROOT(_lv_timer_heap) = new_heap;
+        slot_max = new_max;
+    }
+
+    /*Make room at the end of the heap. The first timer which already ran is moved to the end.*/
+    if(heap_cnt < slot_cnt) heap_set(slot_cnt, LV_GC_ROOT(_lv_timer_heap)[heap_cnt]);
+    slot_cnt++;
+
+    heap_set(heap_cnt, timer);
+    heap_cnt++;
+    heap_sift_up(heap_cnt - 1, lv_tick_get());
+    return true;
+}
+
+/**
+ * Remove a timer from the heap or from the timers which already ran
+ * @param timer pointer to a timer
+ */
+static void heap_remove(lv_timer_t * timer)
+{
+    if(timer->paused) return;
+
+    lv_timer_t ** heap = LV_GC_ROOT(_lv_timer_heap);
+    uint32_t idx = timer->heap_idx;
+    LV_ASSERT(idx < slot_cnt && heap[idx] == timer);
+
+    if(idx >= heap_cnt) {
+        /*It already ran, fill its place with the last one*/
+        slot_cnt--;
+        if(idx != slot_cnt) heap_set(idx, heap[slot_cnt]);
+    }
+    else {
+        heap_cnt--;
+        if(idx != heap_cnt) {
+            lv_timer_t * moved = heap[heap_cnt];
+            heap_set(idx, moved);
+            uint32_t now = lv_tick_get();
+            heap_sift_up(idx, now);
+            if(moved->heap_idx == idx) heap_sift_down(idx, now);
+        }
+        /*Close the gap between the heap and the timers which already ran*/
+        slot_cnt--;
+        if(heap_cnt != slot_cnt) heap_set(heap_cnt, heap[slot_cnt]);
+    }
+    timer->heap_idx = HEAP_IDX_NONE;
+}
+
+/**
+ * Move a timer to its place in the heap after its remaining time has changed
+ * @param timer pointer to a timer
+ */
+static void heap_update(lv_timer_t * timer)
+{
+    /*The paused timers are not in the heap and the timers which already ran are added back later*/
+    if(timer->paused || timer->heap_idx >= heap_cnt) return;
+
+    uint32_t now = lv_tick_get();
+    uint32_t idx = timer->heap_idx;
+    heap_sift_up(idx, now);
+    if(timer->heap_idx == idx) heap_sift_down(idx, now);
 }
@@ -47,6 +47,8 @@ typedef struct _lv_timer_t {
     lv_timer_cb_t timer_cb; /**< Timer function*/
     void * user_data; /**< Custom user data*/
     int32_t repeat_count; /**< 1: One time;  -1 : infinity;  n>0: residual times*/
+    uint32_t heap_idx; /**< Position in the scheduler's heap (internal)*/
+    uint32_t id; /**< Creation order to run the timers ready at the same time newest first (internal)*/
     uint32_t paused : 1;
 } lv_timer_t;
 
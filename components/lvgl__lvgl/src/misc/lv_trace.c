@@ -0,0 +1,219 @@
+/**
+ * @file lv_trace.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_trace.h"
+#if LV_USE_TRACE
+
+#include "lv_assert.h"
+#include "lv_mem.h"
+#include "lv_math.h"
+#include "lv_printf.h"
+#include "../hal/lv_hal_tick.h"
+#include LV_TRACE_TIME_INCLUDE
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    uint32_t start_us;
+    uint32_t dur_us;
+    uint8_t stage;
+} trace_event_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static uint32_t get_bucket(uint32_t dur_us);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_trace_stats_t stats[_LV_TRACE_STAGE_NUM];
+static uint32_t start_us[_LV_TRACE_STAGE_NUM];
+static uint8_t depth[_LV_TRACE_STAGE_NUM];
+
+#if LV_TRACE_EVENT_CNT
+    static trace_event_t events[LV_TRACE_EVENT_CNT];
+    static uint32_t event_cnt;      /*Number of all events, the last LV_TRACE_EVENT_CNT are kept*/
+#endif
+
+static const char * stage_names[_LV_TRACE_STAGE_NUM] = {
+    "frame", "layout", "style", "render", "sync", "flush", "flush_wait", "user"
+};
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void lv_trace_begin(lv_trace_stage_t stage)
+{
+    LV_ASSERT(stage < _LV_TRACE_STAGE_NUM);
+
+    if(depth[stage] == 0) start_us[stage] = LV_TRACE_TIME_EXPR;
+    if(depth[stage] < UINT8_MAX) depth[stage]++;
+}
+
+void lv_trace_end(lv_trace_stage_t stage)
+{
+    LV_ASSERT(stage < _LV_TRACE_STAGE_NUM);
+
+    if(depth[stage] == 0) return;
+    depth[stage]--;
+    if(depth[stage]) return;
+
+    uint32_t dur_us = (uint32_t)(LV_TRACE_TIME_EXPR) - start_us[stage];
+
+    lv_trace_stats_t * s = &stats[stage];
+    if(s->cnt == 0 || dur_us < s->min_us) s->min_us = dur_us;
+    if(dur_us > s->max_us) s->max_us = dur_us;
+    s->cnt++;
+    s->sum_us += dur_us;
+    s->hist[get_bucket(dur_us)]++;
+
+#if LV_TRACE_EVENT_CNT
+    trace_event_t * e = &events[event_cnt % LV_TRACE_EVENT_CNT];
+    e->start_us = start_us[stage];
+    e->dur_us = dur_us;
+    e->stage = stage;
+    event_cnt++;
+#endif
+}
+
+void lv_trace_cancel(lv_trace_stage_t stage)
+{
+    LV_ASSERT(stage < _LV_TRACE_STAGE_NUM);
+
+    if(depth[stage]) depth[stage]--;
+}
+
+void lv_trace_reset(void)
+{
+    lv_memset_00(stats, sizeof(stats));
+#if LV_TRACE_EVENT_CNT
+    event_cnt = 0;
+#endif
+}
+
+void lv_trace_get_stats(lv_trace_stage_t stage, lv_trace_stats_t * stats_res)
+{
+    LV_ASSERT(stage < _LV_TRACE_STAGE_NUM);
+
+    *stats_res = stats[stage];
+}
+
+const char * lv_trace_stage_get_name(lv_trace_stage_t stage)
+{
+    if(stage >= _LV_TRACE_STAGE_NUM) return "";
+    return stage_names[stage];
+}
+
+uint32_t lv_trace_stats_get_percentile(const lv_trace_stats_t * s, uint32_t pct)
+{
+    if(s->cnt == 0) return 0;
+
+    /*The number of durations which are not longer than the percentile*/
+    uint64_t limit = ((uint64_t)s->cnt * LV_MIN(pct, 100) + 99) / 100;
+    if(limit == 0) limit = 1;
+
+    uint64_t sum = 0;
+    uint32_t i;
+    for(i = 0; i < LV_TRACE_HIST_BUCKETS - 1; i++) {
+        sum += s->hist[i];
+        if(sum >= limit) return LV_MIN((2U << i) - 1, s->max_us);
+    }
+
+    return s->max_us;
+}
+
+uint32_t lv_trace_dump(char * buf, uint32_t buf_size)
+{
+    if(buf_size == 0) return 0;
+
+    buf[0] = '\0';
+    uint32_t len = 0;
+    uint32_t i;
+    for(i = 0; i < _LV_TRACE_STAGE_NUM && len < buf_size - 1; i++) {
+        const lv_trace_stats_t * s = &stats[i];
+        if(s->cnt == 0) continue;
+
+        int res = lv_snprintf(buf + len, buf_size - len,
+                              "%s: %u x, avg %u us, min %u us, p50 %u us, p90 %u us, p99 %u us, max %u us\n",
+                              stage_names[i], (unsigned)s->cnt, (unsigned)(s->sum_us / s->cnt), (unsigned)s->min_us,
+                              (unsigned)lv_trace_stats_get_percentile(s, 50),
+                              (unsigned)lv_trace_stats_get_percentile(s, 90),
+                              (unsigned)lv_trace_stats_get_percentile(s, 99), (unsigned)s->max_us);
+        if(res < 0) break;
+        len = LV_MIN(len + (uint32_t)res, buf_size - 1);
+    }
+
+    return len;
+}
+
+uint32_t lv_trace_export_chrome(lv_trace_write_cb_t write_cb, void * user_data)
+{
+    static const char header[] = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    static const char footer[] = "\n]}\n";
+
+    write_cb(header, sizeof(header) - 1, user_data);
+
+    uint32_t written = 0;
+#if LV_TRACE_EVENT_CNT
+    uint32_t first = event_cnt > LV_TRACE_EVENT_CNT ? event_cnt - LV_TRACE_EVENT_CNT : 0;
+
+    /*The timestamps are relative to the earliest start so they don't overflow.
+     *The outer stages are logged after the inner ones so the first event is not always the earliest.*/
+    uint32_t ref = events[first % LV_TRACE_EVENT_CNT].start_us;
+    int32_t min_d = 0;
+    uint32_t i;
+    for(i = first; i < event_cnt; i++) {
+        int32_t d = (int32_t)(events[i % LV_TRACE_EVENT_CNT].start_us - ref);
+        if(d < min_d) min_d = d;
+    }
+
+    for(i = first; i < event_cnt; i++) {
+        const trace_event_t * e = &events[i % LV_TRACE_EVENT_CNT];
+        char line[128];
+        int len = lv_snprintf(line, sizeof(line),
+                              "%s\n{\"name\":\"%s\",\"cat\":\"lvgl\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%u,\"dur\":%u}",
+                              written ? "," : "", stage_names[e->stage], (unsigned)((int32_t)(e->start_us - ref) - min_d),
+                              (unsigned)e->dur_us);
+        if(len <= 0) continue;
+        write_cb(line, LV_MIN((uint32_t)len, sizeof(line) - 1), user_data);
+        written++;
+    }
+#endif
+
+    write_cb(footer, sizeof(footer) - 1, user_data);
+
+    return written;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static uint32_t get_bucket(uint32_t dur_us)
+{
+    uint32_t i = 0;
+    while(dur_us > 1 && i < LV_TRACE_HIST_BUCKETS - 1) {
+        dur_us >>= 1;
+        i++;
+    }
+
+    return i;
+}
+
+#endif /*LV_USE_TRACE*/
@@ -0,0 +1,151 @@
+/**
+ * @file lv_trace.h
+ * Durations of the refresh stages with histograms and a log of the last events
+ */
+
+#ifndef LV_TRACE_H
+#define LV_TRACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../lv_conf_internal.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/*hist[i] counts the durations in [2^i, 2^(i+1)) us, the last one the longer ones too*/
+#define LV_TRACE_HIST_BUCKETS   20
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**
+ * The measured stages. The outer stages include the inner ones,
+ * e.g. the rendering includes the flushes and the flushes the waits for the display.
+ */
+typedef enum {
+    LV_TRACE_STAGE_FRAME,       /**< A refresh of a display which drew something*/
+    LV_TRACE_STAGE_LAYOUT,      /**< Update of the layouts before the refresh*/
+    LV_TRACE_STAGE_STYLE,       /**< Refresh of the objects after their styles changed*/
+    LV_TRACE_STAGE_RENDER,      /**< Drawing of the invalidated areas*/
+    LV_TRACE_STAGE_SYNC,        /**< Copy of the areas between the buffers in double buffered direct mode*/
+    LV_TRACE_STAGE_FLUSH,       /**< `flush_cb` of the display driver*/
+    LV_TRACE_STAGE_FLUSH_WAIT,  /**< Waiting for the display to take a buffer (flushing, vsync)*/
+    LV_TRACE_STAGE_USER,        /**< Free for the application*/
+    _LV_TRACE_STAGE_NUM
+} lv_trace_stage_t;
+
+typedef struct {
+    uint32_t cnt;       /**< Number of the measured durations*/
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t sum_us;
+    uint32_t hist[LV_TRACE_HIST_BUCKETS];
+} lv_trace_stats_t;
+
+/**
+ * Write a part of an export
+ * @param str       text to write, not '\0' terminated
+ * @param len       length of `str`
+ * @param user_data the `user_data` given to the export function
+ */
+typedef void (*lv_trace_write_cb_t)(const char * str, uint32_t len, void * user_data);
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+#if LV_USE_TRACE
+
+/**
+ * Start to measure a stage. Nested calls of the same stage are measured once, from the outermost.
+ * @param stage     the stage
+ */
+void lv_trace_begin(lv_trace_stage_t stage);
+
+/**
+ * Finish the measurement of a stage and add its duration to the histogram and the event log
+ * @param stage     the stage
+ */
+void lv_trace_end(lv_trace_stage_t stage);
+
+/**
+ * Drop the measurement of a stage started by `lv_trace_begin()`
+ * @param stage     the stage
+ */
+void lv_trace_cancel(lv_trace_stage_t stage);
+
+/**
+ * Clear the histograms and the event log
+ */
+void lv_trace_reset(void);
+
+/**
+ * Get the statistics of a stage
+ * @param stage     the stage
+ * @param stats     store the statistics here
+ */
+void lv_trace_get_stats(lv_trace_stage_t stage, lv_trace_stats_t * stats);
+
+/**
+ * Get the name of a stage
+ * @param stage     the stage
+ * @return          e.g. "render"
+ */
+const char * lv_trace_stage_get_name(lv_trace_stage_t stage);
+
+/**
+ * Estimate a percentile of the durations from the histogram
+ * @param stats     statistics of a stage
+ * @param pct       the percentile [0..100]
+ * @return          the upper limit of the bucket of the percentile in us, limited to the max. duration
+ */
+uint32_t lv_trace_stats_get_percentile(const lv_trace_stats_t * stats, uint32_t pct);
+
+/**
+ * Print the statistics of the measured stages, a line per stage
+ * @param buf       buffer for the text
+ * @param buf_size  size of `buf`, the text is cut if it's too small
+ * @return          length of the text without the closing '\0'
+ */
+uint32_t lv_trace_dump(char * buf, uint32_t buf_size);
+
+/**
+ * Write the event log as a Chrome trace JSON (open it in chrome://tracing or Perfetto)
+ * @param write_cb  called with the parts of the JSON text
+ * @param user_data passed to `write_cb`
+ * @return          number of the written events
+ */
+uint32_t lv_trace_export_chrome(lv_trace_write_cb_t write_cb, void * user_data);
+
+#define LV_TRACE_BEGIN(stage)   lv_trace_begin(stage)
+#define LV_TRACE_END(stage)     lv_trace_end(stage)
+#define LV_TRACE_CANCEL(stage)  lv_trace_cancel(stage)
+
+#else
+
+#define LV_TRACE_BEGIN(stage)
+#define LV_TRACE_END(stage)
+#define LV_TRACE_CANCEL(stage)
+
+#endif /*LV_USE_TRACE*/
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_TRACE_H*/
@@ -379,6 +379,112 @@ lv_coord_t lv_txt_get_width(const char * txt, uint32_t length, const lv_font_t *
     return width;
 }
 
+void _lv_txt_layout_init(lv_txt_layout_t * layout)
+{
+    lv_memset_00(layout, sizeof(lv_txt_layout_t));
+}
+
+bool _lv_txt_layout_update(lv_txt_layout_t * layout, const char * txt, const lv_font_t * font,
+                           lv_coord_t letter_space, lv_coord_t max_width, lv_text_flag_t flag)
+{
+    if(_lv_txt_layout_is_valid(layout, txt, font, letter_space, max_width, flag)) return true;
+
+    layout->valid = 0;
+    if(txt == NULL || font == NULL) return false;
+
+    /*Break the lines exactly as `lv_txt_get_size()` and the label drawing do*/
+    uint32_t line_cnt = 0;
+    uint32_t line_start = 0;
+    while(1) {
+        /*Keep place for the closing item too*/
+        if(line_cnt >= layout->line_alloc) {
+            uint32_t new_alloc = layout->line_alloc ? layout->line_alloc * 2 : 8;
+            lv_txt_line_t * new_lines = lv_mem_realloc(layout->lines, new_alloc * sizeof(lv_txt_line_t));
+            if(new_lines == NULL) {
+                _lv_txt_layout_free(layout);
+                return false;
+            }
+            layout->lines = new_lines;
+            layout->line_alloc = new_alloc;
+        }
+
+        layout->lines[line_cnt].start = line_start;
+        layout->lines[line_cnt].w = 0;
+        if(txt[line_start] == '\0') break;
+
+        uint32_t line_end = line_start + _lv_txt_get_next_line(&txt[line_start], font, letter_space, max_width, NULL, flag);
+        layout->lines[line_cnt].w = lv_txt_get_width(&txt[line_start], line_end - line_start, font, letter_space, flag);
+        line_start = line_end;
+        line_cnt++;
+    }
+
+    layout->line_cnt = line_cnt;
+    layout->txt = txt;
+    layout->font = font;
+    layout->letter_space = letter_space;
+    layout->max_width = max_width;
+    layout->flag = flag;
+    layout->valid = 1;
+
+    return true;
+}
+
+bool _lv_txt_layout_is_valid(const lv_txt_layout_t * layout, const char * txt, const lv_font_t * font,
+                             lv_coord_t letter_space, lv_coord_t max_width, lv_text_flag_t flag)
+{
+    if(!layout->valid) return false;
+    if(layout->txt != txt || layout->font != font || layout->flag != flag) return false;
+    if(layout->letter_space != letter_space) return false;
+
+    /*The width doesn't matter if the lines are broken only at new line characters*/
+    if((flag & LV_TEXT_FLAG_EXPAND) || (flag & LV_TEXT_FLAG_FIT)) return true;
+
+    return layout->max_width == max_width;
+}
+
+void _lv_txt_layout_get_size(const lv_txt_layout_t * layout, lv_coord_t line_space, lv_point_t * size_res)
+{
+    size_res->x = 0;
+    size_res->y = 0;
+
+    uint16_t letter_height = lv_font_get_line_height(layout->font);
+
+    uint32_t i;
+    for(i = 0; i < layout->line_cnt; i++) {
+        if((unsigned long)size_res->y + (unsigned long)letter_height + (unsigned long)line_space > LV_MAX_OF(lv_coord_t)) {
+            LV_LOG_WARN("_lv_txt_layout_get_size: integer overflow while calculating text height");
+            return;
+        }
+
+        size_res->y += letter_height;
+        size_res->y += line_space;
+        size_res->x = LV_MAX(layout->lines[i].w, size_res->x);
+    }
+
+    /*Make the text one line taller if the last character is '\n' or '\r'*/
+    uint32_t len = layout->lines[layout->line_cnt].start;
+    if((len != 0) && (layout->txt[len - 1] == '\n' || layout->txt[len - 1] == '\r')) {
+        size_res->y += letter_height + line_space;
+    }
+
+    /*Correction with the last line space or set the height manually if the text is empty*/
+    if(size_res->y == 0)
+        size_res->y = letter_height;
+    else
+        size_res->y -= line_space;
+}
+
+void _lv_txt_layout_invalidate(lv_txt_layout_t * layout)
+{
+    layout->valid = 0;
+}
+
+void _lv_txt_layout_free(lv_txt_layout_t * layout)
+{
+    lv_mem_free(layout->lines);
+    _lv_txt_layout_init(layout);
+}
+
 bool _lv_txt_is_cmd(lv_text_cmd_state_t * state, uint32_t c)
 {
     bool ret = false;
@@ -65,6 +65,28 @@ enum {
 };
 typedef uint8_t lv_text_align_t;
 
+/** A line of a text in `lv_txt_layout_t`*/
+typedef struct {
+    uint32_t start;     /**< Byte index of the first character of the line*/
+    lv_coord_t w;       /**< Width of the line as `lv_txt_get_width()` returns it*/
+} lv_txt_line_t;
+
+/**
+ * Line breaks of a text and the parameters they were calculated with.
+ * Used to not break and measure the same text again and again when it's drawn or its size is needed.
+ */
+typedef struct {
+    lv_txt_line_t * lines;      /**< `line_cnt + 1` lines, the `start` of the last one is the length of the text*/
+    uint32_t line_cnt;
+    uint32_t line_alloc;        /**< Number of allocated items in `lines`*/
+    const char * txt;
+    const lv_font_t * font;
+    lv_coord_t max_width;
+    lv_coord_t letter_space;
+    lv_text_flag_t flag;
+    uint8_t valid : 1;
+} lv_txt_layout_t;
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -112,6 +134,82 @@ uint32_t _lv_txt_get_next_line(const char * txt, const lv_font_t * font, lv_coor
 lv_coord_t lv_txt_get_width(const char * txt, uint32_t length, const lv_font_t * font, lv_coord_t letter_space,
                             lv_text_flag_t flag);
 
+/**
+ * Initialize an empty text layout
+ * @param layout pointer to a text layout
+ */
+void _lv_txt_layout_init(lv_txt_layout_t * layout);
+
+/**
+ * Break a text to lines and measure them if the layout is not valid for the text and the parameters yet.
+ * The parameters are the same as in `_lv_txt_get_next_line()`.
+ * @param layout pointer to a text layout
+ * @param txt a '\0' terminated string
+ * @param font pointer to a font
+ * @param letter_space letter space
+ * @param max_width max width of the text (break the lines to fit this size). Set COORD_MAX to avoid
+ * line breaks
+ * @param flag settings for the text from 'txt_flag_type' enum
+ * @return true: the layout is valid; false: out of memory, the layout can't be used
+ */
+bool _lv_txt_layout_update(lv_txt_layout_t * layout, const char * txt, const lv_font_t * font,
+                           lv_coord_t letter_space, lv_coord_t max_width, lv_text_flag_t flag);
+
+/**
+ * Check if a layout was created with the given text and parameters
+ * @param layout pointer to a text layout
+ * @param txt a '\0' terminated string
+ * @param font pointer to a font
+ * @param letter_space letter space
+ * @param max_width max width of the text
+ * @param flag settings for the text from 'txt_flag_type' enum
+ * @return true: the lines of the layout can be used
+ */
+bool _lv_txt_layout_is_valid(const lv_txt_layout_t * layout, const char * txt, const lv_font_t * font,
+                             lv_coord_t letter_space, lv_coord_t max_width, lv_text_flag_t flag);
+
+/**
+ * Get the size of the text of a valid layout. The result is the same as `lv_txt_get_size()`'s.
+ * @param layout pointer to a valid text layout
+ * @param line_space line space of the text
+ * @param size_res pointer to a 'point_t' variable to store the result
+ */
+void _lv_txt_layout_get_size(const lv_txt_layout_t * layout, lv_coord_t line_space, lv_point_t * size_res);
+
+/**
+ * Mark a layout as invalid, e.g. because its text has been changed. The next update will break the text again.
+ * @param layout pointer to a text layout
+ */
+void _lv_txt_layout_invalidate(lv_txt_layout_t * layout);
+
+/**
+ * Free the lines of a layout
+ * @param layout pointer to a text layout
+ */
+void _lv_txt_layout_free(lv_txt_layout_t * layout);
+
+/**
+ * Get the byte index where a line of a valid layout starts
+ * @param layout pointer to a valid text layout
+ * @param line_id index of the line. With `line_cnt` or larger the length of the text is returned.
+ * @return byte index of the first character of the line
+ */
+static inline uint32_t _lv_txt_layout_get_line_start(const lv_txt_layout_t * layout, uint32_t line_id)
+{
+    return layout->lines[line_id < layout->line_cnt ? line_id : layout->line_cnt].start;
+}
+
+/**
+ * Get the width of a line of a valid layout
+ * @param layout pointer to a valid text layout
+ * @param line_id index of the line
+ * @return width of the line or 0 if `line_id` is after the last line
+ */
+static inline lv_coord_t _lv_txt_layout_get_line_width(const lv_txt_layout_t * layout, uint32_t line_id)
+{
+    return line_id < layout->line_cnt ? layout->lines[line_id].w : 0;
+}
+
 /**
  * Check next character in a string and decide if the character is part of the command or not
  * @param state pointer to a txt_cmd_state_t variable which stores the current state of command
@@ -17,6 +17,7 @@
 #include "../misc/lv_bidi.h"
 #include "../misc/lv_txt_ap.h"
 #include "../misc/lv_printf.h"
+#include "../misc/lv_parallel.h"
 
 /*********************
  *      DEFINES
@@ -48,6 +49,10 @@ static char * lv_label_get_dot_tmp(lv_obj_t * label);
 static void lv_label_dot_tmp_free(lv_obj_t * label);
 static void set_ofs_x_anim(void * obj, int32_t v);
 static void set_ofs_y_anim(void * obj, int32_t v);
+static const lv_txt_layout_t * get_layout(lv_obj_t * obj, const lv_font_t * font, lv_coord_t letter_space,
+                                          lv_coord_t max_w, lv_text_flag_t flag);
+static void invalidate_layout(lv_obj_t * obj);
+static bool is_same_text(lv_obj_t * obj, const char * text);
 
 /**********************
  *  STATIC VARIABLES
@@ -87,12 +92,13 @@ void lv_label_set_text(lv_obj_t * obj, const char * text)
     LV_ASSERT_OBJ(obj, MY_CLASS);
     lv_label_t * label = (lv_label_t *)obj;
 
-    lv_obj_invalidate(obj);
-
     /*If text is NULL then just refresh with the current text*/
     if(text == NULL) text = label->text;
 
     if(label->text == text && label->static_txt == 0) {
+        lv_obj_invalidate(obj);
+        invalidate_layout(obj);
+
         /*If set its own text then reallocate it (maybe its size changed)*/
 #if LV_USE_ARABIC_PERSIAN_CHARS
         /*Get the size of the text and process it*/
@@ -111,33 +117,43 @@ void lv_label_set_text(lv_obj_t * obj, const char * text)
         if(label->text == NULL) return;
     }
     else {
-        /*Free the old text*/
-        if(label->text != NULL && label->static_txt == 0) {
-            lv_mem_free(label->text);
-            label->text = NULL;
-        }
-
+        char * new_text;
 #if LV_USE_ARABIC_PERSIAN_CHARS
         /*Get the size of the text and process it*/
         size_t len = _lv_txt_ap_calc_bytes_cnt(text);
 
-        label->text = lv_mem_alloc(len);
-        LV_ASSERT_MALLOC(label->text);
-        if(label->text == NULL) return;
+        new_text = lv_mem_alloc(len);
+        LV_ASSERT_MALLOC(new_text);
+        if(new_text == NULL) return;
 
-        _lv_txt_ap_proc(text, label->text);
+        _lv_txt_ap_proc(text, new_text);
 #else
         /*Get the size of the text*/
         size_t len = strlen(text) + 1;
 
         /*Allocate space for the new text*/
-        label->text = lv_mem_alloc(len);
-        LV_ASSERT_MALLOC(label->text);
-        if(label->text == NULL) return;
-        strcpy(label->text, text);
+        new_text = lv_mem_alloc(len);
+        LV_ASSERT_MALLOC(new_text);
+        if(new_text == NULL) return;
+        strcpy(new_text, text);
 #endif
 
+        /*Nothing to do if the same text is set again, e.g. on periodic status updates. Keep its line breaks too.*/
+        if(is_same_text(obj, new_text)) {
+            lv_mem_free(new_text);
+            return;
+        }
+
+        lv_obj_invalidate(obj);
+        invalidate_layout(obj);
+
+        /*Free the old text*/
+        if(label->text != NULL && label->static_txt == 0) {
+            lv_mem_free(label->text);
+        }
+
         /*Now the text is dynamically allocated*/
+        label->text = new_text;
         label->static_txt = 0;
     }
 
@@ -149,24 +165,35 @@ void lv_label_set_text_fmt(lv_obj_t * obj, const char * fmt, ...)
     LV_ASSERT_OBJ(obj, MY_CLASS);
     LV_ASSERT_NULL(fmt);
 
-    lv_obj_invalidate(obj);
     lv_label_t * label = (lv_label_t *)obj;
 
     /*If text is NULL then refresh*/
     if(fmt == NULL) {
+        lv_obj_invalidate(obj);
         lv_label_refr_text(obj);
         return;
     }
 
+    va_list args;
+    va_start(args, fmt);
+    char * text = _lv_txt_set_text_vfmt(fmt, args);
+    va_end(args);
+
+    /*Nothing to do if the same text is set again. Keep its line breaks too.*/
+    if(text != NULL && is_same_text(obj, text)) {
+        lv_mem_free(text);
+        return;
+    }
+
+    lv_obj_invalidate(obj);
+    invalidate_layout(obj);
+
     if(label->text != NULL && label->static_txt == 0) {
         lv_mem_free(label->text);
         label->text = NULL;
     }
 
-    va_list args;
-    va_start(args, fmt);
-    label->text = _lv_txt_set_text_vfmt(fmt, args);
-    va_end(args);
+    label->text = text;
     label->static_txt = 0; /*Now the text is dynamically allocated*/
 
     lv_label_refr_text(obj);
@@ -177,6 +204,9 @@ void lv_label_set_text_static(lv_obj_t * obj, const char * text)
     LV_ASSERT_OBJ(obj, MY_CLASS);
     lv_label_t * label = (lv_label_t *)obj;
 
+    /*The static text could be modified in place*/
+    invalidate_layout(obj);
+
     if(label->static_txt == 0 && label->text != NULL) {
         lv_mem_free(label->text);
         label->text = NULL;
@@ -326,15 +356,19 @@ void lv_label_get_letter_pos(const lv_obj_t * obj, uint32_t char_id, lv_point_t
     if(lv_obj_get_style_width(obj, LV_PART_MAIN) == LV_SIZE_CONTENT && !obj->w_layout) flag |= LV_TEXT_FLAG_FIT;
 
     uint32_t byte_id = _lv_txt_encoded_get_byte_id(txt, char_id);
+    const lv_txt_layout_t * layout = get_layout((lv_obj_t *)obj, font, letter_space, max_w, flag);
+    uint32_t line_id = 0;
 
     /*Search the line of the index letter*/;
     while(txt[new_line_start] != '\0') {
-        new_line_start += _lv_txt_get_next_line(&txt[line_start], font, letter_space, max_w, NULL, flag);
+        if(layout) new_line_start = _lv_txt_layout_get_line_start(layout, line_id + 1);
+        else new_line_start += _lv_txt_get_next_line(&txt[line_start], font, letter_space, max_w, NULL, flag);
         if(byte_id < new_line_start || txt[new_line_start] == '\0')
             break; /*The line of 'index' letter begins at 'line_start'*/
 
         y += letter_height + line_space;
         line_start = new_line_start;
+        line_id++;
     }
 
     /*If the last character is line break then go to the next line*/
@@ -427,10 +461,13 @@ uint32_t lv_label_get_letter_on(const lv_obj_t * obj, lv_point_t * pos_in)
     if(lv_obj_get_style_width(obj, LV_PART_MAIN) == LV_SIZE_CONTENT && !obj->w_layout) flag |= LV_TEXT_FLAG_FIT;
 
     lv_text_align_t align = lv_obj_calculate_style_text_align(obj, LV_PART_MAIN, label->text);
+    const lv_txt_layout_t * layout = get_layout((lv_obj_t *)obj, font, letter_space, max_w, flag);
+    uint32_t line_id = 0;
 
     /*Search the line of the index letter*/;
     while(txt[line_start] != '\0') {
-        new_line_start += _lv_txt_get_next_line(&txt[line_start], font, letter_space, max_w, NULL, flag);
+        if(layout) new_line_start = _lv_txt_layout_get_line_start(layout, line_id + 1);
+        else new_line_start += _lv_txt_get_next_line(&txt[line_start], font, letter_space, max_w, NULL, flag);
 
         if(pos.y <= y + letter_height) {
             /*The line is found (stored in 'line_start')*/
@@ -444,6 +481,7 @@ uint32_t lv_label_get_letter_on(const lv_obj_t * obj, lv_point_t * pos_in)
         y += letter_height + line_space;
 
         line_start = new_line_start;
+        line_id++;
     }
 
 #if LV_USE_BIDI
@@ -546,27 +584,34 @@ bool lv_label_is_char_under_pos(const lv_obj_t * obj, lv_point_t * pos)
     if(label->expand != 0) flag |= LV_TEXT_FLAG_EXPAND;
     if(lv_obj_get_style_width(obj, LV_PART_MAIN) == LV_SIZE_CONTENT && !obj->w_layout) flag |= LV_TEXT_FLAG_FIT;
 
+    const lv_txt_layout_t * layout = get_layout((lv_obj_t *)obj, font, letter_space, max_w, flag);
+    uint32_t line_id = 0;
+
     /*Search the line of the index letter*/;
     while(txt[line_start] != '\0') {
-        new_line_start += _lv_txt_get_next_line(&txt[line_start], font, letter_space, max_w, NULL, flag);
+        if(layout) new_line_start = _lv_txt_layout_get_line_start(layout, line_id + 1);
+        else new_line_start += _lv_txt_get_next_line(&txt[line_start], font, letter_space, max_w, NULL, flag);
 
         if(pos->y <= y + letter_height) break; /*The line is found (stored in 'line_start')*/
         y += letter_height + line_space;
 
         line_start = new_line_start;
+        line_id++;
     }
 
     /*Calculate the x coordinate*/
     lv_coord_t x      = 0;
     lv_coord_t last_x = 0;
+    lv_coord_t line_w = 0;
+    if(align == LV_TEXT_ALIGN_CENTER || align == LV_TEXT_ALIGN_RIGHT) {
+        if(layout) line_w = _lv_txt_layout_get_line_width(layout, line_id);
+        else line_w = lv_txt_get_width(&txt[line_start], new_line_start - line_start, font, letter_space, flag);
+    }
+
     if(align == LV_TEXT_ALIGN_CENTER) {
-        lv_coord_t line_w;
-        line_w = lv_txt_get_width(&txt[line_start], new_line_start - line_start, font, letter_space, flag);
         x += lv_area_get_width(&txt_coords) / 2 - line_w / 2;
     }
     else if(align == LV_TEXT_ALIGN_RIGHT) {
-        lv_coord_t line_w;
-        line_w = lv_txt_get_width(&txt[line_start], new_line_start - line_start, font, letter_space, flag);
         x += lv_area_get_width(&txt_coords) - line_w;
     }
 
@@ -676,6 +721,7 @@ void lv_label_cut_text(lv_obj_t * obj, uint32_t pos, uint32_t cnt)
     char * label_txt = lv_label_get_text(obj);
     /*Delete the characters*/
     _lv_txt_cut(label_txt, pos, cnt);
+    invalidate_layout(obj);
 
     /*Refresh the label*/
     lv_label_refr_text(obj);
@@ -710,6 +756,10 @@ static void lv_label_constructor(const lv_obj_class_t * class_p, lv_obj_t * obj)
     label->sel_start = LV_DRAW_LABEL_NO_TXT_SEL;
     label->sel_end   = LV_DRAW_LABEL_NO_TXT_SEL;
 #endif
+
+#if LV_LABEL_LINE_CACHE
+    _lv_txt_layout_init(&label->layout);
+#endif
     label->dot.tmp_ptr   = NULL;
     label->dot_tmp_alloc = 0;
 
@@ -728,6 +778,10 @@ static void lv_label_destructor(const lv_obj_class_t * class_p, lv_obj_t * obj)
     lv_label_dot_tmp_free(obj);
     if(!label->static_txt) lv_mem_free(label->text);
     label->text = NULL;
+
+#if LV_LABEL_LINE_CACHE
+    _lv_txt_layout_free(&label->layout);
+#endif
 }
 
 static void lv_label_event(const lv_obj_class_t * class_p, lv_event_t * e)
@@ -775,7 +829,16 @@ static void lv_label_event(const lv_obj_class_t * class_p, lv_event_t * e)
         if(lv_obj_get_style_width(obj, LV_PART_MAIN) == LV_SIZE_CONTENT && !obj->w_layout) w = LV_COORD_MAX;
         else w = lv_obj_get_content_width(obj);
 
-        lv_txt_get_size(&size, label->text, font, letter_space, line_space, w, flag);
+        /*Content sized labels are laid out with LV_TEXT_FLAG_FIT, so their lines can be reused only if not content sized*/
+#if LV_LABEL_LINE_CACHE
+        if(_lv_txt_layout_is_valid(&label->layout, label->text, font, letter_space, w, flag)) {
+            _lv_txt_layout_get_size(&label->layout, line_space, &size);
+        }
+        else
+#endif
+        {
+            lv_txt_get_size(&size, label->text, font, letter_space, line_space, w, flag);
+        }
 
         lv_point_t * self_size = lv_event_get_param(e);
         self_size->x = LV_MAX(self_size->x, size.x);
@@ -810,6 +873,12 @@ static void draw_main(lv_event_t * e)
     lv_obj_init_draw_label_dsc(obj, LV_PART_MAIN, &label_draw_dsc);
     lv_bidi_calculate_align(&label_draw_dsc.align, &label_draw_dsc.bidi_dir, label->text);
 
+    /*Both render threads could draw the label and update the line breaks*/
+    _lv_parallel_lock();
+    label_draw_dsc.layout = get_layout(obj, label_draw_dsc.font, label_draw_dsc.letter_space,
+                                       lv_area_get_width(&txt_coords), flag);
+    _lv_parallel_unlock();
+
     label_draw_dsc.sel_start = lv_label_get_text_selection_start(obj);
     label_draw_dsc.sel_end = lv_label_get_text_selection_end(obj);
     if(label_draw_dsc.sel_start != LV_DRAW_LABEL_NO_TXT_SEL && label_draw_dsc.sel_end != LV_DRAW_LABEL_NO_TXT_SEL) {
@@ -832,6 +901,8 @@ static void draw_main(lv_event_t * e)
     lv_draw_label_hint_t * hint = &label->hint;
     if(label->long_mode == LV_LABEL_LONG_SCROLL_CIRCULAR || lv_area_get_height(&txt_coords) < LV_LABEL_HINT_HEIGHT_LIMIT)
         hint = NULL;
+    /*Both render threads could draw the label and update the hint*/
+    if(_lv_parallel_is_active()) hint = NULL;
 
 #else
     /*Just for compatibility*/
@@ -912,7 +983,9 @@ static void lv_label_refr_text(lv_obj_t * obj)
     if(label->expand != 0) flag |= LV_TEXT_FLAG_EXPAND;
     if(lv_obj_get_style_width(obj, LV_PART_MAIN) == LV_SIZE_CONTENT && !obj->w_layout) flag |= LV_TEXT_FLAG_FIT;
 
-    lv_txt_get_size(&size, label->text, font, letter_space, line_space, max_w, flag);
+    const lv_txt_layout_t * layout = get_layout(obj, font, letter_space, max_w, flag);
+    if(layout) _lv_txt_layout_get_size(layout, line_space, &size);
+    else lv_txt_get_size(&size, label->text, font, letter_space, line_space, max_w, flag);
 
     lv_obj_refresh_self_size(obj);
 
@@ -1156,6 +1229,7 @@ static void lv_label_refr_text(lv_obj_t * obj)
                 }
                 label->text[byte_id_ori + LV_LABEL_DOT_NUM] = '\0';
                 label->dot_end                              = letter_id + LV_LABEL_DOT_NUM;
+                invalidate_layout(obj);
             }
         }
     }
@@ -1185,6 +1259,7 @@ static void lv_label_revert_dots(lv_obj_t * obj)
     }
     label->text[byte_i + i] = dot_tmp[i];
     lv_label_dot_tmp_free(obj);
+    invalidate_layout(obj);
 
     label->dot_end = LV_LABEL_DOT_END_INV;
 }
@@ -1266,4 +1341,64 @@ static void set_ofs_y_anim(void * obj, int32_t v)
     lv_obj_invalidate(obj);
 }
 
+/**
+ * Get the line breaks of the label's text. The text is broken again only if
+ * the text, the font, the width, the letter space or the flags have changed.
+ * @param obj pointer to a label object
+ * @return the line breaks or NULL if they are not cached (disabled or out of memory)
+ */
+static const lv_txt_layout_t * get_layout(lv_obj_t * obj, const lv_font_t * font, lv_coord_t letter_space,
+                                          lv_coord_t max_w, lv_text_flag_t flag)
+{
+#if LV_LABEL_LINE_CACHE
+    lv_label_t * label = (lv_label_t *)obj;
+    if(!_lv_txt_layout_update(&label->layout, label->text, font, letter_space, max_w, flag)) return NULL;
+    return &label->layout;
+#else
+    LV_UNUSED(obj);
+    LV_UNUSED(font);
+    LV_UNUSED(letter_space);
+    LV_UNUSED(max_w);
+    LV_UNUSED(flag);
+    return NULL;
+#endif
+}
+
+/**
+ * Break the text again on the next use, because it was changed in place
+ * @param obj pointer to a label object
+ */
+static void invalidate_layout(lv_obj_t * obj)
+{
+#if LV_LABEL_LINE_CACHE
+    lv_label_t * label = (lv_label_t *)obj;
+    _lv_txt_layout_invalidate(&label->layout);
+#else
+    LV_UNUSED(obj);
+#endif
+}
+
+/**
+ * Check if a new text is the same as the current text of the label.
+ * Only with the line cache, as without it setting the same text is the way to refresh the label.
+ * Setting the label's own text (e.g. after modifying it in place) is not checked, it always refreshes.
+ * @param obj pointer to a label object
+ * @param text the new text, already processed as the label stores it
+ * @return true: the label has the same dynamically allocated text, without dots
+ */
+static bool is_same_text(lv_obj_t * obj, const char * text)
+{
+#if LV_LABEL_LINE_CACHE
+    lv_label_t * label = (lv_label_t *)obj;
+    if(label->text == NULL || label->static_txt != 0) return false;
+    if(label->dot_end != LV_LABEL_DOT_END_INV) return false;
+
+    return strcmp(label->text, text) == 0;
+#else
+    LV_UNUSED(obj);
+    LV_UNUSED(text);
+    return false;
+#endif
+}
+
 #endif
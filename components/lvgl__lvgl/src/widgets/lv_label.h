@@ -63,6 +63,10 @@ typedef struct {
     lv_draw_label_hint_t hint;
 #endif
 
+#if LV_LABEL_LINE_CACHE
+    lv_txt_layout_t layout; /*Line breaks of the text, reused until the text, font or width changes*/
+#endif
+
 #if LV_LABEL_TEXT_SELECTION
     uint32_t sel_start;
     uint32_t sel_end;
@@ -95,6 +99,8 @@ lv_obj_t * lv_label_create(lv_obj_t * parent);
 
 /**
  * Set a new text for a label. Memory will be allocated to store the text by the label.
+ * With `LV_LABEL_LINE_CACHE` setting a copy of the current text does nothing.
+ * After modifying the label's text in place use `lv_label_set_text(obj, NULL)` to refresh it.
  * @param obj           pointer to a label object
  * @param text          '\0' terminated character string. NULL to refresh with the current text.
  */
@@ -103,6 +109,7 @@ void lv_label_set_text(lv_obj_t * obj, const char * text);
 /**
  * Set a new formatted text for a label. Memory will be allocated to store the text by the label.
  * @param obj           pointer to a label object
+ * With `LV_LABEL_LINE_CACHE` nothing happens if the formatted text is the same as the current one.
  * @param fmt           `printf`-like format
  * @example lv_label_set_text_fmt(label1, "%d user", user_num);
  */
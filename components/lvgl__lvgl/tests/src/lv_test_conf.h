@@ -32,6 +32,19 @@ void lv_test_assert_fail(void);
 uint32_t custom_tick_get(void);
 #define LV_TICK_CUSTOM_SYS_TIME_EXPR custom_tick_get()
 
+uint32_t lv_test_time_us(void);
+#define LV_TRACE_TIME_EXPR lv_test_time_us()
+
+/*Copy the cached images to the system heap so that the copy is tested too*/
+#define LV_IMG_CACHE_MEM_INCLUDE <stdlib.h>
+#define LV_IMG_CACHE_MEM_ALLOC malloc
+#define LV_IMG_CACHE_MEM_FREE free
+
+/*Allocate the caches from the system heap so that mixing up the allocators is caught by the sanitizer*/
+#define LV_CACHE_MEM_INCLUDE <stdlib.h>
+#define LV_CACHE_MEM_ALLOC malloc
+#define LV_CACHE_MEM_FREE free
+
 typedef void * lv_user_data_t;
 
 /**********************
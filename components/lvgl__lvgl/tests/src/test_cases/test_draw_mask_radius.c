@@ -0,0 +1,225 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+
+/*The radius mask is compared row by row with the original per pixel implementation,
+ *on random masks to hit every case of mixing. Rounded rectangles are compared to a screenshot
+ *which was made without the constant circle tables.
+ *The fill time of rounded rectangles with a few or many different radii is printed.*/
+
+#if LV_DRAW_COMPLEX
+
+#include <time.h>
+
+#define FRAMES      5
+#define MASK_LEN    300
+
+extern lv_color_t test_fb[];
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static lv_opa_t ref_mask_mix(lv_opa_t mask_act, lv_opa_t mask_new)
+{
+    if(mask_new >= LV_OPA_MAX) return mask_act;
+    if(mask_new <= LV_OPA_MIN) return 0;
+
+    return LV_UDIV255(mask_act * mask_new);
+}
+
+/*The anti-aliased part of a row as it was mixed pixel by pixel*/
+static void ref_mask_radius(lv_opa_t * mask_buf, lv_coord_t abs_x, lv_coord_t abs_y, lv_coord_t len,
+                            lv_draw_mask_radius_param_t * p)
+{
+    bool outer = p->cfg.outer;
+    int32_t radius = p->cfg.radius;
+    lv_area_t rect = p->cfg.rect;
+
+    int32_t k = rect.x1 - abs_x;
+    int32_t w = lv_area_get_width(&rect);
+    int32_t h = lv_area_get_height(&rect);
+    abs_y -= rect.y1;
+
+    lv_coord_t cir_y = abs_y < radius ? radius - abs_y - 1 : abs_y - (h - radius);
+    _lv_draw_mask_radius_circle_dsc_t * c = p->circle;
+    lv_coord_t aa_len = c->opa_start_on_y[cir_y + 1] - c->opa_start_on_y[cir_y];
+    lv_coord_t x_start = c->x_start_on_y[cir_y];
+    lv_opa_t * aa_opa = &c->cir_opa[c->opa_start_on_y[cir_y]];
+    lv_coord_t cir_x_right = k + w - radius + x_start;
+    lv_coord_t cir_x_left = k + radius - x_start - 1;
+    lv_coord_t i;
+
+    for(i = 0; i < aa_len; i++) {
+        lv_opa_t opa = aa_opa[aa_len - i - 1];
+        if(outer) opa = 255 - opa;
+        if(cir_x_right + i >= 0 && cir_x_right + i < len) {
+            mask_buf[cir_x_right + i] = ref_mask_mix(opa, mask_buf[cir_x_right + i]);
+        }
+        if(cir_x_left - i >= 0 && cir_x_left - i < len) {
+            mask_buf[cir_x_left - i] = ref_mask_mix(opa, mask_buf[cir_x_left - i]);
+        }
+    }
+
+    if(outer == false) {
+        cir_x_right = LV_CLAMP(0, cir_x_right + i, len);
+        lv_memset_00(&mask_buf[cir_x_right], len - cir_x_right);
+        cir_x_left = LV_CLAMP(0, cir_x_left - aa_len + 1, len);
+        lv_memset_00(&mask_buf[0], cir_x_left);
+    }
+    else {
+        lv_coord_t clr_start = LV_CLAMP(0, cir_x_left + 1, len);
+        lv_coord_t clr_len = LV_CLAMP(0, cir_x_right - clr_start, len - clr_start);
+        lv_memset_00(&mask_buf[clr_start], clr_len);
+    }
+}
+
+static lv_obj_t * rect_create(lv_coord_t x, lv_coord_t y, lv_coord_t w, lv_coord_t h, lv_coord_t radius)
+{
+    lv_obj_t * obj = lv_obj_create(lv_scr_act());
+    lv_obj_remove_style_all(obj);
+    lv_obj_set_style_bg_opa(obj, LV_OPA_COVER, 0);
+    lv_obj_set_style_bg_color(obj, lv_palette_main(LV_PALETTE_BLUE), 0);
+    lv_obj_set_style_radius(obj, radius, 0);
+    lv_obj_set_pos(obj, x, y);
+    lv_obj_set_size(obj, w, h);
+    return obj;
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+    lv_obj_clean(lv_scr_act());
+}
+
+void test_draw_mask_radius_rows(void)
+{
+    static const lv_coord_t radii[] = {1, 2, 3, 5, 8, 12, 16, 17, 25, 40, 63, 100};
+    lv_opa_t mask_buf[MASK_LEN];
+    lv_opa_t ref_buf[MASK_LEN];
+
+    uint32_t r;
+    for(r = 0; r < sizeof(radii) / sizeof(radii[0]); r++) {
+        uint32_t outer;
+        for(outer = 0; outer < 2; outer++) {
+            /*The rectangle is at x = 100 so the rows can start before, in or after its corners*/
+            lv_area_t rect;
+            lv_area_set(&rect, 100, 10, 100 + radii[r] * 2 + lv_rand(0, 20), 10 + radii[r] * 2 + lv_rand(0, 20));
+
+            lv_draw_mask_radius_param_t param;
+            lv_draw_mask_radius_init(&param, &rect, radii[r], outer);
+
+            lv_coord_t y;
+            for(y = rect.y1; y < rect.y1 + radii[r]; y++) {
+                uint32_t i;
+                for(i = 0; i < 8; i++) {
+                    lv_coord_t abs_x = lv_rand(0, rect.x1 + radii[r] - 1);
+                    lv_coord_t len = lv_rand(1, MASK_LEN);
+
+                    /*Add also the values which are handled specially when mixing*/
+                    uint32_t j;
+                    for(j = 0; j < MASK_LEN; j++) {
+                        uint32_t v = lv_rand(0, 15);
+                        if(v < 4) mask_buf[j] = v;
+                        else if(v < 8) mask_buf[j] = 255 - (v - 4);
+                        else mask_buf[j] = lv_rand(0, 255);
+                    }
+                    lv_memcpy(ref_buf, mask_buf, MASK_LEN);
+
+                    ref_mask_radius(ref_buf, abs_x, y, len, &param);
+                    param.dsc.cb(mask_buf, abs_x, y, len, &param);
+                    TEST_ASSERT_EQUAL_UINT8_ARRAY(ref_buf, mask_buf, MASK_LEN);
+
+                    /*The bottom corners are the same from the other side*/
+                    lv_memcpy(mask_buf, ref_buf, MASK_LEN);
+                    lv_coord_t y_bottom = rect.y2 - (y - rect.y1);
+                    ref_mask_radius(ref_buf, abs_x, y_bottom, len, &param);
+                    param.dsc.cb(mask_buf, abs_x, y_bottom, len, &param);
+                    TEST_ASSERT_EQUAL_UINT8_ARRAY(ref_buf, mask_buf, MASK_LEN);
+                }
+            }
+
+            lv_draw_mask_free_param(&param);
+        }
+    }
+}
+
+void test_draw_mask_radius_screenshot(void)
+{
+    /*Radii in and out of the constant tables and the cache, with borders for the outer masks*/
+    lv_coord_t i;
+    for(i = 0; i < 60; i++) {
+        lv_coord_t radius = i < 40 ? i + 1 : (i - 40) * 5 + 41;
+        lv_obj_t * obj = rect_create(10 + (i % 10) * 78, 10 + (i / 10) * 78, 40 + i % 4 * 10, 66 - i % 3 * 7, radius);
+        if(i % 2) {
+            lv_obj_set_style_border_width(obj, 1 + i % 5, 0);
+            lv_obj_set_style_bg_opa(obj, LV_OPA_50, 0);
+        }
+    }
+
+    TEST_ASSERT_EQUAL_SCREENSHOT("draw_mask_radius.png");
+}
+
+void test_draw_mask_radius_benchmark(void)
+{
+    /*Number of different radii on the screen*/
+    static const uint32_t mixes[] = {1, 4, 8, 24};
+
+    uint32_t m;
+    for(m = 0; m < sizeof(mixes) / sizeof(mixes[0]); m++) {
+        uint32_t px_cnt = 0;
+        uint32_t i;
+        for(i = 0; i < 64; i++) {
+            lv_coord_t radius = 3 + i % mixes[m];
+            rect_create(8 + (i % 8) * 98, 4 + (i / 8) * 59, 90, 55, radius);
+            px_cnt += 90 * 55;
+        }
+
+        uint64_t t_sum = 0;
+        for(i = 0; i < FRAMES; i++) {
+            lv_obj_invalidate(lv_scr_act());
+            uint64_t t = now_ns();
+            lv_refr_now(NULL);
+            t_sum += now_ns() - t;
+        }
+
+        uint64_t t_frame = t_sum / FRAMES;
+        TEST_PRINTF("rounded rects with %u radii: %u us/frame, %u Mpx/s", (unsigned)mixes[m],
+                    (unsigned)(t_frame / 1000), (unsigned)((uint64_t)px_cnt * 1000 / t_frame));
+
+        lv_obj_clean(lv_scr_act());
+    }
+}
+
+#else
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_draw_mask_radius_rows(void)
+{
+}
+
+void test_draw_mask_radius_screenshot(void)
+{
+}
+
+void test_draw_mask_radius_benchmark(void)
+{
+}
+
+#endif
+
+#endif
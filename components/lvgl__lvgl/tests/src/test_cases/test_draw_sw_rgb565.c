@@ -0,0 +1,147 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+#include "../src/draw/sw/lv_draw_sw.h"
+
+#include "unity/unity.h"
+
+/*Compare the RGB565 kernels with LVGL's generic `fill_normal` and `map_normal` loops.
+ *They are used only with 16 bit color depth, so run `build_16bit/test_draw_sw_rgb565` of the OPTIONS_16BIT build.*/
+
+#if LV_DRAW_SW_BLEND_RGB565
+
+#define BUF_W   67
+#define BUF_H   9
+
+static uint16_t dest_ref[BUF_W * BUF_H + 2];
+static uint16_t dest_res[BUF_W * BUF_H + 2];
+static uint16_t src[BUF_W * BUF_H + 2];
+static lv_opa_t mask[BUF_W * BUF_H + 4];
+
+static uint32_t rnd_seed;
+
+static const lv_opa_t opa_list[] = {LV_OPA_COVER, 254, LV_OPA_MAX, 200, LV_OPA_50, 17, 3};
+
+static uint32_t rnd(void)
+{
+    rnd_seed = rnd_seed * 1103515245 + 12345;
+    return rnd_seed >> 8;
+}
+
+static void fill_random(void)
+{
+    uint32_t i;
+    /*Use black and runs of the same color too to exercise the result caching*/
+    for(i = 0; i < sizeof(dest_ref) / sizeof(dest_ref[0]); i++) {
+        uint32_t type = rnd() & 0x3;
+        if(type == 0) dest_ref[i] = 0x0000;
+        else if(type == 1 && i > 0) dest_ref[i] = dest_ref[i - 1];
+        else dest_ref[i] = (uint16_t)rnd();
+        src[i] = (uint16_t)rnd();
+    }
+    lv_memcpy(dest_res, dest_ref, sizeof(dest_ref));
+
+    /*Runs of fully covered, fully transparent and anti-aliased mask values*/
+    i = 0;
+    while(i < sizeof(mask)) {
+        uint32_t len = 1 + (rnd() % 9);
+        uint32_t type = rnd() % 3;
+        while(len-- && i < sizeof(mask)) {
+            mask[i++] = type == 0 ? LV_OPA_COVER : type == 1 ? LV_OPA_TRANSP : (lv_opa_t)rnd();
+        }
+    }
+}
+
+static void check_blend(bool map, bool use_mask)
+{
+    uint32_t i;
+    for(i = 0; i < 200; i++) {
+        fill_random();
+
+        /*Random sub area with random alignment of the buffers*/
+        int32_t dest_ofs = rnd() % 2;
+        int32_t mask_ofs = rnd() % 4;
+        int32_t w = 1 + rnd() % (BUF_W - 1);
+        int32_t h = 1 + rnd() % BUF_H;
+
+        lv_draw_sw_rgb565_blend_dsc_t dsc;
+        lv_memset_00(&dsc, sizeof(dsc));
+        dsc.dest_w = w;
+        dsc.dest_h = h;
+        dsc.dest_stride = BUF_W;
+        dsc.color = (uint16_t)rnd();
+        dsc.src_buf = map ? &src[rnd() % 2] : NULL;
+        dsc.src_stride = BUF_W;
+        dsc.opa = opa_list[i % (sizeof(opa_list) / sizeof(opa_list[0]))];
+        dsc.mask_buf = use_mask ? &mask[mask_ofs] : NULL;
+        dsc.mask_stride = use_mask ? BUF_W : 0;
+
+        dsc.dest_buf = &dest_ref[dest_ofs];
+        _lv_draw_sw_blend_rgb565_generic(&dsc);
+
+        dsc.dest_buf = &dest_res[dest_ofs];
+        if(map) lv_draw_sw_blend_rgb565_map(&dsc);
+        else lv_draw_sw_blend_rgb565_fill(&dsc);
+
+        TEST_ASSERT_EQUAL_HEX16_ARRAY(dest_ref, dest_res, sizeof(dest_ref) / sizeof(dest_ref[0]));
+    }
+}
+
+void setUp(void)
+{
+    rnd_seed = 0x1234;
+}
+
+void tearDown(void)
+{
+    /* Function run after every test */
+}
+
+void test_rgb565_fill(void)
+{
+    check_blend(false, false);
+}
+
+void test_rgb565_fill_mask(void)
+{
+    check_blend(false, true);
+}
+
+void test_rgb565_map(void)
+{
+    check_blend(true, false);
+}
+
+void test_rgb565_map_mask(void)
+{
+    check_blend(true, true);
+}
+
+#else
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_rgb565_fill(void)
+{
+}
+
+void test_rgb565_fill_mask(void)
+{
+}
+
+void test_rgb565_map(void)
+{
+}
+
+void test_rgb565_map_mask(void)
+{
+}
+
+#endif
+
+#endif
@@ -0,0 +1,417 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+#include "../src/draw/sw/lv_draw_sw.h"
+
+#include "unity/unity.h"
+
+/*Images are transformed with `lv_draw_sw_transform` and with the original pixel by pixel implementation.
+ *The result has to be the same for every color format, angle, zoom and pivot, with and without anti-aliasing.
+ *The throughput of both is printed for a 320x240 true color image.*/
+
+#if LV_DRAW_COMPLEX && LV_COLOR_DEPTH == 32
+
+#include <stdlib.h>
+#include <time.h>
+
+#define SRC_W       37
+#define SRC_H       23
+#define SRC_STRIDE  (SRC_W + 3)
+#define BENCH_W     320
+#define BENCH_H     240
+
+typedef struct {
+    int32_t x_in;
+    int32_t y_in;
+    int32_t sinma;
+    int32_t cosma;
+    int32_t zoom;
+    int32_t angle;
+    int32_t pivot_x_256;
+    int32_t pivot_y_256;
+    lv_point_t pivot;
+} ref_tr_dsc_t;
+
+static uint32_t rnd_seed;
+
+static uint32_t rnd(void)
+{
+    rnd_seed = rnd_seed * 1103515245 + 12345;
+    return rnd_seed >> 8;
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void ref_transform_point(ref_tr_dsc_t * t, int32_t xin, int32_t yin, int32_t * xout, int32_t * yout)
+{
+    if(t->angle == 0 && t->zoom == LV_IMG_ZOOM_NONE) {
+        *xout = xin * 256;
+        *yout = yin * 256;
+        return;
+    }
+
+    xin -= t->pivot.x;
+    yin -= t->pivot.y;
+
+    if(t->angle == 0) {
+        *xout = ((int32_t)(xin * t->zoom)) + (t->pivot_x_256);
+        *yout = ((int32_t)(yin * t->zoom)) + (t->pivot_y_256);
+    }
+    else if(t->zoom == LV_IMG_ZOOM_NONE) {
+        *xout = ((t->cosma * xin - t->sinma * yin) >> 2) + (t->pivot_x_256);
+        *yout = ((t->sinma * xin + t->cosma * yin) >> 2) + (t->pivot_y_256);
+    }
+    else {
+        *xout = (((t->cosma * xin - t->sinma * yin) * t->zoom) >> 10) + (t->pivot_x_256);
+        *yout = (((t->sinma * xin + t->cosma * yin) * t->zoom) >> 10) + (t->pivot_y_256);
+    }
+}
+
+/*A pixel of a line as it was calculated with 32 bit color depth*/
+static void ref_px(const uint8_t * src, int32_t src_w, int32_t src_h, int32_t stride, int32_t xs_ups, int32_t ys_ups,
+                   lv_img_cf_t cf, bool aa, lv_color_t ck, lv_color_t * c, lv_opa_t * a)
+{
+    int32_t px_size = cf == LV_IMG_CF_TRUE_COLOR_ALPHA ? LV_IMG_PX_SIZE_ALPHA_BYTE : sizeof(lv_color_t);
+    int32_t xs_int = xs_ups >> 8;
+    int32_t ys_int = ys_ups >> 8;
+    if(xs_int < 0 || xs_int >= src_w || ys_int < 0 || ys_int >= src_h) {
+        *a = 0x00;
+        return;
+    }
+
+    const uint8_t * px = src + ys_int * stride * px_size + xs_int * px_size;
+    if(!aa) {
+        c->full = *((uint32_t *)px);
+        if(cf == LV_IMG_CF_TRUE_COLOR_ALPHA) *a = px[LV_IMG_PX_SIZE_ALPHA_BYTE - 1];
+        else if(cf == LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED && c->full == ck.full) *a = 0x00;
+        else *a = 0xff;
+        return;
+    }
+
+    int32_t xs_fract = xs_ups & 0xFF;
+    int32_t ys_fract = ys_ups & 0xFF;
+    int32_t x_next;
+    int32_t y_next;
+    if(xs_fract < 0x80) {
+        x_next = -1;
+        xs_fract = (0x7F - xs_fract) * 2;
+    }
+    else {
+        x_next = 1;
+        xs_fract = (xs_fract - 0x80) * 2;
+    }
+    if(ys_fract < 0x80) {
+        y_next = -1;
+        ys_fract = (0x7F - ys_fract) * 2;
+    }
+    else {
+        y_next = 1;
+        ys_fract = (ys_fract - 0x80) * 2;
+    }
+
+    if(xs_int + x_next >= 0 && xs_int + x_next <= src_w - 1 && ys_int + y_next >= 0 && ys_int + y_next <= src_h - 1) {
+        const uint8_t * px_hor = px + x_next * px_size;
+        const uint8_t * px_ver = px + y_next * stride * px_size;
+        lv_color_t c_base;
+        lv_color_t c_ver;
+        lv_color_t c_hor;
+        c_base.full = *((uint32_t *)px);
+        c_ver.full = *((uint32_t *)px_ver);
+        c_hor.full = *((uint32_t *)px_hor);
+
+        if(cf == LV_IMG_CF_TRUE_COLOR) {
+            *a = 0xff;
+        }
+        else {
+            lv_opa_t a_base = 0xff;
+            lv_opa_t a_ver = 0xff;
+            lv_opa_t a_hor = 0xff;
+            if(cf == LV_IMG_CF_TRUE_COLOR_ALPHA) {
+                a_base = px[LV_IMG_PX_SIZE_ALPHA_BYTE - 1];
+                a_ver = px_ver[LV_IMG_PX_SIZE_ALPHA_BYTE - 1];
+                a_hor = px_hor[LV_IMG_PX_SIZE_ALPHA_BYTE - 1];
+            }
+            else if(c_base.full == ck.full || c_ver.full == ck.full || c_hor.full == ck.full) {
+                *a = 0x00;
+                return;
+            }
+
+            if(a_ver != a_base) a_ver = ((a_ver * ys_fract) + (a_base * (0x100 - ys_fract))) >> 8;
+            if(a_hor != a_base) a_hor = ((a_hor * xs_fract) + (a_base * (0x100 - xs_fract))) >> 8;
+            *a = (a_ver + a_hor) >> 1;
+            if(*a == 0x00) return;
+        }
+
+        if(c_base.full == c_ver.full && c_base.full == c_hor.full) {
+            *c = c_base;
+        }
+        else {
+            c_ver = lv_color_mix(c_ver, c_base, ys_fract);
+            c_hor = lv_color_mix(c_hor, c_base, xs_fract);
+            *c = lv_color_mix(c_hor, c_ver, LV_OPA_50);
+        }
+    }
+    else {
+        c->full = *((uint32_t *)px);
+        lv_opa_t a_px = 0xff;
+        if(cf == LV_IMG_CF_TRUE_COLOR_ALPHA) a_px = px[LV_IMG_PX_SIZE_ALPHA_BYTE - 1];
+        else if(cf == LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED) a_px = c->full == ck.full ? 0x00 : 0xff;
+
+        if((xs_int == 0 && x_next < 0) || (xs_int == src_w - 1 && x_next > 0)) *a = (a_px * (0xFF - xs_fract)) >> 8;
+        else if((ys_int == 0 && y_next < 0) || (ys_int == src_h - 1 && y_next > 0)) *a = (a_px * (0xFF - ys_fract)) >> 8;
+        else *a = 0x00;
+    }
+}
+
+/*The original `lv_draw_sw_transform`: every pixel is transformed separately*/
+static void ref_transform(const lv_area_t * dest_area, const void * src_buf, lv_coord_t src_w, lv_coord_t src_h,
+                          lv_coord_t src_stride, const lv_draw_img_dsc_t * draw_dsc, lv_img_cf_t cf,
+                          lv_color_t * cbuf, lv_opa_t * abuf)
+{
+    ref_tr_dsc_t tr_dsc;
+    tr_dsc.angle = -draw_dsc->angle;
+    tr_dsc.zoom = (256 * 256) / draw_dsc->zoom;
+    tr_dsc.pivot = draw_dsc->pivot;
+
+    int32_t angle_low = tr_dsc.angle / 10;
+    int32_t angle_high = angle_low + 1;
+    int32_t angle_rem = tr_dsc.angle  - (angle_low * 10);
+
+    int32_t s1 = lv_trigo_sin(angle_low);
+    int32_t s2 = lv_trigo_sin(angle_high);
+    int32_t c1 = lv_trigo_sin(angle_low + 90);
+    int32_t c2 = lv_trigo_sin(angle_high + 90);
+
+    tr_dsc.sinma = (s1 * (10 - angle_rem) + s2 * angle_rem) / 10;
+    tr_dsc.cosma = (c1 * (10 - angle_rem) + c2 * angle_rem) / 10;
+    tr_dsc.sinma = tr_dsc.sinma >> (LV_TRIGO_SHIFT - 10);
+    tr_dsc.cosma = tr_dsc.cosma >> (LV_TRIGO_SHIFT - 10);
+    tr_dsc.pivot_x_256 = tr_dsc.pivot.x * 256;
+    tr_dsc.pivot_y_256 = tr_dsc.pivot.y * 256;
+
+    lv_color_t ck = _lv_refr_get_disp_refreshing()->driver->color_chroma_key;
+    lv_coord_t dest_w = lv_area_get_width(dest_area);
+    lv_coord_t dest_h = lv_area_get_height(dest_area);
+    lv_coord_t y;
+    for(y = 0; y < dest_h; y++) {
+        int32_t xs1_ups, ys1_ups, xs2_ups, ys2_ups;
+        ref_transform_point(&tr_dsc, dest_area->x1, dest_area->y1 + y, &xs1_ups, &ys1_ups);
+        ref_transform_point(&tr_dsc, dest_area->x2, dest_area->y1 + y, &xs2_ups, &ys2_ups);
+
+        int32_t xs_step_256 = 0;
+        int32_t ys_step_256 = 0;
+        if(dest_w > 1) {
+            xs_step_256 = (256 * (xs2_ups - xs1_ups)) / (dest_w - 1);
+            ys_step_256 = (256 * (ys2_ups - ys1_ups)) / (dest_w - 1);
+        }
+
+        lv_coord_t x;
+        for(x = 0; x < dest_w; x++) {
+            int32_t xs_ups = xs1_ups + 0x80 + ((xs_step_256 * x) >> 8);
+            int32_t ys_ups = ys1_ups + 0x80 + ((ys_step_256 * x) >> 8);
+            ref_px(src_buf, src_w, src_h, src_stride, xs_ups, ys_ups, cf, draw_dsc->antialias, ck, &cbuf[x], &abuf[x]);
+        }
+
+        cbuf += dest_w;
+        abuf += dest_w;
+    }
+}
+
+static void fill_src(uint8_t * src, uint32_t px_cnt, lv_img_cf_t cf)
+{
+    static const uint32_t palette[] = {0xff102030, 0xff405060, 0xffa0b0c0, 0xffff0000, 0xff00ff00};
+    lv_color_t ck = _lv_refr_get_disp_refreshing()->driver->color_chroma_key;
+
+    uint32_t * px = (uint32_t *)src;
+    uint32_t i;
+    for(i = 0; i < px_cnt; i++) {
+        /*Mostly random colors, but also areas of the same color*/
+        uint32_t r = rnd();
+        px[i] = r % 4 ? palette[r % 5] : r | 0xff000000;
+        if(cf == LV_IMG_CF_TRUE_COLOR_ALPHA) {
+            static const uint8_t alphas[] = {0x00, 0x10, 0x80, 0xfe, 0xff, 0xff};
+            px[i] = (px[i] & 0x00ffffff) | ((uint32_t)alphas[(r >> 4) % 6] << 24);
+        }
+        else if(cf == LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED && (r >> 4) % 8 == 0) {
+            px[i] = ck.full;
+        }
+    }
+}
+
+/*Transform with both versions and compare the opacities, and the colors where they are visible*/
+static void check_transform(const uint8_t * src, lv_img_cf_t cf, int16_t angle, uint16_t zoom, lv_point_t pivot,
+                            bool aa)
+{
+    lv_draw_img_dsc_t dsc;
+    lv_draw_img_dsc_init(&dsc);
+    dsc.angle = angle;
+    dsc.zoom = zoom;
+    dsc.pivot = pivot;
+    dsc.antialias = aa;
+
+    /*The transformed image with some pixels around it, and a part of it as when it's clipped*/
+    lv_area_t areas[2];
+    _lv_img_buf_get_transformed_area(&areas[0], SRC_W, SRC_H, angle, zoom, &pivot);
+    lv_area_increase(&areas[0], 3, 3);
+    lv_area_set(&areas[1], areas[0].x1 + lv_area_get_width(&areas[0]) / 3, areas[0].y1 + 2,
+                areas[0].x2 - 4, areas[0].y1 + lv_area_get_height(&areas[0]) / 2);
+
+    uint32_t i;
+    for(i = 0; i < 2; i++) {
+        uint32_t px_cnt = lv_area_get_size(&areas[i]);
+        lv_color_t * cbuf_ref = calloc(px_cnt, sizeof(lv_color_t));
+        lv_color_t * cbuf_res = calloc(px_cnt, sizeof(lv_color_t));
+        lv_opa_t * abuf_ref = calloc(px_cnt, 1);
+        lv_opa_t * abuf_res = calloc(px_cnt, 1);
+
+        ref_transform(&areas[i], src, SRC_W, SRC_H, SRC_STRIDE, &dsc, cf, cbuf_ref, abuf_ref);
+        lv_draw_sw_transform(NULL, &areas[i], src, SRC_W, SRC_H, SRC_STRIDE, &dsc, cf, cbuf_res, abuf_res);
+
+        char msg[96];
+        lv_snprintf(msg, sizeof(msg), "cf %d, angle %d, zoom %d, pivot %d;%d, aa %d, area %d",
+                    cf, angle, zoom, pivot.x, pivot.y, aa, (int)i);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(abuf_ref, abuf_res, px_cnt, msg);
+        /*The alpha channel of the colors is not used, the opacity is in abuf*/
+        uint32_t j;
+        for(j = 0; j < px_cnt; j++) {
+            if(abuf_ref[j] == 0) continue;
+            TEST_ASSERT_EQUAL_HEX32_MESSAGE(cbuf_ref[j].full & 0xFFFFFF, cbuf_res[j].full & 0xFFFFFF, msg);
+        }
+
+        free(cbuf_ref);
+        free(cbuf_res);
+        free(abuf_ref);
+        free(abuf_res);
+    }
+}
+
+void setUp(void)
+{
+    /*The chroma key is taken from the display being refreshed*/
+    _lv_refr_set_disp_refreshing(lv_disp_get_default());
+    rnd_seed = 1;
+}
+
+void tearDown(void)
+{
+}
+
+void test_draw_sw_transform_equivalence(void)
+{
+    static const lv_img_cf_t cfs[] = {
+        LV_IMG_CF_TRUE_COLOR, LV_IMG_CF_TRUE_COLOR_ALPHA, LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED
+    };
+    static const int16_t angles[] = {0, 900, 1800, 2700, -900, 450, 300, 1234, 3590};
+    static const uint16_t zooms[] = {256, 512, 1024, 128, 64, 384, 300, 200, 2048};
+    const lv_point_t pivots[] = {{SRC_W / 2, SRC_H / 2}, {0, 0}, {5, 17}};
+
+    uint8_t * src = malloc(SRC_STRIDE * SRC_H * LV_IMG_PX_SIZE_ALPHA_BYTE);
+
+    uint32_t c;
+    for(c = 0; c < sizeof(cfs) / sizeof(cfs[0]); c++) {
+        fill_src(src, SRC_STRIDE * SRC_H, cfs[c]);
+
+        uint32_t a;
+        uint32_t z;
+        uint32_t p;
+        for(a = 0; a < sizeof(angles) / sizeof(angles[0]); a++) {
+            for(z = 0; z < sizeof(zooms) / sizeof(zooms[0]); z++) {
+                for(p = 0; p < sizeof(pivots) / sizeof(pivots[0]); p++) {
+                    check_transform(src, cfs[c], angles[a], zooms[z], pivots[p], false);
+                    check_transform(src, cfs[c], angles[a], zooms[z], pivots[p], true);
+                }
+            }
+        }
+    }
+
+    free(src);
+}
+
+void test_draw_sw_transform_benchmark(void)
+{
+    static const struct {
+        const char * name;
+        int16_t angle;
+        uint16_t zoom;
+    } cases[] = {
+        {"translate", 0, 256},
+        {"rotate 90", 900, 256},
+        {"rotate 180", 1800, 256},
+        {"rotate 270", 2700, 256},
+        {"zoom 2x", 0, 512},
+        {"zoom 4x", 0, 1024},
+        {"zoom 0.5x", 0, 128},
+        {"rotate 30", 300, 256},
+        {"rotate 30, zoom 1.5x", 300, 384},
+    };
+
+    uint8_t * src = malloc(BENCH_W * BENCH_H * sizeof(lv_color_t));
+    lv_color_t * cbuf = malloc(BENCH_W * BENCH_H * sizeof(lv_color_t));
+    lv_opa_t * abuf = malloc(BENCH_W * BENCH_H);
+    fill_src(src, BENCH_W * BENCH_H, LV_IMG_CF_TRUE_COLOR);
+
+    uint32_t i;
+    for(i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        uint32_t aa;
+        for(aa = 0; aa < 2; aa++) {
+            lv_draw_img_dsc_t dsc;
+            lv_draw_img_dsc_init(&dsc);
+            dsc.angle = cases[i].angle;
+            dsc.zoom = cases[i].zoom;
+            dsc.pivot.x = BENCH_W / 2;
+            dsc.pivot.y = BENCH_H / 2;
+            dsc.antialias = aa;
+
+            /*As large as the image, at the middle of the transformed image*/
+            lv_area_t area;
+            lv_area_set(&area, 0, 0, BENCH_W - 1, BENCH_H - 1);
+            uint32_t px_cnt = lv_area_get_size(&area);
+
+            uint64_t t_ref = 0;
+            uint64_t t_res = 0;
+            uint32_t r;
+            for(r = 0; r < 8; r++) {
+                uint64_t t = now_ns();
+                ref_transform(&area, src, BENCH_W, BENCH_H, BENCH_W, &dsc, LV_IMG_CF_TRUE_COLOR, cbuf, abuf);
+                t_ref += now_ns() - t;
+
+                t = now_ns();
+                lv_draw_sw_transform(NULL, &area, src, BENCH_W, BENCH_H, BENCH_W, &dsc, LV_IMG_CF_TRUE_COLOR, cbuf, abuf);
+                t_res += now_ns() - t;
+            }
+
+            TEST_PRINTF("%s%s: %u Mpx/s per pixel, %u Mpx/s now", cases[i].name, aa ? ", anti-aliased" : "",
+                        (unsigned)((uint64_t)px_cnt * 8 * 1000 / t_ref), (unsigned)((uint64_t)px_cnt * 8 * 1000 / t_res));
+        }
+    }
+
+    free(src);
+    free(cbuf);
+    free(abuf);
+}
+
+#else
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_draw_sw_transform_equivalence(void)
+{
+}
+
+void test_draw_sw_transform_benchmark(void)
+{
+}
+
+#endif
+
+#endif
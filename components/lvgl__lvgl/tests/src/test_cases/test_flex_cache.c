@@ -0,0 +1,332 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+
+/*Two copies of the same flex container get the same random changes. The reference copy is laid out from scratch
+ *every time (its cache is dropped before the layout), the other one incrementally. Both are laid out once per step,
+ *so the layouts depending on the earlier ones (e.g. wrapping with grow items) have the same history.
+ *The items have to be at the same place in both. The relayout times are printed as a benchmark.*/
+
+#if LV_USE_FLEX && LV_FLEX_CACHE
+
+#include <time.h>
+
+#define ITEM_CNT    24
+#define STEP_CNT    300
+#define GAP         5
+
+typedef struct {
+    lv_flex_flow_t flow;
+    lv_flex_align_t main_place;
+    lv_flex_align_t cross_place;
+    lv_flex_align_t track_place;
+    lv_base_dir_t base_dir;
+    bool content_cross;     /*The size across the tracks depends on the items*/
+} flex_setup_t;
+
+static uint32_t rnd_state;
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static uint32_t rnd(uint32_t max)
+{
+    rnd_state ^= rnd_state << 13;
+    rnd_state ^= rnd_state >> 17;
+    rnd_state ^= rnd_state << 5;
+    return rnd_state % max;
+}
+
+static lv_obj_t * create_cont(const flex_setup_t * setup)
+{
+    lv_obj_t * cont = lv_obj_create(lv_scr_act());
+    lv_obj_set_pos(cont, 10, 10);
+    lv_obj_set_size(cont, 400, 300);
+    if(setup->content_cross) {
+        if(setup->flow & _LV_FLEX_COLUMN) lv_obj_set_width(cont, LV_SIZE_CONTENT);
+        else lv_obj_set_height(cont, LV_SIZE_CONTENT);
+    }
+    lv_obj_set_flex_flow(cont, setup->flow);
+    lv_obj_set_flex_align(cont, setup->main_place, setup->cross_place, setup->track_place);
+    lv_obj_set_style_base_dir(cont, setup->base_dir, 0);
+    lv_obj_set_style_pad_gap(cont, GAP, 0);
+
+    uint32_t i;
+    for(i = 0; i < ITEM_CNT; i++) {
+        lv_obj_t * item;
+        if(i % 3 == 0) {
+            item = lv_label_create(cont);
+            lv_label_set_text(item, "Water valve");
+        }
+        else {
+            item = lv_obj_create(cont);
+            lv_obj_set_size(item, 20 + (i * 7) % 50, 15 + (i * 5) % 30);
+        }
+    }
+
+    return cont;
+}
+
+static void apply_change(lv_obj_t * cont, uint32_t op, uint32_t a, uint32_t b)
+{
+    uint32_t cnt = lv_obj_get_child_cnt(cont);
+    lv_obj_t * item = lv_obj_get_child(cont, a % cnt);
+    bool label = lv_obj_check_type(item, &lv_label_class);
+    static const char * texts[] = {"ON", "OFF", "Central vacuum", "Vacuum pump: ON", ""};
+
+    switch(op) {
+        case 0:
+            if(label) lv_label_set_text(item, texts[b % 5]);
+            else lv_obj_set_size(item, 5 + b % 60, 5 + (b / 7) % 40);
+            break;
+        case 1:
+            if(lv_obj_has_flag(item, LV_OBJ_FLAG_HIDDEN)) lv_obj_clear_flag(item, LV_OBJ_FLAG_HIDDEN);
+            else lv_obj_add_flag(item, LV_OBJ_FLAG_HIDDEN);
+            break;
+        case 2:
+            /*Without grow the grown size is kept until the next layout, so it would depend on the number of layouts*/
+            lv_obj_set_flex_grow(item, 1 + b % 2);
+            break;
+        case 3:
+            lv_obj_set_style_translate_x(item, b % 9 - 4, 0);
+            lv_obj_set_style_translate_y(item, b % 2 ? lv_pct(10) : 0, 0);
+            break;
+        case 4:
+            if(lv_obj_has_flag(item, LV_OBJ_FLAG_FLEX_IN_NEW_TRACK)) lv_obj_clear_flag(item, LV_OBJ_FLAG_FLEX_IN_NEW_TRACK);
+            else lv_obj_add_flag(item, LV_OBJ_FLAG_FLEX_IN_NEW_TRACK);
+            break;
+        case 5:
+            lv_obj_move_to_index(item, b % cnt);
+            break;
+        case 6:
+            if(cnt < ITEM_CNT + 8) {
+                lv_obj_t * new_item = lv_obj_create(cont);
+                lv_obj_set_size(new_item, 10 + b % 40, 10 + b % 25);
+                lv_obj_move_to_index(new_item, a % cnt);
+            }
+            break;
+        case 7:
+            if(cnt > ITEM_CNT - 8) lv_obj_del(item);
+            break;
+        case 8:
+            /*Keep the scroll position valid, else only the reference copy would readjust it after the layout*/
+            lv_obj_update_layout(cont);
+            lv_obj_scroll_by_bounded(cont, 0, b % 21 - 10, LV_ANIM_OFF);
+            break;
+        case 9:
+            lv_obj_set_style_min_width(item, b % 2 ? 40 : 0, 0);
+            lv_obj_set_style_max_height(item, b % 3 ? LV_COORD_MAX : 30, 0);
+            break;
+        case 10:
+            lv_obj_set_style_pad_row(cont, GAP + b % 3, 0);
+            break;
+        case 11:
+            if(lv_obj_has_flag(item, LV_OBJ_FLAG_FLOATING)) {
+                lv_obj_clear_flag(item, LV_OBJ_FLAG_FLOATING);
+            }
+            else {
+                lv_obj_add_flag(item, LV_OBJ_FLAG_FLOATING);
+                lv_obj_set_pos(item, b % 100, b % 50);
+            }
+            break;
+        default:
+            /*The size of the container along the tracks*/
+            if(lv_obj_get_style_flex_flow(cont, 0) & _LV_FLEX_COLUMN) lv_obj_set_height(cont, 250 + b % 100);
+            else lv_obj_set_width(cont, 300 + b % 150);
+            break;
+    }
+}
+
+static void check_same(lv_obj_t * cont, lv_obj_t * ref, uint32_t step)
+{
+    TEST_ASSERT_EQUAL(lv_obj_get_child_cnt(ref), lv_obj_get_child_cnt(cont));
+    TEST_ASSERT_EQUAL(lv_obj_get_width(ref), lv_obj_get_width(cont));
+    TEST_ASSERT_EQUAL(lv_obj_get_height(ref), lv_obj_get_height(cont));
+
+    uint32_t i;
+    for(i = 0; i < lv_obj_get_child_cnt(cont); i++) {
+        lv_obj_t * a = lv_obj_get_child(cont, i);
+        lv_obj_t * b = lv_obj_get_child(ref, i);
+        if(!_lv_area_is_equal(&a->coords, &b->coords)) {
+            TEST_PRINTF("step %u, item %u: %d;%d %dx%d instead of %d;%d %dx%d", (unsigned)step, (unsigned)i,
+                        a->coords.x1, a->coords.y1, lv_obj_get_width(a), lv_obj_get_height(a),
+                        b->coords.x1, b->coords.y1, lv_obj_get_width(b), lv_obj_get_height(b));
+            TEST_FAIL_MESSAGE("the incremental layout is different");
+        }
+    }
+}
+
+static void run_changes(const flex_setup_t * setup)
+{
+    lv_obj_t * cont = create_cont(setup);
+    lv_obj_t * ref = create_cont(setup);
+    lv_obj_update_layout(cont);
+    check_same(cont, ref, 0);
+
+    uint32_t step;
+    for(step = 1; step <= STEP_CNT; step++) {
+        uint32_t change_cnt = 1 + rnd(2);
+        while(change_cnt--) {
+            uint32_t op = rnd(13);
+            /*Changing the container itself is less common*/
+            if(op >= 10 && rnd(4)) op = 0;
+            uint32_t a = rnd(1000);
+            uint32_t b = rnd(1000);
+            apply_change(cont, op, a, b);
+            apply_change(ref, op, a, b);
+        }
+
+        lv_mem_free(ref->spec_attr->flex_cache);
+        ref->spec_attr->flex_cache = NULL;
+        lv_obj_mark_layout_as_dirty(ref);
+        lv_obj_update_layout(ref);
+
+        check_same(cont, ref, step);
+    }
+
+    lv_obj_del(cont);
+    lv_obj_del(ref);
+}
+
+void setUp(void)
+{
+    rnd_state = 0x12345678;
+}
+
+void tearDown(void)
+{
+    lv_obj_clean(lv_scr_act());
+}
+
+void test_flex_cache_row_wrap(void)
+{
+    flex_setup_t setup = {LV_FLEX_FLOW_ROW_WRAP, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_START, LV_BASE_DIR_LTR, false};
+    run_changes(&setup);
+
+    setup.cross_place = LV_FLEX_ALIGN_CENTER;
+    run_changes(&setup);
+
+    setup.main_place = LV_FLEX_ALIGN_SPACE_BETWEEN;
+    setup.content_cross = true;
+    run_changes(&setup);
+
+    /*Not cached (wrapping with grow items or content sized), but still has to work*/
+    setup.main_place = LV_FLEX_ALIGN_START;
+    run_changes(&setup);
+}
+
+void test_flex_cache_column(void)
+{
+    flex_setup_t setup = {LV_FLEX_FLOW_COLUMN, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_START, LV_BASE_DIR_LTR, false};
+    run_changes(&setup);
+
+    setup.cross_place = LV_FLEX_ALIGN_END;
+    run_changes(&setup);
+
+    setup.flow = LV_FLEX_FLOW_COLUMN_REVERSE;
+    run_changes(&setup);
+
+    setup.flow = LV_FLEX_FLOW_COLUMN_WRAP;
+    run_changes(&setup);
+
+    /*Not cached (content sized)*/
+    setup.content_cross = true;
+    run_changes(&setup);
+}
+
+void test_flex_cache_reverse_rtl(void)
+{
+    flex_setup_t setup = {LV_FLEX_FLOW_ROW_WRAP_REVERSE, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_START, LV_BASE_DIR_LTR, false};
+    run_changes(&setup);
+
+    setup.base_dir = LV_BASE_DIR_RTL;
+    run_changes(&setup);
+
+    /*Not cached, but still has to work*/
+    setup.track_place = LV_FLEX_ALIGN_CENTER;
+    run_changes(&setup);
+}
+
+void test_flex_cache_benchmark(void)
+{
+    static const uint32_t row_cnts[] = {10, 100, 1000};
+    static const char * texts[] = {"Vacuum pump: ON", "Vacuum pump: OFF"};
+    uint32_t i;
+    for(i = 0; i < sizeof(row_cnts) / sizeof(row_cnts[0]); i++) {
+        /*Like the switch container of the controller, with more rows.
+         *The rows are content sized, so a new text changes only the width of its row.*/
+        lv_obj_t * cont = lv_obj_create(lv_scr_act());
+        lv_obj_set_size(cont, 320, 200);
+        lv_obj_set_flex_flow(cont, LV_FLEX_FLOW_COLUMN);
+
+        lv_obj_t * label = NULL;
+        uint32_t r;
+        for(r = 0; r < row_cnts[i]; r++) {
+            lv_obj_t * row = lv_obj_create(cont);
+            lv_obj_set_size(row, LV_SIZE_CONTENT, LV_SIZE_CONTENT);
+            lv_obj_set_flex_flow(row, LV_FLEX_FLOW_ROW);
+            lv_switch_create(row);
+            lv_obj_t * l = lv_label_create(row);
+            lv_label_set_text(l, "Vacuum pump: OFF");
+            if(r == row_cnts[i] / 2) label = l;
+        }
+        lv_obj_update_layout(cont);
+
+        /*The layout after the same label changes with and without the cache, interleaved to share the noise*/
+        uint64_t t_uncached = 0;
+        uint64_t t_cached = 0;
+        uint32_t j;
+        for(j = 0; j < 100; j++) {
+            bool cached = (j / 2 + j) % 2;  /*Both with both texts*/
+            lv_label_set_text(label, texts[j % 2]);
+            if(!cached) {
+                lv_mem_free(cont->spec_attr->flex_cache);
+                cont->spec_attr->flex_cache = NULL;
+            }
+            uint64_t t = now_ns();
+            lv_obj_update_layout(cont);
+            if(cached) t_cached += now_ns() - t;
+            else t_uncached += now_ns() - t;
+        }
+
+        TEST_PRINTF("%u rows, after a label change: %u us without the cache, %u us with the cache",
+                    (unsigned)row_cnts[i], (unsigned)(t_uncached / 50000), (unsigned)(t_cached / 50000));
+
+        lv_obj_del(cont);
+    }
+}
+
+#else
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_flex_cache_row_wrap(void)
+{
+}
+
+void test_flex_cache_column(void)
+{
+}
+
+void test_flex_cache_reverse_rtl(void)
+{
+}
+
+void test_flex_cache_benchmark(void)
+{
+}
+
+#endif
+
+#endif
@@ -0,0 +1,114 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+
+/*Labels with a compressed font are rendered with and without caching the decompressed glyphs.
+ *The result has to be the same pixel by pixel. The render times are printed as a benchmark.*/
+
+#if LV_USE_FONT_COMPRESSED && LV_FONT_MONTSERRAT_28_COMPRESSED
+
+#include <stdlib.h>
+#include <time.h>
+
+#define FRAMES      20
+#define LABEL_CNT   12
+
+static lv_color_t * ref_buf;
+
+extern lv_color_t test_fb[];
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/*Render the screen a few times and return the average time of a frame*/
+static uint64_t render(uint32_t cache_size)
+{
+    lv_font_fmt_txt_set_bitmap_cache_size(cache_size);
+
+    uint64_t t_sum = 0;
+    uint32_t i;
+    for(i = 0; i < FRAMES; i++) {
+        lv_memset_ff(test_fb, LV_HOR_RES * LV_VER_RES * sizeof(lv_color_t));
+        lv_obj_invalidate(lv_scr_act());
+        uint64_t t = now_ns();
+        lv_refr_now(NULL);
+        t_sum += now_ns() - t;
+    }
+
+    return t_sum / FRAMES;
+}
+
+void setUp(void)
+{
+    ref_buf = malloc(LV_HOR_RES * LV_VER_RES * sizeof(lv_color_t));
+
+    /*Status texts like the ones on the controller*/
+    static const char * texts[] = {
+        "Water valve: OPEN", "Central vacuum: OFF", "Vacuum pump: ON", "WiFi: connected -54 dBm",
+        "MQTT: 12:04:31 office/relay/1 -> 1", "Camera: 14.8 fps",
+    };
+
+    uint32_t i;
+    for(i = 0; i < LABEL_CNT; i++) {
+        lv_obj_t * label = lv_label_create(lv_scr_act());
+        lv_obj_set_style_text_font(label, &lv_font_montserrat_28_compressed, 0);
+        lv_label_set_text(label, texts[i % (sizeof(texts) / sizeof(texts[0]))]);
+        lv_obj_set_pos(label, (i % 2) * 400, (i / 2) * 40);
+    }
+}
+
+void tearDown(void)
+{
+    lv_font_fmt_txt_set_bitmap_cache_size(LV_FONT_COMPRESSED_CACHE_SIZE);
+    lv_obj_clean(lv_scr_act());
+    free(ref_buf);
+}
+
+void test_font_bitmap_cache_render(void)
+{
+    uint64_t t_no_cache = render(0);
+    lv_memcpy(ref_buf, test_fb, LV_HOR_RES * LV_VER_RES * sizeof(lv_color_t));
+
+    uint64_t t_cache = render(LV_FONT_COMPRESSED_CACHE_SIZE);
+    TEST_ASSERT_EQUAL_MEMORY(ref_buf, test_fb, LV_HOR_RES * LV_VER_RES * sizeof(lv_color_t));
+
+    TEST_PRINTF("%u labels: %u us/frame without glyph cache, %u us/frame with %u bytes of cache", LABEL_CNT,
+                (unsigned)(t_no_cache / 1000), (unsigned)(t_cache / 1000), (unsigned)LV_FONT_COMPRESSED_CACHE_SIZE);
+}
+
+void test_font_bitmap_cache_small(void)
+{
+    render(0);
+    lv_memcpy(ref_buf, test_fb, LV_HOR_RES * LV_VER_RES * sizeof(lv_color_t));
+
+    /*Only a few glyphs fit, they are evicted all the time*/
+    render(600);
+    TEST_ASSERT_EQUAL_MEMORY(ref_buf, test_fb, LV_HOR_RES * LV_VER_RES * sizeof(lv_color_t));
+}
+
+#else
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_font_bitmap_cache_render(void)
+{
+}
+
+void test_font_bitmap_cache_small(void)
+{
+}
+
+#endif
+
+#endif
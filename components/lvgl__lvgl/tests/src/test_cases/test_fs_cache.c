@@ -0,0 +1,451 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+
+/*The file accesses of the font loader and the image decoders are recorded on a copy of the POSIX driver without
+ *cache ('R'), then replayed on a copy with the shared block cache ('P'). The read data has to match the file and
+ *the cache has to need much fewer driver calls than the recorded ones.*/
+
+#if LV_FS_BLOCK_CACHE_SIZE && LV_USE_FS_POSIX && LV_USE_SJPG && LV_USE_PNG
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define FONT_FILE   "src/test_fonts/font_2.fnt"
+#define SJPG_FILE   "../examples/libs/sjpg/small_image.sjpg"
+#define PNG_FILE    "../examples/libs/png/wink.png"
+#define TMP_FILE    "/tmp/lv_test_fs_cache.bin"
+
+#define TRACE_MAX   16384
+#define HANDLE_MAX  4
+
+typedef enum {
+    OP_OPEN,
+    OP_CLOSE,
+    OP_READ,
+    OP_SEEK,
+} op_type_t;
+
+typedef struct {
+    uint8_t type;
+    uint8_t handle;
+    uint8_t whence;
+    uint32_t value;
+} trace_op_t;
+
+static trace_op_t trace[TRACE_MAX];
+static uint32_t trace_len;
+static void * trace_files[HANDLE_MAX];
+
+static lv_fs_drv_t * posix_drv;
+static lv_fs_drv_t rec_drv;
+static lv_fs_drv_t cached_drv;
+static uint32_t cached_seek_cnt;
+
+static uint8_t trace_handle(void * file_d)
+{
+    uint8_t i;
+    for(i = 0; i < HANDLE_MAX; i++) {
+        if(trace_files[i] == file_d) return i;
+    }
+    TEST_FAIL_MESSAGE("unknown file handle");
+    return 0;
+}
+
+static void trace_add(op_type_t type, uint8_t handle, uint32_t value, lv_fs_whence_t whence)
+{
+    TEST_ASSERT_LESS_THAN(TRACE_MAX, trace_len);
+    trace[trace_len].type = type;
+    trace[trace_len].handle = handle;
+    trace[trace_len].value = value;
+    trace[trace_len].whence = whence;
+    trace_len++;
+}
+
+static void * rec_open(lv_fs_drv_t * drv, const char * path, lv_fs_mode_t mode)
+{
+    LV_UNUSED(drv);
+    void * file_d = posix_drv->open_cb(posix_drv, path, mode);
+    uint8_t i;
+    for(i = 0; i < HANDLE_MAX && trace_files[i]; i++);
+    TEST_ASSERT_LESS_THAN(HANDLE_MAX, i);
+    trace_files[i] = file_d;
+    trace_add(OP_OPEN, i, 0, LV_FS_SEEK_SET);
+    return file_d;
+}
+
+static lv_fs_res_t rec_close(lv_fs_drv_t * drv, void * file_p)
+{
+    LV_UNUSED(drv);
+    uint8_t i = trace_handle(file_p);
+    trace_files[i] = NULL;
+    trace_add(OP_CLOSE, i, 0, LV_FS_SEEK_SET);
+    return posix_drv->close_cb(posix_drv, file_p);
+}
+
+static lv_fs_res_t rec_read(lv_fs_drv_t * drv, void * file_p, void * buf, uint32_t btr, uint32_t * br)
+{
+    LV_UNUSED(drv);
+    trace_add(OP_READ, trace_handle(file_p), btr, LV_FS_SEEK_SET);
+    return posix_drv->read_cb(posix_drv, file_p, buf, btr, br);
+}
+
+static lv_fs_res_t rec_seek(lv_fs_drv_t * drv, void * file_p, uint32_t pos, lv_fs_whence_t whence)
+{
+    LV_UNUSED(drv);
+    trace_add(OP_SEEK, trace_handle(file_p), pos, whence);
+    return posix_drv->seek_cb(posix_drv, file_p, pos, whence);
+}
+
+static lv_fs_res_t cached_seek(lv_fs_drv_t * drv, void * file_p, uint32_t pos, lv_fs_whence_t whence)
+{
+    LV_UNUSED(drv);
+    cached_seek_cnt++;
+    return posix_drv->seek_cb(posix_drv, file_p, pos, whence);
+}
+
+void setUp(void)
+{
+    if(posix_drv) return;
+
+    posix_drv = lv_fs_get_drv('B');
+
+    rec_drv = *posix_drv;
+    rec_drv.letter = 'R';
+    rec_drv.cache_size = 0;
+    rec_drv.open_cb = rec_open;
+    rec_drv.close_cb = rec_close;
+    rec_drv.read_cb = rec_read;
+    rec_drv.seek_cb = rec_seek;
+    lv_fs_drv_register(&rec_drv);
+
+    cached_drv = *posix_drv;
+    cached_drv.letter = 'P';
+    cached_drv.cache_size = 1;
+    cached_drv.seek_cb = cached_seek;
+    lv_fs_drv_register(&cached_drv);
+}
+
+void tearDown(void)
+{
+    lv_fs_cache_invalidate(NULL);
+}
+
+static uint8_t * load_file(const char * path, uint32_t * size)
+{
+    FILE * f = fopen(path, "rb");
+    TEST_ASSERT_NOT_NULL(f);
+    fseek(f, 0, SEEK_END);
+    *size = (uint32_t)ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t * data = malloc(*size);
+    TEST_ASSERT_EQUAL_UINT32(*size, fread(data, 1, *size, f));
+    fclose(f);
+    return data;
+}
+
+static uint32_t trace_count(op_type_t type)
+{
+    uint32_t cnt = 0;
+    uint32_t i;
+    for(i = 0; i < trace_len; i++) {
+        if(trace[i].type == type) cnt++;
+    }
+    return cnt;
+}
+
+/*Replay the trace on the cached driver and check every read against the file*/
+static void replay(const char * path)
+{
+    uint32_t size;
+    uint8_t * data = load_file(path, &size);
+    uint8_t * buf = malloc(size + 64);
+    char lv_path[128];
+    lv_snprintf(lv_path, sizeof(lv_path), "P:%s", path);
+
+    lv_fs_file_t files[HANDLE_MAX];
+    uint32_t pos[HANDLE_MAX];
+    uint32_t i;
+    for(i = 0; i < trace_len; i++) {
+        const trace_op_t * op = &trace[i];
+        lv_fs_file_t * f = &files[op->handle];
+        uint32_t br;
+        switch(op->type) {
+            case OP_OPEN:
+                TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_open(f, lv_path, LV_FS_MODE_RD));
+                pos[op->handle] = 0;
+                break;
+            case OP_CLOSE:
+                TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_close(f));
+                break;
+            case OP_READ:
+                TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_read(f, buf, op->value, &br));
+                TEST_ASSERT_EQUAL_UINT32(pos[op->handle] >= size ? 0 : LV_MIN(op->value, size - pos[op->handle]), br);
+                if(br) TEST_ASSERT_EQUAL_MEMORY(data + pos[op->handle], buf, br);
+                pos[op->handle] += br;
+                break;
+            case OP_SEEK:
+                TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_seek(f, op->value, op->whence));
+                if(op->whence == LV_FS_SEEK_SET) pos[op->handle] = op->value;
+                else if(op->whence == LV_FS_SEEK_CUR) pos[op->handle] += op->value;
+                else pos[op->handle] = size + op->value;
+                break;
+        }
+
+        if(op->type != OP_CLOSE) {
+            uint32_t tell;
+            TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_tell(f, &tell));
+            TEST_ASSERT_EQUAL_UINT32(pos[op->handle], tell);
+        }
+
+        lv_fs_cache_stats_t stats;
+        lv_fs_cache_get_stats(&stats);
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32(LV_FS_BLOCK_CACHE_SIZE, stats.size);
+    }
+
+    free(buf);
+    free(data);
+}
+
+/*Replay a recorded trace and return the driver reads needed with the cache*/
+static uint32_t replay_count(const char * name, const char * path)
+{
+    lv_fs_cache_invalidate(NULL);
+    lv_fs_cache_reset_stats();
+    cached_seek_cnt = 0;
+
+    replay(path);
+
+    lv_fs_cache_stats_t stats;
+    lv_fs_cache_get_stats(&stats);
+    TEST_PRINTF("%s: %u reads, %u seeks without cache; %u reads (%u bytes), %u seeks with it, %u/%u hit/miss",
+                name, (unsigned)trace_count(OP_READ), (unsigned)trace_count(OP_SEEK),
+                (unsigned)stats.read_cnt, (unsigned)stats.read_bytes, (unsigned)cached_seek_cnt,
+                (unsigned)stats.hit_cnt, (unsigned)stats.miss_cnt);
+    return stats.read_cnt;
+}
+
+void test_fs_cache_font_loader(void)
+{
+    trace_len = 0;
+    lv_font_t * font = lv_font_load("R:" FONT_FILE);
+    TEST_ASSERT_NOT_NULL(font);
+    lv_font_free(font);
+
+    uint32_t read_cnt = replay_count("font", FONT_FILE);
+    TEST_ASSERT_LESS_THAN(trace_count(OP_READ) / 10, read_cnt);
+}
+
+void test_fs_cache_sjpg(void)
+{
+    trace_len = 0;
+    lv_img_decoder_dsc_t dsc;
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_open(&dsc, "R:" SJPG_FILE, lv_color_black(), 0));
+    TEST_ASSERT_NULL(dsc.img_data);
+
+    /*Jump between the JPG fragments like a partially redrawn, rotated image*/
+    lv_coord_t w = dsc.header.w;
+    lv_coord_t h = dsc.header.h;
+    uint8_t * line = malloc(w * LV_IMG_PX_SIZE_ALPHA_BYTE);
+    lv_coord_t i;
+    for(i = 0; i < h; i += 4) {
+        lv_coord_t y = (i * 37) % h;
+        TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_read_line(&dsc, 0, y, w, line));
+    }
+    free(line);
+    lv_img_decoder_close(&dsc);
+
+    uint32_t read_cnt = replay_count("sjpg", SJPG_FILE);
+    TEST_ASSERT_LESS_THAN(trace_count(OP_READ) / 4, read_cnt);
+}
+
+void test_fs_cache_png(void)
+{
+    trace_len = 0;
+    lv_img_decoder_dsc_t dsc;
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_open(&dsc, "R:" PNG_FILE, lv_color_black(), 0));
+    lv_img_decoder_close(&dsc);
+
+    uint32_t read_cnt = replay_count("png", PNG_FILE);
+    TEST_ASSERT_LESS_THAN(trace_count(OP_READ) / 2, read_cnt);
+}
+
+/*Two places of a file read alternately. A single cache window would read the file on every access.
+ *Both places are in one block, so one driver read each.*/
+void test_fs_cache_windows(void)
+{
+    uint32_t size;
+    uint8_t * data = load_file(SJPG_FILE, &size);
+    lv_fs_cache_reset_stats();
+
+    lv_fs_file_t f;
+    TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_open(&f, "P:" SJPG_FILE, LV_FS_MODE_RD));
+    uint32_t i;
+    for(i = 0; i < 200; i++) {
+        uint32_t pos = (i & 1) ? size / 2 + i % 50 : 20 + i % 50;
+        uint8_t buf[20];
+        uint32_t br;
+        lv_fs_seek(&f, pos, LV_FS_SEEK_SET);
+        TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_read(&f, buf, sizeof(buf), &br));
+        TEST_ASSERT_EQUAL_UINT32(sizeof(buf), br);
+        TEST_ASSERT_EQUAL_MEMORY(data + pos, buf, br);
+    }
+    lv_fs_close(&f);
+
+    lv_fs_cache_stats_t stats;
+    lv_fs_cache_get_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.read_cnt);
+    TEST_ASSERT_EQUAL_UINT32(198, stats.hit_cnt);
+
+    /*The blocks serve the next opening too*/
+    TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_open(&f, "P:" SJPG_FILE, LV_FS_MODE_RD));
+    uint8_t buf[20];
+    uint32_t br;
+    TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_read(&f, buf, sizeof(buf), &br));
+    TEST_ASSERT_EQUAL_MEMORY(data, buf, br);
+    lv_fs_close(&f);
+    lv_fs_cache_get_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.read_cnt);
+
+    free(data);
+}
+
+/*Small sequential reads are read ahead, up to the group size*/
+void test_fs_cache_read_ahead(void)
+{
+    uint32_t size;
+    uint8_t * data = load_file(SJPG_FILE, &size);
+    lv_fs_cache_reset_stats();
+    cached_seek_cnt = 0;
+
+    lv_fs_file_t f;
+    TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_open(&f, "P:" SJPG_FILE, LV_FS_MODE_RD));
+    uint8_t buf[13];
+    uint32_t pos = 0;
+    uint32_t br = 1;
+    while(br) {
+        TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_read(&f, buf, sizeof(buf), &br));
+        if(br) TEST_ASSERT_EQUAL_MEMORY(data + pos, buf, br);
+        pos += br;
+    }
+    TEST_ASSERT_EQUAL_UINT32(size, pos);
+    lv_fs_close(&f);
+
+    lv_fs_cache_stats_t stats;
+    lv_fs_cache_get_stats(&stats);
+    uint32_t group = LV_FS_BLOCK_CACHE_BLOCK_SIZE * LV_FS_BLOCK_CACHE_READ_AHEAD;
+    TEST_ASSERT_EQUAL_UINT32(size, stats.read_bytes);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32((size + group - 1) / group + 3, stats.read_cnt);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, stats.evict_cnt);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(LV_FS_BLOCK_CACHE_SIZE, stats.size);
+    /*Only the seek to the end to measure the file and back*/
+    TEST_ASSERT_EQUAL_UINT32(2, cached_seek_cnt);
+
+    free(data);
+}
+
+/*Random reads on a file larger than the cache*/
+void test_fs_cache_random(void)
+{
+    uint32_t size;
+    uint8_t * data = load_file(SJPG_FILE, &size);
+    uint8_t * buf = malloc(3 * LV_FS_BLOCK_CACHE_BLOCK_SIZE);
+
+    lv_fs_file_t f[2];
+    TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_open(&f[0], "P:" SJPG_FILE, LV_FS_MODE_RD));
+    TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_open(&f[1], "P:" SJPG_FILE, LV_FS_MODE_RD));
+    uint32_t rnd = 1;
+    uint32_t i;
+    for(i = 0; i < 2000; i++) {
+        rnd = rnd * 1103515245 + 12345;
+        uint32_t pos = (rnd >> 8) % (size + 10);
+        uint32_t len = (rnd >> 20) % (3 * LV_FS_BLOCK_CACHE_BLOCK_SIZE);
+        uint32_t br;
+        lv_fs_seek(&f[i & 1], pos, LV_FS_SEEK_SET);
+        TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_read(&f[i & 1], buf, len, &br));
+        TEST_ASSERT_EQUAL_UINT32(pos >= size ? 0 : LV_MIN(len, size - pos), br);
+        if(br) TEST_ASSERT_EQUAL_MEMORY(data + pos, buf, br);
+
+        lv_fs_cache_stats_t stats;
+        lv_fs_cache_get_stats(&stats);
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32(LV_FS_BLOCK_CACHE_SIZE, stats.size);
+    }
+    lv_fs_close(&f[0]);
+    lv_fs_close(&f[1]);
+
+    free(buf);
+    free(data);
+}
+
+/*Writing a file drops its cached blocks*/
+void test_fs_cache_write(void)
+{
+    static const char text_1[] = "The first version of the file";
+    static const char text_2[] = "The other version of the file";
+    char buf[sizeof(text_1)];
+    uint32_t n;
+    lv_fs_file_t f;
+
+    TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_open(&f, "P:" TMP_FILE, LV_FS_MODE_WR));
+    TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_write(&f, text_1, sizeof(text_1), &n));
+    lv_fs_close(&f);
+
+    TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_open(&f, "P:" TMP_FILE, LV_FS_MODE_RD));
+    TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_read(&f, buf, sizeof(buf), &n));
+    TEST_ASSERT_EQUAL_STRING(text_1, buf);
+    lv_fs_close(&f);
+
+    TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_open(&f, "P:" TMP_FILE, LV_FS_MODE_WR));
+    TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_write(&f, text_2, sizeof(text_2), &n));
+    lv_fs_close(&f);
+
+    TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_open(&f, "P:" TMP_FILE, LV_FS_MODE_RD));
+    TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_read(&f, buf, sizeof(buf), &n));
+    TEST_ASSERT_EQUAL_STRING(text_2, buf);
+    lv_fs_close(&f);
+
+    remove(TMP_FILE);
+}
+
+#else
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_fs_cache_font_loader(void)
+{
+}
+
+void test_fs_cache_sjpg(void)
+{
+}
+
+void test_fs_cache_png(void)
+{
+}
+
+void test_fs_cache_windows(void)
+{
+}
+
+void test_fs_cache_read_ahead(void)
+{
+}
+
+void test_fs_cache_random(void)
+{
+}
+
+void test_fs_cache_write(void)
+{
+}
+
+#endif
+
+#endif
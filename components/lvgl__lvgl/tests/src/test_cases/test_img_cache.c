@@ -0,0 +1,301 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+
+/*A test decoder "decodes" RAW variables to a generated ARGB image allocated on every open.
+ *The cache has to serve the repeated opens, evict the least recently used images by the byte
+ *and entry limits and keep the images which are still drawn alive until they are released.*/
+
+#if LV_IMG_CACHE_DEF_SIZE
+
+#define IMG_W       40
+#define IMG_H       30
+#define IMG_SIZE    (IMG_W * IMG_H * LV_IMG_PX_SIZE_ALPHA_BYTE)
+#define IMG_CNT     6
+
+static lv_img_decoder_t * decoder;
+static lv_img_dsc_t imgs[IMG_CNT];
+static uint32_t open_cnt;
+static uint32_t close_cnt;
+
+static lv_res_t test_info_cb(lv_img_decoder_t * dec, const void * src, lv_img_header_t * header)
+{
+    LV_UNUSED(dec);
+    if(lv_img_src_get_type(src) != LV_IMG_SRC_VARIABLE) return LV_RES_INV;
+
+    const lv_img_dsc_t * img_dsc = src;
+    if(img_dsc->header.cf != LV_IMG_CF_RAW) return LV_RES_INV;
+
+    header->w = img_dsc->header.w;
+    header->h = img_dsc->header.h;
+    header->cf = LV_IMG_CF_TRUE_COLOR_ALPHA;
+    return LV_RES_OK;
+}
+
+static lv_res_t test_open_cb(lv_img_decoder_t * dec, lv_img_decoder_dsc_t * dsc)
+{
+    LV_UNUSED(dec);
+    if(test_info_cb(dec, dsc->src, &dsc->header) != LV_RES_OK) return LV_RES_INV;
+
+    const lv_img_dsc_t * img_dsc = dsc->src;
+    uint8_t * data = lv_mem_alloc(IMG_SIZE);
+    uint32_t i;
+    for(i = 0; i < IMG_SIZE; i++) data[i] = (uint8_t)(img_dsc->data[0] + i);
+    dsc->img_data = data;
+    open_cnt++;
+    return LV_RES_OK;
+}
+
+static void test_close_cb(lv_img_decoder_t * dec, lv_img_decoder_dsc_t * dsc)
+{
+    LV_UNUSED(dec);
+    lv_mem_free((void *)dsc->img_data);
+    dsc->img_data = NULL;
+    close_cnt++;
+}
+
+static void check_data(const _lv_img_cache_entry_t * entry, const lv_img_dsc_t * img_dsc)
+{
+    uint32_t i;
+    for(i = 0; i < IMG_SIZE; i++) {
+        TEST_ASSERT_EQUAL_UINT8((uint8_t)(img_dsc->data[0] + i), entry->dec_dsc.img_data[i]);
+    }
+}
+
+/*Open and release an image, return the number of decodes it caused*/
+static uint32_t draw(const lv_img_dsc_t * img_dsc)
+{
+    uint32_t open_cnt_ori = open_cnt;
+    _lv_img_cache_entry_t * entry = _lv_img_cache_open(img_dsc, lv_color_black(), 0);
+    TEST_ASSERT_NOT_NULL(entry);
+    check_data(entry, img_dsc);
+    _lv_img_cache_release(entry);
+    return open_cnt - open_cnt_ori;
+}
+
+/*Byte budget which fits `cnt` images*/
+static size_t mem_for(uint32_t cnt)
+{
+    return cnt * (IMG_SIZE + sizeof(_lv_img_cache_entry_t) + 64);
+}
+
+void setUp(void)
+{
+    decoder = lv_img_decoder_create();
+    lv_img_decoder_set_info_cb(decoder, test_info_cb);
+    lv_img_decoder_set_open_cb(decoder, test_open_cb);
+    lv_img_decoder_set_close_cb(decoder, test_close_cb);
+
+    static uint8_t seeds[IMG_CNT];
+    uint32_t i;
+    for(i = 0; i < IMG_CNT; i++) {
+        seeds[i] = (uint8_t)(i * 37);
+        imgs[i].header.cf = LV_IMG_CF_RAW;
+        imgs[i].header.w = IMG_W;
+        imgs[i].header.h = IMG_H;
+        imgs[i].data = &seeds[i];
+        imgs[i].data_size = 1;
+    }
+
+    open_cnt = 0;
+    close_cnt = 0;
+    lv_img_cache_set_mem_size(LV_IMG_CACHE_DEF_MEM_SIZE);
+    lv_img_cache_set_size(LV_IMG_CACHE_DEF_SIZE);
+}
+
+void tearDown(void)
+{
+    lv_img_cache_invalidate_src(NULL);
+    lv_img_decoder_delete(decoder);
+    TEST_ASSERT_EQUAL_UINT32(open_cnt, close_cnt);
+}
+
+void test_img_cache_hit(void)
+{
+    lv_img_cache_stats_t s1;
+    lv_img_cache_stats_t s2;
+    lv_img_cache_get_stats(&s1);
+
+    uint32_t i;
+    for(i = 0; i < IMG_CNT; i++) TEST_ASSERT_EQUAL_UINT32(1, draw(&imgs[i]));
+    for(i = 0; i < IMG_CNT; i++) TEST_ASSERT_EQUAL_UINT32(0, draw(&imgs[i]));
+
+    lv_img_cache_get_stats(&s2);
+    TEST_ASSERT_EQUAL_UINT32(IMG_CNT, s2.miss_cnt - s1.miss_cnt);
+    TEST_ASSERT_EQUAL_UINT32(IMG_CNT, s2.hit_cnt - s1.hit_cnt);
+    TEST_ASSERT_EQUAL_UINT16(IMG_CNT, s2.entry_cnt);
+    TEST_ASSERT_GREATER_OR_EQUAL(IMG_CNT * IMG_SIZE, s2.mem_size);
+    TEST_ASSERT_LESS_OR_EQUAL(s2.mem_max, s2.mem_size);
+
+    /*Another color or frame is another entry*/
+    _lv_img_cache_entry_t * entry = _lv_img_cache_open(&imgs[0], lv_color_white(), 0);
+    _lv_img_cache_release(entry);
+    entry = _lv_img_cache_open(&imgs[0], lv_color_black(), 1);
+    _lv_img_cache_release(entry);
+    TEST_ASSERT_EQUAL_UINT32(IMG_CNT + 2, open_cnt);
+
+#ifdef LV_IMG_CACHE_MEM_ALLOC
+    /*The pixels are copied and the decoder is closed right away*/
+    TEST_ASSERT_EQUAL_UINT32(open_cnt, close_cnt);
+#endif
+}
+
+void test_img_cache_lru_by_mem_size(void)
+{
+    lv_img_cache_set_mem_size(mem_for(3));
+
+    draw(&imgs[0]);
+    draw(&imgs[1]);
+    draw(&imgs[2]);
+
+    /*0 becomes the most recently used so 1 is evicted by 3*/
+    TEST_ASSERT_EQUAL_UINT32(0, draw(&imgs[0]));
+    TEST_ASSERT_EQUAL_UINT32(1, draw(&imgs[3]));
+    TEST_ASSERT_EQUAL_UINT32(0, draw(&imgs[0]));
+    TEST_ASSERT_EQUAL_UINT32(0, draw(&imgs[2]));
+    TEST_ASSERT_EQUAL_UINT32(0, draw(&imgs[3]));
+    TEST_ASSERT_EQUAL_UINT32(1, draw(&imgs[1]));
+
+    lv_img_cache_stats_t s;
+    lv_img_cache_get_stats(&s);
+    TEST_ASSERT_EQUAL_UINT16(3, s.entry_cnt);
+    TEST_ASSERT_LESS_OR_EQUAL(mem_for(3), s.mem_size);
+}
+
+void test_img_cache_lru_by_entry_cnt(void)
+{
+    lv_img_cache_set_size(2);
+
+    draw(&imgs[0]);
+    draw(&imgs[1]);
+    draw(&imgs[0]);
+    TEST_ASSERT_EQUAL_UINT32(1, draw(&imgs[2]));
+    TEST_ASSERT_EQUAL_UINT32(0, draw(&imgs[0]));
+    TEST_ASSERT_EQUAL_UINT32(1, draw(&imgs[1]));
+
+    lv_img_cache_stats_t s;
+    lv_img_cache_get_stats(&s);
+    TEST_ASSERT_EQUAL_UINT16(2, s.entry_cnt);
+}
+
+void test_img_cache_keep_used_entry(void)
+{
+    lv_img_cache_set_mem_size(mem_for(2));
+
+    _lv_img_cache_entry_t * used = _lv_img_cache_open(&imgs[0], lv_color_black(), 0);
+    TEST_ASSERT_NOT_NULL(used);
+
+    /*Push the used entry out of the cache. It has to stay valid until it's released.*/
+    uint32_t i;
+    for(i = 1; i < IMG_CNT; i++) draw(&imgs[i]);
+    lv_img_cache_invalidate_src(&imgs[0]);
+    check_data(used, &imgs[0]);
+
+    uint32_t close_cnt_ori = close_cnt;
+    _lv_img_cache_release(used);
+#ifndef LV_IMG_CACHE_MEM_ALLOC
+    TEST_ASSERT_EQUAL_UINT32(close_cnt_ori + 1, close_cnt);
+#else
+    LV_UNUSED(close_cnt_ori);
+#endif
+
+    TEST_ASSERT_EQUAL_UINT32(1, draw(&imgs[0]));
+}
+
+void test_img_cache_invalidate(void)
+{
+    draw(&imgs[0]);
+    draw(&imgs[1]);
+    _lv_img_cache_entry_t * entry = _lv_img_cache_open(&imgs[0], lv_color_white(), 0);
+    _lv_img_cache_release(entry);
+
+    /*All colors of the source are dropped*/
+    lv_img_cache_invalidate_src(&imgs[0]);
+    TEST_ASSERT_EQUAL_UINT32(1, draw(&imgs[0]));
+    TEST_ASSERT_EQUAL_UINT32(0, draw(&imgs[1]));
+
+    lv_img_cache_stats_t s;
+    lv_img_cache_get_stats(&s);
+    TEST_ASSERT_EQUAL_UINT16(2, s.entry_cnt);
+
+    lv_img_cache_invalidate_src(NULL);
+    lv_img_cache_get_stats(&s);
+    TEST_ASSERT_EQUAL_UINT16(0, s.entry_cnt);
+    TEST_ASSERT_EQUAL(0, s.mem_size);
+}
+
+void test_img_cache_too_large(void)
+{
+    lv_img_cache_set_mem_size(IMG_SIZE / 2);
+
+    /*Decoded on every open and freed on release*/
+    TEST_ASSERT_EQUAL_UINT32(1, draw(&imgs[0]));
+    TEST_ASSERT_EQUAL_UINT32(1, draw(&imgs[0]));
+    TEST_ASSERT_EQUAL_UINT32(open_cnt, close_cnt);
+
+    lv_img_cache_stats_t s;
+    lv_img_cache_get_stats(&s);
+    TEST_ASSERT_EQUAL_UINT16(0, s.entry_cnt);
+}
+
+void test_img_cache_draw(void)
+{
+    /*Every image widget is decoded only once while the screen is redrawn*/
+    uint32_t i;
+    for(i = 0; i < IMG_CNT; i++) {
+        lv_obj_t * img = lv_img_create(lv_scr_act());
+        lv_img_set_src(img, &imgs[i]);
+        lv_obj_set_pos(img, i * 50, 10);
+    }
+
+    for(i = 0; i < 5; i++) {
+        lv_obj_invalidate(lv_scr_act());
+        lv_refr_now(NULL);
+    }
+    TEST_ASSERT_EQUAL_UINT32(IMG_CNT, open_cnt);
+
+    lv_obj_clean(lv_scr_act());
+}
+
+#else
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_img_cache_hit(void)
+{
+}
+
+void test_img_cache_lru_by_mem_size(void)
+{
+}
+
+void test_img_cache_lru_by_entry_cnt(void)
+{
+}
+
+void test_img_cache_keep_used_entry(void)
+{
+}
+
+void test_img_cache_invalidate(void)
+{
+}
+
+void test_img_cache_too_large(void)
+{
+}
+
+void test_img_cache_draw(void)
+{
+}
+
+#endif
+
+#endif
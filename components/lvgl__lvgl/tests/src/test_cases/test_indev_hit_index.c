@@ -0,0 +1,241 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+
+/*The objects found with the hit index of a screen has to be the same as the ones found by the recursive
+ *search on the same screen, while the objects are created, moved, scrolled, hidden, reparented and deleted.
+ *The query times with and without index are printed as a benchmark.*/
+
+#if LV_INDEV_HIT_INDEX_CELL_SIZE
+
+#include <time.h>
+
+#define POINT_CNT   2000
+#define BENCH_CNT   3000
+
+static lv_obj_t * scr;
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/*Does what `lv_indev_search_obj` does on a screen without hit index*/
+static lv_obj_t * search_recursive(lv_point_t * point)
+{
+    if(lv_obj_has_flag(scr, LV_OBJ_FLAG_HIDDEN)) return NULL;
+
+    if(_lv_area_is_point_on(&scr->coords, point, 0) || lv_obj_has_flag(scr, LV_OBJ_FLAG_OVERFLOW_VISIBLE)) {
+        int32_t i;
+        for(i = lv_obj_get_child_cnt(scr) - 1; i >= 0; i--) {
+            lv_obj_t * found = lv_indev_search_obj(lv_obj_get_child(scr, i), point);
+            if(found) return found;
+        }
+    }
+
+    return lv_obj_hit_test(scr, point) ? scr : NULL;
+}
+
+static void check_points(void)
+{
+    uint32_t i;
+    for(i = 0; i < POINT_CNT; i++) {
+        lv_point_t p;
+        p.x = lv_rand(0, LV_HOR_RES + 40) - 20;
+        p.y = lv_rand(0, LV_VER_RES + 40) - 20;
+
+        lv_obj_t * ref = search_recursive(&p);
+        lv_obj_t * found = lv_indev_search_obj(scr, &p);
+        if(ref != found) {
+            TEST_PRINTF("at %d;%d: %p instead of %p", p.x, p.y, (void *)found, (void *)ref);
+            TEST_FAIL_MESSAGE("different object found with the hit index");
+        }
+    }
+}
+
+void setUp(void)
+{
+    scr = lv_obj_create(NULL);
+    lv_indev_hit_index_enable(scr, true);
+}
+
+void tearDown(void)
+{
+    /*Deletes the index too*/
+    lv_obj_del(scr);
+}
+
+void test_indev_hit_index_changes(void)
+{
+    /*A scrolled list*/
+    lv_obj_t * list = lv_obj_create(scr);
+    lv_obj_set_size(list, 300, 400);
+    lv_obj_set_pos(list, 10, 10);
+    lv_obj_set_flex_flow(list, LV_FLEX_FLOW_COLUMN);
+
+    uint32_t i;
+    for(i = 0; i < 40; i++) {
+        lv_obj_t * btn = lv_btn_create(list);
+        lv_obj_set_width(btn, lv_pct(100));
+        lv_obj_t * label = lv_label_create(btn);
+        lv_label_set_text_fmt(label, "Button %d", (int)i);
+        if(i % 7 == 3) lv_obj_add_state(btn, LV_STATE_DISABLED);
+        if(i % 11 == 5) lv_obj_add_flag(label, LV_OBJ_FLAG_CLICKABLE);
+    }
+
+    /*A grid with overlapping and sticking out children*/
+    static lv_coord_t col_dsc[] = {80, 80, 80, LV_GRID_TEMPLATE_LAST};
+    static lv_coord_t row_dsc[] = {60, 60, 60, LV_GRID_TEMPLATE_LAST};
+    lv_obj_t * grid = lv_obj_create(scr);
+    lv_obj_set_size(grid, 300, 260);
+    lv_obj_set_pos(grid, 380, 20);
+    lv_obj_set_grid_dsc_array(grid, col_dsc, row_dsc);
+    lv_obj_add_flag(grid, LV_OBJ_FLAG_OVERFLOW_VISIBLE);
+    for(i = 0; i < 9; i++) {
+        lv_obj_t * btn = lv_btn_create(grid);
+        lv_obj_set_grid_cell(btn, LV_GRID_ALIGN_STRETCH, i % 3, 1, LV_GRID_ALIGN_STRETCH, i / 3, 1);
+        lv_obj_t * badge = lv_obj_create(btn);
+        lv_obj_set_size(badge, 30, 30);
+        lv_obj_set_pos(badge, 50, -20);
+        if(i % 2) lv_obj_add_flag(btn, LV_OBJ_FLAG_OVERFLOW_VISIBLE);
+    }
+
+    /*Free floating objects*/
+    lv_obj_t * floating[8];
+    for(i = 0; i < 8; i++) {
+        floating[i] = lv_obj_create(scr);
+        lv_obj_set_size(floating[i], 100, 70);
+        lv_obj_set_pos(floating[i], 320 + i * 55, 250 + (i % 3) * 50);
+        if(i % 3 == 0) lv_obj_set_ext_click_area(floating[i], 15);
+    }
+
+    lv_obj_update_layout(scr);
+    check_points();
+
+    lv_obj_scroll_to_y(list, 300, LV_ANIM_OFF);
+    check_points();
+
+    lv_obj_scroll_by(grid, 0, -40, LV_ANIM_OFF);
+    lv_obj_set_pos(floating[1], 700, 400);
+    lv_obj_set_size(floating[2], 200, 200);
+    lv_obj_update_layout(scr);
+    check_points();
+
+    lv_obj_add_flag(floating[3], LV_OBJ_FLAG_HIDDEN);
+    lv_obj_clear_flag(floating[4], LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_add_state(floating[5], LV_STATE_DISABLED);
+    lv_obj_add_flag(lv_obj_get_child(list, 12), LV_OBJ_FLAG_HIDDEN);
+    lv_obj_set_ext_click_area(floating[6], 30);
+    lv_obj_update_layout(scr);
+    check_points();
+
+    lv_obj_move_to_index(floating[0], -1);
+    lv_obj_move_to_index(list, -1);
+    lv_obj_set_parent(floating[7], list);
+    lv_obj_set_parent(lv_obj_get_child(list, 20), scr);
+    lv_obj_update_layout(scr);
+    check_points();
+
+    lv_obj_del(lv_obj_get_child(list, 15));
+    lv_obj_del(floating[2]);
+    lv_obj_clean(lv_obj_get_child(grid, 4));
+    lv_obj_set_size(scr, 600, 400);
+    lv_obj_update_layout(scr);
+    check_points();
+
+    /*Objects with advanced hit test are asked only if the point is on them*/
+    lv_obj_t * round = lv_btn_create(scr);
+    lv_obj_set_size(round, 120, 120);
+    lv_obj_set_pos(round, 100, 100);
+    lv_obj_set_style_radius(round, LV_RADIUS_CIRCLE, 0);
+    lv_obj_add_flag(round, LV_OBJ_FLAG_ADV_HITTEST);
+    lv_obj_update_layout(scr);
+    check_points();
+
+    /*Transformed objects make the index fall back to the recursive search*/
+    lv_obj_set_style_transform_angle(floating[6], 300, 0);
+    check_points();
+    lv_obj_set_style_transform_angle(floating[6], 0, 0);
+    check_points();
+
+    lv_obj_set_parent(floating[6], lv_layer_top());
+    lv_obj_update_layout(scr);
+    check_points();
+    lv_obj_del(floating[6]);
+}
+
+void test_indev_hit_index_benchmark(void)
+{
+    lv_obj_t * cont = lv_obj_create(scr);
+    lv_obj_set_size(cont, lv_pct(100), lv_pct(100));
+    lv_obj_set_flex_flow(cont, LV_FLEX_FLOW_ROW_WRAP);
+    lv_obj_set_style_pad_all(cont, 4, 0);
+    lv_obj_set_style_pad_gap(cont, 4, 0);
+
+    uint32_t i;
+    for(i = 0; i < BENCH_CNT; i++) {
+        lv_obj_t * obj = lv_obj_create(cont);
+        lv_obj_set_size(obj, 20, 20);
+    }
+    lv_obj_update_layout(scr);
+    lv_obj_scroll_to_y(cont, 1000, LV_ANIM_OFF);
+
+    static lv_point_t points[POINT_CNT];
+    static lv_obj_t * found[POINT_CNT];
+    for(i = 0; i < POINT_CNT; i++) {
+        points[i].x = lv_rand(0, LV_HOR_RES - 1);
+        points[i].y = lv_rand(0, LV_VER_RES - 1);
+    }
+
+    uint64_t t = now_ns();
+    for(i = 0; i < POINT_CNT; i++) found[i] = lv_indev_search_obj(scr, &points[i]);
+    uint64_t t_index = now_ns() - t;
+
+    lv_indev_hit_index_enable(scr, false);
+    t = now_ns();
+    for(i = 0; i < POINT_CNT; i++) {
+        TEST_ASSERT_EQUAL_PTR(found[i], lv_indev_search_obj(scr, &points[i]));
+    }
+    uint64_t t_recursive = now_ns() - t;
+
+    /*Updating the index on scroll has a cost too*/
+    lv_indev_hit_index_enable(scr, true);
+    t = now_ns();
+    for(i = 0; i < 20; i++) lv_obj_scroll_by(cont, 0, i % 2 ? 50 : -50, LV_ANIM_OFF);
+    uint64_t t_scroll_index = now_ns() - t;
+
+    lv_indev_hit_index_enable(scr, false);
+    t = now_ns();
+    for(i = 0; i < 20; i++) lv_obj_scroll_by(cont, 0, i % 2 ? 50 : -50, LV_ANIM_OFF);
+    uint64_t t_scroll = now_ns() - t;
+
+    TEST_PRINTF("%d objects: %u ns/search recursively, %u ns/search with hit index; "
+                "scroll: %u us without, %u us with hit index", BENCH_CNT,
+                (unsigned)(t_recursive / POINT_CNT), (unsigned)(t_index / POINT_CNT),
+                (unsigned)(t_scroll / 20000), (unsigned)(t_scroll_index / 20000));
+}
+
+#else
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_indev_hit_index_changes(void)
+{
+}
+
+void test_indev_hit_index_benchmark(void)
+{
+}
+
+#endif
+
+#endif
@@ -0,0 +1,227 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+
+/*Invalidation traces of an 800x480 dashboard (title bar, relay switches with labels, sensor labels,
+ *a log view and a 320x240 camera image) replayed frame by frame. The redrawn pixels are compared with
+ *the former behavior which invalidated the whole screen after `LV_INV_BUF_SIZE` areas.*/
+
+#define FRAMES          60
+#define WIDGET_CNT      64
+
+typedef enum {
+    TRACE_LABELS,
+    TRACE_LABELS_CAMERA,
+    TRACE_LOG_SCROLL,
+    TRACE_ANIM,
+} trace_t;
+
+static lv_area_t widgets[WIDGET_CNT];
+static uint32_t rnd_seed;
+static uint32_t refr_px;
+
+static uint32_t rnd(void)
+{
+    rnd_seed = rnd_seed * 1103515245 + 12345;
+    return rnd_seed >> 8;
+}
+
+static void monitor_cb(lv_disp_drv_t * drv, uint32_t time, uint32_t px)
+{
+    LV_UNUSED(drv);
+    LV_UNUSED(time);
+    refr_px += px;
+}
+
+void setUp(void)
+{
+    /*Title bar labels, a column of 24 switches with labels, then sensor labels*/
+    uint32_t i;
+    for(i = 0; i < 4; i++) lv_area_set(&widgets[i], 10 + i * 190, 5, 10 + i * 190 + 150, 25);
+    for(i = 0; i < 24; i++) {
+        lv_coord_t y = 60 + (i % 12) * 34;
+        lv_coord_t x = 10 + (i / 12) * 200;
+        lv_area_set(&widgets[4 + i * 2], x, y, x + 50, y + 25);
+        lv_area_set(&widgets[5 + i * 2], x + 60, y + 4, x + 180, y + 20);
+    }
+    for(i = 52; i < WIDGET_CNT; i++) {
+        lv_coord_t x = 10 + (i - 52) % 4 * 95;
+        lv_coord_t y = 440 + (i - 52) / 4 * 12;
+        lv_area_set(&widgets[i], x, y, x + 80, y + 10);
+    }
+
+    lv_disp_get_default()->driver->monitor_cb = monitor_cb;
+    rnd_seed = 0x1234;
+}
+
+void tearDown(void)
+{
+    lv_disp_get_default()->driver->monitor_cb = NULL;
+}
+
+/*The former `_lv_inv_area` and `lv_refr_join_area` without rounder*/
+static uint32_t legacy_px(const lv_area_t * areas, uint32_t cnt)
+{
+    lv_area_t scr_area;
+    lv_area_t inv[LV_INV_BUF_SIZE];
+    uint8_t joined[LV_INV_BUF_SIZE] = {0};
+    uint32_t inv_p = 0;
+    uint32_t i;
+    uint32_t j;
+
+    lv_area_set(&scr_area, 0, 0, LV_HOR_RES - 1, LV_VER_RES - 1);
+    for(i = 0; i < cnt; i++) {
+        lv_area_t com;
+        if(!_lv_area_intersect(&com, &areas[i], &scr_area)) continue;
+        bool in = false;
+        for(j = 0; j < inv_p; j++) {
+            if(_lv_area_is_in(&com, &inv[j], 0)) in = true;
+        }
+        if(in) continue;
+        if(inv_p < LV_INV_BUF_SIZE) {
+            inv[inv_p] = com;
+        }
+        else {
+            inv_p = 0;
+            inv[inv_p] = scr_area;
+        }
+        inv_p++;
+    }
+
+    for(i = 0; i < inv_p; i++) {
+        if(joined[i]) continue;
+        for(j = 0; j < inv_p; j++) {
+            if(joined[j] || i == j) continue;
+            if(!_lv_area_is_on(&inv[i], &inv[j])) continue;
+            lv_area_t tmp;
+            _lv_area_join(&tmp, &inv[i], &inv[j]);
+            if(lv_area_get_size(&tmp) < lv_area_get_size(&inv[i]) + lv_area_get_size(&inv[j])) {
+                inv[i] = tmp;
+                joined[j] = 1;
+            }
+        }
+    }
+
+    uint32_t px = 0;
+    for(i = 0; i < inv_p; i++) {
+        if(!joined[i]) px += lv_area_get_size(&inv[i]);
+    }
+    return px;
+}
+
+static uint32_t frame_areas(trace_t trace, uint32_t frame, lv_area_t * areas)
+{
+    uint32_t cnt = 0;
+    uint32_t i;
+
+    /*A few dozen label and switch updates*/
+    uint32_t updates = 20 + rnd() % 40;
+    for(i = 0; i < updates; i++) areas[cnt++] = widgets[rnd() % WIDGET_CNT];
+
+    switch(trace) {
+        case TRACE_LABELS:
+            break;
+        case TRACE_LABELS_CAMERA:
+            lv_area_set(&areas[cnt++], 410, 230, 729, 469);
+            break;
+        case TRACE_LOG_SCROLL:
+            /*The log view rows shift up by one row*/
+            for(i = 0; i < 12; i++) {
+                lv_coord_t y = 62 + i * 16;
+                lv_area_set(&areas[cnt++], 412, y, 787, y + 15);
+            }
+            break;
+        case TRACE_ANIM: {
+                /*A knob moving across the screen: old and new position*/
+                lv_coord_t x = 20 + frame * 12;
+                lv_area_set(&areas[cnt++], x, 300, x + 39, 339);
+                lv_area_set(&areas[cnt++], x + 12, 300, x + 51, 339);
+                break;
+            }
+    }
+    return cnt;
+}
+
+static void replay(trace_t trace, const char * name)
+{
+    lv_area_t areas[128];
+    uint32_t legacy_sum = 0;
+    uint32_t new_sum = 0;
+    uint32_t legacy_full = 0;
+    uint32_t frame;
+
+    lv_disp_t * disp = lv_disp_get_default();
+    lv_refr_now(disp);
+
+    for(frame = 0; frame < FRAMES; frame++) {
+        uint32_t cnt = frame_areas(trace, frame, areas);
+        uint32_t i;
+        for(i = 0; i < cnt; i++) _lv_inv_area(disp, &areas[i]);
+
+        /*Never more than the buffer and never the whole screen because of the count*/
+        TEST_ASSERT_LESS_OR_EQUAL(LV_INV_BUF_SIZE, disp->inv_p);
+
+        /*Every invalidated pixel is still covered*/
+        for(i = 0; i < cnt; i++) {
+            uint32_t j;
+            bool covered = false;
+            for(j = 0; j < disp->inv_p && !covered; j++) covered = _lv_area_is_in(&areas[i], &disp->inv_areas[j], 0);
+            TEST_ASSERT_TRUE(covered);
+        }
+
+        refr_px = 0;
+        lv_refr_now(disp);
+
+        uint32_t old_px = legacy_px(areas, cnt);
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32(old_px, refr_px);
+        if(old_px == (uint32_t)(LV_HOR_RES * LV_VER_RES)) legacy_full++;
+        legacy_sum += old_px;
+        new_sum += refr_px;
+    }
+
+    TEST_PRINTF("%s: %u px/frame (whole screen invalidation: %u px/frame in %u of %d frames)", name,
+                (unsigned)(new_sum / FRAMES), (unsigned)(legacy_sum / FRAMES), (unsigned)legacy_full, FRAMES);
+    TEST_ASSERT_LESS_THAN_UINT32(legacy_sum, new_sum);
+}
+
+void test_inv_area_labels(void)
+{
+    replay(TRACE_LABELS, "labels");
+}
+
+void test_inv_area_labels_camera(void)
+{
+    replay(TRACE_LABELS_CAMERA, "labels + camera");
+}
+
+void test_inv_area_log_scroll(void)
+{
+    replay(TRACE_LOG_SCROLL, "log scroll");
+}
+
+void test_inv_area_anim(void)
+{
+    replay(TRACE_ANIM, "animation");
+}
+
+void test_inv_area_cover_removes_saved(void)
+{
+    lv_disp_t * disp = lv_disp_get_default();
+    lv_area_t a;
+    lv_refr_now(disp);
+
+    lv_area_set(&a, 10, 10, 19, 19);
+    _lv_inv_area(disp, &a);
+    lv_area_set(&a, 30, 10, 39, 19);
+    _lv_inv_area(disp, &a);
+    TEST_ASSERT_EQUAL(2, disp->inv_p);
+
+    lv_area_set(&a, 0, 0, 99, 99);
+    _lv_inv_area(disp, &a);
+    TEST_ASSERT_EQUAL(1, disp->inv_p);
+    TEST_ASSERT_EQUAL(100 * 100, lv_area_get_size(&disp->inv_areas[0]));
+    lv_refr_now(disp);
+}
+
+#endif
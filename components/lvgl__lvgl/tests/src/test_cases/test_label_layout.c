@@ -0,0 +1,369 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+
+/*The cached line breaks of labels are compared with breaking the text again,
+ *and labels are drawn with and without them. The draw and hit test times of a long text are printed.*/
+
+#if LV_LABEL_LINE_CACHE
+
+#include <stdlib.h>
+#include <time.h>
+
+#define FRAMES      5
+#define SCREEN_SIZE (LV_HOR_RES * LV_VER_RES * sizeof(lv_color_t))
+
+static lv_color_t * ref_buf;
+
+extern lv_color_t test_fb[];
+
+static const char * texts[] = {
+    "",
+    "A",
+    "Short line",
+    "Ends with new line\n",
+    "Windows\r\nline\r\nendings\r\n",
+    "\n\nEmpty lines\n\n\nin between\n",
+    "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt ut labore et "
+    "dolore magna aliqua. Ut enim ad minim veniam, quis nostrud exercitation ullamco laboris nisi ut aliquip.",
+    "Averyveryveryverylongwordwhichhastobebrokensomewherebecauseitdoesnotfitinaline and some short ones",
+    "Re-colored #ff0000 red# and #00ff00 green words# in a longer text, wrapped to more lines",
+    "Árvíztűrő tükörfúrógép, UTF-8 text with accents, ÁÉÍÓÖŐÚÜŰ",
+    "Tabs\tand, punctuation-marks; in a text: with (brackets) and 1234567890 numbers",
+};
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/*The text is drawn as the label draws it, but without cached line breaks*/
+static void plain_draw_event_cb(lv_event_t * e)
+{
+    lv_obj_t * obj = lv_event_get_target(e);
+    lv_obj_t * label = lv_event_get_user_data(e);
+
+    /*Letters can be out of the object as in the label*/
+    if(lv_event_get_code(e) == LV_EVENT_REFR_EXT_DRAW_SIZE) {
+        lv_event_set_ext_draw_size(e, lv_font_get_line_height(lv_obj_get_style_text_font(label, LV_PART_MAIN)) / 4);
+        return;
+    }
+
+    lv_area_t txt_coords;
+    lv_obj_get_content_coords(obj, &txt_coords);
+
+    lv_draw_label_dsc_t dsc;
+    lv_draw_label_dsc_init(&dsc);
+    dsc.flag = lv_label_get_recolor(label) ? LV_TEXT_FLAG_RECOLOR : LV_TEXT_FLAG_NONE;
+    lv_obj_init_draw_label_dsc(label, LV_PART_MAIN, &dsc);
+    lv_draw_label(lv_event_get_draw_ctx(e), &dsc, &txt_coords, lv_label_get_text(label), NULL);
+}
+
+/*A plain object at the place of the label which draws its text without the cached line breaks*/
+static lv_obj_t * plain_create(lv_obj_t * label)
+{
+    lv_obj_t * obj = lv_obj_create(lv_scr_act());
+    lv_obj_remove_style_all(obj);
+    lv_obj_set_pos(obj, lv_obj_get_x(label), lv_obj_get_y(label));
+    lv_obj_set_size(obj, lv_obj_get_width(label), lv_obj_get_height(label));
+    lv_obj_add_event_cb(obj, plain_draw_event_cb, LV_EVENT_DRAW_MAIN, label);
+    lv_obj_add_event_cb(obj, plain_draw_event_cb, LV_EVENT_REFR_EXT_DRAW_SIZE, label);
+    lv_obj_refresh_ext_draw_size(obj);
+    return obj;
+}
+
+static uint64_t render(void)
+{
+    uint64_t t_sum = 0;
+    uint32_t i;
+    for(i = 0; i < FRAMES; i++) {
+        lv_memset_ff(test_fb, SCREEN_SIZE);
+        lv_obj_invalidate(lv_scr_act());
+        uint64_t t = now_ns();
+        lv_refr_now(NULL);
+        t_sum += now_ns() - t;
+    }
+
+    return t_sum / FRAMES;
+}
+
+void setUp(void)
+{
+    ref_buf = malloc(SCREEN_SIZE);
+}
+
+void tearDown(void)
+{
+    lv_obj_clean(lv_scr_act());
+    free(ref_buf);
+}
+
+void test_label_layout_lines(void)
+{
+    static const lv_coord_t widths[] = {1, 10, 37, 80, 150, 400, LV_COORD_MAX};
+    static const lv_text_flag_t flags[] = {LV_TEXT_FLAG_NONE, LV_TEXT_FLAG_RECOLOR, LV_TEXT_FLAG_EXPAND, LV_TEXT_FLAG_FIT};
+    const lv_font_t * font = LV_FONT_DEFAULT;
+
+    lv_txt_layout_t layout;
+    _lv_txt_layout_init(&layout);
+
+    uint32_t t;
+    for(t = 0; t < sizeof(texts) / sizeof(texts[0]); t++) {
+        uint32_t w;
+        uint32_t f;
+        lv_coord_t letter_space;
+        for(w = 0; w < sizeof(widths) / sizeof(widths[0]); w++) {
+            for(f = 0; f < sizeof(flags) / sizeof(flags[0]); f++) {
+                for(letter_space = -1; letter_space <= 3; letter_space += 2) {
+                    TEST_ASSERT_TRUE(_lv_txt_layout_update(&layout, texts[t], font, letter_space, widths[w], flags[f]));
+                    TEST_ASSERT_TRUE(_lv_txt_layout_is_valid(&layout, texts[t], font, letter_space, widths[w], flags[f]));
+
+                    /*The same line breaks and widths as when the text is broken and measured line by line*/
+                    uint32_t line_id = 0;
+                    uint32_t line_start = 0;
+                    while(texts[t][line_start] != '\0') {
+                        uint32_t line_end = line_start + _lv_txt_get_next_line(&texts[t][line_start], font, letter_space,
+                                                                               widths[w], NULL, flags[f]);
+                        TEST_ASSERT_EQUAL_UINT32(line_start, _lv_txt_layout_get_line_start(&layout, line_id));
+                        TEST_ASSERT_EQUAL_INT16(lv_txt_get_width(&texts[t][line_start], line_end - line_start, font,
+                                                                 letter_space, flags[f]),
+                                                _lv_txt_layout_get_line_width(&layout, line_id));
+                        line_start = line_end;
+                        line_id++;
+                    }
+                    TEST_ASSERT_EQUAL_UINT32(line_id, layout.line_cnt);
+                    TEST_ASSERT_EQUAL_UINT32(strlen(texts[t]), _lv_txt_layout_get_line_start(&layout, line_id + 5));
+
+                    lv_coord_t line_space;
+                    for(line_space = -2; line_space <= 4; line_space += 3) {
+                        lv_point_t size_ref;
+                        lv_point_t size;
+                        lv_txt_get_size(&size_ref, texts[t], font, letter_space, line_space, widths[w], flags[f]);
+                        _lv_txt_layout_get_size(&layout, line_space, &size);
+                        TEST_ASSERT_EQUAL_INT16(size_ref.x, size.x);
+                        TEST_ASSERT_EQUAL_INT16(size_ref.y, size.y);
+                    }
+                }
+            }
+        }
+    }
+
+    /*Another parameter or text needs breaking again*/
+    TEST_ASSERT_FALSE(_lv_txt_layout_is_valid(&layout, texts[1], font, 3, LV_COORD_MAX, LV_TEXT_FLAG_FIT));
+    TEST_ASSERT_FALSE(_lv_txt_layout_is_valid(&layout, texts[t - 1], font, 1, LV_COORD_MAX, LV_TEXT_FLAG_FIT));
+    TEST_ASSERT_FALSE(_lv_txt_layout_is_valid(&layout, texts[t - 1], font, 3, LV_COORD_MAX, LV_TEXT_FLAG_NONE));
+    TEST_ASSERT_TRUE(_lv_txt_layout_is_valid(&layout, texts[t - 1], font, 3, 100, LV_TEXT_FLAG_FIT));
+    _lv_txt_layout_invalidate(&layout);
+    TEST_ASSERT_FALSE(_lv_txt_layout_is_valid(&layout, texts[t - 1], font, 3, LV_COORD_MAX, LV_TEXT_FLAG_FIT));
+
+    _lv_txt_layout_free(&layout);
+}
+
+void test_label_layout_draw(void)
+{
+    static const lv_text_align_t aligns[] = {LV_TEXT_ALIGN_LEFT, LV_TEXT_ALIGN_CENTER, LV_TEXT_ALIGN_RIGHT};
+
+    uint32_t a;
+    for(a = 0; a < sizeof(aligns) / sizeof(aligns[0]); a++) {
+        lv_obj_t * labels[sizeof(texts) / sizeof(texts[0])];
+        lv_obj_t * plains[sizeof(texts) / sizeof(texts[0])];
+        uint32_t t;
+        for(t = 0; t < sizeof(texts) / sizeof(texts[0]); t++) {
+            labels[t] = lv_label_create(lv_scr_act());
+            lv_label_set_recolor(labels[t], true);
+            lv_label_set_text(labels[t], texts[t]);
+            lv_obj_set_width(labels[t], 60 + t * 17);
+            lv_obj_set_pos(labels[t], 5 + (t % 4) * 200, 5 + (t / 4) * 160);
+            lv_obj_set_style_text_align(labels[t], aligns[a], 0);
+            lv_obj_set_style_text_letter_space(labels[t], t % 3, 0);
+            lv_obj_set_style_text_line_space(labels[t], t % 4 - 1, 0);
+        }
+        lv_obj_update_layout(lv_scr_act());
+
+        for(t = 0; t < sizeof(texts) / sizeof(texts[0]); t++) {
+            plains[t] = plain_create(labels[t]);
+            lv_obj_add_flag(plains[t], LV_OBJ_FLAG_HIDDEN);
+        }
+
+        /*Draw the labels with the cached lines, then the plain objects without them*/
+        render();
+        lv_memcpy(ref_buf, test_fb, SCREEN_SIZE);
+
+        for(t = 0; t < sizeof(texts) / sizeof(texts[0]); t++) {
+            lv_obj_add_flag(labels[t], LV_OBJ_FLAG_HIDDEN);
+            lv_obj_clear_flag(plains[t], LV_OBJ_FLAG_HIDDEN);
+        }
+        render();
+        TEST_ASSERT_EQUAL_MEMORY(ref_buf, test_fb, SCREEN_SIZE);
+
+        lv_obj_clean(lv_scr_act());
+    }
+}
+
+void test_label_layout_invalidate(void)
+{
+    lv_obj_t * label = lv_label_create(lv_scr_act());
+    lv_obj_set_width(label, 100);
+    lv_label_set_text(label, texts[6]);
+    lv_obj_update_layout(label);
+
+    lv_label_t * l = (lv_label_t *)label;
+    TEST_ASSERT_TRUE(l->layout.valid);
+    uint32_t line_cnt = l->layout.line_cnt;
+    TEST_ASSERT_GREATER_THAN_UINT32(3, line_cnt);
+
+    /*Setting the same text again keeps the lines*/
+    char * txt = lv_label_get_text(label);
+    lv_label_set_text(label, texts[6]);
+    lv_label_set_text_fmt(label, "%s", texts[6]);
+    TEST_ASSERT_EQUAL_PTR(txt, lv_label_get_text(label));
+    TEST_ASSERT_TRUE(l->layout.valid);
+
+    /*Modified in place and refreshed with NULL or its own text: broken again*/
+    txt[10] = '\0';
+    lv_label_set_text(label, NULL);
+    lv_obj_update_layout(label);
+    TEST_ASSERT_EQUAL_UINT32(10, _lv_txt_layout_get_line_start(&l->layout, 100));
+    txt = lv_label_get_text(label);
+    txt[5] = '\0';
+    lv_label_set_text(label, txt);
+    lv_obj_update_layout(label);
+    TEST_ASSERT_EQUAL_UINT32(5, _lv_txt_layout_get_line_start(&l->layout, 100));
+    lv_label_set_text(label, texts[6]);
+    lv_obj_update_layout(label);
+    TEST_ASSERT_EQUAL_UINT32(line_cnt, l->layout.line_cnt);
+
+    /*A new width breaks the text again*/
+    lv_obj_set_width(label, 200);
+    lv_obj_update_layout(label);
+    TEST_ASSERT_TRUE(l->layout.valid);
+    TEST_ASSERT_EQUAL_INT16(200, l->layout.max_width);
+    TEST_ASSERT_LESS_THAN_UINT32(line_cnt, l->layout.line_cnt);
+
+    /*Also a new letter space*/
+    lv_obj_set_style_text_letter_space(label, 4, 0);
+    TEST_ASSERT_TRUE(l->layout.valid);
+    TEST_ASSERT_EQUAL_INT16(4, l->layout.letter_space);
+
+    /*Changing the text in place*/
+    lv_label_cut_text(label, 0, 200);
+    TEST_ASSERT_TRUE(l->layout.valid);
+    TEST_ASSERT_EQUAL_UINT32(strlen(lv_label_get_text(label)), _lv_txt_layout_get_line_start(&l->layout, 100));
+    lv_label_ins_text(label, 0, "Some words at the beginning\n");
+    TEST_ASSERT_EQUAL_UINT32(strlen(lv_label_get_text(label)), _lv_txt_layout_get_line_start(&l->layout, 100));
+    TEST_ASSERT_EQUAL_UINT32(_lv_txt_get_next_line(lv_label_get_text(label), LV_FONT_DEFAULT, 4, 200, NULL, 0),
+                             _lv_txt_layout_get_line_start(&l->layout, 1));
+
+    /*Dots replace the end of the text*/
+    lv_obj_set_height(label, 40);
+    lv_label_set_long_mode(label, LV_LABEL_LONG_DOT);
+    lv_refr_now(NULL);
+    TEST_ASSERT_TRUE(l->layout.valid);
+    TEST_ASSERT_EQUAL_UINT32(strlen(lv_label_get_text(label)), _lv_txt_layout_get_line_start(&l->layout, 100));
+    lv_label_set_long_mode(label, LV_LABEL_LONG_WRAP);
+    TEST_ASSERT_EQUAL_UINT32(strlen(lv_label_get_text(label)), _lv_txt_layout_get_line_start(&l->layout, 100));
+}
+
+void test_label_layout_hit_test(void)
+{
+    lv_obj_t * label = lv_label_create(lv_scr_act());
+    lv_obj_set_width(label, 150);
+    lv_label_set_text(label, texts[6]);
+    lv_obj_update_layout(label);
+
+    /*The letter at the position of a letter is itself*/
+    uint32_t len = _lv_txt_get_encoded_length(texts[6]);
+    uint32_t i;
+    for(i = 0; i < len; i++) {
+        lv_point_t p;
+        lv_label_get_letter_pos(label, i, &p);
+        p.x += 1;
+        p.y += 1;
+        uint32_t letter = lv_label_get_letter_on(label, &p);
+        if(texts[6][i] != ' ') TEST_ASSERT_EQUAL_UINT32(i, letter);
+        TEST_ASSERT_TRUE(lv_label_is_char_under_pos(label, &p));
+    }
+}
+
+void test_label_layout_benchmark(void)
+{
+    /*200 paragraphs wrapped to about 600 lines*/
+    static char txt[200 * 200 + 1];
+    uint32_t i;
+    for(i = 0; i + 200 < sizeof(txt); i += 200) {
+        lv_snprintf(&txt[i], 201, "%-199.199s\n", texts[6 + (i / 200) % 5]);
+    }
+    txt[i] = '\0';
+
+    lv_obj_t * label = lv_label_create(lv_scr_act());
+    lv_label_set_text_static(label, txt);
+    lv_obj_set_width(label, 380);
+    lv_obj_set_style_text_align(label, LV_TEXT_ALIGN_CENTER, 0);
+    lv_obj_update_layout(label);
+
+    lv_obj_t * plain = plain_create(label);
+    lv_obj_add_flag(plain, LV_OBJ_FLAG_HIDDEN);
+
+    uint64_t t_cache = render();
+
+    lv_obj_add_flag(label, LV_OBJ_FLAG_HIDDEN);
+    lv_obj_clear_flag(plain, LV_OBJ_FLAG_HIDDEN);
+    uint64_t t_no_cache = render();
+
+    TEST_PRINTF("long text: %u us/frame without cache, %u us/frame with cache",
+                (unsigned)(t_no_cache / 1000), (unsigned)(t_cache / 1000));
+
+    /*Hit test at the end of the text*/
+    lv_point_t p = {190, lv_obj_get_height(label) - 5};
+    uint64_t t = now_ns();
+    for(i = 0; i < 100; i++) lv_label_get_letter_on(label, &p);
+    uint64_t t_hit = (now_ns() - t) / 100;
+
+    /*Breaking the text again each time*/
+    t = now_ns();
+    for(i = 0; i < 100; i++) {
+        _lv_txt_layout_invalidate(&((lv_label_t *)label)->layout);
+        lv_label_get_letter_on(label, &p);
+    }
+    uint64_t t_hit_no_cache = (now_ns() - t) / 100;
+
+    TEST_PRINTF("hit test at the end: %u us without cache, %u us with cache",
+                (unsigned)(t_hit_no_cache / 1000), (unsigned)(t_hit / 1000));
+}
+
+#else
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_label_layout_lines(void)
+{
+}
+
+void test_label_layout_draw(void)
+{
+}
+
+void test_label_layout_invalidate(void)
+{
+}
+
+void test_label_layout_hit_test(void)
+{
+}
+
+void test_label_layout_benchmark(void)
+{
+}
+
+#endif
+
+#endif
@@ -0,0 +1,263 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+
+/*Small objects are allocated from the size classes of the slab and larger ones from the pool.
+ *The soak test creates and deletes widget trees and prints the peak use and fragmentation of the heap.
+ *Set the LV_SOAK_ITERATIONS environment variable to run it longer, e.g. for millions of iterations.*/
+
+#if LV_MEM_CUSTOM == 0 && LV_MEM_SLAB_SIZE
+
+#include <stdlib.h>
+#include <time.h>
+
+#define SOAK_ITERATIONS 5000
+#define SOAK_TREES      16
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static lv_style_t style_a;
+static lv_style_t style_b;
+
+void setUp(void)
+{
+    lv_style_init(&style_a);
+    lv_style_set_bg_color(&style_a, lv_palette_main(LV_PALETTE_RED));
+    lv_style_init(&style_b);
+    lv_style_set_pad_all(&style_b, 3);
+}
+
+void tearDown(void)
+{
+    lv_obj_clean(lv_scr_act());
+    lv_style_reset(&style_a);
+    lv_style_reset(&style_b);
+}
+
+void test_mem_slab_alloc_free(void)
+{
+    lv_mem_monitor_t m1;
+    lv_mem_monitor_t m2;
+    lv_mem_monitor(&m1);
+    TEST_ASSERT_EQUAL_UINT32(LV_MEM_SLAB_SIZE / 256 * 256, m1.slab_size);
+
+    uint8_t * p[160];
+    uint32_t i;
+    for(i = 0; i < 160; i++) {
+        p[i] = lv_mem_alloc(i + 1);
+        TEST_ASSERT_NOT_NULL(p[i]);
+        lv_memset(p[i], (uint8_t)i, i + 1);
+    }
+
+    /*Only the ones up to 128 bytes are in the slab*/
+    lv_mem_monitor(&m2);
+    TEST_ASSERT_EQUAL_UINT32(m1.slab_used_cnt + 128, m2.slab_used_cnt);
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_mem_test());
+
+    /*Grow within the slot, to a larger class and to the pool*/
+    for(i = 0; i < 160; i++) {
+        uint8_t * new_p = lv_mem_realloc(p[i], (i + 1) * 3);
+        TEST_ASSERT_NOT_NULL(new_p);
+        uint32_t j;
+        for(j = 0; j < i + 1; j++) {
+            TEST_ASSERT_EQUAL_UINT8(i, new_p[j]);
+        }
+        lv_memset(new_p, 0x55, (i + 1) * 3);
+        p[i] = new_p;
+    }
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_mem_test());
+
+    for(i = 0; i < 160; i++) {
+        lv_mem_free(p[i]);
+    }
+
+    lv_mem_monitor(&m2);
+    TEST_ASSERT_EQUAL_UINT32(m1.slab_used_cnt, m2.slab_used_cnt);
+    TEST_ASSERT_EQUAL_UINT32(m1.slab_free_size, m2.slab_free_size);
+    TEST_ASSERT_EQUAL_UINT32(m1.free_size, m2.free_size);
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_mem_test());
+}
+
+void test_mem_slab_full(void)
+{
+    lv_mem_monitor_t m1;
+    lv_mem_monitor_t m2;
+    lv_mem_monitor(&m1);
+
+    /*Fill the slab with the smallest class until the pool is used too*/
+    uint32_t cnt = LV_MEM_SLAB_SIZE / 8 + 64;
+    void ** p = malloc(cnt * sizeof(void *));
+    uint32_t i;
+    for(i = 0; i < cnt; i++) {
+        p[i] = lv_mem_alloc(8);
+        TEST_ASSERT_NOT_NULL(p[i]);
+    }
+
+    lv_mem_monitor_t m_full;
+    lv_mem_monitor(&m_full);
+    TEST_ASSERT_GREATER_THAN_UINT32(m1.slab_fallback_cnt, m_full.slab_fallback_cnt);
+    TEST_ASSERT_LESS_THAN_UINT32(m1.slab_free_size, m_full.slab_free_size);
+
+    /*Free every second object, the pages of the class are half empty*/
+    for(i = 0; i < cnt; i += 2) {
+        lv_mem_free(p[i]);
+    }
+    lv_mem_monitor(&m2);
+    TEST_ASSERT_GREATER_THAN_UINT8(m_full.slab_frag_pct, m2.slab_frag_pct);
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_mem_test());
+
+    for(i = 1; i < cnt; i += 2) {
+        lv_mem_free(p[i]);
+    }
+
+    /*The empty pages can be used by other classes*/
+    uint32_t large_cnt = LV_MEM_SLAB_SIZE / 2 / 128;
+    for(i = 0; i < large_cnt; i++) {
+        p[i] = lv_mem_alloc(128);
+    }
+    lv_mem_monitor(&m2);
+    TEST_ASSERT_EQUAL_UINT32(m1.slab_used_cnt + large_cnt, m2.slab_used_cnt);
+
+    for(i = 0; i < large_cnt; i++) {
+        lv_mem_free(p[i]);
+    }
+    free(p);
+
+    lv_mem_monitor(&m2);
+    TEST_ASSERT_EQUAL_UINT32(m1.slab_used_cnt, m2.slab_used_cnt);
+    TEST_ASSERT_EQUAL_UINT32(m1.free_size, m2.free_size);
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_mem_test());
+}
+
+/*A container with a few widgets of different sizes and styles*/
+static lv_obj_t * tree_create(uint32_t seed)
+{
+    lv_obj_t * cont = lv_obj_create(lv_scr_act());
+    lv_obj_set_size(cont, 200, 150);
+    lv_obj_set_flex_flow(cont, LV_FLEX_FLOW_COLUMN);
+
+    uint32_t i;
+    for(i = 0; i < 2 + seed % 5; i++) {
+        lv_obj_t * obj;
+        switch((seed + i) % 4) {
+            case 0:
+                obj = lv_label_create(cont);
+                lv_label_set_text_fmt(obj, "Label %d", (int)(seed + i));
+                break;
+            case 1:
+                obj = lv_btn_create(cont);
+                lv_label_set_text(lv_label_create(obj), "Button");
+                break;
+            case 2:
+                obj = lv_switch_create(cont);
+                break;
+            default:
+                obj = lv_obj_create(cont);
+                lv_obj_set_style_bg_opa(obj, LV_OPA_50, 0);
+                break;
+        }
+        lv_obj_add_style(obj, &style_a, 0);
+        if(i % 2) lv_obj_add_style(obj, &style_b, LV_STATE_PRESSED);
+        lv_obj_set_style_text_color(obj, lv_color_hex(seed), 0);
+    }
+
+    return cont;
+}
+
+void test_mem_slab_soak(void)
+{
+    uint32_t iterations = SOAK_ITERATIONS;
+    const char * env = getenv("LV_SOAK_ITERATIONS");
+    if(env) iterations = strtoul(env, NULL, 10);
+
+    lv_obj_t * trees[SOAK_TREES] = {NULL};
+
+    /*Let the one time allocations happen before taking the baseline*/
+    trees[0] = tree_create(0);
+    lv_refr_now(NULL);
+    lv_obj_del(trees[0]);
+    trees[0] = NULL;
+
+    /*The temporary buffers are kept for reuse, don't count them*/
+    lv_mem_buf_free_all();
+    lv_mem_monitor_t m_start;
+    lv_mem_monitor(&m_start);
+
+    uint32_t used_peak = 0;
+    uint32_t frag_max = 0;
+    uint32_t slab_frag_max = 0;
+    uint64_t t_start = now_ns();
+    uint32_t i;
+    for(i = 0; i < iterations; i++) {
+        /*Replace a random tree to mix the lifetimes*/
+        uint32_t id = lv_rand(0, SOAK_TREES - 1);
+        if(trees[id]) lv_obj_del(trees[id]);
+        trees[id] = tree_create(lv_rand(0, 0xFFFF));
+
+        if(i % 1000 == 0) {
+            lv_refr_now(NULL);
+            TEST_ASSERT_EQUAL(LV_RES_OK, lv_mem_test());
+        }
+
+        if(i % 64 == 0) {
+            lv_mem_monitor_t m;
+            lv_mem_monitor(&m);
+            used_peak = LV_MAX(used_peak, m.total_size - m.free_size);
+            frag_max = LV_MAX(frag_max, m.frag_pct);
+            slab_frag_max = LV_MAX(slab_frag_max, m.slab_frag_pct);
+        }
+    }
+    uint64_t t_sum = now_ns() - t_start;
+
+    lv_mem_monitor_t m_end;
+    lv_mem_monitor(&m_end);
+
+    TEST_PRINTF("%u iterations, %u us/iteration: peak %u bytes, frag %u%% (max %u%%), slab frag %u%% (max %u%%), "
+                "%u fallbacks", (unsigned)iterations, (unsigned)(t_sum / 1000 / LV_MAX(iterations, 1)),
+                (unsigned)(used_peak - (m_start.total_size - m_start.free_size)), m_end.frag_pct, (unsigned)frag_max,
+                m_end.slab_frag_pct, (unsigned)slab_frag_max,
+                (unsigned)(m_end.slab_fallback_cnt - m_start.slab_fallback_cnt));
+
+    for(i = 0; i < SOAK_TREES; i++) {
+        if(trees[i]) lv_obj_del(trees[i]);
+    }
+
+    /*Nothing is leaked*/
+    lv_mem_buf_free_all();
+    lv_mem_monitor(&m_end);
+    TEST_ASSERT_EQUAL_UINT32(m_start.slab_used_cnt, m_end.slab_used_cnt);
+    TEST_ASSERT_EQUAL_UINT32(m_start.free_size, m_end.free_size);
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_mem_test());
+}
+
+#else
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_mem_slab_alloc_free(void)
+{
+}
+
+void test_mem_slab_full(void)
+{
+}
+
+void test_mem_slab_soak(void)
+{
+}
+
+#endif
+
+#endif
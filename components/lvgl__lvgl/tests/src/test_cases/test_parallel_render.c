@@ -0,0 +1,276 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+#include "../demos/lv_demos.h"
+
+#include "unity/unity.h"
+
+/*Every tab of the widgets demo is rendered on one thread and then split between two threads.
+ *The results have to be the same pixel by pixel. The render times are printed too but this host
+ *might have only one CPU so the speedup is not checked.*/
+
+#if LV_USE_PARALLEL_RENDER && LV_USE_DEMO_WIDGETS
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define FRAMES          3
+#define RND_AREA_CNT    8
+
+typedef struct {
+    uint64_t serial_ns;
+    uint64_t parallel_ns;
+} render_time_t;
+
+static pthread_t worker;
+static pthread_mutex_t job_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t job_cond = PTHREAD_COND_INITIALIZER;
+static pthread_mutex_t lock_mutex;
+static lv_parallel_job_cb_t job_cb;
+static void * job_param;
+static bool job_done;
+static bool worker_quit;
+static uint32_t job_cnt;
+
+static lv_color_t * ref_buf;
+static uint32_t rnd_seed;
+static bool direct_mode_ori;
+static void (*flush_cb_ori)(lv_disp_drv_t *, const lv_area_t *, lv_color_t *);
+
+extern lv_color_t test_fb[];
+
+static void * worker_thread(void * arg)
+{
+    LV_UNUSED(arg);
+
+    pthread_mutex_lock(&job_mutex);
+    while(1) {
+        while(job_cb == NULL && !worker_quit) pthread_cond_wait(&job_cond, &job_mutex);
+        if(worker_quit) break;
+
+        lv_parallel_job_cb_t cb = job_cb;
+        pthread_mutex_unlock(&job_mutex);
+        cb(job_param);
+        pthread_mutex_lock(&job_mutex);
+
+        job_cb = NULL;
+        job_done = true;
+        pthread_cond_broadcast(&job_cond);
+    }
+    pthread_mutex_unlock(&job_mutex);
+    return NULL;
+}
+
+static void start_cb(lv_parallel_job_cb_t cb, void * param)
+{
+    pthread_mutex_lock(&job_mutex);
+    job_param = param;
+    job_done = false;
+    job_cb = cb;
+    job_cnt++;
+    pthread_cond_broadcast(&job_cond);
+    pthread_mutex_unlock(&job_mutex);
+}
+
+static void wait_cb(void)
+{
+    pthread_mutex_lock(&job_mutex);
+    while(!job_done) pthread_cond_wait(&job_cond, &job_mutex);
+    pthread_mutex_unlock(&job_mutex);
+}
+
+static void lock_cb(void)
+{
+    pthread_mutex_lock(&lock_mutex);
+}
+
+static void unlock_cb(void)
+{
+    pthread_mutex_unlock(&lock_mutex);
+}
+
+static const lv_parallel_cb_t parallel_cb = {
+    .start_cb = start_cb,
+    .wait_cb = wait_cb,
+    .lock_cb = lock_cb,
+    .unlock_cb = unlock_cb,
+};
+
+static void direct_flush_cb(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p)
+{
+    LV_UNUSED(area);
+    LV_UNUSED(color_p);
+    lv_disp_flush_ready(drv);
+}
+
+static uint32_t rnd(void)
+{
+    rnd_seed = rnd_seed * 1103515245 + 12345;
+    return rnd_seed >> 8;
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/*Invalidate the same areas before both renderings*/
+static void invalidate(uint32_t frame, uint32_t seed)
+{
+    if(frame == 0) {
+        lv_obj_invalidate(lv_scr_act());
+        return;
+    }
+
+    rnd_seed = seed;
+    uint32_t i;
+    for(i = 0; i < RND_AREA_CNT; i++) {
+        lv_area_t a;
+        a.x1 = rnd() % LV_HOR_RES;
+        a.y1 = rnd() % LV_VER_RES;
+        a.x2 = a.x1 + rnd() % 300;
+        a.y2 = a.y1 + rnd() % 200;
+        _lv_inv_area(lv_disp_get_default(), &a);
+    }
+}
+
+static uint64_t render(uint32_t frame, uint32_t seed, const lv_parallel_cb_t * cb)
+{
+    lv_disp_t * disp = lv_disp_get_default();
+
+    /*Overwrite the former result so that stale pixels can't pass*/
+    lv_memset_ff(disp->driver->draw_buf->buf1, LV_HOR_RES * LV_VER_RES * sizeof(lv_color_t));
+    lv_memset_ff(test_fb, LV_HOR_RES * LV_VER_RES * sizeof(lv_color_t));
+
+    lv_parallel_set_cb(cb);
+    invalidate(frame, seed);
+    uint64_t t = now_ns();
+    _lv_disp_refr_timer(NULL);
+    t = now_ns() - t;
+    lv_parallel_set_cb(NULL);
+    return t;
+}
+
+static void render_scenes(bool direct_mode, render_time_t * time)
+{
+    lv_disp_t * disp = lv_disp_get_default();
+    disp->driver->direct_mode = direct_mode;
+    disp->driver->flush_cb = direct_mode ? direct_flush_cb : flush_cb_ori;
+
+    /*Direct mode renders into the draw buffer, partial mode flushes the areas to the test frame buffer*/
+    lv_color_t * result = direct_mode ? disp->driver->draw_buf->buf1 : test_fb;
+
+    lv_demo_widgets();
+
+    lv_obj_t * tv = NULL;
+    uint32_t i;
+    for(i = 0; i < lv_obj_get_child_cnt(lv_scr_act()); i++) {
+        lv_obj_t * child = lv_obj_get_child(lv_scr_act(), i);
+        if(lv_obj_check_type(child, &lv_tabview_class)) tv = child;
+    }
+    TEST_ASSERT_NOT_NULL(tv);
+
+    uint32_t tab_cnt = lv_obj_get_child_cnt(lv_tabview_get_content(tv));
+    uint32_t tab;
+    for(tab = 0; tab < tab_cnt; tab++) {
+        lv_tabview_set_act(tv, tab, LV_ANIM_OFF);
+
+        uint32_t frame;
+        for(frame = 0; frame < FRAMES; frame++) {
+            /*Move the animated objects of the scene*/
+            if(frame) lv_anim_refr_now();
+            _lv_disp_refr_timer(NULL);
+
+            uint32_t seed = tab * FRAMES + frame;
+            time->serial_ns += render(frame, seed, NULL);
+            lv_memcpy(ref_buf, result, LV_HOR_RES * LV_VER_RES * sizeof(lv_color_t));
+
+            time->parallel_ns += render(frame, seed, &parallel_cb);
+            TEST_ASSERT_EQUAL_MEMORY(ref_buf, result, LV_HOR_RES * LV_VER_RES * sizeof(lv_color_t));
+        }
+    }
+
+    lv_demo_widgets_close();
+}
+
+static void print_time(const char * name, const render_time_t * time)
+{
+    TEST_PRINTF("%s: serial %u ms, parallel %u ms (%u%% of the serial time), %u jobs on the worker", name,
+                (unsigned)(time->serial_ns / 1000000), (unsigned)(time->parallel_ns / 1000000),
+                (unsigned)(time->parallel_ns * 100 / time->serial_ns), (unsigned)job_cnt);
+}
+
+void setUp(void)
+{
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&lock_mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+
+    worker_quit = false;
+    job_cb = NULL;
+    job_cnt = 0;
+    pthread_create(&worker, NULL, worker_thread, NULL);
+
+    ref_buf = malloc(LV_HOR_RES * LV_VER_RES * sizeof(lv_color_t));
+
+    lv_disp_t * disp = lv_disp_get_default();
+    direct_mode_ori = disp->driver->direct_mode;
+    flush_cb_ori = disp->driver->flush_cb;
+}
+
+void tearDown(void)
+{
+    lv_disp_t * disp = lv_disp_get_default();
+    disp->driver->direct_mode = direct_mode_ori;
+    disp->driver->flush_cb = flush_cb_ori;
+    disp->driver->monitor_cb = NULL;
+    lv_parallel_set_cb(NULL);
+
+    pthread_mutex_lock(&job_mutex);
+    worker_quit = true;
+    pthread_cond_broadcast(&job_cond);
+    pthread_mutex_unlock(&job_mutex);
+    pthread_join(worker, NULL);
+    pthread_mutex_destroy(&lock_mutex);
+
+    free(ref_buf);
+    lv_obj_clean(lv_scr_act());
+}
+
+#else
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+#endif
+
+void test_parallel_render_direct_mode(void)
+{
+#if LV_USE_PARALLEL_RENDER && LV_USE_DEMO_WIDGETS
+    render_time_t time = {0};
+    render_scenes(true, &time);
+    print_time("direct mode", &time);
+    TEST_ASSERT_GREATER_THAN(0, job_cnt);
+#endif
+}
+
+void test_parallel_render_partial_mode(void)
+{
+#if LV_USE_PARALLEL_RENDER && LV_USE_DEMO_WIDGETS
+    render_time_t time = {0};
+    render_scenes(false, &time);
+    print_time("partial mode", &time);
+    TEST_ASSERT_GREATER_THAN(0, job_cnt);
+#endif
+}
+
+#endif
@@ -0,0 +1,509 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+
+/*PNGs of all color types and bit depths are generated with the lodepng encoder and decoded by the PNG decoder
+ *both fully and row by row. The result has to match lodepng's own decoder.
+ *The last test compares the peak memory and the time of the decoding with lodepng's full image decoding.*/
+
+#if LV_USE_PNG && LV_COLOR_DEPTH == 32
+
+#include "../../src/extra/libs/png/lodepng.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define PNG_FILE   "/tmp/lv_test_png_stream.png"
+
+typedef struct {
+    LodePNGColorType ct;
+    uint8_t depth;
+    bool key;
+    uint8_t btype;
+} png_cfg_t;
+
+static const png_cfg_t cfgs[] = {
+    {LCT_RGBA, 8, false, 2},
+    {LCT_RGBA, 16, false, 1},
+    {LCT_RGB, 8, false, 0},
+    {LCT_RGB, 8, true, 2},
+    {LCT_RGB, 16, true, 2},
+    {LCT_GREY_ALPHA, 8, false, 2},
+    {LCT_GREY_ALPHA, 16, false, 1},
+    {LCT_GREY, 1, false, 2},
+    {LCT_GREY, 2, true, 1},
+    {LCT_GREY, 4, false, 0},
+    {LCT_GREY, 8, true, 2},
+    {LCT_GREY, 16, false, 2},
+    {LCT_PALETTE, 1, false, 2},
+    {LCT_PALETTE, 2, false, 1},
+    {LCT_PALETTE, 4, false, 2},
+    {LCT_PALETTE, 8, false, 0},
+};
+
+extern lv_color_t test_fb[];
+
+static uint32_t rnd_state;
+static lv_img_dsc_t img_dsc;
+static uint8_t * png;
+static uint8_t * ref;      /*Expected pixels*/
+
+static uint32_t rnd(void)
+{
+    rnd_state = rnd_state * 1103515245 + 12345;
+    return rnd_state >> 16;
+}
+
+static uint32_t get_sample(const uint8_t * raw, uint32_t i, uint8_t depth)
+{
+    if(depth == 16) return (raw[i * 2] << 8) | raw[i * 2 + 1];
+    if(depth == 8) return raw[i];
+    uint32_t bit = i * depth;
+    return (raw[bit >> 3] >> (8 - depth - (bit & 7))) & ((1 << depth) - 1);
+}
+
+/*Encode a partly repetitive, partly random image, so that the encoder uses back references too*/
+static void encode(const png_cfg_t * cfg, uint32_t w, uint32_t h, bool interlace)
+{
+    LodePNGState state;
+    lodepng_state_init(&state);
+    state.encoder.auto_convert = 0;
+    state.encoder.filter_palette_zero = 0;
+    state.encoder.zlibsettings.btype = cfg->btype;
+    state.info_png.interlace_method = interlace;
+    state.info_raw.colortype = cfg->ct;
+    state.info_raw.bitdepth = cfg->depth;
+    state.info_png.color.colortype = cfg->ct;
+    state.info_png.color.bitdepth = cfg->depth;
+
+    /*All the filter types*/
+    uint8_t * filters = lv_mem_alloc(h);
+    uint32_t i;
+    for(i = 0; i < h; i++) filters[i] = i % 5;
+    if(!interlace) {
+        state.encoder.filter_strategy = LFS_PREDEFINED;
+        state.encoder.predefined_filters = filters;
+    }
+
+    if(cfg->ct == LCT_PALETTE) {
+        for(i = 0; i < (1U << cfg->depth); i++) {
+            uint8_t r = rnd(), g = rnd(), b = rnd(), a = i % 3 ? 255 : rnd();
+            lodepng_palette_add(&state.info_png.color, r, g, b, a);
+            lodepng_palette_add(&state.info_raw, r, g, b, a);
+        }
+    }
+
+    size_t raw_size = lodepng_get_raw_size(w, h, &state.info_raw);
+    uint8_t * raw = lv_mem_alloc(raw_size);
+    for(i = 0; i < raw_size; i++) {
+        raw[i] = rnd() % 4 == 0 ? rnd() : (uint8_t)(i / 7 + (i / 101) * 3);
+    }
+
+    if(cfg->key) {
+        /*The color of the first pixel is transparent*/
+        bool rgb = cfg->ct == LCT_RGB;
+        state.info_png.color.key_defined = 1;
+        state.info_png.color.key_r = get_sample(raw, 0, cfg->depth);
+        state.info_png.color.key_g = get_sample(raw, rgb ? 1 : 0, cfg->depth);
+        state.info_png.color.key_b = get_sample(raw, rgb ? 2 : 0, cfg->depth);
+        lodepng_color_mode_copy(&state.info_raw, &state.info_png.color);
+    }
+
+    size_t png_size;
+    TEST_ASSERT_EQUAL_UINT32(0, lodepng_encode(&png, &png_size, raw, w, h, &state));
+    lodepng_state_cleanup(&state);
+    lv_mem_free(raw);
+    lv_mem_free(filters);
+
+    unsigned ref_w;
+    unsigned ref_h;
+    TEST_ASSERT_EQUAL_UINT32(0, lodepng_decode32(&ref, &ref_w, &ref_h, png, png_size));
+
+    /*The color format of the display*/
+    for(i = 0; i < w * h; i++) {
+        uint8_t tmp = ref[i * 4];
+        ref[i * 4] = ref[i * 4 + 2];
+        ref[i * 4 + 2] = tmp;
+    }
+
+    lv_memset_00(&img_dsc, sizeof(img_dsc));
+    img_dsc.header.cf = LV_IMG_CF_RAW_ALPHA;
+    img_dsc.data = png;
+    img_dsc.data_size = png_size;
+}
+
+/*Split the image data into chunks of `len` bytes*/
+static void split_idat(uint32_t len)
+{
+    uint32_t size = img_dsc.data_size;
+    uint8_t * split = lv_mem_alloc(size + (size / len + 1) * 12);
+    uint32_t pos = 8;
+    uint32_t out = 8;
+    lv_memcpy(split, png, 8);
+    while(pos < size) {
+        const uint8_t * p = png + pos;
+        uint32_t chunk_len = ((uint32_t)p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+        if(memcmp(p + 4, "IDAT", 4) != 0) {
+            lv_memcpy(split + out, p, chunk_len + 12);
+            out += chunk_len + 12;
+        }
+        else {
+            uint32_t i;
+            for(i = 0; i < chunk_len; i += len) {
+                uint32_t l = LV_MIN(len, chunk_len - i);
+                uint8_t * o = split + out;
+                o[0] = l >> 24;
+                o[1] = l >> 16;
+                o[2] = l >> 8;
+                o[3] = l;
+                lv_memcpy(o + 4, "IDAT", 4);
+                lv_memcpy(o + 8, p + 8 + i, l);
+                uint32_t crc = lodepng_crc32(o + 4, l + 4);
+                o[l + 8] = crc >> 24;
+                o[l + 9] = crc >> 16;
+                o[l + 10] = crc >> 8;
+                o[l + 11] = crc;
+                out += l + 12;
+            }
+        }
+        pos += chunk_len + 12;
+    }
+
+    lv_mem_free(png);
+    png = split;
+    img_dsc.data = png;
+    img_dsc.data_size = out;
+}
+
+static void save_file(void)
+{
+    FILE * f = fopen(PNG_FILE, "wb");
+    TEST_ASSERT_NOT_NULL(f);
+    fwrite(img_dsc.data, 1, img_dsc.data_size, f);
+    fclose(f);
+}
+
+static void check_full(const void * src, uint32_t w, uint32_t h)
+{
+    lv_png_set_stream_min_size(0);
+    lv_img_decoder_dsc_t dsc;
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_open(&dsc, src, lv_color_black(), 0));
+    TEST_ASSERT_NOT_NULL(dsc.img_data);
+    TEST_ASSERT_EQUAL_UINT32(w, dsc.header.w);
+    TEST_ASSERT_EQUAL_UINT32(h, dsc.header.h);
+    TEST_ASSERT_EQUAL_MEMORY(ref, dsc.img_data, w * h * 4);
+    lv_img_decoder_close(&dsc);
+}
+
+static void check_stream(const void * src, uint32_t w, uint32_t h)
+{
+    lv_png_set_stream_min_size(1);
+    lv_img_decoder_dsc_t dsc;
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_open(&dsc, src, lv_color_black(), 0));
+    TEST_ASSERT_NULL(dsc.img_data);
+
+    uint8_t * buf = lv_mem_alloc(w * 4);
+    uint32_t y;
+    for(y = 0; y < h; y++) {
+        TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_read_line(&dsc, 0, y, w, buf));
+        TEST_ASSERT_EQUAL_MEMORY(&ref[y * w * 4], buf, w * 4);
+    }
+
+    /*Parts of random rows, also the same row again and earlier rows*/
+    uint32_t i;
+    for(i = 0; i < 20; i++) {
+        y = rnd() % h;
+        uint32_t x = rnd() % w;
+        uint32_t len = 1 + rnd() % (w - x);
+        TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_read_line(&dsc, x, y, len, buf));
+        TEST_ASSERT_EQUAL_MEMORY(&ref[(y * w + x) * 4], buf, len * 4);
+        TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_read_line(&dsc, x, y, len, buf));
+        TEST_ASSERT_EQUAL_MEMORY(&ref[(y * w + x) * 4], buf, len * 4);
+    }
+
+    TEST_ASSERT_EQUAL(LV_RES_INV, lv_img_decoder_read_line(&dsc, 0, h, 1, buf));
+    TEST_ASSERT_EQUAL(LV_RES_INV, lv_img_decoder_read_line(&dsc, w - 1, 0, 2, buf));
+
+    lv_mem_free(buf);
+    lv_img_decoder_close(&dsc);
+}
+
+static void free_png(void)
+{
+    lv_mem_free(png);
+    lv_mem_free(ref);
+    png = NULL;
+    ref = NULL;
+}
+
+void setUp(void)
+{
+    rnd_state = 1;
+}
+
+void tearDown(void)
+{
+    lv_png_set_stream_min_size(LV_PNG_STREAM_MIN_SIZE);
+    lv_obj_clean(lv_scr_act());
+    free_png();
+}
+
+void test_png_color_types(void)
+{
+    uint32_t i;
+    for(i = 0; i < sizeof(cfgs) / sizeof(cfgs[0]); i++) {
+        /*Widths which don't fill the last byte of the rows too*/
+        uint32_t w = 37 + i;
+        uint32_t h = 23;
+        encode(&cfgs[i], w, h, false);
+        check_full(&img_dsc, w, h);
+        check_stream(&img_dsc, w, h);
+        free_png();
+    }
+}
+
+void test_png_large(void)
+{
+    /*Larger than the deflate window*/
+    encode(&cfgs[0], 160, 120, false);
+    check_full(&img_dsc, 160, 120);
+    check_stream(&img_dsc, 160, 120);
+
+    /*The data of the image is in several chunks*/
+    split_idat(1000);
+    check_full(&img_dsc, 160, 120);
+    check_stream(&img_dsc, 160, 120);
+}
+
+void test_png_file(void)
+{
+    encode(&cfgs[3], 100, 70, false);
+    split_idat(333);
+    save_file();
+    check_full("A:" PNG_FILE, 100, 70);
+    check_stream("A:" PNG_FILE, 100, 70);
+    check_full("B:" PNG_FILE, 100, 70);
+    check_stream("B:" PNG_FILE, 100, 70);
+    remove(PNG_FILE);
+}
+
+void test_png_interlaced(void)
+{
+    /*Decoded fully by lodepng*/
+    encode(&cfgs[0], 50, 40, true);
+    check_full(&img_dsc, 50, 40);
+
+    lv_png_set_stream_min_size(1);
+    lv_img_decoder_dsc_t dsc;
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_open(&dsc, &img_dsc, lv_color_black(), 0));
+    TEST_ASSERT_EQUAL_MEMORY(ref, dsc.img_data, 50 * 40 * 4);
+    lv_img_decoder_close(&dsc);
+}
+
+void test_png_corrupted(void)
+{
+    encode(&cfgs[0], 60, 50, false);
+    uint32_t size = img_dsc.data_size;
+
+    /*The end of the data is missing*/
+    img_dsc.data_size = size / 2;
+    lv_png_set_stream_min_size(0);
+    lv_img_decoder_dsc_t dsc;
+    TEST_ASSERT_EQUAL(LV_RES_INV, lv_img_decoder_open(&dsc, &img_dsc, lv_color_black(), 0));
+
+    lv_png_set_stream_min_size(1);
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_open(&dsc, &img_dsc, lv_color_black(), 0));
+    uint8_t buf[60 * 4];
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_read_line(&dsc, 0, 0, 60, buf));
+    TEST_ASSERT_EQUAL(LV_RES_INV, lv_img_decoder_read_line(&dsc, 0, 49, 60, buf));
+    lv_img_decoder_close(&dsc);
+
+    /*Invalid zlib header*/
+    img_dsc.data_size = size;
+    uint8_t * cmf = png + 8;
+    while(memcmp(cmf + 4, "IDAT", 4) != 0) cmf += ((cmf[2] << 8) | cmf[3]) + 12;
+    cmf += 8;
+    *cmf ^= 0x01;
+    TEST_ASSERT_EQUAL(LV_RES_INV, lv_img_decoder_open(&dsc, &img_dsc, lv_color_black(), 0));
+    *cmf ^= 0x01;
+
+    /*Invalid block type, found only when the first row is decoded*/
+    cmf[2] |= 0x06;
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_open(&dsc, &img_dsc, lv_color_black(), 0));
+    TEST_ASSERT_EQUAL(LV_RES_INV, lv_img_decoder_read_line(&dsc, 0, 0, 60, buf));
+    lv_img_decoder_close(&dsc);
+
+    lv_png_set_stream_min_size(0);
+    TEST_ASSERT_EQUAL(LV_RES_INV, lv_img_decoder_open(&dsc, &img_dsc, lv_color_black(), 0));
+}
+
+void test_png_draw(void)
+{
+    encode(&cfgs[12], 130, 90, false);
+
+    lv_obj_t * img = lv_img_create(lv_scr_act());
+    lv_obj_set_pos(img, 11, 7);
+    lv_png_set_stream_min_size(0);
+    lv_img_set_src(img, &img_dsc);
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+
+    uint32_t fb_size = LV_HOR_RES * LV_VER_RES * sizeof(lv_color_t);
+    lv_color_t * full_fb = malloc(fb_size);   /*Not from the LVGL heap to keep its max. usage low for test_png_perf*/
+    lv_memcpy(full_fb, test_fb, fb_size);
+
+    lv_img_cache_invalidate_src(NULL);
+    lv_png_set_stream_min_size(1);
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+
+    TEST_ASSERT_EQUAL_MEMORY(full_fb, test_fb, fb_size);
+    free(full_fb);
+
+#if LV_IMG_CACHE_DEF_SIZE
+    /*The cached stream has no pixels but its window and rows are counted, the entry itself is much smaller*/
+    lv_img_cache_stats_t stats;
+    lv_img_cache_get_stats(&stats);
+    TEST_ASSERT_GREATER_THAN_UINT32(4096, stats.mem_size);
+#endif
+    lv_img_cache_invalidate_src(NULL);
+}
+
+#if LV_MEM_CUSTOM == 0
+/*The current usage of the heap can be derived from the growth of the max. usage
+ *caused by an allocation which surely exceeds it*/
+static uint32_t mem_get_cur_used(void)
+{
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    uint32_t size = mon.max_used;
+    void * p = lv_mem_alloc(size);
+    TEST_ASSERT_NOT_NULL(p);
+    lv_mem_monitor(&mon);
+    lv_mem_free(p);
+    return mon.max_used - size;
+}
+
+/*Allocate the difference between the current and the max. usage.
+ *After this the max. usage grows by every byte allocated.*/
+static void * ballast_alloc(uint32_t cur_used, uint32_t * max_used)
+{
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    void * ballast = lv_mem_alloc(mon.max_used - cur_used);
+    TEST_ASSERT_NOT_NULL(ballast);
+    *max_used = mon.max_used;
+    return ballast;
+}
+
+static uint32_t ballast_free(void * ballast, uint32_t max_used_ori)
+{
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    lv_mem_free(ballast);
+    return mon.max_used - max_used_ori;
+}
+#endif
+
+void test_png_perf(void)
+{
+    /*An icon of 200x200 px*/
+    encode(&cfgs[0], 200, 200, false);
+    uint32_t line_size = 200 * LV_IMG_PX_SIZE_ALPHA_BYTE;
+    uint8_t * line = lv_mem_alloc(line_size);
+    uint32_t peak[3] = {0};
+    uint32_t time[3];
+    uint32_t i;
+#if LV_MEM_CUSTOM == 0
+    uint32_t cur_used = mem_get_cur_used();
+#endif
+    for(i = 0; i < 3; i++) {
+#if LV_MEM_CUSTOM == 0
+        uint32_t max_used;
+        void * ballast = ballast_alloc(cur_used, &max_used);
+#endif
+        uint32_t t = lv_test_time_us();
+        if(i == 0) {
+            /*lodepng decodes the whole image to ARGB8888 which is converted in place*/
+            uint8_t * data;
+            unsigned w;
+            unsigned h;
+            TEST_ASSERT_EQUAL_UINT32(0, lodepng_decode32(&data, &w, &h, img_dsc.data, img_dsc.data_size));
+            uint32_t px;
+            for(px = 0; px < w * h; px++) {
+                lv_color_t c = lv_color_make(data[px * 4], data[px * 4 + 1], data[px * 4 + 2]);
+                lv_memcpy_small(&data[px * 4], &c, 3);
+            }
+            lv_mem_free(data);
+        }
+        else {
+            lv_png_set_stream_min_size(i == 1 ? 0 : 1);
+            lv_img_decoder_dsc_t dsc;
+            TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_open(&dsc, &img_dsc, lv_color_black(), 0));
+            if(i == 2) {
+                uint32_t y;
+                for(y = 0; y < 200; y++) lv_img_decoder_read_line(&dsc, 0, y, 200, line);
+                TEST_ASSERT_EQUAL_MEMORY(&ref[199 * line_size], line, line_size);
+            }
+            lv_img_decoder_close(&dsc);
+        }
+        time[i] = lv_test_time_us() - t;
+#if LV_MEM_CUSTOM == 0
+        peak[i] = ballast_free(ballast, max_used);
+#endif
+    }
+    lv_mem_free(line);
+
+    TEST_PRINTF("200x200 PNG, lodepng + conversion: %u us, %u bytes peak; one pass: %u us, %u bytes peak; "
+                "row by row: %u us, %u bytes peak", (unsigned)time[0], (unsigned)peak[0], (unsigned)time[1],
+                (unsigned)peak[1], (unsigned)time[2], (unsigned)peak[2]);
+
+#if LV_MEM_CUSTOM == 0
+    /*The image itself or nothing of its size*/
+    TEST_ASSERT_LESS_THAN_UINT32(peak[0], peak[1]);
+    TEST_ASSERT_LESS_THAN_UINT32(200 * 200 * 4 + 40 * 1024, peak[1]);
+    TEST_ASSERT_LESS_THAN_UINT32(40 * 1024, peak[2]);
+#endif
+}
+
+#else
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_png_color_types(void)
+{
+}
+
+void test_png_large(void)
+{
+}
+
+void test_png_file(void)
+{
+}
+
+void test_png_interlaced(void)
+{
+}
+
+void test_png_corrupted(void)
+{
+}
+
+void test_png_draw(void)
+{
+}
+
+void test_png_perf(void)
+{
+}
+
+#endif
+
+#endif
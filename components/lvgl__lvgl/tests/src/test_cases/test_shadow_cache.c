@@ -0,0 +1,239 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+#include "../demos/lv_demos.h"
+#include "../src/draw/sw/lv_draw_sw.h"
+
+#include "unity/unity.h"
+
+/*Shadows are rendered with and without caching their blurred corners.
+ *The result has to be the same pixel by pixel, also for small rectangles whose size changes the corner.
+ *The frame times and hit rates of the shadow scenes of the benchmark demo are printed.*/
+
+#if LV_DRAW_COMPLEX && LV_SHADOW_CACHE_SIZE >= 64
+
+#include <stdlib.h>
+#include <time.h>
+
+#define FRAMES      5
+#define SCREEN_SIZE (LV_HOR_RES * LV_VER_RES * sizeof(lv_color_t))
+
+static lv_color_t * ref_buf;
+
+extern lv_color_t test_fb[];
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/*Redraw the whole screen a few times and return the average time of a frame*/
+static uint64_t render(uint32_t mem_size)
+{
+    lv_draw_sw_shadow_cache_set_mem_size(mem_size);
+
+    uint64_t t_sum = 0;
+    uint32_t i;
+    for(i = 0; i < FRAMES; i++) {
+        lv_memset_ff(test_fb, SCREEN_SIZE);
+        lv_obj_invalidate(lv_scr_act());
+        uint64_t t = now_ns();
+        lv_refr_now(NULL);
+        t_sum += now_ns() - t;
+    }
+
+    return t_sum / FRAMES;
+}
+
+/*The screen with the cache has to be the same as without it*/
+static void check_against_uncached(uint32_t mem_size)
+{
+    render(0);
+    lv_memcpy(ref_buf, test_fb, SCREEN_SIZE);
+    render(mem_size);
+    TEST_ASSERT_EQUAL_MEMORY(ref_buf, test_fb, SCREEN_SIZE);
+}
+
+static lv_obj_t * shadow_create(lv_coord_t x, lv_coord_t y, lv_coord_t w, lv_coord_t h)
+{
+    lv_obj_t * obj = lv_obj_create(lv_scr_act());
+    lv_obj_remove_style_all(obj);
+    lv_obj_set_style_bg_opa(obj, LV_OPA_COVER, 0);
+    lv_obj_set_style_shadow_opa(obj, LV_OPA_COVER, 0);
+    lv_obj_set_pos(obj, x, y);
+    lv_obj_set_size(obj, w, h);
+    return obj;
+}
+
+void setUp(void)
+{
+    ref_buf = malloc(SCREEN_SIZE);
+    lv_draw_sw_shadow_cache_set_mem_size(LV_SHADOW_CACHE_MEM_SIZE);
+}
+
+void tearDown(void)
+{
+    lv_draw_sw_shadow_cache_set_mem_size(LV_SHADOW_CACHE_MEM_SIZE);
+    lv_obj_clean(lv_scr_act());
+    free(ref_buf);
+}
+
+#if LV_USE_DEMO_BENCHMARK
+void test_shadow_cache_benchmark_scenes(void)
+{
+    /*Index of the shadow scenes in the benchmark*/
+    static const uint32_t scenes[] = {11, 12, 13, 14};
+    static const char * names[] = {"small", "small offset", "large", "large offset"};
+
+    uint32_t s;
+    for(s = 0; s < sizeof(scenes) / sizeof(scenes[0]); s++) {
+        uint32_t opa;
+        for(opa = 0; opa < 2; opa++) {
+            lv_demo_benchmark_run_scene(scenes[s] * 2 + opa);
+
+            lv_draw_sw_shadow_cache_stats_t s1;
+            lv_draw_sw_shadow_cache_stats_t s2;
+            uint64_t t_no_cache = 0;
+            uint64_t t_cache = 0;
+            uint32_t hit_cnt = 0;
+            uint32_t miss_cnt = 0;
+
+            /*Let the objects fall and check the frames on the way. It also reports the FPS of the scene.*/
+            uint32_t i;
+            for(i = 0; i < 32; i++) {
+                lv_tick_inc(33);
+                lv_timer_handler();
+                if(i % 4) continue;
+
+                t_no_cache += render(0);
+                lv_memcpy(ref_buf, test_fb, SCREEN_SIZE);
+
+                /*The first frame fills the cache, the others are measured*/
+                lv_draw_sw_shadow_cache_set_mem_size(LV_SHADOW_CACHE_MEM_SIZE);
+                lv_obj_invalidate(lv_scr_act());
+                lv_refr_now(NULL);
+                lv_draw_sw_shadow_cache_get_stats(&s1);
+                t_cache += render(LV_SHADOW_CACHE_MEM_SIZE);
+                lv_draw_sw_shadow_cache_get_stats(&s2);
+                TEST_ASSERT_EQUAL_MEMORY(ref_buf, test_fb, SCREEN_SIZE);
+
+                hit_cnt += s2.hit_cnt - s1.hit_cnt;
+                miss_cnt += s2.miss_cnt - s1.miss_cnt;
+            }
+
+            TEST_ASSERT_GREATER_THAN_UINT32(0, hit_cnt);
+            TEST_PRINTF("shadow %s%s: %u us/frame without cache, %u us/frame with cache, %u%% hits",
+                        names[s], opa ? " + opa" : "", (unsigned)(t_no_cache / 8000), (unsigned)(t_cache / 8000),
+                        (unsigned)((hit_cnt * 100) / (hit_cnt + miss_cnt)));
+
+            lv_demo_benchmark_close();
+        }
+    }
+
+    lv_disp_get_default()->driver->monitor_cb = NULL;
+}
+#else
+void test_shadow_cache_benchmark_scenes(void)
+{
+}
+#endif
+
+void test_shadow_cache_sizes(void)
+{
+    /*Rectangles from tiny to larger than the corner. The small ones have their own corners.*/
+    static const lv_coord_t widths[] = {2, 3, 4, 6, 9, 13, 18, 24, 31, 40, 52, 70};
+    static const lv_coord_t sws[] = {1, 2, 5, 8, 15, 30};
+    static const lv_coord_t radii[] = {0, 3, 10, LV_RADIUS_CIRCLE};
+    static const lv_coord_t spreads[] = {-3, 0, 4};
+
+    uint32_t r;
+    uint32_t sp;
+    for(r = 0; r < sizeof(radii) / sizeof(radii[0]); r++) {
+        for(sp = 0; sp < sizeof(spreads) / sizeof(spreads[0]); sp++) {
+            uint32_t i;
+            uint32_t j;
+            for(i = 0; i < sizeof(sws) / sizeof(sws[0]); i++) {
+                for(j = 0; j < sizeof(widths) / sizeof(widths[0]); j++) {
+                    lv_obj_t * obj = shadow_create(10 + j * 66, 10 + i * 78, widths[j] / 2 + 2, widths[j]);
+                    lv_obj_set_style_radius(obj, radii[r], 0);
+                    lv_obj_set_style_shadow_width(obj, sws[i], 0);
+                    lv_obj_set_style_shadow_spread(obj, spreads[sp], 0);
+                    lv_obj_set_style_shadow_ofs_x(obj, j % 3, 0);
+                }
+            }
+
+            check_against_uncached(LV_SHADOW_CACHE_MEM_SIZE);
+            lv_obj_clean(lv_scr_act());
+        }
+    }
+}
+
+void test_shadow_cache_lru(void)
+{
+    lv_obj_t * objs[4];
+    uint32_t i;
+    for(i = 0; i < 4; i++) {
+        objs[i] = shadow_create(20 + i * 180, 50, 120, 80);
+        lv_obj_set_style_radius(objs[i], 10, 0);
+        lv_obj_set_style_shadow_width(objs[i], 20 + i * 4, 0);
+    }
+
+    lv_draw_sw_shadow_cache_stats_t s1;
+    lv_draw_sw_shadow_cache_stats_t s2;
+
+    /*All corners fit, only the first frame calculates them*/
+    lv_draw_sw_shadow_cache_get_stats(&s1);
+    render(LV_SHADOW_CACHE_MEM_SIZE);
+    lv_draw_sw_shadow_cache_get_stats(&s2);
+    TEST_ASSERT_EQUAL_UINT32(4, s2.miss_cnt - s1.miss_cnt);
+    TEST_ASSERT_EQUAL_UINT32(4 * (FRAMES - 1), s2.hit_cnt - s1.hit_cnt);
+    TEST_ASSERT_EQUAL_UINT16(4, s2.entry_cnt);
+    TEST_ASSERT_LESS_OR_EQUAL(s2.mem_max, s2.mem_size);
+
+    /*Only 2 corners of ~40x40 fit, they evict each other in every frame*/
+    check_against_uncached(2 * 44 * 44);
+    lv_draw_sw_shadow_cache_get_stats(&s2);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT16(2, s2.entry_cnt);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, s2.evict_cnt);
+    TEST_ASSERT_LESS_OR_EQUAL(s2.mem_max, s2.mem_size);
+
+    /*Too small for any corner, nothing is cached*/
+    check_against_uncached(100);
+    lv_draw_sw_shadow_cache_get_stats(&s2);
+    TEST_ASSERT_EQUAL_UINT16(0, s2.entry_cnt);
+    TEST_ASSERT_EQUAL(0, s2.mem_size);
+
+    /*Not counted while disabled*/
+    lv_draw_sw_shadow_cache_get_stats(&s1);
+    render(0);
+    lv_draw_sw_shadow_cache_get_stats(&s2);
+    TEST_ASSERT_EQUAL_UINT32(s1.hit_cnt, s2.hit_cnt);
+    TEST_ASSERT_EQUAL_UINT32(s1.miss_cnt, s2.miss_cnt);
+}
+
+#else
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_shadow_cache_benchmark_scenes(void)
+{
+}
+
+void test_shadow_cache_sizes(void)
+{
+}
+
+void test_shadow_cache_lru(void)
+{
+}
+
+#endif
+
+#endif
@@ -0,0 +1,272 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+#include "../demos/lv_demos.h"
+
+#include "unity/unity.h"
+
+/*The widgets demo is rendered with and without caching the resolved style properties.
+ *The result has to be the same pixel by pixel. The style lookups and render times are printed as a benchmark.
+ *The cached values have to follow the style, state and transition changes.*/
+
+#if LV_OBJ_STYLE_CACHE_DEF_SIZE
+
+#include <stdlib.h>
+#include <time.h>
+
+#define FRAMES      10
+#define SCREEN_SIZE (LV_HOR_RES * LV_VER_RES * sizeof(lv_color_t))
+
+static lv_color_t * ref_buf;
+static bool demo_open;
+
+extern lv_color_t test_fb[];
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/*Redraw the whole screen a few times, return the average time of a frame and the counters of a frame*/
+static uint64_t render(uint32_t cache_size, lv_obj_style_cache_stats_t * frame_stats)
+{
+    lv_obj_style_cache_set_size(cache_size);
+
+    /*Warm up, the first frame can update the layout too*/
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+
+    lv_obj_style_cache_stats_t s1;
+    lv_obj_style_cache_stats_t s2;
+    lv_obj_style_cache_get_stats(&s1);
+
+    uint64_t t_sum = 0;
+    uint32_t i;
+    for(i = 0; i < FRAMES; i++) {
+        lv_memset_ff(test_fb, SCREEN_SIZE);
+        lv_obj_invalidate(lv_scr_act());
+        uint64_t t = now_ns();
+        lv_refr_now(NULL);
+        t_sum += now_ns() - t;
+    }
+
+    lv_obj_style_cache_get_stats(&s2);
+    frame_stats->lookup_cnt = (s2.lookup_cnt - s1.lookup_cnt) / FRAMES;
+    frame_stats->walk_cnt = (s2.walk_cnt - s1.walk_cnt) / FRAMES;
+    frame_stats->hit_cnt = (s2.hit_cnt - s1.hit_cnt) / FRAMES;
+    frame_stats->entry_max = s2.entry_max;
+
+    return t_sum / FRAMES;
+}
+
+/*The screen with the cache has to be the same as without it*/
+static void check_against_uncached(void)
+{
+    lv_obj_style_cache_stats_t s;
+    render(LV_OBJ_STYLE_CACHE_DEF_SIZE, &s);
+    lv_memcpy(ref_buf, test_fb, SCREEN_SIZE);
+    render(0, &s);
+    TEST_ASSERT_EQUAL_MEMORY(ref_buf, test_fb, SCREEN_SIZE);
+    lv_obj_style_cache_set_size(LV_OBJ_STYLE_CACHE_DEF_SIZE);
+}
+
+void setUp(void)
+{
+    ref_buf = malloc(SCREEN_SIZE);
+    lv_obj_style_cache_set_size(LV_OBJ_STYLE_CACHE_DEF_SIZE);
+}
+
+void tearDown(void)
+{
+    lv_obj_style_cache_set_size(LV_OBJ_STYLE_CACHE_DEF_SIZE);
+#if LV_USE_DEMO_WIDGETS
+    if(demo_open) lv_demo_widgets_close();
+    demo_open = false;
+#endif
+    lv_obj_clean(lv_scr_act());
+    free(ref_buf);
+}
+
+#if LV_USE_DEMO_WIDGETS
+void test_style_cache_widgets_demo(void)
+{
+    lv_demo_widgets();
+    demo_open = true;
+
+    lv_obj_style_cache_stats_t s_no_cache;
+    lv_obj_style_cache_stats_t s_cache;
+    uint64_t t_no_cache = render(0, &s_no_cache);
+    lv_memcpy(ref_buf, test_fb, SCREEN_SIZE);
+
+    uint64_t t_cache = render(LV_OBJ_STYLE_CACHE_DEF_SIZE, &s_cache);
+    TEST_ASSERT_EQUAL_MEMORY(ref_buf, test_fb, SCREEN_SIZE);
+
+    TEST_ASSERT_EQUAL_UINT32(s_no_cache.lookup_cnt, s_cache.lookup_cnt);
+    TEST_ASSERT_EQUAL_UINT32(0, s_no_cache.hit_cnt);
+    TEST_ASSERT_LESS_THAN_UINT32(s_no_cache.walk_cnt, s_cache.walk_cnt);
+
+    TEST_PRINTF("widgets demo, %u style lookups/frame: %u style walks and %u us/frame without cache",
+                (unsigned)s_cache.lookup_cnt, (unsigned)s_no_cache.walk_cnt, (unsigned)(t_no_cache / 1000));
+    TEST_PRINTF("%u entries: %u style walks, %u hits and %u us/frame", (unsigned)s_cache.entry_max,
+                (unsigned)s_cache.walk_cnt, (unsigned)s_cache.hit_cnt, (unsigned)(t_cache / 1000));
+
+    /*Let the animations and timers of the demo change the styles and check again*/
+    uint32_t i;
+    for(i = 0; i < 50; i++) {
+        lv_tick_inc(33);
+        lv_timer_handler();
+    }
+    check_against_uncached();
+}
+#else
+void test_style_cache_widgets_demo(void)
+{
+}
+#endif
+
+void test_style_cache_local_and_shared_style(void)
+{
+    static lv_style_t style;
+    lv_style_init(&style);
+    lv_style_set_bg_color(&style, lv_palette_main(LV_PALETTE_RED));
+    lv_style_set_radius(&style, 7);
+
+    lv_obj_t * obj = lv_obj_create(lv_scr_act());
+    lv_coord_t radius_theme = lv_obj_get_style_radius(obj, 0);
+    lv_obj_add_style(obj, &style, 0);
+    TEST_ASSERT_EQUAL_HEX16(lv_palette_main(LV_PALETTE_RED).full, lv_obj_get_style_bg_color(obj, 0).full);
+    TEST_ASSERT_EQUAL(7, lv_obj_get_style_radius(obj, 0));
+
+    lv_obj_set_style_bg_color(obj, lv_palette_main(LV_PALETTE_BLUE), 0);
+    TEST_ASSERT_EQUAL_HEX16(lv_palette_main(LV_PALETTE_BLUE).full, lv_obj_get_style_bg_color(obj, 0).full);
+
+    lv_obj_remove_local_style_prop(obj, LV_STYLE_BG_COLOR, 0);
+    TEST_ASSERT_EQUAL_HEX16(lv_palette_main(LV_PALETTE_RED).full, lv_obj_get_style_bg_color(obj, 0).full);
+
+    lv_style_set_radius(&style, 9);
+    lv_obj_report_style_change(&style);
+    TEST_ASSERT_EQUAL(9, lv_obj_get_style_radius(obj, 0));
+
+    /*All the cached values are dropped if the objects are not refreshed*/
+    lv_obj_enable_style_refresh(false);
+    lv_style_set_radius(&style, 11);
+    lv_obj_report_style_change(&style);
+    lv_obj_enable_style_refresh(true);
+    TEST_ASSERT_EQUAL(11, lv_obj_get_style_radius(obj, 0));
+
+    lv_obj_remove_style(obj, &style, 0);
+    TEST_ASSERT_EQUAL(radius_theme, lv_obj_get_style_radius(obj, 0));
+
+    /*Inherited from the parent*/
+    lv_obj_t * label = lv_label_create(obj);
+    lv_obj_set_style_text_color(obj, lv_palette_main(LV_PALETTE_GREEN), 0);
+    TEST_ASSERT_EQUAL_HEX16(lv_palette_main(LV_PALETTE_GREEN).full, lv_obj_get_style_text_color(label, 0).full);
+    lv_obj_set_style_text_color(obj, lv_palette_main(LV_PALETTE_TEAL), 0);
+    TEST_ASSERT_EQUAL_HEX16(lv_palette_main(LV_PALETTE_TEAL).full, lv_obj_get_style_text_color(label, 0).full);
+
+    lv_style_reset(&style);
+    check_against_uncached();
+}
+
+void test_style_cache_state_and_transition(void)
+{
+    static const lv_style_prop_t props[] = {LV_STYLE_BG_OPA, 0};
+    static lv_style_transition_dsc_t tr;
+    lv_style_transition_dsc_init(&tr, props, lv_anim_path_linear, 100, 0, NULL);
+
+    static lv_style_t style_pr;
+    lv_style_init(&style_pr);
+    lv_style_set_bg_opa(&style_pr, LV_OPA_20);
+    lv_style_set_transition(&style_pr, &tr);
+
+    lv_obj_t * obj = lv_obj_create(lv_scr_act());
+    lv_obj_set_style_bg_opa(obj, LV_OPA_100, 0);
+    lv_obj_set_style_border_width(obj, 3, 0);
+    lv_obj_set_style_border_width(obj, 5, LV_STATE_FOCUSED);
+    lv_obj_add_style(obj, &style_pr, LV_STATE_PRESSED);
+
+    TEST_ASSERT_EQUAL(3, lv_obj_get_style_border_width(obj, 0));
+    lv_obj_add_state(obj, LV_STATE_FOCUSED);
+    TEST_ASSERT_EQUAL(5, lv_obj_get_style_border_width(obj, 0));
+    lv_obj_clear_state(obj, LV_STATE_FOCUSED);
+    TEST_ASSERT_EQUAL(3, lv_obj_get_style_border_width(obj, 0));
+
+    /*The transition starts from the current value and ends at the pressed value*/
+    TEST_ASSERT_EQUAL(LV_OPA_100, lv_obj_get_style_bg_opa(obj, 0));
+    lv_obj_add_state(obj, LV_STATE_PRESSED);
+    TEST_ASSERT_EQUAL(LV_OPA_100, lv_obj_get_style_bg_opa(obj, 0));
+
+    lv_tick_inc(50);
+    lv_timer_handler();
+    lv_opa_t opa = lv_obj_get_style_bg_opa(obj, 0);
+    TEST_ASSERT_LESS_THAN(LV_OPA_100, opa);
+    TEST_ASSERT_GREATER_THAN(LV_OPA_20, opa);
+    check_against_uncached();
+
+    lv_tick_inc(100);
+    lv_timer_handler();
+    TEST_ASSERT_EQUAL(LV_OPA_20, lv_obj_get_style_bg_opa(obj, 0));
+
+    lv_obj_clear_state(obj, LV_STATE_PRESSED);
+    lv_tick_inc(500);
+    lv_timer_handler();
+    TEST_ASSERT_EQUAL(LV_OPA_100, lv_obj_get_style_bg_opa(obj, 0));
+    check_against_uncached();
+
+    lv_obj_remove_style(obj, &style_pr, LV_STATE_PRESSED);
+    lv_style_reset(&style_pr);
+}
+
+void test_style_cache_small(void)
+{
+    lv_obj_t * objs[20];
+    uint32_t i;
+    for(i = 0; i < 20; i++) {
+        objs[i] = lv_btn_create(lv_scr_act());
+        lv_obj_set_pos(objs[i], (i % 5) * 150, (i / 5) * 100);
+        lv_obj_set_style_radius(objs[i], i, 0);
+        lv_obj_t * label = lv_label_create(objs[i]);
+        lv_label_set_text_fmt(label, "Button %d", (int)i);
+    }
+
+    /*Only a group of slots, the objects evict each other's values all the time*/
+    lv_obj_style_cache_stats_t s;
+    render(0, &s);
+    lv_memcpy(ref_buf, test_fb, SCREEN_SIZE);
+    render(40, &s);
+    TEST_ASSERT_EQUAL(32, s.entry_max);
+    TEST_ASSERT_EQUAL_MEMORY(ref_buf, test_fb, SCREEN_SIZE);
+
+    for(i = 0; i < 20; i++) TEST_ASSERT_EQUAL(i, lv_obj_get_style_radius(objs[i], 0));
+}
+
+#else
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_style_cache_widgets_demo(void)
+{
+}
+
+void test_style_cache_local_and_shared_style(void)
+{
+}
+
+void test_style_cache_state_and_transition(void)
+{
+}
+
+void test_style_cache_small(void)
+{
+}
+
+#endif
+
+#endif
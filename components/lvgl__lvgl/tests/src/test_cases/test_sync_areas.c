@@ -0,0 +1,219 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+
+#include <stdlib.h>
+
+/*Direct mode with two buffers: before rendering, the areas of the last frame are copied from the buffer
+ *on the screen. Objects are moved around and after every frame the buffer on the screen has to be the
+ *same as the whole screen rendered in partial mode.*/
+
+#define FRAMES      40
+#define OBJ_CNT     24
+
+static lv_disp_draw_buf_t draw_buf;
+static lv_disp_draw_buf_t * draw_buf_ori;
+static void (*flush_cb_ori)(lv_disp_drv_t *, const lv_area_t *, lv_color_t *);
+static lv_color_t * buf1;
+static lv_color_t * buf2;
+static lv_obj_t * objs[OBJ_CNT];
+static uint32_t rnd_seed;
+static uint32_t sync_cb_cnt;
+
+extern lv_color_t test_fb[];
+
+static uint32_t rnd(void)
+{
+    rnd_seed = rnd_seed * 1103515245 + 12345;
+    return rnd_seed >> 8;
+}
+
+static void direct_flush_cb(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p)
+{
+    LV_UNUSED(area);
+    LV_UNUSED(color_p);
+    lv_disp_flush_ready(drv);
+}
+
+static void sync_cb(lv_disp_drv_t * drv, lv_color_t * dest_buf, const lv_color_t * src_buf,
+                    const lv_area_t * areas, uint16_t area_cnt)
+{
+    lv_disp_t * disp = lv_disp_get_default();
+    uint16_t i;
+    uint16_t j;
+    for(i = 0; i < area_cnt; i++) {
+        /*Nothing is copied twice or copied and then redrawn*/
+        for(j = i + 1; j < area_cnt; j++) TEST_ASSERT_FALSE(_lv_area_is_on(&areas[i], &areas[j]));
+        for(j = 0; j < disp->inv_p; j++) {
+            if(disp->inv_area_joined[j]) continue;
+            TEST_ASSERT_FALSE(_lv_area_is_on(&areas[i], &disp->inv_areas[j]));
+        }
+
+        lv_coord_t y;
+        lv_coord_t w = lv_area_get_width(&areas[i]);
+        for(y = areas[i].y1; y <= areas[i].y2; y++) {
+            uint32_t ofs = y * drv->hor_res + areas[i].x1;
+            lv_memcpy(dest_buf + ofs, src_buf + ofs, w * sizeof(lv_color_t));
+        }
+    }
+    sync_cb_cnt++;
+}
+
+void setUp(void)
+{
+    lv_disp_t * disp = lv_disp_get_default();
+    uint32_t px = LV_HOR_RES * LV_VER_RES;
+    /*Too large for the LVGL heap*/
+    buf1 = malloc(px * sizeof(lv_color_t));
+    buf2 = malloc(px * sizeof(lv_color_t));
+    lv_disp_draw_buf_init(&draw_buf, buf1, buf2, px);
+
+    draw_buf_ori = disp->driver->draw_buf;
+    flush_cb_ori = disp->driver->flush_cb;
+    disp->driver->draw_buf = &draw_buf;
+    disp->driver->flush_cb = direct_flush_cb;
+    disp->driver->direct_mode = 1;
+
+    lv_obj_t * scr = lv_scr_act();
+    lv_obj_set_style_bg_color(scr, lv_color_hex(0x204060), 0);
+    uint32_t i;
+    for(i = 0; i < OBJ_CNT; i++) {
+        if(i % 2) {
+            objs[i] = lv_label_create(scr);
+            lv_label_set_text_fmt(objs[i], "Label %d", (int)i);
+        }
+        else {
+            objs[i] = lv_obj_create(scr);
+            lv_obj_set_size(objs[i], 20 + i * 5, 30 + i * 3);
+            lv_obj_set_style_bg_color(objs[i], lv_palette_main(i % 19), 0);
+        }
+        lv_obj_set_pos(objs[i], (i * 97) % 700, (i * 53) % 400);
+    }
+
+    rnd_seed = 0x5678;
+    sync_cb_cnt = 0;
+
+    /*Render both buffers entirely*/
+    lv_obj_invalidate(scr);
+    _lv_disp_refr_timer(NULL);
+    lv_obj_invalidate(scr);
+    _lv_disp_refr_timer(NULL);
+}
+
+void tearDown(void)
+{
+    lv_disp_t * disp = lv_disp_get_default();
+    disp->driver->draw_buf = draw_buf_ori;
+    disp->driver->flush_cb = flush_cb_ori;
+    disp->driver->direct_mode = 0;
+    disp->driver->sync_cb = NULL;
+    disp->sync_p = 0;
+
+    lv_obj_clean(lv_scr_act());
+    free(buf1);
+    free(buf2);
+}
+
+/*Render the whole screen with the original single buffer, it's flushed to `test_fb`*/
+static void render_reference(void)
+{
+    lv_disp_t * disp = lv_disp_get_default();
+    disp->driver->draw_buf = draw_buf_ori;
+    disp->driver->flush_cb = flush_cb_ori;
+    disp->driver->direct_mode = 0;
+
+    lv_obj_invalidate(lv_scr_act());
+    _lv_disp_refr_timer(NULL);
+
+    disp->driver->draw_buf = &draw_buf;
+    disp->driver->flush_cb = direct_flush_cb;
+    disp->driver->direct_mode = 1;
+}
+
+static void move_objs(void)
+{
+    uint32_t cnt = 1 + rnd() % 4;
+    uint32_t i;
+    for(i = 0; i < cnt; i++) {
+        lv_obj_t * obj = objs[rnd() % OBJ_CNT];
+        lv_obj_set_pos(obj, lv_obj_get_x(obj) + (lv_coord_t)(rnd() % 41) - 20, lv_obj_get_y(obj) + (lv_coord_t)(rnd() % 41) - 20);
+        if(lv_obj_check_type(obj, &lv_label_class)) lv_label_set_text_fmt(obj, "%d", (int)rnd() % 10000);
+    }
+}
+
+static void render_frames(void)
+{
+    lv_disp_t * disp = lv_disp_get_default();
+    uint32_t copied_sum = 0;
+    uint32_t frame;
+    for(frame = 0; frame < FRAMES; frame++) {
+        move_objs();
+        lv_obj_update_layout(lv_scr_act());
+
+        /*The areas of the last frame are the upper limit of the copy*/
+        uint32_t sync_max = 0;
+        uint16_t i;
+        for(i = 0; i < disp->sync_p; i++) sync_max += lv_area_get_size(&disp->sync_areas[i]);
+
+        _lv_disp_refr_timer(NULL);
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32(sync_max * sizeof(lv_color_t), lv_disp_get_sync_size(disp));
+        copied_sum += lv_disp_get_sync_size(disp);
+
+        /*The buffers are swapped, the other one is on the screen*/
+        lv_color_t * on_screen = draw_buf.buf_act == buf1 ? buf2 : buf1;
+        render_reference();
+        TEST_ASSERT_EQUAL_MEMORY(test_fb, on_screen, LV_HOR_RES * LV_VER_RES * sizeof(lv_color_t));
+    }
+
+    TEST_PRINTF("%u bytes copied per frame (a frame is %u bytes)", (unsigned)(copied_sum / FRAMES),
+                (unsigned)(LV_HOR_RES * LV_VER_RES * sizeof(lv_color_t)));
+    TEST_ASSERT_GREATER_THAN(0, copied_sum);
+}
+
+void test_sync_areas_buffer_copy(void)
+{
+    render_frames();
+}
+
+void test_sync_areas_sync_cb(void)
+{
+    lv_disp_get_default()->driver->sync_cb = sync_cb;
+    render_frames();
+    TEST_ASSERT_GREATER_THAN(0, sync_cb_cnt);
+}
+
+void test_sync_areas_diff_is_exact(void)
+{
+    lv_area_t a1;
+    lv_area_t a2;
+    lv_area_t res[4];
+    uint32_t i;
+    for(i = 0; i < 1000; i++) {
+        lv_area_set(&a1, rnd() % 50, rnd() % 50, 50 + rnd() % 50, 50 + rnd() % 50);
+        lv_area_set(&a2, rnd() % 100, rnd() % 100, 0, 0);
+        a2.x2 = a2.x1 + rnd() % 50;
+        a2.y2 = a2.y1 + rnd() % 50;
+
+        int8_t res_c = _lv_area_diff(res, &a1, &a2);
+        if(res_c < 0) {
+            TEST_ASSERT_FALSE(_lv_area_is_on(&a1, &a2));
+            continue;
+        }
+
+        lv_area_t common;
+        _lv_area_intersect(&common, &a1, &a2);
+        uint32_t size = lv_area_get_size(&common);
+        int8_t j;
+        for(j = 0; j < res_c; j++) {
+            TEST_ASSERT_TRUE(_lv_area_is_in(&res[j], &a1, 0));
+            TEST_ASSERT_FALSE(_lv_area_is_on(&res[j], &a2));
+            int8_t k;
+            for(k = j + 1; k < res_c; k++) TEST_ASSERT_FALSE(_lv_area_is_on(&res[j], &res[k]));
+            size += lv_area_get_size(&res[j]);
+        }
+        TEST_ASSERT_EQUAL_UINT32(lv_area_get_size(&a1), size);
+    }
+}
+
+#endif
@@ -0,0 +1,285 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+
+/*Thousands of timers are run by `lv_timer_handler()` while the callbacks create, delete, pause and change
+ *other timers. Every timer has to run exactly when its period is over and the time until the next
+ *timer has to be the smallest remaining time. The time spent in the handler is printed.*/
+
+#include <time.h>
+
+#define TIMER_MAX   3000
+
+static lv_timer_t * timers[TIMER_MAX];
+static uint32_t run_cnt[TIMER_MAX];
+static uint32_t timer_cnt;
+static uint32_t base_timer_cnt;
+static uint32_t rnd_seed;
+static uint32_t one_shot_created;
+static uint32_t one_shot_ran;
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static uint32_t rnd(void)
+{
+    rnd_seed = rnd_seed * 1103515245 + 12345;
+    return rnd_seed >> 8;
+}
+
+static uint32_t count_timers(void)
+{
+    uint32_t cnt = 0;
+    lv_timer_t * t = lv_timer_get_next(NULL);
+    while(t) {
+        cnt++;
+        t = lv_timer_get_next(t);
+    }
+    return cnt;
+}
+
+/*The smallest remaining time of the not paused timers*/
+static uint32_t time_till_next_ref(void)
+{
+    uint32_t min = LV_NO_TIMER_READY;
+    lv_timer_t * t = lv_timer_get_next(NULL);
+    while(t) {
+        if(!t->paused) {
+            uint32_t elp = lv_tick_elaps(t->last_run);
+            uint32_t remaining = elp >= t->period || t->repeat_count == 0 ? 0 : t->period - elp;
+            if(remaining < min) min = remaining;
+        }
+        t = lv_timer_get_next(t);
+    }
+    return min;
+}
+
+static void count_cb(lv_timer_t * t)
+{
+    run_cnt[(lv_uintptr_t)t->user_data]++;
+}
+
+static int32_t find(lv_timer_t * t)
+{
+    uint32_t i;
+    for(i = 0; i < timer_cnt; i++) {
+        if(timers[i] == t) return i;
+    }
+    return -1;
+}
+
+static void forget(lv_timer_t * t)
+{
+    int32_t i = find(t);
+    TEST_ASSERT_GREATER_OR_EQUAL(0, i);
+    timers[i] = timers[timer_cnt - 1];
+    timer_cnt--;
+}
+
+static void chaos_cb(lv_timer_t * t);
+
+static void add_chaos_timer(void)
+{
+    if(timer_cnt >= TIMER_MAX) return;
+
+    lv_timer_t * t = lv_timer_create(chaos_cb, rnd() % 50, NULL);
+    TEST_ASSERT_NOT_NULL(t);
+    if(rnd() % 4 == 0) {
+        lv_timer_set_repeat_count(t, 1);
+        one_shot_created++;
+    }
+    timers[timer_cnt++] = t;
+}
+
+static void chaos_cb(lv_timer_t * t)
+{
+    TEST_ASSERT_GREATER_OR_EQUAL(0, find(t));
+
+    /*A one shot timer is deleted after this callback*/
+    if(t->repeat_count == 0) {
+        one_shot_ran++;
+        forget(t);
+    }
+
+    lv_timer_t * other = timer_cnt ? timers[rnd() % timer_cnt] : NULL;
+    switch(rnd() % 10) {
+        case 0:
+            add_chaos_timer();
+            add_chaos_timer();
+            break;
+        case 1:
+            if(other && other != t && other->repeat_count != 1) {
+                forget(other);
+                lv_timer_del(other);
+            }
+            break;
+        case 2:
+            if(t->repeat_count != 0) {
+                forget(t);
+                lv_timer_del(t);
+            }
+            break;
+        case 3:
+            if(other) lv_timer_pause(other);
+            break;
+        case 4:
+            if(other) lv_timer_resume(other);
+            break;
+        case 5:
+            if(other) lv_timer_set_period(other, rnd() % 50);
+            break;
+        case 6:
+            if(other) lv_timer_ready(other);
+            break;
+        case 7:
+            if(other) lv_timer_reset(other);
+            break;
+        default:
+            break;
+    }
+}
+
+void setUp(void)
+{
+    base_timer_cnt = count_timers();
+    timer_cnt = 0;
+    rnd_seed = 0x1234;
+    one_shot_created = 0;
+    one_shot_ran = 0;
+    lv_memset_00(run_cnt, sizeof(run_cnt));
+}
+
+void tearDown(void)
+{
+    uint32_t i;
+    for(i = 0; i < timer_cnt; i++) lv_timer_del(timers[i]);
+    timer_cnt = 0;
+    TEST_ASSERT_EQUAL_UINT32(base_timer_cnt, count_timers());
+}
+
+void test_timer_periods(void)
+{
+    uint32_t i;
+    for(i = 0; i < TIMER_MAX; i++) {
+        timers[i] = lv_timer_create(count_cb, 1 + rnd() % 300, (void *)(lv_uintptr_t)i);
+    }
+    timer_cnt = TIMER_MAX;
+
+    uint32_t ms = 3000;
+    uint32_t run_sum = 0;
+    uint64_t t_sum = 0;
+    for(i = 0; i < ms; i++) {
+        lv_tick_inc(1);
+        uint64_t t = now_ns();
+        uint32_t time_till_next = lv_timer_handler();
+        t_sum += now_ns() - t;
+        TEST_ASSERT_EQUAL_UINT32(time_till_next_ref(), time_till_next);
+    }
+
+    for(i = 0; i < TIMER_MAX; i++) {
+        TEST_ASSERT_EQUAL_UINT32(ms / timers[i]->period, run_cnt[i]);
+        run_sum += run_cnt[i];
+    }
+
+    TEST_PRINTF("%u timers, %u runs in %u ms: %u ns per lv_timer_handler() call (%u ns per run)", TIMER_MAX,
+                (unsigned)run_sum, (unsigned)ms, (unsigned)(t_sum / ms), (unsigned)(t_sum / run_sum));
+}
+
+void test_timer_idle_overhead(void)
+{
+    /*Many timers but only a few are ready in a call*/
+    uint32_t i;
+    for(i = 0; i < TIMER_MAX; i++) {
+        timers[i] = lv_timer_create(count_cb, 1000 + i, (void *)(lv_uintptr_t)i);
+    }
+    timer_cnt = TIMER_MAX;
+
+    uint64_t t = now_ns();
+    for(i = 0; i < 1000; i++) lv_timer_handler();
+    t = now_ns() - t;
+
+    TEST_PRINTF("%u waiting timers: %u ns per lv_timer_handler() call", TIMER_MAX, (unsigned)(t / 1000));
+}
+
+void test_timer_zero_period(void)
+{
+    /*Runs once per call even if it's always ready*/
+    timers[0] = lv_timer_create(count_cb, 0, (void *)0);
+    timer_cnt = 1;
+
+    uint32_t i;
+    for(i = 0; i < 10; i++) TEST_ASSERT_EQUAL_UINT32(0, lv_timer_handler());
+    TEST_ASSERT_EQUAL_UINT32(10, run_cnt[0]);
+
+    lv_timer_pause(timers[0]);
+    TEST_ASSERT_NOT_EQUAL(0, lv_timer_handler());
+    TEST_ASSERT_EQUAL_UINT32(10, run_cnt[0]);
+}
+
+void test_timer_repeat_count(void)
+{
+    timers[0] = lv_timer_create(count_cb, 10, (void *)0);
+    lv_timer_set_repeat_count(timers[0], 3);
+    timers[1] = lv_timer_create(count_cb, 1000, (void *)1);
+    timer_cnt = 2;
+
+    uint32_t i;
+    for(i = 0; i < 100; i++) {
+        lv_tick_inc(1);
+        lv_timer_handler();
+    }
+    TEST_ASSERT_EQUAL_UINT32(3, run_cnt[0]);
+    TEST_ASSERT_EQUAL_UINT32(base_timer_cnt + 1, count_timers());
+    lv_timer_t * waiting = timers[1];
+    forget(timers[0]);
+
+    /*Setting 0 repeat count deletes the timer on the next call without running it*/
+    lv_timer_set_repeat_count(waiting, 0);
+    forget(waiting);
+    lv_timer_handler();
+    TEST_ASSERT_EQUAL_UINT32(0, run_cnt[1]);
+    TEST_ASSERT_EQUAL_UINT32(base_timer_cnt, count_timers());
+}
+
+void test_timer_create_and_delete_in_callbacks(void)
+{
+    uint32_t i;
+    for(i = 0; i < 1000; i++) add_chaos_timer();
+
+    for(i = 0; i < 2000; i++) {
+        lv_tick_inc(1 + rnd() % 3);
+        uint32_t time_till_next = lv_timer_handler();
+        TEST_ASSERT_EQUAL_UINT32(time_till_next_ref(), time_till_next);
+        TEST_ASSERT_EQUAL_UINT32(base_timer_cnt + timer_cnt, count_timers());
+        if(timer_cnt < 100) add_chaos_timer();
+    }
+
+    /*Let the remaining one shot timers run, they delete themselves*/
+    uint32_t one_shot_left = 0;
+    for(i = 0; i < timer_cnt;) {
+        lv_timer_t * t = timers[i];
+        lv_timer_resume(t);
+        lv_timer_set_cb(t, NULL);
+        lv_timer_set_period(t, 10);
+        if(t->repeat_count == 1) {
+            one_shot_left++;
+            forget(t);
+        }
+        else {
+            i++;
+        }
+    }
+    lv_tick_inc(10);
+    lv_timer_handler();
+
+    TEST_ASSERT_EQUAL_UINT32(one_shot_created, one_shot_ran + one_shot_left);
+    TEST_ASSERT_EQUAL_UINT32(base_timer_cnt + timer_cnt, count_timers());
+    TEST_PRINTF("%u one shot timers created, %u timers left", (unsigned)one_shot_created, (unsigned)timer_cnt);
+}
+
+#endif
@@ -0,0 +1,247 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+
+/*The durations of the refresh stages are collected into histograms and an event log.
+ *Set the LV_TRACE_JSON environment variable to a file name to save the log of a few frames as a Chrome trace.*/
+
+#if LV_USE_TRACE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    char * buf;
+    uint32_t size;
+    uint32_t len;
+} export_buf_t;
+
+static void export_write_cb(const char * str, uint32_t len, void * user_data)
+{
+    export_buf_t * b = user_data;
+    if(b->len + len >= b->size) return;
+    lv_memcpy(b->buf + b->len, str, len);
+    b->len += len;
+    b->buf[b->len] = '\0';
+}
+
+#if LV_TRACE_EVENT_CNT
+static void file_write_cb(const char * str, uint32_t len, void * user_data)
+{
+    fwrite(str, 1, len, user_data);
+}
+
+static uint32_t count_str(const char * buf, const char * str)
+{
+    uint32_t cnt = 0;
+    const char * p = buf;
+    while((p = strstr(p, str)) != NULL) {
+        cnt++;
+        p += strlen(str);
+    }
+    return cnt;
+}
+#endif
+
+void setUp(void)
+{
+    /*Draw everything which is pending before measuring*/
+    lv_refr_now(NULL);
+    lv_trace_reset();
+}
+
+void tearDown(void)
+{
+    lv_obj_clean(lv_scr_act());
+}
+
+void test_trace_refresh_stages(void)
+{
+    lv_obj_t * btn = lv_btn_create(lv_scr_act());
+    lv_label_set_text(lv_label_create(btn), "Hello");
+
+    uint32_t i;
+    for(i = 0; i < 5; i++) {
+        lv_obj_set_x(btn, i * 10);
+        lv_refr_now(NULL);
+    }
+
+    lv_trace_stats_t s;
+    lv_trace_get_stats(LV_TRACE_STAGE_FRAME, &s);
+    TEST_ASSERT_EQUAL_UINT32(5, s.cnt);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(s.max_us, s.min_us);
+
+    lv_trace_get_stats(LV_TRACE_STAGE_RENDER, &s);
+    TEST_ASSERT_EQUAL_UINT32(5, s.cnt);
+
+    lv_trace_get_stats(LV_TRACE_STAGE_LAYOUT, &s);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(5, s.cnt);
+
+    /*At least one flush per frame*/
+    lv_trace_get_stats(LV_TRACE_STAGE_FLUSH, &s);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(5, s.cnt);
+
+    /*Adding the button and the label refreshed the styles*/
+    lv_trace_get_stats(LV_TRACE_STAGE_STYLE, &s);
+    TEST_ASSERT_NOT_EQUAL(0, s.cnt);
+
+    /*Nothing is drawn so no frame is counted*/
+    lv_trace_get_stats(LV_TRACE_STAGE_FRAME, &s);
+    lv_refr_now(NULL);
+    lv_trace_stats_t s2;
+    lv_trace_get_stats(LV_TRACE_STAGE_FRAME, &s2);
+    TEST_ASSERT_EQUAL_UINT32(s.cnt, s2.cnt);
+}
+
+void test_trace_nesting(void)
+{
+    lv_trace_begin(LV_TRACE_STAGE_USER);
+    lv_trace_begin(LV_TRACE_STAGE_USER);
+    lv_trace_end(LV_TRACE_STAGE_USER);
+
+    lv_trace_stats_t s;
+    lv_trace_get_stats(LV_TRACE_STAGE_USER, &s);
+    TEST_ASSERT_EQUAL_UINT32(0, s.cnt);
+
+    lv_trace_end(LV_TRACE_STAGE_USER);
+    lv_trace_get_stats(LV_TRACE_STAGE_USER, &s);
+    TEST_ASSERT_EQUAL_UINT32(1, s.cnt);
+
+    /*Unbalanced ends are ignored*/
+    lv_trace_end(LV_TRACE_STAGE_USER);
+    lv_trace_get_stats(LV_TRACE_STAGE_USER, &s);
+    TEST_ASSERT_EQUAL_UINT32(1, s.cnt);
+
+    lv_trace_begin(LV_TRACE_STAGE_USER);
+    lv_trace_cancel(LV_TRACE_STAGE_USER);
+    lv_trace_end(LV_TRACE_STAGE_USER);
+    lv_trace_get_stats(LV_TRACE_STAGE_USER, &s);
+    TEST_ASSERT_EQUAL_UINT32(1, s.cnt);
+}
+
+void test_trace_percentile(void)
+{
+    lv_trace_stats_t s;
+    lv_memset_00(&s, sizeof(s));
+
+    /*90 short and 10 long durations*/
+    s.cnt = 100;
+    s.min_us = 100;
+    s.max_us = 5000;
+    s.hist[6] = 90;     /*64..127 us*/
+    s.hist[12] = 10;    /*4096..8191 us*/
+
+    TEST_ASSERT_EQUAL_UINT32(127, lv_trace_stats_get_percentile(&s, 50));
+    TEST_ASSERT_EQUAL_UINT32(127, lv_trace_stats_get_percentile(&s, 90));
+    TEST_ASSERT_EQUAL_UINT32(5000, lv_trace_stats_get_percentile(&s, 91));
+    TEST_ASSERT_EQUAL_UINT32(5000, lv_trace_stats_get_percentile(&s, 100));
+
+    s.cnt = 0;
+    TEST_ASSERT_EQUAL_UINT32(0, lv_trace_stats_get_percentile(&s, 50));
+}
+
+void test_trace_dump(void)
+{
+    char buf[512];
+    TEST_ASSERT_EQUAL_UINT32(0, lv_trace_dump(buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_STRING("", buf);
+
+    lv_obj_t * obj = lv_obj_create(lv_scr_act());
+    lv_obj_invalidate(obj);
+    lv_refr_now(NULL);
+
+    uint32_t len = lv_trace_dump(buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_UINT32(strlen(buf), len);
+    TEST_ASSERT_NOT_NULL(strstr(buf, "frame: 1 x, avg "));
+    TEST_ASSERT_NOT_NULL(strstr(buf, "render: 1 x"));
+    TEST_ASSERT_NOT_NULL(strstr(buf, "p99 "));
+    TEST_ASSERT_NULL(strstr(buf, "user:"));
+
+    /*Cut to the buffer*/
+    char small[20];
+    len = lv_trace_dump(small, sizeof(small));
+    TEST_ASSERT_EQUAL_UINT32(sizeof(small) - 1, len);
+    TEST_ASSERT_EQUAL_UINT32(sizeof(small) - 1, strlen(small));
+}
+
+void test_trace_export_chrome(void)
+{
+    static char json[64 * 1024];
+    export_buf_t b = {json, sizeof(json), 0};
+
+    TEST_ASSERT_EQUAL_UINT32(0, lv_trace_export_chrome(export_write_cb, &b));
+    TEST_ASSERT_EQUAL_STRING("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n]}\n", json);
+
+#if LV_TRACE_EVENT_CNT
+    lv_obj_t * obj = lv_obj_create(lv_scr_act());
+    uint32_t i;
+    for(i = 0; i < 3; i++) {
+        lv_obj_set_y(obj, i * 20);
+        lv_refr_now(NULL);
+    }
+
+    b.len = 0;
+    uint32_t cnt = lv_trace_export_chrome(export_write_cb, &b);
+    TEST_ASSERT_NOT_EQUAL(0, cnt);
+    TEST_ASSERT_EQUAL_UINT32(cnt, count_str(json, "\"ph\":\"X\""));
+    TEST_ASSERT_EQUAL_UINT32(3, count_str(json, "\"name\":\"frame\""));
+    TEST_ASSERT_EQUAL_UINT32(cnt - 1, count_str(json, "},\n{"));
+    TEST_ASSERT_EQUAL_STRING("\n]}\n", json + b.len - 4);
+
+    /*The timestamps are relative to the earliest event*/
+    TEST_ASSERT_NOT_NULL(strstr(json, "\"ts\":0,"));
+
+    /*Only the last events are kept*/
+    for(i = 0; i < LV_TRACE_EVENT_CNT; i++) {
+        lv_obj_set_y(obj, (i % 2) * 20);
+        lv_refr_now(NULL);
+    }
+    b.len = 0;
+    TEST_ASSERT_EQUAL_UINT32(LV_TRACE_EVENT_CNT, lv_trace_export_chrome(export_write_cb, &b));
+
+    const char * fn = getenv("LV_TRACE_JSON");
+    if(fn) {
+        FILE * f = fopen(fn, "w");
+        TEST_ASSERT_NOT_NULL(f);
+        cnt = lv_trace_export_chrome(file_write_cb, f);
+        fclose(f);
+        TEST_PRINTF("%u events saved to %s", (unsigned)cnt, fn);
+    }
+#endif
+}
+
+#else
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_trace_refresh_stages(void)
+{
+}
+
+void test_trace_nesting(void)
+{
+}
+
+void test_trace_percentile(void)
+{
+}
+
+void test_trace_dump(void)
+{
+}
+
+void test_trace_export_chrome(void)
+{
+}
+
+#endif
+
+#endif
@@ -1,193 +1,325 @@
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
 #include <esp_log.h>
 #include <esp_http_client.h>
-#include <esp_tls.h>
+#include <esp_heap_caps.h>
 #include <freertos/FreeRTOS.h>
-#include <freertos/timers.h>
+#include <freertos/task.h>
 #include "camera_client.h"
+#include "camera_stream.h"
 #include "lcd.h"
 #include "sdkconfig.h"
 #include "lvgl.h"
 #include "esp_lvgl_port.h"
-#include "wifi.h"
-#include <jpeg_decoder.h>  // Keep for old API
 
 static const char *TAG = "CAMERA_CLIENT";
 
-static uint8_t *image_buffer = NULL;
-#define IMAGE_BUFFER_SIZE (100 * 1024)
+#define CAMERA_WIDTH 320
+#define CAMERA_HEIGHT 240
+#define DECODED_IMAGE_SIZE (CAMERA_WIDTH * CAMERA_HEIGHT * 2)  // 153,600 bytes
+#define CHUNK_BUFFER_SIZE 4096
+#define HTTP_TIMEOUT_MS 10000
+#define RECONNECT_DELAY_MS 1000
+#define LVGL_LOCK_TIMEOUT_MS 100
+#define STATS_LOG_PERIOD_MS 10000
 
-// Dynamically allocated buffer for decoded RGB565 image (320x240) in PSRAM
-static uint16_t *decoded_image = NULL;
-#define DECODED_IMAGE_SIZE (320 * 240 * 2)  // 153,600 bytes
+#define CAMERA_TASK_STACK_SIZE 6144
+#define CAMERA_TASK_PRIORITY 2
 
-// Placeholder: Removed JPEG data, will fill buffer directly
+// Notifications of the camera task
+#define CAMERA_EVENT_START (1 << 0)
+#define CAMERA_EVENT_STOP (1 << 1)
+#define CAMERA_EVENT_FETCH (1 << 2)
 
 extern lv_obj_t *camera_img_widget;
-static lv_img_dsc_t camera_img_dsc;  // Descriptor for decoded image data
-
-esp_err_t http_event_handler(esp_http_client_event_t *evt) {
-    static int output_len;
-    switch(evt->event_id) {
-        case HTTP_EVENT_ON_CONNECTED:
-            ESP_LOGD(TAG, "HTTP_EVENT_ON_CONNECTED");
-            output_len = 0;
-            break;
-        case HTTP_EVENT_ON_DATA:
-            if (evt->data_len > 0 && image_buffer != NULL) {
-                if (output_len + evt->data_len < IMAGE_BUFFER_SIZE) {
-                    memcpy(image_buffer + output_len, evt->data, evt->data_len);
-                    output_len += evt->data_len;
-                } else {
-                    ESP_LOGW(TAG, "Image buffer overflow");
-                }
+
+// Two RGB565 buffers in PSRAM: one is shown while the next frame is decoded into the other one
+static uint16_t *decoded_image[2];
+static lv_img_dsc_t camera_img_dsc[2];  // One descriptor per buffer, the image cache keys on it
+
+static camera_stream_t stream;
+static TaskHandle_t camera_task_handle = NULL;
+// The last shown frame isn't drawn yet. Frames arriving meanwhile are skipped without decoding.
+static volatile bool frame_pending = false;
+
+static esp_http_client_handle_t client = NULL;
+static const char *client_url = NULL;
+static bool body_open = false;
+static char boundary[MJPEG_PARSER_BOUNDARY_MAX + 1];
+
+static esp_err_t http_event_handler(esp_http_client_event_t *evt)
+{
+    // Pick the multipart boundary from the response headers
+    if (evt->event_id == HTTP_EVENT_ON_HEADER && strcasecmp(evt->header_key, "Content-Type") == 0) {
+        const char *p = strstr(evt->header_value, "boundary=");
+        if (p != NULL) {
+            p += strlen("boundary=");
+            if (*p == '"') {
+                p++;
             }
-            break;
-        case HTTP_EVENT_ON_FINISH:
-            ESP_LOGD(TAG, "HTTP_EVENT_ON_FINISH, received %d bytes", output_len);
-            if (output_len > 0) {
-                // Log the response details
-                ESP_LOGI(TAG, "JPEG response: %d bytes received", output_len);
-                if (output_len >= 10) {
-                    ESP_LOGI(TAG, "First 10 bytes: %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x",
-                             image_buffer[0], image_buffer[1], image_buffer[2], image_buffer[3],
-                             image_buffer[4], image_buffer[5], image_buffer[6], image_buffer[7],
-                             image_buffer[8], image_buffer[9]);
-                }
-                // Check for JPEG signature
-                if (output_len >= 2 && image_buffer[0] == 0xFF && image_buffer[1] == 0xD8) {
-                    ESP_LOGI(TAG, "Response appears to be JPEG");
-                } else {
-                    ESP_LOGW(TAG, "Response does not appear to be JPEG");
-                }
-                
-
-                // Decode JPEG to RGB565 using old API
-                esp_jpeg_image_cfg_t jpeg_cfg = {
-                    .indata = image_buffer,
-                    .indata_size = output_len,
-                    .outbuf = (uint8_t *)decoded_image,
-                    .outbuf_size = DECODED_IMAGE_SIZE,
-                    .out_format = JPEG_IMAGE_FORMAT_RGB565,
-                    .out_scale = JPEG_IMAGE_SCALE_0,
-                    .flags = {
-                        .swap_color_bytes = 0,  // Changed from 1 to 0 to fix potential color byte order issues
-                    }
-                };
-                esp_jpeg_image_output_t outimg;
-                esp_err_t ret = esp_jpeg_decode(&jpeg_cfg, &outimg);
-                if (ret == ESP_OK) {
-                    ESP_LOGI(TAG, "JPEG decoded successfully: %ux%u", outimg.width, outimg.height);
-                    // Configure lv_img_dsc_t for the decoded image
-                    camera_img_dsc.header.always_zero = 0;
-                    camera_img_dsc.header.w = outimg.width;
-                    camera_img_dsc.header.h = outimg.height;
-                    camera_img_dsc.data_size = outimg.width * outimg.height * 2;
-                    camera_img_dsc.header.cf = LV_IMG_CF_TRUE_COLOR;  // RGB565
-                    camera_img_dsc.data = (const uint8_t *)decoded_image;
-                    
-                    lvgl_port_lock(0);
-                    lv_img_set_src(camera_img_widget, &camera_img_dsc);
-                    lv_obj_invalidate(camera_img_widget);
-                    lvgl_port_unlock();
-                } else {
-                    ESP_LOGE(TAG, "JPEG decode failed: %s", esp_err_to_name(ret));
-                }
+            size_t len = strcspn(p, "\";\r\n ");
+            // Some cameras put the leading "--" into the parameter too
+            if (len > 2 && p[0] == '-' && p[1] == '-') {
+                p += 2;
+                len -= 2;
             }
-            output_len = 0;
-            break;
-        case HTTP_EVENT_ERROR:
-            ESP_LOGE(TAG, "HTTP_EVENT_ERROR");
-            break;
-        default:
-            break;
+            if (len > MJPEG_PARSER_BOUNDARY_MAX) {
+                len = MJPEG_PARSER_BOUNDARY_MAX;
+            }
+            memcpy(boundary, p, len);
+            boundary[len] = '\0';
+        }
     }
     return ESP_OK;
 }
 
-static TimerHandle_t stream_timer = NULL;
-static bool is_streaming = false;
+static int http_read(void *ctx, uint8_t *buf, size_t len)
+{
+    return esp_http_client_read(client, (char *)buf, len);
+}
+
+static void http_close(void)
+{
+    if (client != NULL) {
+        esp_http_client_close(client);
+    }
+    body_open = false;
+}
+
+// Send a request on the kept alive connection (reconnecting if the camera closed it)
+static bool http_open(const char *url)
+{
+    if (client == NULL) {
+        esp_http_client_config_t config = {
+            .url = url,
+            .event_handler = http_event_handler,
+            .timeout_ms = HTTP_TIMEOUT_MS,
+            .keep_alive_enable = true,
+        };
+        client = esp_http_client_init(&config);
+        if (client == NULL) {
+            ESP_LOGE(TAG, "Failed to create HTTP client");
+            return false;
+        }
+        client_url = url;
+    } else if (client_url != url) {
+        esp_http_client_set_url(client, url);
+        client_url = url;
+    }
+
+    // The first attempt reuses the connection, if it was closed meanwhile try a new one
+    for (int attempt = 0; attempt < 2; attempt++) {
+        boundary[0] = '\0';
+        esp_err_t err = esp_http_client_open(client, 0);
+        if (err == ESP_OK && esp_http_client_fetch_headers(client) >= -1) {
+            int status = esp_http_client_get_status_code(client);
+            if (status == 200) {
+                break;
+            }
+            ESP_LOGE(TAG, "HTTP status %d", status);
+            http_close();
+            return false;
+        }
+        http_close();
+        if (attempt == 1) {
+            ESP_LOGE(TAG, "HTTP request failed: %s", esp_err_to_name(err));
+            return false;
+        }
+    }
+
+    camera_stream_reset(&stream, boundary[0] ? boundary : NULL);
+    body_open = true;
+    return true;
+}
+
+static void camera_show_frame(void)
+{
+    uint16_t w, h;
+    const uint16_t *data = camera_stream_get_frame(&stream, &w, &h);
+    lv_img_dsc_t *dsc = &camera_img_dsc[data == decoded_image[0] ? 0 : 1];
+    dsc->header.w = w;
+    dsc->header.h = h;
+    dsc->data_size = w * h * 2;
+
+    if (!lvgl_port_lock(LVGL_LOCK_TIMEOUT_MS)) {
+        // Keep the buffer as back buffer, the next frame overwrites it
+        return;
+    }
+    lv_img_set_src(camera_img_widget, dsc);
+    frame_pending = true;
+    lvgl_port_unlock();
+
+    // LVGL reads only the new buffer from now, the other one is free for decoding
+    camera_stream_swap(&stream);
+}
+
+static void camera_img_draw_cb(lv_event_t *e)
+{
+    frame_pending = false;
+}
+
+static bool camera_is_multipart(void)
+{
+    return CONFIG_CAMERA_STREAM_URL[0] != '\0';
+}
+
+// Receive one frame. Returns how long to wait before the next one.
+static TickType_t camera_receive_frame(bool streaming)
+{
+    bool multipart = streaming && camera_is_multipart();
+    TickType_t start = xTaskGetTickCount();
+
+    if (!body_open && !http_open(multipart ? CONFIG_CAMERA_STREAM_URL : CONFIG_CAMERA_SNAPSHOT_URL)) {
+        return pdMS_TO_TICKS(RECONNECT_DELAY_MS);
+    }
+
+    switch (camera_stream_next(&stream, frame_pending)) {
+    case CAMERA_STREAM_FRAME:
+        camera_show_frame();
+        break;
+    case CAMERA_STREAM_DROPPED:
+        break;
+    case CAMERA_STREAM_EOF:
+        body_open = false;
+        if (multipart) {
+            ESP_LOGW(TAG, "Camera closed the stream");
+            http_close();
+            return pdMS_TO_TICKS(RECONNECT_DELAY_MS);
+        }
+        return 0;
+    case CAMERA_STREAM_ERROR:
+        ESP_LOGE(TAG, "Camera connection failed");
+        http_close();
+        return pdMS_TO_TICKS(RECONNECT_DELAY_MS);
+    }
+
+    if (multipart) {
+        return 0;
+    }
+
+    // A snapshot is one frame: finish the response, the connection stays open for the next one
+    esp_http_client_flush_response(client, NULL);
+    body_open = false;
+    TickType_t elapsed = xTaskGetTickCount() - start;
+    TickType_t period = pdMS_TO_TICKS(CONFIG_CAMERA_STREAM_PERIOD_MS);
+    return elapsed < period ? period - elapsed : 0;
+}
+
+static void camera_task(void *arg)
+{
+    bool streaming = false;
+    TickType_t wait = portMAX_DELAY;
+    TickType_t last_stats = xTaskGetTickCount();
 
-// Timer callback to fetch a frame
-static void stream_timer_callback(TimerHandle_t xTimer) {
-    camera_client_fetch_image();
+    while (true) {
+        uint32_t events = 0;
+        xTaskNotifyWait(0, UINT32_MAX, &events, wait);
+
+        if (events & CAMERA_EVENT_STOP) {
+            streaming = false;
+            http_close();
+        }
+        if (events & CAMERA_EVENT_START) {
+            streaming = true;
+        }
+
+        if (streaming || (events & CAMERA_EVENT_FETCH)) {
+            wait = camera_receive_frame(streaming);
+        }
+        if (!streaming) {
+            wait = portMAX_DELAY;
+        }
+
+        if (streaming && xTaskGetTickCount() - last_stats >= pdMS_TO_TICKS(STATS_LOG_PERIOD_MS)) {
+            const camera_stream_stats_t *stats = camera_stream_get_stats(&stream);
+            ESP_LOGI(TAG, "%.1f fps, decode %lu us (max %lu us), %lu frames, %lu dropped",
+                     stats->fps, (unsigned long)stats->decode_us_avg, (unsigned long)stats->decode_us_max,
+                     (unsigned long)stats->frames, (unsigned long)stats->dropped);
+            last_stats = xTaskGetTickCount();
+        }
+    }
+}
+
+static void *camera_alloc(size_t size, uint32_t caps)
+{
+    void *p = heap_caps_malloc(size, caps);
+    if (p == NULL) {
+        ESP_LOGW(TAG, "Failed to allocate %u bytes with caps 0x%lx. Trying internal RAM.",
+                 (unsigned)size, (unsigned long)caps);
+        p = malloc(size);
+    }
+    return p;
 }
 
-void camera_client_start_stream(void) {
-    if (is_streaming) return;
-    is_streaming = true;
+void camera_client_start_stream(void)
+{
     ESP_LOGI(TAG, "Starting camera stream");
-    // Create a timer to fetch every 200ms (5 FPS; adjust as needed)
-    stream_timer = xTimerCreate("stream_timer", pdMS_TO_TICKS(200), pdTRUE, NULL, stream_timer_callback);
-    if (stream_timer != NULL) {
-        xTimerStart(stream_timer, 0);
-    } else {
-        ESP_LOGE(TAG, "Failed to create stream timer");
+    if (camera_task_handle != NULL) {
+        xTaskNotify(camera_task_handle, CAMERA_EVENT_START, eSetBits);
     }
 }
 
-void camera_client_stop_stream(void) {
-    if (!is_streaming) return;
-    is_streaming = false;
+void camera_client_stop_stream(void)
+{
     ESP_LOGI(TAG, "Stopping camera stream");
-    if (stream_timer != NULL) {
-        xTimerStop(stream_timer, 0);
-        xTimerDelete(stream_timer, 0);
-        stream_timer = NULL;
+    if (camera_task_handle != NULL) {
+        xTaskNotify(camera_task_handle, CAMERA_EVENT_STOP, eSetBits);
     }
 }
 
-void camera_client_start(void) {
-    image_buffer = (uint8_t *)heap_caps_malloc(IMAGE_BUFFER_SIZE, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
-    if (image_buffer == NULL) {
-        ESP_LOGE(TAG, "Failed to allocate image buffer in PSRAM. Trying internal RAM.");
-        image_buffer = (uint8_t *)malloc(IMAGE_BUFFER_SIZE);
+void camera_client_fetch_image(void)
+{
+    if (camera_task_handle != NULL) {
+        xTaskNotify(camera_task_handle, CAMERA_EVENT_FETCH, eSetBits);
     }
-    if (image_buffer == NULL) {
-        ESP_LOGE(TAG, "Failed to allocate image buffer.");
-        return;
-    }
-    
-    // Allocate decoded_image in PSRAM
-    decoded_image = (uint16_t *)heap_caps_malloc(DECODED_IMAGE_SIZE, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
-    if (decoded_image == NULL) {
-        ESP_LOGE(TAG, "Failed to allocate decoded image buffer in PSRAM. Trying internal RAM.");
-        decoded_image = (uint16_t *)malloc(DECODED_IMAGE_SIZE);
+}
+
+void camera_client_get_stats(camera_stream_stats_t *stats)
+{
+    *stats = *camera_stream_get_stats(&stream);
+}
+
+void camera_client_start(void)
+{
+    camera_stream_config_t cfg = {
+        .read = http_read,
+        .chunk_buf = camera_alloc(CHUNK_BUFFER_SIZE, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT),
+        .chunk_size = CHUNK_BUFFER_SIZE,
+        .work_buf = camera_alloc(CAMERA_STREAM_WORK_SIZE, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT),
+        .frame_buf_size = DECODED_IMAGE_SIZE,
+    };
+    for (int i = 0; i < 2; i++) {
+        decoded_image[i] = camera_alloc(DECODED_IMAGE_SIZE, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        cfg.frame_buf[i] = decoded_image[i];
+
+        camera_img_dsc[i].header.always_zero = 0;
+        camera_img_dsc[i].header.cf = LV_IMG_CF_TRUE_COLOR;  // RGB565
+        camera_img_dsc[i].data = (const uint8_t *)decoded_image[i];
     }
-    if (decoded_image == NULL) {
-        ESP_LOGE(TAG, "Failed to allocate decoded image buffer.");
+    if (!cfg.chunk_buf || !cfg.work_buf || !decoded_image[0] || !decoded_image[1]) {
+        ESP_LOGE(TAG, "Failed to allocate camera buffers.");
         return;
     }
-    
-    // Create a 320x240 red placeholder by filling the buffer
+    camera_stream_init(&stream, &cfg);
+
+    // Create a 320x240 red placeholder in the buffer shown at start
     uint16_t red_color = 0xF800;  // RGB565 red
-    for (int i = 0; i < 320 * 240; i++) {
-        decoded_image[i] = red_color;
-    }
-    
-    // Configure lv_img_dsc_t for the placeholder
-    camera_img_dsc.header.always_zero = 0;
-    camera_img_dsc.header.w = 320;
-    camera_img_dsc.header.h = 240;
-    camera_img_dsc.data_size = 320 * 240 * 2;
-    camera_img_dsc.header.cf = LV_IMG_CF_TRUE_COLOR;  // RGB565
-    camera_img_dsc.data = (const uint8_t *)decoded_image;
-    
+    for (int i = 0; i < CAMERA_WIDTH * CAMERA_HEIGHT; i++) {
+        decoded_image[0][i] = red_color;
+    }
+    camera_img_dsc[0].header.w = CAMERA_WIDTH;
+    camera_img_dsc[0].header.h = CAMERA_HEIGHT;
+    camera_img_dsc[0].data_size = DECODED_IMAGE_SIZE;
+
     lvgl_port_lock(0);
-    lv_img_set_src(camera_img_widget, &camera_img_dsc);
-    lv_obj_invalidate(camera_img_widget);
+    lv_img_set_src(camera_img_widget, &camera_img_dsc[0]);
+    lv_obj_add_event_cb(camera_img_widget, camera_img_draw_cb, LV_EVENT_DRAW_MAIN_END, NULL);
     lvgl_port_unlock();
-}
 
-void camera_client_fetch_image(void) {
-    esp_http_client_config_t config = {
-        .url = CONFIG_CAMERA_SNAPSHOT_URL,
-        .event_handler = http_event_handler,
-        .timeout_ms = 10000,
-    };
-    esp_http_client_handle_t client = esp_http_client_init(&config);
-    esp_err_t err = esp_http_client_perform(client);
-    if (err != ESP_OK) {
-        ESP_LOGE(TAG, "HTTP request failed: %s", esp_err_to_name(err));
+    if (xTaskCreate(camera_task, "camera", CAMERA_TASK_STACK_SIZE, NULL, CAMERA_TASK_PRIORITY,
+                    &camera_task_handle) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create camera task");
+        camera_task_handle = NULL;
     }
-    esp_http_client_cleanup(client);
-}
\ No newline at end of file
+}
@@ -1,7 +1,11 @@
 #ifndef CAMERA_CLIENT_H
 #define CAMERA_CLIENT_H
+#include "camera_stream.h"
 
 void camera_client_start(void);
-void camera_client_fetch_image(void);  // New function for on-demand fetch
+void camera_client_fetch_image(void);  // Fetch one snapshot in the camera task
+void camera_client_start_stream(void);
+void camera_client_stop_stream(void);
+void camera_client_get_stats(camera_stream_stats_t *stats);
 
-#endif // CAMERA_CLIENT_H
\ No newline at end of file
+#endif // CAMERA_CLIENT_H
@@ -0,0 +1,231 @@
+#include "camera_stream.h"
+#include <string.h>
+#include "sdkconfig.h"
+
+#if CONFIG_JD_USE_ROM
+#include "rom/tjpgd.h"
+// The ROM code of TJPGD is older and has different types in the callbacks
+typedef unsigned int jd_size_t;
+typedef unsigned int jd_out_t;
+#else
+#include "tjpgd.h"
+typedef size_t jd_size_t;
+typedef int jd_out_t;
+#endif
+
+// The ROM decoder outputs RGB888
+#ifndef JD_FORMAT
+#define JD_FORMAT 0
+#endif
+
+#ifdef ESP_PLATFORM
+#include "esp_timer.h"
+#define stream_now_us() esp_timer_get_time()
+#else
+#include <time.h>
+static int64_t stream_now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+#endif
+
+#define STATS_PERIOD_US 1000000
+
+void camera_stream_init(camera_stream_t *stream, const camera_stream_config_t *cfg)
+{
+    memset(stream, 0, sizeof(*stream));
+    stream->cfg = *cfg;
+    stream->back = 1;
+    stream->period_start_us = stream_now_us();
+    camera_stream_reset(stream, NULL);
+}
+
+void camera_stream_reset(camera_stream_t *stream, const char *boundary)
+{
+    mjpeg_parser_init(&stream->parser, boundary);
+    stream->chunk_len = 0;
+    stream->chunk_pos = 0;
+    stream->slice_len = 0;
+    stream->frame_end = true;
+}
+
+// Get the next frame bytes (or the frame end) from the parser, reading the stream as needed
+static bool stream_parse(camera_stream_t *stream)
+{
+    while (true) {
+        // Parse before reading: a frame end is reported after the last data, without new bytes
+        size_t used;
+        const uint8_t *out;
+        size_t out_len;
+        mjpeg_parser_res_t res = mjpeg_parser_parse(&stream->parser, stream->cfg.chunk_buf + stream->chunk_pos,
+                                                    stream->chunk_len - stream->chunk_pos, &used, &out, &out_len);
+        stream->chunk_pos += used;
+        if (res == MJPEG_PARSER_FRAME_DATA) {
+            stream->slice = out;
+            stream->slice_len = out_len;
+            return true;
+        }
+        if (res == MJPEG_PARSER_FRAME_END) {
+            stream->frame_end = true;
+            return true;
+        }
+
+        int64_t start = stream_now_us();
+        int n = stream->cfg.read(stream->cfg.read_ctx, stream->cfg.chunk_buf, stream->cfg.chunk_size);
+        stream->read_us += stream_now_us() - start;
+        if (n <= 0) {
+            stream->io_res = (n == 0) ? CAMERA_STREAM_EOF : CAMERA_STREAM_ERROR;
+            return false;
+        }
+        stream->chunk_len = n;
+        stream->chunk_pos = 0;
+    }
+}
+
+// Copy (or skip if `buf` is NULL) up to `len` bytes of the current frame
+static size_t stream_pull(camera_stream_t *stream, uint8_t *buf, size_t len)
+{
+    size_t done = 0;
+    while (done < len) {
+        if (stream->slice_len == 0) {
+            if (stream->frame_end || !stream_parse(stream)) {
+                break;
+            }
+            continue;
+        }
+        size_t n = len - done;
+        if (n > stream->slice_len) {
+            n = stream->slice_len;
+        }
+        if (buf) {
+            memcpy(buf + done, stream->slice, n);
+        }
+        stream->slice += n;
+        stream->slice_len -= n;
+        done += n;
+    }
+    return done;
+}
+
+static jd_size_t stream_jd_in(JDEC *jd, uint8_t *buf, jd_size_t len)
+{
+    return stream_pull((camera_stream_t *)jd->device, buf, len);
+}
+
+static jd_out_t stream_jd_out(JDEC *jd, void *bitmap, JRECT *rect)
+{
+    camera_stream_t *stream = (camera_stream_t *)jd->device;
+    uint16_t *dst = stream->cfg.frame_buf[stream->back] + rect->top * jd->width + rect->left;
+    uint32_t w = rect->right - rect->left + 1;
+
+    for (int y = rect->top; y <= rect->bottom; y++) {
+#if JD_FORMAT == 1
+        const uint16_t *src = (const uint16_t *)bitmap + (y - rect->top) * w;
+        memcpy(dst, src, w * sizeof(uint16_t));
+#else
+        const uint8_t *src = (const uint8_t *)bitmap + (y - rect->top) * w * 3;
+        for (uint32_t x = 0; x < w; x++) {
+            dst[x] = ((src[0] & 0xF8) << 8) | ((src[1] & 0xFC) << 3) | (src[2] >> 3);
+            src += 3;
+        }
+#endif
+        dst += jd->width;
+    }
+    return 1;
+}
+
+static bool stream_decode(camera_stream_t *stream)
+{
+    JDEC jd;
+    if (jd_prepare(&jd, stream_jd_in, stream->cfg.work_buf, CAMERA_STREAM_WORK_SIZE, stream) != JDR_OK) {
+        return false;
+    }
+    if ((size_t)jd.width * jd.height * sizeof(uint16_t) > stream->cfg.frame_buf_size) {
+        return false;
+    }
+    if (jd_decomp(&jd, stream_jd_out, 0) != JDR_OK) {
+        return false;
+    }
+    stream->width = jd.width;
+    stream->height = jd.height;
+    return true;
+}
+
+static void stream_update_stats(camera_stream_t *stream, int64_t now)
+{
+    camera_stream_stats_t *stats = &stream->stats;
+    int64_t elapsed = now - stream->period_start_us;
+    if (elapsed < STATS_PERIOD_US) {
+        return;
+    }
+    stats->fps = stream->period_frames * 1000000.0f / elapsed;
+    stats->decode_us_avg = stream->period_frames ? stream->period_decode_us / stream->period_frames : 0;
+    stream->period_start_us = now;
+    stream->period_frames = 0;
+    stream->period_decode_us = 0;
+}
+
+camera_stream_res_t camera_stream_next(camera_stream_t *stream, bool skip)
+{
+    // Wait for the first bytes of the frame, the time before it isn't decode time
+    stream->frame_end = false;
+    while (stream->slice_len == 0) {
+        if (!stream_parse(stream)) {
+            return stream->io_res;
+        }
+        if (stream->frame_end) {
+            // Empty part
+            stream->stats.dropped++;
+            return CAMERA_STREAM_DROPPED;
+        }
+    }
+
+    int64_t start = stream_now_us();
+    stream->read_us = 0;
+    bool decoded = !skip && stream_decode(stream);
+
+    // The decoder stops after the last MCU (or at an error), read the rest of the frame
+    while (stream_pull(stream, NULL, SIZE_MAX) > 0) {
+    }
+    int64_t now = stream_now_us();
+
+    if (!stream->frame_end) {
+        // The body ended within the frame
+        stream->stats.dropped++;
+        return stream->io_res;
+    }
+    if (!decoded) {
+        stream->stats.dropped++;
+        stream_update_stats(stream, now);
+        return CAMERA_STREAM_DROPPED;
+    }
+
+    uint32_t decode_us = now - start - stream->read_us;
+    stream->stats.frames++;
+    if (decode_us > stream->stats.decode_us_max) {
+        stream->stats.decode_us_max = decode_us;
+    }
+    stream->period_frames++;
+    stream->period_decode_us += decode_us;
+    stream_update_stats(stream, now);
+    return CAMERA_STREAM_FRAME;
+}
+
+const uint16_t *camera_stream_get_frame(const camera_stream_t *stream, uint16_t *width, uint16_t *height)
+{
+    *width = stream->width;
+    *height = stream->height;
+    return stream->cfg.frame_buf[stream->back];
+}
+
+void camera_stream_swap(camera_stream_t *stream)
+{
+    stream->back ^= 1;
+}
+
+const camera_stream_stats_t *camera_stream_get_stats(const camera_stream_t *stream)
+{
+    return &stream->stats;
+}
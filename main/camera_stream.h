@@ -0,0 +1,82 @@
+#ifndef CAMERA_STREAM_H
+#define CAMERA_STREAM_H
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "mjpeg_parser.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CAMERA_STREAM_WORK_SIZE 3100  // tjpgd work buffer, independent of the image size
+
+// Read the next bytes of the stream: returns the number of bytes, 0 at the end of the body, <0 on error
+typedef int (*camera_stream_read_cb_t)(void *ctx, uint8_t *buf, size_t len);
+
+typedef enum {
+    CAMERA_STREAM_FRAME,    // A frame is decoded into the back buffer
+    CAMERA_STREAM_DROPPED,  // A frame was skipped or couldn't be decoded
+    CAMERA_STREAM_EOF,      // The body ended
+    CAMERA_STREAM_ERROR,    // Read error
+} camera_stream_res_t;
+
+typedef struct {
+    camera_stream_read_cb_t read;
+    void *read_ctx;
+    uint8_t *chunk_buf;         // Socket reads, the JPEG is never stored as a whole
+    size_t chunk_size;
+    void *work_buf;             // CAMERA_STREAM_WORK_SIZE bytes
+    uint16_t *frame_buf[2];     // RGB565 buffers, frame_buf[0] is the shown one at start
+    size_t frame_buf_size;      // Size of one buffer in bytes
+} camera_stream_config_t;
+
+typedef struct {
+    uint32_t frames;            // Decoded frames
+    uint32_t dropped;           // Skipped, truncated and undecodable frames
+    float fps;                  // Decoded frames per second in the last stats period
+    uint32_t decode_us_avg;     // Average decode time in the last stats period, without the network waits
+    uint32_t decode_us_max;
+} camera_stream_stats_t;
+
+typedef struct {
+    camera_stream_config_t cfg;
+    mjpeg_parser_t parser;
+    size_t chunk_len;
+    size_t chunk_pos;
+    const uint8_t *slice;       // Frame bytes returned by the parser, not passed to the decoder yet
+    size_t slice_len;
+    bool frame_end;
+    camera_stream_res_t io_res;
+    uint8_t back;
+    uint16_t width;
+    uint16_t height;
+    int64_t read_us;            // Time spent waiting in read() during the current frame
+    int64_t period_start_us;
+    uint32_t period_frames;
+    uint64_t period_decode_us;
+    camera_stream_stats_t stats;
+} camera_stream_t;
+
+// Streams JPEG frames from `read` and decodes them while the bytes arrive into the back buffer
+void camera_stream_init(camera_stream_t *stream, const camera_stream_config_t *cfg);
+
+// Start a new body (connection or response). `boundary`: see mjpeg_parser_init()
+void camera_stream_reset(camera_stream_t *stream, const char *boundary);
+
+// Receive the next frame. With `skip` its bytes are only read, e.g. while the previous frame isn't drawn yet.
+camera_stream_res_t camera_stream_next(camera_stream_t *stream, bool skip);
+
+// Back buffer holding the last CAMERA_STREAM_FRAME
+const uint16_t *camera_stream_get_frame(const camera_stream_t *stream, uint16_t *width, uint16_t *height);
+
+// The back buffer is shown now: decode the next frames into the other one
+void camera_stream_swap(camera_stream_t *stream);
+
+const camera_stream_stats_t *camera_stream_get_stats(const camera_stream_t *stream);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CAMERA_STREAM_H
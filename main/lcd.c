@@ -5,13 +5,14 @@
 #include "esp_lcd_panel_rgb.h"
 #include <string.h>
 #include "mqtt.h"
+#include "log_view.h"
+#include "ui_queue.h"
 
-static lv_obj_t *motion_event_textarea;
+static lv_obj_t *motion_event_log;
 lv_obj_t *camera_img_widget; // New camera image widget
 static lv_img_dsc_t camera_img_dsc; // New image descriptor
 
-#define LCD_MAX_LINES 100  // Increased from 50 to 100 to keep more history in the scrolling text area
-#define LCD_MAX_TEXTAREA_BUF 2048
+#define LCD_MAX_LINES 100  // Increased from 50 to 100 to keep more history in the scrolling log
 
 // UI object pointers (static globals)
 static lv_obj_t *title_bar = NULL;
@@ -29,6 +30,10 @@ static lv_obj_t *vacuum_pump_switch_label = NULL;
 static lv_obj_t *fetch_image_button = NULL; // Button to fetch camera image
 static lv_obj_t *stream_btn;  // Add this global or in a struct
 
+// Updates from the MQTT task, applied by the LVGL task
+static ui_queue_t ui_queue;
+static void ui_queue_timer_cb(lv_timer_t *timer);
+
 // Forward declarations for callback handlers
 void water_valve_state_cb(int relay_index, bool state);
 void central_vacuum_state_cb(int relay_index, bool state);
@@ -114,19 +119,19 @@ void lcd_create_ui(void)
     lv_color_t inactive = lv_color_hex(0xB0BEC5); // Blue Gray 200
     lv_color_t label_color = lv_color_hex(0x263238); // Blue Gray 900
 
-    // Motion event text area on the right half of the screen (shortened height to avoid overlap with image)
-    motion_event_textarea = lv_textarea_create(scr);
-    lv_obj_set_size(motion_event_textarea, 380, 200); // Reduced height from 400 to 200
-    lv_obj_align(motion_event_textarea, LV_ALIGN_TOP_RIGHT, -10, 60);
-    lv_textarea_set_text(motion_event_textarea, "Motion Events:\n");
-    lv_obj_set_style_bg_color(motion_event_textarea, lv_color_hex(0xF5F5F5), 0); // Light gray background
-    lv_obj_set_style_text_color(motion_event_textarea, lv_color_hex(0x263238), 0); // Dark text
-    lv_obj_set_style_border_width(motion_event_textarea, 1, 0);
+    // Motion event log on the right half of the screen (shortened height to avoid overlap with image)
+    motion_event_log = log_view_create(scr, LCD_MAX_LINES);
+    lv_obj_set_size(motion_event_log, 380, 200); // Reduced height from 400 to 200
+    lv_obj_align(motion_event_log, LV_ALIGN_TOP_RIGHT, -10, 60);
+    lv_obj_set_style_bg_color(motion_event_log, lv_color_hex(0xF5F5F5), 0); // Light gray background
+    lv_obj_set_style_text_color(motion_event_log, lv_color_hex(0x263238), 0); // Dark text
+    lv_obj_set_style_border_width(motion_event_log, 1, 0);
+    log_view_append(motion_event_log, "Motion Events:");
 
     // Create the camera image widget - always visible, positioned below the text area
     camera_img_widget = lv_img_create(scr);
     lv_obj_set_size(camera_img_widget, 320, 240); // Match camera resolution
-    lv_obj_align_to(camera_img_widget, motion_event_textarea, LV_ALIGN_OUT_BOTTOM_LEFT, 0, 20); // Below text area, with 20px gap
+    lv_obj_align_to(camera_img_widget, motion_event_log, LV_ALIGN_OUT_BOTTOM_LEFT, 0, 20); // Below text area, with 20px gap
     // Removed LV_OBJ_FLAG_HIDDEN to make it always visible
 
     // Create a container for the switches
@@ -190,6 +195,9 @@ void lcd_create_ui(void)
     lv_obj_add_event_cb(stream_btn, stream_btn_event_cb, LV_EVENT_ALL, NULL);
     lv_obj_t *stream_label = lv_label_create(stream_btn);
     lv_label_set_text(stream_label, "Start Stream");
+
+    // Apply the queued updates once per refresh period
+    lv_timer_create(ui_queue_timer_cb, LV_DISP_DEF_REFR_PERIOD, NULL);
 }
 
 // --- Switch event handlers ---
@@ -216,10 +224,10 @@ static void fetch_image_button_event_cb(lv_event_t *e) {
 }
 
 // --- Update relay state callbacks ---
+// Applied by the UI queue drain on the LVGL task, so they don't take the LVGL lock
 
 void water_valve_state_cb(int relay_index, bool state)
 {
-    lvgl_port_lock(0);
     if (water_switch) {
         if (state) {
             lv_obj_add_state(water_switch, LV_STATE_CHECKED);
@@ -227,14 +235,12 @@ void water_valve_state_cb(int relay_index, bool state)
             lv_obj_clear_state(water_switch, LV_STATE_CHECKED);
         }
     }
-    lvgl_port_unlock();
 }
 
 void central_vacuum_state_cb(int relay_index, bool state)
 {
     if (relay_index != CENTRAL_VACUUM_INDEX)
         return;
-    lvgl_port_lock(0);
     if (central_vacuum_switch) {
         if (state) {
             lv_obj_add_state(central_vacuum_switch, LV_STATE_CHECKED);
@@ -242,14 +248,12 @@ void central_vacuum_state_cb(int relay_index, bool state)
             lv_obj_clear_state(central_vacuum_switch, LV_STATE_CHECKED);
         }
     }
-    lvgl_port_unlock();
 }
 
 void vacuum_pump_state_cb(int relay_index, bool state)
 {
     if (relay_index != VACUUM_PUMP_INDEX)
         return;
-    lvgl_port_lock(0);
     if (vacuum_pump_switch) {
         if (state) {
             lv_obj_add_state(vacuum_pump_switch, LV_STATE_CHECKED);
@@ -257,7 +261,6 @@ void vacuum_pump_state_cb(int relay_index, bool state)
             lv_obj_clear_state(vacuum_pump_switch, LV_STATE_CHECKED);
         }
     }
-    lvgl_port_unlock();
 }
 
 void lcd_update_wifi_status(const char *ssid, const char *ip)
@@ -385,59 +388,66 @@ void set_relay_state_change_callback(relay_state_change_callback_t cb) {
     relay_cb = cb;
 }
 
-void lcd_append_motion_event(const char *event_text)
+static void apply_relay_state(int relay_index, bool state)
 {
-    lvgl_port_lock(0); // <-- Lock LVGL before UI update
+    switch (relay_index) {
+        case WATER_VALVE_INDEX:
+            water_valve_state_cb(relay_index, state);
+            break;
+        case CENTRAL_VACUUM_INDEX:
+            central_vacuum_state_cb(relay_index, state);
+            break;
+        case VACUUM_PUMP_INDEX:
+            vacuum_pump_state_cb(relay_index, state);
+            break;
+    }
+}
 
-    static char buffer[LCD_MAX_TEXTAREA_BUF];
-    const char *current = lv_textarea_get_text(motion_event_textarea);
+static void apply_log_line(const char *line)
+{
+    // The log view draws the lines added in one drain together
+    log_view_append(motion_event_log, line);
+}
 
-    // Ignore huge messages that can't fit in buffer
-    if (strlen(event_text) > LCD_MAX_TEXTAREA_BUF / 2) {
-        return;
-    }
+static void ui_queue_timer_cb(lv_timer_t *timer)
+{
+    static const ui_queue_handlers_t handlers = {
+        .relay = apply_relay_state,
+        .ha_status = lcd_update_ha_status,
+        .log = apply_log_line,
+        .request = mqtt_serve_diag_requests,
+    };
+    (void)timer;
+    ui_queue_drain(&ui_queue, &handlers);
+}
 
-    // Copy current text to buffer
-    strncpy(buffer, current, sizeof(buffer) - 1);
-    buffer[sizeof(buffer) - 1] = '\0';
-
-    // Append new event (truncate if needed)
-    size_t buf_len = strlen(buffer);
-    size_t event_len = strlen(event_text);
-    size_t space_left = sizeof(buffer) - buf_len - 2; // for \n and \0
-    if (event_len > space_left) event_len = space_left;
-    strncat(buffer, event_text, event_len);
-    buf_len = strlen(buffer);
-    if (buf_len < sizeof(buffer) - 2) {
-        buffer[buf_len] = '\n';
-        buffer[buf_len + 1] = '\0';
-    }
+void lcd_post_relay_state(int relay_index, bool state)
+{
+    ui_queue_post_relay(&ui_queue, relay_index, state);
+}
 
-    // Count lines and keep only the last LCD_MAX_LINES
-    int lines = 0;
-    char *p = buffer;
-    while (*p) {
-        if (*p == '\n') lines++;
-        p++;
-    }
-    if (lines > LCD_MAX_LINES) {
-        // Find the Nth last newline
-        int to_skip = lines - LCD_MAX_LINES;
-        p = buffer;
-        while (to_skip > 0 && *p) {
-            if (*p == '\n') to_skip--;
-            p++;
-        }
-        // p now points just after the Nth newline
-        size_t len = strlen(p);
-        memmove(buffer, p, len + 1);
-    }
+void lcd_post_ha_status(bool connected, const char *ip)
+{
+    ui_queue_post_ha_status(&ui_queue, connected, ip);
+}
 
-    // Set text area
-    lv_textarea_set_text(motion_event_textarea, buffer);
-    lv_textarea_set_cursor_pos(motion_event_textarea, LV_TEXTAREA_CURSOR_LAST);
+bool lcd_post_log(const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    bool res = ui_queue_post_logv(&ui_queue, fmt, args);
+    va_end(args);
+    return res;
+}
 
-    lvgl_port_unlock(); // <-- Unlock after UI update
+void lcd_post_request(uint32_t requests)
+{
+    ui_queue_post_request(&ui_queue, requests);
+}
+
+void lcd_get_ui_queue_stats(ui_queue_stats_t *stats)
+{
+    ui_queue_get_stats(&ui_queue, stats);
 }
 
 void lcd_update_camera_snapshot(const uint8_t *jpeg_data, size_t jpeg_size) {
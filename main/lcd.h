@@ -4,6 +4,7 @@
 #include "esp_err.h"
 #include "lvgl.h"
 #include <stddef.h> // For size_t
+#include "ui_queue.h"
 
 #define WATER_VALVE_INDEX 1
 #define CENTRAL_VACUUM_INDEX 2
@@ -22,7 +23,13 @@ void update_wifi_status_ui(void);
 void update_ha_status_ui(bool connected, const char *ip);
 void update_wifi_status_ui(void);
 void update_ha_status_ui(bool connected, const char *ip);
-void lcd_append_motion_event(const char *event_text);
+// Queue UI updates from the MQTT task, the LVGL task applies them once per frame.
+// The producer doesn't take the LVGL lock; updates of the same widget are coalesced.
+void lcd_post_relay_state(int relay_index, bool state);
+void lcd_post_ha_status(bool connected, const char *ip);  // `ip` must stay valid
+bool lcd_post_log(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+void lcd_post_request(uint32_t requests);  // e.g. MQTT_DIAG_TRACE, served by mqtt_serve_diag_requests()
+void lcd_get_ui_queue_stats(ui_queue_stats_t *stats);
 void lcd_update_camera_snapshot(const uint8_t *jpeg_data, size_t jpeg_size);
 extern lv_obj_t *camera_img_widget;
 
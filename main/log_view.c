@@ -0,0 +1,322 @@
+#include "log_view.h"
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "esp_log.h"
+
+static const char *TAG = "LOG_VIEW";
+
+#define LOG_VIEW_ROWS_MAX 8        // Wrapped rows kept per line, the rest is clipped
+
+typedef struct {
+    char text[LOG_VIEW_LINE_MAX];
+    uint8_t row_start[LOG_VIEW_ROWS_MAX];  // Byte offset of every wrapped row
+    uint8_t row_cnt;
+} log_line_t;
+
+typedef struct {
+    log_line_t *lines;
+    uint32_t max_lines;
+    uint32_t first;             // Ring index of the oldest line
+    uint32_t cnt;
+    uint32_t total_rows;        // Wrapped rows of all lines
+    uint32_t scroll_rows;       // Rows scrolled back from the newest one
+    lv_coord_t drag_y;
+    lv_coord_t wrap_width;      // Content width the lines were wrapped to
+} log_view_t;
+
+static void log_view_event_cb(lv_event_t *e);
+static void log_view_wrap_line(lv_obj_t *obj, const log_view_t *view, log_line_t *line);
+static void log_view_wrap_all(lv_obj_t *obj, log_view_t *view);
+static uint32_t log_view_visible_rows(lv_obj_t *obj);
+static uint32_t log_view_top_row(const log_view_t *view, uint32_t visible);
+static void log_view_clamp_scroll(log_view_t *view, uint32_t visible);
+static void log_view_invalidate_rows(lv_obj_t *obj, const log_view_t *view, uint32_t from, uint32_t to);
+static void log_view_invalidate_content(lv_obj_t *obj);
+
+lv_obj_t *log_view_create(lv_obj_t *parent, uint32_t max_lines)
+{
+    log_view_t *view = calloc(1, sizeof(log_view_t));
+    if (view) {
+        view->lines = calloc(max_lines, sizeof(log_line_t));
+    }
+    if (!view || !view->lines || max_lines == 0) {
+        ESP_LOGE(TAG, "Not enough memory for %u lines", (unsigned)max_lines);
+        if (view) {
+            free(view->lines);
+            free(view);
+        }
+        return NULL;
+    }
+    view->max_lines = max_lines;
+
+    lv_obj_t *obj = lv_obj_create(parent);
+    // The rows are scrolled by the widget itself, don't pass the drag to the parent
+    lv_obj_clear_flag(obj, LV_OBJ_FLAG_SCROLLABLE | LV_OBJ_FLAG_SCROLL_CHAIN);
+    lv_obj_set_user_data(obj, view);
+    lv_obj_add_event_cb(obj, log_view_event_cb, LV_EVENT_ALL, NULL);
+
+    return obj;
+}
+
+void log_view_append(lv_obj_t *obj, const char *text)
+{
+    log_view_t *view = obj ? lv_obj_get_user_data(obj) : NULL;
+    if (!view || !text) {
+        return;
+    }
+
+    if (view->wrap_width != lv_obj_get_content_width(obj)) {
+        log_view_wrap_all(obj, view);
+        log_view_invalidate_content(obj);
+    }
+
+    uint32_t visible = log_view_visible_rows(obj);
+    uint32_t old_total = view->total_rows;
+    uint32_t old_top = log_view_top_row(view, visible);
+    uint32_t dropped_rows = 0;
+
+    log_line_t *line;
+    if (view->cnt == view->max_lines) {
+        // The ring is full, the oldest line scrolls out
+        line = &view->lines[view->first];
+        dropped_rows = line->row_cnt;
+        view->total_rows -= line->row_cnt;
+        view->first = (view->first + 1) % view->max_lines;
+        view->cnt--;
+    }
+    line = &view->lines[(view->first + view->cnt) % view->max_lines];
+    size_t i;
+    for (i = 0; i < LOG_VIEW_LINE_MAX - 1 && text[i]; i++) {
+        // One entry is one line, the rows are made by wrapping only
+        line->text[i] = (text[i] == '\n' || text[i] == '\r' || text[i] == '\t') ? ' ' : text[i];
+    }
+    line->text[i] = '\0';
+    view->cnt++;
+
+    log_view_wrap_line(obj, view, line);
+    view->total_rows += line->row_cnt;
+
+    // Keep a scrolled back view in place
+    if (view->scroll_rows) {
+        view->scroll_rows += view->total_rows + dropped_rows - old_total;
+        log_view_clamp_scroll(view, visible);
+    }
+
+    // Rows are counted from the oldest line, so the dropped rows shift the indices.
+    // The invalid areas of the lines added before the next refresh are joined and drawn together.
+    uint32_t new_top = log_view_top_row(view, visible);
+    if (new_top + dropped_rows == old_top) {
+        // Only the appended rows changed on the screen
+        log_view_invalidate_rows(obj, view, old_total - dropped_rows, view->total_rows);
+    } else {
+        log_view_invalidate_content(obj);
+    }
+}
+
+// --- Layout ---
+
+static lv_coord_t log_view_row_height(lv_obj_t *obj)
+{
+    const lv_font_t *font = lv_obj_get_style_text_font(obj, LV_PART_MAIN);
+    lv_coord_t h = lv_font_get_line_height(font) + lv_obj_get_style_text_line_space(obj, LV_PART_MAIN);
+    return h > 0 ? h : 1;
+}
+
+static uint32_t log_view_visible_rows(lv_obj_t *obj)
+{
+    lv_coord_t h = lv_obj_get_content_height(obj);
+    return h > 0 ? h / log_view_row_height(obj) : 0;
+}
+
+// First shown row, counted from the oldest line
+static uint32_t log_view_top_row(const log_view_t *view, uint32_t visible)
+{
+    if (view->total_rows <= visible) {
+        return 0;
+    }
+    return view->total_rows - visible - view->scroll_rows;
+}
+
+static void log_view_clamp_scroll(log_view_t *view, uint32_t visible)
+{
+    uint32_t max_scroll = view->total_rows > visible ? view->total_rows - visible : 0;
+    if (view->scroll_rows > max_scroll) {
+        view->scroll_rows = max_scroll;
+    }
+}
+
+static void log_view_wrap_line(lv_obj_t *obj, const log_view_t *view, log_line_t *line)
+{
+    const lv_font_t *font = lv_obj_get_style_text_font(obj, LV_PART_MAIN);
+    lv_coord_t letter_space = lv_obj_get_style_text_letter_space(obj, LV_PART_MAIN);
+    uint32_t ofs = 0;
+
+    line->row_cnt = 0;
+    do {
+        line->row_start[line->row_cnt++] = ofs;
+        if (view->wrap_width <= 0) {
+            break;
+        }
+        uint32_t len = _lv_txt_get_next_line(&line->text[ofs], font, letter_space, view->wrap_width, NULL, LV_TEXT_FLAG_NONE);
+        if (len == 0) {
+            break;
+        }
+        ofs += len;
+    } while (line->text[ofs] != '\0' && line->row_cnt < LOG_VIEW_ROWS_MAX);
+}
+
+static void log_view_wrap_all(lv_obj_t *obj, log_view_t *view)
+{
+    view->wrap_width = lv_obj_get_content_width(obj);
+    view->total_rows = 0;
+    for (uint32_t i = 0; i < view->cnt; i++) {
+        log_line_t *line = &view->lines[(view->first + i) % view->max_lines];
+        log_view_wrap_line(obj, view, line);
+        view->total_rows += line->row_cnt;
+    }
+    log_view_clamp_scroll(view, log_view_visible_rows(obj));
+}
+
+// Invalidate the shown rows in [from, to), counted from the oldest line
+static void log_view_invalidate_rows(lv_obj_t *obj, const log_view_t *view, uint32_t from, uint32_t to)
+{
+    uint32_t visible = log_view_visible_rows(obj);
+    uint32_t top = log_view_top_row(view, visible);
+    if (from < top) from = top;
+    if (to > top + visible) to = top + visible;
+    if (from >= to) {
+        return;
+    }
+
+    lv_coord_t row_h = log_view_row_height(obj);
+    lv_area_t area;
+    lv_obj_get_content_coords(obj, &area);
+    area.y1 += (lv_coord_t)(from - top) * row_h;
+    area.y2 = area.y1 + (lv_coord_t)(to - from) * row_h - 1;
+    lv_obj_invalidate_area(obj, &area);
+}
+
+static void log_view_invalidate_content(lv_obj_t *obj)
+{
+    lv_area_t area;
+    lv_obj_get_content_coords(obj, &area);
+    lv_obj_invalidate_area(obj, &area);
+}
+
+// --- Events ---
+
+static void log_view_draw(lv_event_t *e, lv_obj_t *obj, log_view_t *view)
+{
+    lv_draw_ctx_t *draw_ctx = lv_event_get_draw_ctx(e);
+    lv_area_t content;
+    lv_area_t clip;
+    lv_obj_get_content_coords(obj, &content);
+    if (!_lv_area_intersect(&clip, draw_ctx->clip_area, &content)) {
+        return;
+    }
+
+    lv_draw_label_dsc_t dsc;
+    lv_draw_label_dsc_init(&dsc);
+    lv_obj_init_draw_label_dsc(obj, LV_PART_MAIN, &dsc);
+
+    lv_coord_t row_h = log_view_row_height(obj);
+    uint32_t visible = log_view_visible_rows(obj);
+    uint32_t top = log_view_top_row(view, visible);
+    uint32_t end = top + visible;
+    uint32_t row = 0;
+    char buf[LOG_VIEW_LINE_MAX];
+
+    const lv_area_t *clip_ori = draw_ctx->clip_area;
+    draw_ctx->clip_area = &clip;
+
+    for (uint32_t i = 0; i < view->cnt && row < end; i++) {
+        const log_line_t *line = &view->lines[(view->first + i) % view->max_lines];
+        if (row + line->row_cnt <= top) {
+            row += line->row_cnt;
+            continue;
+        }
+        size_t len = strlen(line->text);
+        for (uint32_t r = 0; r < line->row_cnt && row < end; r++, row++) {
+            if (row < top) {
+                continue;
+            }
+            lv_area_t area = content;
+            area.y1 = content.y1 + (lv_coord_t)(row - top) * row_h;
+            area.y2 = area.y1 + row_h - 1;
+            if (!_lv_area_is_on(&area, &clip)) {
+                continue;
+            }
+
+            size_t start = line->row_start[r];
+            size_t stop = (r + 1 < line->row_cnt) ? line->row_start[r + 1] : len;
+            memcpy(buf, &line->text[start], stop - start);
+            buf[stop - start] = '\0';
+            lv_draw_label(draw_ctx, &dsc, &area, buf, NULL);
+        }
+    }
+
+    draw_ctx->clip_area = clip_ori;
+}
+
+static void log_view_scroll(lv_obj_t *obj, log_view_t *view)
+{
+    lv_point_t vect;
+    lv_indev_get_vect(lv_indev_get_act(), &vect);
+
+    // Dragging down shows older rows
+    lv_coord_t row_h = log_view_row_height(obj);
+    view->drag_y += vect.y;
+    int32_t rows = view->drag_y / row_h;
+    if (rows == 0) {
+        return;
+    }
+    view->drag_y -= rows * row_h;
+
+    uint32_t old_scroll = view->scroll_rows;
+    if (rows < 0 && (uint32_t)(-rows) > view->scroll_rows) {
+        view->scroll_rows = 0;
+    } else {
+        view->scroll_rows += rows;
+    }
+    log_view_clamp_scroll(view, log_view_visible_rows(obj));
+    if (view->scroll_rows != old_scroll) {
+        log_view_invalidate_content(obj);
+    }
+}
+
+static void log_view_event_cb(lv_event_t *e)
+{
+    lv_event_code_t code = lv_event_get_code(e);
+    lv_obj_t *obj = lv_event_get_target(e);
+    log_view_t *view = lv_obj_get_user_data(obj);
+    if (!view) {
+        return;
+    }
+
+    switch (code) {
+    case LV_EVENT_DRAW_MAIN:
+        log_view_draw(e, obj, view);
+        break;
+    case LV_EVENT_SIZE_CHANGED:
+    case LV_EVENT_STYLE_CHANGED:
+        // The cached rows depend on the width and the font
+        log_view_wrap_all(obj, view);
+        log_view_invalidate_content(obj);
+        break;
+    case LV_EVENT_PRESSING:
+        log_view_scroll(obj, view);
+        break;
+    case LV_EVENT_RELEASED:
+    case LV_EVENT_PRESS_LOST:
+        view->drag_y = 0;
+        break;
+    case LV_EVENT_DELETE:
+        lv_obj_set_user_data(obj, NULL);
+        free(view->lines);
+        free(view);
+        break;
+    default:
+        break;
+    }
+}
@@ -0,0 +1,25 @@
+#ifndef LOG_VIEW_H
+#define LOG_VIEW_H
+#include <stdint.h>
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LOG_VIEW_LINE_MAX 128  // Longer lines are truncated
+
+// Scrolling log/console widget backed by a fixed capacity ring of lines.
+// Every line is wrapped once, when it's added (or when the width changes), and
+// the appends arriving within one refresh period are drawn together.
+lv_obj_t *log_view_create(lv_obj_t *parent, uint32_t max_lines);
+
+// Append a line. Like the other LVGL calls it has to run on the LVGL task or with the LVGL lock held;
+// the other tasks post their lines through the UI queue (lcd_post_log()).
+void log_view_append(lv_obj_t *obj, const char *text);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LOG_VIEW_H
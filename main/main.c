@@ -8,6 +8,7 @@
 #include "esp_event.h"
 #include "esp_wifi.h"
 #include "nvs_flash.h"
+#include "esp_partition.h"
 #include "esp_private/wifi.h"
 
 #include "freertos/FreeRTOS.h"
@@ -22,11 +23,15 @@
 #include "driver/i2c.h"
 #include "mqtt_relay_client.h"
 #include "esp_system.h"
+#include "esp_heap_caps.h"
+#include <inttypes.h>
 #include "lcd.h"
 #include "mqtt.h"
 #include "wifi.h"
 #include "camera_client.h" // Add this include
+#include "ui_assets.h"
 #include "src/extra/libs/png/lv_png.h"  // Corrected path for lv_png_init
+#include "src/draw/sw/lv_draw_sw.h"
 
 #define TAG "CENTRALCONTROLLER"
 
@@ -37,13 +42,24 @@
 #define EXAMPLE_LCD_V_RES   (480)
 
 /* LCD settings */
+// Tile mode: LVGL renders 800x24 tiles in internal RAM, they are copied into the only RGB frame buffer
+// behind the scan-out. Otherwise direct mode with two RGB frame buffers.
+#define EXAMPLE_LCD_LVGL_TILE_MODE              (0)
+#if EXAMPLE_LCD_LVGL_TILE_MODE
+#define EXAMPLE_LCD_LVGL_FULL_REFRESH           (0)
+#define EXAMPLE_LCD_LVGL_DIRECT_MODE            (0)
+#define EXAMPLE_LCD_LVGL_AVOID_TEAR             (0)
+#define EXAMPLE_LCD_DRAW_BUFF_HEIGHT            (24)
+#define EXAMPLE_LCD_RGB_BUFFER_NUMS             (1)
+#else
 #define EXAMPLE_LCD_LVGL_FULL_REFRESH           (0)
 #define EXAMPLE_LCD_LVGL_DIRECT_MODE            (1)
 #define EXAMPLE_LCD_LVGL_AVOID_TEAR             (1)
-#define EXAMPLE_LCD_RGB_BOUNCE_BUFFER_MODE      (1)
-#define EXAMPLE_LCD_DRAW_BUFF_DOUBLE            (0)
 #define EXAMPLE_LCD_DRAW_BUFF_HEIGHT            (100)
 #define EXAMPLE_LCD_RGB_BUFFER_NUMS             (2)
+#endif
+#define EXAMPLE_LCD_RGB_BOUNCE_BUFFER_MODE      (1)
+#define EXAMPLE_LCD_DRAW_BUFF_DOUBLE            (0)
 #define EXAMPLE_LCD_RGB_BOUNCE_BUFFER_HEIGHT    (10)
 
 /* LCD pins - Waveshare ESP32-S3-Touch-LCD-7.0 */
@@ -76,10 +92,15 @@
 /* Touch pins - Waveshare ESP32-S3-Touch-LCD-7.0 */
 #define EXAMPLE_TOUCH_I2C_SCL       (GPIO_NUM_9)
 #define EXAMPLE_TOUCH_I2C_SDA       (GPIO_NUM_8)
+#define EXAMPLE_TOUCH_GPIO_INT      (GPIO_NUM_4)
+
+#define EXAMPLE_LCD_PCLK_HZ         (16 * 1000 * 1000)
+#define EXAMPLE_LCD_H_BLANK         (4 + 8 + 8)     // HSYNC pulse width + back porch + front porch
+#define EXAMPLE_LCD_V_BLANK         (4 + 8 + 8)     // VSYNC pulse width + back porch + front porch
 
 #define EXAMPLE_LCD_PANEL_35HZ_RGB_TIMING()  \
     {                                               \
-        .pclk_hz = 16 * 1000 * 1000,                \
+        .pclk_hz = EXAMPLE_LCD_PCLK_HZ,             \
         .h_res = EXAMPLE_LCD_H_RES,                 \
         .v_res = EXAMPLE_LCD_V_RES,                 \
         .hsync_pulse_width = 4,                     \
@@ -173,7 +194,8 @@ static esp_err_t app_touch_init(void)
         .x_max = EXAMPLE_LCD_H_RES,
         .y_max = EXAMPLE_LCD_V_RES,
         .rst_gpio_num = GPIO_NUM_NC,
-        .int_gpio_num = GPIO_NUM_NC,
+        /* The LVGL task sleeps while the touch is released and wakes on this interrupt */
+        .int_gpio_num = EXAMPLE_TOUCH_GPIO_INT,
         .levels = {
             .reset = 0,
             .interrupt = 0,
@@ -204,6 +226,12 @@ static esp_err_t app_lvgl_init(void)
 
     // Initialize PNG decoder
     lv_png_init();
+    // Images and fonts drawn straight from the asset partition if the partition table has one
+    // (see ui_assets.h), the UI works without them too
+    if (esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, "assets") &&
+        ui_assets_init("assets") != ESP_OK) {
+        ESP_LOGW(TAG, "Can't use the UI assets, flash them with the app");
+    }
 
     uint32_t buff_size = EXAMPLE_LCD_H_RES * EXAMPLE_LCD_DRAW_BUFF_HEIGHT;
 #if EXAMPLE_LCD_LVGL_FULL_REFRESH || EXAMPLE_LCD_LVGL_DIRECT_MODE
@@ -251,9 +279,21 @@ static esp_err_t app_lvgl_init(void)
 #else
             .avoid_tearing = false,
 #endif
-        }
+#if EXAMPLE_LCD_LVGL_TILE_MODE
+            .tile_mode = true,
+#endif
+        },
+        .timing = {
+            .pclk_hz = EXAMPLE_LCD_PCLK_HZ,
+            .h_blank = EXAMPLE_LCD_H_BLANK,
+            .v_blank = EXAMPLE_LCD_V_BLANK,
+#if EXAMPLE_LCD_RGB_BOUNCE_BUFFER_MODE
+            .bounce_lines = EXAMPLE_LCD_RGB_BOUNCE_BUFFER_HEIGHT,
+#endif
+        },
     };
     lvgl_disp = lvgl_port_add_disp_rgb(&disp_cfg, &rgb_cfg);
+    ESP_RETURN_ON_FALSE(lvgl_disp, ESP_FAIL, TAG, "Adding the LVGL display failed");
 
     /* Add touch input (for selected screen) - only if touch was initialized successfully */
     if (touch_handle != NULL) {
@@ -269,18 +309,107 @@ static esp_err_t app_lvgl_init(void)
     return ESP_OK;
 }
 
-static void relay_state_change_handler(int relay_index, bool state) {
-    switch (relay_index) {
-        case WATER_VALVE_INDEX:
-            water_valve_state_cb(relay_index, state);
-            break;
-        case CENTRAL_VACUUM_INDEX:
-            central_vacuum_state_cb(relay_index, state);
-            break;
-        case VACUUM_PUMP_INDEX:
-            vacuum_pump_state_cb(relay_index, state);
-            break;
+// --- Diagnostics, logged every 30 s by one LVGL timer. The counters are per period. ---
+
+#if EXAMPLE_LCD_LVGL_TILE_MODE
+// Frame buffer traffic of the tile mode, the tiles are counted in the LVGL task
+static void diag_log_tiles(void)
+{
+    static lvgl_port_tile_stats_t last;
+    lvgl_port_tile_stats_t stats;
+
+    if (lvgl_port_get_tile_stats(lvgl_disp, &stats) != ESP_OK) {
+        return;
     }
+
+    ESP_LOGI(TAG, "Tiles: %"PRIu32" frames, %"PRIu32" tiles, %"PRIu64" KB written, %"PRIu64" ms waited, %"PRIu32" late",
+             stats.frames - last.frames, stats.tiles - last.tiles, (stats.bytes - last.bytes) / 1024,
+             (stats.wait_us - last.wait_us) / 1000, stats.late - last.late);
+    last = stats;
+}
+#endif
+
+#if LV_IMG_CACHE_DEF_SIZE
+// How well the decoded images are reused
+static void diag_log_img_cache(void)
+{
+    static lv_img_cache_stats_t last;
+    lv_img_cache_stats_t stats;
+
+    lv_img_cache_get_stats(&stats);
+    ESP_LOGI(TAG, "Image cache: %"PRIu32" hits, %"PRIu32" misses, %"PRIu32" evictions, %u images, %u of %u KB",
+             stats.hit_cnt - last.hit_cnt, stats.miss_cnt - last.miss_cnt, stats.evict_cnt - last.evict_cnt,
+             stats.entry_cnt, (unsigned)(stats.mem_size / 1024), (unsigned)(stats.mem_max / 1024));
+    last = stats;
+}
+#endif
+
+#if LV_DRAW_COMPLEX && LV_SHADOW_CACHE_SIZE
+// How often the blurred shadow corners are reused
+static void diag_log_shadow_cache(void)
+{
+    static lv_draw_sw_shadow_cache_stats_t last;
+    lv_draw_sw_shadow_cache_stats_t stats;
+
+    lv_draw_sw_shadow_cache_get_stats(&stats);
+    ESP_LOGI(TAG, "Shadow cache: %"PRIu32" hits, %"PRIu32" misses, %"PRIu32" evictions, %u corners, %u of %u bytes",
+             stats.hit_cnt - last.hit_cnt, stats.miss_cnt - last.miss_cnt, stats.evict_cnt - last.evict_cnt,
+             stats.entry_cnt, (unsigned)stats.mem_size, (unsigned)stats.mem_max);
+    last = stats;
+}
+#endif
+
+#if LV_MEM_CUSTOM == 0
+// Use and fragmentation of the LVGL heap
+static void diag_log_mem(void)
+{
+    static uint32_t last_fallbacks;
+    lv_mem_monitor_t mon;
+
+    lv_mem_monitor(&mon);
+    ESP_LOGI(TAG, "LVGL heap: %u of %u KB used (max %u KB), %u%% frag, biggest free %u bytes, "
+             "slab: %"PRIu32" objects, %u%% frag, %"PRIu32" fallbacks",
+             (unsigned)((mon.total_size - mon.free_size) / 1024), (unsigned)(mon.total_size / 1024),
+             (unsigned)(mon.max_used / 1024), mon.frag_pct, (unsigned)mon.free_biggest_size,
+             mon.slab_used_cnt, mon.slab_frag_pct, mon.slab_fallback_cnt - last_fallbacks);
+    last_fallbacks = mon.slab_fallback_cnt;
+}
+#endif
+
+// The MQTT to UI update queue
+static void diag_log_ui_queue(void)
+{
+    static ui_queue_stats_t last;
+    ui_queue_stats_t stats;
+
+    lcd_get_ui_queue_stats(&stats);
+    ESP_LOGI(TAG, "UI queue: %"PRIu32" updates, %"PRIu32" coalesced, %"PRIu32" dropped, depth %"PRIu32
+             " (max %"PRIu32"), %"PRIu32" drains", stats.posted - last.posted, stats.coalesced - last.coalesced,
+             stats.dropped - last.dropped, stats.depth, stats.depth_max, stats.drains - last.drains);
+    last = stats;
+}
+
+static void diag_timer_cb(lv_timer_t *timer)
+{
+    (void)timer;
+#if EXAMPLE_LCD_LVGL_TILE_MODE
+    diag_log_tiles();
+#endif
+#if LV_IMG_CACHE_DEF_SIZE
+    diag_log_img_cache();
+#endif
+#if LV_DRAW_COMPLEX && LV_SHADOW_CACHE_SIZE
+    diag_log_shadow_cache();
+#endif
+#if LV_MEM_CUSTOM == 0
+    diag_log_mem();
+#endif
+    diag_log_ui_queue();
+}
+
+static void relay_state_change_handler(int relay_index, bool state) {
+    // Called from the MQTT task, the switch is updated with the next frame
+    lcd_post_relay_state(relay_index, state);
 }
 
 void app_main(void)
@@ -298,6 +427,10 @@ void app_main(void)
     // Initialize and connect WiFi
     wifi_init_sta();
 
+    // Measure the memory taken by the frame buffers, bounce buffers and LVGL draw buffers
+    size_t psram_free = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+    size_t internal_free = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+
     // Initialize MQTT client before any publish
     ESP_ERROR_CHECK(app_lcd_init());
 
@@ -309,8 +442,12 @@ void app_main(void)
     }
 
     ESP_ERROR_CHECK(app_lvgl_init());
+    ESP_LOGI(TAG, "Display uses %u KB PSRAM and %u KB internal RAM",
+             (unsigned)((psram_free - heap_caps_get_free_size(MALLOC_CAP_SPIRAM)) / 1024),
+             (unsigned)((internal_free - heap_caps_get_free_size(MALLOC_CAP_INTERNAL)) / 1024));
     lvgl_port_lock(0);
     lcd_create_ui();
+    lv_timer_create(diag_timer_cb, 30 * 1000, NULL);
     lvgl_port_unlock();
     
     
@@ -0,0 +1,295 @@
+#include "mjpeg_parser.h"
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+enum {
+    ST_DELIM,       // Looking for the multipart delimiter
+    ST_DELIM_LINE,  // Rest of the delimiter line
+    ST_HEADERS,     // Part headers
+    ST_SOI,         // Looking for the start of the next JPEG
+    ST_JPEG,        // JPEG data, its end is found by the marker scanner
+    ST_BODY,        // JPEG data of a part with Content-Length
+    ST_END,         // Frame complete, report it
+};
+
+enum {
+    J_FF,           // Expecting the 0xFF of a marker
+    J_MARKER,       // Expecting the marker code
+    J_LEN_HI,
+    J_LEN_LO,
+    J_SEGMENT,      // Skipping the payload of a marker segment
+    J_ENTROPY,      // Entropy coded data after SOS
+    J_ENTROPY_FF,   // 0xFF in entropy coded data
+};
+
+#define JPEG_SOS 0xDA
+#define JPEG_EOI 0xD9
+
+static const uint8_t jpeg_soi[2] = {0xFF, 0xD8};
+
+void mjpeg_parser_init(mjpeg_parser_t *parser, const char *boundary)
+{
+    memset(parser, 0, sizeof(*parser));
+    parser->part_len = -1;
+    parser->state = ST_SOI;
+
+    size_t boundary_len = boundary ? strlen(boundary) : 0;
+    if (boundary_len == 0) {
+        return;
+    }
+    if (boundary_len > MJPEG_PARSER_BOUNDARY_MAX) {
+        boundary_len = MJPEG_PARSER_BOUNDARY_MAX;
+    }
+
+    parser->delim[0] = '-';
+    parser->delim[1] = '-';
+    memcpy(parser->delim + 2, boundary, boundary_len);
+    parser->delim_len = boundary_len + 2;
+    parser->state = ST_DELIM;
+
+    // KMP failure table, so a delimiter split across reads or following '-' characters is still found
+    uint8_t k = 0;
+    for (uint8_t i = 1; i < parser->delim_len; i++) {
+        while (k > 0 && parser->delim[i] != parser->delim[k]) {
+            k = parser->delim_next[k - 1];
+        }
+        if (parser->delim[i] == parser->delim[k]) {
+            k++;
+        }
+        parser->delim_next[i] = k;
+    }
+}
+
+static size_t find_delim(mjpeg_parser_t *parser, const uint8_t *in, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        while (parser->delim_match > 0 && parser->delim[parser->delim_match] != (char)in[i]) {
+            parser->delim_match = parser->delim_next[parser->delim_match - 1];
+        }
+        if (parser->delim[parser->delim_match] == (char)in[i]) {
+            parser->delim_match++;
+        }
+        if (parser->delim_match == parser->delim_len) {
+            parser->delim_match = 0;
+            parser->state = ST_DELIM_LINE;
+            return i + 1;
+        }
+    }
+    return len;
+}
+
+static size_t parse_headers(mjpeg_parser_t *parser, const uint8_t *in, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        if (in[i] != '\n') {
+            if (parser->line_len < MJPEG_PARSER_LINE_MAX - 1) {
+                parser->line[parser->line_len++] = in[i];
+            } else {
+                parser->line_long = true;
+            }
+            continue;
+        }
+
+        if (parser->line_len > 0 && parser->line[parser->line_len - 1] == '\r') {
+            parser->line_len--;
+        }
+        parser->line[parser->line_len] = '\0';
+
+        if (parser->line_len == 0 && !parser->line_long) {
+            // Empty line: the part body follows
+            if (parser->part_len == 0) {
+                parser->state = ST_END;
+            } else {
+                parser->state = parser->part_len > 0 ? ST_BODY : ST_SOI;
+            }
+            return i + 1;
+        }
+        if (!parser->line_long && strncasecmp(parser->line, "Content-Length:", 15) == 0) {
+            parser->part_len = atoi(parser->line + 15);
+            if (parser->part_len < 0) {
+                parser->part_len = -1;
+            }
+        }
+        parser->line_len = 0;
+        parser->line_long = false;
+    }
+    return len;
+}
+
+static size_t find_soi(mjpeg_parser_t *parser, const uint8_t *in, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        if (parser->soi_ff && in[i] == jpeg_soi[1]) {
+            parser->soi_ff = false;
+            parser->jpeg_state = J_FF;
+            parser->state = ST_JPEG;
+            return i + 1;
+        }
+        parser->soi_ff = (in[i] == 0xFF);
+    }
+    return len;
+}
+
+// Returns true at EOI
+static bool jpeg_marker(mjpeg_parser_t *parser, uint8_t marker)
+{
+    if (marker == JPEG_EOI) {
+        return true;
+    }
+    if (marker == 0xD8 || marker == 0x01 || (marker >= 0xD0 && marker <= 0xD7)) {
+        // SOI, TEM and RSTn have no payload
+        parser->jpeg_state = J_FF;
+    } else {
+        parser->jpeg_marker = marker;
+        parser->jpeg_state = J_LEN_HI;
+    }
+    return false;
+}
+
+// Follows the marker segments (skipping their payload) and the entropy coded data up to EOI
+static size_t scan_jpeg(mjpeg_parser_t *parser, const uint8_t *in, size_t len, bool *eoi)
+{
+    size_t i = 0;
+    *eoi = false;
+
+    while (i < len) {
+        switch (parser->jpeg_state) {
+        case J_FF:
+            if (in[i++] == 0xFF) {
+                parser->jpeg_state = J_MARKER;
+            }
+            break;
+        case J_MARKER:
+            // 0xFF fill bytes can precede the marker code
+            if (in[i] != 0xFF && jpeg_marker(parser, in[i])) {
+                *eoi = true;
+                return i + 1;
+            }
+            i++;
+            break;
+        case J_LEN_HI:
+            parser->jpeg_seg_left = in[i++] << 8;
+            parser->jpeg_state = J_LEN_LO;
+            break;
+        case J_LEN_LO:
+            parser->jpeg_seg_left |= in[i++];
+            // The length includes its own 2 bytes
+            parser->jpeg_seg_left = parser->jpeg_seg_left >= 2 ? parser->jpeg_seg_left - 2 : 0;
+            parser->jpeg_state = J_SEGMENT;
+            break;
+        case J_SEGMENT: {
+            size_t n = len - i;
+            if (n > parser->jpeg_seg_left) {
+                n = parser->jpeg_seg_left;
+            }
+            i += n;
+            parser->jpeg_seg_left -= n;
+            if (parser->jpeg_seg_left == 0) {
+                parser->jpeg_state = (parser->jpeg_marker == JPEG_SOS) ? J_ENTROPY : J_FF;
+            }
+            break;
+        }
+        case J_ENTROPY: {
+            const uint8_t *ff = memchr(in + i, 0xFF, len - i);
+            if (ff == NULL) {
+                return len;
+            }
+            i = ff - in + 1;
+            parser->jpeg_state = J_ENTROPY_FF;
+            break;
+        }
+        case J_ENTROPY_FF: {
+            uint8_t c = in[i++];
+            if (c == 0x00 || (c >= 0xD0 && c <= 0xD7)) {
+                // Stuffed 0xFF or restart marker
+                parser->jpeg_state = J_ENTROPY;
+            } else if (c != 0xFF && jpeg_marker(parser, c)) {
+                *eoi = true;
+                return i;
+            }
+            break;
+        }
+        }
+    }
+    return i;
+}
+
+mjpeg_parser_res_t mjpeg_parser_parse(mjpeg_parser_t *parser, const uint8_t *in, size_t len,
+                                      size_t *used, const uint8_t **out, size_t *out_len)
+{
+    size_t pos = 0;
+    *out = NULL;
+    *out_len = 0;
+
+    while (true) {
+        if (parser->state == ST_END) {
+            parser->state = parser->delim_len ? ST_DELIM : ST_SOI;
+            *used = pos;
+            return MJPEG_PARSER_FRAME_END;
+        }
+        if (pos == len) {
+            break;
+        }
+
+        switch (parser->state) {
+        case ST_DELIM:
+            pos += find_delim(parser, in + pos, len - pos);
+            break;
+        case ST_DELIM_LINE: {
+            const uint8_t *nl = memchr(in + pos, '\n', len - pos);
+            if (nl == NULL) {
+                pos = len;
+                break;
+            }
+            pos = nl - in + 1;
+            parser->line_len = 0;
+            parser->line_long = false;
+            parser->part_len = -1;
+            parser->state = ST_HEADERS;
+            break;
+        }
+        case ST_HEADERS:
+            pos += parse_headers(parser, in + pos, len - pos);
+            break;
+        case ST_SOI:
+            pos += find_soi(parser, in + pos, len - pos);
+            if (parser->state == ST_JPEG) {
+                // The marker may have been split between two reads, so return it from a constant
+                *out = jpeg_soi;
+                *out_len = sizeof(jpeg_soi);
+                *used = pos;
+                return MJPEG_PARSER_FRAME_DATA;
+            }
+            break;
+        case ST_JPEG: {
+            bool eoi;
+            size_t n = scan_jpeg(parser, in + pos, len - pos, &eoi);
+            if (eoi) {
+                parser->state = ST_END;
+            }
+            *out = in + pos;
+            *out_len = n;
+            *used = pos + n;
+            return MJPEG_PARSER_FRAME_DATA;
+        }
+        case ST_BODY: {
+            size_t n = len - pos;
+            if (n > (size_t)parser->part_len) {
+                n = parser->part_len;
+            }
+            parser->part_len -= n;
+            if (parser->part_len == 0) {
+                parser->state = ST_END;
+            }
+            *out = in + pos;
+            *out_len = n;
+            *used = pos + n;
+            return MJPEG_PARSER_FRAME_DATA;
+        }
+        }
+    }
+
+    *used = pos;
+    return MJPEG_PARSER_NEED_DATA;
+}
@@ -0,0 +1,57 @@
+#ifndef MJPEG_PARSER_H
+#define MJPEG_PARSER_H
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MJPEG_PARSER_BOUNDARY_MAX 70  // RFC 2046 limit
+#define MJPEG_PARSER_LINE_MAX 80      // Longer part header lines are ignored
+
+typedef enum {
+    MJPEG_PARSER_NEED_DATA,   // The input is consumed, feed the next bytes
+    MJPEG_PARSER_FRAME_DATA,  // *out points to the next bytes of the current frame
+    MJPEG_PARSER_FRAME_END,   // The current frame is complete
+} mjpeg_parser_res_t;
+
+// Splits a byte stream into JPEG frames without buffering them.
+// The stream is either a multipart/x-mixed-replace body or bare JPEG images back to back
+// (e.g. one snapshot response). Parts without Content-Length are delimited by the JPEG
+// markers, so the EOI inside an embedded EXIF thumbnail doesn't end the frame.
+typedef struct {
+    uint8_t state;
+    // Multipart delimiter search ("--boundary")
+    char delim[2 + MJPEG_PARSER_BOUNDARY_MAX];
+    uint8_t delim_next[2 + MJPEG_PARSER_BOUNDARY_MAX];
+    uint8_t delim_len;
+    uint8_t delim_match;
+    // Part headers
+    char line[MJPEG_PARSER_LINE_MAX];
+    uint8_t line_len;
+    bool line_long;
+    int32_t part_len;  // Content-Length of the part, -1: unknown
+    // JPEG marker scanner
+    uint8_t jpeg_state;
+    uint8_t jpeg_marker;
+    uint16_t jpeg_seg_left;
+    bool soi_ff;
+} mjpeg_parser_t;
+
+// Start parsing a new body. `boundary` is the boundary parameter of the multipart
+// Content-Type, or NULL for bare JPEG images.
+void mjpeg_parser_init(mjpeg_parser_t *parser, const char *boundary);
+
+// Parse the next bytes of `in`. `*used` returns how many bytes were consumed; call again
+// with the rest of the input until it returns MJPEG_PARSER_NEED_DATA.
+// Frame data is returned as a pointer into `in` (or to a constant), it is never copied.
+mjpeg_parser_res_t mjpeg_parser_parse(mjpeg_parser_t *parser, const uint8_t *in, size_t len,
+                                      size_t *used, const uint8_t **out, size_t *out_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MJPEG_PARSER_H
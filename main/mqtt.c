@@ -4,11 +4,12 @@
 #include <string.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <stdlib.h>
+#include <inttypes.h>
 #include "esp_log.h"
 #include "mqtt_client.h"
-
-// Forward declaration for the text area MQTT handler
-static void mqtt_textarea_event_handler(void *handler_args, esp_event_base_t base, int32_t event_id, void *event_data);
+#include "esp_lvgl_port.h"
+#include "mqtt_router.h"
 
 static const char *TAG = "mqtt";
 static esp_mqtt_client_handle_t mqtt_client = NULL;
@@ -60,28 +61,130 @@ esp_err_t mqtt_publish_vacuum_pump_state(bool state)
     return (msg_id >= 0) ? ESP_OK : ESP_FAIL;
 }
 
-static void handle_command_message(const char *topic, const char *data, int data_len)
+#define DIAG_CMD_TOPIC    "esp32_office_controller/diag/cmd"
+#define DIAG_TRACE_TOPIC  "esp32_office_controller/diag/trace"
+#define DIAG_ROUTES_TOPIC "esp32_office_controller/diag/routes"
+
+// Routes of the received messages, compiled once in mqtt_init()
+static mqtt_router_t router;
+
+static bool payload_is(const char *data, size_t data_len, const char *str)
+{
+    return data_len == strlen(str) && memcmp(data, str, data_len) == 0;
+}
+
+#if LV_USE_TRACE
+typedef struct {
+    char *buf;
+    size_t size;
+    size_t len;
+} trace_json_buf_t;
+
+static void trace_json_write_cb(const char *str, uint32_t len, void *user_data)
 {
-    char payload[16] = {0};
-    memcpy(payload, data, data_len < 15 ? data_len : 15);
-    payload[data_len < 15 ? data_len : 15] = '\0';
-    ESP_LOGI(TAG, "Received MQTT command: topic='%s', payload='%s'", topic, payload);
+    trace_json_buf_t *b = user_data;
+    if (b->len + len >= b->size)
+        return;
+    memcpy(b->buf + b->len, str, len);
+    b->len += len;
+}
 
-    if (strstr(topic, "water_valve/cmd") && relay_callback)
+// Runs on the LVGL task, so the trace is read without taking the LVGL lock. The message is only
+// put into the outbox here, the MQTT task sends it.
+static void publish_trace(bool json)
+{
+    size_t size = json ? LV_TRACE_EVENT_CNT * 96 + 64 : 1024;
+    char *buf = malloc(size);
+    if (buf == NULL)
     {
-        bool new_state = (strncmp(data, "ON", data_len) == 0);
-        relay_callback(WATER_VALVE_INDEX, new_state);
+        ESP_LOGE(TAG, "No memory for the trace");
+        return;
     }
-    else if (strstr(topic, "central_vac/cmd") && relay_callback)
+
+    size_t len;
+    if (json)
     {
-        bool new_state = (strncmp(data, "ON", data_len) == 0);
-        relay_callback(CENTRAL_VACUUM_INDEX, new_state);
+        trace_json_buf_t b = {buf, size, 0};
+        lv_trace_export_chrome(trace_json_write_cb, &b);
+        len = b.len;
     }
-    else if (strstr(topic, "vacuum_pump/cmd") && relay_callback)
+    else
     {
-        bool new_state = (strncmp(data, "ON", data_len) == 0);
-        relay_callback(VACUUM_PUMP_INDEX, new_state);
+        len = lv_trace_dump(buf, size);
     }
+
+    if (len)
+        esp_mqtt_client_enqueue(mqtt_client, DIAG_TRACE_TOPIC, buf, len, 0, 0, true);
+    free(buf);
+}
+#endif
+
+// "routes": publish the number of the messages dispatched to each route
+static void publish_route_counts(void)
+{
+    char buf[512];
+    size_t len = 0;
+    uint8_t i;
+    for (i = 0; i < router.route_cnt && len < sizeof(buf); i++)
+    {
+        len += snprintf(buf + len, sizeof(buf) - len, "%s: %" PRIu32 "\n", router.routes[i].pattern,
+                        router.routes[i].count);
+    }
+    if (len < sizeof(buf))
+        len += snprintf(buf + len, sizeof(buf) - len, "unmatched: %" PRIu32 "\n", router.unmatched);
+    len = len < sizeof(buf) ? len : sizeof(buf) - 1;
+    esp_mqtt_client_publish(mqtt_client, DIAG_ROUTES_TOPIC, buf, len, 0, 0);
+}
+
+static void diag_cmd_cb(const char *topic, size_t topic_len, const char *data, size_t data_len, void *user_data)
+{
+    if (payload_is(data, data_len, "routes"))
+    {
+        publish_route_counts();
+        return;
+    }
+#if LV_USE_TRACE
+    // "trace": publish the frame stage statistics as text
+    // "trace_json": publish the last frames as Chrome trace JSON (save it and open it in Perfetto)
+    // "trace_reset": clear the statistics
+    // The trace belongs to the LVGL task, it is served from the UI queue
+    if (payload_is(data, data_len, "trace"))
+        lcd_post_request(MQTT_DIAG_TRACE);
+    else if (payload_is(data, data_len, "trace_json"))
+        lcd_post_request(MQTT_DIAG_TRACE_JSON);
+    else if (payload_is(data, data_len, "trace_reset"))
+        lcd_post_request(MQTT_DIAG_TRACE_RESET);
+#endif
+}
+
+void mqtt_serve_diag_requests(uint32_t requests)
+{
+#if LV_USE_TRACE
+    // Dump before a reset posted in the same frame
+    if (requests & MQTT_DIAG_TRACE)
+        publish_trace(false);
+    if (requests & MQTT_DIAG_TRACE_JSON)
+        publish_trace(true);
+    if (requests & MQTT_DIAG_TRACE_RESET)
+        lv_trace_reset();
+#else
+    (void)requests;
+#endif
+}
+
+// user_data is the index of the relay
+static void relay_cmd_cb(bool on, void *user_data)
+{
+    int relay_index = (int)(intptr_t)user_data;
+    ESP_LOGI(TAG, "Received MQTT command: relay %d %s", relay_index, on ? "ON" : "OFF");
+    if (relay_callback)
+        relay_callback(relay_index, on);
+}
+
+// Log all messages to the log view, format: [TOPIC]: PAYLOAD
+static void log_view_cb(const char *topic, size_t topic_len, const char *data, size_t data_len, void *user_data)
+{
+    lcd_post_log("[%.*s]: %.*s", (int)topic_len, topic, (int)data_len, data);
 }
 
 static void mqtt_publish_discovery_config(void)
@@ -164,18 +267,23 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base, int32_
         esp_mqtt_client_subscribe(mqtt_client, "water_valve/cmd", 1);
         esp_mqtt_client_subscribe(mqtt_client, "central_vac/cmd", 1);
         esp_mqtt_client_subscribe(mqtt_client, "vacuum_pump/cmd", 1);
+        esp_mqtt_client_subscribe(mqtt_client, DIAG_CMD_TOPIC, 0);
+        // Subscribe to all topics (#) to show all HA events in the log view
+        esp_mqtt_client_subscribe(mqtt_client, "#", 1);
         mqtt_publish_discovery_config();
 
         ESP_LOGI(TAG, "MQTT connected");
-        lcd_update_ha_status(true, "192.168.1.206");
+        lcd_post_ha_status(true, "192.168.1.206");
         break;
     case MQTT_EVENT_DISCONNECTED:
         mqtt_connected = false;
         ESP_LOGI(TAG, "MQTT disconnected");
-        lcd_update_ha_status(false, NULL);
+        lcd_post_ha_status(false, NULL);
         break;
     case MQTT_EVENT_DATA:
-        handle_command_message(event->topic, event->data, event->data_len);
+        // Only the first part of the messages longer than the buffer of the client has the topic
+        if (event->current_data_offset == 0)
+            mqtt_router_dispatch(&router, event->topic, event->topic_len, event->data, event->data_len);
         break;
     default:
         break;
@@ -184,19 +292,8 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base, int32_
 
 static void relay_state_change_handler(int relay_index, bool state)
 {
-    // Update the UI and hardware for each relay
-    switch (relay_index)
-    {
-    case WATER_VALVE_INDEX:
-        water_valve_state_cb(relay_index, state);
-        break;
-    case CENTRAL_VACUUM_INDEX:
-        central_vacuum_state_cb(relay_index, state);
-        break;
-    case VACUUM_PUMP_INDEX:
-        vacuum_pump_state_cb(relay_index, state);
-        break;
-    }
+    // Update the switch of the relay with the next frame, without waiting for the LVGL task
+    lcd_post_relay_state(relay_index, state);
 }
 
 esp_err_t mqtt_init(void)
@@ -210,51 +307,16 @@ esp_err_t mqtt_init(void)
     mqtt_client = esp_mqtt_client_init(&mqtt_cfg);
     if (!mqtt_client)
         return ESP_FAIL;
+
+    mqtt_router_init(&router);
+    mqtt_router_add_on_off(&router, "water_valve/cmd", MQTT_ON_PREFIX, relay_cmd_cb, (void *)(intptr_t)WATER_VALVE_INDEX);
+    mqtt_router_add_on_off(&router, "central_vac/cmd", MQTT_ON_PREFIX, relay_cmd_cb, (void *)(intptr_t)CENTRAL_VACUUM_INDEX);
+    mqtt_router_add_on_off(&router, "vacuum_pump/cmd", MQTT_ON_PREFIX, relay_cmd_cb, (void *)(intptr_t)VACUUM_PUMP_INDEX);
+    mqtt_router_add_raw(&router, DIAG_CMD_TOPIC, diag_cmd_cb, NULL);
+    mqtt_router_add_raw(&router, "#", log_view_cb, NULL);
+
     esp_mqtt_client_register_event(mqtt_client, ESP_EVENT_ANY_ID, mqtt_event_handler, NULL);
-    esp_mqtt_client_register_event(mqtt_client, ESP_EVENT_ANY_ID, mqtt_textarea_event_handler, NULL);
     esp_err_t err = esp_mqtt_client_start(mqtt_client);
     mqtt_set_relay_callback(relay_state_change_handler);
     return err;
 }
-
-static void mqtt_textarea_event_handler(void *handler_args, esp_event_base_t base, int32_t event_id, void *event_data) {
-    esp_mqtt_event_handle_t event = event_data;
-    switch ((esp_mqtt_event_id_t)event_id)
-    {
-    case MQTT_EVENT_CONNECTED:
-        // Subscribe to all topics (#) to capture all HA events
-        int msg_id = esp_mqtt_client_subscribe(mqtt_client, "#", 1);
-        ESP_LOGI(TAG, "Textarea handler: Subscribed to all MQTT topics (#), msg_id=%d", msg_id);
-        break;
-    case MQTT_EVENT_DATA:
-    {
-        char topic[256] = {0};
-        char data[256] = {0};
-        char event_text[1024] = {0};  // Increased size to prevent truncation
-        int tlen = event->topic_len < 255 ? event->topic_len : 255;
-        int dlen = event->data_len < 255 ? event->data_len : 255;
-        memcpy(topic, event->topic, tlen); topic[tlen] = '\0';
-        memcpy(data, event->data, dlen); data[dlen] = '\0';
-
-        // Log ALL MQTT messages (for debugging)
-        ESP_LOGI(TAG, "Textarea handler received MQTT data: topic='%s', payload='%s'", topic, data);
-
-        // Log ALL MQTT messages to the text area (no filtering for motion)
-        // Format: [TOPIC]: PAYLOAD
-        snprintf(event_text, sizeof(event_text), "[%s]: %s", topic, data);
-        lcd_append_motion_event(event_text);
-
-        // Still trigger camera fetch only for motion events (if desired)
-        bool is_motion_event = (strstr(topic, "motion") != NULL || strstr(topic, "binary_sensor") != NULL);
-        if (is_motion_event) {
-            extern void camera_client_fetch_image(void);
-            //camera_client_fetch_image();
-        }
-        break;
-    }
-    default:
-        // Log unhandled MQTT events (e.g., MQTT_EVENT_DISCONNECTED, MQTT_EVENT_ERROR, etc.)
-        ESP_LOGW(TAG, "Textarea handler: Unhandled MQTT event ID=%ld", (long)event_id);
-        break;
-    }
-}
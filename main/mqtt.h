@@ -1,6 +1,7 @@
 #ifndef MQTT_H
 #define MQTT_H
 #include <stdbool.h>
+#include <stdint.h>
 #include "esp_err.h"
 
 #ifdef __cplusplus
@@ -16,6 +17,12 @@ esp_err_t mqtt_publish_central_vacuum_state(bool state);
 esp_err_t mqtt_publish_water_valve_state(bool state);
 esp_err_t mqtt_publish_vacuum_pump_state(bool state);
 
+// Diagnostic requests received on the diag topic, served on the LVGL task (see lcd_post_request())
+#define MQTT_DIAG_TRACE        (1u << 0)  // Publish the frame stage statistics as text
+#define MQTT_DIAG_TRACE_JSON   (1u << 1)  // Publish the last frames as Chrome trace JSON
+#define MQTT_DIAG_TRACE_RESET  (1u << 2)  // Clear the statistics
+void mqtt_serve_diag_requests(uint32_t requests);
+
 
 #ifdef __cplusplus
 }
@@ -5,9 +5,12 @@
 #include <esp_err.h>
 #include <mqtt_client.h>
 #include "mqtt_relay_client.h"
+#include "mqtt_router.h"
 
 #define NUM_RELAYS 3
 static const char* relay_ids[NUM_RELAYS] = { "vacuum_pump", "central_vac", "water_valve" };
+static const char* relay_cmd_topics[NUM_RELAYS] = { "vacuum_pump/cmd", "central_vac/cmd", "water_valve/cmd" };
+static mqtt_router_t router;
 static bool relay_states[NUM_RELAYS] = {false};
 static esp_mqtt_client_handle_t mqtt_client = NULL;
 static bool mqtt_connected = false;
@@ -18,20 +21,12 @@ void set_relay_state_change_callback(relay_state_change_callback_t cb) {
     relay_state_cb = cb;
 }
 
-static void handle_command_message(const char* topic, const char* data, int data_len) {
-    if (!topic || !data || data_len <= 0) return;
-    for (int i = 0; i < NUM_RELAYS; i++) {
-        char expected_topic[64];
-        snprintf(expected_topic, sizeof(expected_topic), "%s/cmd", relay_ids[i]);
-        if (strcmp(topic, expected_topic) == 0) {
-            bool new_state = (strncmp(data, "ON", 2) == 0);
-            relay_states[i] = new_state;
-            if (relay_state_cb) relay_state_cb(i, new_state);
-            ESP_LOGI(TAG, "Relay %d set to %s", i+1, new_state ? "ON" : "OFF");
-            return;
-        }
-    }
-    ESP_LOGW(TAG, "Unknown relay topic: %s", topic);
+// user_data is the index of the relay
+static void relay_cmd_cb(bool on, void *user_data) {
+    int i = (int)(intptr_t)user_data;
+    relay_states[i] = on;
+    if (relay_state_cb) relay_state_cb(i, on);
+    ESP_LOGI(TAG, "Relay %d set to %s", i+1, on ? "ON" : "OFF");
 }
 
 static void mqtt_event_handler(void *handler_args, esp_event_base_t base, int32_t event_id, void *event_data) {
@@ -39,10 +34,8 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base, int32_
     switch ((esp_mqtt_event_id_t)event_id) {
     case MQTT_EVENT_CONNECTED: {
         mqtt_connected = true;
-        char topic[64];
         for (int i = 0; i < NUM_RELAYS; i++) {
-            snprintf(topic, sizeof(topic), "%s/cmd", relay_ids[i]);
-            esp_mqtt_client_subscribe(mqtt_client, topic, 1);
+            esp_mqtt_client_subscribe(mqtt_client, relay_cmd_topics[i], 1);
         }
         ESP_LOGI(TAG, "MQTT connected and subscribed");
         break;
@@ -51,16 +44,12 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base, int32_
         mqtt_connected = false;
         ESP_LOGI(TAG, "MQTT disconnected");
         break;
-    case MQTT_EVENT_DATA: {
-        char topic[256] = {0};
-        char data[256] = {0};
-        int tlen = event->topic_len < 255 ? event->topic_len : 255;
-        int dlen = event->data_len < 255 ? event->data_len : 255;
-        memcpy(topic, event->topic, tlen); topic[tlen] = '\0';
-        memcpy(data, event->data, dlen); data[dlen] = '\0';
-        handle_command_message(topic, data, dlen);
+    case MQTT_EVENT_DATA:
+        if (event->current_data_offset == 0 &&
+            mqtt_router_dispatch(&router, event->topic, event->topic_len, event->data, event->data_len) == 0) {
+            ESP_LOGW(TAG, "Unknown relay topic: %.*s", event->topic_len, event->topic);
+        }
         break;
-    }
     default:
         break;
     }
@@ -76,6 +65,10 @@ esp_err_t mqtt_init(void) {
     };
     mqtt_client = esp_mqtt_client_init(&mqtt_cfg);
     if (!mqtt_client) return ESP_FAIL;
+    mqtt_router_init(&router);
+    for (int i = 0; i < NUM_RELAYS; i++) {
+        mqtt_router_add_on_off(&router, relay_cmd_topics[i], MQTT_ON_STARTS, relay_cmd_cb, (void *)(intptr_t)i);
+    }
     esp_mqtt_client_register_event(mqtt_client, ESP_EVENT_ANY_ID, mqtt_event_handler, NULL);
     esp_err_t err = esp_mqtt_client_start(mqtt_client);
     mqtt_connected = (err == ESP_OK);
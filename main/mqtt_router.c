@@ -0,0 +1,226 @@
+#include "mqtt_router.h"
+#include <string.h>
+
+void mqtt_router_init(mqtt_router_t *router)
+{
+    memset(router, 0, sizeof(*router));
+    router->node_cnt = 1;  // The root, the level before the first one
+}
+
+static int new_node(mqtt_router_t *router, const char *level, size_t level_len)
+{
+    if (router->node_cnt >= MQTT_ROUTER_NODES_MAX) {
+        return -1;
+    }
+    mqtt_router_node_t *node = &router->nodes[router->node_cnt];
+    memset(node, 0, sizeof(*node));
+    node->level = level;
+    node->level_len = (uint8_t)level_len;
+    return router->node_cnt++;
+}
+
+// Append a route to the end of a route list, so the routes are called in the order they were added
+static void append_route(mqtt_router_t *router, uint8_t *first, uint8_t route)
+{
+    while (*first) {
+        first = &router->routes[*first - 1].next;
+    }
+    *first = route + 1;
+}
+
+// The child of node `n` for a level of a pattern, 0: none yet
+static uint8_t find_child(const mqtt_router_t *router, uint8_t n, const char *level, size_t len)
+{
+    if (len == 1 && level[0] == '+') {
+        return router->nodes[n].plus;
+    }
+    uint8_t child = router->nodes[n].child;
+    while (child && (router->nodes[child].level_len != len || memcmp(router->nodes[child].level, level, len) != 0)) {
+        child = router->nodes[child].sibling;
+    }
+    return child;
+}
+
+// Compile the pattern and add a route for it, the caller sets the handler
+static mqtt_route_t *add_route(mqtt_router_t *router, const char *pattern, mqtt_route_type_t type, void *user_data)
+{
+    if (!pattern || !pattern[0] || router->route_cnt >= MQTT_ROUTER_ROUTES_MAX) {
+        return NULL;
+    }
+
+    // Check the whole pattern and count its new nodes first, so nothing is left behind if it can't be added
+    const char *p = pattern;
+    uint8_t n = 0;
+    size_t new_cnt = 0;
+    while (1) {
+        const char *slash = strchr(p, '/');
+        size_t len = slash ? (size_t)(slash - p) : strlen(p);
+        if (len > UINT8_MAX) {
+            return NULL;
+        }
+        // The wildcards must be whole levels and '#' the last one
+        if ((memchr(p, '+', len) && len != 1) || (memchr(p, '#', len) && (len != 1 || slash))) {
+            return NULL;
+        }
+        if (len == 1 && p[0] == '#') {
+            break;
+        }
+        // Below a new node all nodes are new
+        n = new_cnt ? 0 : find_child(router, n, p, len);
+        if (n == 0) {
+            new_cnt++;
+        }
+        if (!slash) {
+            break;
+        }
+        p = slash + 1;
+    }
+    if (router->node_cnt + new_cnt > MQTT_ROUTER_NODES_MAX) {
+        return NULL;
+    }
+
+    n = 0;
+    uint8_t *route_list = NULL;
+    p = pattern;
+    while (1) {
+        const char *slash = strchr(p, '/');
+        size_t len = slash ? (size_t)(slash - p) : strlen(p);
+
+        if (len == 1 && p[0] == '#') {
+            route_list = &router->nodes[n].hash_route;
+            break;
+        }
+
+        // The nodes were counted above, new_node() can't fail
+        uint8_t child = find_child(router, n, p, len);
+        if (child == 0) {
+            child = (uint8_t)new_node(router, p, len);
+            if (len == 1 && p[0] == '+') {
+                router->nodes[n].plus = child;
+            } else {
+                router->nodes[child].sibling = router->nodes[n].child;
+                router->nodes[n].child = child;
+            }
+        }
+        n = child;
+
+        if (!slash) {
+            route_list = &router->nodes[n].route;
+            break;
+        }
+        p = slash + 1;
+    }
+
+    uint8_t id = router->route_cnt++;
+    mqtt_route_t *route = &router->routes[id];
+    memset(route, 0, sizeof(*route));
+    route->pattern = pattern;
+    route->type = type;
+    route->user_data = user_data;
+    append_route(router, route_list, id);
+    return route;
+}
+
+int mqtt_router_add_raw(mqtt_router_t *router, const char *pattern, mqtt_route_raw_cb_t cb, void *user_data)
+{
+    mqtt_route_t *route = cb ? add_route(router, pattern, MQTT_ROUTE_RAW, user_data) : NULL;
+    if (!route) {
+        return -1;
+    }
+    route->handler.raw = cb;
+    return (int)(route - router->routes);
+}
+
+int mqtt_router_add_on_off(mqtt_router_t *router, const char *pattern, mqtt_on_match_t on_match,
+                           mqtt_route_on_off_cb_t cb, void *user_data)
+{
+    mqtt_route_t *route = cb ? add_route(router, pattern, MQTT_ROUTE_ON_OFF, user_data) : NULL;
+    if (!route) {
+        return -1;
+    }
+    route->on_match = on_match;
+    route->handler.on_off = cb;
+    return (int)(route - router->routes);
+}
+
+typedef struct {
+    const char *topic;
+    size_t topic_len;
+    const char *data;
+    size_t data_len;
+} mqtt_router_msg_t;
+
+static bool payload_is_on(mqtt_on_match_t on_match, const char *data, size_t data_len)
+{
+    if (on_match == MQTT_ON_STARTS) {
+        return data_len >= 2 && memcmp(data, "ON", 2) == 0;
+    }
+    return data_len <= 2 && memcmp(data, "ON", data_len) == 0;
+}
+
+static int call_routes(mqtt_router_t *router, uint8_t first, const mqtt_router_msg_t *msg)
+{
+    int cnt = 0;
+    while (first) {
+        mqtt_route_t *route = &router->routes[first - 1];
+        route->count++;
+        if (route->type == MQTT_ROUTE_ON_OFF) {
+            if (msg->data_len > 0 || route->on_match != MQTT_ON_STARTS) {
+                route->handler.on_off(payload_is_on(route->on_match, msg->data, msg->data_len), route->user_data);
+            }
+        } else {
+            route->handler.raw(msg->topic, msg->topic_len, msg->data, msg->data_len, route->user_data);
+        }
+        first = route->next;
+        cnt++;
+    }
+    return cnt;
+}
+
+// Match the levels of the topic from `level` against the children of node `n`.
+// `done` is set when all levels are matched.
+static int dispatch_node(mqtt_router_t *router, uint8_t n, const char *level, bool done, const mqtt_router_msg_t *msg)
+{
+    const mqtt_router_node_t *node = &router->nodes[n];
+    const char *end = msg->topic + msg->topic_len;
+    // The wildcards don't match the first level of the topics starting with '$' (e.g. "$SYS/...")
+    bool sys = (n == 0 && level < end && level[0] == '$');
+    int cnt = 0;
+
+    // '#' matches the parent level too, e.g. "a/#" matches "a"
+    if (node->hash_route && !sys) {
+        cnt += call_routes(router, node->hash_route, msg);
+    }
+    if (done) {
+        return cnt + call_routes(router, node->route, msg);
+    }
+
+    const char *slash = memchr(level, '/', end - level);
+    size_t len = slash ? (size_t)(slash - level) : (size_t)(end - level);
+    const char *next = slash ? slash + 1 : end;
+
+    uint8_t child;
+    for (child = node->child; child; child = router->nodes[child].sibling) {
+        if (router->nodes[child].level_len == len && memcmp(router->nodes[child].level, level, len) == 0) {
+            cnt += dispatch_node(router, child, next, !slash, msg);
+            break;  // The levels of the children are unique
+        }
+    }
+    if (node->plus && !sys) {
+        cnt += dispatch_node(router, node->plus, next, !slash, msg);
+    }
+    return cnt;
+}
+
+int mqtt_router_dispatch(mqtt_router_t *router, const char *topic, size_t topic_len, const char *data, size_t data_len)
+{
+    if (!topic || topic_len == 0) {
+        return 0;
+    }
+    const mqtt_router_msg_t msg = {topic, topic_len, data, data_len};
+    int cnt = dispatch_node(router, 0, topic, false, &msg);
+    if (cnt == 0) {
+        router->unmatched++;
+    }
+    return cnt;
+}
@@ -0,0 +1,85 @@
+#ifndef MQTT_ROUTER_H
+#define MQTT_ROUTER_H
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MQTT_ROUTER_NODES_MAX 64   // Topic levels of all patterns, the shared prefixes are stored once
+#define MQTT_ROUTER_ROUTES_MAX 16
+
+typedef enum {
+    MQTT_ROUTE_RAW,     // handler.raw gets the topic and the payload
+    MQTT_ROUTE_ON_OFF,  // handler.on_off gets if the payload is ON, see mqtt_on_match_t
+} mqtt_route_type_t;
+
+// What an ON_OFF route takes for ON. The clients kept the payload rules of their handlers before the router.
+typedef enum {
+    MQTT_ON_PREFIX,     // "ON" or a prefix of it, also "O" and the empty payload (strncmp(data, "ON", data_len) of mqtt.c)
+    MQTT_ON_STARTS,     // Payloads starting with "ON", also "ONX". Empty payloads are ignored, the handler
+                        // isn't called (strncmp(data, "ON", 2) of mqtt_relay_client.c)
+} mqtt_on_match_t;
+
+// The topic and the payload point into the received message, they are not '\0' terminated
+typedef void (*mqtt_route_raw_cb_t)(const char *topic, size_t topic_len, const char *data, size_t data_len,
+                                    void *user_data);
+typedef void (*mqtt_route_on_off_cb_t)(bool on, void *user_data);
+
+typedef struct {
+    const char *pattern;
+    mqtt_route_type_t type;
+    mqtt_on_match_t on_match;   // Only for ON_OFF
+    union {
+        mqtt_route_raw_cb_t raw;
+        mqtt_route_on_off_cb_t on_off;
+    } handler;
+    void *user_data;
+    uint32_t count;     // Number of the matching messages
+    uint8_t next;       // Next route of the same pattern + 1, 0: none
+} mqtt_route_t;
+
+// One level of a pattern, e.g. "cmd" of "water_valve/cmd"
+typedef struct {
+    const char *level;  // Points into the pattern
+    uint8_t level_len;
+    uint8_t child;      // First child, 0: none (the root can't be a child)
+    uint8_t sibling;    // Next child of the parent, 0: none
+    uint8_t plus;       // Child for the '+' wildcard, 0: none
+    uint8_t route;      // First route ending at this level + 1, 0: none
+    uint8_t hash_route; // First route of '#' below this level + 1, 0: none
+} mqtt_router_node_t;
+
+// Dispatches MQTT messages to the handlers of the subscription patterns matching their topics.
+// The patterns are compiled into a trie of topic levels, so a message is matched by walking
+// its topic once, without copying or formatting it. A message is dispatched to every matching
+// route, like the broker delivers it to every matching subscription.
+typedef struct {
+    mqtt_router_node_t nodes[MQTT_ROUTER_NODES_MAX];
+    uint8_t node_cnt;
+    mqtt_route_t routes[MQTT_ROUTER_ROUTES_MAX];
+    uint8_t route_cnt;
+    uint32_t unmatched;  // Number of the messages without a matching route
+} mqtt_router_t;
+
+void mqtt_router_init(mqtt_router_t *router);
+
+// Add a route for a subscription pattern, e.g. "homeassistant/+/motion/#". The pattern is not
+// copied, it must stay valid (e.g. a string literal). Returns the index of the route, or -1 if
+// the pattern is invalid or the router is full.
+int mqtt_router_add_raw(mqtt_router_t *router, const char *pattern, mqtt_route_raw_cb_t cb, void *user_data);
+int mqtt_router_add_on_off(mqtt_router_t *router, const char *pattern, mqtt_on_match_t on_match,
+                           mqtt_route_on_off_cb_t cb, void *user_data);
+
+// Call the handlers of the routes matching `topic`. Returns the number of the matching routes, also
+// the ones which ignored the payload.
+int mqtt_router_dispatch(mqtt_router_t *router, const char *topic, size_t topic_len, const char *data,
+                         size_t data_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MQTT_ROUTER_H
@@ -0,0 +1,406 @@
+#include "ui_assets.h"
+#include <string.h>
+#include <stdint.h>
+#include "sdkconfig.h"
+#include "esp_log.h"
+#include "esp_check.h"
+#include "esp_mmap_assets.h"
+
+static const char *TAG = "UI_ASSETS";
+
+#define UI_ASSETS_FILES_MAX 1024    // An erased or foreign partition has a garbage file count
+
+// The font layout written by tools/ui_assets_pack.py. Offsets are from the start of the payload.
+#define UI_FONT_MAGIC "UFNT"
+#define UI_FONT_VERSION 1
+
+typedef struct {
+    char magic[4];
+    uint16_t version;
+    uint16_t glyph_dsc_size;        // sizeof(lv_font_fmt_txt_glyph_dsc_t) of LV_FONT_FMT_TXT_LARGE
+    int16_t line_height;
+    int16_t base_line;
+    int8_t underline_position;
+    int8_t underline_thickness;
+    uint8_t subpx;
+    uint8_t bpp;
+    uint8_t bitmap_format;
+    uint8_t kern_classes;
+    uint16_t kern_scale;
+    uint16_t cmap_num;
+    uint16_t glyph_cnt;
+    uint32_t glyph_dsc_ofs;         // lv_font_fmt_txt_glyph_dsc_t[glyph_cnt]
+    uint32_t bitmap_ofs;
+    uint32_t cmap_ofs;              // ui_font_cmap_t[cmap_num]
+    uint32_t kern_ofs;              // ui_font_kern_pairs_t or ui_font_kern_classes_t, 0: no kerning
+} ui_font_header_t;
+
+typedef struct {
+    uint32_t range_start;
+    uint16_t range_length;
+    uint16_t glyph_id_start;
+    uint16_t list_length;
+    uint8_t type;
+    uint8_t reserved;
+    uint32_t unicode_list_ofs;      // 0: none
+    uint32_t glyph_id_ofs_list_ofs; // 0: none
+} ui_font_cmap_t;
+
+typedef struct {
+    uint32_t pair_cnt;
+    uint8_t glyph_ids_size;
+    uint8_t reserved[3];
+    uint32_t glyph_ids_ofs;
+    uint32_t values_ofs;
+} ui_font_kern_pairs_t;
+
+typedef struct {
+    uint8_t left_class_cnt;
+    uint8_t right_class_cnt;
+    uint16_t mapping_length;        // Of each class mapping: one class per glyph ID
+    uint32_t left_class_mapping_ofs;
+    uint32_t right_class_mapping_ofs;
+    uint32_t class_pair_values_ofs;
+} ui_font_kern_classes_t;
+
+// Everything a loaded font keeps in RAM, in one allocation
+typedef struct {
+    lv_font_t font;
+    lv_font_fmt_txt_dsc_t dsc;
+    lv_font_fmt_txt_glyph_cache_t cache;
+    union {
+        lv_font_fmt_txt_kern_pair_t pairs;
+        lv_font_fmt_txt_kern_classes_t classes;
+    } kern;
+    lv_font_fmt_txt_cmap_t cmaps[];
+} ui_font_t;
+
+static mmap_assets_handle_t assets;
+static int asset_cnt;
+
+static lv_res_t decoder_info(lv_img_decoder_t *decoder, const void *src, lv_img_header_t *header);
+static lv_res_t decoder_open(lv_img_decoder_t *decoder, lv_img_decoder_dsc_t *dsc);
+static lv_res_t decoder_read_line(lv_img_decoder_t *decoder, lv_img_decoder_dsc_t *dsc,
+                                  lv_coord_t x, lv_coord_t y, lv_coord_t len, uint8_t *buf);
+
+esp_err_t ui_assets_init(const char *partition_label)
+{
+    ESP_RETURN_ON_FALSE(assets == NULL, ESP_ERR_INVALID_STATE, TAG, "Already initialized");
+
+    // The table can only be walked with the right file count, so open it once to read the count
+    mmap_assets_config_t config = {
+        .partition_label = partition_label,
+        .max_files = 1,
+        .flags = {.mmap_enable = 1},
+    };
+    mmap_assets_handle_t probe;
+    ESP_RETURN_ON_ERROR(mmap_assets_new(&config, &probe), TAG, "Can't map the \"%s\" partition", partition_label);
+    int stored_files = mmap_assets_get_stored_files(probe);
+    mmap_assets_del(probe);
+    ESP_RETURN_ON_FALSE(stored_files > 0 && stored_files <= UI_ASSETS_FILES_MAX, ESP_ERR_NOT_FOUND, TAG,
+                        "No assets in the \"%s\" partition", partition_label);
+
+    config.max_files = stored_files;
+    config.flags.metadata_check = 1;
+    ESP_RETURN_ON_ERROR(mmap_assets_new(&config, &assets), TAG, "Bad assets in the \"%s\" partition", partition_label);
+    asset_cnt = stored_files;
+
+    lv_img_decoder_t *dec = lv_img_decoder_create();
+    if (dec == NULL) {
+        mmap_assets_del(assets);
+        assets = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    lv_img_decoder_set_info_cb(dec, decoder_info);
+    lv_img_decoder_set_open_cb(dec, decoder_open);
+    lv_img_decoder_set_read_line_cb(dec, decoder_read_line);
+    // No close callback: the pixels stay in flash, so the image cache keeps the pointer instead of a copy
+
+    ESP_LOGI(TAG, "%d assets in \"%s\"", asset_cnt, partition_label);
+    return ESP_OK;
+}
+
+const void *ui_assets_get(const char *name, size_t *size)
+{
+    if (assets == NULL || strlen(name) > CONFIG_MMAP_FILE_NAME_LENGTH) {
+        return NULL;
+    }
+    int i;
+    for (i = 0; i < asset_cnt; i++) {
+        // The names of the table are only NUL terminated if they are shorter than the field
+        if (strncmp(mmap_assets_get_name(assets, i), name, CONFIG_MMAP_FILE_NAME_LENGTH) == 0) {
+            if (size) {
+                *size = mmap_assets_get_size(assets, i);
+            }
+            return mmap_assets_get_mem(assets, i);
+        }
+    }
+    return NULL;
+}
+
+/**********************
+ *  Images
+ **********************/
+
+// The packed LVGL image of an "M:name" source, or NULL if it's not one
+static const uint8_t *img_find(const void *src)
+{
+    if (lv_img_src_get_type(src) != LV_IMG_SRC_FILE ||
+        strncmp(src, UI_ASSETS_DRIVE, sizeof(UI_ASSETS_DRIVE) - 1) != 0) {
+        return NULL;
+    }
+    const char *name = (const char *)src + sizeof(UI_ASSETS_DRIVE) - 1;
+    size_t size;
+    const uint8_t *data = ui_assets_get(name, &size);
+    if (data == NULL) {
+        return NULL;
+    }
+
+    lv_img_header_t header;
+    if (size < sizeof(header)) {
+        ESP_LOGW(TAG, "\"%s\" is not an image", name);
+        return NULL;
+    }
+    memcpy(&header, data, sizeof(header));
+    switch (header.always_zero ? LV_IMG_CF_UNKNOWN : header.cf) {
+    case LV_IMG_CF_TRUE_COLOR:
+    case LV_IMG_CF_TRUE_COLOR_ALPHA:
+    case LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED:
+    case LV_IMG_CF_ALPHA_8BIT:
+#if LV_COLOR_DEPTH == 16
+    case LV_IMG_CF_RGB565A8:
+#endif
+        break;
+    default:
+        ESP_LOGW(TAG, "\"%s\" is not an image of a supported color format", name);
+        return NULL;
+    }
+    if (size < sizeof(header) + lv_img_buf_get_img_size(header.w, header.h, header.cf) || ((uintptr_t)data & 3)) {
+        ESP_LOGW(TAG, "\"%s\" is truncated or not aligned, packed for another color depth?", name);
+        return NULL;
+    }
+    return data;
+}
+
+static lv_res_t decoder_info(lv_img_decoder_t *decoder, const void *src, lv_img_header_t *header)
+{
+    LV_UNUSED(decoder);
+    const uint8_t *data = img_find(src);
+    if (data == NULL) {
+        return LV_RES_INV;
+    }
+    memcpy(header, data, sizeof(*header));
+    return LV_RES_OK;
+}
+
+static lv_res_t decoder_open(lv_img_decoder_t *decoder, lv_img_decoder_dsc_t *dsc)
+{
+    LV_UNUSED(decoder);
+    const uint8_t *data = img_find(dsc->src);
+    if (data == NULL) {
+        return LV_RES_INV;
+    }
+    // The pixels are used where they are in flash
+    dsc->img_data = data + sizeof(lv_img_header_t);
+    return LV_RES_OK;
+}
+
+// Only needed for A8 images drawn transformed: LVGL reads them as colored pixels with alpha then
+static lv_res_t decoder_read_line(lv_img_decoder_t *decoder, lv_img_decoder_dsc_t *dsc,
+                                  lv_coord_t x, lv_coord_t y, lv_coord_t len, uint8_t *buf)
+{
+    LV_UNUSED(decoder);
+    if (dsc->header.cf != LV_IMG_CF_ALPHA_8BIT) {
+        return LV_RES_INV;
+    }
+    const uint8_t *alpha = dsc->img_data + (uint32_t)y * dsc->header.w + x;
+    lv_coord_t i;
+    for (i = 0; i < len; i++) {
+        memcpy(buf, &dsc->color, sizeof(lv_color_t));
+        buf[LV_IMG_PX_SIZE_ALPHA_BYTE - 1] = alpha[i];
+        buf += LV_IMG_PX_SIZE_ALPHA_BYTE;
+    }
+    return LV_RES_OK;
+}
+
+/**********************
+ *  Fonts
+ **********************/
+
+// The length is 64 bit, so the products of the counts and sizes can't wrap
+static bool font_range_ok(size_t size, uint32_t ofs, uint64_t len)
+{
+    return ofs <= size && len <= size - ofs;
+}
+
+// The most bytes LVGL reads from the bitmap of a glyph. A compressed bitmap is read bit by bit until
+// the glyph is complete: at most bpp + 2 bits per pixel (see rle_next()) and one byte ahead.
+static uint32_t font_glyph_bitmap_max(const ui_font_header_t *hdr, const lv_font_fmt_txt_glyph_dsc_t *glyph)
+{
+    uint32_t px_cnt = (uint32_t)glyph->box_w * glyph->box_h;
+    if (px_cnt == 0) {
+        return 0;
+    }
+    if (hdr->bitmap_format == LV_FONT_FMT_TXT_PLAIN) {
+        return (px_cnt * hdr->bpp + 7) / 8;
+    }
+    return (px_cnt * (hdr->bpp + 2) + 7) / 8 + 1;
+}
+
+lv_font_t *ui_assets_font_load(const char *name)
+{
+    size_t size;
+    const uint8_t *data = ui_assets_get(name, &size);
+    if (data == NULL) {
+        ESP_LOGW(TAG, "No font \"%s\"", name);
+        return NULL;
+    }
+
+    const ui_font_header_t *hdr = (const ui_font_header_t *)data;
+    if (size < sizeof(*hdr) || memcmp(hdr->magic, UI_FONT_MAGIC, 4) != 0 || ((uintptr_t)data & 3)) {
+        ESP_LOGW(TAG, "\"%s\" is not a font", name);
+        return NULL;
+    }
+    if (hdr->version != UI_FONT_VERSION || hdr->glyph_dsc_size != sizeof(lv_font_fmt_txt_glyph_dsc_t)) {
+        ESP_LOGW(TAG, "\"%s\" was packed for another version or LV_FONT_FMT_TXT_LARGE", name);
+        return NULL;
+    }
+    bool ok = hdr->bitmap_format <= LV_FONT_FMT_TXT_COMPRESSED && hdr->bpp <= 8 &&
+              (hdr->glyph_dsc_ofs & 3) == 0 && (hdr->cmap_ofs & 3) == 0 && (hdr->kern_ofs & 3) == 0 &&
+              font_range_ok(size, hdr->glyph_dsc_ofs, (uint64_t)hdr->glyph_cnt * sizeof(lv_font_fmt_txt_glyph_dsc_t)) &&
+              font_range_ok(size, hdr->cmap_ofs, (uint64_t)hdr->cmap_num * sizeof(ui_font_cmap_t)) &&
+              font_range_ok(size, hdr->bitmap_ofs, 0);
+#if LV_USE_FONT_COMPRESSED == 0
+    ok = ok && hdr->bitmap_format == LV_FONT_FMT_TXT_PLAIN;
+#endif
+    // LVGL doesn't check the glyphs while drawing, so none may point outside of the payload
+    const lv_font_fmt_txt_glyph_dsc_t *glyphs = (const lv_font_fmt_txt_glyph_dsc_t *)(data + hdr->glyph_dsc_ofs);
+    uint32_t g;
+    for (g = 0; ok && g < hdr->glyph_cnt; g++) {
+        uint32_t len = font_glyph_bitmap_max(hdr, &glyphs[g]);
+        ok = len == 0 || font_range_ok(size - hdr->bitmap_ofs, glyphs[g].bitmap_index, len);
+    }
+
+    ui_font_t *f = ok ? lv_mem_alloc(sizeof(ui_font_t) + hdr->cmap_num * sizeof(lv_font_fmt_txt_cmap_t)) : NULL;
+    if (!ok) {
+        ESP_LOGW(TAG, "\"%s\" is corrupted", name);
+        return NULL;
+    }
+    if (f == NULL) {
+        ESP_LOGW(TAG, "Not enough memory for \"%s\"", name);
+        return NULL;
+    }
+    lv_memset_00(f, sizeof(ui_font_t) + hdr->cmap_num * sizeof(lv_font_fmt_txt_cmap_t));
+
+    // Only these descriptors are in RAM, the glyph descriptors, bitmaps and lists point into flash.
+    // The glyph IDs reachable through them index glyph_dsc, so they are checked too.
+    const ui_font_cmap_t *cmaps = (const ui_font_cmap_t *)(data + hdr->cmap_ofs);
+    int i;
+    for (i = 0; ok && i < hdr->cmap_num; i++) {
+        lv_font_fmt_txt_cmap_t *cmap = &f->cmaps[i];
+        cmap->range_start = cmaps[i].range_start;
+        cmap->range_length = cmaps[i].range_length;
+        cmap->glyph_id_start = cmaps[i].glyph_id_start;
+        cmap->list_length = cmaps[i].list_length;
+        cmap->type = cmaps[i].type;
+
+        bool sparse = cmap->type == LV_FONT_FMT_TXT_CMAP_SPARSE_TINY || cmap->type == LV_FONT_FMT_TXT_CMAP_SPARSE_FULL;
+        bool id_list = cmap->type == LV_FONT_FMT_TXT_CMAP_FORMAT0_FULL || cmap->type == LV_FONT_FMT_TXT_CMAP_SPARSE_FULL;
+        // The format 0 tables are indexed by the code point, the sparse ones by the position in the unicode list
+        uint32_t entry_cnt = sparse ? cmap->list_length : cmap->range_length;
+        ok = cmap->type <= LV_FONT_FMT_TXT_CMAP_SPARSE_TINY;
+        if (ok && sparse) {
+            ok = cmaps[i].unicode_list_ofs != 0 && (cmaps[i].unicode_list_ofs & 1) == 0 &&
+                 font_range_ok(size, cmaps[i].unicode_list_ofs, (uint64_t)entry_cnt * sizeof(uint16_t));
+            cmap->unicode_list = (const uint16_t *)(data + cmaps[i].unicode_list_ofs);
+        }
+
+        uint32_t max_ofs = entry_cnt ? entry_cnt - 1 : 0;
+        if (ok && id_list) {
+            // uint8_t IDs for the format 0 tables, uint16_t for the sparse ones
+            uint32_t id_size = sparse ? sizeof(uint16_t) : sizeof(uint8_t);
+            ok = cmaps[i].glyph_id_ofs_list_ofs != 0 && (cmaps[i].glyph_id_ofs_list_ofs & (id_size - 1)) == 0 &&
+                 font_range_ok(size, cmaps[i].glyph_id_ofs_list_ofs, (uint64_t)entry_cnt * id_size);
+            cmap->glyph_id_ofs_list = data + cmaps[i].glyph_id_ofs_list_ofs;
+            uint32_t e;
+            for (max_ofs = 0, e = 0; ok && e < entry_cnt; e++) {
+                uint32_t ofs = sparse ? ((const uint16_t *)cmap->glyph_id_ofs_list)[e] :
+                               ((const uint8_t *)cmap->glyph_id_ofs_list)[e];
+                max_ofs = LV_MAX(max_ofs, ofs);
+            }
+        }
+        ok = ok && (entry_cnt == 0 || cmap->glyph_id_start + max_ofs < hdr->glyph_cnt);
+    }
+
+    if (ok && hdr->kern_ofs && hdr->kern_classes == 0) {
+        const ui_font_kern_pairs_t *kern = (const ui_font_kern_pairs_t *)(data + hdr->kern_ofs);
+        ok = font_range_ok(size, hdr->kern_ofs, sizeof(*kern)) &&
+             font_range_ok(size, kern->glyph_ids_ofs, (uint64_t)kern->pair_cnt * 2 * (kern->glyph_ids_size ? 2 : 1)) &&
+             font_range_ok(size, kern->values_ofs, kern->pair_cnt);
+        if (ok) {
+            f->kern.pairs.glyph_ids = data + kern->glyph_ids_ofs;
+            f->kern.pairs.values = (const int8_t *)(data + kern->values_ofs);
+            f->kern.pairs.pair_cnt = kern->pair_cnt;
+            f->kern.pairs.glyph_ids_size = kern->glyph_ids_size;
+            f->dsc.kern_dsc = &f->kern.pairs;
+        }
+    } else if (ok && hdr->kern_ofs) {
+        const ui_font_kern_classes_t *kern = (const ui_font_kern_classes_t *)(data + hdr->kern_ofs);
+        ok = font_range_ok(size, hdr->kern_ofs, sizeof(*kern)) && kern->mapping_length >= hdr->glyph_cnt &&
+             font_range_ok(size, kern->left_class_mapping_ofs, kern->mapping_length) &&
+             font_range_ok(size, kern->right_class_mapping_ofs, kern->mapping_length) &&
+             font_range_ok(size, kern->class_pair_values_ofs, kern->left_class_cnt * kern->right_class_cnt);
+        // The classes index class_pair_values
+        const uint8_t *left = data + kern->left_class_mapping_ofs;
+        const uint8_t *right = data + kern->right_class_mapping_ofs;
+        for (g = 0; ok && g < kern->mapping_length; g++) {
+            ok = left[g] <= kern->left_class_cnt && right[g] <= kern->right_class_cnt;
+        }
+        if (ok) {
+            f->kern.classes.left_class_mapping = data + kern->left_class_mapping_ofs;
+            f->kern.classes.right_class_mapping = data + kern->right_class_mapping_ofs;
+            f->kern.classes.class_pair_values = (const int8_t *)(data + kern->class_pair_values_ofs);
+            f->kern.classes.left_class_cnt = kern->left_class_cnt;
+            f->kern.classes.right_class_cnt = kern->right_class_cnt;
+            f->dsc.kern_dsc = &f->kern.classes;
+        }
+    }
+    if (!ok) {
+        ESP_LOGW(TAG, "\"%s\" is corrupted", name);
+        lv_mem_free(f);
+        return NULL;
+    }
+
+    f->dsc.glyph_bitmap = data + hdr->bitmap_ofs;
+    f->dsc.glyph_dsc = glyphs;
+    f->dsc.cmaps = f->cmaps;
+    f->dsc.kern_scale = hdr->kern_ofs ? hdr->kern_scale : 0;
+    f->dsc.cmap_num = hdr->cmap_num;
+    f->dsc.bpp = hdr->bpp;
+    f->dsc.kern_classes = hdr->kern_classes ? 1 : 0;
+    f->dsc.bitmap_format = hdr->bitmap_format;
+    f->dsc.cache = &f->cache;
+
+    f->font.get_glyph_dsc = lv_font_get_glyph_dsc_fmt_txt;
+    f->font.get_glyph_bitmap = lv_font_get_bitmap_fmt_txt;
+    f->font.line_height = hdr->line_height;
+    f->font.base_line = hdr->base_line;
+    f->font.subpx = hdr->subpx;
+    f->font.underline_position = hdr->underline_position;
+    f->font.underline_thickness = hdr->underline_thickness;
+    f->font.dsc = &f->dsc;
+    return &f->font;
+}
+
+void ui_assets_font_free(lv_font_t *font)
+{
+    if (font == NULL) {
+        return;
+    }
+    // The decompressed glyphs are cached by the font's address
+    const lv_font_fmt_txt_dsc_t *dsc = font->dsc;
+    if (dsc->bitmap_format != LV_FONT_FMT_TXT_PLAIN) {
+        lv_font_fmt_txt_bitmap_cache_clear();
+    }
+    lv_mem_free(font);
+}
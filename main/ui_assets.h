@@ -0,0 +1,40 @@
+#ifndef UI_ASSETS_H
+#define UI_ASSETS_H
+#include <stddef.h>
+#include "esp_err.h"
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Image sources of the asset partition: lv_img_set_src(img, UI_ASSETS_IMG("logo"))
+#define UI_ASSETS_DRIVE "M:"
+#define UI_ASSETS_IMG(name) UI_ASSETS_DRIVE name
+
+// Images and fonts packed by tools/ui_assets_pack.py into an esp_mmap_assets partition.
+// The partition is memory mapped and LVGL uses the pixels, glyph descriptors and glyph bitmaps
+// where they are in flash: the image cache doesn't copy them and the fonts only allocate
+// their small descriptors. Compressed fonts are decompressed into the glyph cache as usual.
+
+// The default partition table has no asset partition. To use assets, put them into main/assets and
+// switch to a custom table with a data partition for them, e.g. in partition_table/partitionTable.csv:
+//   assets,data,spiffs,0x190000,4M,
+// with CONFIG_PARTITION_TABLE_CUSTOM and CONFIG_PARTITION_TABLE_CUSTOM_FILENAME pointing to it.
+
+// Map the partition and register the image decoder of the "M:" sources.
+// Call once, after lv_init(), with the LVGL lock held.
+esp_err_t ui_assets_init(const char *partition_label);
+
+// The payload of an asset in the mapped flash, NULL if there is no such asset
+const void *ui_assets_get(const char *name, size_t *size);
+
+// Create a font from a packed .fnt asset. NULL if it's missing or invalid.
+lv_font_t *ui_assets_font_load(const char *name);
+void ui_assets_font_free(lv_font_t *font);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UI_ASSETS_H
@@ -0,0 +1,148 @@
+#include "ui_queue.h"
+#include <stdio.h>
+
+void ui_queue_post_relay(ui_queue_t *queue, int relay_index, bool state)
+{
+    if (relay_index < 0 || relay_index >= UI_QUEUE_RELAYS) {
+        return;
+    }
+    uint32_t bit = 1u << relay_index;
+
+    // The state first, so the consumer seeing the pending bit sees this state or a newer one
+    if (state) {
+        atomic_fetch_or_explicit(&queue->relay_state, bit, memory_order_relaxed);
+    } else {
+        atomic_fetch_and_explicit(&queue->relay_state, ~bit, memory_order_relaxed);
+    }
+    uint32_t pending = atomic_fetch_or_explicit(&queue->relay_pending, bit, memory_order_release);
+
+    atomic_fetch_add_explicit(&queue->posted, 1, memory_order_relaxed);
+    if (pending & bit) {
+        atomic_fetch_add_explicit(&queue->coalesced, 1, memory_order_relaxed);
+    }
+}
+
+void ui_queue_post_ha_status(ui_queue_t *queue, bool connected, const char *ip)
+{
+    // The two values are one slot: the sequence is odd while they are written, so the consumer can
+    // tell a torn read
+    uint32_t seq = atomic_load_explicit(&queue->ha_seq, memory_order_relaxed);
+    atomic_store_explicit(&queue->ha_seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&queue->ha_connected, connected, memory_order_relaxed);
+    atomic_store_explicit(&queue->ha_ip, ip, memory_order_relaxed);
+    atomic_store_explicit(&queue->ha_seq, seq + 2, memory_order_release);
+    bool pending = atomic_exchange_explicit(&queue->ha_pending, true, memory_order_release);
+
+    atomic_fetch_add_explicit(&queue->posted, 1, memory_order_relaxed);
+    if (pending) {
+        atomic_fetch_add_explicit(&queue->coalesced, 1, memory_order_relaxed);
+    }
+}
+
+bool ui_queue_post_logv(ui_queue_t *queue, const char *fmt, va_list args)
+{
+    uint32_t head = atomic_load_explicit(&queue->log_head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&queue->log_tail, memory_order_acquire);
+
+    atomic_fetch_add_explicit(&queue->posted, 1, memory_order_relaxed);
+    if (head - tail >= UI_QUEUE_LOG_LINES) {
+        // The UI is behind. Only the consumer may free slots, so the new line is dropped.
+        atomic_fetch_add_explicit(&queue->dropped, 1, memory_order_relaxed);
+        return false;
+    }
+
+    vsnprintf(queue->log[head % UI_QUEUE_LOG_LINES], UI_QUEUE_LINE_MAX, fmt, args);
+    atomic_store_explicit(&queue->log_head, head + 1, memory_order_release);
+
+    uint32_t depth = head + 1 - tail;
+    if (depth > atomic_load_explicit(&queue->depth_max, memory_order_relaxed)) {
+        atomic_store_explicit(&queue->depth_max, depth, memory_order_relaxed);
+    }
+    return true;
+}
+
+bool ui_queue_post_log(ui_queue_t *queue, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    bool res = ui_queue_post_logv(queue, fmt, args);
+    va_end(args);
+    return res;
+}
+
+void ui_queue_post_request(ui_queue_t *queue, uint32_t requests)
+{
+    uint32_t pending = atomic_fetch_or_explicit(&queue->request_pending, requests, memory_order_release);
+
+    atomic_fetch_add_explicit(&queue->posted, 1, memory_order_relaxed);
+    if (pending & requests) {
+        atomic_fetch_add_explicit(&queue->coalesced, 1, memory_order_relaxed);
+    }
+}
+
+uint32_t ui_queue_drain(ui_queue_t *queue, const ui_queue_handlers_t *handlers)
+{
+    uint32_t applied = 0;
+
+    uint32_t pending = atomic_exchange_explicit(&queue->relay_pending, 0, memory_order_acquire);
+    if (pending) {
+        uint32_t state = atomic_load_explicit(&queue->relay_state, memory_order_relaxed);
+        int i;
+        for (i = 0; i < UI_QUEUE_RELAYS; i++) {
+            if ((pending & (1u << i)) && handlers->relay) {
+                handlers->relay(i, (state >> i) & 1);
+                applied++;
+            }
+        }
+    }
+
+    if (atomic_exchange_explicit(&queue->ha_pending, false, memory_order_acquire)) {
+        uint32_t seq = atomic_load_explicit(&queue->ha_seq, memory_order_acquire);
+        bool connected = atomic_load_explicit(&queue->ha_connected, memory_order_relaxed);
+        const char *ip = atomic_load_explicit(&queue->ha_ip, memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire);
+        // On a torn read the producer is still writing, it sets the pending flag again when it is
+        // done, so the status is applied with the next drain instead of waiting for it here
+        bool torn = (seq & 1) || seq != atomic_load_explicit(&queue->ha_seq, memory_order_relaxed);
+        if (!torn && handlers->ha_status) {
+            handlers->ha_status(connected, ip);
+            applied++;
+        }
+    }
+
+    uint32_t tail = atomic_load_explicit(&queue->log_tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&queue->log_head, memory_order_acquire);
+    for (; tail != head; tail++) {
+        if (handlers->log) {
+            handlers->log(queue->log[tail % UI_QUEUE_LOG_LINES]);
+            applied++;
+        }
+    }
+    // The slots are given back after the lines were used
+    atomic_store_explicit(&queue->log_tail, tail, memory_order_release);
+
+    uint32_t requests = atomic_exchange_explicit(&queue->request_pending, 0, memory_order_acquire);
+    if (requests && handlers->request) {
+        handlers->request(requests);
+        applied++;
+    }
+
+    if (applied) {
+        atomic_fetch_add_explicit(&queue->drains, 1, memory_order_relaxed);
+    }
+    return applied;
+}
+
+void ui_queue_get_stats(ui_queue_t *queue, ui_queue_stats_t *stats)
+{
+    uint32_t tail = atomic_load_explicit(&queue->log_tail, memory_order_acquire);
+    uint32_t head = atomic_load_explicit(&queue->log_head, memory_order_acquire);
+
+    stats->posted = atomic_load_explicit(&queue->posted, memory_order_relaxed);
+    stats->coalesced = atomic_load_explicit(&queue->coalesced, memory_order_relaxed);
+    stats->dropped = atomic_load_explicit(&queue->dropped, memory_order_relaxed);
+    stats->depth = head - tail;
+    stats->depth_max = atomic_load_explicit(&queue->depth_max, memory_order_relaxed);
+    stats->drains = atomic_load_explicit(&queue->drains, memory_order_relaxed);
+}
@@ -0,0 +1,80 @@
+#ifndef UI_QUEUE_H
+#define UI_QUEUE_H
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define UI_QUEUE_RELAYS 32     // Relay indexes 0..31
+#define UI_QUEUE_LOG_LINES 32  // Must be a power of 2
+#define UI_QUEUE_LINE_MAX 128  // Longer lines are truncated
+
+typedef struct {
+    void (*relay)(int relay_index, bool state);
+    void (*ha_status)(bool connected, const char *ip);
+    void (*log)(const char *line);
+    void (*request)(uint32_t requests);
+} ui_queue_handlers_t;
+
+typedef struct {
+    uint32_t posted;     // All updates posted
+    uint32_t coalesced;  // Updates replaced by a newer one of the same widget before they were applied
+    uint32_t dropped;    // Log lines dropped because the queue was full
+    uint32_t depth;      // Log lines waiting now
+    uint32_t depth_max;  // The most log lines waiting at once
+    uint32_t drains;     // Drains which applied something
+} ui_queue_stats_t;
+
+// UI updates posted by one task (the MQTT task) and applied by the LVGL task once per frame.
+// The producer never waits for the LVGL lock or the rendering, and there are no locks at all:
+// relay states and the HA status are "latest value" slots, so the updates of the same widget
+// arriving within one frame are applied once, with the last value. Log lines are queued in a
+// single producer/single consumer ring and dropped if the UI is behind. Requests are bits of work
+// which has to run on the LVGL task (e.g. reading LVGL state), the same bits posted within one
+// frame are served once.
+// A zeroed ui_queue_t is empty and ready to use.
+typedef struct {
+    atomic_uint_least32_t relay_pending;  // Bit i: the state of relay i changed
+    atomic_uint_least32_t relay_state;
+    atomic_bool ha_pending;
+    atomic_uint_least32_t ha_seq;         // Odd while the producer writes the HA status
+    atomic_bool ha_connected;
+    _Atomic(const char *) ha_ip;
+    atomic_uint_least32_t request_pending;
+    atomic_uint_least32_t log_head;       // Written by the producer
+    atomic_uint_least32_t log_tail;       // Written by the consumer
+    char log[UI_QUEUE_LOG_LINES][UI_QUEUE_LINE_MAX];
+    // Counters of the producer and the consumer
+    atomic_uint_least32_t posted;
+    atomic_uint_least32_t coalesced;
+    atomic_uint_least32_t dropped;
+    atomic_uint_least32_t depth_max;
+    atomic_uint_least32_t drains;
+} ui_queue_t;
+
+// Producer side
+void ui_queue_post_relay(ui_queue_t *queue, int relay_index, bool state);
+// `ip` is not copied, it must stay valid (e.g. a string literal)
+void ui_queue_post_ha_status(ui_queue_t *queue, bool connected, const char *ip);
+// Format a log line directly into the queue. Returns false if it was dropped.
+bool ui_queue_post_log(ui_queue_t *queue, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+bool ui_queue_post_logv(ui_queue_t *queue, const char *fmt, va_list args);
+void ui_queue_post_request(ui_queue_t *queue, uint32_t requests);
+
+// Consumer side: apply the posted updates, relays and HA status first, then the log lines in order,
+// then serve the requests.
+// Returns the number of the applied updates.
+uint32_t ui_queue_drain(ui_queue_t *queue, const ui_queue_handlers_t *handlers);
+
+// Can be called from any task
+void ui_queue_get_stats(ui_queue_t *queue, ui_queue_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UI_QUEUE_H
@@ -34,6 +34,7 @@ extern "C" {
 typedef enum {
     LVGL_PORT_EVENT_DISPLAY = 0x01,
     LVGL_PORT_EVENT_TOUCH   = 0x02,
+    LVGL_PORT_EVENT_VSYNC   = 0x04,
     LVGL_PORT_EVENT_USER    = 0x80,
 } lvgl_port_event_type_t;
 
@@ -52,7 +53,7 @@ typedef struct {
     int task_priority;        /*!< LVGL task priority */
     int task_stack;           /*!< LVGL task stack size */
     int task_affinity;        /*!< LVGL task pinned to core (-1 is no affinity) */
-    int task_max_sleep_ms;    /*!< Maximum sleep in LVGL task */
+    int task_max_sleep_ms;    /*!< Maximum sleep in LVGL task (LVGL8: only while LVGL timers are pending) */
     unsigned task_stack_caps; /*!< LVGL task stack memory capabilities (see esp_heap_caps.h) */
     int timer_period_ms;      /*!< LVGL timer tick period in ms */
 } lvgl_port_cfg_t;
@@ -73,9 +73,33 @@ typedef struct {
     struct {
         unsigned int bb_mode: 1;        /*!< 1: Use bounce buffer mode */
         unsigned int avoid_tearing: 1;  /*!< 1: Use internal RGB buffers as a LVGL draw buffers to avoid tearing effect, enabling this option requires over two LCD buffers and may reduce the frame rate */
+#if LVGL_VERSION_MAJOR == 8
+        unsigned int tile_mode: 1;      /*!< 1: Render into internal RAM tiles (`buffer_size`) and copy them into the only RGB frame buffer when the scan-out is not reading their rows. Requires `timing`, can't be used with `avoid_tearing`, `direct_mode`, `full_refresh` or rotation */
+#endif
     } flags;
+#if LVGL_VERSION_MAJOR == 8
+    struct {
+        uint32_t pclk_hz;       /*!< Pixel clock of the panel */
+        uint32_t h_blank;       /*!< HSYNC pulse width + back porch + front porch in pixels */
+        uint32_t v_blank;       /*!< VSYNC pulse width + back porch + front porch in lines */
+        uint32_t bounce_lines;  /*!< Height of one bounce buffer in lines (0: no bounce buffers) */
+    } timing;                   /*!< Scan-out timing for `tile_mode` */
+#endif
 } lvgl_port_display_rgb_cfg_t;
 
+#if LVGL_VERSION_MAJOR == 8
+/**
+ * @brief Statistics of an RGB display in tile mode
+ */
+typedef struct {
+    uint32_t tiles;     /*!< Tiles copied into the frame buffer */
+    uint64_t bytes;     /*!< Bytes written into the frame buffer */
+    uint64_t wait_us;   /*!< Time spent waiting for the scan-out to leave the rows of the tiles */
+    uint32_t late;      /*!< Tiles whose rows were read out while they were copied (possible tearing) */
+    uint32_t frames;    /*!< Frames scanned out */
+} lvgl_port_tile_stats_t;
+#endif
+
 /**
  * @brief Configuration MIPI-DSI display structure
  */
@@ -117,6 +141,21 @@ lv_display_t *lvgl_port_add_disp_dsi(const lvgl_port_display_cfg_t *disp_cfg, co
  */
 lv_display_t *lvgl_port_add_disp_rgb(const lvgl_port_display_cfg_t *disp_cfg, const lvgl_port_display_rgb_cfg_t *rgb_cfg);
 
+#if LVGL_VERSION_MAJOR == 8
+/**
+ * @brief Get the statistics of an RGB display added with `tile_mode`
+ *
+ * @note Call it from the LVGL task (e.g. from an LVGL timer) or with the LVGL lock held, the tiles are counted by the LVGL task
+ *
+ * @param disp Pointer to LVGL display
+ * @param stats Statistics since the display was added
+ * @return
+ *      - ESP_OK                    on success
+ *      - ESP_ERR_INVALID_STATE     if the display is not in tile mode
+ */
+esp_err_t lvgl_port_get_tile_stats(lv_display_t *disp, lvgl_port_tile_stats_t *stats);
+#endif
+
 /**
  * @brief Remove display handling from LVGL
  *
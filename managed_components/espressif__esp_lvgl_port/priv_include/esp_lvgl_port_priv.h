@@ -11,6 +11,9 @@
 
 #pragma once
 
+#include <stdint.h>
+#include <stdbool.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -29,6 +32,7 @@ typedef enum {
  */
 typedef struct {
     unsigned int avoid_tearing: 1;    /*!< Use internal RGB buffers as a LVGL draw buffers to avoid tearing effect */
+    unsigned int tile_mode: 1;        /*!< Use internal RAM draw buffers which are copied into the RGB frame buffer */
 } lvgl_port_disp_priv_cfg_t;
 
 /**
@@ -42,6 +46,87 @@ typedef struct {
  */
 bool lvgl_port_task_notify(uint32_t value);
 
+/**
+ * @brief Notify LVGL task about a vsync, if it has a frame to render
+ *
+ * @note It is called from RGB vsync ready
+ *
+ * @return
+ *      - true, whether a high priority task has been waken up by this function
+ */
+bool lvgl_port_task_vsync_notify(void);
+
+#define LVGL_PORT_TASK_WAIT_FOREVER     UINT32_MAX
+
+/**
+ * @brief Get how long the LVGL task can sleep, if no event arrives
+ *
+ * @param timer_delay_ms    return value of lv_timer_handler()
+ * @param max_sleep_ms      maximum sleep while LVGL timers are pending
+ * @return
+ *      - sleep time in ms or LVGL_PORT_TASK_WAIT_FOREVER, if no LVGL timer is ready
+ */
+static inline uint32_t lvgl_port_task_wait_ms(uint32_t timer_delay_ms, uint32_t max_sleep_ms)
+{
+    /* LV_NO_TIMER_READY: nothing to do until an event */
+    if (timer_delay_ms == UINT32_MAX) {
+        return LVGL_PORT_TASK_WAIT_FOREVER;
+    }
+
+    return (timer_delay_ms < max_sleep_ms) ? timer_delay_ms : max_sleep_ms;
+}
+
+/**
+ * @brief Scan-out of an RGB frame buffer in line periods
+ *
+ * The frame buffer is read row by row (by the DMA or the bounce buffer refills) once in every frame.
+ * A frame is `v_total` line periods long and row `y` is read in period `(read_ofs + y) % v_total`
+ * counted from the vsync event.
+ */
+typedef struct {
+    uint32_t v_total;   /*!< Active rows + vertical blanking */
+    uint32_t read_ofs;  /*!< Line period in which row 0 is read */
+    uint32_t margin;    /*!< Uncertainty of the reader position in line periods */
+} lvgl_port_tile_scan_t;
+
+/**
+ * @brief Get how long a tile has to wait to be copied into the frame buffer without tearing
+ *
+ * The rows of the tile must not be read while they are written: either the reader has already passed them
+ * (they are shown from the next frame on) or it reaches them only when the copy is done.
+ *
+ * @param scan      scan-out of the frame buffer
+ * @param line      line periods elapsed since the last vsync event
+ * @param y1        first row of the tile
+ * @param y2        last row of the tile
+ * @param copy      line periods needed to copy the tile
+ * @return
+ *      - 0 to copy now, otherwise the line periods to wait
+ */
+static inline uint32_t lvgl_port_tile_wait_lines(const lvgl_port_tile_scan_t *scan, uint32_t line, int32_t y1, int32_t y2, uint32_t copy)
+{
+    const uint32_t total = scan->v_total;
+    const uint32_t rows = (uint32_t)(y2 - y1 + 1);
+    const uint32_t first = (scan->read_ofs + (uint32_t)y1) % total;
+
+    /* How far the reader is past the first row of the tile */
+    const uint32_t past = (line % total + total - first) % total;
+
+    /* Reading the tile (or maybe still, because of the uncertainty): wait until it has passed */
+    if (past < rows + scan->margin) {
+        return rows + scan->margin - past;
+    }
+
+    /* Reaches the tile only after the copy */
+    const uint32_t reach = total - past;
+    if (reach >= copy + scan->margin) {
+        return 0;
+    }
+
+    /* Too close, let it pass */
+    return reach + rows + scan->margin;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -32,8 +32,16 @@ typedef struct lvgl_port_ctx_s {
     SemaphoreHandle_t   task_mux;
     esp_timer_handle_t  tick_timer;
     bool                running;
+    volatile bool       vsync_wait;     /* A frame is pending, wake the task on the next vsync */
     int                 task_max_sleep_ms;
     int                 timer_period_ms;
+#if LV_USE_PARALLEL_RENDER
+    TaskHandle_t        render_task;    /* Renders a part of the frame on the other core */
+    SemaphoreHandle_t   render_done;
+    SemaphoreHandle_t   render_mux;     /* Guards the LVGL heap and caches while both tasks render */
+    lv_parallel_job_cb_t render_job;
+    void                *render_param;
+#endif
 } lvgl_port_ctx_t;
 
 /*******************************************************************************
@@ -47,6 +55,11 @@ static lvgl_port_ctx_t lvgl_port_ctx;
 static void lvgl_port_task(void *arg);
 static esp_err_t lvgl_port_tick_init(void);
 static void lvgl_port_task_deinit(void);
+static bool lvgl_port_frame_pending(void);
+#if LV_USE_PARALLEL_RENDER
+static esp_err_t lvgl_port_render_task_init(const lvgl_port_cfg_t *cfg, uint32_t caps);
+static void lvgl_port_render_task_deinit(void);
+#endif
 
 /*******************************************************************************
 * Public API functions
@@ -86,6 +99,10 @@ esp_err_t lvgl_port_init(const lvgl_port_cfg_t *cfg)
     }
     ESP_GOTO_ON_FALSE(res == pdPASS, ESP_FAIL, err, TAG, "Create LVGL task fail!");
 
+#if LV_USE_PARALLEL_RENDER
+    ESP_GOTO_ON_ERROR(lvgl_port_render_task_init(cfg, caps), err, TAG, "Create LVGL render task fail!");
+#endif
+
 err:
     if (ret != ESP_OK) {
         lvgl_port_deinit();
@@ -101,6 +118,7 @@ esp_err_t lvgl_port_resume(void)
     if (lvgl_port_ctx.tick_timer != NULL) {
         lv_timer_enable(true);
         ret = esp_timer_start_periodic(lvgl_port_ctx.tick_timer, lvgl_port_ctx.timer_period_ms * 1000);
+        lvgl_port_task_wake(LVGL_PORT_EVENT_USER, NULL);
     }
 
     return ret;
@@ -130,6 +148,8 @@ esp_err_t lvgl_port_deinit(void)
     /* Stop running task */
     if (lvgl_port_ctx.running) {
         lvgl_port_ctx.running = false;
+        /* The task may sleep without timeout */
+        lvgl_port_task_wake(LVGL_PORT_EVENT_USER, NULL);
     }
 
     /* Wait for stop task */
@@ -156,35 +176,62 @@ void lvgl_port_unlock(void)
 {
     assert(lvgl_port_ctx.lvgl_mux && "lvgl_port_init must be called first");
     xSemaphoreGiveRecursive(lvgl_port_ctx.lvgl_mux);
+
+    /* Other tasks can invalidate objects or create timers, so the LVGL task has to recalculate its sleep */
+    TaskHandle_t task = xTaskGetCurrentTaskHandle();
+    if (lvgl_port_ctx.lvgl_task && task != lvgl_port_ctx.lvgl_task && xSemaphoreGetMutexHolder(lvgl_port_ctx.lvgl_mux) != task) {
+        lvgl_port_task_wake(LVGL_PORT_EVENT_DISPLAY, NULL);
+    }
 }
 
-esp_err_t lvgl_port_task_wake(lvgl_port_event_type_t event, void *param)
+IRAM_ATTR esp_err_t lvgl_port_task_wake(lvgl_port_event_type_t event, void *param)
 {
-    ESP_LOGE(TAG, "Task wake is not supported, when used LVGL8!");
-    return ESP_ERR_NOT_SUPPORTED;
+    if (!lvgl_port_ctx.lvgl_task) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (lvgl_port_task_notify(event)) {
+        portYIELD_FROM_ISR();
+    }
+
+    return ESP_OK;
 }
 
 IRAM_ATTR bool lvgl_port_task_notify(uint32_t value)
 {
     BaseType_t need_yield = pdFALSE;
 
-    // Notify LVGL task
+    // Notify LVGL task, the events are collected in the notification value
     if (xPortInIsrContext() == pdTRUE) {
-        xTaskNotifyFromISR(lvgl_port_ctx.lvgl_task, value, eNoAction, &need_yield);
+        xTaskNotifyFromISR(lvgl_port_ctx.lvgl_task, value, eSetBits, &need_yield);
     } else {
-        xTaskNotify(lvgl_port_ctx.lvgl_task, value, eNoAction);
+        xTaskNotify(lvgl_port_ctx.lvgl_task, value, eSetBits);
     }
 
     return (need_yield == pdTRUE);
 }
 
+IRAM_ATTR bool lvgl_port_task_vsync_notify(void)
+{
+    /* Wake the task only when it has a frame to render, so the idle screen costs no wake ups */
+    if (!lvgl_port_ctx.vsync_wait) {
+        return false;
+    }
+    lvgl_port_ctx.vsync_wait = false;
+
+    return lvgl_port_task_notify(LVGL_PORT_EVENT_VSYNC);
+}
+
 /*******************************************************************************
 * Private functions
 *******************************************************************************/
 
 static void lvgl_port_task(void *arg)
 {
-    uint32_t task_delay_ms = lvgl_port_ctx.task_max_sleep_ms;
+    uint32_t task_delay_ms = 0;
+    uint32_t events = 0;
+    lv_indev_t *indev = NULL;
+    lv_disp_t *disp = NULL;
 
     /* Take the task semaphore */
     if (xSemaphoreTake(lvgl_port_ctx.task_mux, 0) != pdTRUE) {
@@ -196,16 +243,38 @@ static void lvgl_port_task(void *arg)
     ESP_LOGI(TAG, "Starting LVGL task");
     lvgl_port_ctx.running = true;
     while (lvgl_port_ctx.running) {
+        /* Sleep until an event or the next LVGL timer. Without ready timers only an event can wake the task. */
+        events = 0;
+        task_delay_ms = lvgl_port_task_wait_ms(task_delay_ms, lvgl_port_ctx.task_max_sleep_ms);
+        xTaskNotifyWait(0, UINT32_MAX, &events, (task_delay_ms == LVGL_PORT_TASK_WAIT_FOREVER) ? portMAX_DELAY : (task_delay_ms + portTICK_PERIOD_MS - 1) / portTICK_PERIOD_MS);
+
         if (lvgl_port_lock(0)) {
+            /* Read the input devices right away, they are not polled while released in interrupt mode */
+            if (events & LVGL_PORT_EVENT_TOUCH) {
+                indev = lv_indev_get_next(NULL);
+                while (indev != NULL) {
+                    if (indev->driver->read_timer) {
+                        lv_indev_read_timer_cb(indev->driver->read_timer);
+                    }
+                    indev = lv_indev_get_next(indev);
+                }
+            }
+
+            /* Render the pending frames just after the vsync instead of waiting for the refresh timer */
+            if (events & LVGL_PORT_EVENT_VSYNC) {
+                disp = lv_disp_get_next(NULL);
+                while (disp != NULL) {
+                    if (disp->inv_p && disp->refr_timer) {
+                        _lv_disp_refr_timer(disp->refr_timer);
+                    }
+                    disp = lv_disp_get_next(disp);
+                }
+            }
+
             task_delay_ms = lv_timer_handler();
+            lvgl_port_ctx.vsync_wait = lvgl_port_frame_pending();
             lvgl_port_unlock();
         }
-        if (task_delay_ms > lvgl_port_ctx.task_max_sleep_ms) {
-            task_delay_ms = lvgl_port_ctx.task_max_sleep_ms;
-        } else if (task_delay_ms < 5) {
-            task_delay_ms = 5;
-        }
-        vTaskDelay(pdMS_TO_TICKS(task_delay_ms));
     }
 
     /* Give semaphore back */
@@ -215,8 +284,24 @@ static void lvgl_port_task(void *arg)
     vTaskDelete( NULL );
 }
 
+static bool lvgl_port_frame_pending(void)
+{
+    lv_disp_t *disp = lv_disp_get_next(NULL);
+    while (disp != NULL) {
+        if (disp->inv_p) {
+            return true;
+        }
+        disp = lv_disp_get_next(disp);
+    }
+
+    return false;
+}
+
 static void lvgl_port_task_deinit(void)
 {
+#if LV_USE_PARALLEL_RENDER
+    lvgl_port_render_task_deinit();
+#endif
     if (lvgl_port_ctx.lvgl_mux) {
         vSemaphoreDelete(lvgl_port_ctx.lvgl_mux);
     }
@@ -230,6 +315,96 @@ static void lvgl_port_task_deinit(void)
 #endif
 }
 
+#if LV_USE_PARALLEL_RENDER
+static void lvgl_port_render_task(void *arg)
+{
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        lv_parallel_job_cb_t job = lvgl_port_ctx.render_job;
+        if (job == NULL) {
+            break;
+        }
+        job(lvgl_port_ctx.render_param);
+        xSemaphoreGive(lvgl_port_ctx.render_done);
+    }
+
+    xSemaphoreGive(lvgl_port_ctx.render_done);
+    vTaskDelete(NULL);
+}
+
+static void lvgl_port_render_start(lv_parallel_job_cb_t job, void *param)
+{
+    lvgl_port_ctx.render_job = job;
+    lvgl_port_ctx.render_param = param;
+    xTaskNotifyGive(lvgl_port_ctx.render_task);
+}
+
+static void lvgl_port_render_wait(void)
+{
+    xSemaphoreTake(lvgl_port_ctx.render_done, portMAX_DELAY);
+}
+
+static void lvgl_port_render_lock(void)
+{
+    xSemaphoreTakeRecursive(lvgl_port_ctx.render_mux, portMAX_DELAY);
+}
+
+static void lvgl_port_render_unlock(void)
+{
+    xSemaphoreGiveRecursive(lvgl_port_ctx.render_mux);
+}
+
+static esp_err_t lvgl_port_render_task_init(const lvgl_port_cfg_t *cfg, uint32_t caps)
+{
+    // A second render task helps only on the other core
+    if (configNUM_CORES < 2) {
+        return ESP_OK;
+    }
+
+    lvgl_port_ctx.render_done = xSemaphoreCreateBinary();
+    ESP_RETURN_ON_FALSE(lvgl_port_ctx.render_done, ESP_ERR_NO_MEM, TAG, "Create render semaphore fail!");
+    lvgl_port_ctx.render_mux = xSemaphoreCreateRecursiveMutex();
+    ESP_RETURN_ON_FALSE(lvgl_port_ctx.render_mux, ESP_ERR_NO_MEM, TAG, "Create render mutex fail!");
+
+    BaseType_t res;
+    if (cfg->task_affinity < 0) {
+        res = xTaskCreateWithCaps(lvgl_port_render_task, "taskLVGLRender", cfg->task_stack, NULL, cfg->task_priority, &lvgl_port_ctx.render_task, caps);
+    } else {
+        const BaseType_t core = (cfg->task_affinity + 1) % configNUM_CORES;
+        res = xTaskCreatePinnedToCoreWithCaps(lvgl_port_render_task, "taskLVGLRender", cfg->task_stack, NULL, cfg->task_priority, &lvgl_port_ctx.render_task, core, caps);
+    }
+    ESP_RETURN_ON_FALSE(res == pdPASS, ESP_FAIL, TAG, "Create render task fail!");
+
+    const lv_parallel_cb_t parallel_cb = {
+        .start_cb = lvgl_port_render_start,
+        .wait_cb = lvgl_port_render_wait,
+        .lock_cb = lvgl_port_render_lock,
+        .unlock_cb = lvgl_port_render_unlock,
+    };
+    lv_parallel_set_cb(&parallel_cb);
+
+    return ESP_OK;
+}
+
+static void lvgl_port_render_task_deinit(void)
+{
+    lv_parallel_set_cb(NULL);
+
+    if (lvgl_port_ctx.render_task) {
+        // A NULL job stops the task
+        lvgl_port_render_start(NULL, NULL);
+        lvgl_port_render_wait();
+        lvgl_port_ctx.render_task = NULL;
+    }
+    if (lvgl_port_ctx.render_done) {
+        vSemaphoreDelete(lvgl_port_ctx.render_done);
+    }
+    if (lvgl_port_ctx.render_mux) {
+        vSemaphoreDelete(lvgl_port_ctx.render_mux);
+    }
+}
+#endif
+
 static void lvgl_port_tick_increment(void *arg)
 {
     /* Tell LVGL how many milliseconds have elapsed */
@@ -5,11 +5,14 @@
  */
 
 #include <string.h>
+#include <inttypes.h>
 #include "esp_log.h"
 #include "esp_err.h"
 #include "esp_check.h"
 #include "esp_heap_caps.h"
 #include "esp_idf_version.h"
+#include "esp_timer.h"
+#include "esp_rom_sys.h"
 #include "esp_lcd_panel_io.h"
 #include "esp_lcd_panel_ops.h"
 #include "esp_lvgl_port.h"
@@ -26,6 +29,30 @@
 #include "esp_lcd_mipi_dsi.h"
 #endif
 
+/* Copy the areas between the RGB frame buffers with GDMA instead of the CPU */
+#if CONFIG_IDF_TARGET_ESP32S3 && CONFIG_SPIRAM && ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 1, 0)
+#define LVGL_PORT_SYNC_DMA 1
+#include "esp_async_memcpy.h"
+#else
+#define LVGL_PORT_SYNC_DMA 0
+#endif
+
+#if CONFIG_IDF_TARGET_ESP32S3 && ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0)
+#define LVGL_PORT_TILE_MODE 1
+#else
+#define LVGL_PORT_TILE_MODE 0
+#endif
+
+#if LVGL_PORT_TILE_MODE
+#define LVGL_PORT_TILE_COPY_NS_PER_KB   25000   /* Initial guess of the copy speed (40 MB/s), then it is measured */
+#endif
+
+#if LVGL_PORT_SYNC_DMA
+#define LVGL_PORT_SYNC_DMA_ALIGN    64      /* Alignment of the PSRAM transfers (data cache line) */
+#define LVGL_PORT_SYNC_DMA_MIN      4096    /* Smaller areas are copied by the CPU */
+#define LVGL_PORT_SYNC_DMA_BACKLOG  16
+#endif
+
 #if (ESP_IDF_VERSION < ESP_IDF_VERSION_VAL(4, 4, 4)) || (ESP_IDF_VERSION == ESP_IDF_VERSION_VAL(5, 0, 0))
 #define LVGL_PORT_HANDLE_FLUSH_READY 0
 #else
@@ -38,6 +65,17 @@ static const char *TAG = "LVGL";
 * Types definitions
 *******************************************************************************/
 
+#if LVGL_PORT_TILE_MODE
+typedef struct {
+    lvgl_port_tile_scan_t     scan;         /* Scan-out of the frame buffer */
+    uint32_t                  line_ns_nom;  /* Line period from the panel timing */
+    volatile uint32_t         line_ns;      /* Line period measured from the vsync period */
+    volatile uint32_t         vsync_us;     /* Time of the last vsync event (lower 32 bits) */
+    uint32_t                  copy_ns_per_kb; /* Measured speed of copying into the frame buffer */
+    lvgl_port_tile_stats_t    stats;
+} lvgl_port_tile_ctx_t;
+#endif
+
 typedef struct {
     lvgl_port_disp_type_t     disp_type;    /* Display type */
     esp_lcd_panel_io_handle_t io_handle;    /* LCD panel IO handle */
@@ -48,6 +86,13 @@ typedef struct {
     lv_color_t                *trans_buf;   /* Buffer send to driver */
     uint32_t                  trans_size;   /* Maximum size for one transport */
     SemaphoreHandle_t         trans_sem;    /* Idle transfer mutex */
+#if LVGL_PORT_SYNC_DMA
+    async_memcpy_handle_t     sync_dma;     /* Copies the areas of the last frame between the frame buffers */
+    SemaphoreHandle_t         sync_sem;     /* Given when a copy is done */
+#endif
+#if LVGL_PORT_TILE_MODE
+    lvgl_port_tile_ctx_t      *tile;        /* Tile mode state, NULL: not in tile mode */
+#endif
 } lvgl_port_display_ctx_t;
 
 /*******************************************************************************
@@ -68,6 +113,18 @@ static bool lvgl_port_flush_dpi_vsync_ready_callback(esp_lcd_panel_handle_t pane
 static void lvgl_port_flush_callback(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_map);
 static void lvgl_port_update_callback(lv_disp_drv_t *drv);
 static void lvgl_port_pix_monochrome_callback(lv_disp_drv_t *drv, uint8_t *buf, lv_coord_t buf_w, lv_coord_t x, lv_coord_t y, lv_color_t color, lv_opa_t opa);
+#if LVGL_PORT_TILE_MODE
+static esp_err_t lvgl_port_tile_init(lvgl_port_display_ctx_t *disp_ctx, const lvgl_port_display_cfg_t *disp_cfg, const lvgl_port_display_rgb_cfg_t *rgb_cfg);
+static bool lvgl_port_tile_vsync_callback(esp_lcd_panel_handle_t panel, const esp_lcd_rgb_panel_event_data_t *edata, void *user_ctx);
+static uint32_t lvgl_port_tile_now(const lvgl_port_tile_ctx_t *tile, uint32_t *vsync_us);
+static uint32_t lvgl_port_tile_line(const lvgl_port_tile_ctx_t *tile, uint32_t vsync_us, uint32_t now);
+static void lvgl_port_flush_tile(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_map);
+#endif
+#if LVGL_PORT_SYNC_DMA
+static esp_err_t lvgl_port_sync_dma_init(lvgl_port_display_ctx_t *disp_ctx);
+static void lvgl_port_sync_dma_deinit(lvgl_port_display_ctx_t *disp_ctx);
+static void lvgl_port_sync_callback(lv_disp_drv_t *drv, lv_color_t *dest_buf, const lv_color_t *src_buf, const lv_area_t *areas, uint16_t area_cnt);
+#endif
 
 /*******************************************************************************
 * Public API functions
@@ -131,6 +188,7 @@ lv_display_t *lvgl_port_add_disp_rgb(const lvgl_port_display_cfg_t *disp_cfg, co
     assert(rgb_cfg != NULL);
     const lvgl_port_disp_priv_cfg_t priv_cfg = {
         .avoid_tearing = rgb_cfg->flags.avoid_tearing,
+        .tile_mode = rgb_cfg->flags.tile_mode,
     };
     lv_disp_t *disp = lvgl_port_add_disp_priv(disp_cfg, &priv_cfg);
 
@@ -139,6 +197,20 @@ lv_display_t *lvgl_port_add_disp_rgb(const lvgl_port_display_cfg_t *disp_cfg, co
         /* Set display type */
         disp_ctx->disp_type = LVGL_PORT_DISP_TYPE_RGB;
 
+#if LVGL_PORT_TILE_MODE
+        if (rgb_cfg->flags.tile_mode) {
+            if (lvgl_port_tile_init(disp_ctx, disp_cfg, rgb_cfg) != ESP_OK) {
+                lvgl_port_remove_disp(disp);
+                return NULL;
+            }
+            const esp_lcd_rgb_panel_event_callbacks_t tile_cbs = {
+                .on_vsync = lvgl_port_tile_vsync_callback,
+            };
+            ESP_ERROR_CHECK(esp_lcd_rgb_panel_register_event_callbacks(disp_ctx->panel_handle, &tile_cbs, &disp_ctx->disp_drv));
+            return disp;
+        }
+#endif
+
 #if (CONFIG_IDF_TARGET_ESP32S3 && ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0))
         /* Register done callback */
         const esp_lcd_rgb_panel_event_callbacks_t vsync_cbs = {
@@ -178,6 +250,13 @@ esp_err_t lvgl_port_remove_disp(lv_disp_t *disp)
 
     lv_disp_remove(disp);
 
+#if LVGL_PORT_SYNC_DMA
+    lvgl_port_sync_dma_deinit(disp_ctx);
+#endif
+#if LVGL_PORT_TILE_MODE
+    free(disp_ctx->tile);
+#endif
+
     if (disp_drv) {
         if (disp_drv->draw_ctx) {
             disp_drv->draw_ctx_deinit(disp_drv, disp_drv->draw_ctx);
@@ -203,6 +282,22 @@ esp_err_t lvgl_port_remove_disp(lv_disp_t *disp)
     return ESP_OK;
 }
 
+#if LVGL_VERSION_MAJOR == 8
+esp_err_t lvgl_port_get_tile_stats(lv_disp_t *disp, lvgl_port_tile_stats_t *stats)
+{
+    assert(disp);
+    assert(stats);
+#if LVGL_PORT_TILE_MODE
+    lvgl_port_display_ctx_t *disp_ctx = lvgl_port_get_display_ctx(disp);
+    ESP_RETURN_ON_FALSE(disp_ctx->tile, ESP_ERR_INVALID_STATE, TAG, "Display is not in tile mode");
+    *stats = disp_ctx->tile->stats;
+    return ESP_OK;
+#else
+    return ESP_ERR_INVALID_STATE;
+#endif
+}
+#endif
+
 void lvgl_port_flush_ready(lv_disp_t *disp)
 {
     assert(disp);
@@ -265,6 +360,16 @@ static lv_disp_t *lvgl_port_add_disp_priv(const lvgl_port_display_cfg_t *disp_cf
         trans_sem = xSemaphoreCreateCounting(1, 0);
         ESP_GOTO_ON_FALSE(trans_sem, ESP_ERR_NO_MEM, err, TAG, "Failed to create transport counting Semaphore");
         disp_ctx->trans_sem = trans_sem;
+    } else if (priv_cfg && priv_cfg->tile_mode) {
+        /* Tiles are rendered in internal RAM and only copied into the PSRAM frame buffer */
+        ESP_GOTO_ON_FALSE(!disp_cfg->flags.direct_mode && !disp_cfg->flags.full_refresh && !disp_cfg->flags.sw_rotate, ESP_ERR_INVALID_ARG, err, TAG, "Tile mode can't be used with direct mode, full refresh or rotation!");
+        ESP_GOTO_ON_FALSE(!disp_cfg->rotation.swap_xy && !disp_cfg->rotation.mirror_x && !disp_cfg->rotation.mirror_y, ESP_ERR_INVALID_ARG, err, TAG, "Tile mode can't be used with direct mode, full refresh or rotation!");
+        buf1 = heap_caps_malloc(buffer_size * sizeof(lv_color_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        ESP_GOTO_ON_FALSE(buf1, ESP_ERR_NO_MEM, err, TAG, "Not enough memory for LVGL buffer (buf1) allocation!");
+        if (disp_cfg->double_buffer) {
+            buf2 = heap_caps_malloc(buffer_size * sizeof(lv_color_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+            ESP_GOTO_ON_FALSE(buf2, ESP_ERR_NO_MEM, err, TAG, "Not enough memory for LVGL buffer (buf2) allocation!");
+        }
     } else {
         uint32_t buff_caps = MALLOC_CAP_DEFAULT;
         if (disp_cfg->flags.buff_dma && disp_cfg->flags.buff_spiram && (0 == disp_cfg->trans_size)) {
@@ -326,6 +431,16 @@ static lv_disp_t *lvgl_port_add_disp_priv(const lvgl_port_display_cfg_t *disp_cf
         ESP_GOTO_ON_FALSE((disp_cfg->hres * disp_cfg->vres == buffer_size), ESP_ERR_INVALID_ARG, err, TAG, "Direct mode must using full buffer!");
 
         disp_ctx->disp_drv.direct_mode = 1;
+#if LVGL_PORT_SYNC_DMA
+        /* The two RGB frame buffers are in PSRAM, copy the areas of the last frame with DMA */
+        if (priv_cfg && priv_cfg->avoid_tearing && buf2) {
+            if (lvgl_port_sync_dma_init(disp_ctx) == ESP_OK) {
+                disp_ctx->disp_drv.sync_cb = lvgl_port_sync_callback;
+            } else {
+                ESP_LOGW(TAG, "Async memcpy is not available, the frame buffers are synchronized by the CPU");
+            }
+        }
+#endif
     } else if (disp_cfg->flags.full_refresh) {
         /* When using full_refresh, there must be used full bufer! */
         ESP_GOTO_ON_FALSE((disp_cfg->hres * disp_cfg->vres == buffer_size), ESP_ERR_INVALID_ARG, err, TAG, "Full refresh must using full buffer!");
@@ -352,6 +467,11 @@ err:
         if (trans_sem) {
             vSemaphoreDelete(trans_sem);
         }
+#if LVGL_PORT_SYNC_DMA
+        if (disp_ctx) {
+            lvgl_port_sync_dma_deinit(disp_ctx);
+        }
+#endif
         if (disp_ctx) {
             free(disp_ctx);
         }
@@ -427,6 +547,11 @@ static bool lvgl_port_flush_rgb_vsync_ready_callback(esp_lcd_panel_handle_t pane
         xSemaphoreGiveFromISR(disp_ctx->trans_sem, &need_yield);
     }
 
+    /* Start rendering the pending frame right after vsync */
+    if (lvgl_port_task_vsync_notify()) {
+        need_yield = pdTRUE;
+    }
+
     return (need_yield == pdTRUE);
 }
 #endif
@@ -460,6 +585,13 @@ static void lvgl_port_flush_callback(lv_disp_drv_t *drv, const lv_area_t *area,
     lv_color_t *from = color_map;
     lv_color_t *to = NULL;
 
+#if LVGL_PORT_TILE_MODE
+    if (disp_ctx->tile) {
+        lvgl_port_flush_tile(drv, area, color_map);
+        return;
+    }
+#endif
+
     if (disp_ctx->trans_size == 0) {
         if ((disp_ctx->disp_type == LVGL_PORT_DISP_TYPE_RGB || disp_ctx->disp_type == LVGL_PORT_DISP_TYPE_DSI) && (drv->direct_mode || drv->full_refresh)) {
             if (lv_disp_flush_is_last(drv)) {
@@ -467,7 +599,9 @@ static void lvgl_port_flush_callback(lv_disp_drv_t *drv, const lv_area_t *area,
                 esp_lcd_panel_draw_bitmap(disp_ctx->panel_handle, x_start, y_start, x_end + 1, y_end + 1, color_map);
                 /* Waiting for the last frame buffer to complete transmission */
                 xSemaphoreTake(disp_ctx->trans_sem, 0);
+                LV_TRACE_BEGIN(LV_TRACE_STAGE_FLUSH_WAIT);
                 xSemaphoreTake(disp_ctx->trans_sem, portMAX_DELAY);
+                LV_TRACE_END(LV_TRACE_STAGE_FLUSH_WAIT);
             }
         } else {
             esp_lcd_panel_draw_bitmap(disp_ctx->panel_handle, x_start, y_start, x_end + 1, y_end + 1, color_map);
@@ -499,7 +633,9 @@ static void lvgl_port_flush_callback(lv_disp_drv_t *drv, const lv_area_t *area,
 
             from += max_line * width;
             y_start_tmp += max_line;
+            LV_TRACE_BEGIN(LV_TRACE_STAGE_FLUSH_WAIT);
             xSemaphoreTake(disp_ctx->trans_sem, portMAX_DELAY);
+            LV_TRACE_END(LV_TRACE_STAGE_FLUSH_WAIT);
         }
     }
 }
@@ -561,3 +697,224 @@ static void lvgl_port_pix_monochrome_callback(lv_disp_drv_t *drv, uint8_t *buf,
         (*buf) |= (1 << (y % 8));
     }
 }
+
+#if LVGL_PORT_TILE_MODE
+static esp_err_t lvgl_port_tile_init(lvgl_port_display_ctx_t *disp_ctx, const lvgl_port_display_cfg_t *disp_cfg, const lvgl_port_display_rgb_cfg_t *rgb_cfg)
+{
+    ESP_RETURN_ON_FALSE(!rgb_cfg->flags.avoid_tearing, ESP_ERR_INVALID_ARG, TAG, "Tile mode can't be used with avoid tearing!");
+    ESP_RETURN_ON_FALSE(rgb_cfg->timing.pclk_hz > 0, ESP_ERR_INVALID_ARG, TAG, "Tile mode needs the panel timing!");
+
+    lvgl_port_tile_ctx_t *tile = calloc(1, sizeof(lvgl_port_tile_ctx_t));
+    ESP_RETURN_ON_FALSE(tile, ESP_ERR_NO_MEM, TAG, "Not enough memory for tile mode context allocation!");
+
+    const uint32_t v_total = disp_cfg->vres + rgb_cfg->timing.v_blank;
+    const uint32_t lead = rgb_cfg->timing.bounce_lines * 2;
+    tile->line_ns_nom = (uint64_t)(disp_cfg->hres + rgb_cfg->timing.h_blank) * 1000000000ULL / rgb_cfg->timing.pclk_hz;
+    tile->line_ns = tile->line_ns_nom;
+    tile->copy_ns_per_kb = LVGL_PORT_TILE_COPY_NS_PER_KB;
+
+    /* The active rows are scanned out after the vertical blanking, the two bounce buffers are refilled
+     * that many rows ahead. Where the vsync event is in the blanking and that a bounce buffer is
+     * refilled at once are covered by the margin. */
+    tile->scan.v_total = v_total;
+    tile->scan.read_ofs = (rgb_cfg->timing.v_blank + v_total - lead % v_total) % v_total;
+    tile->scan.margin = rgb_cfg->timing.v_blank + rgb_cfg->timing.bounce_lines + 1;
+    ESP_LOGD(TAG, "Tile mode: %"PRIu32" ns/line, read offset %"PRIu32", margin %"PRIu32" lines", tile->line_ns, tile->scan.read_ofs, tile->scan.margin);
+
+    disp_ctx->tile = tile;
+    return ESP_OK;
+}
+
+static IRAM_ATTR bool lvgl_port_tile_vsync_callback(esp_lcd_panel_handle_t panel, const esp_lcd_rgb_panel_event_data_t *edata, void *user_ctx)
+{
+    lv_disp_drv_t *disp_drv = (lv_disp_drv_t *)user_ctx;
+    lvgl_port_display_ctx_t *disp_ctx = disp_drv->user_data;
+    lvgl_port_tile_ctx_t *tile = disp_ctx->tile;
+
+    /* Correct the line period with the measured frame period, unless a vsync was missed */
+    uint32_t now = (uint32_t)esp_timer_get_time();
+    int32_t frame_us = (int32_t)(now - tile->vsync_us);
+    uint32_t line_ns = frame_us > 0 ? (uint64_t)frame_us * 1000 / tile->scan.v_total : 0;
+    if (line_ns > tile->line_ns_nom * 3 / 4 && line_ns < tile->line_ns_nom * 5 / 4) {
+        tile->line_ns = line_ns;
+    }
+    tile->vsync_us = now;
+    tile->stats.frames++;
+
+    return false;
+}
+
+/* Current time and the last vsync before it. The vsync interrupt may come between the two reads, then they are repeated. */
+static uint32_t lvgl_port_tile_now(const lvgl_port_tile_ctx_t *tile, uint32_t *vsync_us)
+{
+    uint32_t now;
+    do {
+        *vsync_us = tile->vsync_us;
+        now = (uint32_t)esp_timer_get_time();
+    } while (*vsync_us != tile->vsync_us);
+
+    return now;
+}
+
+/* Line periods elapsed between the vsync and `now` */
+static uint32_t lvgl_port_tile_line(const lvgl_port_tile_ctx_t *tile, uint32_t vsync_us, uint32_t now)
+{
+    int32_t elapsed_us = (int32_t)(now - vsync_us);
+    return elapsed_us > 0 ? (uint64_t)elapsed_us * 1000 / tile->line_ns : 0;
+}
+
+static void lvgl_port_flush_tile(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_map)
+{
+    lvgl_port_display_ctx_t *disp_ctx = (lvgl_port_display_ctx_t *)drv->user_data;
+    lvgl_port_tile_ctx_t *tile = disp_ctx->tile;
+    const uint32_t bytes = lv_area_get_size(area) * sizeof(lv_color_t);
+    const uint32_t copy = (uint64_t)bytes * tile->copy_ns_per_kb / 1024 / tile->line_ns + 1;
+    const uint32_t tick_us = portTICK_PERIOD_MS * 1000;
+
+    /* Sleep while the wait is long, then busy wait for the last tick */
+    uint32_t vsync_us;
+    const uint32_t wait_start = lvgl_port_tile_now(tile, &vsync_us);
+    uint32_t now = wait_start;
+    uint32_t wait;
+    while ((wait = lvgl_port_tile_wait_lines(&tile->scan, lvgl_port_tile_line(tile, vsync_us, now), area->y1, area->y2, copy)) != 0) {
+        uint32_t wait_us = (uint64_t)wait * tile->line_ns / 1000 + 1;
+        if (wait_us > 2 * tick_us) {
+            vTaskDelay(wait_us / tick_us - 1);
+        } else {
+            esp_rom_delay_us(wait_us);
+        }
+        now = lvgl_port_tile_now(tile, &vsync_us);
+    }
+
+    esp_lcd_panel_draw_bitmap(disp_ctx->panel_handle, area->x1, area->y1, area->x2 + 1, area->y2 + 1, color_map);
+    const uint32_t end = (uint32_t)esp_timer_get_time();
+    const uint32_t copy_us = (int32_t)(end - now) > 0 ? end - now : 0;
+
+    /* Learn the copy speed and check whether the reader came to the tile meanwhile (e.g. the task was preempted) */
+    const uint32_t copy_ns_per_kb = (uint64_t)copy_us * 1000 * 1024 / bytes;
+    tile->copy_ns_per_kb = (tile->copy_ns_per_kb * 7 + copy_ns_per_kb) / 8;
+    const lvgl_port_tile_scan_t exact = {
+        .v_total = tile->scan.v_total,
+        .read_ofs = tile->scan.read_ofs,
+        .margin = 0,
+    };
+    /* The copy started at `now`, so its line is counted from the vsync read with it, not from a vsync during the copy */
+    const uint32_t copied = (uint64_t)copy_us * 1000 / tile->line_ns + 1;
+    if (lvgl_port_tile_wait_lines(&exact, lvgl_port_tile_line(tile, vsync_us, now), area->y1, area->y2, copied) != 0) {
+        tile->stats.late++;
+    }
+    tile->stats.tiles++;
+    tile->stats.bytes += bytes;
+    tile->stats.wait_us += now - wait_start;
+
+    lv_disp_flush_ready(drv);
+}
+#endif
+
+#if LVGL_PORT_SYNC_DMA
+static IRAM_ATTR bool lvgl_port_sync_dma_done_callback(async_memcpy_handle_t mcp_hdl, async_memcpy_event_t *event, void *cb_args)
+{
+    BaseType_t need_yield = pdFALSE;
+    lvgl_port_display_ctx_t *disp_ctx = (lvgl_port_display_ctx_t *)cb_args;
+    xSemaphoreGiveFromISR(disp_ctx->sync_sem, &need_yield);
+    return (need_yield == pdTRUE);
+}
+
+static esp_err_t lvgl_port_sync_dma_init(lvgl_port_display_ctx_t *disp_ctx)
+{
+    esp_err_t ret = ESP_OK;
+    async_memcpy_config_t cfg = ASYNC_MEMCPY_DEFAULT_CONFIG();
+    cfg.backlog = LVGL_PORT_SYNC_DMA_BACKLOG;
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 4, 0)
+    cfg.dma_burst_size = LVGL_PORT_SYNC_DMA_ALIGN;
+#else
+    cfg.psram_trans_align = LVGL_PORT_SYNC_DMA_ALIGN;
+#endif
+
+    disp_ctx->sync_sem = xSemaphoreCreateCounting(LVGL_PORT_SYNC_DMA_BACKLOG, 0);
+    ESP_GOTO_ON_FALSE(disp_ctx->sync_sem, ESP_ERR_NO_MEM, err, TAG, "Failed to create sync counting Semaphore");
+    ESP_GOTO_ON_ERROR(esp_async_memcpy_install(&cfg, &disp_ctx->sync_dma), err, TAG, "Install async memcpy failed");
+
+err:
+    if (ret != ESP_OK) {
+        lvgl_port_sync_dma_deinit(disp_ctx);
+    }
+    return ret;
+}
+
+static void lvgl_port_sync_dma_deinit(lvgl_port_display_ctx_t *disp_ctx)
+{
+    if (disp_ctx->sync_dma) {
+        esp_async_memcpy_uninstall(disp_ctx->sync_dma);
+        disp_ctx->sync_dma = NULL;
+    }
+    if (disp_ctx->sync_sem) {
+        vSemaphoreDelete(disp_ctx->sync_sem);
+        disp_ctx->sync_sem = NULL;
+    }
+}
+
+/* Start one DMA copy, if the backlog is full wait for a former one. Returns false if the CPU has to copy. */
+static bool lvgl_port_sync_dma_copy(lvgl_port_display_ctx_t *disp_ctx, void *dest, void *src, size_t size, uint32_t *pending)
+{
+    while (esp_async_memcpy(disp_ctx->sync_dma, dest, src, size, lvgl_port_sync_dma_done_callback, disp_ctx) != ESP_OK) {
+        if (*pending == 0) {
+            return false;
+        }
+        xSemaphoreTake(disp_ctx->sync_sem, portMAX_DELAY);
+        (*pending)--;
+    }
+    (*pending)++;
+    return true;
+}
+
+static void lvgl_port_sync_callback(lv_disp_drv_t *drv, lv_color_t *dest_buf, const lv_color_t *src_buf, const lv_area_t *areas, uint16_t area_cnt)
+{
+    lvgl_port_display_ctx_t *disp_ctx = (lvgl_port_display_ctx_t *)drv->user_data;
+    const size_t stride = drv->hor_res * sizeof(lv_color_t);
+    const size_t align = LVGL_PORT_SYNC_DMA_ALIGN;
+    uint8_t *dest = (uint8_t *)dest_buf;
+    uint8_t *src = (uint8_t *)src_buf;
+    uint32_t pending = 0;
+
+    for (uint16_t i = 0; i < area_cnt; i++) {
+        const lv_area_t *a = &areas[i];
+        size_t row_ofs = a->x1 * sizeof(lv_color_t);
+        size_t row_len = lv_area_get_width(a) * sizeof(lv_color_t);
+        size_t rows = lv_area_get_height(a);
+        bool dma = (row_len * rows >= LVGL_PORT_SYNC_DMA_MIN) && ((uintptr_t)dest % align == 0) && ((uintptr_t)src % align == 0);
+
+        // Both buffers hold the same picture outside of the areas, so copying a few more pixels is harmless:
+        // widen the rows to the DMA alignment and copy the full width rows of the area in one transfer
+        if (dma) {
+            size_t start = row_ofs / align * align;
+            size_t end = (row_ofs + row_len + align - 1) / align * align;
+            if (end > stride) {
+                dma = false;
+            } else if (start == 0 && end == stride) {
+                size_t ofs = a->y1 * stride;
+                dma = lvgl_port_sync_dma_copy(disp_ctx, dest + ofs, src + ofs, stride * rows, &pending);
+            } else {
+                for (lv_coord_t y = a->y1; y <= a->y2 && dma; y++) {
+                    size_t ofs = y * stride + start;
+                    dma = lvgl_port_sync_dma_copy(disp_ctx, dest + ofs, src + ofs, end - start, &pending);
+                }
+            }
+        }
+
+        // Copying twice is harmless as well if the DMA gave up in the middle of the area
+        if (!dma) {
+            for (lv_coord_t y = a->y1; y <= a->y2; y++) {
+                size_t ofs = y * stride + row_ofs;
+                memcpy(dest + ofs, src + ofs, row_len);
+            }
+        }
+    }
+
+    // LVGL renders into `dest_buf` after returning, so every transfer has to be done
+    while (pending) {
+        xSemaphoreTake(disp_ctx->sync_sem, portMAX_DELAY);
+        pending--;
+    }
+}
+#endif
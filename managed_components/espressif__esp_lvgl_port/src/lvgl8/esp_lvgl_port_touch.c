@@ -19,6 +19,9 @@ static const char *TAG = "LVGL";
 typedef struct {
     esp_lcd_touch_handle_t   handle;     /* LCD touch IO handle */
     lv_indev_drv_t           indev_drv;  /* LVGL input device driver */
+    lv_indev_t               *indev;     /* LVGL input device */
+    bool                     irq_mode;   /* Read on touch interrupt instead of polling */
+    volatile bool            polling;    /* The read timer runs (touch pressed), the interrupt is not needed */
     struct {
         float x;
         float y;
@@ -30,6 +33,7 @@ typedef struct {
 *******************************************************************************/
 
 static void lvgl_port_touchpad_read(lv_indev_drv_t *indev_drv, lv_indev_data_t *data);
+static void lvgl_port_touch_interrupt_callback(esp_lcd_touch_handle_t tp);
 
 /*******************************************************************************
 * Public API functions
@@ -50,14 +54,33 @@ lv_indev_t *lvgl_port_add_touch(const lvgl_port_touch_cfg_t *touch_cfg)
     touch_ctx->handle = touch_cfg->handle;
     touch_ctx->scale.x = (touch_cfg->scale.x ? touch_cfg->scale.x : 1);
     touch_ctx->scale.y = (touch_cfg->scale.y ? touch_cfg->scale.y : 1);
+    touch_ctx->irq_mode = false;
+    touch_ctx->polling = false;
+
+    if (touch_ctx->handle->config.int_gpio_num != GPIO_NUM_NC) {
+        /* Register touch interrupt callback */
+        if (esp_lcd_touch_register_interrupt_callback_with_data(touch_ctx->handle, lvgl_port_touch_interrupt_callback, touch_ctx) == ESP_OK) {
+            touch_ctx->irq_mode = true;
+        } else {
+            ESP_LOGW(TAG, "Error in register touch interrupt, polling the touch.");
+        }
+    }
 
+    lvgl_port_lock(0);
     /* Register a touchpad input device */
     lv_indev_drv_init(&touch_ctx->indev_drv);
     touch_ctx->indev_drv.type = LV_INDEV_TYPE_POINTER;
     touch_ctx->indev_drv.disp = touch_cfg->disp;
     touch_ctx->indev_drv.read_cb = lvgl_port_touchpad_read;
     touch_ctx->indev_drv.user_data = touch_ctx;
-    return lv_indev_drv_register(&touch_ctx->indev_drv);
+    touch_ctx->indev = lv_indev_drv_register(&touch_ctx->indev_drv);
+    /* The interrupt wakes the LVGL task to read the touch, poll it only while pressed */
+    if (touch_ctx->indev && touch_ctx->irq_mode) {
+        lv_timer_pause(touch_ctx->indev_drv.read_timer);
+    }
+    lvgl_port_unlock();
+
+    return touch_ctx->indev;
 }
 
 esp_err_t lvgl_port_remove_touch(lv_indev_t *touch)
@@ -67,6 +90,11 @@ esp_err_t lvgl_port_remove_touch(lv_indev_t *touch)
     assert(indev_drv);
     lvgl_port_touch_ctx_t *touch_ctx = (lvgl_port_touch_ctx_t *)indev_drv->user_data;
 
+    if (touch_ctx && touch_ctx->irq_mode) {
+        /* Unregister touch interrupt callback */
+        esp_lcd_touch_register_interrupt_callback(touch_ctx->handle, NULL);
+    }
+
     /* Remove input device driver */
     lv_indev_delete(touch);
 
@@ -104,4 +132,29 @@ static void lvgl_port_touchpad_read(lv_indev_drv_t *indev_drv, lv_indev_data_t *
     } else {
         data->state = LV_INDEV_STATE_RELEASED;
     }
+
+    /* Long press and scrolling need periodic reads while pressed. Released touch is read only on interrupt. */
+    if (touch_ctx->irq_mode && indev_drv->read_timer) {
+        if (data->state == LV_INDEV_STATE_PRESSED) {
+            /* Poll in the phase of the display refresh, else the reads would be extra wake ups during animations */
+            if (indev_drv->read_timer->paused && indev_drv->disp && indev_drv->disp->refr_timer) {
+                indev_drv->read_timer->last_run = indev_drv->disp->refr_timer->last_run;
+            }
+            lv_timer_resume(indev_drv->read_timer);
+        } else {
+            lv_timer_pause(indev_drv->read_timer);
+        }
+        touch_ctx->polling = (data->state == LV_INDEV_STATE_PRESSED);
+    }
+}
+
+static void IRAM_ATTR lvgl_port_touch_interrupt_callback(esp_lcd_touch_handle_t tp)
+{
+    lvgl_port_touch_ctx_t *touch_ctx = (lvgl_port_touch_ctx_t *)tp->config.user_data;
+
+    /* Wake LVGL task to read the touch. While pressed the controller reports every few ms, but the read timer
+     * polls anyway, so these interrupts would only add wake ups. The release is seen by the next poll. */
+    if (!touch_ctx->polling) {
+        lvgl_port_task_wake(LVGL_PORT_EVENT_TOUCH, NULL);
+    }
 }
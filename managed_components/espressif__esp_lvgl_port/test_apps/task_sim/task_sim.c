@@ -0,0 +1,339 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Host simulation of the LVGL8 port task scheduling.
+ *
+ * Compares the former polling loop (lv_timer_handler() + vTaskDelay() clamped to 5..task_max_sleep_ms)
+ * with the event driven loop (task notifications from touch interrupt, other tasks and RGB vsync).
+ * The LVGL timers (input device read, animation, display refresh) are modeled with their LVGL8 behavior.
+ *
+ * Build and run: cc -O2 -I../../priv_include task_sim.c -o task_sim && ./task_sim
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "esp_lvgl_port_priv.h"
+
+#define LV_NO_TIMER_READY       0xFFFFFFFF
+#define SIM_NEVER               INT64_MAX
+#define SIM_MS(ms)              ((int64_t)(ms) * 1000)
+
+#define SIM_REFR_PERIOD_MS      30      /* LV_DISP_DEF_REFR_PERIOD */
+#define SIM_READ_PERIOD_MS      30      /* LV_INDEV_DEF_READ_PERIOD */
+#define SIM_TASK_MAX_SLEEP_MS   500
+#define SIM_RENDER_US           8000    /* Render and flush of one frame */
+#define SIM_VSYNC_US            16667   /* 60 Hz panel */
+#define SIM_TOUCH_REPORT_MS     10      /* Touch controller interrupt period while touched */
+#define SIM_TAP_OFFSET_MS       100
+
+/* Same as lvgl_port_event_type_t */
+#define SIM_EVENT_DISPLAY       0x01
+#define SIM_EVENT_TOUCH         0x02
+#define SIM_EVENT_VSYNC         0x04
+
+/*******************************************************************************
+* Types definitions
+*******************************************************************************/
+
+typedef struct {
+    int64_t period;
+    int64_t last_run;
+    bool paused;
+    void (*cb)(void);
+} sim_timer_t;
+
+typedef struct {
+    const char *name;
+    int64_t duration;
+    int64_t tap_period;         /* Touch tap period, 0: no touch */
+    int64_t tap_len;            /* How long a tap is pressed */
+    int64_t update_period;      /* UI update from an other task (lock/unlock), 0: no update */
+    bool anim;                  /* Animation is running all the time */
+} sim_scenario_t;
+
+typedef struct {
+    const sim_scenario_t *scn;
+    bool event_mode;
+    int64_t now;
+    sim_timer_t indev;
+    sim_timer_t anim;
+    sim_timer_t refr;
+    bool inv;                   /* There are invalid areas */
+    bool pressed;               /* Last read touch state */
+    int64_t input_ts;           /* Press time waiting for its frame, -1: none */
+    int64_t update_ts;          /* Last applied UI update */
+    bool vsync_wait;
+    /* Statistics */
+    uint32_t wakeups;
+    uint32_t frames;
+    uint32_t lat_cnt;
+    int64_t lat_sum;
+    int64_t lat_max;
+} sim_ctx_t;
+
+/*******************************************************************************
+* Local variables
+*******************************************************************************/
+
+static sim_ctx_t sim;
+
+static const sim_scenario_t scenarios[] = {
+    {.name = "idle",      .duration = SIM_MS(10000)},
+    {.name = "touch",     .duration = SIM_MS(10000), .tap_period = SIM_MS(1000), .tap_len = SIM_MS(120)},
+    {.name = "updates",   .duration = SIM_MS(10000), .update_period = SIM_MS(500)},
+    {.name = "animation", .duration = SIM_MS(10000), .anim = true},
+    {.name = "anim+touch", .duration = SIM_MS(10000), .tap_period = SIM_MS(700), .tap_len = SIM_MS(300), .anim = true},
+};
+
+/*******************************************************************************
+* Scenario
+*******************************************************************************/
+
+static bool touch_pressed(int64_t t, int64_t *press_ts)
+{
+    const sim_scenario_t *scn = sim.scn;
+    int64_t rel = t - SIM_MS(SIM_TAP_OFFSET_MS);
+    if (scn->tap_period == 0 || rel < 0) {
+        return false;
+    }
+    int64_t m = rel % scn->tap_period;
+    if (press_ts) {
+        *press_ts = t - m;
+    }
+    return m < scn->tap_len;
+}
+
+/* First touch interrupt after `t`: periodic reports while touched and one at release */
+static int64_t next_touch_irq(int64_t t)
+{
+    const sim_scenario_t *scn = sim.scn;
+    if (scn->tap_period == 0) {
+        return SIM_NEVER;
+    }
+    int64_t k = (t - SIM_MS(SIM_TAP_OFFSET_MS)) / scn->tap_period;
+    if (k < 0) {
+        k = 0;
+    }
+    for (;; k++) {
+        int64_t press = SIM_MS(SIM_TAP_OFFSET_MS) + k * scn->tap_period;
+        for (int64_t irq = press; irq < press + scn->tap_len; irq += SIM_MS(SIM_TOUCH_REPORT_MS)) {
+            if (irq > t) {
+                return irq;
+            }
+        }
+        if (press + scn->tap_len > t) {
+            return press + scn->tap_len;
+        }
+    }
+}
+
+static int64_t next_update(int64_t t)
+{
+    if (sim.scn->update_period == 0) {
+        return SIM_NEVER;
+    }
+    int64_t k = (t < 0 ? 0 : t / sim.scn->update_period) + 1;
+    return k * sim.scn->update_period;
+}
+
+static int64_t next_vsync(int64_t t)
+{
+    return (t / SIM_VSYNC_US + 1) * SIM_VSYNC_US;
+}
+
+/*******************************************************************************
+* LVGL model
+*******************************************************************************/
+
+static void invalidate(void)
+{
+    sim.inv = true;
+    sim.refr.paused = false;
+}
+
+static void indev_read_cb(void)
+{
+    int64_t press_ts = 0;
+    bool pressed = touch_pressed(sim.now, &press_ts);
+
+    /* Press and release change the look of the pressed object */
+    if (pressed != sim.pressed) {
+        if (pressed && sim.input_ts < 0) {
+            sim.input_ts = press_ts;
+        }
+        invalidate();
+    }
+    sim.pressed = pressed;
+
+    /* In interrupt mode the touch is polled only while pressed, in the phase of the display refresh */
+    if (sim.event_mode) {
+        if (pressed && sim.indev.paused) {
+            sim.indev.last_run = sim.refr.last_run;
+        }
+        sim.indev.paused = !pressed;
+    }
+}
+
+static void anim_cb(void)
+{
+    invalidate();
+}
+
+static void refr_cb(void)
+{
+    sim.refr.paused = true;
+    if (!sim.inv) {
+        return;
+    }
+
+    sim.now += SIM_RENDER_US;
+    sim.inv = false;
+    sim.frames++;
+
+    if (sim.input_ts >= 0) {
+        int64_t lat = sim.now - sim.input_ts;
+        sim.lat_sum += lat;
+        sim.lat_cnt++;
+        if (lat > sim.lat_max) {
+            sim.lat_max = lat;
+        }
+        sim.input_ts = -1;
+    }
+}
+
+/* lv_timer_handler(): run the ready timers and return the time till the next one */
+static uint32_t timer_handler(void)
+{
+    sim_timer_t *timers[] = {&sim.indev, &sim.anim, &sim.refr};
+    const int cnt = sizeof(timers) / sizeof(timers[0]);
+
+    for (int i = 0; i < cnt; i++) {
+        if (!timers[i]->paused && sim.now - timers[i]->last_run >= timers[i]->period) {
+            timers[i]->last_run = sim.now;
+            timers[i]->cb();
+        }
+    }
+
+    uint32_t next = LV_NO_TIMER_READY;
+    for (int i = 0; i < cnt; i++) {
+        if (timers[i]->paused) {
+            continue;
+        }
+        int64_t remain = timers[i]->period - (sim.now - timers[i]->last_run);
+        uint32_t remain_ms = remain > 0 ? (uint32_t)((remain + 999) / 1000) : 0;
+        if (remain_ms < next) {
+            next = remain_ms;
+        }
+    }
+
+    return next;
+}
+
+/*******************************************************************************
+* Port task model
+*******************************************************************************/
+
+static void run(const sim_scenario_t *scn, bool event_mode)
+{
+    memset(&sim, 0, sizeof(sim));
+    sim.scn = scn;
+    sim.event_mode = event_mode;
+    sim.input_ts = -1;
+    sim.update_ts = -1;
+    sim.indev = (sim_timer_t) {
+        .period = SIM_MS(SIM_READ_PERIOD_MS), .paused = event_mode, .cb = indev_read_cb
+    };
+    sim.anim = (sim_timer_t) {
+        .period = SIM_MS(SIM_REFR_PERIOD_MS), .paused = !scn->anim, .cb = anim_cb
+    };
+    sim.refr = (sim_timer_t) {
+        .period = SIM_MS(SIM_REFR_PERIOD_MS), .paused = true, .cb = refr_cb
+    };
+
+    int64_t last_ret = -1;
+    uint32_t task_delay_ms = 0;
+
+    while (sim.now < scn->duration) {
+        uint32_t events = 0;
+        int64_t wake;
+
+        if (event_mode) {
+            /* xTaskNotifyWait(): the events raised while the task was busy are still pending */
+            uint32_t wait_ms = lvgl_port_task_wait_ms(task_delay_ms, SIM_TASK_MAX_SLEEP_MS);
+            int64_t deadline = (wait_ms == LVGL_PORT_TASK_WAIT_FOREVER) ? SIM_NEVER : sim.now + SIM_MS(wait_ms);
+            /* The touch interrupt wakes the task only while the input device is not polled */
+            int64_t touch = sim.indev.paused ? next_touch_irq(last_ret) : SIM_NEVER;
+            int64_t update = next_update(last_ret);
+            int64_t vsync = sim.vsync_wait ? next_vsync(sim.now) : SIM_NEVER;
+
+            wake = deadline;
+            wake = touch < wake ? touch : wake;
+            wake = update < wake ? update : wake;
+            wake = vsync < wake ? vsync : wake;
+            wake = wake > sim.now ? wake : sim.now;
+
+            events |= (touch <= wake) ? SIM_EVENT_TOUCH : 0;
+            events |= (update <= wake) ? SIM_EVENT_DISPLAY : 0;
+            events |= (vsync <= wake) ? SIM_EVENT_VSYNC : 0;
+        } else {
+            /* vTaskDelay() with the former clamping */
+            uint32_t delay_ms = task_delay_ms;
+            if (delay_ms > SIM_TASK_MAX_SLEEP_MS) {
+                delay_ms = SIM_TASK_MAX_SLEEP_MS;
+            } else if (delay_ms < 5) {
+                delay_ms = 5;
+            }
+            wake = sim.now + SIM_MS(delay_ms);
+        }
+
+        if (wake >= scn->duration) {
+            break;
+        }
+        sim.now = wake;
+        last_ret = wake;
+        sim.wakeups++;
+
+        /* UI updates of the other tasks invalidate under the lock */
+        if (next_update(sim.update_ts) <= sim.now) {
+            sim.update_ts = sim.now;
+            invalidate();
+        }
+
+        if (events & SIM_EVENT_TOUCH) {
+            indev_read_cb();
+        }
+        if ((events & SIM_EVENT_VSYNC) && sim.inv) {
+            refr_cb();
+        }
+
+        task_delay_ms = timer_handler();
+        sim.vsync_wait = sim.inv;
+    }
+
+    double sec = (double)scn->duration / 1000000.0;
+    printf("| %-10s | %-6s | %9.1f | %8.1f |", scn->name, event_mode ? "event" : "poll",
+           sim.wakeups / sec, sim.frames / sec);
+    if (sim.lat_cnt) {
+        printf(" %21.1f | %21.1f |\n", (double)sim.lat_sum / sim.lat_cnt / 1000.0, (double)sim.lat_max / 1000.0);
+    } else {
+        printf(" %21s | %21s |\n", "-", "-");
+    }
+}
+
+int main(void)
+{
+    printf("| Scenario   | Loop   | Wakeups/s | Frames/s | Input->flush avg [ms] | Input->flush max [ms] |\n");
+    printf("| :--------- | :----- | --------: | -------: | --------------------: | --------------------: |\n");
+    for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+        run(&scenarios[i], false);
+        run(&scenarios[i], true);
+    }
+
+    return 0;
+}
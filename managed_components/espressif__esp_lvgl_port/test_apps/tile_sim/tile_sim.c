@@ -0,0 +1,339 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Host simulation of the RGB tile mode of the LVGL8 port.
+ *
+ * Compares the direct mode with two PSRAM frame buffers (avoid_tearing, the frame buffers are synchronized
+ * before rendering) with the tile mode (partial mode with an internal RAM draw buffer whose tiles are
+ * copied into the only frame buffer). The scan-out reads the frame buffer through two bounce buffers.
+ * The tile mode is run with the scheduling of the port and without it (tiles copied right away).
+ *
+ * Build and run: cc -O2 -I../../priv_include tile_sim.c -o tile_sim && ./tile_sim
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "esp_lvgl_port_priv.h"
+
+#define SIM_MS(ms)              ((int64_t)(ms) * 1000000)
+#define SIM_DURATION            SIM_MS(10000)
+
+/* Panel of the project (800x480, 16 MHz pixel clock, 10 line bounce buffers) */
+#define SIM_H_RES               800
+#define SIM_V_RES               480
+#define SIM_PCLK_HZ             16000000
+#define SIM_H_BLANK             20
+#define SIM_V_BLANK             20
+#define SIM_V_SYNC_BP           12      /* VSYNC pulse + back porch: blanking lines before row 0 */
+#define SIM_BOUNCE_LINES        10
+#define SIM_V_TOTAL             (SIM_V_RES + SIM_V_BLANK)
+#define SIM_LINE_NS             ((int64_t)(SIM_H_RES + SIM_H_BLANK) * 1000000000 / SIM_PCLK_HZ)
+#define SIM_FRAME_NS            (SIM_LINE_NS * SIM_V_TOTAL)
+#define SIM_PX_SIZE             2
+
+/* Model of the CPU and PSRAM, the same for both modes */
+#define SIM_RENDER_SRAM_NS      30      /* Render one pixel into internal RAM */
+#define SIM_RENDER_PSRAM_NS     55      /* Render one pixel into PSRAM */
+#define SIM_RENDER_PSRAM_ACCESS 3       /* PSRAM accesses of a rendered pixel (background, widget, blending read) */
+#define SIM_COPY_NS_PER_BYTE    25      /* CPU copy into PSRAM (40 MB/s) */
+
+#define SIM_TILE_LINES          24      /* Height of the full width tile */
+#define SIM_AREA_MAX            32
+
+/*******************************************************************************
+* Types definitions
+*******************************************************************************/
+
+typedef struct {
+    int32_t x1, y1, x2, y2;
+} sim_area_t;
+
+typedef enum {
+    SIM_MODE_DIRECT,        /* Direct mode, 2 frame buffers, avoid tearing */
+    SIM_MODE_TILE_NAIVE,    /* Tile mode, tiles copied right away */
+    SIM_MODE_TILE,          /* Tile mode, tiles copied behind the scan-out */
+} sim_mode_t;
+
+typedef struct {
+    const char *name;
+    int64_t period;
+    uint32_t (*areas)(uint32_t update, sim_area_t *areas);
+} sim_scenario_t;
+
+typedef struct {
+    uint64_t psram_bytes;   /* PSRAM traffic of the UI, the scan-out is not counted */
+    int64_t wait;
+    int64_t lat_sum;
+    int64_t lat_max;
+    uint32_t updates;
+    uint32_t tiles;
+    uint32_t torn;
+} sim_stats_t;
+
+/*******************************************************************************
+* Scenarios
+*******************************************************************************/
+
+static uint32_t rnd_seed;
+
+static uint32_t rnd(void)
+{
+    rnd_seed = rnd_seed * 1103515245 + 12345;
+    return rnd_seed >> 8;
+}
+
+static uint32_t areas_labels(uint32_t update, sim_area_t *areas)
+{
+    (void)update;
+    for (uint32_t i = 0; i < 20; i++) {
+        int32_t x = 10 + (rnd() % 5) * 150;
+        int32_t y = 60 + (rnd() % 24) * 17;
+        areas[i] = (sim_area_t) {
+            x, y, x + 119, y + 16
+        };
+    }
+    return 20;
+}
+
+static uint32_t areas_camera(uint32_t update, sim_area_t *areas)
+{
+    areas[0] = (sim_area_t) {
+        410, 240, 729, 479
+    };
+    uint32_t cnt = 1;
+    if (update % 4 == 0) {
+        areas[cnt++] = (sim_area_t) {
+            10, 5, 160, 25
+        };
+    }
+    return cnt;
+}
+
+static uint32_t areas_log(uint32_t update, sim_area_t *areas)
+{
+    (void)update;
+    areas[0] = (sim_area_t) {
+        410, 60, 789, 259
+    };
+    return 1;
+}
+
+static uint32_t areas_screen(uint32_t update, sim_area_t *areas)
+{
+    (void)update;
+    areas[0] = (sim_area_t) {
+        0, 0, SIM_H_RES - 1, SIM_V_RES - 1
+    };
+    return 1;
+}
+
+static const sim_scenario_t scenarios[] = {
+    {.name = "labels",     .period = SIM_MS(100),  .areas = areas_labels},
+    {.name = "camera",     .period = SIM_MS(66),   .areas = areas_camera},
+    {.name = "log scroll", .period = SIM_MS(200),  .areas = areas_log},
+    {.name = "screen",     .period = SIM_MS(1000), .areas = areas_screen},
+};
+
+/*******************************************************************************
+* Scan-out model
+*******************************************************************************/
+
+/* The bounce buffer refills read SIM_BOUNCE_LINES rows at once, two buffers ahead of the scan-out */
+static int64_t read_period_ofs(void)
+{
+    return (SIM_V_SYNC_BP - 2 * SIM_BOUNCE_LINES + SIM_V_TOTAL) % SIM_V_TOTAL;
+}
+
+/* First row read in line period `p` (counted from time 0), -1 if none */
+static int32_t read_row(int64_t p)
+{
+    int64_t r = ((p - read_period_ofs()) % SIM_V_TOTAL + SIM_V_TOTAL) % SIM_V_TOTAL;
+    if (r >= SIM_V_RES || r % SIM_BOUNCE_LINES) {
+        return -1;
+    }
+    return (int32_t)r;
+}
+
+/* Are rows y1..y2 read between t1 and t2 */
+static bool read_between(int32_t y1, int32_t y2, int64_t t1, int64_t t2)
+{
+    for (int64_t p = t1 / SIM_LINE_NS; p * SIM_LINE_NS <= t2; p++) {
+        int64_t t = p * SIM_LINE_NS;
+        int32_t r = read_row(p);
+        if (t < t1 || r < 0) {
+            continue;
+        }
+        if (r <= y2 && r + SIM_BOUNCE_LINES - 1 >= y1) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Time when row y is read next time after t */
+static int64_t next_read(int32_t y, int64_t t)
+{
+    int64_t p = t / SIM_LINE_NS + 1;
+    while (true) {
+        int32_t r = read_row(p);
+        if (r >= 0 && y >= r && y < r + SIM_BOUNCE_LINES) {
+            return p * SIM_LINE_NS;
+        }
+        p++;
+    }
+}
+
+/*******************************************************************************
+* Modes
+*******************************************************************************/
+
+static uint8_t cur_mask[SIM_V_RES][SIM_H_RES];
+static uint8_t prev_mask[SIM_V_RES][SIM_H_RES];
+
+static uint64_t area_px(const sim_area_t *a)
+{
+    return (uint64_t)(a->x2 - a->x1 + 1) * (a->y2 - a->y1 + 1);
+}
+
+/* Render into the back frame buffer after copying the stale parts, then wait for the vsync to swap */
+static int64_t frame_direct(int64_t start, const sim_area_t *areas, uint32_t cnt, sim_stats_t *st, int64_t *visible)
+{
+    memset(cur_mask, 0, sizeof(cur_mask));
+    uint64_t px = 0;
+    int32_t y_max = 0;
+    for (uint32_t i = 0; i < cnt; i++) {
+        for (int32_t y = areas[i].y1; y <= areas[i].y2; y++) {
+            memset(&cur_mask[y][areas[i].x1], 1, areas[i].x2 - areas[i].x1 + 1);
+        }
+        y_max = areas[i].y2 > y_max ? areas[i].y2 : y_max;
+    }
+    uint64_t sync_px = 0;
+    for (int32_t y = 0; y < SIM_V_RES; y++) {
+        for (int32_t x = 0; x < SIM_H_RES; x++) {
+            px += cur_mask[y][x];
+            sync_px += prev_mask[y][x] && !cur_mask[y][x];
+        }
+    }
+    memcpy(prev_mask, cur_mask, sizeof(prev_mask));
+
+    int64_t t = start;
+    t += sync_px * SIM_PX_SIZE * 2 * SIM_COPY_NS_PER_BYTE;
+    t += px * SIM_RENDER_PSRAM_NS;
+    st->psram_bytes += sync_px * SIM_PX_SIZE * 2 + px * SIM_PX_SIZE * SIM_RENDER_PSRAM_ACCESS;
+
+    /* The buffers are swapped at the vsync, the rows are read out during the next frame */
+    int64_t vsync = (t / SIM_FRAME_NS + 1) * SIM_FRAME_NS;
+    st->wait += vsync - t;
+    *visible = next_read(y_max, vsync);
+    return vsync;
+}
+
+/* Render the areas tile by tile (as LVGL8 partial mode splits them) and copy each tile into the frame buffer */
+static int64_t frame_tile(int64_t start, const sim_area_t *areas, uint32_t cnt, bool schedule, sim_stats_t *st, int64_t *visible)
+{
+    const lvgl_port_tile_scan_t scan = {
+        .v_total = SIM_V_TOTAL,
+        .read_ofs = (SIM_V_BLANK - 2 * SIM_BOUNCE_LINES + SIM_V_TOTAL) % SIM_V_TOTAL,
+        .margin = SIM_V_BLANK + SIM_BOUNCE_LINES + 1,
+    };
+    int64_t t = start;
+    *visible = start;
+
+    for (uint32_t i = 0; i < cnt; i++) {
+        int32_t w = areas[i].x2 - areas[i].x1 + 1;
+        int32_t h_max = SIM_H_RES * SIM_TILE_LINES / w;
+        for (int32_t y1 = areas[i].y1; y1 <= areas[i].y2; y1 += h_max) {
+            sim_area_t tile = areas[i];
+            tile.y1 = y1;
+            tile.y2 = (y1 + h_max - 1) < areas[i].y2 ? (y1 + h_max - 1) : areas[i].y2;
+            uint64_t bytes = area_px(&tile) * SIM_PX_SIZE;
+            int64_t copy_ns = bytes * SIM_COPY_NS_PER_BYTE;
+
+            t += area_px(&tile) * SIM_RENDER_SRAM_NS;
+
+            /* The port knows only the time of the last vsync event */
+            int64_t wait_start = t;
+            uint32_t wait;
+            while (schedule && (wait = lvgl_port_tile_wait_lines(&scan, (uint32_t)((t % SIM_FRAME_NS) / SIM_LINE_NS), tile.y1, tile.y2,
+                                       (uint32_t)(copy_ns / SIM_LINE_NS + 1))) != 0) {
+                t += wait * SIM_LINE_NS;
+            }
+            st->wait += t - wait_start;
+
+            if (read_between(tile.y1, tile.y2, t, t + copy_ns)) {
+                st->torn++;
+            }
+            t += copy_ns;
+            st->psram_bytes += bytes;
+            st->tiles++;
+
+            int64_t vis = next_read(tile.y2, t);
+            *visible = vis > *visible ? vis : *visible;
+        }
+    }
+    return t;
+}
+
+static void run(const sim_scenario_t *scn, sim_mode_t mode)
+{
+    static const char *mode_names[] = {"direct", "tile (no schedule)", "tile"};
+    sim_stats_t st = {0};
+    sim_area_t areas[SIM_AREA_MAX];
+    int64_t busy = 0;
+
+    rnd_seed = 0x1234;
+    memset(prev_mask, 0, sizeof(prev_mask));
+
+    for (uint32_t u = 0; u * scn->period < SIM_DURATION; u++) {
+        int64_t update = u * scn->period;
+        uint32_t cnt = scn->areas(u, areas);
+        int64_t start = update > busy ? update : busy;
+        int64_t visible;
+
+        if (mode == SIM_MODE_DIRECT) {
+            busy = frame_direct(start, areas, cnt, &st, &visible);
+        } else {
+            busy = frame_tile(start, areas, cnt, mode == SIM_MODE_TILE, &st, &visible);
+        }
+
+        int64_t lat = visible - update;
+        st.lat_sum += lat;
+        st.lat_max = lat > st.lat_max ? lat : st.lat_max;
+        st.updates++;
+    }
+
+    double sec = (double)SIM_DURATION / 1e9;
+    printf("| %-10s | %-18s | %15.2f | %24.1f | %8.1f | %11.1f | %7.1f | %4u |\n", scn->name, mode_names[mode],
+           st.psram_bytes / sec / 1e6, (double)st.lat_sum / st.updates / 1e6, (double)st.lat_max / 1e6,
+           (double)st.wait / sec / 1e6, st.tiles / sec, (unsigned)st.torn);
+}
+
+int main(void)
+{
+    const double fb = SIM_H_RES * SIM_V_RES * SIM_PX_SIZE / 1024.0;
+    const double bounce = 2 * SIM_H_RES * SIM_BOUNCE_LINES * SIM_PX_SIZE / 1024.0;
+    const double tile = SIM_H_RES * SIM_TILE_LINES * SIM_PX_SIZE / 1024.0;
+
+    printf("Panel: %d x %d, %.1f Hz, scan-out reads %.1f MB/s of PSRAM in both modes\n\n", SIM_H_RES, SIM_V_RES,
+           1e9 / SIM_FRAME_NS, fb * 1024 * 1e9 / SIM_FRAME_NS / 1e6);
+    printf("| Mode   | PSRAM [KB] | Internal RAM [KB] |\n");
+    printf("| :----- | ---------: | ----------------: |\n");
+    printf("| direct | %10.0f | %17.1f |\n", 2 * fb, bounce);
+    printf("| tile   | %10.0f | %17.1f |\n\n", fb, bounce + tile);
+
+    printf("| Scenario   | Mode               | UI PSRAM [MB/s] | Update->visible avg [ms] | max [ms] | Wait [ms/s] | Tiles/s | Torn |\n");
+    printf("| :--------- | :----------------- | --------------: | -----------------------: | -------: | ----------: | ------: | ---: |\n");
+    for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+        run(&scenarios[i], SIM_MODE_DIRECT);
+        run(&scenarios[i], SIM_MODE_TILE_NAIVE);
+        run(&scenarios[i], SIM_MODE_TILE);
+    }
+
+    return 0;
+}
@@ -0,0 +1,319 @@
+/*
+ * Host test of the camera stream pipeline (mjpeg_parser.c and camera_stream.c of main/)
+ * against mjpeg_server.py, the stand-in of the IP camera.
+ *
+ * Every frame received over HTTP (multipart with and without Content-Length, snapshots over
+ * one kept alive connection) must decode to the same pixels as the recorded JPEG decoded
+ * from memory. The server splits the data into random small writes and the test reads
+ * into an odd sized chunk buffer, so markers and delimiters are split between reads.
+ *
+ * Run: ./run_test.sh
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include "camera_stream.h"
+
+#define FRAME_BUF_SIZE  (320 * 240 * 2)
+#define CHUNK_SIZE      97
+#define CYCLES          5       /* Each recorded frame is received this many times */
+#define MAX_FRAMES      8
+
+typedef struct {
+    int sock;
+    uint8_t buf[1024];          /* Response header bytes, and the body bytes read with them */
+    size_t buf_len;
+    size_t buf_pos;
+    long body_left;             /* -1: until the connection is closed */
+    char boundary[MJPEG_PARSER_BOUNDARY_MAX + 1];
+} http_conn_t;
+
+typedef struct {
+    uint16_t w;
+    uint16_t h;
+    uint16_t *pixels;
+} ref_frame_t;
+
+static int port;
+static ref_frame_t ref[MAX_FRAMES];
+static int ref_cnt;
+static int failures;
+
+static uint8_t chunk_buf[CHUNK_SIZE];
+static uint8_t work_buf[CAMERA_STREAM_WORK_SIZE];
+static uint16_t frame_buf[2][FRAME_BUF_SIZE / 2];
+
+#define CHECK(cond, ...) do { \
+        if (!(cond)) { \
+            printf("FAIL %s:%d: ", __FILE__, __LINE__); \
+            printf(__VA_ARGS__); \
+            printf("\n"); \
+            failures++; \
+        } \
+    } while (0)
+
+/*******************************************************************************
+* HTTP client
+*******************************************************************************/
+
+static int http_connect(void)
+{
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons(port),
+        .sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+    };
+    int sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (sock < 0 || connect(sock, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        perror("connect");
+        exit(1);
+    }
+    return sock;
+}
+
+static bool http_get(http_conn_t *conn, const char *path)
+{
+    char req[256];
+    int len = snprintf(req, sizeof(req), "GET %s HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n", path);
+    if (write(conn->sock, req, len) != len) {
+        return false;
+    }
+
+    /* Read the header, the body bytes after it are kept for http_read() */
+    conn->buf_len = 0;
+    char *end = NULL;
+    while (end == NULL) {
+        ssize_t n = read(conn->sock, conn->buf + conn->buf_len, sizeof(conn->buf) - 1 - conn->buf_len);
+        if (n <= 0) {
+            return false;
+        }
+        conn->buf_len += n;
+        conn->buf[conn->buf_len] = '\0';
+        end = strstr((char *)conn->buf, "\r\n\r\n");
+    }
+    *end = '\0';
+    conn->buf_pos = (uint8_t *)end + 4 - conn->buf;
+
+    if (strncmp((char *)conn->buf, "HTTP/1.1 200", 12) != 0) {
+        return false;
+    }
+    conn->body_left = -1;
+    conn->boundary[0] = '\0';
+    for (char *line = strtok((char *)conn->buf, "\r\n"); line; line = strtok(NULL, "\r\n")) {
+        if (strncasecmp(line, "Content-Length:", 15) == 0) {
+            conn->body_left = atol(line + 15);
+        }
+        char *b = strstr(line, "boundary=");
+        if (strncasecmp(line, "Content-Type:", 13) == 0 && b) {
+            b += strlen("boundary=");
+            b += (*b == '"');
+            size_t n = strcspn(b, "\";");
+            memcpy(conn->boundary, b, n);
+            conn->boundary[n] = '\0';
+        }
+    }
+    conn->body_left -= (conn->body_left >= 0) ? (long)(conn->buf_len - conn->buf_pos) : 0;
+    return true;
+}
+
+static int http_read(void *ctx, uint8_t *buf, size_t len)
+{
+    http_conn_t *conn = ctx;
+    if (conn->buf_pos < conn->buf_len) {
+        size_t n = conn->buf_len - conn->buf_pos;
+        n = n < len ? n : len;
+        memcpy(buf, conn->buf + conn->buf_pos, n);
+        conn->buf_pos += n;
+        return n;
+    }
+    if (conn->body_left == 0) {
+        return 0;
+    }
+    if (conn->body_left > 0 && (long)len > conn->body_left) {
+        len = conn->body_left;
+    }
+    ssize_t n = read(conn->sock, buf, len);
+    if (n > 0 && conn->body_left > 0) {
+        conn->body_left -= n;
+    }
+    return n;
+}
+
+/*******************************************************************************
+* Helpers
+*******************************************************************************/
+
+typedef struct {
+    const uint8_t *data;
+    size_t len;
+} mem_src_t;
+
+static int mem_read(void *ctx, uint8_t *buf, size_t len)
+{
+    mem_src_t *src = ctx;
+    len = len < src->len ? len : src->len;
+    memcpy(buf, src->data, len);
+    src->data += len;
+    src->len -= len;
+    return len;
+}
+
+static void stream_init(camera_stream_t *stream, camera_stream_read_cb_t read, void *ctx)
+{
+    camera_stream_config_t cfg = {
+        .read = read,
+        .read_ctx = ctx,
+        .chunk_buf = chunk_buf,
+        .chunk_size = sizeof(chunk_buf),
+        .work_buf = work_buf,
+        .frame_buf = {frame_buf[0], frame_buf[1]},
+        .frame_buf_size = FRAME_BUF_SIZE,
+    };
+    camera_stream_init(stream, &cfg);
+}
+
+/* Decode the recorded frames from memory in one piece */
+static void load_reference(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        perror(path);
+        exit(1);
+    }
+    static uint8_t jpeg[256 * 1024];
+    size_t len = fread(jpeg, 1, sizeof(jpeg), f);
+    fclose(f);
+
+    static uint8_t big_chunk[256 * 1024];
+    camera_stream_t stream;
+    mem_src_t src = {jpeg, len};
+    stream_init(&stream, mem_read, &src);
+    stream.cfg.chunk_buf = big_chunk;
+    stream.cfg.chunk_size = sizeof(big_chunk);
+
+    if (camera_stream_next(&stream, false) != CAMERA_STREAM_FRAME) {
+        printf("Can't decode %s\n", path);
+        exit(1);
+    }
+    ref_frame_t *r = &ref[ref_cnt++];
+    const uint16_t *pixels = camera_stream_get_frame(&stream, &r->w, &r->h);
+    r->pixels = malloc(r->w * r->h * 2);
+    memcpy(r->pixels, pixels, r->w * r->h * 2);
+}
+
+static void check_frame(camera_stream_t *stream, int idx, const char *name)
+{
+    const ref_frame_t *r = &ref[idx % ref_cnt];
+    uint16_t w, h;
+    const uint16_t *pixels = camera_stream_get_frame(stream, &w, &h);
+    CHECK(w == r->w && h == r->h, "%s frame %d: %dx%d instead of %dx%d", name, idx, w, h, r->w, r->h);
+    if (w == r->w && h == r->h) {
+        CHECK(memcmp(pixels, r->pixels, w * h * 2) == 0, "%s frame %d: pixels differ", name, idx);
+    }
+}
+
+static void print_stats(const char *name, const camera_stream_t *stream)
+{
+    const camera_stream_stats_t *stats = camera_stream_get_stats(stream);
+    printf("%-16s %3u frames, %3u dropped, decode max %5u us\n", name,
+           (unsigned)stats->frames, (unsigned)stats->dropped, (unsigned)stats->decode_us_max);
+}
+
+/*******************************************************************************
+* Tests
+*******************************************************************************/
+
+/* Receive a multipart stream; skip every `skip_every`th frame (0: none) */
+static void test_stream(const char *name, const char *path, int skip_every)
+{
+    http_conn_t conn = {.sock = http_connect()};
+    camera_stream_t stream;
+    int total = CYCLES * ref_cnt;
+    int skipped = 0;
+
+    stream_init(&stream, http_read, &conn);
+    CHECK(http_get(&conn, path), "%s: request failed", name);
+    CHECK(conn.boundary[0] != '\0', "%s: no boundary", name);
+    camera_stream_reset(&stream, conn.boundary);
+
+    for (int i = 0; i < total; i++) {
+        bool skip = skip_every && (i % skip_every) == skip_every - 1;
+        camera_stream_res_t res = camera_stream_next(&stream, skip);
+        if (skip) {
+            CHECK(res == CAMERA_STREAM_DROPPED, "%s frame %d: not skipped (%d)", name, i, res);
+            skipped++;
+            continue;
+        }
+        CHECK(res == CAMERA_STREAM_FRAME, "%s frame %d: result %d", name, i, res);
+        check_frame(&stream, i, name);
+        camera_stream_swap(&stream);
+    }
+    CHECK(camera_stream_next(&stream, false) == CAMERA_STREAM_EOF, "%s: no EOF after the last frame", name);
+
+    const camera_stream_stats_t *stats = camera_stream_get_stats(&stream);
+    CHECK((int)stats->frames == total - skipped, "%s: %u frames decoded", name, (unsigned)stats->frames);
+    CHECK((int)stats->dropped == skipped, "%s: %u frames dropped", name, (unsigned)stats->dropped);
+    print_stats(name, &stream);
+    close(conn.sock);
+}
+
+/* Poll snapshots over one kept alive connection */
+static void test_snapshots(void)
+{
+    http_conn_t conn = {.sock = http_connect()};
+    camera_stream_t stream;
+    int total = CYCLES * ref_cnt;
+
+    stream_init(&stream, http_read, &conn);
+    for (int i = 0; i < total; i++) {
+        CHECK(http_get(&conn, "/snap"), "snapshot %d: request failed", i);
+        camera_stream_reset(&stream, conn.boundary[0] ? conn.boundary : NULL);
+        CHECK(camera_stream_next(&stream, false) == CAMERA_STREAM_FRAME, "snapshot %d: not decoded", i);
+        check_frame(&stream, i, "snapshot");
+        camera_stream_swap(&stream);
+        CHECK(camera_stream_next(&stream, false) == CAMERA_STREAM_EOF, "snapshot %d: no EOF", i);
+    }
+    print_stats("snapshots", &stream);
+    close(conn.sock);
+}
+
+/* A stream cut within a frame */
+static void test_truncated(void)
+{
+    const uint8_t *jpeg = (const uint8_t *)"--b\r\nContent-Type: image/jpeg\r\n\r\n\xFF\xD8\xFF\xDB\x00\x43\x00\x01";
+    mem_src_t src = {jpeg, strlen((const char *)jpeg)};
+    camera_stream_t stream;
+
+    stream_init(&stream, mem_read, &src);
+    camera_stream_reset(&stream, "b");
+    CHECK(camera_stream_next(&stream, false) == CAMERA_STREAM_EOF, "truncated: no EOF");
+    CHECK(camera_stream_get_stats(&stream)->dropped == 1, "truncated: not counted as dropped");
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 3) {
+        printf("Usage: %s <port> <recorded frames>...\n", argv[0]);
+        return 1;
+    }
+    port = atoi(argv[1]);
+    for (int i = 2; i < argc && ref_cnt < MAX_FRAMES; i++) {
+        load_reference(argv[i]);
+    }
+    char path[64];
+    snprintf(path, sizeof(path), "/stream?frames=%d", CYCLES * ref_cnt);
+    test_stream("stream", path, 0);
+    snprintf(path, sizeof(path), "/stream?frames=%d&nolen=1", CYCLES * ref_cnt);
+    test_stream("stream no length", path, 0);
+    test_stream("stream skipping", path, 3);
+    test_snapshots();
+    test_truncated();
+
+    printf("%s\n", failures ? "FAILED" : "PASSED");
+    return failures ? 1 : 0;
+}
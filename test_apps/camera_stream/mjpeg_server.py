@@ -0,0 +1,107 @@
+#!/usr/bin/env python3
+# Stand-in for the IP camera: serves recorded JPEG frames over HTTP/1.1
+#
+#   /stream            multipart/x-mixed-replace MJPEG stream, parts with Content-Length
+#   /stream?nolen=1    the same without Content-Length in the parts
+#   /snap              one frame per request, the connection is kept alive
+#
+# The frames are sent in small writes of random size to split the markers and the
+# multipart delimiters between reads. Every connection starts with the first frame.
+
+import argparse
+import os
+import random
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from urllib.parse import parse_qs, urlparse
+
+BOUNDARY = 'frame-boundary'
+HERE = os.path.dirname(os.path.abspath(__file__))
+JPEG_DIR = os.path.join(HERE, '../../managed_components/espressif__esp_jpeg')
+DEFAULT_FRAMES = [
+    os.path.join(JPEG_DIR, 'examples/get_started/main/image.jpg'),
+    os.path.join(JPEG_DIR, 'test_apps/main/logo.jpg'),
+    os.path.join(JPEG_DIR, 'test_apps/main/usb_camera_2.jpg'),
+]
+
+
+class CameraHandler(BaseHTTPRequestHandler):
+    protocol_version = 'HTTP/1.1'
+
+    def setup(self):
+        super().setup()
+        self.frame_idx = 0
+        self.rng = random.Random(self.server.seed)
+
+    def log_message(self, format, *args):
+        pass
+
+    def write_split(self, data):
+        pos = 0
+        while pos < len(data):
+            n = self.rng.randint(1, self.server.max_write)
+            self.wfile.write(data[pos:pos + n])
+            self.wfile.flush()
+            pos += n
+
+    def next_frame(self):
+        frame = self.server.frames[self.frame_idx % len(self.server.frames)]
+        self.frame_idx += 1
+        return frame
+
+    def do_GET(self):
+        url = urlparse(self.path)
+        query = parse_qs(url.query)
+        if url.path == '/snap':
+            frame = self.next_frame()
+            self.send_response(200)
+            self.send_header('Content-Type', 'image/jpeg')
+            self.send_header('Content-Length', str(len(frame)))
+            self.end_headers()
+            self.write_split(frame)
+        elif url.path == '/stream':
+            count = int(query.get('frames', ['0'])[0])
+            nolen = query.get('nolen', ['0'])[0] == '1'
+            self.send_response(200)
+            self.send_header('Content-Type', 'multipart/x-mixed-replace; boundary="%s"' % BOUNDARY)
+            self.send_header('Connection', 'close')
+            self.end_headers()
+            self.close_connection = True
+            sent = 0
+            while count == 0 or sent < count:
+                frame = self.next_frame()
+                part = '--%s\r\nContent-Type: image/jpeg\r\n' % BOUNDARY
+                if not nolen:
+                    part += 'Content-Length: %d\r\n' % len(frame)
+                try:
+                    self.write_split(part.encode() + b'\r\n' + frame + b'\r\n')
+                except (BrokenPipeError, ConnectionResetError):
+                    return
+                sent += 1
+                if self.server.period:
+                    time.sleep(self.server.period)
+            self.wfile.write(('--%s--\r\n' % BOUNDARY).encode())
+        else:
+            self.send_error(404)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='IP camera stand-in serving recorded JPEG frames')
+    parser.add_argument('--host', default='127.0.0.1')
+    parser.add_argument('--port', type=int, default=8080)
+    parser.add_argument('--fps', type=float, default=0, help='Stream frame rate, 0: as fast as possible')
+    parser.add_argument('--max-write', type=int, default=700, help='Largest write in bytes')
+    parser.add_argument('--seed', type=int, default=1)
+    parser.add_argument('frames', nargs='*', default=DEFAULT_FRAMES, help='Recorded JPEG frames')
+    args = parser.parse_args()
+
+    server = ThreadingHTTPServer((args.host, args.port), CameraHandler)
+    server.frames = [open(f, 'rb').read() for f in args.frames]
+    server.period = 1.0 / args.fps if args.fps else 0
+    server.max_write = args.max_write
+    server.seed = args.seed
+    server.serve_forever()
+
+
+if __name__ == '__main__':
+    main()
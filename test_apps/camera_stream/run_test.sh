@@ -0,0 +1,24 @@
+#!/bin/sh
+# Build the test for both decoder outputs (RGB565 and RGB888 like the ROM decoder) and run it
+# against the camera stand-in
+set -e
+cd "$(dirname "$0")"
+
+ROOT=../..
+JPEG=$ROOT/managed_components/espressif__esp_jpeg
+PORT=${PORT:-18080}
+FRAMES="$JPEG/examples/get_started/main/image.jpg $JPEG/test_apps/main/logo.jpg $JPEG/test_apps/main/usb_camera_2.jpg"
+
+python3 mjpeg_server.py --port "$PORT" $FRAMES &
+SERVER=$!
+trap 'kill $SERVER' EXIT
+sleep 1
+
+for FORMAT in 1 0; do
+    cc -O2 -Wall -Wextra -DCONFIG_JD_FORMAT=$FORMAT -I. -I$ROOT/main -I$JPEG/tjpgd \
+        camera_stream_test.c $ROOT/main/camera_stream.c $ROOT/main/mjpeg_parser.c $JPEG/tjpgd/tjpgd.c \
+        -o camera_stream_test
+    echo "JD_FORMAT=$FORMAT"
+    ./camera_stream_test "$PORT" $FRAMES
+done
+rm -f camera_stream_test
@@ -0,0 +1,11 @@
+// Host build of tjpgd: the configuration of esp_jpeg without the ROM decoder
+#pragma once
+
+#define CONFIG_JD_USE_ROM 0
+#define CONFIG_JD_SZBUF 512
+#ifndef CONFIG_JD_FORMAT
+#define CONFIG_JD_FORMAT 1  // 0: RGB888 output like the ROM decoder
+#endif
+#define CONFIG_JD_USE_SCALE 1
+#define CONFIG_JD_TBLCLIP 1
+#define CONFIG_JD_FASTDECODE 1
@@ -0,0 +1,366 @@
+/*
+ * Host test and benchmark of the MQTT topic router (mqtt_router.c of main/).
+ *
+ * The matching rules (exact levels, '+', '#', '$' topics, invalid patterns, several routes
+ * of one topic) are checked first. Then a recorded capture of the broker traffic (one
+ * "topic payload" line per message, as printed by mosquitto_sub -v) is replayed through the
+ * routes of the device and through the strstr/snprintf dispatch the router replaced.
+ *
+ * Run: ./run_test.sh [capture.txt]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "mqtt_router.h"
+
+#define REPLAY_ROUNDS   200
+#define MSG_MAX         4096
+
+typedef struct {
+    const char *topic;
+    size_t topic_len;
+    const char *data;
+    size_t data_len;
+} msg_t;
+
+static int failures;
+
+#define CHECK(cond, ...) do { \
+        if (!(cond)) { \
+            printf("FAIL %s:%d: ", __FILE__, __LINE__); \
+            printf(__VA_ARGS__); \
+            printf("\n"); \
+            failures++; \
+        } \
+    } while (0)
+
+/*******************************************************************************
+ * Matching rules
+ ******************************************************************************/
+
+static char call_log[256];
+
+static void log_cb(const char *topic, size_t topic_len, const char *data, size_t data_len, void *user_data)
+{
+    (void)topic;
+    (void)topic_len;
+    (void)data;
+    (void)data_len;
+    strncat(call_log, user_data, sizeof(call_log) - strlen(call_log) - 1);
+}
+
+static int on_off_last = -1;
+
+static void on_off_cb(bool on, void *user_data)
+{
+    (void)user_data;
+    on_off_last = on;
+}
+
+// Dispatch a topic and return the names of the called routes
+static const char *route(mqtt_router_t *router, const char *topic)
+{
+    call_log[0] = '\0';
+    mqtt_router_dispatch(router, topic, strlen(topic), "", 0);
+    return call_log;
+}
+
+static void test_matching(void)
+{
+    static mqtt_router_t router;
+    mqtt_router_init(&router);
+
+    CHECK(mqtt_router_add_raw(&router, "water_valve/cmd", log_cb, "A") == 0, "add");
+    CHECK(mqtt_router_add_raw(&router, "homeassistant/+/hallway_motion/state", log_cb, "B") == 1, "add");
+    CHECK(mqtt_router_add_raw(&router, "zigbee2mqtt/#", log_cb, "C") == 2, "add");
+    CHECK(mqtt_router_add_raw(&router, "+/+", log_cb, "D") == 3, "add");
+    CHECK(mqtt_router_add_raw(&router, "water_valve/cmd", log_cb, "E") == 4, "add");
+
+    const struct {
+        const char *topic;
+        const char *routes;
+    } cases[] = {
+        {"water_valve/cmd", "AED"},
+        {"water_valve/cmdx", "D"},                 // strstr matched these two
+        {"x/water_valve/cmd", ""},
+        {"water_valve", ""},
+        {"homeassistant/binary_sensor/hallway_motion/state", "B"},
+        {"homeassistant/binary_sensor/hallway_motion", ""},
+        {"homeassistant//hallway_motion/state", "B"},  // '+' matches an empty level
+        {"zigbee2mqtt", "C"},                      // '#' matches the parent level too
+        {"zigbee2mqtt/office_sensor", "CD"},
+        {"zigbee2mqtt/bridge/state", "C"},
+        {"zigbee2mqtt/", "CD"},
+        {"a/", "D"},
+        {"$SYS/broker", ""},                        // No wildcards at the first level of '$' topics
+    };
+    size_t i;
+    for (i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        const char *res = route(&router, cases[i].topic);
+        CHECK(strcmp(res, cases[i].routes) == 0, "%s: called \"%s\" instead of \"%s\"", cases[i].topic, res,
+              cases[i].routes);
+    }
+
+    // The topic is a slice of the received message, it's not '\0' terminated
+    const char msg[] = "water_valve/cmdON";
+    call_log[0] = '\0';
+    CHECK(mqtt_router_dispatch(&router, msg, 15, msg + 15, 2) == 3, "slice");
+
+    // The counters
+    CHECK(router.routes[0].count == 2, "count A %u", (unsigned)router.routes[0].count);
+    CHECK(router.routes[2].count == 4, "count C %u", (unsigned)router.routes[2].count);
+    CHECK(router.unmatched == 4, "unmatched %u", (unsigned)router.unmatched);
+
+    // '#' and '$'
+    mqtt_router_init(&router);
+    CHECK(mqtt_router_add_raw(&router, "#", log_cb, "A") == 0, "add");
+    CHECK(mqtt_router_add_raw(&router, "$SYS/#", log_cb, "B") == 1, "add");
+    CHECK(strcmp(route(&router, "a/b/c"), "A") == 0, "#");
+    CHECK(strcmp(route(&router, "$SYS/broker/uptime"), "B") == 0, "$SYS");
+
+    // Invalid patterns
+    CHECK(mqtt_router_add_raw(&router, "a/#/b", log_cb, "X") < 0, "# not last");
+    CHECK(mqtt_router_add_raw(&router, "a/b#", log_cb, "X") < 0, "# in a level");
+    CHECK(mqtt_router_add_raw(&router, "a+/b", log_cb, "X") < 0, "+ in a level");
+    CHECK(mqtt_router_add_raw(&router, "", log_cb, "X") < 0, "empty");
+    CHECK(mqtt_router_add_raw(&router, "a/b", NULL, "X") < 0, "no handler");
+    CHECK(router.node_cnt == 2 && router.route_cnt == 2, "invalid patterns left nodes or routes behind");
+
+    // Full
+    int res = 0;
+    for (i = 0; i < MQTT_ROUTER_ROUTES_MAX; i++) {
+        res = mqtt_router_add_raw(&router, "a/b", log_cb, "X");
+    }
+    CHECK(res < 0 && router.route_cnt == MQTT_ROUTER_ROUTES_MAX, "too many routes");
+
+    // Out of nodes in the middle of a pattern: nothing is added, the existing patterns still work
+    mqtt_router_init(&router);
+    static char deep[MQTT_ROUTER_NODES_MAX * 3];
+    size_t len = 0;
+    for (i = 0; i < MQTT_ROUTER_NODES_MAX - 3; i++) {
+        len += snprintf(deep + len, sizeof(deep) - len, i ? "/%u" : "%u", (unsigned)i);
+    }
+    CHECK(mqtt_router_add_raw(&router, deep, log_cb, "L") == 0 && router.node_cnt == MQTT_ROUTER_NODES_MAX - 2,
+          "deep pattern");
+    uint8_t node_cnt = router.node_cnt;
+    uint8_t route_cnt = router.route_cnt;
+    CHECK(mqtt_router_add_raw(&router, "x/y/z", log_cb, "X") < 0, "a pattern added without enough nodes");
+    CHECK(router.node_cnt == node_cnt && router.route_cnt == route_cnt, "a failed pattern left nodes behind");
+    CHECK(mqtt_router_add_raw(&router, "0/y", log_cb, "Y") >= 0, "a pattern with enough nodes not added");
+    CHECK(strcmp(route(&router, "0/y"), "Y") == 0 && strcmp(route(&router, "x/y/z"), "") == 0, "after full");
+
+    // ON/OFF payloads, each client with the rules of its handler before the router:
+    // MQTT_ON_PREFIX like strncmp(data, "ON", data_len) of mqtt.c,
+    // MQTT_ON_STARTS like strncmp(data, "ON", 2) of mqtt_relay_client.c, empty payloads ignored (-1)
+    mqtt_router_init(&router);
+    mqtt_router_add_on_off(&router, "vacuum_pump/cmd", MQTT_ON_PREFIX, on_off_cb, NULL);
+    mqtt_router_add_on_off(&router, "relay1/cmd", MQTT_ON_STARTS, on_off_cb, NULL);
+    const char *payloads[] = {"ON", "OFF", "O", "", "ONX", "on"};
+    const int expected_prefix[] = {1, 0, 1, 1, 0, 0};
+    const int expected_starts[] = {1, 0, 0, -1, 1, 0};
+    for (i = 0; i < sizeof(payloads) / sizeof(payloads[0]); i++) {
+        on_off_last = -1;
+        mqtt_router_dispatch(&router, "vacuum_pump/cmd", 15, payloads[i], strlen(payloads[i]));
+        CHECK(on_off_last == expected_prefix[i], "prefix, payload %s: %d", payloads[i], on_off_last);
+        on_off_last = -1;
+        CHECK(mqtt_router_dispatch(&router, "relay1/cmd", 10, payloads[i], strlen(payloads[i])) == 1,
+              "starts, payload %s not matched", payloads[i]);
+        CHECK(on_off_last == expected_starts[i], "starts, payload %s: %d", payloads[i], on_off_last);
+    }
+}
+
+/*******************************************************************************
+ * Replay of the capture
+ ******************************************************************************/
+
+#define NUM_RELAYS 3
+static const char *relay_ids[NUM_RELAYS] = {"vacuum_pump", "central_vac", "water_valve"};
+static unsigned relay_on[NUM_RELAYS];
+static unsigned diag_cnt;
+static unsigned log_len;
+
+static void relay_cb(bool on, void *user_data)
+{
+    relay_on[(size_t)user_data] += on;
+}
+
+static void diag_cb(const char *topic, size_t topic_len, const char *data, size_t data_len, void *user_data)
+{
+    (void)topic;
+    (void)topic_len;
+    (void)data;
+    (void)data_len;
+    (void)user_data;
+    diag_cnt++;
+}
+
+// The line of the log view, formatted from the slices of the message
+static void log_view_cb(const char *topic, size_t topic_len, const char *data, size_t data_len, void *user_data)
+{
+    char line[128];
+    (void)user_data;
+    int len = snprintf(line, sizeof(line), "[%.*s]: %.*s", (int)topic_len, topic, (int)data_len, data);
+    log_len += len < (int)sizeof(line) - 1 ? len : (int)sizeof(line) - 1;
+}
+
+// The dispatch before the router: both handlers got every message, copied it into
+// '\0' terminated buffers and searched the topic with strstr or formatted the expected topics
+static void legacy_dispatch(const msg_t *m)
+{
+    char topic[256];
+    char data[256];
+    char event_text[1024];
+    int tlen = m->topic_len < 255 ? (int)m->topic_len : 255;
+    int dlen = m->data_len < 255 ? (int)m->data_len : 255;
+
+    // Relay commands
+    memcpy(topic, m->topic, tlen);
+    topic[tlen] = '\0';
+    memcpy(data, m->data, dlen);
+    data[dlen] = '\0';
+    int i;
+    for (i = 0; i < NUM_RELAYS; i++) {
+        char expected_topic[64];
+        snprintf(expected_topic, sizeof(expected_topic), "%s/cmd", relay_ids[i]);
+        if (strcmp(topic, expected_topic) == 0) {
+            relay_on[i] += (strncmp(data, "ON", dlen) == 0);
+            break;
+        }
+    }
+    if (strstr(topic, "esp32_office_controller/diag/cmd")) {
+        diag_cnt++;
+    }
+
+    // Log view
+    memcpy(topic, m->topic, tlen);
+    topic[tlen] = '\0';
+    memcpy(data, m->data, dlen);
+    data[dlen] = '\0';
+    snprintf(event_text, sizeof(event_text), "[%s]: %s", topic, data);
+    log_len += strlen(event_text) < 127 ? strlen(event_text) : 127;
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static size_t load_capture(const char *path, msg_t *msgs, size_t max, char **text)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        return 0;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    *text = malloc(size + 1);
+    size_t read = fread(*text, 1, size, f);
+    fclose(f);
+    (*text)[read] = '\0';
+
+    // The messages point into the text, like the received ones point into the buffer of the MQTT client
+    size_t cnt = 0;
+    char *line = *text;
+    while (*line && cnt < max) {
+        char *eol = strchr(line, '\n');
+        char *next = eol ? eol + 1 : line + strlen(line);
+        char *end = eol ? eol : next;
+        char *space = memchr(line, ' ', end - line);
+        if (space && space > line) {
+            msgs[cnt].topic = line;
+            msgs[cnt].topic_len = space - line;
+            msgs[cnt].data = space + 1;
+            msgs[cnt].data_len = end - space - 1;
+            cnt++;
+        }
+        line = next;
+    }
+    return cnt;
+}
+
+static void test_replay(const char *path)
+{
+    static msg_t msgs[MSG_MAX];
+    char *text = NULL;
+    size_t cnt = load_capture(path, msgs, MSG_MAX, &text);
+    CHECK(cnt > 0, "no messages in %s", path);
+    if (cnt == 0) {
+        free(text);
+        return;
+    }
+
+    // The routes of the device (main/mqtt.c)
+    static mqtt_router_t router;
+    mqtt_router_init(&router);
+    size_t i;
+    for (i = 0; i < NUM_RELAYS; i++) {
+        static char patterns[NUM_RELAYS][32];
+        snprintf(patterns[i], sizeof(patterns[i]), "%s/cmd", relay_ids[i]);
+        mqtt_router_add_on_off(&router, patterns[i], MQTT_ON_PREFIX, relay_cb, (void *)i);
+    }
+    mqtt_router_add_raw(&router, "esp32_office_controller/diag/cmd", diag_cb, NULL);
+    mqtt_router_add_raw(&router, "#", log_view_cb, NULL);
+
+    unsigned legacy_on[NUM_RELAYS];
+    unsigned legacy_diag;
+    unsigned legacy_log;
+    unsigned round;
+
+    memset(relay_on, 0, sizeof(relay_on));
+    diag_cnt = 0;
+    log_len = 0;
+    uint64_t t = now_ns();
+    for (round = 0; round < REPLAY_ROUNDS; round++) {
+        for (i = 0; i < cnt; i++) {
+            legacy_dispatch(&msgs[i]);
+        }
+    }
+    uint64_t t_legacy = now_ns() - t;
+    memcpy(legacy_on, relay_on, sizeof(relay_on));
+    legacy_diag = diag_cnt;
+    legacy_log = log_len;
+
+    memset(relay_on, 0, sizeof(relay_on));
+    diag_cnt = 0;
+    log_len = 0;
+    t = now_ns();
+    for (round = 0; round < REPLAY_ROUNDS; round++) {
+        for (i = 0; i < cnt; i++) {
+            mqtt_router_dispatch(&router, msgs[i].topic, msgs[i].topic_len, msgs[i].data, msgs[i].data_len);
+        }
+    }
+    uint64_t t_router = now_ns() - t;
+
+    // Both dispatch the same messages to the same handlers
+    CHECK(memcmp(legacy_on, relay_on, sizeof(relay_on)) == 0, "relay commands differ");
+    CHECK(legacy_diag == diag_cnt, "diag commands differ: %u, %u", legacy_diag, diag_cnt);
+    CHECK(legacy_log == log_len, "log lines differ: %u, %u", legacy_log, log_len);
+
+    uint64_t msg_cnt = (uint64_t)cnt * REPLAY_ROUNDS;
+    printf("%s: %zu messages x %d\n", path, cnt, REPLAY_ROUNDS);
+    printf("  strstr/snprintf dispatch: %6.1f ns/message\n", (double)t_legacy / msg_cnt);
+    printf("  router:                   %6.1f ns/message\n", (double)t_router / msg_cnt);
+    for (i = 0; i < router.route_cnt; i++) {
+        printf("  %-34s %8u\n", router.routes[i].pattern, (unsigned)(router.routes[i].count / REPLAY_ROUNDS));
+    }
+    printf("  %-34s %8u\n", "(unmatched)", (unsigned)(router.unmatched / REPLAY_ROUNDS));
+    free(text);
+}
+
+int main(int argc, char **argv)
+{
+    test_matching();
+    test_replay(argc > 1 ? argv[1] : "ha_capture.txt");
+
+    if (failures) {
+        printf("%d checks failed\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
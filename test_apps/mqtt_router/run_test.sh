@@ -0,0 +1,9 @@
+#!/bin/sh
+# Build the router test and replay the capture (or the one given as argument) through it
+set -e
+cd "$(dirname "$0")"
+
+ROOT=../..
+cc -O2 -Wall -Wextra -I$ROOT/main mqtt_router_test.c $ROOT/main/mqtt_router.c -o mqtt_router_test
+./mqtt_router_test "$@"
+rm -f mqtt_router_test
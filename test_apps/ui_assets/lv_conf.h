@@ -0,0 +1,21 @@
+// LVGL configuration of the host test: the color format of the device, the rest is the default
+#ifndef LV_CONF_H
+#define LV_CONF_H
+
+#define LV_COLOR_DEPTH 16
+#define LV_COLOR_16_SWAP 0
+#define LV_MEM_SIZE (256U * 1024U)
+
+// The cache copies the decoded images, so a copy of the mapped pixels would show up
+#define LV_IMG_CACHE_DEF_SIZE 8
+#define LV_IMG_CACHE_MEM_INCLUDE <stdlib.h>
+#define LV_IMG_CACHE_MEM_ALLOC malloc
+#define LV_IMG_CACHE_MEM_FREE free
+
+#define LV_USE_FONT_COMPRESSED 1
+
+// lv_font_load() of the same fonts to compare the RAM usage
+#define LV_USE_FS_STDIO 1
+#define LV_FS_STDIO_LETTER 'A'
+
+#endif // LV_CONF_H
@@ -0,0 +1,76 @@
+#!/usr/bin/env python3
+# Write the test images of ui_assets_test.c to the given directory. The pixels are computed
+# from the coordinates, the test computes the same to check the packed images.
+
+import os
+import struct
+import sys
+import zlib
+
+
+def color(x, y):
+    return (x * 6) & 0xFF, (y * 8) & 0xFF, ((x + y) * 3) & 0xFF
+
+
+def alpha(x, y):
+    return (x * y * 7) & 0xFF
+
+
+def chunk(ctype, data):
+    return struct.pack('>I', len(data)) + ctype + data + struct.pack('>I', zlib.crc32(ctype + data))
+
+
+def filter_rows(rows, bpp):
+    # A different filter on every row to test the unfiltering of the packer
+    out = bytearray()
+    prev = bytes(len(rows[0]))
+    for y, row in enumerate(rows):
+        ftype = y % 5
+        out.append(ftype)
+        for i, v in enumerate(row):
+            a = row[i - bpp] if i >= bpp else 0
+            b = prev[i]
+            c = prev[i - bpp] if i >= bpp else 0
+            if ftype == 1:
+                v -= a
+            elif ftype == 2:
+                v -= b
+            elif ftype == 3:
+                v -= (a + b) >> 1
+            elif ftype == 4:
+                p = a + b - c
+                pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+                v -= a if pa <= pb and pa <= pc else (b if pb <= pc else c)
+            out.append(v & 0xFF)
+        prev = row
+    return bytes(out)
+
+
+def write_png(path, w, h, color_type, rows, bpp, depth=8, extra=b''):
+    ihdr = struct.pack('>IIBBBBB', w, h, depth, color_type, 0, 0, 0)
+    with open(path, 'wb') as f:
+        f.write(b'\x89PNG\r\n\x1a\n' + chunk(b'IHDR', ihdr) + extra +
+                chunk(b'IDAT', zlib.compress(filter_rows(rows, bpp))) + chunk(b'IEND', b''))
+
+
+def main():
+    out = sys.argv[1]
+    os.makedirs(out, exist_ok=True)
+    w, h = 40, 30
+
+    write_png(os.path.join(out, 'rgb.png'), w, h, 2,
+              [bytes(c for x in range(w) for c in color(x, y)) for y in range(h)], 3)
+    write_png(os.path.join(out, 'argb.png'), w, h, 6,
+              [bytes(c for x in range(w) for c in color(x, y) + (alpha(x, y),)) for y in range(h)], 4)
+    # 4 bit palette, index 0 is transparent
+    palette = b''.join(bytes((i * 16, 255 - i * 16, i * 8)) for i in range(16))
+    rows = [bytes((((x + y) % 16) << 4) | ((x + 1 + y) % 16) for x in range(0, w, 2)) for y in range(h)]
+    write_png(os.path.join(out, 'pal.png'), w, h, 3, rows, 1, 4,
+              chunk(b'PLTE', palette) + chunk(b'tRNS', b'\x00'))
+    # Gray with alpha, packed as A8 of the alpha
+    write_png(os.path.join(out, 'mask.a8.png'), w, h, 4,
+              [bytes(c for x in range(w) for c in (128, alpha(x, y))) for y in range(h)], 2)
+
+
+if __name__ == '__main__':
+    main()
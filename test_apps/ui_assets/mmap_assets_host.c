@@ -0,0 +1,153 @@
+/*
+ * Host stand-in of esp_mmap_assets: the "partition" is a file (partition_label is its path)
+ * mapped read only with mmap(). The table is walked like esp_mmap_assets.c does it, so the
+ * asset pointers depend on max_files the same way. Writing to an asset crashes the test.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "sdkconfig.h"
+#include "esp_mmap_assets.h"
+
+#define ASSETS_TABLE_OFFSET 12
+#define ASSETS_FILE_MAGIC_LEN 2
+
+#pragma pack(1)
+typedef struct {
+    char asset_name[CONFIG_MMAP_FILE_NAME_LENGTH];
+    uint32_t asset_size;
+    uint32_t asset_offset;
+    uint16_t asset_width;
+    uint16_t asset_height;
+} mmap_assets_table_t;
+#pragma pack()
+
+typedef struct mmap_assets_t {
+    const uint8_t *root;
+    size_t len;
+    const mmap_assets_table_t *table;
+    int max_files;
+    int stored_files;
+} mmap_assets_t;
+
+// The last mapping, for the test to check where the assets are used from
+const uint8_t *mmap_assets_host_map;
+size_t mmap_assets_host_len;
+
+esp_err_t mmap_assets_new(const mmap_assets_config_t *config, mmap_assets_handle_t *ret_item)
+{
+    if (!config || !ret_item || !config->flags.mmap_enable) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    int fd = open(config->partition_label, O_RDONLY);
+    if (fd < 0) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    struct stat st;
+    const uint8_t *root = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size >= ASSETS_TABLE_OFFSET) {
+        root = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (root == MAP_FAILED) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    mmap_assets_t *assets = calloc(1, sizeof(mmap_assets_t));
+    if (!assets) {
+        munmap((void *)root, st.st_size);
+        return ESP_ERR_NO_MEM;
+    }
+    assets->root = root;
+    assets->len = st.st_size;
+    assets->table = (const mmap_assets_table_t *)(root + ASSETS_TABLE_OFFSET);
+    assets->max_files = config->max_files;
+    memcpy(&assets->stored_files, root, sizeof(int));
+
+    esp_err_t ret = ESP_OK;
+    if (config->flags.full_check) {
+        uint32_t stored_len, stored_chksum, sum = 0;
+        memcpy(&stored_chksum, root + 4, 4);
+        memcpy(&stored_len, root + 8, 4);
+        for (uint32_t i = 0; i < stored_len && ASSETS_TABLE_OFFSET + i < assets->len; i++) {
+            sum += root[ASSETS_TABLE_OFFSET + i];
+        }
+        if ((sum & 0xFFFF) != stored_chksum) {
+            ret = ESP_ERR_INVALID_CRC;
+        }
+    }
+    for (int i = 0; ret == ESP_OK && config->flags.metadata_check && i < assets->max_files; i++) {
+        const uint8_t *mem = mmap_assets_get_mem(assets, i) - ASSETS_FILE_MAGIC_LEN;
+        if (mem + ASSETS_FILE_MAGIC_LEN > root + assets->len || mem[0] != 0x5A || mem[1] != 0x5A) {
+            ret = ESP_ERR_INVALID_CRC;
+        }
+    }
+    if (ret != ESP_OK) {
+        mmap_assets_del(assets);
+        return ret;
+    }
+    mmap_assets_host_map = assets->root;
+    mmap_assets_host_len = assets->len;
+    *ret_item = assets;
+    return ESP_OK;
+}
+
+esp_err_t mmap_assets_del(mmap_assets_handle_t handle)
+{
+    if (!handle) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    munmap((void *)handle->root, handle->len);
+    free(handle);
+    return ESP_OK;
+}
+
+const uint8_t *mmap_assets_get_mem(mmap_assets_handle_t handle, int index)
+{
+    if (index >= handle->max_files) {
+        return NULL;
+    }
+    return handle->root + ASSETS_TABLE_OFFSET + handle->max_files * sizeof(mmap_assets_table_t) +
+           handle->table[index].asset_offset + ASSETS_FILE_MAGIC_LEN;
+}
+
+size_t mmap_assets_copy_mem(mmap_assets_handle_t handle, size_t offset, void *dest_buffer, size_t size)
+{
+    if (offset >= handle->len) {
+        return 0;
+    }
+    if (size > handle->len - offset) {
+        size = handle->len - offset;
+    }
+    memcpy(dest_buffer, handle->root + offset, size);
+    return size;
+}
+
+const char *mmap_assets_get_name(mmap_assets_handle_t handle, int index)
+{
+    return index < handle->max_files ? handle->table[index].asset_name : NULL;
+}
+
+int mmap_assets_get_size(mmap_assets_handle_t handle, int index)
+{
+    return index < handle->max_files ? (int)handle->table[index].asset_size : -1;
+}
+
+int mmap_assets_get_width(mmap_assets_handle_t handle, int index)
+{
+    return index < handle->max_files ? handle->table[index].asset_width : -1;
+}
+
+int mmap_assets_get_height(mmap_assets_handle_t handle, int index)
+{
+    return index < handle->max_files ? handle->table[index].asset_height : -1;
+}
+
+int mmap_assets_get_stored_files(mmap_assets_handle_t handle)
+{
+    return handle ? handle->stored_files : 0;
+}
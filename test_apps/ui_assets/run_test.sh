@@ -0,0 +1,59 @@
+#!/bin/sh
+# Pack the test images and fonts, build LVGL with ui_assets.c and the mmap stand-in and run the test
+set -e
+cd "$(dirname "$0")"
+
+ROOT=../..
+LVGL=$ROOT/components/lvgl__lvgl
+FONTS=$LVGL/tests/src/test_fonts
+BUILD=build
+mkdir -p $BUILD/assets
+
+python3 make_pngs.py $BUILD/assets
+cp $FONTS/font_1.fnt $FONTS/font_2.fnt $BUILD/assets
+cp $FONTS/font_1.fnt $BUILD/assets/font_bad.fnt
+cp $FONTS/font_1.fnt $BUILD/assets/font_bad_cmap.fnt
+# Packed like the others, but the bitmap of the last glyph of font_bad points past the end of its payload,
+# and the last cmap of font_bad_cmap maps to glyph IDs past the glyph descriptors
+python3 - $ROOT/tools -o $BUILD/assets.bin $BUILD/assets <<'EOF'
+import struct
+import sys
+sys.path.insert(0, sys.argv.pop(1))
+import ui_assets_pack as pack
+
+pack_font = pack.pack_font
+
+
+def pack_bad_font(path, large):
+    blob = bytearray(pack_font(path, large))
+    if path.endswith('font_bad.fnt'):
+        header = pack.FONT_HEADER.unpack_from(blob)
+        glyph_dsc_size, glyph_cnt, glyph_dsc_ofs, bitmap_ofs = header[2], header[13], header[14], header[15]
+        ofs = glyph_dsc_ofs + (glyph_cnt - 1) * glyph_dsc_size
+        mask = 0xFFFFF if glyph_dsc_size == 8 else 0xFFFFFFFF
+        word = struct.unpack_from('<I', blob, ofs)[0]
+        struct.pack_into('<I', blob, ofs, (word & ~mask) | (len(blob) - bitmap_ofs))
+    if 'font_bad_cmap' in path:
+        header = pack.FONT_HEADER.unpack_from(blob)
+        cmap_num, glyph_cnt, cmap_ofs = header[12], header[13], header[16]
+        cmap = list(pack.FONT_CMAP.unpack_from(blob, cmap_ofs + (cmap_num - 1) * pack.FONT_CMAP.size))
+        cmap[2] = glyph_cnt
+        pack.FONT_CMAP.pack_into(blob, cmap_ofs + (cmap_num - 1) * pack.FONT_CMAP.size, *cmap)
+    return bytes(blob)
+
+
+pack.pack_font = pack_bad_font
+pack.main()
+EOF
+
+# LVGL is built once, in parallel. The fonts include "../../lvgl.h", found from src/font.
+CFLAGS="-O1 -g -Wall -Wextra -Wno-unused-parameter -DLV_CONF_INCLUDE_SIMPLE -DLV_BUILD_TEST=1 -I. -I$LVGL -I$LVGL/src/font"
+for SRC in $(find $LVGL/src -name '*.c') $FONTS/font_1.c $FONTS/font_2.c; do
+    OBJ=$BUILD/obj/$(echo "$SRC" | sed 's|.*/lvgl__lvgl/||; s|/|_|g').o
+    [ -f "$OBJ" ] || echo "$SRC $OBJ"
+done | xargs -r -n 2 -P "$(nproc)" sh -c 'mkdir -p $(dirname "$1") && cc '"$CFLAGS"' -c "$0" -o "$1"'
+
+cc $CFLAGS -fsanitize=address -I$ROOT/main -I$ROOT/managed_components/espressif__esp_mmap_assets/include \
+    ui_assets_test.c $ROOT/main/ui_assets.c mmap_assets_host.c $BUILD/obj/*.o -o $BUILD/ui_assets_test
+$BUILD/ui_assets_test $BUILD/assets.bin $FONTS/font_1.fnt $FONTS/font_2.fnt
+rm -rf $BUILD
@@ -0,0 +1,4 @@
+// Host build of ui_assets.c: the configuration of esp_mmap_assets
+#pragma once
+
+#define CONFIG_MMAP_FILE_NAME_LENGTH 16
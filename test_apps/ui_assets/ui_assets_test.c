@@ -0,0 +1,370 @@
+/*
+ * Host test of the asset partition (ui_assets.c of main/) on mmap_assets_host.c, the stand-in
+ * of esp_mmap_assets which maps a file read only.
+ *
+ * run_test.sh packs the images of make_pngs.py and two fonts of the LVGL tests with
+ * tools/ui_assets_pack.py. The images must be opened with their pixels where they are in the
+ * mapping, also through the image cache which copies the pixels of the other decoders, and must
+ * be drawn with the expected colors. The fonts must have the same glyphs as the C arrays of
+ * lv_font_conv, with only their descriptors in RAM. Any write to the assets crashes the test.
+ *
+ * Run: ./run_test.sh
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lvgl.h"
+#include "ui_assets.h"
+
+#define HOR_RES     160
+#define VER_RES     80
+#define IMG_W       40
+#define IMG_H       30
+
+// The last mapping of mmap_assets_host.c
+extern const uint8_t *mmap_assets_host_map;
+extern size_t mmap_assets_host_len;
+
+// The fonts of the LVGL tests compiled from the C arrays
+extern lv_font_t font_1;
+extern lv_font_t font_2;
+
+static int failures;
+
+#define CHECK(cond, ...) do { \
+        if (!(cond)) { \
+            printf("FAIL %s:%d: ", __FILE__, __LINE__); \
+            printf(__VA_ARGS__); \
+            printf("\n"); \
+            failures++; \
+        } \
+    } while (0)
+
+static lv_color_t fb[HOR_RES * VER_RES];
+static lv_color_t draw_buf_px[HOR_RES * VER_RES];
+
+/* The pixels of make_pngs.py */
+static lv_color_t img_color(int x, int y)
+{
+    return lv_color_make((x * 6) & 0xFF, (y * 8) & 0xFF, ((x + y) * 3) & 0xFF);
+}
+
+static uint8_t img_alpha(int x, int y)
+{
+    return (x * y * 7) & 0xFF;
+}
+
+static bool in_map(const void *p)
+{
+    const uint8_t *b = p;
+    return b >= mmap_assets_host_map && b < mmap_assets_host_map + mmap_assets_host_len;
+}
+
+static void flush_cb(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p)
+{
+    memcpy(fb, color_p, lv_area_get_size(area) * sizeof(lv_color_t));
+    lv_disp_flush_ready(drv);
+}
+
+static void hal_init(void)
+{
+    static lv_disp_draw_buf_t draw_buf;
+    static lv_disp_drv_t drv;
+    lv_disp_draw_buf_init(&draw_buf, draw_buf_px, NULL, HOR_RES * VER_RES);
+    lv_disp_drv_init(&drv);
+    drv.draw_buf = &draw_buf;
+    drv.flush_cb = flush_cb;
+    drv.hor_res = HOR_RES;
+    drv.ver_res = VER_RES;
+    drv.full_refresh = 1;
+    lv_disp_drv_register(&drv);
+}
+
+static bool color_near(lv_color_t a, lv_color_t b)
+{
+    return abs((int)a.ch.red - b.ch.red) <= 1 && abs((int)a.ch.green - b.ch.green) <= 1 &&
+           abs((int)a.ch.blue - b.ch.blue) <= 1;
+}
+
+/* Open every packed image and check that its pixels are used in place */
+static void test_open(void)
+{
+    static const struct {
+        const char *name;
+        lv_img_cf_t cf;
+    } imgs[] = {
+        {"rgb", LV_IMG_CF_TRUE_COLOR},
+        {"argb", LV_IMG_CF_RGB565A8},
+        {"pal", LV_IMG_CF_RGB565A8},
+        {"mask", LV_IMG_CF_ALPHA_8BIT},
+    };
+
+    for (size_t i = 0; i < sizeof(imgs) / sizeof(imgs[0]); i++) {
+        char src[32];
+        snprintf(src, sizeof(src), UI_ASSETS_DRIVE "%s", imgs[i].name);
+        const uint8_t *asset = ui_assets_get(imgs[i].name, NULL);
+        CHECK(asset && in_map(asset) && ((uintptr_t)asset & 3) == 0, "%s: not found or not aligned", src);
+
+        lv_img_header_t header;
+        CHECK(lv_img_decoder_get_info(src, &header) == LV_RES_OK, "%s: no info", src);
+        CHECK(header.w == IMG_W && header.h == IMG_H && header.cf == imgs[i].cf, "%s: %dx%d cf %d",
+              src, header.w, header.h, header.cf);
+
+        lv_img_decoder_dsc_t dsc;
+        CHECK(lv_img_decoder_open(&dsc, src, lv_color_black(), 0) == LV_RES_OK, "%s: can't open", src);
+        CHECK(dsc.img_data == asset + sizeof(lv_img_header_t), "%s: the pixels were copied to %p", src,
+              (void *)dsc.img_data);
+        if (dsc.img_data != asset + sizeof(lv_img_header_t)) {
+            continue;
+        }
+
+        const lv_color_t *px = (const lv_color_t *)dsc.img_data;
+        const uint8_t *alpha = dsc.img_data + IMG_W * IMG_H * sizeof(lv_color_t);
+        int bad = 0;
+        for (int y = 0; y < IMG_H; y++) {
+            for (int x = 0; x < IMG_W; x++) {
+                int idx = y * IMG_W + x;
+                if (i == 0) {
+                    bad += px[idx].full != img_color(x, y).full;
+                } else if (i == 1) {
+                    bad += px[idx].full != img_color(x, y).full || alpha[idx] != img_alpha(x, y);
+                } else if (i == 2) {
+                    int p = (x + y) % 16;
+                    bad += px[idx].full != lv_color_make(p * 16, 255 - p * 16, p * 8).full ||
+                           alpha[idx] != (p ? 255 : 0);
+                } else {
+                    bad += dsc.img_data[idx] != img_alpha(x, y);
+                }
+            }
+        }
+        CHECK(bad == 0, "%s: %d wrong pixels", src, bad);
+        lv_img_decoder_close(&dsc);
+
+        // The cache copies the pixels of the decoders which own them, these are only pointed to
+        _lv_img_cache_entry_t *entry = _lv_img_cache_open(src, lv_color_black(), 0);
+        CHECK(entry && entry->dec_dsc.img_data == asset + sizeof(lv_img_header_t) && !entry->own_data,
+              "%s: the cache copied the pixels", src);
+        if (entry) {
+            _lv_img_cache_release(entry);
+        }
+    }
+
+    lv_img_cache_stats_t stats;
+    lv_img_cache_get_stats(&stats);
+    CHECK(stats.entry_cnt == 4 && stats.mem_size < 1024, "cache: %u images in %u bytes",
+          stats.entry_cnt, (unsigned)stats.mem_size);
+
+    lv_img_header_t header;
+    CHECK(lv_img_decoder_get_info(UI_ASSETS_IMG("font_2"), &header) == LV_RES_INV, "a font opened as image");
+    CHECK(lv_img_decoder_get_info(UI_ASSETS_IMG("missing"), &header) == LV_RES_INV, "a missing image opened");
+    CHECK(ui_assets_get("rgb_and_a_too_long_name", NULL) == NULL, "a too long name found");
+}
+
+/* Draw the images from the mapping */
+static void test_draw(void)
+{
+    lv_obj_t *scr = lv_scr_act();
+    lv_obj_set_style_bg_color(scr, lv_color_white(), 0);
+
+    lv_obj_t *rgb = lv_img_create(scr);
+    lv_img_set_src(rgb, UI_ASSETS_IMG("rgb"));
+    lv_obj_set_pos(rgb, 0, 0);
+    lv_obj_t *argb = lv_img_create(scr);
+    lv_img_set_src(argb, UI_ASSETS_IMG("argb"));
+    lv_obj_set_pos(argb, 50, 0);
+    lv_obj_t *mask = lv_img_create(scr);
+    lv_img_set_src(mask, UI_ASSETS_IMG("mask"));
+    lv_obj_set_pos(mask, 100, 0);
+    lv_obj_set_style_img_recolor(mask, lv_palette_main(LV_PALETTE_RED), 0);
+    lv_obj_set_style_img_recolor_opa(mask, LV_OPA_COVER, 0);
+    lv_refr_now(NULL);
+
+    int bad_rgb = 0, bad_argb = 0, bad_mask = 0;
+    lv_color_t red = lv_palette_main(LV_PALETTE_RED);
+    for (int y = 0; y < IMG_H; y++) {
+        for (int x = 0; x < IMG_W; x++) {
+            bad_rgb += fb[y * HOR_RES + x].full != img_color(x, y).full;
+            lv_color_t exp = lv_color_mix(img_color(x, y), lv_color_white(), img_alpha(x, y));
+            bad_argb += !color_near(fb[y * HOR_RES + 50 + x], exp);
+            exp = lv_color_mix(red, lv_color_white(), img_alpha(x, y));
+            bad_mask += !color_near(fb[y * HOR_RES + 100 + x], exp);
+        }
+    }
+    CHECK(bad_rgb == 0, "rgb: %d wrong pixels", bad_rgb);
+    CHECK(bad_argb == 0, "argb: %d wrong pixels", bad_argb);
+    CHECK(bad_mask == 0, "mask: %d wrong pixels", bad_mask);
+
+    // A transformed A8 image is read line by line as recolored pixels
+    lv_img_decoder_dsc_t dsc;
+    uint8_t line[IMG_W * LV_IMG_PX_SIZE_ALPHA_BYTE];
+    CHECK(lv_img_decoder_open(&dsc, UI_ASSETS_IMG("mask"), red, 0) == LV_RES_OK, "mask: can't open");
+    CHECK(lv_img_decoder_read_line(&dsc, 5, 7, IMG_W - 5, line) == LV_RES_OK, "mask: can't read a line");
+    int bad = 0;
+    for (int x = 5; x < IMG_W; x++) {
+        const uint8_t *p = &line[(x - 5) * LV_IMG_PX_SIZE_ALPHA_BYTE];
+        lv_color_t c;
+        memcpy(&c, p, sizeof(c));
+        bad += c.full != red.full || p[LV_IMG_PX_SIZE_ALPHA_BYTE - 1] != img_alpha(x, 7);
+    }
+    CHECK(bad == 0, "mask: %d wrong pixels read", bad);
+    lv_img_decoder_close(&dsc);
+
+    // Transformed, it must look the same as the built-in decoder draws the same pixels of a variable
+    static lv_color_t ref_fb[HOR_RES * VER_RES];
+    static uint8_t mask_px[IMG_W * IMG_H];
+    for (int i = 0; i < IMG_W * IMG_H; i++) {
+        mask_px[i] = img_alpha(i % IMG_W, i / IMG_W);
+    }
+    const lv_img_dsc_t mask_var = {
+        .header = {.cf = LV_IMG_CF_ALPHA_8BIT, .w = IMG_W, .h = IMG_H},
+        .data_size = sizeof(mask_px),
+        .data = mask_px,
+    };
+    lv_img_set_zoom(mask, 384);
+    lv_img_set_angle(mask, 300);
+    lv_img_set_src(mask, &mask_var);
+    lv_refr_now(NULL);
+    memcpy(ref_fb, fb, sizeof(fb));
+    int drawn = 0;
+    for (int i = 0; i < HOR_RES * VER_RES; i++) {
+        drawn += ref_fb[i].full != lv_color_white().full;
+    }
+    lv_img_set_src(mask, UI_ASSETS_IMG("mask"));
+    lv_refr_now(NULL);
+    CHECK(drawn > IMG_W * IMG_H && memcmp(ref_fb, fb, sizeof(fb)) == 0, "mask transformed: drawn differently");
+
+    lv_obj_clean(scr);
+}
+
+static uint32_t bitmap_size(const lv_font_t *font, const lv_font_glyph_dsc_t *g)
+{
+    const lv_font_fmt_txt_dsc_t *dsc = font->dsc;
+    uint32_t px = g->box_w * g->box_h;
+    // Compressed glyphs are decompressed to 1, 2 or 4 bits per pixel, 8 stays 8
+    if (dsc->bitmap_format == LV_FONT_FMT_TXT_PLAIN || dsc->bpp == 8) {
+        return (px * dsc->bpp + 7) / 8;
+    }
+    return (px * (dsc->bpp == 3 ? 4 : dsc->bpp) + 7) / 8;
+}
+
+static size_t mem_used(void)
+{
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    return mon.total_size - mon.free_size;
+}
+
+/* Load the fonts from the mapping and compare them with the compiled ones */
+static void test_font(const char *name, const lv_font_t *ref, const char *fnt_path)
+{
+    size_t used = mem_used();
+    lv_font_t *font = ui_assets_font_load(name);
+    size_t font_ram = mem_used() - used;
+    CHECK(font != NULL, "%s: can't load", name);
+    if (font == NULL) {
+        return;
+    }
+
+    const lv_font_fmt_txt_dsc_t *dsc = font->dsc;
+    const lv_font_fmt_txt_dsc_t *ref_dsc = ref->dsc;
+    CHECK(font->line_height == ref->line_height && font->base_line == ref->base_line &&
+          font->subpx == ref->subpx, "%s: line %d/%d base %d/%d", name, font->line_height, ref->line_height,
+          font->base_line, ref->base_line);
+    CHECK(dsc->bpp == ref_dsc->bpp && dsc->bitmap_format == ref_dsc->bitmap_format &&
+          dsc->cmap_num == ref_dsc->cmap_num && dsc->kern_classes == ref_dsc->kern_classes &&
+          dsc->kern_scale == ref_dsc->kern_scale, "%s: different font parameters", name);
+    CHECK(in_map(dsc->glyph_dsc) && in_map(dsc->glyph_bitmap), "%s: the glyphs are not in the mapping", name);
+
+    int glyphs = 0, bad = 0;
+    uint32_t letter;
+    for (letter = 0x20; letter < 0x2000; letter++) {
+        lv_font_glyph_dsc_t g, ref_g;
+        bool found = lv_font_get_glyph_dsc(font, &g, letter, 'A');
+        bool ref_found = lv_font_get_glyph_dsc(ref, &ref_g, letter, 'A');
+        if (found != ref_found) {
+            bad++;
+            continue;
+        }
+        if (!found) {
+            continue;
+        }
+        glyphs++;
+        // With the kerning to 'A'
+        if (g.adv_w != ref_g.adv_w || g.box_w != ref_g.box_w || g.box_h != ref_g.box_h ||
+            g.ofs_x != ref_g.ofs_x || g.ofs_y != ref_g.ofs_y || g.bpp != ref_g.bpp) {
+            bad++;
+            continue;
+        }
+        uint32_t size = bitmap_size(ref, &ref_g);
+        if (size == 0) {
+            continue;
+        }
+        static uint8_t ref_bitmap[4096];
+        const uint8_t *ref_bmp = lv_font_get_glyph_bitmap(ref, letter);
+        if (ref_bmp == NULL || size > sizeof(ref_bitmap)) {
+            bad++;
+            continue;
+        }
+        memcpy(ref_bitmap, ref_bmp, size);
+        const uint8_t *bmp = lv_font_get_glyph_bitmap(font, letter);
+        if (bmp == NULL || memcmp(bmp, ref_bitmap, size) != 0) {
+            bad++;
+            continue;
+        }
+        // Plain bitmaps are drawn from the mapping
+        if (dsc->bitmap_format == LV_FONT_FMT_TXT_PLAIN && !in_map(bmp)) {
+            bad++;
+        }
+    }
+    CHECK(glyphs > 50 && bad == 0, "%s: %d glyphs, %d different", name, glyphs, bad);
+
+    // The binary font loaded to RAM as it's done without the mapping
+    used = mem_used();
+    lv_font_t *loaded = lv_font_load(fnt_path);
+    size_t loaded_ram = mem_used() - used;
+    CHECK(loaded != NULL, "%s: lv_font_load() failed", fnt_path);
+    lv_font_free(loaded);
+    printf("%s: %d glyphs, %u bytes of RAM (%u bytes with lv_font_load)\n", name, glyphs,
+           (unsigned)font_ram, (unsigned)loaded_ram);
+    CHECK(font_ram * 10 < loaded_ram, "%s: %u bytes of RAM", name, (unsigned)font_ram);
+
+    ui_assets_font_free(font);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 4) {
+        printf("Usage: %s ASSETS_BIN FONT_1_FNT FONT_2_FNT\n", argv[0]);
+        return 2;
+    }
+    lv_init();
+    hal_init();
+
+    CHECK(ui_assets_init("missing.bin") != ESP_OK, "mapped a missing partition");
+    CHECK(ui_assets_init(argv[1]) == ESP_OK, "can't map %s", argv[1]);
+    CHECK(ui_assets_init(argv[1]) == ESP_ERR_INVALID_STATE, "mapped twice");
+    if (failures) {
+        return 1;
+    }
+
+    test_open();
+    test_draw();
+
+    char path[256];
+    snprintf(path, sizeof(path), "A:%s", argv[2]);
+    test_font("font_1", &font_1, path);
+    snprintf(path, sizeof(path), "A:%s", argv[3]);
+    test_font("font_2", &font_2, path);
+    CHECK(ui_assets_font_load("rgb") == NULL, "an image loaded as font");
+    CHECK(ui_assets_font_load("missing") == NULL, "a missing font loaded");
+    CHECK(ui_assets_font_load("font_bad") == NULL, "a font with a glyph outside of its payload loaded");
+    CHECK(ui_assets_font_load("font_bad_cmap") == NULL, "a font with glyph IDs outside of its glyphs loaded");
+
+    if (failures) {
+        printf("%d checks failed\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,9 @@
+#!/bin/sh
+# Build the UI queue test with ThreadSanitizer and run it
+set -e
+cd "$(dirname "$0")"
+
+ROOT=../..
+cc -O1 -g -Wall -Wextra -fsanitize=thread -I$ROOT/main ui_queue_test.c $ROOT/main/ui_queue.c -o ui_queue_test -lpthread
+./ui_queue_test
+rm -f ui_queue_test
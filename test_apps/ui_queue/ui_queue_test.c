@@ -0,0 +1,174 @@
+/*
+ * Host test of the MQTT to UI update queue (ui_queue.c of main/).
+ *
+ * A producer thread posts relay flips, HA status changes and numbered log lines as fast as it can,
+ * while the consumer drains the queue once per "frame" and spends the rest of the frame rendering.
+ * Every log line must arrive once and in order unless it was counted as dropped, and the relays
+ * and the HA status must end in the last posted state. Built with ThreadSanitizer by run_test.sh.
+ *
+ * Run: ./run_test.sh
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+#include "ui_queue.h"
+
+#define MESSAGES    200000
+#define RELAYS      3
+#define FRAME_US    2000        /* Time of one "frame" of the consumer */
+
+static int failures;
+
+#define CHECK(cond, ...) do { \
+        if (!(cond)) { \
+            printf("FAIL %s:%d: ", __FILE__, __LINE__); \
+            printf(__VA_ARGS__); \
+            printf("\n"); \
+            failures++; \
+        } \
+    } while (0)
+
+static ui_queue_t queue;
+static atomic_bool producer_done;
+
+/* The state of the "widgets" */
+static int relay_widget[RELAYS];
+static int relay_applied;
+static bool ha_widget;
+static const char *ha_ip_widget;
+static long next_line;
+static long lines_received;
+static int order_errors;
+
+static const char *ips[2] = {"192.168.1.206", NULL};
+
+static void apply_relay(int relay_index, bool state)
+{
+    relay_widget[relay_index] = state;
+    relay_applied++;
+}
+
+static void apply_ha_status(bool connected, const char *ip)
+{
+    ha_widget = connected;
+    ha_ip_widget = ip;
+}
+
+static void apply_log(const char *line)
+{
+    long n = strtol(line + 5, NULL, 10);  /* "line N" */
+    if (n < next_line) {
+        order_errors++;
+    }
+    next_line = n + 1;
+    lines_received++;
+}
+
+static const ui_queue_handlers_t handlers = {
+    .relay = apply_relay,
+    .ha_status = apply_ha_status,
+    .log = apply_log,
+};
+
+static void sleep_us(long us)
+{
+    struct timespec ts = {0, us * 1000};
+    nanosleep(&ts, NULL);
+}
+
+static int last_relay[RELAYS];
+static bool last_ha;
+static long lines_posted;
+
+static void *producer(void *arg)
+{
+    (void)arg;
+    unsigned seed = 1;
+    long i;
+    for (i = 0; i < MESSAGES; i++) {
+        seed = seed * 1103515245 + 12345;
+        switch ((seed >> 16) % 4) {
+            case 0:
+            case 1: {
+                int relay = (seed >> 8) % RELAYS;
+                last_relay[relay] = (seed >> 4) & 1;
+                ui_queue_post_relay(&queue, relay, last_relay[relay]);
+                break;
+            }
+            case 2:
+                last_ha = (seed >> 4) & 1;
+                ui_queue_post_ha_status(&queue, last_ha, ips[!last_ha]);
+                break;
+            default:
+                ui_queue_post_log(&queue, "line %ld: %s", lines_posted++, "zigbee2mqtt/office_sensor {\"occupancy\":true}");
+                break;
+        }
+        /* Bursts with pauses, like the messages arriving from the broker */
+        if (i % 1000 == 999) {
+            sleep_us(FRAME_US);
+        }
+    }
+    atomic_store(&producer_done, true);
+    return NULL;
+}
+
+int main(void)
+{
+    pthread_t thread;
+    pthread_create(&thread, NULL, producer, NULL);
+
+    uint32_t frames = 0;
+    while (1) {
+        bool done = atomic_load(&producer_done);
+        ui_queue_drain(&queue, &handlers);
+        frames++;
+        if (done) {
+            break;
+        }
+        sleep_us(FRAME_US);  /* Rendering */
+    }
+    pthread_join(thread, NULL);
+    ui_queue_drain(&queue, &handlers);
+
+    ui_queue_stats_t stats;
+    ui_queue_get_stats(&queue, &stats);
+
+    int i;
+    for (i = 0; i < RELAYS; i++) {
+        CHECK(relay_widget[i] == last_relay[i], "relay %d is %d instead of %d", i, relay_widget[i], last_relay[i]);
+    }
+    CHECK(ha_widget == last_ha && ha_ip_widget == ips[!last_ha], "HA status");
+    CHECK(order_errors == 0, "%d log lines out of order", order_errors);
+    CHECK(lines_received + (long)stats.dropped == lines_posted, "%ld lines received, %u dropped, %ld posted",
+          lines_received, (unsigned)stats.dropped, lines_posted);
+    CHECK(stats.posted == MESSAGES, "%u posted", (unsigned)stats.posted);
+    CHECK(stats.depth == 0, "depth %u", (unsigned)stats.depth);
+    CHECK(stats.depth_max <= UI_QUEUE_LOG_LINES, "depth_max %u", (unsigned)stats.depth_max);
+    CHECK(stats.coalesced > 0, "nothing coalesced");
+
+    printf("%u updates in %u frames: %u relay changes applied, %u coalesced, %ld lines, %u dropped, max depth %u\n",
+           (unsigned)stats.posted, (unsigned)frames, (unsigned)relay_applied, (unsigned)stats.coalesced,
+           lines_received, (unsigned)stats.dropped, (unsigned)stats.depth_max);
+
+    /* A drop doesn't lose the line after it */
+    static ui_queue_t small;
+    for (i = 0; i < UI_QUEUE_LOG_LINES + 3; i++) {
+        CHECK(ui_queue_post_log(&small, "line %d", i) == (i < UI_QUEUE_LOG_LINES), "post %d", i);
+    }
+    next_line = 0;
+    lines_received = 0;
+    CHECK(ui_queue_drain(&small, &handlers) == UI_QUEUE_LOG_LINES, "drain");
+    CHECK(ui_queue_post_log(&small, "line %d", 100), "post after drain");
+    CHECK(ui_queue_drain(&small, &handlers) == 1 && next_line == 101, "line after drain");
+
+    if (failures) {
+        printf("%d checks failed\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,503 @@
+#!/usr/bin/env python3
+# Pack UI images and fonts into an asset partition for main/ui_assets.c
+#
+# The assets are stored in the form LVGL uses them, so they are drawn straight from the
+# memory mapped flash without copying them into RAM:
+#
+#   name.png     RGB565 image, RGB565A8 if the PNG has transparent pixels
+#   name.a8.png  A8 image (the alpha channel, or the gray level of an opaque PNG), drawn with the
+#                image recolor
+#   name.bin     LVGL image file (the "bin" output of the LVGL image converter), stored as it is
+#   name.fnt     lv_font_conv binary font (--format bin), re-packed so that the glyph descriptors
+#                and the bitmaps are used in place
+#
+# The asset name is the file name without the extensions ("icons/wifi.a8.png" -> "wifi").
+# The container is the one of esp_mmap_assets (spiffs_assets_gen.py): a header, the table of the
+# names, sizes and offsets, and the assets each prefixed with 0x5A5A. Padding is added between
+# the assets so every payload starts on a 4 byte boundary of the partition.
+#
+# Usage: ui_assets_pack.py -o assets.bin [--swap] [--font-large] FILE_OR_DIR...
+
+import argparse
+import os
+import struct
+import sys
+import zlib
+
+# lv_img_cf_t
+CF_TRUE_COLOR = 4
+CF_TRUE_COLOR_ALPHA = 5
+CF_TRUE_COLOR_CHROMA_KEYED = 6
+CF_ALPHA_8BIT = 14
+CF_RGB565A8 = 20
+# The formats ui_assets.c can draw from flash and their bytes per pixel at 16 bit color depth
+BIN_FORMATS = {CF_TRUE_COLOR: 2, CF_TRUE_COLOR_ALPHA: 3, CF_TRUE_COLOR_CHROMA_KEYED: 2,
+               CF_ALPHA_8BIT: 1, CF_RGB565A8: 3}
+
+FONT_MAGIC = b'UFNT'
+FONT_VERSION = 1
+FONT_HEADER = struct.Struct('<4sHHhhbbBBBBHHHIIII')
+FONT_CMAP = struct.Struct('<IHHHBxII')
+FONT_KERN_PAIRS = struct.Struct('<IB3xII')
+FONT_KERN_CLASSES = struct.Struct('<BBHIII')
+
+ASSET_MAGIC = b'\x5A\x5A'
+TABLE_ENTRY_EXTRA = 12  # size, offset, width, height after the name
+
+
+class PackError(Exception):
+    pass
+
+
+# ---------------------------------------------------------------------------------------------
+# PNG reading. Pillow is used if it's installed, the fallback handles the non-interlaced PNGs.
+# ---------------------------------------------------------------------------------------------
+
+def read_png_rgba(path):
+    try:
+        from PIL import Image
+    except ImportError:
+        return read_png_rgba_zlib(path)
+    with Image.open(path) as img:
+        img = img.convert('RGBA')
+        return img.width, img.height, list(img.getdata())
+
+
+def read_png_rgba_zlib(path):
+    with open(path, 'rb') as f:
+        data = f.read()
+    if data[:8] != b'\x89PNG\r\n\x1a\n':
+        raise PackError(f'{path}: not a PNG (install Pillow for the other formats)')
+
+    pos = 8
+    idat = bytearray()
+    palette = None
+    trns = None
+    while pos + 8 <= len(data):
+        length, ctype = struct.unpack('>I4s', data[pos:pos + 8])
+        chunk = data[pos + 8:pos + 8 + length]
+        pos += 12 + length
+        if ctype == b'IHDR':
+            w, h, depth, color_type, _, _, interlace = struct.unpack('>IIBBBBB', chunk)
+        elif ctype == b'PLTE':
+            palette = [tuple(chunk[i:i + 3]) for i in range(0, len(chunk), 3)]
+        elif ctype == b'tRNS':
+            trns = chunk
+        elif ctype == b'IDAT':
+            idat += chunk
+        elif ctype == b'IEND':
+            break
+
+    if interlace:
+        raise PackError(f'{path}: interlaced PNG (install Pillow to read it)')
+    channels = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}[color_type]
+    bits_px = channels * depth
+    stride = (w * bits_px + 7) // 8
+    bpp = max(1, bits_px // 8)
+    raw = zlib.decompress(bytes(idat))
+
+    rows = []
+    prev = bytearray(stride)
+    for y in range(h):
+        ftype = raw[y * (stride + 1)]
+        line = bytearray(raw[y * (stride + 1) + 1:(y + 1) * (stride + 1)])
+        for i in range(stride):
+            a = line[i - bpp] if i >= bpp else 0
+            b = prev[i]
+            c = prev[i - bpp] if i >= bpp else 0
+            if ftype == 1:
+                line[i] = (line[i] + a) & 0xFF
+            elif ftype == 2:
+                line[i] = (line[i] + b) & 0xFF
+            elif ftype == 3:
+                line[i] = (line[i] + ((a + b) >> 1)) & 0xFF
+            elif ftype == 4:
+                p = a + b - c
+                pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+                pred = a if pa <= pb and pa <= pc else (b if pb <= pc else c)
+                line[i] = (line[i] + pred) & 0xFF
+        rows.append(line)
+        prev = line
+
+    def samples(line):
+        if depth == 8:
+            return list(line)
+        if depth == 16:
+            return [line[i] for i in range(0, len(line), 2)]
+        per_byte = 8 // depth
+        mask = (1 << depth) - 1
+        out = []
+        for byte in line:
+            for k in range(per_byte):
+                out.append((byte >> (8 - depth * (k + 1))) & mask)
+        return out
+
+    scale = 255 // ((1 << depth) - 1) if depth < 8 else 1
+    pixels = []
+    for line in rows:
+        s = samples(line)
+        for x in range(w):
+            if color_type == 0:
+                v = s[x] * scale
+                key = trns and struct.unpack('>H', trns[:2])[0] * scale == v
+                pixels.append((v, v, v, 0 if key else 255))
+            elif color_type == 2:
+                r, g, b = s[x * 3:x * 3 + 3]
+                key = trns and [v >> 8 if depth == 16 else v for v in struct.unpack('>HHH', trns[:6])] == [r, g, b]
+                pixels.append((r, g, b, 0 if key else 255))
+            elif color_type == 3:
+                idx = s[x]
+                alpha = trns[idx] if trns and idx < len(trns) else 255
+                pixels.append(palette[idx] + (alpha,))
+            elif color_type == 4:
+                pixels.append((s[x * 2], s[x * 2], s[x * 2], s[x * 2 + 1]))
+            else:
+                pixels.append(tuple(s[x * 4:x * 4 + 4]))
+    return w, h, pixels
+
+
+# ---------------------------------------------------------------------------------------------
+# Images
+# ---------------------------------------------------------------------------------------------
+
+def img_header(cf, w, h):
+    if w >= 2048 or h >= 2048:
+        raise PackError(f'{w}x{h}: LVGL images can be at most 2047x2047')
+    return struct.pack('<I', cf | (w << 10) | (h << 21))
+
+
+def rgb565(r, g, b, swap):
+    c = ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3)
+    return struct.pack('>H' if swap else '<H', c)
+
+
+def pack_png(path, a8, swap):
+    w, h, pixels = read_png_rgba(path)
+    if a8:
+        opaque = all(p[3] == 255 for p in pixels)
+        # The gray level of an opaque image, e.g. a white icon drawn on black
+        data = bytes((p[0] * 299 + p[1] * 587 + p[2] * 114) // 1000 if opaque else p[3] for p in pixels)
+        return img_header(CF_ALPHA_8BIT, w, h) + data, w, h
+
+    color = b''.join(rgb565(p[0], p[1], p[2], swap) for p in pixels)
+    if all(p[3] == 255 for p in pixels):
+        return img_header(CF_TRUE_COLOR, w, h) + color, w, h
+    # The color array followed by the alpha array
+    return img_header(CF_RGB565A8, w, h) + color + bytes(p[3] for p in pixels), w, h
+
+
+def pack_bin(path):
+    with open(path, 'rb') as f:
+        data = f.read()
+    if len(data) < 4:
+        raise PackError(f'{path}: too short for an LVGL image')
+    hdr = struct.unpack('<I', data[:4])[0]
+    cf, zero, w, h = hdr & 0x1F, (hdr >> 5) & 0x7, (hdr >> 10) & 0x7FF, (hdr >> 21) & 0x7FF
+    if zero or cf not in BIN_FORMATS:
+        raise PackError(f'{path}: color format {cf} can\'t be drawn from flash, '
+                        'convert it to true color (16 bit), RGB565A8 or A8')
+    if len(data) < 4 + w * h * BIN_FORMATS[cf]:
+        raise PackError(f'{path}: {len(data)} bytes are too few for a {w}x{h} image of color format {cf}')
+    return data, w, h
+
+
+# ---------------------------------------------------------------------------------------------
+# Fonts. Read like lv_font_loader.c reads them, then stored in the layout of the C arrays.
+# ---------------------------------------------------------------------------------------------
+
+class BitReader:
+    # MSB first, like the bit iterator of lv_font_loader.c
+    def __init__(self, data, pos):
+        self.data = data
+        self.pos = pos
+        self.bit_pos = -1
+        self.byte = 0
+
+    def read(self, n):
+        value = 0
+        while n:
+            n -= 1
+            self.byte = (self.byte << 1) & 0xFF
+            self.bit_pos -= 1
+            if self.bit_pos < 0:
+                self.bit_pos = 7
+                self.byte = self.data[self.pos]
+                self.pos += 1
+            value |= ((self.byte >> 7) & 1) << n
+        return value
+
+    def read_signed(self, n):
+        value = self.read(n)
+        if n and value & (1 << (n - 1)):
+            value -= 1 << n
+        return value
+
+
+def read_label(data, pos, label):
+    length, name = struct.unpack_from('<I4s', data, pos)
+    if name != label:
+        raise PackError(f'"{label.decode()}" table expected at {pos}')
+    return length
+
+
+def align4(blob):
+    blob.extend(b'\0' * (-len(blob) % 4))
+    return len(blob)
+
+
+def pack_font(path, large):
+    with open(path, 'rb') as f:
+        data = f.read()
+
+    header_len = read_label(data, 0, b'head')
+    (_, tables_count, _, ascent, descent, _, _, _, _, _, default_adv_w, kern_scale,
+     loca_format, glyph_id_format, adv_w_format, bpp, xy_bits, wh_bits, adv_w_bits,
+     compression, subpx, _, underline_pos, underline_thick) = struct.unpack_from(
+        '<IHHHhHhHhhHHBBBBBBBBBBhH', data, 8)
+
+    # cmaps
+    cmaps_start = header_len
+    cmaps_len = read_label(data, cmaps_start, b'cmap')
+    cmap_cnt = struct.unpack_from('<I', data, cmaps_start + 8)[0]
+    cmaps = []
+    for i in range(cmap_cnt):
+        (data_ofs, range_start, range_len, glyph_id_start, entries,
+         fmt) = struct.unpack_from('<IIHHHBx', data, cmaps_start + 12 + i * 16)
+        pos = cmaps_start + data_ofs
+        unicode_list = None
+        ids = None
+        if fmt == 0:    # Format 0 full
+            ids = data[pos:pos + entries]
+            list_len = range_len
+        elif fmt == 2:  # Format 0 tiny
+            list_len = 0
+        elif fmt in (1, 3):  # Sparse full and tiny
+            unicode_list = data[pos:pos + entries * 2]
+            if fmt == 1:
+                ids = data[pos + entries * 2:pos + entries * 4]
+            list_len = entries
+        else:
+            raise PackError(f'{path}: unknown cmap format {fmt}')
+        cmaps.append((range_start, range_len, glyph_id_start, list_len, fmt, unicode_list, ids))
+
+    # loca
+    loca_start = cmaps_start + cmaps_len
+    loca_len = read_label(data, loca_start, b'loca')
+    loca_cnt = struct.unpack_from('<I', data, loca_start + 8)[0]
+    if loca_format not in (0, 1):
+        raise PackError(f'{path}: unknown index_to_loc_format {loca_format}')
+    offsets = list(struct.unpack_from(('<%dH' if loca_format == 0 else '<%dI') % loca_cnt, data, loca_start + 12))
+
+    # glyf
+    glyf_start = loca_start + loca_len
+    glyf_len = read_label(data, glyf_start, b'glyf')
+    nbits = adv_w_bits + 2 * xy_bits + 2 * wh_bits
+    glyphs = []
+    bitmaps = bytearray()
+    for i in range(loca_cnt):
+        it = BitReader(data, glyf_start + offsets[i])
+        adv_w = it.read(adv_w_bits) if adv_w_bits else default_adv_w
+        if adv_w_format == 0:
+            adv_w *= 16
+        ofs_x = it.read_signed(xy_bits)
+        ofs_y = it.read_signed(xy_bits)
+        box_w = it.read(wh_bits)
+        box_h = it.read(wh_bits)
+        if i == 0:
+            adv_w = box_w = box_h = ofs_x = ofs_y = 0
+        glyphs.append((len(bitmaps), adv_w, box_w, box_h, ofs_x, ofs_y))
+        if box_w * box_h == 0:
+            continue
+        next_ofs = offsets[i + 1] if i < loca_cnt - 1 else glyf_len
+        bmp_size = next_ofs - offsets[i] - nbits // 8
+        if nbits % 8 == 0:
+            start = glyf_start + offsets[i] + nbits // 8
+            bitmaps += data[start:start + bmp_size]
+        else:
+            # Re-align the bitmap to a byte boundary
+            for _ in range(bmp_size - 1):
+                bitmaps.append(it.read(8))
+            bitmaps.append((it.read(8 - nbits % 8) << (nbits % 8)) & 0xFF)
+
+    # kern
+    kern = None
+    if tables_count >= 4:
+        kern_start = glyf_start + glyf_len
+        read_label(data, kern_start, b'kern')
+        kern_fmt = data[kern_start + 8]
+        pos = kern_start + 12
+        if kern_fmt == 0:
+            entries = struct.unpack_from('<I', data, pos)[0]
+            ids_size = 2 * entries * (1 if glyph_id_format == 0 else 2)
+            ids = data[pos + 4:pos + 4 + ids_size]
+            values = data[pos + 4 + ids_size:pos + 4 + ids_size + entries]
+            kern = (0, entries, glyph_id_format, ids, values)
+        elif kern_fmt == 3:
+            map_len, rows, cols = struct.unpack_from('<HBB', data, pos)
+            pos += 4
+            left = data[pos:pos + map_len]
+            right = data[pos + map_len:pos + 2 * map_len]
+            values = data[pos + 2 * map_len:pos + 2 * map_len + rows * cols]
+            kern = (1, rows, cols, left, right, values)
+        else:
+            raise PackError(f'{path}: unknown kern format {kern_fmt}')
+    else:
+        kern_scale = 0
+
+    # The flat layout: header, glyph descriptors, cmaps, their lists, kerning, bitmaps.
+    # The offsets are from the start of the payload.
+    blob = bytearray(FONT_HEADER.size)
+    glyph_dsc_ofs = len(blob)
+    for bitmap_index, adv_w, box_w, box_h, ofs_x, ofs_y in glyphs:
+        if large:
+            blob += struct.pack('<IIHHhh', bitmap_index, adv_w, box_w, box_h, ofs_x, ofs_y)
+        else:
+            if bitmap_index >= 1 << 20 or adv_w >= 1 << 12 or box_w > 255 or box_h > 255:
+                raise PackError(f'{path}: the font is too large for LV_FONT_FMT_TXT_LARGE 0, use --font-large')
+            blob += struct.pack('<IBBbb', bitmap_index | (adv_w << 20), box_w, box_h, ofs_x, ofs_y)
+    glyph_dsc_size = 16 if large else 8
+
+    cmap_ofs = align4(blob)
+    blob += bytes(FONT_CMAP.size * len(cmaps))
+    for i, (range_start, range_len, glyph_id_start, list_len, fmt, unicode_list, ids) in enumerate(cmaps):
+        unicode_ofs = ids_ofs = 0
+        if unicode_list is not None:
+            unicode_ofs = align4(blob)
+            blob += unicode_list
+        if ids is not None:
+            ids_ofs = align4(blob)
+            blob += ids
+        FONT_CMAP.pack_into(blob, cmap_ofs + i * FONT_CMAP.size, range_start, range_len, glyph_id_start,
+                            list_len, fmt, unicode_ofs, ids_ofs)
+
+    kern_ofs = 0
+    kern_classes = 0
+    if kern and kern[0] == 0:
+        _, entries, ids_size, ids, values = kern
+        kern_ofs = align4(blob)
+        blob += bytes(FONT_KERN_PAIRS.size)
+        ids_ofs = align4(blob)
+        blob += ids
+        values_ofs = len(blob)
+        blob += values
+        FONT_KERN_PAIRS.pack_into(blob, kern_ofs, entries, ids_size, ids_ofs, values_ofs)
+    elif kern:
+        _, rows, cols, left, right, values = kern
+        kern_classes = 1
+        kern_ofs = align4(blob)
+        blob += bytes(FONT_KERN_CLASSES.size)
+        left_ofs = len(blob)
+        blob += left
+        right_ofs = len(blob)
+        blob += right
+        values_ofs = len(blob)
+        blob += values
+        FONT_KERN_CLASSES.pack_into(blob, kern_ofs, rows, cols, len(left), left_ofs, right_ofs, values_ofs)
+
+    # A compressed glyph is read bit by bit until it's complete, at most bpp + 2 bits per pixel and
+    # one byte ahead. ui_assets.c checks that this stays in the payload, so pad it for the last glyphs.
+    if compression:
+        end = max((index + (w * h * (bpp + 2) + 7) // 8 + 1 for index, _, w, h, _, _ in glyphs if w * h), default=0)
+        bitmaps += bytes(max(0, end - len(bitmaps)))
+
+    bitmap_ofs = align4(blob)
+    blob += bitmaps
+
+    # Truncated to int8_t like lv_font_loader.c does
+    underline_pos = ((underline_pos + 128) & 0xFF) - 128
+    underline_thick = ((underline_thick + 128) & 0xFF) - 128
+    FONT_HEADER.pack_into(blob, 0, FONT_MAGIC, FONT_VERSION, glyph_dsc_size,
+                          ascent - descent, -descent, underline_pos, underline_thick, subpx, bpp,
+                          compression, kern_classes, kern_scale, len(cmaps), len(glyphs),
+                          glyph_dsc_ofs, bitmap_ofs, cmap_ofs, kern_ofs)
+    return bytes(blob)
+
+
+# ---------------------------------------------------------------------------------------------
+# Container
+# ---------------------------------------------------------------------------------------------
+
+def asset_name(path):
+    name = os.path.basename(path)
+    while True:
+        name, ext = os.path.splitext(name)
+        if not ext:
+            return name
+
+
+def collect(paths):
+    files = []
+    for p in paths:
+        if os.path.isdir(p):
+            files += sorted(os.path.join(p, f) for f in os.listdir(p) if os.path.isfile(os.path.join(p, f)))
+        else:
+            files.append(p)
+    return files
+
+
+def pack(files, name_length, swap, font_large):
+    assets = []
+    names = {}
+    for path in files:
+        lower = path.lower()
+        w = h = 0
+        if lower.endswith('.a8.png'):
+            payload, w, h = pack_png(path, True, swap)
+        elif lower.endswith('.png'):
+            payload, w, h = pack_png(path, False, swap)
+        elif lower.endswith('.bin'):
+            payload, w, h = pack_bin(path)
+        elif lower.endswith('.fnt'):
+            payload = pack_font(path, font_large)
+        else:
+            print(f'Skipping {path}: unknown type', file=sys.stderr)
+            continue
+
+        name = asset_name(path)
+        if len(name.encode()) > name_length:
+            raise PackError(f'{path}: the name "{name}" is longer than {name_length} bytes')
+        if name in names:
+            raise PackError(f'{path}: the name "{name}" is used by {names[name]} too')
+        names[name] = path
+        assets.append((name, payload, w, h))
+
+    entry_size = name_length + TABLE_ENTRY_EXTRA
+    data_start = 12 + len(assets) * entry_size
+    table = bytearray()
+    merged = bytearray()
+    for name, payload, w, h in assets:
+        # The partition is mapped on a page boundary, so aligning the offset in the image is enough
+        merged.extend(b'\0' * ((2 - (data_start + len(merged))) % 4))
+        table += name.encode().ljust(name_length, b'\0')
+        table += struct.pack('<IIHH', len(payload), len(merged), w, h)
+        merged += ASSET_MAGIC + payload
+
+    body = table + merged
+    checksum = sum(body) & 0xFFFF
+    return struct.pack('<III', len(assets), checksum, len(body)) + body, assets
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Pack UI images and fonts into an asset partition image')
+    parser.add_argument('inputs', nargs='+', help='Files or directories to pack')
+    parser.add_argument('-o', '--output', required=True, help='Partition image to write')
+    parser.add_argument('--name-length', type=int, default=16, help='CONFIG_MMAP_FILE_NAME_LENGTH')
+    parser.add_argument('--swap', action='store_true', help='LV_COLOR_16_SWAP: store RGB565 big endian')
+    parser.add_argument('--font-large', action='store_true', help='LV_FONT_FMT_TXT_LARGE glyph descriptors')
+    parser.add_argument('--max-size', type=lambda s: int(s, 0), default=0, help='Partition size to check against')
+    args = parser.parse_args()
+
+    try:
+        image, assets = pack(collect(args.inputs), args.name_length, args.swap, args.font_large)
+        if args.max_size and len(image) > args.max_size:
+            raise PackError(f'{len(image)} bytes don\'t fit into the {args.max_size} byte partition')
+    except (PackError, OSError, zlib.error) as e:
+        sys.exit(f'ui_assets_pack: {e}')
+
+    with open(args.output, 'wb') as f:
+        f.write(image)
+    print(f'{args.output}: {len(assets)} assets, {len(image)} bytes')
+
+
+if __name__ == '__main__':
+    main()